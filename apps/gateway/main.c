@@ -60,8 +60,8 @@ int DNET_list[2] = {
 /* current version of the BACnet stack */
 static const char *BACnet_Version = BACNET_VERSION_TEXT;
 
-/* routed devices - I-Am on startup */
-static unsigned Routed_Device_Index;
+/* number of Devices, including the gateway Device */
+static unsigned Gateway_Device_Count = MAX_NUM_DEVICES;
 
 /** Initialize the Device Objects and each of the child Object instances.
  * @param first_object_instance Set the first (gateway) Device to this
@@ -79,7 +79,7 @@ static void Devices_Init(uint32_t first_object_instance)
     Routed_Device_Set_Description(DEV_DESCR_GATEWAY, strlen(DEV_DESCR_GATEWAY));
 
     /* Now initialize the remote Device objects. */
-    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+    for (i = 1; i < (int)Gateway_Device_Count; i++) {
         snprintf(nameText, MAX_DEV_NAME_LEN, "%s %d", DEV_NAME_BASE, i + 1);
         snprintf(descText, MAX_DEV_DESC_LEN, "%s %d", DEV_DESCR_REMOTE, i);
         characterstring_init_ansi(&name_string, nameText);
@@ -121,24 +121,24 @@ static void Initialize_Device_Addresses(void)
 #else
 #error "No support for this Data Link Layer type "
 #endif
-    bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
-    /* broadcast an I-Am on startup */
-    Send_I_Am(&Handler_Transmit_Buffer[0]);
+    Routed_Device_Set_Address(&virtual_address);
 
-    for (i = 1; i < MAX_NUM_DEVICES; i++) {
+    for (i = 1; i < Routed_Device_Count(); i++) {
         pDev = Get_Routed_Device_Object(i);
         if (pDev == NULL) {
             continue;
         }
-        /* start with the router address */
-        bacnet_address_copy(&pDev->bacDevAddr, &virtual_address);
         /* add the network number to each gateway device */
-        pDev->bacDevAddr.net = VIRTUAL_DNET;
+        virtual_address.net = VIRTUAL_DNET;
         /* use a virtual MAC for each gateway device */
         virtual_mac = pDev->bacObj.Object_Instance_Number;
-        encode_unsigned24(&pDev->bacDevAddr.adr[0], virtual_mac);
-        pDev->bacDevAddr.len = 3;
+        encode_unsigned24(&virtual_address.adr[0], virtual_mac);
+        virtual_address.len = 3;
+        /* the virtual MAC is indexed to find the device quickly */
+        Routed_Device_Set_Address(&virtual_address);
     }
+    /* broadcast an I-Am for each device on startup, a few at a time */
+    Routed_Device_I_Am_Request(0, BACNET_MAX_INSTANCE, NULL);
 }
 
 /** Initialize the handlers we will utilize.
@@ -152,11 +152,12 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
     /* we need to handle who-is to support dynamic device binding
      * For the gateway, we will use the unicast variety so we can
      * get back through switches to different subnets.
-     * Don't need the routed versions, since the npdu handler calls
-     * each device in turn.
+     * Use the routed version, since the npdu handler gives a global
+     * Who-Is only to the gateway device, and the routed version answers
+     * for each device in the range of the Who-Is.
      */
     apdu_set_unconfirmed_handler(
-        SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_unicast);
+        SERVICE_UNCONFIRMED_WHO_IS, handler_who_is_unicast_for_routing);
     apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_HAS, handler_who_has);
     /* set the handler for all the services we don't implement */
     /* It is required to send the proper reject message... */
@@ -200,7 +201,8 @@ static void Init_Service_Handlers(uint32_t first_object_instance)
  *      handler_cov_task, tsm_timer_milliseconds
  *
  * @param argc [in] Arg count.
- * @param argv [in] Takes one argument: the Device Instance #.
+ * @param argv [in] Takes two optional arguments: the Device Instance #,
+ *  and the number of Devices including the gateway Device.
  * @return 0 on success.
  */
 int main(int argc, char *argv[])
@@ -230,15 +232,23 @@ int main(int argc, char *argv[])
             exit(1);
         }
     }
+    if (argc > 2) {
+        Gateway_Device_Count = strtol(argv[2], NULL, 0);
+        if ((Gateway_Device_Count == 0) || (Gateway_Device_Count >= UINT16_MAX)) {
+            printf("Error: Invalid number of Devices %s \n", argv[2]);
+            exit(1);
+        }
+    }
     printf("BACnet Router Demo\n"
            "BACnet Stack Version %s\n"
            "BACnet Device ID: %u\n"
            "Max APDU: %d\n"
-           "Max Devices: %d\n",
-        BACnet_Version, first_object_instance, MAX_APDU, MAX_NUM_DEVICES);
+           "Max Devices: %u\n",
+        BACnet_Version, first_object_instance, MAX_APDU, Gateway_Device_Count);
     Init_Service_Handlers(first_object_instance);
     dlenv_init();
     atexit(datalink_cleanup);
+    atexit(Routed_Device_Cleanup);
     Devices_Init(first_object_instance);
     Initialize_Device_Addresses();
 
@@ -278,11 +288,12 @@ int main(int argc, char *argv[])
             Device_Timer(elapsed_milliseconds);
         }
         handler_cov_task();
-        if (Routed_Device_Index < MAX_NUM_DEVICES) {
-            Routed_Device_Index++;
-            Get_Routed_Device_Object(Routed_Device_Index);
-            /* broadcast an I-Am for each routed Device now */
-            Send_I_Am(&Handler_Transmit_Buffer[0]);
+        /* send the waiting I-Am responses in batches, and come back
+           soon while there are more */
+        if (Routed_Device_I_Am_Task(0)) {
+            timeout = 1;
+        } else {
+            timeout = 1000;
         }
     }
     /* Dummy return */
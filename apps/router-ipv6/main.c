@@ -75,8 +75,12 @@ static DNET *Router_Table_Head;
 static uint16_t BIP_Net;
 static uint16_t BIP6_Net;
 /* buffer for receiving packets from the directly connected ports */
-static uint8_t BIP_Rx_Buffer[BIP_MPDU_MAX];
-static uint8_t BIP6_Rx_Buffer[BIP6_MPDU_MAX];
+/* the receive buffers reserve headroom so that a routed NPCI may grow
+   in front of the APDU without copying the APDU */
+static uint8_t BIP_Rx_Buffer[BACNET_PDU_HEADROOM + BIP_MPDU_MAX];
+static uint8_t BIP6_Rx_Buffer[BACNET_PDU_HEADROOM + BIP6_MPDU_MAX];
+static BACNET_PDU_BUFFER BIP_Rx_PDU;
+static BACNET_PDU_BUFFER BIP6_Rx_PDU;
 /* buffer for transmitting from any port */
 #define MAX(a, b) (((a) > (b)) ? (a) : (b))
 static uint8_t Tx_Buffer[MAX(BIP_MPDU_MAX, BIP6_MPDU_MAX)];
@@ -780,6 +784,44 @@ static void routed_src_address(
     }
 }
 
+/**
+ * Replace the NPCI of a received NPDU with the NPCI of the routed NPDU.
+ * The old NPCI is pulled from the front of the APDU and the new NPCI is
+ * pushed into its place, growing into the headroom of the buffer as
+ * needed, so that the APDU stays where it was received.
+ *
+ * @param pdu [in,out] The received NPDU, which returns the routed NPDU.
+ * @param apdu_offset [in] The number of octets of the received NPCI.
+ * @param dest [in] The BACNET_ADDRESS of the routed message's destination.
+ * @param src [in] The BACNET_ADDRESS of the routed message's source.
+ * @param npdu_data [in] The NPCI data of the routed message.
+ *
+ * @return number of bytes of the routed NPDU, or 0 if there is not
+ *  enough headroom.
+ */
+static uint16_t routed_npdu_encode(BACNET_PDU_BUFFER *pdu,
+    uint16_t apdu_offset,
+    BACNET_ADDRESS *dest,
+    BACNET_ADDRESS *src,
+    BACNET_NPDU_DATA *npdu_data)
+{
+    uint8_t *npdu = NULL;
+    int npdu_len = 0;
+
+    npdu_len = npdu_encode_pdu(NULL, dest, src, npdu_data);
+    if (!pdubuf_pull(pdu, apdu_offset)) {
+        return 0;
+    }
+    npdu = pdubuf_push(pdu, (uint16_t)npdu_len);
+    if (!npdu) {
+        (void)pdubuf_push(pdu, apdu_offset);
+        return 0;
+    }
+    npdu_encode_pdu(npdu, dest, src, npdu_data);
+
+    return pdubuf_length(pdu);
+}
+
 /**
  * If a BACnet NPDU is received with NPCI indicating that the message
  * should be relayed by virtue of the presence of a non-broadcast
@@ -796,21 +838,21 @@ static void routed_src_address(
  * @param dest [in] The BACNET_ADDRESS of the message's destination.
  * @param DNET_list [in] List of our reachable downstream BACnet Network
  * numbers. Normally just one valid entry; terminated with a -1 value.
- * @param apdu [in] The apdu portion of the request, to be processed.
- * @param apdu_len [in] The total (remaining) length of the apdu.
+ * @param pdu [in,out] The received NPDU, whose NPCI is replaced in place.
+ * @param apdu_offset [in] The number of octets of the received NPCI.
  */
 static void routed_apdu_handler(uint16_t snet,
     BACNET_NPDU_DATA *npdu,
     BACNET_ADDRESS *src,
     BACNET_ADDRESS *dest,
-    uint8_t *apdu,
-    uint16_t apdu_len)
+    BACNET_PDU_BUFFER *pdu,
+    uint16_t apdu_offset)
 {
     DNET *port = NULL;
     BACNET_ADDRESS local_dest;
     BACNET_ADDRESS remote_dest;
     BACNET_ADDRESS router_src;
-    int npdu_len = 0;
+    uint16_t pdu_len = 0;
 
     /* for broadcast messages no search is needed */
     if (dest->net == BACNET_BROADCAST_NETWORK) {
@@ -830,16 +872,18 @@ static void routed_apdu_handler(uint16_t snet,
         npdu->hop_count--;
         routed_src_address(&router_src, snet, src);
         /* encode both source and destination for broadcast */
-        npdu_len =
-            npdu_encode_pdu(&Tx_Buffer[0], &local_dest, &router_src, npdu);
-        memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
+        pdu_len = routed_npdu_encode(
+            pdu, apdu_offset, &local_dest, &router_src, npdu);
+        if (pdu_len == 0) {
+            return;
+        }
         /* send to my other ports */
         debug_printf("Routing a BROADCAST from %u\n", (unsigned)snet);
         port = Router_Table_Head;
         while (port != NULL) {
             if (port->net != snet) {
-                datalink_send_pdu(port->net, &local_dest, npdu, &Tx_Buffer[0],
-                    npdu_len + apdu_len);
+                datalink_send_pdu(port->net, &local_dest, npdu,
+                    pdubuf_data(pdu), pdu_len);
             }
             port = port->next;
         }
@@ -862,11 +906,12 @@ static void routed_apdu_handler(uint16_t snet,
             local_dest.net = 0;
             npdu->hop_count--;
             routed_src_address(&router_src, snet, src);
-            npdu_len =
-                npdu_encode_pdu(&Tx_Buffer[0], &local_dest, &router_src, npdu);
-            memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
-            datalink_send_pdu(port->net, &local_dest, npdu, &Tx_Buffer[0],
-                npdu_len + apdu_len);
+            pdu_len = routed_npdu_encode(
+                pdu, apdu_offset, &local_dest, &router_src, npdu);
+            if (pdu_len) {
+                datalink_send_pdu(port->net, &local_dest, npdu,
+                    pdubuf_data(pdu), pdu_len);
+            }
         } else {
             debug_printf(
                 "Routing to another Router %u\n", (unsigned)remote_dest.net);
@@ -879,11 +924,12 @@ static void routed_apdu_handler(uint16_t snet,
                 discarded. */
             npdu->hop_count--;
             routed_src_address(&router_src, snet, src);
-            npdu_len =
-                npdu_encode_pdu(&Tx_Buffer[0], &remote_dest, &router_src, npdu);
-            memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
-            datalink_send_pdu(port->net, &remote_dest, npdu, &Tx_Buffer[0],
-                npdu_len + apdu_len);
+            pdu_len = routed_npdu_encode(
+                pdu, apdu_offset, &remote_dest, &router_src, npdu);
+            if (pdu_len) {
+                datalink_send_pdu(port->net, &remote_dest, npdu,
+                    pdubuf_data(pdu), pdu_len);
+            }
         }
     } else if (dest->net) {
         debug_printf("Routing to Unknown Route %u\n", (unsigned)dest->net);
@@ -892,14 +938,14 @@ static void routed_apdu_handler(uint16_t snet,
         npdu->hop_count--;
         /* encode both source and destination */
         routed_src_address(&router_src, snet, src);
-        npdu_len = npdu_encode_pdu(&Tx_Buffer[0], dest, &router_src, npdu);
-        memmove(&Tx_Buffer[npdu_len], apdu, apdu_len);
+        pdu_len =
+            routed_npdu_encode(pdu, apdu_offset, dest, &router_src, npdu);
         /* send to all other ports */
         port = Router_Table_Head;
-        while (port != NULL) {
+        while ((port != NULL) && (pdu_len > 0)) {
             if (port->net != snet) {
-                datalink_send_pdu(port->net, dest, npdu, &Tx_Buffer[0],
-                	npdu_len + apdu_len);
+                datalink_send_pdu(
+                    port->net, dest, npdu, pdubuf_data(pdu), pdu_len);
             }
             port = port->next;
         }
@@ -921,16 +967,18 @@ static void routed_apdu_handler(uint16_t snet,
  *  is passed down into the apdu_handler.
  * @param DNET_list [in] List of our reachable downstream BACnet Network
  *  numbers terminated with a -1 value.
- * @param pdu [in]  Buffer containing the NPDU and APDU of the received packet.
- * @param pdu_len [in] The size of the received message in the pdu[] buffer.
+ * @param pdu_buffer [in] Buffer containing the NPDU and APDU of the
+ *  received packet, with headroom in front of it for routing.
  */
 static void my_routing_npdu_handler(
-    uint16_t snet, BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
+    uint16_t snet, BACNET_ADDRESS *src, BACNET_PDU_BUFFER *pdu_buffer)
 {
     int apdu_offset = 0;
     unsigned protocol_version = 0;
     BACNET_ADDRESS dest = { 0 };
     BACNET_NPDU_DATA npdu_data = { 0 };
+    uint8_t *pdu = pdubuf_data(pdu_buffer);
+    uint16_t pdu_len = pdubuf_length(pdu_buffer);
 
     if (!pdu) {
         /* no packet */
@@ -963,8 +1011,9 @@ static void my_routing_npdu_handler(
                     /* ConfirmedBroadcastReceived */
                     /* then enter IDLE - ignore the PDU */
                 } else {
+                    /* the APDU stays in place while the NPCI is routed */
                     routed_apdu_handler(snet, &npdu_data, src, &dest,
-                        &pdu[apdu_offset], (uint16_t)(pdu_len - apdu_offset));
+                        pdu_buffer, (uint16_t)apdu_offset);
                     /* add a Device object and application layer */
                     if ((dest.net == 0) ||
                         (dest.net == BACNET_BROADCAST_NETWORK)) {
@@ -1158,21 +1207,22 @@ int main(int argc, char *argv[])
         /* input */
         current_seconds = time(NULL);
         /* returns 0 bytes on timeout */
-        pdu_len =
-            bip_receive(&src, &BIP_Rx_Buffer[0], sizeof(BIP_Rx_Buffer), 5);
+        pdubuf_init(&BIP_Rx_PDU, &BIP_Rx_Buffer[0], sizeof(BIP_Rx_Buffer),
+            BACNET_PDU_HEADROOM);
+        pdu_len = bip_receive_buffer(&src, &BIP_Rx_PDU, 5);
         /* process */
         if (pdu_len) {
             debug_printf("BACnet/IP Received packet\n");
-            my_routing_npdu_handler(BIP_Net, &src, &BIP_Rx_Buffer[0], pdu_len);
+            my_routing_npdu_handler(BIP_Net, &src, &BIP_Rx_PDU);
         }
         /* returns 0 bytes on timeout */
-        pdu_len =
-            bip6_receive(&src, &BIP6_Rx_Buffer[0], sizeof(BIP6_Rx_Buffer), 5);
+        pdubuf_init(&BIP6_Rx_PDU, &BIP6_Rx_Buffer[0], sizeof(BIP6_Rx_Buffer),
+            BACNET_PDU_HEADROOM);
+        pdu_len = bip6_receive_buffer(&src, &BIP6_Rx_PDU, 5);
         /* process */
         if (pdu_len) {
             debug_printf("BACnet/IPv6 Received packet\n");
-            my_routing_npdu_handler(
-                BIP6_Net, &src, &BIP6_Rx_Buffer[0], pdu_len);
+            my_routing_npdu_handler(BIP6_Net, &src, &BIP6_Rx_PDU);
         }
         /* at least one second has passed */
         elapsed_seconds = (uint32_t)(current_seconds - last_seconds);
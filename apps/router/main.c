@@ -195,6 +195,10 @@ void print_help()
         "-P, --port <port>\n\tspecify udp port for BIP device\n"
         "-m, --mac <mac_address> [max_master] [max_frames]\n\tspecify MSTP "
         "port parameters\n"
+        "-f, --frames-limit <max_frames_limit> [token_rotation_limit]\n\t"
+        "let a busy MSTP port send up to <max_frames_limit> frames per token "
+        "(at most\n\tthe transmit queue size), halved while the token "
+        "rotation is longer than\n\t[token_rotation_limit] milliseconds\n"
         "-b, --baud <baud>\n\tspecify MSTP port baud rate\n"
         "-p, --parity <None|Even|Odd>\n\tspecify MSTP port parity\n"
         "-d, --databits <5|6|7|8>\n\tspecify MSTP port databits\n"
@@ -333,6 +337,20 @@ bool read_config(char *filepath)
                 } else {
                     current->params.mstp_params.max_frames = 1;
                 }
+                result = config_setting_lookup_int(
+                    port, "max_frames_limit", (int *)&param);
+                if (result && param >= 0 && param <= 255) {
+                    current->params.mstp_params.max_frames_limit = param;
+                } else {
+                    current->params.mstp_params.max_frames_limit = 0;
+                }
+                result = config_setting_lookup_int(
+                    port, "token_rotation_limit", (int *)&param);
+                if (result && param >= 0 && param <= 65535) {
+                    current->params.mstp_params.token_rotation_limit = param;
+                } else {
+                    current->params.mstp_params.token_rotation_limit = 0;
+                }
                 result = config_setting_lookup_int(port, "baud", (int *)&param);
                 if (result) {
                     current->params.mstp_params.baudrate = param;
@@ -397,13 +415,14 @@ bool parse_cmd(int argc, char *argv[])
 {
     const char *optString = "hc:D:";
     const char *bipString = "p:n:D:";
-    const char *mstpString = "m:b:p:d:s:n:D:";
+    const char *mstpString = "m:f:b:p:d:s:n:D:";
     const struct option Options[] = {
         { "config", required_argument, NULL, 'c' },
         { "device", required_argument, NULL, 'D' },
         { "network", required_argument, NULL, 'n' },
         { "port", required_argument, NULL, 'P' },
         { "mac", required_argument, NULL, 'm' },
+        { "frames-limit", required_argument, NULL, 'f' },
         { "baud", required_argument, NULL, 'b' },
         { "parity", required_argument, NULL, 'p' },
         { "databits", required_argument, NULL, 'd' },
@@ -530,6 +549,8 @@ bool parse_cmd(int argc, char *argv[])
                     current->route_info.mac_len = 1;
                     current->params.mstp_params.max_master = 127;
                     current->params.mstp_params.max_frames = 1;
+                    current->params.mstp_params.max_frames_limit = 0;
+                    current->params.mstp_params.token_rotation_limit = 0;
                     current->params.mstp_params.baudrate = 9600;
                     current->params.mstp_params.parity = PARITY_NONE;
                     current->params.mstp_params.databits = 8;
@@ -561,6 +582,21 @@ bool parse_cmd(int argc, char *argv[])
                                     }
                                 }
                                 break;
+                            case 'f':
+                                result = atoi(optarg);
+                                if (result >= 0 && result <= 255) {
+                                    current->params.mstp_params
+                                        .max_frames_limit = (uint8_t)result;
+                                }
+                                if (optind < argc && argv[optind][0] != '-') {
+                                    result = atoi(argv[optind]);
+                                    if (result >= 0 && result <= 65535) {
+                                        current->params.mstp_params
+                                            .token_rotation_limit =
+                                            (uint16_t)result;
+                                    }
+                                }
+                                break;
                             case 'b':
                                 result = atoi(optarg);
                                 if (result) {
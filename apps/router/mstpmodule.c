@@ -29,6 +29,7 @@ void *dl_mstp_thread(void *pArgs)
     ROUTER_PORT *port = (ROUTER_PORT *)pArgs;
     struct mstp_port_struct_t mstp_port = { (MSTP_RECEIVE_STATE)0 };
     volatile SHARED_MSTP_DATA shared_port_data = { 0 };
+    MSTP_TOKEN_STATISTICS token_statistics = { 0 };
     uint16_t pdu_len;
     uint8_t shutdown = 0;
 
@@ -72,6 +73,10 @@ void *dl_mstp_thread(void *pArgs)
     dlmstp_set_mac_address(&mstp_port, port->route_info.mac[0]);
     dlmstp_set_max_info_frames(&mstp_port, port->params.mstp_params.max_frames);
     dlmstp_set_max_master(&mstp_port, port->params.mstp_params.max_master);
+    dlmstp_set_max_info_frames_limit(
+        &mstp_port, port->params.mstp_params.max_frames_limit);
+    dlmstp_set_token_rotation_limit(
+        &mstp_port, port->params.mstp_params.token_rotation_limit);
     if (!dlmstp_init(&mstp_port, port->iface)) {
         printf("MSTP %s init failed. Stop.\n", port->iface);
     }
@@ -152,6 +157,15 @@ void *dl_mstp_thread(void *pArgs)
         }
     }
 
+    dlmstp_token_statistics(&mstp_port, &token_statistics);
+    mstp_thread_debug("MSTP %s: tokens %u, info frames %u, budget used up "
+                      "%u, Poll For Master %u, token rotation %ums (max %ums)\n",
+        port->iface, (unsigned)token_statistics.token_counter,
+        (unsigned)token_statistics.info_frame_counter,
+        (unsigned)token_statistics.budget_exhausted_counter,
+        (unsigned)token_statistics.poll_for_master_counter,
+        (unsigned)token_statistics.token_rotation_milliseconds,
+        (unsigned)token_statistics.token_rotation_milliseconds_max);
     dlmstp_cleanup(&mstp_port);
     port->state = FINISHED;
 
@@ -67,6 +67,9 @@ typedef union _port_params {
         uint8_t stopbits;
         uint8_t max_master;
         uint8_t max_frames;
+        /* adaptive Max_Info_Frames, off when zero */
+        uint8_t max_frames_limit;
+        uint16_t token_rotation_limit;
     } mstp_params;
 } PORT_PARAMS;
 
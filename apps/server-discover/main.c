@@ -54,6 +54,233 @@ static struct mstimer BACnet_TSM_Timer;
 static struct mstimer BACnet_Print_Timer;
 /* flag to determine if devices or both devices and objects are printed */
 static bool Print_Summary = false;
+/* files that each device is written to when its discovery is done */
+static FILE *CSV_File;
+static FILE *JSON_File;
+/* number of properties written to the current JSON object */
+static unsigned JSON_Property_Count;
+
+/**
+ * @brief Convert the property value of a ReadProperty reply to text.
+ *  A list or array of values is enclosed in braces.
+ * @param rp_data [in] the property and its application data
+ * @param str [out] buffer for the text
+ * @param str_len [in] size of the buffer
+ */
+static void discover_value_text(
+    BACNET_READ_PROPERTY_DATA *rp_data, char *str, size_t str_len)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_PROPERTY_VALUE object_value = { 0 };
+    uint8_t *apdu = rp_data->application_data;
+    int apdu_len = rp_data->application_data_len;
+    size_t offset = 0;
+    unsigned count = 0;
+    int len;
+
+    str[0] = 0;
+    object_value.object_type = rp_data->object_type;
+    object_value.object_instance = rp_data->object_instance;
+    object_value.object_property = rp_data->object_property;
+    object_value.array_index = rp_data->array_index;
+    object_value.value = &value;
+    while ((apdu_len > 0) && (offset + 2 < str_len)) {
+        len = bacapp_decode_known_property(apdu, (unsigned)apdu_len, &value,
+            rp_data->object_type, rp_data->object_property);
+        if (len <= 0) {
+            break;
+        }
+        apdu += len;
+        apdu_len -= len;
+        if ((count == 0) && (apdu_len <= 0) &&
+            (value.tag == BACNET_APPLICATION_TAG_CHARACTER_STRING)) {
+            /* a single string is written without its quotes */
+            characterstring_ansi_copy(
+                str, str_len, &value.type.Character_String);
+            return;
+        }
+        if (count == 0) {
+            if (apdu_len > 0) {
+                str[offset++] = '{';
+            }
+        } else {
+            str[offset++] = ',';
+        }
+        str[offset] = 0;
+        len = bacapp_snprintf_value(
+            &str[offset], str_len - offset, &object_value);
+        if (len > 0) {
+            offset += (size_t)len;
+            if (offset >= str_len) {
+                offset = str_len - 1;
+            }
+        }
+        count++;
+    }
+    if ((count > 1) && (offset + 1 < str_len)) {
+        str[offset++] = '}';
+        str[offset] = 0;
+    }
+}
+
+/**
+ * @brief Write a string with the quotes and escapes of JSON
+ * @param file [in] where to write
+ * @param str [in] the string to write
+ */
+static void json_string_write(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for (; *str; str++) {
+        if ((*str == '"') || (*str == '\\')) {
+            fputc('\\', file);
+            fputc(*str, file);
+        } else if ((unsigned char)*str < 0x20) {
+            fprintf(file, "\\u%04x", (unsigned)(unsigned char)*str);
+        } else {
+            fputc(*str, file);
+        }
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief Write a string with the quotes and escapes of CSV
+ * @param file [in] where to write
+ * @param str [in] the string to write
+ */
+static void csv_string_write(FILE *file, const char *str)
+{
+    fputc('"', file);
+    for (; *str; str++) {
+        if (*str == '"') {
+            fputc('"', file);
+        }
+        fputc(*str, file);
+    }
+    fputc('"', file);
+}
+
+/**
+ * @brief Write one device object property as a CSV row
+ * @return true to continue with the next property
+ */
+static bool csv_property_write(uint32_t device_id,
+    unsigned device_index,
+    unsigned object_index,
+    unsigned property_index,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    void *context)
+{
+    static char value_text[2048];
+    FILE *file = context;
+
+    (void)device_index;
+    (void)object_index;
+    (void)property_index;
+    discover_value_text(rp_data, value_text, sizeof(value_text));
+    fprintf(file, "%lu,%s,%lu,%s,", (unsigned long)device_id,
+        bactext_object_type_name(rp_data->object_type),
+        (unsigned long)rp_data->object_instance,
+        bactext_property_name(rp_data->object_property));
+    csv_string_write(file, value_text);
+    fputc('\n', file);
+
+    return true;
+}
+
+/**
+ * @brief Write one device object property as a JSON member
+ * @return true to continue with the next property
+ */
+static bool json_property_write(uint32_t device_id,
+    unsigned device_index,
+    unsigned object_index,
+    unsigned property_index,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    void *context)
+{
+    static char value_text[2048];
+    FILE *file = context;
+
+    (void)device_id;
+    (void)device_index;
+    (void)object_index;
+    (void)property_index;
+    if (JSON_Property_Count > 0) {
+        fputc(',', file);
+    }
+    JSON_Property_Count++;
+    discover_value_text(rp_data, value_text, sizeof(value_text));
+    json_string_write(file, bactext_property_name(rp_data->object_property));
+    fputc(':', file);
+    json_string_write(file, value_text);
+
+    return true;
+}
+
+/**
+ * @brief Write the objects of a device to the output files as soon as
+ *  its first discovery is done: a CSV row for each property, and a JSON
+ *  object on its own line for each object.  A device that failed, or that
+ *  was discovered again, is not written.
+ * @param device_id [in] the device instance
+ */
+static void discover_device_done(uint32_t device_id)
+{
+    BACNET_OBJECT_ID object_id = { 0 };
+    unsigned object_index, object_count;
+
+    if (bacnet_discover_device_failed(device_id)) {
+        debug_perror("device %lu - discovery failed\n",
+            (unsigned long)device_id);
+        return;
+    }
+    if (bacnet_discover_device_done_count(device_id) != 1) {
+        return;
+    }
+    if (CSV_File) {
+        bacnet_discover_device_object_iterate(
+            device_id, csv_property_write, CSV_File);
+        fflush(CSV_File);
+    }
+    if (JSON_File) {
+        object_count = bacnet_discover_device_object_count(device_id);
+        for (object_index = 0; object_index < object_count; object_index++) {
+            if (!bacnet_discover_device_object_identifier(
+                    device_id, object_index, &object_id)) {
+                continue;
+            }
+            fprintf(JSON_File,
+                "{\"device-instance\":%lu,\"object-type\":\"%s\","
+                "\"object-instance\":%lu,\"properties\":{",
+                (unsigned long)device_id,
+                bactext_object_type_name(object_id.type),
+                (unsigned long)object_id.instance);
+            JSON_Property_Count = 0;
+            bacnet_discover_device_object_property_iterate(device_id,
+                object_id.type, object_id.instance, json_property_write,
+                JSON_File);
+            fprintf(JSON_File, "}}\n");
+        }
+        fflush(JSON_File);
+    }
+}
+
+/**
+ * @brief Close the output files
+ */
+static void discover_output_cleanup(void)
+{
+    if (CSV_File) {
+        fclose(CSV_File);
+        CSV_File = NULL;
+    }
+    if (JSON_File) {
+        fclose(JSON_File);
+        JSON_File = NULL;
+    }
+}
 
 /**
  * @brief Print the list of discovered devices and their objects
@@ -173,6 +400,8 @@ static void print_usage(const char *filename)
 {
     printf("Usage: %s [--dnet]\n", filename);
     printf("       [--discover-seconds][--print-seconds][--print-summary]\n");
+    printf("       [--concurrency N][--device-concurrency N]\n");
+    printf("       [--csv filename][--json filename][--once seconds]\n");
     printf("       [--version][--help]\n");
 }
 
@@ -192,6 +421,19 @@ static void print_help(const char *filename)
            "Optional BACnet network number N for directed requests.\n"
            "Valid range is from 0 to 65535 where 0 is the local connection\n"
            "and 65535 is network broadcast.\n");
+    printf("--concurrency N:\n"
+           "Number of requests in progress at the same time (default 16).\n");
+    printf("--device-concurrency N:\n"
+           "Number of requests in progress to the same device (default 1).\n");
+    printf("--csv filename:\n"
+           "Write a row for each property of each device to the file,\n"
+           "as soon as the discovery of the device is done.\n");
+    printf("--json filename:\n"
+           "Write a JSON object for each object of each device to its own\n"
+           "line of the file, as soon as the discovery of the device is done.\n");
+    printf("--once seconds:\n"
+           "Exit when every device that answered within the seconds has\n"
+           "been discovered once, or has failed to return its object list.\n");
     (void)filename;
 }
 
@@ -211,6 +453,12 @@ int main(int argc, char *argv[])
     /* data from the command line */
     unsigned long print_seconds = 60;
     unsigned long discover_seconds = 60;
+    unsigned long once_seconds = 0;
+    unsigned concurrency = 16;
+    unsigned device_concurrency = 1;
+    const char *csv_filename = NULL;
+    const char *json_filename = NULL;
+    struct mstimer once_timer = { 0 };
     uint16_t dnet = 0;
 
     filename = filename_remove_path(argv[0]);
@@ -239,6 +487,26 @@ int main(int argc, char *argv[])
             }
         } else if (strcmp(argv[argi], "--print-summary") == 0) {
             Print_Summary = true;
+        } else if (strcmp(argv[argi], "--concurrency") == 0) {
+            if (++argi < argc) {
+                concurrency = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--device-concurrency") == 0) {
+            if (++argi < argc) {
+                device_concurrency = strtoul(argv[argi], NULL, 0);
+            }
+        } else if (strcmp(argv[argi], "--csv") == 0) {
+            if (++argi < argc) {
+                csv_filename = argv[argi];
+            }
+        } else if (strcmp(argv[argi], "--json") == 0) {
+            if (++argi < argc) {
+                json_filename = argv[argi];
+            }
+        } else if (strcmp(argv[argi], "--once") == 0) {
+            if (++argi < argc) {
+                once_seconds = strtoul(argv[argi], NULL, 0);
+            }
         } else if (strcmp(argv[argi], "--dnet") == 0) {
             if (++argi < argc) {
                 long_value = strtol(argv[argi], NULL, 0);
@@ -258,6 +526,24 @@ int main(int argc, char *argv[])
             device_id, BACNET_MAX_INSTANCE);
         return 1;
     }
+    if (csv_filename) {
+        CSV_File = fopen(csv_filename, "w");
+        if (!CSV_File) {
+            debug_perror("%s - unable to open\n", csv_filename);
+            return 1;
+        }
+        fprintf(CSV_File,
+            "device-instance,object-type,object-instance,property,value\n");
+    }
+    if (json_filename) {
+        JSON_File = fopen(json_filename, "w");
+        if (!JSON_File) {
+            debug_perror("%s - unable to open\n", json_filename);
+            discover_output_cleanup();
+            return 1;
+        }
+    }
+    atexit(discover_output_cleanup);
     Device_Set_Object_Instance_Number(device_id);
     debug_aprintf("BACnet Server-Discovery Demo\n"
                   "BACnet Stack Version %s\n"
@@ -274,8 +560,11 @@ int main(int argc, char *argv[])
     bacnet_discover_dnet_set(dnet);
     bacnet_discover_seconds_set(discover_seconds);
     bacnet_discover_init();
+    bacnet_discover_concurrency_set(concurrency, device_concurrency);
+    bacnet_discover_device_done_callback_set(discover_device_done);
     atexit(bacnet_discover_cleanup);
     mstimer_set(&BACnet_Print_Timer, print_seconds * 1000UL);
+    mstimer_set(&once_timer, once_seconds * 1000UL);
     /* loop forever */
     for (;;) {
         bacnet_server_task();
@@ -284,6 +573,11 @@ int main(int argc, char *argv[])
             mstimer_reset(&BACnet_Print_Timer);
             print_discovered_devices();
         }
+        if (once_seconds && mstimer_expired(&once_timer) &&
+            bacnet_discover_devices_done()) {
+            print_discovered_devices();
+            break;
+        }
     }
 
     return 0;
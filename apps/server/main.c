@@ -6,12 +6,20 @@
  * @date 2006
  * @copyright SPDX-License-Identifier: MIT
  */
+#include <ctype.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <signal.h>
 #include <string.h>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_POSIX 1
+#endif
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -34,6 +42,8 @@
 #include "bacnet/datetime.h"
 /* include the device object */
 #include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/journal.h"
+#include "bacnet/basic/object/snapshot.h"
 /* objects that have tasks inside them */
 #if (BACNET_PROTOCOL_REVISION >= 14)
 #include "bacnet/basic/object/lo.h"
@@ -74,8 +84,30 @@ static struct mstimer BACnet_Notification_Timer;
 #endif
 /* task timer for objects */
 static struct mstimer BACnet_Object_Timer;
+/* task timer for saving the object database snapshot */
+static struct mstimer BACnet_Snapshot_Timer;
+/* object database snapshot file, from BACNET_SNAPSHOT_FILE */
+static const char *Snapshot_Pathname;
+/* CRC-32 of the last snapshot loaded or saved */
+static uint32_t Snapshot_CRC;
+/* journal of the values written since the snapshot */
+static char Journal_Pathname[512];
+static FILE *Journal_File;
+/* journal size that causes a compaction into the snapshot */
+static unsigned long Journal_Size_Limit = 1024UL * 1024UL;
+/* time between flushes of the journal file to stable storage */
+static struct mstimer Journal_Sync_Timer;
+/* records were appended to the journal file since the last flush */
+static bool Journal_Sync_Pending;
+/* time to wait after a compaction failed, doubled on each failure */
+static struct mstimer Journal_Retry_Timer;
+static unsigned long Journal_Retry_Seconds;
+/* longest time to wait after a compaction failed */
+#define JOURNAL_RETRY_SECONDS_MAX 300UL
+#if !(defined(BACDL_ETHERNET) && defined(BACDL_ETHERNET_RECEIVE_PDUS))
 /** Buffer used for receiving */
 static uint8_t Rx_Buf[MAX_MPDU] = { 0 };
+#endif
 
 /* configure an example structured view object subordinate list */
 #if (BACNET_PROTOCOL_REVISION >= 4)
@@ -205,6 +237,9 @@ static void Init_Service_Handlers(void)
         SERVICE_CONFIRMED_WRITE_PROPERTY, handler_write_property);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_WRITE_PROP_MULTIPLE, handler_write_property_multiple);
+    /* reject a WritePropertyMultiple before anything is written */
+    handler_write_property_multiple_check_default_set(
+        Device_Write_Property_Check);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_READ_RANGE, handler_read_range);
 #if defined(BACFILE)
@@ -221,6 +256,11 @@ static void Init_Service_Handlers(void)
         SERVICE_UNCONFIRMED_TIME_SYNCHRONIZATION, handler_timesync);
     apdu_set_confirmed_handler(
         SERVICE_CONFIRMED_SUBSCRIBE_COV, handler_cov_subscribe);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        handler_cov_subscribe_property);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE,
+        handler_cov_subscribe_property_multiple);
     apdu_set_unconfirmed_handler(
         SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
     /* handle communication so we can shutup when asked */
@@ -254,6 +294,316 @@ static void Init_Service_Handlers(void)
 #endif
 }
 
+/**
+ * @brief Map a whole file into memory for reading
+ * @param pathname - name of the file
+ * @param buffer_size - number of bytes in the file
+ * @return contents of the file, or NULL if it is missing or empty
+ */
+static uint8_t *File_Map(const char *pathname, size_t *buffer_size)
+{
+    uint8_t *buffer = NULL;
+#if defined(SNAPSHOT_POSIX)
+    struct stat file_stat;
+    int fd;
+
+    fd = open(pathname, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    if ((fstat(fd, &file_stat) == 0) && (file_stat.st_size > 0)) {
+        *buffer_size = (size_t)file_stat.st_size;
+        buffer = mmap(NULL, *buffer_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (buffer == MAP_FAILED) {
+            buffer = NULL;
+        }
+    }
+    close(fd);
+#else
+    FILE *pFile;
+    long file_size;
+
+    pFile = fopen(pathname, "rb");
+    if (!pFile) {
+        return NULL;
+    }
+    if ((fseek(pFile, 0, SEEK_END) == 0) &&
+        ((file_size = ftell(pFile)) > 0) &&
+        (fseek(pFile, 0, SEEK_SET) == 0)) {
+        *buffer_size = (size_t)file_size;
+        buffer = malloc(*buffer_size);
+        if (buffer &&
+            (fread(buffer, 1, *buffer_size, pFile) != *buffer_size)) {
+            free(buffer);
+            buffer = NULL;
+        }
+    }
+    fclose(pFile);
+#endif
+
+    return buffer;
+}
+
+/**
+ * @brief Release a file mapped with File_Map()
+ * @param buffer - contents of the file
+ * @param buffer_size - number of bytes in the file
+ */
+static void File_Unmap(uint8_t *buffer, size_t buffer_size)
+{
+#if defined(SNAPSHOT_POSIX)
+    munmap(buffer, buffer_size);
+#else
+    (void)buffer_size;
+    free(buffer);
+#endif
+}
+
+/**
+ * @brief Flush a file to stable storage
+ * @param pFile - file to flush
+ * @return true if the file was flushed
+ */
+static bool File_Sync(FILE *pFile)
+{
+    if (fflush(pFile) != 0) {
+        return false;
+    }
+#if defined(SNAPSHOT_POSIX)
+    if (fsync(fileno(pFile)) != 0) {
+        return false;
+    }
+#endif
+
+    return true;
+}
+
+/**
+ * @brief Restore the objects from the snapshot file and then replay the
+ *  journal of the values written after the snapshot was saved
+ * @param pathname - name of the snapshot file
+ */
+static void Snapshot_Load(const char *pathname)
+{
+    uint8_t *buffer;
+    size_t buffer_size = 0, valid_len = 0;
+    int objects, records;
+
+    buffer = File_Map(pathname, &buffer_size);
+    if (buffer) {
+        objects = Device_Snapshot_Restore(buffer, buffer_size);
+        if (objects < 0) {
+            fprintf(stderr, "Snapshot %s is not valid.\n", pathname);
+        } else {
+            Snapshot_CRC = Device_Snapshot_Header_CRC32(buffer, buffer_size);
+            printf("Restored %d objects from %s\n", objects, pathname);
+        }
+        File_Unmap(buffer, buffer_size);
+    }
+    buffer = File_Map(Journal_Pathname, &buffer_size);
+    if (buffer) {
+        records = Device_Journal_Replay(buffer, buffer_size, &valid_len);
+        printf("Replayed %d writes from %s\n", records, Journal_Pathname);
+        if (valid_len < buffer_size) {
+            fprintf(stderr, "Journal %s ends with a partial write.\n",
+                Journal_Pathname);
+        }
+        File_Unmap(buffer, buffer_size);
+    }
+}
+
+/**
+ * @brief Save the objects to the snapshot file, if they changed.
+ *  The snapshot is written to a temporary file that replaces the
+ *  snapshot file, so a crash while saving leaves the last snapshot.
+ * @param pathname - name of the snapshot file
+ * @return true if the snapshot file holds the objects
+ */
+static bool Snapshot_Save(const char *pathname)
+{
+    char temp_pathname[512];
+    uint8_t *buffer;
+    size_t buffer_size, len;
+    uint32_t crc;
+    FILE *pFile;
+    bool status = false;
+
+    buffer_size = Device_Snapshot_Encode(NULL, 0);
+    buffer = malloc(buffer_size);
+    if (!buffer) {
+        return false;
+    }
+    len = Device_Snapshot_Encode(buffer, buffer_size);
+    if (len == 0) {
+        free(buffer);
+        return false;
+    }
+    crc = Device_Snapshot_Header_CRC32(buffer, len);
+    if (crc == Snapshot_CRC) {
+        free(buffer);
+        return true;
+    }
+    snprintf(temp_pathname, sizeof(temp_pathname), "%s.tmp", pathname);
+    pFile = fopen(temp_pathname, "wb");
+    if (pFile) {
+        status = (fwrite(buffer, 1, len, pFile) == len) && File_Sync(pFile);
+        status = (fclose(pFile) == 0) && status;
+    }
+    if (status) {
+#if !defined(SNAPSHOT_POSIX)
+        /* rename does not replace a file on some systems */
+        (void)remove(pathname);
+#endif
+        status = (rename(temp_pathname, pathname) == 0);
+    }
+    if (status) {
+        Snapshot_CRC = crc;
+    } else {
+        fprintf(stderr, "Unable to save snapshot %s\n", pathname);
+    }
+    free(buffer);
+
+    return status;
+}
+
+/**
+ * @brief Append the journal records to the journal file.  The records
+ *  reach stable storage at the next flush from Journal_Task(), so the
+ *  flush is shared by all of the records committed in between.
+ * @param context - journal file
+ * @param data - journal records
+ * @param data_len - number of bytes of journal records
+ * @return true if the records were written
+ */
+static bool Journal_Append(void *context, const uint8_t *data, size_t data_len)
+{
+    FILE *pFile = context;
+
+    if (!pFile) {
+        return false;
+    }
+    if (fwrite(data, 1, data_len, pFile) != data_len) {
+        return false;
+    }
+    if (fflush(pFile) != 0) {
+        return false;
+    }
+    Journal_Sync_Pending = true;
+
+    return true;
+}
+
+/**
+ * @brief Wait before the next compaction, longer after each failure
+ */
+static void Journal_Retry_Later(void)
+{
+    if (Journal_Retry_Seconds == 0) {
+        Journal_Retry_Seconds = 1;
+    } else if (Journal_Retry_Seconds < JOURNAL_RETRY_SECONDS_MAX) {
+        Journal_Retry_Seconds *= 2;
+        if (Journal_Retry_Seconds > JOURNAL_RETRY_SECONDS_MAX) {
+            Journal_Retry_Seconds = JOURNAL_RETRY_SECONDS_MAX;
+        }
+    }
+    mstimer_set(&Journal_Retry_Timer, Journal_Retry_Seconds * 1000UL);
+    if (Device_Journal_Overflow()) {
+        fprintf(stderr,
+            "Journal %s is full: values written are not saved until a "
+            "snapshot is saved.\n",
+            Journal_Pathname);
+    }
+    fprintf(stderr, "Unable to compact journal %s, retry in %lu seconds.\n",
+        Journal_Pathname, Journal_Retry_Seconds);
+}
+
+/**
+ * @brief Compact the journal into the snapshot: save a snapshot that
+ *  holds all of the values, and then start an empty journal.  The new
+ *  journal is opened before the snapshot is saved, and replaces the
+ *  old journal after it, so that a failure leaves the old journal open
+ *  and the records waiting.  After a failure, the compaction is not
+ *  tried again until the retry time has passed.
+ * @return true if the journal was compacted
+ */
+static bool Journal_Compact(void)
+{
+    char temp_pathname[sizeof(Journal_Pathname) + 4];
+    FILE *pFile;
+    bool status;
+
+    if ((Journal_Retry_Seconds > 0) &&
+        !mstimer_expired(&Journal_Retry_Timer)) {
+        return false;
+    }
+    snprintf(temp_pathname, sizeof(temp_pathname), "%s.tmp",
+        Journal_Pathname);
+    pFile = fopen(temp_pathname, "wb");
+    if (!pFile) {
+        Journal_Retry_Later();
+        return false;
+    }
+    if (!Snapshot_Save(Snapshot_Pathname)) {
+        fclose(pFile);
+        (void)remove(temp_pathname);
+        Journal_Retry_Later();
+        return false;
+    }
+#if !defined(SNAPSHOT_POSIX)
+    /* an open file can not be replaced on some systems */
+    if (Journal_File) {
+        fclose(Journal_File);
+        Journal_File = NULL;
+    }
+    (void)remove(Journal_Pathname);
+#endif
+    status = (rename(temp_pathname, Journal_Pathname) == 0);
+    if (!status) {
+        fclose(pFile);
+        (void)remove(temp_pathname);
+        Journal_Retry_Later();
+        return false;
+    }
+    if (Journal_File) {
+        fclose(Journal_File);
+    }
+    Journal_File = pFile;
+    Journal_Sync_Pending = false;
+    Journal_Retry_Seconds = 0;
+    Device_Journal_Reset();
+
+    return true;
+}
+
+/**
+ * @brief Commit the values written in the last second to the journal,
+ *  flush the journal to stable storage when the flush time has passed,
+ *  and compact the journal when it is large or incomplete
+ */
+static void Journal_Task(void)
+{
+    long journal_size;
+
+    if (Device_Journal_Overflow() ||
+        !Device_Journal_Commit(Journal_Append, Journal_File)) {
+        (void)Journal_Compact();
+        return;
+    }
+    if (Journal_Sync_Pending && mstimer_expired(&Journal_Sync_Timer)) {
+        mstimer_reset(&Journal_Sync_Timer);
+        if (File_Sync(Journal_File)) {
+            Journal_Sync_Pending = false;
+        } else {
+            fprintf(stderr, "Unable to flush journal %s\n", Journal_Pathname);
+        }
+    }
+    journal_size = Journal_File ? ftell(Journal_File) : 0;
+    if ((journal_size < 0) ||
+        ((unsigned long)journal_size > Journal_Size_Limit)) {
+        (void)Journal_Compact();
+    }
+}
+
 static void print_usage(const char *filename)
 {
     printf("Usage: %s [device-instance [device-name]]\n", filename);
@@ -275,6 +625,52 @@ static void print_help(const char *filename)
     printf("To simulate Device 123 named Fred, use following command:\n"
            "%s 123 Fred\n",
         filename);
+    printf("\nTo keep the objects and the values written to them across\n"
+           "restarts, set BACNET_SNAPSHOT_FILE to the name of a snapshot\n"
+           "file.  The values written are committed each second to a\n");
+    printf("journal file with the same name and .journal added, and\n"
+           "flushed to stable storage every BACNET_JOURNAL_SYNC_SECONDS\n"
+           "(5).  The journal is compacted into the snapshot when it is\n"
+           "larger than BACNET_JOURNAL_SIZE (1048576) bytes, or every\n"
+           "BACNET_SNAPSHOT_SECONDS (3600).  Properties that can not be\n"
+           "written, such as the name of most objects, are not restored.\n");
+    printf("\nTo spread out the I-Am responses on a large network, set\n"
+           "BACNET_I_AM_JITTER to the largest random delay, and\n"
+           "BACNET_I_AM_INTERVAL to the shortest time between two I-Am,\n"
+           "both in milliseconds from 0 to 65535.  Who-Is requests\n"
+           "received while an I-Am is waiting are answered by the same\n"
+           "I-Am.\n");
+}
+
+/**
+ * @brief Get a number of milliseconds from an environment variable
+ * @param name - name of the environment variable
+ * @param milliseconds [out] the number of milliseconds
+ * @return true if the variable is set to a number from 0 to 65535,
+ *  false if it is not set, or is not valid and is ignored
+ */
+static bool Environment_Milliseconds(const char *name, uint16_t *milliseconds)
+{
+    const char *pEnv;
+    char *pEnd = NULL;
+    unsigned long value;
+
+    pEnv = getenv(name);
+    if (!pEnv) {
+        return false;
+    }
+    value = strtoul(pEnv, &pEnd, 0);
+    if (!isdigit((unsigned char)pEnv[0]) || (*pEnd != 0) ||
+        (value > UINT16_MAX)) {
+        fprintf(stderr,
+            "%s=%s is not a number of milliseconds from 0 to 65535, "
+            "and is ignored.\n",
+            name, pEnv);
+        return false;
+    }
+    *milliseconds = (uint16_t)value;
+
+    return true;
 }
 
 /** Main function of server demo.
@@ -290,8 +686,10 @@ static void print_help(const char *filename)
  */
 int main(int argc, char *argv[])
 {
+#if !(defined(BACDL_ETHERNET) && defined(BACDL_ETHERNET_RECEIVE_PDUS))
     BACNET_ADDRESS src = { 0 }; /* address where message came from */
     uint16_t pdu_len = 0;
+#endif
     unsigned timeout = 1; /* milliseconds */
     uint32_t elapsed_milliseconds = 0;
     uint32_t elapsed_seconds = 0;
@@ -305,6 +703,10 @@ int main(int argc, char *argv[])
 #endif
     int argi = 0;
     const char *filename = NULL;
+    const char *pEnv = NULL;
+    unsigned long snapshot_seconds = 3600;
+    unsigned long journal_sync_seconds = 5;
+    uint16_t milliseconds = 0;
 
     filename = filename_remove_path(argv[0]);
     for (argi = 1; argi < argc; argi++) {
@@ -354,6 +756,30 @@ int main(int argc, char *argv[])
     /* initialize timesync callback function. */
     handler_timesync_set_callback_set(&datetime_timesync);
 
+    /* restore the objects and the values written before the restart */
+    Snapshot_Pathname = getenv("BACNET_SNAPSHOT_FILE");
+    if (Snapshot_Pathname) {
+        snprintf(Journal_Pathname, sizeof(Journal_Pathname), "%s.journal",
+            Snapshot_Pathname);
+        Snapshot_Load(Snapshot_Pathname);
+        (void)Journal_Compact();
+        Device_Write_Property_Store_Callback_Set(
+            Device_Journal_Write_Property);
+        pEnv = getenv("BACNET_SNAPSHOT_SECONDS");
+        if (pEnv) {
+            snapshot_seconds = strtoul(pEnv, NULL, 0);
+        }
+        mstimer_set(&BACnet_Snapshot_Timer, snapshot_seconds * 1000UL);
+        pEnv = getenv("BACNET_JOURNAL_SIZE");
+        if (pEnv) {
+            Journal_Size_Limit = strtoul(pEnv, NULL, 0);
+        }
+        pEnv = getenv("BACNET_JOURNAL_SYNC_SECONDS");
+        if (pEnv) {
+            journal_sync_seconds = strtoul(pEnv, NULL, 0);
+        }
+        mstimer_set(&Journal_Sync_Timer, journal_sync_seconds * 1000UL);
+    }
 #if defined(BAC_UCI)
     const char *uciname;
     ctx = ucix_init("bacnet_dev");
@@ -374,12 +800,23 @@ int main(int argc, char *argv[])
     if (Device_Object_Name(Device_Object_Instance_Number(), &DeviceName)) {
         printf("BACnet Device Name: %s\n", DeviceName.value);
     }
+    /* spread out the I-Am responses to a global Who-Is */
+    if (Environment_Milliseconds("BACNET_I_AM_JITTER", &milliseconds)) {
+        handler_who_is_jitter_set(milliseconds);
+    }
+    if (Environment_Milliseconds("BACNET_I_AM_INTERVAL", &milliseconds)) {
+        handler_who_is_interval_set(milliseconds);
+    }
     dlenv_init();
     atexit(datalink_cleanup);
     /* broadcast an I-Am on startup */
     Send_I_Am(&Handler_Transmit_Buffer[0]);
     /* loop forever */
     for (;;) {
+#if defined(BACDL_ETHERNET) && defined(BACDL_ETHERNET_RECEIVE_PDUS)
+        /* input and process, in place */
+        ethernet_receive_pdus(npdu_handler, timeout);
+#else
         /* input */
         pdu_len = datalink_receive(&src, &Rx_Buf[0], MAX_MPDU, timeout);
 
@@ -387,6 +824,7 @@ int main(int argc, char *argv[])
         if (pdu_len) {
             npdu_handler(&src, &Rx_Buf[0], pdu_len);
         }
+#endif
         if (mstimer_expired(&BACnet_Task_Timer)) {
             mstimer_reset(&BACnet_Task_Timer);
             elapsed_milliseconds = mstimer_interval(&BACnet_Task_Timer);
@@ -397,6 +835,9 @@ int main(int argc, char *argv[])
             dlenv_maintenance_timer(elapsed_seconds);
             handler_cov_timer_seconds(elapsed_seconds);
             trend_log_timer(elapsed_seconds);
+            if (Snapshot_Pathname) {
+                Journal_Task();
+            }
 #if defined(INTRINSIC_REPORTING)
             Device_local_reporting();
 #endif
@@ -409,6 +850,7 @@ int main(int argc, char *argv[])
             mstimer_reset(&BACnet_TSM_Timer);
             elapsed_milliseconds = mstimer_interval(&BACnet_TSM_Timer);
             tsm_timer_milliseconds(elapsed_milliseconds);
+            handler_who_is_timer(elapsed_milliseconds);
         }
         if (mstimer_expired(&BACnet_Address_Timer)) {
             mstimer_reset(&BACnet_Address_Timer);
@@ -429,6 +871,10 @@ int main(int argc, char *argv[])
             elapsed_milliseconds = mstimer_interval(&BACnet_Object_Timer);
             Device_Timer(elapsed_milliseconds);
         }
+        if (Snapshot_Pathname && mstimer_expired(&BACnet_Snapshot_Timer)) {
+            mstimer_reset(&BACnet_Snapshot_Timer);
+            (void)Journal_Compact();
+        }
     }
 
     return 0;
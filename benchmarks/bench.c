@@ -0,0 +1,299 @@
+/**
+ * @file
+ * @brief BACnet Stack microbenchmark harness
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * Each benchmark case is run with an increasing number of iterations
+ * until it runs for at least the minimum time, or for a fixed number of
+ * iterations when requested, so that results are reproducible.  Heap
+ * allocations are counted by wrapping malloc, calloc and realloc at
+ * link time when the toolchain supports it (GNU ld --wrap).
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "bacnet/version.h"
+#include "bench.h"
+
+/* minimum run time of each case, in nanoseconds */
+static uint64_t Bench_Min_Time_ns = 200000000ULL;
+/* when non-zero, the fixed number of iterations of each case */
+static uint64_t Bench_Iterations;
+/* allocation counters */
+static uint64_t Bench_Alloc_Count;
+static uint64_t Bench_Alloc_Bytes;
+/* number of results reported, for separators */
+static unsigned Bench_Report_Count;
+
+#if defined(BENCH_WRAP_MALLOC)
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+void *__wrap_malloc(size_t size);
+void *__wrap_calloc(size_t nmemb, size_t size);
+void *__wrap_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size)
+{
+    Bench_Alloc_Count++;
+    Bench_Alloc_Bytes += size;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size)
+{
+    Bench_Alloc_Count++;
+    Bench_Alloc_Bytes += (uint64_t)nmemb * size;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    Bench_Alloc_Count++;
+    Bench_Alloc_Bytes += size;
+    return __real_realloc(ptr, size);
+}
+#endif
+
+/**
+ * @brief Determine if heap allocations are being counted
+ * @return true if allocations are counted
+ */
+bool bench_alloc_tracking(void)
+{
+#if defined(BENCH_WRAP_MALLOC)
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Reset the heap allocation counters
+ */
+void bench_alloc_reset(void)
+{
+    Bench_Alloc_Count = 0;
+    Bench_Alloc_Bytes = 0;
+}
+
+/**
+ * @brief Get the number of heap allocations since the last reset
+ * @return number of heap allocations
+ */
+uint64_t bench_alloc_count(void)
+{
+    return Bench_Alloc_Count;
+}
+
+/**
+ * @brief Get the number of heap bytes allocated since the last reset
+ * @return number of bytes allocated
+ */
+uint64_t bench_alloc_bytes(void)
+{
+    return Bench_Alloc_Bytes;
+}
+
+/**
+ * @brief Get a monotonic timestamp
+ * @return monotonic time in nanoseconds
+ */
+uint64_t bench_clock_ns(void)
+{
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Keep the optimizer from discarding a computed value
+ * @param data - pointer to the computed value
+ */
+void bench_do_not_optimize(const void *data)
+{
+    static const void *volatile Sink;
+
+    Sink = data;
+}
+
+/**
+ * @brief Set the minimum run time of each benchmark case
+ * @param milliseconds - minimum run time
+ */
+void bench_min_time_set(uint64_t milliseconds)
+{
+    Bench_Min_Time_ns = milliseconds * 1000000ULL;
+}
+
+/**
+ * @brief Set a fixed number of iterations for each benchmark case
+ * @param iterations - number of iterations, or zero to calibrate
+ */
+void bench_iterations_set(uint64_t iterations)
+{
+    Bench_Iterations = iterations;
+}
+
+/**
+ * @brief Run one timed pass of a benchmark case
+ * @param bench - benchmark case
+ * @param context - benchmark context from setup
+ * @param iterations - number of iterations
+ * @param result - timing and allocations of this pass
+ */
+static void bench_case_pass(const BENCH_CASE *bench,
+    void *context,
+    uint64_t iterations,
+    BENCH_RESULT *result)
+{
+    uint64_t start;
+
+    bench_alloc_reset();
+    start = bench_clock_ns();
+    bench->run(context, iterations);
+    result->elapsed_ns = bench_clock_ns() - start;
+    result->iterations = iterations;
+    result->allocs_per_op = (double)bench_alloc_count() / (double)iterations;
+    result->bytes_per_op = (double)bench_alloc_bytes() / (double)iterations;
+    result->ns_per_op = (double)result->elapsed_ns / (double)iterations;
+}
+
+/**
+ * @brief Run a benchmark case
+ * @param bench - benchmark case
+ * @param result - results of the benchmark
+ * @return true if the benchmark ran
+ */
+bool bench_case_run(const BENCH_CASE *bench, BENCH_RESULT *result)
+{
+    void *context = NULL;
+    uint64_t iterations = 1;
+
+    if (!bench || !bench->run || !result) {
+        return false;
+    }
+    if (bench->setup) {
+        context = bench->setup();
+        if (!context) {
+            return false;
+        }
+    }
+    result->group = bench->group;
+    result->name = bench->name;
+    /* warm up caches and lazily created state */
+    bench->run(context, 1);
+    if (Bench_Iterations) {
+        bench_case_pass(bench, context, Bench_Iterations, result);
+    } else {
+        for (;;) {
+            bench_case_pass(bench, context, iterations, result);
+            if ((result->elapsed_ns >= Bench_Min_Time_ns) ||
+                (iterations >= (UINT64_MAX / 2))) {
+                break;
+            }
+            if (result->elapsed_ns < (Bench_Min_Time_ns / 100)) {
+                iterations *= 10;
+            } else {
+                iterations *= 2;
+            }
+        }
+    }
+    if (bench->teardown) {
+        bench->teardown(context);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Start the benchmark report
+ * @param format - report format
+ */
+void bench_report_begin(BENCH_FORMAT format)
+{
+    Bench_Report_Count = 0;
+    switch (format) {
+        case BENCH_FORMAT_JSON:
+            printf("{\n  \"context\": {\n");
+            printf("    \"library\": \"bacnet-stack\",\n");
+            printf("    \"version\": \"%s\",\n", BACNET_VERSION_TEXT);
+            printf("    \"timestamp\": %lu,\n", (unsigned long)time(NULL));
+            printf("    \"alloc_tracking\": %s\n",
+                bench_alloc_tracking() ? "true" : "false");
+            printf("  },\n  \"benchmarks\": [");
+            break;
+        case BENCH_FORMAT_CSV:
+            printf("group,name,iterations,ns_per_op,allocs_per_op,"
+                   "bytes_per_op\n");
+            break;
+        case BENCH_FORMAT_TEXT:
+        default:
+            printf("%-8s %-44s %12s %14s %10s %12s\n", "group", "name",
+                "iterations", "ns/op", "allocs/op", "bytes/op");
+            break;
+    }
+    fflush(stdout);
+}
+
+/**
+ * @brief Report one benchmark result
+ * @param format - report format
+ * @param result - benchmark result
+ */
+void bench_report_result(BENCH_FORMAT format, const BENCH_RESULT *result)
+{
+    if (!result) {
+        return;
+    }
+    switch (format) {
+        case BENCH_FORMAT_JSON:
+            printf("%s\n    {\"group\": \"%s\", \"name\": \"%s\", "
+                   "\"iterations\": %llu, \"ns_per_op\": %.2f, "
+                   "\"allocs_per_op\": %.3f, \"bytes_per_op\": %.1f}",
+                Bench_Report_Count ? "," : "", result->group, result->name,
+                (unsigned long long)result->iterations, result->ns_per_op,
+                result->allocs_per_op, result->bytes_per_op);
+            break;
+        case BENCH_FORMAT_CSV:
+            printf("%s,%s,%llu,%.2f,%.3f,%.1f\n", result->group, result->name,
+                (unsigned long long)result->iterations, result->ns_per_op,
+                result->allocs_per_op, result->bytes_per_op);
+            break;
+        case BENCH_FORMAT_TEXT:
+        default:
+            printf("%-8s %-44s %12llu %14.2f %10.3f %12.1f\n", result->group,
+                result->name, (unsigned long long)result->iterations,
+                result->ns_per_op, result->allocs_per_op,
+                result->bytes_per_op);
+            break;
+    }
+    Bench_Report_Count++;
+    fflush(stdout);
+}
+
+/**
+ * @brief Finish the benchmark report
+ * @param format - report format
+ */
+void bench_report_end(BENCH_FORMAT format)
+{
+    switch (format) {
+        case BENCH_FORMAT_JSON:
+            printf("\n  ]\n}\n");
+            break;
+        case BENCH_FORMAT_CSV:
+        case BENCH_FORMAT_TEXT:
+        default:
+            break;
+    }
+    fflush(stdout);
+}
@@ -0,0 +1,76 @@
+/**
+ * @file
+ * @brief API for the BACnet Stack microbenchmark harness
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BENCH_H
+#define BACNET_BENCH_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+/* run the benchmark body for the given number of iterations */
+typedef void (*bench_function)(void *context, uint64_t iterations);
+/* optional setup and teardown of the benchmark context */
+typedef void *(*bench_setup_function)(void);
+typedef void (*bench_teardown_function)(void *context);
+
+typedef struct bench_case {
+    const char *group;
+    const char *name;
+    bench_setup_function setup;
+    bench_function run;
+    bench_teardown_function teardown;
+} BENCH_CASE;
+
+typedef struct bench_result {
+    const char *group;
+    const char *name;
+    uint64_t iterations;
+    uint64_t elapsed_ns;
+    double ns_per_op;
+    double allocs_per_op;
+    double bytes_per_op;
+} BENCH_RESULT;
+
+typedef enum bench_format {
+    BENCH_FORMAT_TEXT = 0,
+    BENCH_FORMAT_JSON,
+    BENCH_FORMAT_CSV
+} BENCH_FORMAT;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+uint64_t bench_clock_ns(void);
+bool bench_alloc_tracking(void);
+void bench_alloc_reset(void);
+uint64_t bench_alloc_count(void);
+uint64_t bench_alloc_bytes(void);
+
+void bench_min_time_set(uint64_t milliseconds);
+void bench_iterations_set(uint64_t iterations);
+bool bench_case_run(const BENCH_CASE *bench, BENCH_RESULT *result);
+
+void bench_report_begin(BENCH_FORMAT format);
+void bench_report_result(BENCH_FORMAT format, const BENCH_RESULT *result);
+void bench_report_end(BENCH_FORMAT format);
+
+/* keep the optimizer from discarding a computed value */
+void bench_do_not_optimize(const void *data);
+
+/* the benchmark cases, grouped by module */
+extern const BENCH_CASE Bench_Codec_Cases[];
+extern const size_t Bench_Codec_Cases_Count;
+extern const BENCH_CASE Bench_Sys_Cases[];
+extern const size_t Bench_Sys_Cases_Count;
+extern const BENCH_CASE Bench_Handler_Cases[];
+extern const size_t Bench_Handler_Cases_Count;
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -0,0 +1,298 @@
+/**
+ * @file
+ * @brief Microbenchmarks for the BACnet encoders and decoders
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/bactext.h"
+#include "bacnet/rpm.h"
+#include "bacnet/tag_reader.h"
+#include "bacnet/basic/service/h_rpm_a.h"
+#include "bench.h"
+
+/* number of elements in the large Object_List test value */
+#define BENCH_OBJECT_LIST_SIZE 500
+
+typedef struct bench_codec_context {
+    BACNET_APPLICATION_DATA_VALUE value;
+    uint8_t apdu[MAX_APDU];
+    int apdu_len;
+    /* large enough for an Object_List of BENCH_OBJECT_LIST_SIZE */
+    uint8_t list[BENCH_OBJECT_LIST_SIZE * 5 + 16];
+    int list_len;
+} BENCH_CODEC_CONTEXT;
+
+static void *bench_codec_setup(void)
+{
+    BENCH_CODEC_CONTEXT *context;
+    unsigned i;
+
+    context = calloc(1, sizeof(BENCH_CODEC_CONTEXT));
+    if (context) {
+        context->list_len = encode_opening_tag(&context->list[0], 3);
+        for (i = 0; i < BENCH_OBJECT_LIST_SIZE; i++) {
+            context->list_len += encode_application_object_id(
+                &context->list[context->list_len], OBJECT_ANALOG_VALUE, i);
+        }
+        context->list_len +=
+            encode_closing_tag(&context->list[context->list_len], 3);
+    }
+
+    return context;
+}
+
+static void bench_codec_teardown(void *context)
+{
+    free(context);
+}
+
+static void bench_encode_real(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+
+    context->value.tag = BACNET_APPLICATION_TAG_REAL;
+    for (i = 0; i < iterations; i++) {
+        context->value.type.Real = (float)i;
+        context->apdu_len =
+            bacapp_encode_application_data(context->apdu, &context->value);
+    }
+    bench_do_not_optimize(context->apdu);
+}
+
+static void bench_encode_enumerated(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+
+    context->value.tag = BACNET_APPLICATION_TAG_ENUMERATED;
+    for (i = 0; i < iterations; i++) {
+        context->value.type.Enumerated = (uint32_t)i;
+        context->apdu_len =
+            bacapp_encode_application_data(context->apdu, &context->value);
+    }
+    bench_do_not_optimize(context->apdu);
+}
+
+static void bench_encode_character_string(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+
+    context->value.tag = BACNET_APPLICATION_TAG_CHARACTER_STRING;
+    characterstring_init_ansi(
+        &context->value.type.Character_String, "Zone-Temperature-Setpoint");
+    for (i = 0; i < iterations; i++) {
+        context->apdu_len =
+            bacapp_encode_application_data(context->apdu, &context->value);
+    }
+    bench_do_not_optimize(context->apdu);
+}
+
+static void bench_decode_real(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+
+    context->apdu_len = encode_application_real(context->apdu, 72.5f);
+    for (i = 0; i < iterations; i++) {
+        bacapp_decode_application_data(
+            context->apdu, context->apdu_len, &context->value);
+    }
+    bench_do_not_optimize(&context->value);
+}
+
+static void bench_decode_object_id(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+
+    context->apdu_len =
+        encode_application_object_id(context->apdu, OBJECT_DEVICE, 260001);
+    for (i = 0; i < iterations; i++) {
+        bacapp_decode_application_data(
+            context->apdu, context->apdu_len, &context->value);
+    }
+    bench_do_not_optimize(&context->value);
+}
+
+static void bench_object_list_decode_values(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    uint64_t i;
+    int len, offset;
+
+    for (i = 0; i < iterations; i++) {
+        /* skip the opening tag, stop at the closing tag */
+        offset = 1;
+        while (offset < (context->list_len - 1)) {
+            len = bacapp_decode_application_data(&context->list[offset],
+                context->list_len - offset, &context->value);
+            if (len <= 0) {
+                break;
+            }
+            offset += len;
+        }
+    }
+    bench_do_not_optimize(&context->value);
+}
+
+static void bench_object_list_tag_reader(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    BACNET_TAG_READER reader;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        bacnet_tag_reader_init(&reader, context->list, context->list_len);
+        (void)bacnet_tag_reader_skip(&reader);
+    }
+    bench_do_not_optimize(&reader);
+}
+
+static void bench_object_list_array_decode(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    BACNET_OBJECT_ID object_list[BENCH_OBJECT_LIST_SIZE];
+    uint32_t count = 0;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        bacnet_object_id_application_array_decode(&context->list[1],
+            context->list_len - 1, object_list, BENCH_OBJECT_LIST_SIZE,
+            &count);
+    }
+    bench_do_not_optimize(object_list);
+}
+
+static void bench_rpm_ack_decode(void *data, uint64_t iterations)
+{
+    BENCH_CODEC_CONTEXT *context = data;
+    BACNET_READ_ACCESS_DATA *rpm_data;
+    BACNET_RPM_DATA rpmdata = { 0 };
+    BACNET_BIT_STRING status_flags = { 0 };
+    uint8_t value[16];
+    int value_len;
+    uint64_t i;
+    int len = 0;
+    unsigned p;
+
+    /* typical COV-like poll: 3 objects with 4 properties each */
+    bitstring_init(&status_flags);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_FAULT, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(&status_flags, STATUS_FLAG_OUT_OF_SERVICE, false);
+    for (p = 0; p < 3; p++) {
+        rpmdata.object_type = OBJECT_ANALOG_INPUT;
+        rpmdata.object_instance = p + 1;
+        len += rpm_ack_encode_apdu_object_begin(&context->apdu[len], &rpmdata);
+        len += rpm_ack_encode_apdu_object_property(
+            &context->apdu[len], PROP_PRESENT_VALUE, BACNET_ARRAY_ALL);
+        value_len = encode_application_real(value, 72.5f);
+        len += rpm_ack_encode_apdu_object_property_value(
+            &context->apdu[len], value, value_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &context->apdu[len], PROP_STATUS_FLAGS, BACNET_ARRAY_ALL);
+        value_len = encode_application_bitstring(value, &status_flags);
+        len += rpm_ack_encode_apdu_object_property_value(
+            &context->apdu[len], value, value_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &context->apdu[len], PROP_UNITS, BACNET_ARRAY_ALL);
+        value_len =
+            encode_application_enumerated(value, UNITS_DEGREES_FAHRENHEIT);
+        len += rpm_ack_encode_apdu_object_property_value(
+            &context->apdu[len], value, value_len);
+        len += rpm_ack_encode_apdu_object_property(
+            &context->apdu[len], PROP_OUT_OF_SERVICE, BACNET_ARRAY_ALL);
+        value_len = encode_application_boolean(value, false);
+        len += rpm_ack_encode_apdu_object_property_value(
+            &context->apdu[len], value, value_len);
+        len += rpm_ack_encode_apdu_object_end(&context->apdu[len]);
+    }
+    context->apdu_len = len;
+    for (i = 0; i < iterations; i++) {
+        rpm_data = calloc(1, sizeof(BACNET_READ_ACCESS_DATA));
+        if (!rpm_data) {
+            break;
+        }
+        (void)rpm_ack_decode_service_request(
+            context->apdu, context->apdu_len, rpm_data);
+        while (rpm_data) {
+            rpm_data = rpm_data_free(rpm_data);
+        }
+    }
+}
+
+/* property and unit names, from the end of their text lists */
+static const char *Bench_Text_Names[] = { "trim-fade-time", "low-end-trim",
+    "Present-Value", "object-list", "DEGREES-FAHRENHEIT", "not-a-name" };
+
+static void bench_text_property_index(void *context, uint64_t iterations)
+{
+    unsigned found_index = 0, sum = 0;
+    uint64_t i;
+
+    (void)context;
+    for (i = 0; i < iterations; i++) {
+        if (bactext_property_index(
+                Bench_Text_Names[i % 6], &found_index)) {
+            sum += found_index;
+        }
+        if (bactext_engineering_unit_index(
+                Bench_Text_Names[i % 6], &found_index)) {
+            sum += found_index;
+        }
+    }
+    bench_do_not_optimize(&sum);
+}
+
+static void bench_text_property_name(void *context, uint64_t iterations)
+{
+    const char *name = NULL;
+    uint64_t i;
+
+    (void)context;
+    for (i = 0; i < iterations; i++) {
+        name = bactext_property_name(PROP_TRIM_FADE_TIME - (i % 4));
+        name = bactext_engineering_unit_name(UNITS_DEGREES_FAHRENHEIT);
+    }
+    bench_do_not_optimize(&name);
+}
+
+const BENCH_CASE Bench_Codec_Cases[] = {
+    { "codec", "bacapp_encode_application_data/real", bench_codec_setup,
+        bench_encode_real, bench_codec_teardown },
+    { "codec", "bacapp_encode_application_data/enumerated", bench_codec_setup,
+        bench_encode_enumerated, bench_codec_teardown },
+    { "codec", "bacapp_encode_application_data/string", bench_codec_setup,
+        bench_encode_character_string, bench_codec_teardown },
+    { "codec", "bacapp_decode_application_data/real", bench_codec_setup,
+        bench_decode_real, bench_codec_teardown },
+    { "codec", "bacapp_decode_application_data/object_id", bench_codec_setup,
+        bench_decode_object_id, bench_codec_teardown },
+    { "codec", "object_list_500/bacapp_decode", bench_codec_setup,
+        bench_object_list_decode_values, bench_codec_teardown },
+    { "codec", "object_list_500/tag_reader_skip", bench_codec_setup,
+        bench_object_list_tag_reader, bench_codec_teardown },
+    { "codec", "object_list_500/array_decode", bench_codec_setup,
+        bench_object_list_array_decode, bench_codec_teardown },
+    { "codec", "rpm_ack_decode_service_request/3x4", bench_codec_setup,
+        bench_rpm_ack_decode, bench_codec_teardown },
+    { "codec", "bactext_property_index/unit_index", NULL,
+        bench_text_property_index, NULL },
+    { "codec", "bactext_property_name/unit_name", NULL,
+        bench_text_property_name, NULL },
+};
+const size_t Bench_Codec_Cases_Count =
+    sizeof(Bench_Codec_Cases) / sizeof(Bench_Codec_Cases[0]);
@@ -0,0 +1,600 @@
+/**
+ * @file
+ * @brief Microbenchmarks for the BACnet service handlers on a large device
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The handlers are called directly with pre-encoded requests.  The
+ * responses are encoded in full and passed to the datalink, which drops
+ * them because it has not been initialized, so the results measure the
+ * stack without any network I/O.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacdcode.h"
+#include "bacnet/cov.h"
+#include "bacnet/npdu.h"
+#include "bacnet/readrange.h"
+#include "bacnet/rp.h"
+#include "bacnet/rpm.h"
+#include "bacnet/whois.h"
+#include "bacnet/wpm.h"
+#include "bacnet/basic/npdu/h_npdu.h"
+#if defined(BACDL_BIP)
+#include "bacnet/basic/bbmd/h_bbmd.h"
+#endif
+#include "bacnet/basic/object/av.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/lo.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/datalink/datalink.h"
+#if defined(BACDL_BIP)
+#include "bacnet/datalink/bvlc.h"
+#endif
+#include "bench.h"
+
+/* number of objects in the benchmark device */
+#define BENCH_DEVICE_OBJECTS 10000
+#define BENCH_DEVICE_INSTANCE 260001
+
+typedef struct bench_handler_context {
+    BACNET_ADDRESS src;
+    BACNET_CONFIRMED_SERVICE_DATA service_data;
+    uint8_t request[MAX_APDU];
+    uint16_t request_len;
+} BENCH_HANDLER_CONTEXT;
+
+/**
+ * @brief Create the benchmark device once, since populating it with
+ *  many objects takes longer than most of the benchmarks.
+ */
+static void bench_device_init(void)
+{
+    static bool initialized;
+    uint32_t instance;
+
+    if (initialized) {
+        return;
+    }
+    Device_Init(NULL);
+    /* the requests use Device_Object_Instance_Number(), which is the
+       routed device instance when BAC_ROUTING is enabled */
+    Device_Set_Object_Instance_Number(BENCH_DEVICE_INSTANCE);
+    for (instance = 1; instance <= BENCH_DEVICE_OBJECTS; instance++) {
+        (void)Analog_Value_Create(instance);
+    }
+    apdu_set_unconfirmed_handler(SERVICE_UNCONFIRMED_WHO_IS, handler_who_is);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_READ_PROPERTY, handler_read_property);
+    apdu_set_confirmed_handler(SERVICE_CONFIRMED_READ_PROP_MULTIPLE,
+        handler_read_property_multiple);
+    initialized = true;
+}
+
+static BENCH_HANDLER_CONTEXT *bench_handler_context(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+
+    bench_device_init();
+    context = calloc(1, sizeof(BENCH_HANDLER_CONTEXT));
+    if (context) {
+        context->src.mac_len = 6;
+        context->src.mac[0] = 192;
+        context->src.mac[1] = 168;
+        context->src.mac[3] = 10;
+        context->src.mac[4] = 0xBA;
+        context->src.mac[5] = 0xC0;
+        context->service_data.max_resp = MAX_APDU;
+        context->service_data.invoke_id = 1;
+    }
+
+    return context;
+}
+
+static void bench_handler_teardown(void *context)
+{
+    free(context);
+}
+
+static void *bench_rpm_all_object_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    int len = 0;
+
+    context = bench_handler_context();
+    if (context) {
+        /* the last object is the worst case for any linear lookup */
+        len += rpm_encode_apdu_object_begin(&context->request[len],
+            OBJECT_ANALOG_VALUE, BENCH_DEVICE_OBJECTS);
+        len += rpm_encode_apdu_object_property(
+            &context->request[len], PROP_ALL, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_end(&context->request[len]);
+        context->request_len = (uint16_t)len;
+    }
+
+    return context;
+}
+
+static void *bench_rpm_all_device_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    int len = 0;
+
+    context = bench_handler_context();
+    if (context) {
+        /* the Object_List does not fit, so the response is an abort,
+           but every property is still encoded */
+        len += rpm_encode_apdu_object_begin(&context->request[len],
+            OBJECT_DEVICE, Device_Object_Instance_Number());
+        len += rpm_encode_apdu_object_property(
+            &context->request[len], PROP_ALL, BACNET_ARRAY_ALL);
+        len += rpm_encode_apdu_object_end(&context->request[len]);
+        context->request_len = (uint16_t)len;
+    }
+
+    return context;
+}
+
+static void bench_rpm(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        context->service_data.invoke_id = (uint8_t)i;
+        handler_read_property_multiple(context->request, context->request_len,
+            &context->src, &context->service_data);
+    }
+}
+
+static void *bench_rp_object_list_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+
+    context = bench_handler_context();
+    if (context) {
+        rpdata.object_type = OBJECT_DEVICE;
+        rpdata.object_instance = Device_Object_Instance_Number();
+        rpdata.object_property = PROP_OBJECT_LIST;
+        rpdata.array_index = BENCH_DEVICE_OBJECTS;
+        context->request_len =
+            (uint16_t)read_property_request_service_encode(context->request,
+                sizeof(context->request), &rpdata);
+    }
+
+    return context;
+}
+
+static void bench_rp(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        context->service_data.invoke_id = (uint8_t)i;
+        handler_read_property(context->request, context->request_len,
+            &context->src, &context->service_data);
+    }
+}
+
+static void *bench_rr_object_list_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_READ_RANGE_DATA rrdata = { 0 };
+
+    context = bench_handler_context();
+    if (context) {
+        /* the last 200 identifiers of the Object_List */
+        rrdata.object_type = OBJECT_DEVICE;
+        rrdata.object_instance = Device_Object_Instance_Number();
+        rrdata.object_property = PROP_OBJECT_LIST;
+        rrdata.array_index = BACNET_ARRAY_ALL;
+        rrdata.RequestType = RR_BY_POSITION;
+        rrdata.Range.RefIndex = BENCH_DEVICE_OBJECTS + 1;
+        rrdata.Count = -200;
+        context->request_len = (uint16_t)read_range_request_encode(
+            context->request, sizeof(context->request), &rrdata);
+    }
+
+    return context;
+}
+
+static void bench_rr(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        context->service_data.invoke_id = (uint8_t)i;
+        handler_read_range(context->request, context->request_len,
+            &context->src, &context->service_data);
+    }
+}
+
+static void *bench_wpm_present_value_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint32_t instance;
+    int len = 0;
+
+    context = bench_handler_context();
+    if (context) {
+        /* a batch of setpoints, one per object */
+        wp_data.object_property = PROP_PRESENT_VALUE;
+        wp_data.array_index = BACNET_ARRAY_ALL;
+        wp_data.priority = 8;
+        wp_data.application_data_len =
+            encode_application_real(wp_data.application_data, 21.5f);
+        for (instance = 1; instance <= 50; instance++) {
+            len += wpm_encode_apdu_object_begin(
+                &context->request[len], OBJECT_ANALOG_VALUE, instance);
+            len += wpm_encode_apdu_object_property(
+                &context->request[len], &wp_data);
+            len += wpm_encode_apdu_object_end(&context->request[len]);
+        }
+        context->request_len = (uint16_t)len;
+    }
+
+    return context;
+}
+
+static void bench_wpm(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        context->service_data.invoke_id = (uint8_t)i;
+        handler_write_property_multiple(context->request,
+            context->request_len, &context->src, &context->service_data);
+    }
+}
+
+static void *bench_whois_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    int len = 0;
+
+    context = bench_handler_context();
+    if (context) {
+        /* a global broadcast Who-Is with no limits, so every one of
+           them is answered with an I-Am */
+        dest.net = BACNET_BROADCAST_NETWORK;
+        npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+        len = npdu_encode_pdu(&context->request[0], &dest, NULL, &npdu_data);
+        len += whois_encode_apdu(&context->request[len], -1, -1);
+        context->request_len = (uint16_t)len;
+    }
+
+    return context;
+}
+
+static void bench_whois_storm(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        /* a different requester each time */
+        context->src.mac[2] = (uint8_t)i;
+        npdu_handler(&context->src, context->request, context->request_len);
+    }
+}
+
+/* lighting outputs in the benchmark device, and how many are fading */
+#define BENCH_LIGHTING_OUTPUTS 5000
+#define BENCH_LIGHTING_FADES 500
+
+static void *bench_lighting_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint32_t instance;
+
+    context = bench_handler_context();
+    if (context) {
+        for (instance = 1; instance <= BENCH_LIGHTING_OUTPUTS; instance++) {
+            (void)Lighting_Output_Create(instance);
+        }
+        /* a scene change with the longest fade, so that the fades
+           are still in progress at the end of the benchmark */
+        wp_data.object_type = OBJECT_LIGHTING_OUTPUT;
+        wp_data.object_property = PROP_PRESENT_VALUE;
+        wp_data.array_index = BACNET_ARRAY_ALL;
+        wp_data.priority = 8;
+        wp_data.application_data_len =
+            encode_application_real(wp_data.application_data, 100.0f);
+        for (instance = 1; instance <= BENCH_LIGHTING_FADES; instance++) {
+            (void)Lighting_Output_Default_Fade_Time_Set(instance, 86400000UL);
+            wp_data.object_instance = instance;
+            (void)Lighting_Output_Write_Property(&wp_data);
+        }
+    }
+
+    return context;
+}
+
+static void bench_lighting_teardown(void *context)
+{
+    uint32_t instance;
+
+    for (instance = 1; instance <= BENCH_LIGHTING_OUTPUTS; instance++) {
+        (void)Lighting_Output_Delete(instance);
+    }
+    free(context);
+}
+
+static void bench_device_timer(void *data, uint64_t iterations)
+{
+    uint64_t i;
+
+    (void)data;
+    for (i = 0; i < iterations; i++) {
+        Device_Timer(1);
+    }
+}
+
+/* subscriptions to one object, the default size of the subscription
+   list, from the default number of subscriber addresses */
+#define BENCH_COV_SUBSCRIPTIONS 128
+#define BENCH_COV_SUBSCRIBERS 16
+
+static void *bench_cov_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    /* room to list every subscription, to check that they were made */
+    static uint8_t apdu[BENCH_COV_SUBSCRIPTIONS * 64];
+    unsigned i;
+
+    context = bench_handler_context();
+    if (context) {
+        handler_cov_init();
+        (void)Analog_Value_Present_Value_Set(1, 0.0f, BACNET_MAX_PRIORITY);
+        /* unconfirmed notifications, so that no TSM slot limits them */
+        cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+        cov_data.monitoredObjectIdentifier.instance = 1;
+        cov_data.issueConfirmedNotifications = false;
+        cov_data.lifetime = 0;
+        for (i = 0; i < BENCH_COV_SUBSCRIPTIONS; i++) {
+            /* several processes in each subscriber */
+            cov_data.subscriberProcessIdentifier =
+                1 + (i / BENCH_COV_SUBSCRIBERS);
+            context->request_len =
+                (uint16_t)cov_subscribe_service_request_encode(
+                    context->request, sizeof(context->request), &cov_data);
+            context->src.mac[2] = (uint8_t)(i % BENCH_COV_SUBSCRIBERS);
+            handler_cov_subscribe(context->request, context->request_len,
+                &context->src, &context->service_data);
+        }
+        if (handler_cov_encode_subscriptions(apdu, (int)sizeof(apdu)) <= 0) {
+            handler_cov_init();
+            free(context);
+            return NULL;
+        }
+        /* start the benchmark with the task idle */
+        while (!handler_cov_fsm()) {
+        }
+    }
+
+    return context;
+}
+
+static void bench_cov_teardown(void *context)
+{
+    handler_cov_init();
+    free(context);
+}
+
+static void bench_cov_fan_out(void *data, uint64_t iterations)
+{
+    uint64_t i;
+
+    (void)data;
+    for (i = 0; i < iterations; i++) {
+        /* a change larger than the COV increment, notified to all */
+        (void)Analog_Value_Present_Value_Set(
+            1, (i & 1) ? 0.0f : 100.0f, BACNET_MAX_PRIORITY);
+        while (!handler_cov_fsm()) {
+        }
+    }
+}
+
+#if defined(BACDL_BIP)
+/* peer BBMDs in the BDT, and foreign devices registered in the FDT */
+#define BENCH_BBMD_PEERS 64
+#define BENCH_BBMD_FOREIGN_DEVICES 64
+
+static void bench_bbmd_tables_clear(void)
+{
+    BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bdt_entry;
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry;
+
+    for (bdt_entry = bvlc_bdt_list(); bdt_entry; bdt_entry = bdt_entry->next) {
+        bdt_entry->valid = false;
+    }
+    for (fdt_entry = bvlc_fdt_list(); fdt_entry; fdt_entry = fdt_entry->next) {
+        fdt_entry->valid = false;
+    }
+}
+
+static void *bench_bbmd_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    BACNET_IP_BROADCAST_DISTRIBUTION_TABLE_ENTRY *bdt_entry;
+    BACNET_IP_FOREIGN_DEVICE_TABLE_ENTRY *fdt_entry;
+    BACNET_IP_BROADCAST_DISTRIBUTION_MASK mask = { 0 };
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_APDU];
+    unsigned count = 0;
+    unsigned i;
+    int len;
+
+    context = bench_handler_context();
+    if (!context) {
+        return NULL;
+    }
+    bvlc_init();
+    bench_bbmd_tables_clear();
+    /* the peer BBMDs, each on its own subnet with a unicast mask */
+    (void)bvlc_broadcast_distribution_mask_from_host(&mask, 0xFFFFFFFFUL);
+    bdt_entry = bvlc_bdt_list();
+    for (i = 0; bdt_entry && (i < BENCH_BBMD_PEERS); i++) {
+        (void)bvlc_address_set(&addr, 10, 1, (uint8_t)i, 1);
+        addr.port = 0xBAC0;
+        (void)bvlc_broadcast_distribution_table_entry_set(
+            bdt_entry, &addr, &mask);
+        bdt_entry->valid = true;
+        bdt_entry = bdt_entry->next;
+    }
+    /* the foreign devices register themselves */
+    len = bvlc_encode_register_foreign_device(pdu, sizeof(pdu), 3600);
+    for (i = 0; i < BENCH_BBMD_FOREIGN_DEVICES; i++) {
+        (void)bvlc_address_set(&addr, 172, 16, (uint8_t)i, 2);
+        addr.port = 0xBAC0;
+        (void)bvlc_handler(&addr, &src, pdu, (uint16_t)len);
+    }
+    for (fdt_entry = bvlc_fdt_list(); fdt_entry; fdt_entry = fdt_entry->next) {
+        if (fdt_entry->valid) {
+            count++;
+        }
+    }
+    if (count != BENCH_BBMD_FOREIGN_DEVICES) {
+        bench_bbmd_tables_clear();
+        free(context);
+        return NULL;
+    }
+    /* a local broadcast Who-Is, distributed to every peer and device */
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    len = npdu_encode_pdu(&pdu[0], NULL, NULL, &npdu_data);
+    len += whois_encode_apdu(&pdu[len], -1, -1);
+    context->request_len = (uint16_t)bvlc_encode_original_broadcast(
+        context->request, sizeof(context->request), pdu, (uint16_t)len);
+
+    return context;
+}
+
+static void bench_bbmd_teardown(void *context)
+{
+    bench_bbmd_tables_clear();
+    free(context);
+}
+
+static void bench_bbmd_fan_out(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    BACNET_IP_ADDRESS addr = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint64_t i;
+
+    (void)bvlc_address_set(&addr, 192, 168, 0, 10);
+    addr.port = 0xBAC0;
+    for (i = 0; i < iterations; i++) {
+        /* a different local sender each time */
+        addr.address[3] = 10 + (uint8_t)(i % 200);
+        (void)bvlc_handler(&addr, &src, context->request,
+            context->request_len);
+    }
+}
+#endif
+
+#if defined(BACDL_LOOPBACK)
+/* number of simulated clients on the loopback network */
+#define BENCH_LOOPBACK_CLIENTS 256
+
+static void *bench_loopback_setup(void)
+{
+    BENCH_HANDLER_CONTEXT *context;
+    uint16_t mac;
+
+    /* the same broadcast Who-Is, sent by a simulated client */
+    context = bench_whois_setup();
+    if (context) {
+        loopback_reset();
+        loopback_simulated_time_set(true);
+        (void)datalink_init("1");
+        for (mac = 2; mac < (2 + BENCH_LOOPBACK_CLIENTS); mac++) {
+            (void)loopback_port_create(mac);
+        }
+    }
+
+    return context;
+}
+
+static void bench_loopback_teardown(void *context)
+{
+    loopback_reset();
+    free(context);
+}
+
+static void bench_loopback_whois_fan_out(void *data, uint64_t iterations)
+{
+    BENCH_HANDLER_CONTEXT *context = data;
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[LOOPBACK_MPDU_MAX];
+    uint16_t pdu_len;
+    uint16_t mac;
+    uint64_t i;
+
+    loopback_get_broadcast_address(&dest);
+    for (i = 0; i < iterations; i++) {
+        mac = 2 + (uint16_t)(i % BENCH_LOOPBACK_CLIENTS);
+        (void)loopback_port_send(
+            mac, &dest, context->request, context->request_len);
+        /* the device answers with a broadcast I-Am */
+        pdu_len = datalink_receive(&src, pdu, sizeof(pdu), 0);
+        if (pdu_len) {
+            npdu_handler(&src, pdu, pdu_len);
+        }
+        /* every simulated client receives the I-Am and the Who-Is */
+        for (mac = 2; mac < (2 + BENCH_LOOPBACK_CLIENTS); mac++) {
+            while (loopback_port_receive(mac, &src, pdu, sizeof(pdu), 0)) {
+            }
+        }
+    }
+}
+#endif
+
+const BENCH_CASE Bench_Handler_Cases[] = {
+    { "handler", "rpm/prop_all/analog_value_10000", bench_rpm_all_object_setup,
+        bench_rpm, bench_handler_teardown },
+    { "handler", "rpm/prop_all/device_10000", bench_rpm_all_device_setup,
+        bench_rpm, bench_handler_teardown },
+    { "handler", "rp/object_list[10000]", bench_rp_object_list_setup,
+        bench_rp, bench_handler_teardown },
+    { "handler", "rr/object_list_last_200", bench_rr_object_list_setup,
+        bench_rr, bench_handler_teardown },
+    { "handler", "wpm/present_value_50", bench_wpm_present_value_setup,
+        bench_wpm, bench_handler_teardown },
+    { "handler", "npdu_handler/who_is_storm", bench_whois_setup,
+        bench_whois_storm, bench_handler_teardown },
+    { "handler", "Device_Timer/lighting_output_5000_fading_500",
+        bench_lighting_setup, bench_device_timer, bench_lighting_teardown },
+    { "handler", "cov/fan_out_128", bench_cov_setup, bench_cov_fan_out,
+        bench_cov_teardown },
+#if defined(BACDL_BIP)
+    { "handler", "bbmd/fan_out_bdt_64_fdt_64", bench_bbmd_setup,
+        bench_bbmd_fan_out, bench_bbmd_teardown },
+#endif
+#if defined(BACDL_LOOPBACK)
+    { "handler", "loopback/who_is_fan_out_256", bench_loopback_setup,
+        bench_loopback_whois_fan_out, bench_loopback_teardown },
+#endif
+};
+const size_t Bench_Handler_Cases_Count =
+    sizeof(Bench_Handler_Cases) / sizeof(Bench_Handler_Cases[0]);
@@ -0,0 +1,169 @@
+/**
+ * @file
+ * @brief Microbenchmarks for the BACnet Stack data structures
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/keylist.h"
+#include "bench.h"
+
+/* number of nodes in the keylist test lists */
+#define BENCH_KEYLIST_SMALL 1000
+#define BENCH_KEYLIST_LARGE 10000
+
+static int Bench_Keylist_Data;
+
+static void *bench_keylist_setup(void)
+{
+    OS_Keylist list;
+    KEY key;
+
+    list = Keylist_Create();
+    if (list) {
+        for (key = 0; key < BENCH_KEYLIST_LARGE; key++) {
+            Keylist_Data_Add(list, key, &Bench_Keylist_Data);
+        }
+    }
+
+    return list;
+}
+
+static void bench_keylist_teardown(void *context)
+{
+    OS_Keylist list = context;
+
+    /* the data is static, so only the nodes are freed */
+    while (Keylist_Count(list) > 0) {
+        (void)Keylist_Data_Pop(list);
+    }
+    Keylist_Delete(list);
+}
+
+static void bench_keylist_add(void *context, uint64_t iterations)
+{
+    OS_Keylist list;
+    uint64_t i;
+    KEY key;
+
+    (void)context;
+    for (i = 0; i < iterations; i++) {
+        list = Keylist_Create();
+        /* worst case for a sorted array: keys arrive in reverse order */
+        for (key = BENCH_KEYLIST_SMALL; key > 0; key--) {
+            Keylist_Data_Add(list, key, &Bench_Keylist_Data);
+        }
+        while (Keylist_Count(list) > 0) {
+            (void)Keylist_Data_Pop(list);
+        }
+        Keylist_Delete(list);
+    }
+}
+
+static void bench_keylist_add_ascending(void *context, uint64_t iterations)
+{
+    OS_Keylist list;
+    uint64_t i;
+    KEY key;
+
+    (void)context;
+    for (i = 0; i < iterations; i++) {
+        list = Keylist_Create();
+        /* objects created in instance order at startup or restore */
+        for (key = 0; key < BENCH_KEYLIST_LARGE; key++) {
+            Keylist_Data_Add(list, key, &Bench_Keylist_Data);
+        }
+        while (Keylist_Count(list) > 0) {
+            (void)Keylist_Data_Pop(list);
+        }
+        Keylist_Delete(list);
+    }
+}
+
+static void bench_keylist_lookup(void *context, uint64_t iterations)
+{
+    OS_Keylist list = context;
+    void *data = NULL;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        data = Keylist_Data(list, (KEY)(i % BENCH_KEYLIST_LARGE));
+    }
+    bench_do_not_optimize(data);
+}
+
+static void bench_keylist_index(void *context, uint64_t iterations)
+{
+    OS_Keylist list = context;
+    void *data = NULL;
+    uint64_t i;
+
+    for (i = 0; i < iterations; i++) {
+        data = Keylist_Data_Index(list, (int)(i % BENCH_KEYLIST_LARGE));
+    }
+    bench_do_not_optimize(data);
+}
+
+static void *bench_address_setup(void)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint32_t device_id;
+
+    address_init();
+    src.mac_len = 6;
+    for (device_id = 0; device_id < MAX_ADDRESS_CACHE; device_id++) {
+        src.mac[0] = 192;
+        src.mac[1] = 168;
+        src.mac[2] = (uint8_t)(device_id >> 8);
+        src.mac[3] = (uint8_t)device_id;
+        src.mac[4] = 0xBA;
+        src.mac[5] = 0xC0;
+        address_add(device_id, MAX_APDU, &src);
+    }
+
+    return &Bench_Keylist_Data;
+}
+
+static void bench_address_teardown(void *context)
+{
+    (void)context;
+    address_init();
+}
+
+static void bench_address_get_by_device(void *context, uint64_t iterations)
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 0;
+    uint64_t i;
+
+    (void)context;
+    for (i = 0; i < iterations; i++) {
+        /* the last entries are the worst case for a linear search */
+        (void)address_get_by_device(
+            MAX_ADDRESS_CACHE - 1 - (uint32_t)(i % 16), &max_apdu, &src);
+    }
+    bench_do_not_optimize(&src);
+}
+
+const BENCH_CASE Bench_Sys_Cases[] = {
+    { "sys", "Keylist_Data_Add/1000_reverse", NULL, bench_keylist_add,
+        NULL },
+    { "sys", "Keylist_Data_Add/10000_ascending", NULL,
+        bench_keylist_add_ascending, NULL },
+    { "sys", "Keylist_Data/10000", bench_keylist_setup, bench_keylist_lookup,
+        bench_keylist_teardown },
+    { "sys", "Keylist_Data_Index/10000", bench_keylist_setup,
+        bench_keylist_index, bench_keylist_teardown },
+    { "sys", "address_get_by_device/full_cache", bench_address_setup,
+        bench_address_get_by_device, bench_address_teardown },
+};
+const size_t Bench_Sys_Cases_Count =
+    sizeof(Bench_Sys_Cases) / sizeof(Bench_Sys_Cases[0]);
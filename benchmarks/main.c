@@ -0,0 +1,205 @@
+/**
+ * @file
+ * @brief command line tool that runs the BACnet Stack microbenchmarks
+ * and reports ns/op, allocs/op, and bytes/op as a table, JSON, or CSV
+ * so that the results can be compared between builds.
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/version.h"
+#include "bacnet/basic/sys/filename.h"
+#include "bench.h"
+
+struct bench_table {
+    const BENCH_CASE *cases;
+    const size_t *count;
+};
+
+static const struct bench_table Bench_Tables[] = {
+    { Bench_Codec_Cases, &Bench_Codec_Cases_Count },
+    { Bench_Sys_Cases, &Bench_Sys_Cases_Count },
+    { Bench_Handler_Cases, &Bench_Handler_Cases_Count },
+};
+
+static void print_usage(const char *filename)
+{
+    printf("Usage: %s", filename);
+    printf(" [--json|--csv][--filter text][--list][--verbose]\n");
+    printf("       [--iterations N][--min-time-ms T]\n");
+    printf("       [--version][--help]\n");
+}
+
+static void print_help(const char *filename)
+{
+    (void)filename;
+    printf("Run the BACnet Stack microbenchmarks and report the time,\n"
+           "heap allocations, and heap bytes per operation.\n");
+    printf("\n");
+    printf("--json\n"
+           "Report the results as JSON for tooling and CI.\n");
+    printf("\n");
+    printf("--csv\n"
+           "Report the results as comma separated values.\n");
+    printf("\n");
+    printf("--filter text\n"
+           "Run only the benchmarks whose group/name contains text.\n");
+    printf("\n");
+    printf("--list\n"
+           "List the benchmarks without running them.\n");
+    printf("\n");
+    printf("--verbose\n"
+           "Keep the diagnostic messages that the handlers print when\n"
+           "their responses cannot be sent.  They are discarded by\n"
+           "default since no datalink is open while benchmarking.\n"
+           "A benchmark whose setup fails is always reported, and\n"
+           "the exit status is then 1.\n");
+    printf("\n");
+    printf("--iterations N\n"
+           "Run each benchmark exactly N times instead of calibrating.\n");
+    printf("\n");
+    printf("--min-time-ms T\n"
+           "Calibrate each benchmark to run at least T milliseconds.\n"
+           "Default is 200ms.\n");
+}
+
+/**
+ * @brief Discard the diagnostic messages of the handlers
+ * @return a stream to the original stderr for the benchmark errors,
+ *  or stdout if it could not be duplicated
+ */
+static FILE *bench_stderr_discard(void)
+{
+    FILE *stream = NULL;
+    int fd;
+
+#if defined(_WIN32)
+    fd = _dup(_fileno(stderr));
+    if (fd >= 0) {
+        stream = _fdopen(fd, "w");
+    }
+    (void)freopen("NUL", "w", stderr);
+#else
+    fd = dup(fileno(stderr));
+    if (fd >= 0) {
+        stream = fdopen(fd, "w");
+    }
+    (void)freopen("/dev/null", "w", stderr);
+#endif
+    if (!stream) {
+        stream = stdout;
+    }
+
+    return stream;
+}
+
+/**
+ * @brief Determine if a benchmark case matches the filter
+ * @param bench - benchmark case
+ * @param filter - text to match in group/name, or NULL for all
+ * @return true if the benchmark case should be run
+ */
+static bool bench_case_match(const BENCH_CASE *bench, const char *filter)
+{
+    char full_name[128];
+
+    if (!filter) {
+        return true;
+    }
+    snprintf(full_name, sizeof(full_name), "%s/%s", bench->group, bench->name);
+
+    return (strstr(full_name, filter) != NULL);
+}
+
+int main(int argc, char *argv[])
+{
+    BENCH_FORMAT format = BENCH_FORMAT_TEXT;
+    BENCH_RESULT result = { 0 };
+    const BENCH_CASE *bench;
+    const char *filter = NULL;
+    const char *filename;
+    FILE *error_stream = stderr;
+    unsigned failures = 0;
+    bool list_only = false;
+    bool verbose = false;
+    size_t t, c;
+    int argi;
+
+    filename = filename_remove_path(argv[0]);
+    for (argi = 1; argi < argc; argi++) {
+        if (strcmp(argv[argi], "--help") == 0) {
+            print_usage(filename);
+            print_help(filename);
+            return 0;
+        } else if (strcmp(argv[argi], "--version") == 0) {
+            printf("%s %s\n", filename, BACNET_VERSION_TEXT);
+            return 0;
+        } else if (strcmp(argv[argi], "--json") == 0) {
+            format = BENCH_FORMAT_JSON;
+        } else if (strcmp(argv[argi], "--csv") == 0) {
+            format = BENCH_FORMAT_CSV;
+        } else if (strcmp(argv[argi], "--list") == 0) {
+            list_only = true;
+        } else if (strcmp(argv[argi], "--verbose") == 0) {
+            verbose = true;
+        } else if (strcmp(argv[argi], "--filter") == 0) {
+            if (++argi < argc) {
+                filter = argv[argi];
+            }
+        } else if (strcmp(argv[argi], "--iterations") == 0) {
+            if (++argi < argc) {
+                bench_iterations_set(strtoull(argv[argi], NULL, 0));
+            }
+        } else if (strcmp(argv[argi], "--min-time-ms") == 0) {
+            if (++argi < argc) {
+                bench_min_time_set(strtoull(argv[argi], NULL, 0));
+            }
+        } else {
+            print_usage(filename);
+            return 1;
+        }
+    }
+    if (!list_only) {
+        if (!verbose) {
+            error_stream = bench_stderr_discard();
+        }
+        bench_report_begin(format);
+    }
+    for (t = 0; t < (sizeof(Bench_Tables) / sizeof(Bench_Tables[0])); t++) {
+        for (c = 0; c < *Bench_Tables[t].count; c++) {
+            bench = &Bench_Tables[t].cases[c];
+            if (!bench_case_match(bench, filter)) {
+                continue;
+            }
+            if (list_only) {
+                printf("%s/%s\n", bench->group, bench->name);
+            } else if (bench_case_run(bench, &result)) {
+                bench_report_result(format, &result);
+            } else {
+                fprintf(error_stream, "%s/%s: setup failed\n", bench->group,
+                    bench->name);
+                fflush(error_stream);
+                failures++;
+            }
+        }
+    }
+    if (!list_only) {
+        bench_report_end(format);
+    }
+
+    return failures ? 1 : 0;
+}
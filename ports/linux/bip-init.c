@@ -28,6 +28,7 @@
 #include "bacnet/bacint.h"
 #include "bacnet/datalink/bip.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 #include "bacport.h"
 
@@ -276,6 +277,7 @@ uint8_t bip_get_subnet_prefix(void)
 int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in bip_dest = { 0 };
+    int bytes_sent;
 
     /* assumes that the driver has already been initialized */
     if (BIP_Socket < 0) {
@@ -283,6 +285,7 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
             fprintf(stderr, "BIP: driver not initialized!\n");
             fflush(stderr);
         }
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
         return BIP_Socket;
     }
     /* load destination IP address */
@@ -292,22 +295,30 @@ int bip_send_mpdu(BACNET_IP_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     /* Send the packet */
     debug_print_ipv4(
         "Sending MPDU->", &bip_dest.sin_addr, bip_dest.sin_port, mtu_len);
-    return sendto(BIP_Socket, (char *)mtu, mtu_len, 0,
+    bytes_sent = sendto(BIP_Socket, (char *)mtu, mtu_len, 0,
         (struct sockaddr *)&bip_dest, sizeof(struct sockaddr));
+    if (bytes_sent < 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    }
+
+    return bytes_sent;
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * BACnet/IP Datalink Receive handler, which receives into a PDU buffer
+ * and strips the BVLC header without moving the NPDU.
  *
  * @param src - returns the source address
- * @param npdu - returns the NPDU buffer
- * @param max_npdu -maximum size of the NPDU buffer
+ * @param pdu - PDU buffer which receives at its tail, and returns
+ *  the NPDU
  * @param timeout - number of milliseconds to wait for a packet
  *
- * @return Number of bytes received, or 0 if none or timeout.
+ * @return Number of bytes in the NPDU, or 0 if none or timeout.
  */
-uint16_t bip_receive(
-    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+uint16_t bip_receive_buffer(
+    BACNET_ADDRESS *src, BACNET_PDU_BUFFER *pdu, unsigned timeout)
 {
     uint16_t npdu_len = 0; /* return value */
     fd_set read_fds;
@@ -318,13 +329,17 @@ uint16_t bip_receive(
     socklen_t sin_len = sizeof(sin);
     int received_bytes = 0;
     int offset = 0;
-    uint16_t i = 0;
     int socket;
+    uint8_t *mpdu;
 
     /* Make sure the socket is open */
     if (BIP_Socket < 0) {
         return 0;
     }
+    mpdu = pdubuf_tail(pdu);
+    if (!mpdu) {
+        return 0;
+    }
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
        a select. */
@@ -346,8 +361,8 @@ uint16_t bip_receive(
     if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
         socket = FD_ISSET(BIP_Socket, &read_fds) ? BIP_Socket :
             BIP_Broadcast_Socket;
-        received_bytes = recvfrom(socket, (char *)&npdu[0], max_npdu, 0,
-            (struct sockaddr *)&sin, &sin_len);
+        received_bytes = recvfrom(socket, (char *)mpdu, pdubuf_tailroom(pdu),
+            0, (struct sockaddr *)&sin, &sin_len);
     } else {
         return 0;
     }
@@ -359,20 +374,22 @@ uint16_t bip_receive(
     if (received_bytes == 0) {
         return 0;
     }
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
     /* the signature of a BACnet/IPv packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP) {
+    if (mpdu[0] != BVLL_TYPE_BACNET_IP) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
         return 0;
     }
     /* Erase up to 16 bytes after the received bytes as safety margin to
      * ensure that the decoding functions will run into a 'safe field'
      * of zero, if for any reason they would overrun, when parsing the
      * message. */
-    max = (int)max_npdu - received_bytes;
+    max = (int)pdubuf_tailroom(pdu) - received_bytes;
     if (max > 0) {
         if (max > 16) {
             max = 16;
         }
-        memset(&npdu[received_bytes], 0, max);
+        memset(&mpdu[received_bytes], 0, max);
     }
     /* Data link layer addressing between B/IPv4 nodes consists of a 32-bit
        IPv4 address followed by a two-octet UDP port number (both of which
@@ -385,26 +402,43 @@ uint16_t bip_receive(
         "Received MPDU->", &sin.sin_addr, sin.sin_port, received_bytes);
     /* pass the packet into the BBMD handler */
     if (socket == BIP_Socket) {
-        offset = bvlc_handler(&addr, src, npdu, received_bytes);
+        offset = bvlc_handler(&addr, src, mpdu, received_bytes);
     } else {
-        offset = bvlc_broadcast_handler(&addr, src, npdu, received_bytes);
+        offset = bvlc_broadcast_handler(&addr, src, mpdu, received_bytes);
     }
     if (offset > 0) {
-        npdu_len = received_bytes - offset;
+        /* strip the BVLC header to leave the NPDU in place */
+        (void)pdubuf_put(pdu, (uint16_t)received_bytes);
+        (void)pdubuf_pull(pdu, (uint16_t)offset);
+        npdu_len = pdubuf_length(pdu);
         debug_print_ipv4(
             "Received NPDU->", &sin.sin_addr, sin.sin_port, npdu_len);
-        if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
-            }
-        } else {
-            if (BIP_Debug) {
-                fprintf(stderr, "BIP: NPDU dropped!\n");
-                fflush(stderr);
-            }
-            npdu_len = 0;
-        }
+    }
+
+    return npdu_len;
+}
+
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    BACNET_PDU_BUFFER pdu;
+    uint16_t npdu_len;
+
+    pdubuf_init(&pdu, npdu, max_npdu, 0);
+    npdu_len = bip_receive_buffer(src, &pdu, timeout);
+    if (npdu_len > 0) {
+        /* shift the buffer to return a valid NPDU */
+        memmove(npdu, pdubuf_data(&pdu), npdu_len);
     }
 
     return npdu_len;
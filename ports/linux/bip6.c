@@ -8,6 +8,7 @@
 #include <ifaddrs.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <stdint.h> /* for standard integer types uint8_t etc. */
 #include <stdbool.h> /* for the standard bool type. */
 #include "bacnet/bacdcode.h"
@@ -15,6 +16,7 @@
 #include "bacnet/datalink/bip6.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacport.h"
 
 /* enable debugging */
@@ -221,9 +223,11 @@ int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
 {
     struct sockaddr_in6 bvlc_dest = { 0 };
     uint16_t addr16[8];
+    int bytes_sent;
 
     /* assumes that the driver has already been initialized */
     if (BIP6_Socket < 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
         return 0;
     }
     /* load destination IP address */
@@ -242,8 +246,15 @@ int bip6_send_mpdu(BACNET_IP6_ADDRESS *dest, uint8_t *mtu, uint16_t mtu_len)
     bvlc_dest.sin6_scope_id = BIP6_Socket_Scope_Id;
     debug_print_ipv6("Sending MPDU->", &bvlc_dest.sin6_addr);
     /* Send the packet */
-    return sendto(BIP6_Socket, (char *)mtu, mtu_len, 0,
+    bytes_sent = sendto(BIP6_Socket, (char *)mtu, mtu_len, 0,
         (struct sockaddr *)&bvlc_dest, sizeof(bvlc_dest));
+    if (bytes_sent < 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    }
+
+    return bytes_sent;
 }
 
 /**
@@ -267,17 +278,18 @@ int bip6_send_pdu(BACNET_ADDRESS *dest,
 }
 
 /**
- * BACnet/IP Datalink Receive handler.
+ * BACnet/IPv6 Datalink Receive handler, which receives into a PDU buffer
+ * and strips the BVLC header without moving the NPDU.
  *
  * @param src - returns the source address
- * @param npdu - returns the NPDU buffer
- * @param max_npdu -maximum size of the NPDU buffer
+ * @param pdu - PDU buffer which receives at its tail, and returns
+ *  the NPDU
  * @param timeout - number of milliseconds to wait for a packet
  *
- * @return Number of bytes received, or 0 if none or timeout.
+ * @return Number of bytes in the NPDU, or 0 if none or timeout.
  */
-uint16_t bip6_receive(
-    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+uint16_t bip6_receive_buffer(
+    BACNET_ADDRESS *src, BACNET_PDU_BUFFER *pdu, unsigned timeout)
 {
     uint16_t npdu_len = 0; /* return value */
     fd_set read_fds;
@@ -288,12 +300,16 @@ uint16_t bip6_receive(
     socklen_t sin_len = sizeof(sin);
     int received_bytes = 0;
     int offset = 0;
-    uint16_t i = 0;
+    uint8_t *mpdu;
 
     /* Make sure the socket is open */
     if (BIP6_Socket < 0) {
         return 0;
     }
+    mpdu = pdubuf_tail(pdu);
+    if (!mpdu) {
+        return 0;
+    }
     /* we could just use a non-blocking socket, but that consumes all
        the CPU time.  We can use a timeout; it is only supported as
        a select. */
@@ -310,8 +326,8 @@ uint16_t bip6_receive(
     max = BIP6_Socket;
     /* see if there is a packet for us */
     if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0) {
-        received_bytes = recvfrom(BIP6_Socket, (char *)&npdu[0], max_npdu, 0,
-            (struct sockaddr *)&sin, &sin_len);
+        received_bytes = recvfrom(BIP6_Socket, (char *)mpdu,
+            pdubuf_tailroom(pdu), 0, (struct sockaddr *)&sin, &sin_len);
     } else {
         return 0;
     }
@@ -323,8 +339,10 @@ uint16_t bip6_receive(
     if (received_bytes == 0) {
         return 0;
     }
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
     /* the signature of a BACnet/IPv6 packet */
-    if (npdu[0] != BVLL_TYPE_BACNET_IP6) {
+    if (mpdu[0] != BVLL_TYPE_BACNET_IP6) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
         return 0;
     }
     /* pass the packet into the BBMD handler */
@@ -335,17 +353,38 @@ uint16_t bip6_receive(
         ntohs(sin.sin6_addr.s6_addr16[5]), ntohs(sin.sin6_addr.s6_addr16[6]),
         ntohs(sin.sin6_addr.s6_addr16[7]));
     addr.port = ntohs(sin.sin6_port);
-    offset = bvlc6_handler(&addr, src, npdu, received_bytes);
+    offset = bvlc6_handler(&addr, src, mpdu, received_bytes);
     if (offset > 0) {
-        npdu_len = received_bytes - offset;
-        if (npdu_len <= max_npdu) {
-            /* shift the buffer to return a valid NPDU */
-            for (i = 0; i < npdu_len; i++) {
-                npdu[i] = npdu[offset + i];
-            }
-        } else {
-            npdu_len = 0;
-        }
+        /* strip the BVLC header to leave the NPDU in place */
+        (void)pdubuf_put(pdu, (uint16_t)received_bytes);
+        (void)pdubuf_pull(pdu, (uint16_t)offset);
+        npdu_len = pdubuf_length(pdu);
+    }
+
+    return npdu_len;
+}
+
+/**
+ * BACnet/IP Datalink Receive handler.
+ *
+ * @param src - returns the source address
+ * @param npdu - returns the NPDU buffer
+ * @param max_npdu -maximum size of the NPDU buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ *
+ * @return Number of bytes received, or 0 if none or timeout.
+ */
+uint16_t bip6_receive(
+    BACNET_ADDRESS *src, uint8_t *npdu, uint16_t max_npdu, unsigned timeout)
+{
+    BACNET_PDU_BUFFER pdu;
+    uint16_t npdu_len;
+
+    pdubuf_init(&pdu, npdu, max_npdu, 0);
+    npdu_len = bip6_receive_buffer(src, &pdu, timeout);
+    if (npdu_len > 0) {
+        /* shift the buffer to return a valid NPDU */
+        memmove(npdu, pdubuf_data(&pdu), npdu_len);
     }
 
     return npdu_len;
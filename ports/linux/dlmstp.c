@@ -22,6 +22,7 @@
 #include "bacnet/datalink/dlmstp.h"
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 /* OS Specific include */
 #include "bacport.h"
 /* port specific */
@@ -207,6 +208,11 @@ int dlmstp_send_pdu(
         }
     }
     pthread_mutex_unlock(&Ring_Buffer_Mutex);
+    if (bytes_sent > 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+    }
 
     return bytes_sent;
 }
@@ -230,6 +236,7 @@ uint16_t dlmstp_receive(
     if (Receive_Packet.ready) {
         if (Receive_Packet.pdu_len) {
             MSTP_Packets++;
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
             if (src) {
                 memmove(
                     src, &Receive_Packet.address,
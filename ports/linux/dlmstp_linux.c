@@ -19,8 +19,8 @@
 #include "bacnet/bacaddr.h"
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/mstp.h"
-#include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 /* port specific */
 #include "dlmstp_linux.h"
 #include "rs485.h"
@@ -110,6 +110,177 @@ void dlmstp_cleanup(void *poPort)
     pthread_cond_destroy(&poSharedData->Master_Done_Flag);
     pthread_mutex_destroy(&poSharedData->Received_Frame_Mutex);
     pthread_mutex_destroy(&poSharedData->Master_Done_Mutex);
+    pthread_mutex_destroy(&poSharedData->PDU_Mutex);
+}
+
+/**
+ * @brief Determine the bucket of a reply in the reply index
+ * @param destination_mac - MS/TP MAC address of the reply
+ * @param invoke_id - invoke ID of the reply
+ * @return bucket of the reply index
+ */
+static unsigned dlmstp_pdu_reply_bucket(
+    uint8_t destination_mac, uint8_t invoke_id)
+{
+    return (destination_mac ^ invoke_id) & (MSTP_PDU_REPLY_BUCKETS - 1);
+}
+
+/**
+ * @brief Determine if a PDU is a reply to a confirmed request, and
+ *  get its invoke ID
+ * @param pdu - PDU to be sent
+ * @param pdu_len - number of bytes in the PDU
+ * @param invoke_id [out] invoke ID of the reply
+ * @return true if the PDU is a reply
+ */
+static bool dlmstp_pdu_reply_decode(
+    uint8_t *pdu, uint16_t pdu_len, uint8_t *invoke_id)
+{
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int offset;
+
+    offset = bacnet_npdu_decode(pdu, pdu_len, NULL, NULL, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message ||
+        ((offset + 1) >= pdu_len)) {
+        return false;
+    }
+    switch (pdu[offset] & 0xF0) {
+        case PDU_TYPE_SIMPLE_ACK:
+        case PDU_TYPE_COMPLEX_ACK:
+        case PDU_TYPE_ERROR:
+        case PDU_TYPE_REJECT:
+        case PDU_TYPE_ABORT:
+            *invoke_id = pdu[offset + 1];
+            return true;
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Initialize the transmit queues, with every PDU in the free list
+ * @param poSharedData - port specific data
+ */
+static void dlmstp_pdu_queue_init(SHARED_MSTP_DATA *poSharedData)
+{
+    unsigned i;
+
+    for (i = 0; i < MSTP_PDU_PRIORITY_COUNT; i++) {
+        poSharedData->PDU_Queue[i].head = MSTP_PDU_NONE;
+        poSharedData->PDU_Queue[i].tail = MSTP_PDU_NONE;
+    }
+    for (i = 0; i < MSTP_PDU_REPLY_BUCKETS; i++) {
+        poSharedData->PDU_Reply_Index[i] = MSTP_PDU_NONE;
+    }
+    for (i = 0; i < MSTP_PDU_PACKET_COUNT; i++) {
+        poSharedData->PDU_Buffer[i].next = i + 1;
+    }
+    poSharedData->PDU_Buffer[MSTP_PDU_PACKET_COUNT - 1].next = MSTP_PDU_NONE;
+    poSharedData->PDU_Free = 0;
+    poSharedData->PDU_Count = 0;
+}
+
+/**
+ * @brief Get the number of PDUs waiting to be sent, for the adaptive
+ *  Max_Info_Frames of the MS/TP master node state machine
+ * @param poPort - port specific data
+ * @return number of PDUs waiting to be sent
+ */
+static unsigned dlmstp_pdu_queue_count(void *poPort)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+
+    return poSharedData->PDU_Count;
+}
+
+/**
+ * @brief Get a free running millisecond clock, for the token rotation
+ *  time of the MS/TP master node state machine
+ * @param poPort - port specific data
+ * @return milliseconds
+ */
+static uint32_t dlmstp_milliseconds(void *poPort)
+{
+    struct timeval now;
+
+    (void)poPort;
+    gettimeofday(&now, NULL);
+
+    return (uint32_t)((now.tv_sec * 1000UL) + (now.tv_usec / 1000));
+}
+
+/**
+ * @brief Remove a PDU from its priority queue and from the reply index,
+ *  and return it to the free list
+ * @param poSharedData - port specific data
+ * @param index - index of the PDU
+ */
+static void dlmstp_pdu_queue_remove(
+    SHARED_MSTP_DATA *poSharedData, uint8_t index)
+{
+    struct mstp_pdu_packet *pkt = &poSharedData->PDU_Buffer[index];
+    struct mstp_pdu_queue *queue = &poSharedData->PDU_Queue[pkt->priority];
+    uint8_t *bucket;
+
+    if (pkt->prev == MSTP_PDU_NONE) {
+        queue->head = pkt->next;
+    } else {
+        poSharedData->PDU_Buffer[pkt->prev].next = pkt->next;
+    }
+    if (pkt->next == MSTP_PDU_NONE) {
+        queue->tail = pkt->prev;
+    } else {
+        poSharedData->PDU_Buffer[pkt->next].prev = pkt->prev;
+    }
+    if (pkt->reply) {
+        bucket = &poSharedData->PDU_Reply_Index[dlmstp_pdu_reply_bucket(
+            pkt->destination_mac, pkt->invoke_id)];
+        if (pkt->reply_prev == MSTP_PDU_NONE) {
+            *bucket = pkt->reply_next;
+        } else {
+            poSharedData->PDU_Buffer[pkt->reply_prev].reply_next =
+                pkt->reply_next;
+        }
+        if (pkt->reply_next != MSTP_PDU_NONE) {
+            poSharedData->PDU_Buffer[pkt->reply_next].reply_prev =
+                pkt->reply_prev;
+        }
+        pkt->reply = false;
+    }
+    pkt->next = poSharedData->PDU_Free;
+    poSharedData->PDU_Free = index;
+    poSharedData->PDU_Count--;
+}
+
+/**
+ * @brief Convert a queued PDU into the MSTP Frame, and free the PDU
+ * @param mstp_port - port specific data
+ * @param index - index of the PDU
+ * @return number of bytes in the frame
+ */
+static uint16_t dlmstp_pdu_frame(
+    struct mstp_port_struct_t *mstp_port, uint8_t index)
+{
+    SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
+    struct mstp_pdu_packet *pkt = &poSharedData->PDU_Buffer[index];
+    uint8_t frame_type;
+    uint16_t frame_len;
+
+    if (pkt->data_expecting_reply) {
+        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
+    } else {
+        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    }
+    frame_len = MSTP_Create_Frame(
+        &mstp_port->OutputBuffer[0], /* <-- loading this */
+        mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
+        mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
+    dlmstp_pdu_queue_remove(poSharedData, index);
+
+    return frame_len;
 }
 
 /* returns number of bytes sent on success, zero on failure */
@@ -121,7 +292,9 @@ int dlmstp_send_pdu(
 { /* number of bytes of data */
     int bytes_sent = 0;
     struct mstp_pdu_packet *pkt;
-    unsigned i = 0;
+    struct mstp_pdu_queue *queue;
+    uint8_t index;
+    uint8_t *bucket;
     SHARED_MSTP_DATA *poSharedData;
     struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
     if (!mstp_port) {
@@ -131,19 +304,53 @@ int dlmstp_send_pdu(
     if (!poSharedData) {
         return 0;
     }
+    if ((pdu_len < 2) || (pdu_len > sizeof(pkt->buffer))) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+        return 0;
+    }
 
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Data_Peek(&poSharedData->PDU_Queue);
-    if (pkt) {
+    pthread_mutex_lock(&poSharedData->PDU_Mutex);
+    index = poSharedData->PDU_Free;
+    if (index != MSTP_PDU_NONE) {
+        pkt = &poSharedData->PDU_Buffer[index];
+        poSharedData->PDU_Free = pkt->next;
+        poSharedData->PDU_Count++;
         pkt->data_expecting_reply =
             BACNET_DATA_EXPECTING_REPLY(pdu[BACNET_PDU_CONTROL_BYTE_OFFSET]);
-        for (i = 0; i < pdu_len; i++) {
-            pkt->buffer[i] = pdu[i];
-        }
+        pkt->priority = pdu[BACNET_PDU_CONTROL_BYTE_OFFSET] & 0x03;
+        memcpy(pkt->buffer, pdu, pdu_len);
         pkt->length = pdu_len;
         pkt->destination_mac = dest->mac[0];
-        if (Ringbuf_Data_Put(&poSharedData->PDU_Queue, (uint8_t *)pkt)) {
-            bytes_sent = pdu_len;
+        /* FIFO within the priority */
+        queue = &poSharedData->PDU_Queue[pkt->priority];
+        pkt->next = MSTP_PDU_NONE;
+        pkt->prev = queue->tail;
+        if (queue->tail == MSTP_PDU_NONE) {
+            queue->head = index;
+        } else {
+            poSharedData->PDU_Buffer[queue->tail].next = index;
         }
+        queue->tail = index;
+        /* index the replies, for MSTP_Get_Reply */
+        pkt->reply = dlmstp_pdu_reply_decode(
+            pkt->buffer, pkt->length, &pkt->invoke_id);
+        if (pkt->reply) {
+            bucket = &poSharedData->PDU_Reply_Index[dlmstp_pdu_reply_bucket(
+                pkt->destination_mac, pkt->invoke_id)];
+            pkt->reply_prev = MSTP_PDU_NONE;
+            pkt->reply_next = *bucket;
+            if (*bucket != MSTP_PDU_NONE) {
+                poSharedData->PDU_Buffer[*bucket].reply_prev = index;
+            }
+            *bucket = index;
+        }
+        bytes_sent = pdu_len;
+    }
+    pthread_mutex_unlock(&poSharedData->PDU_Mutex);
+    if (bytes_sent > 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
     }
 
     return bytes_sent;
@@ -177,6 +384,7 @@ uint16_t dlmstp_receive(
         if (poSharedData->Receive_Packet.ready) {
             if (poSharedData->Receive_Packet.pdu_len) {
                 poSharedData->MSTP_Packets++;
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
                 if (src) {
                     memmove(
                         src, &poSharedData->Receive_Packet.address,
@@ -345,8 +553,8 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0;
-    uint8_t frame_type = 0;
-    struct mstp_pdu_packet *pkt;
+    unsigned priority;
+    uint8_t index;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     if (!poSharedData) {
@@ -354,21 +562,16 @@ uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
     }
 
     (void)timeout;
-    if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
-        return 0;
-    }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->PDU_Queue);
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
+    pthread_mutex_lock(&poSharedData->PDU_Mutex);
+    /* life safety first, normal last */
+    for (priority = MSTP_PDU_PRIORITY_COUNT; priority > 0; priority--) {
+        index = poSharedData->PDU_Queue[priority - 1].head;
+        if (index != MSTP_PDU_NONE) {
+            pdu_len = dlmstp_pdu_frame(mstp_port, index);
+            break;
+        }
     }
-    /* convert the PDU into the MSTP Frame */
-    pdu_len = MSTP_Create_Frame(
-        &mstp_port->OutputBuffer[0], /* <-- loading this */
-        mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-        mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    (void)Ringbuf_Pop(&poSharedData->PDU_Queue, NULL);
+    pthread_mutex_unlock(&poSharedData->PDU_Mutex);
 
     return pdu_len;
 }
@@ -520,51 +723,46 @@ static bool dlmstp_compare_data_expecting_reply(
 uint16_t MSTP_Get_Reply(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 { /* milliseconds to wait for a packet */
     uint16_t pdu_len = 0; /* return value */
-    bool matched = false;
-    uint8_t frame_type = 0;
+    BACNET_NPDU_DATA npdu_data = { 0 };
     struct mstp_pdu_packet *pkt;
+    uint8_t index;
+    uint8_t invoke_id;
+    int offset;
     SHARED_MSTP_DATA *poSharedData = (SHARED_MSTP_DATA *)mstp_port->UserData;
 
     (void)timeout;
     if (!poSharedData) {
         return 0;
     }
-    if (Ringbuf_Empty(&poSharedData->PDU_Queue)) {
+    /* only the replies to the invoke ID of the DER are candidates */
+    offset = bacnet_npdu_decode(&mstp_port->InputBuffer[0],
+        mstp_port->DataLength, NULL, NULL, &npdu_data);
+    if ((offset <= 0) || npdu_data.network_layer_message ||
+        ((offset + 2) >= mstp_port->DataLength) ||
+        ((mstp_port->InputBuffer[offset] & 0xF0) !=
+            PDU_TYPE_CONFIRMED_SERVICE_REQUEST)) {
         return 0;
     }
-    pkt = (struct mstp_pdu_packet *)Ringbuf_Peek(&poSharedData->PDU_Queue);
-    /* is this the reply to the DER? */
-    matched = dlmstp_compare_data_expecting_reply(
-        &mstp_port->InputBuffer[0], mstp_port->DataLength,
-        mstp_port->SourceAddress, (uint8_t *)&pkt->buffer[0], pkt->length,
-        pkt->destination_mac);
-    if (!matched) {
-        /* Walk the rest of the ring buffer to see if we can find a match */
-        while (!matched &&
-               (pkt = (struct mstp_pdu_packet *)Ringbuf_Peek_Next(
-                    &poSharedData->PDU_Queue, (uint8_t *)pkt)) != NULL) {
-            matched = dlmstp_compare_data_expecting_reply(
-                &mstp_port->InputBuffer[0], mstp_port->DataLength,
-                mstp_port->SourceAddress, (uint8_t *)&pkt->buffer[0],
-                pkt->length, pkt->destination_mac);
-        }
-        if (!matched) {
-            /* Still didn't find a match so just bail out */
-            return 0;
+    invoke_id = mstp_port->InputBuffer[offset + 2];
+    pthread_mutex_lock(&poSharedData->PDU_Mutex);
+    index = poSharedData->PDU_Reply_Index[dlmstp_pdu_reply_bucket(
+        mstp_port->SourceAddress, invoke_id)];
+    while (index != MSTP_PDU_NONE) {
+        pkt = &poSharedData->PDU_Buffer[index];
+        /* is this the reply to the DER? */
+        if ((pkt->destination_mac == mstp_port->SourceAddress) &&
+            (pkt->invoke_id == invoke_id) &&
+            dlmstp_compare_data_expecting_reply(&mstp_port->InputBuffer[0],
+                mstp_port->DataLength, mstp_port->SourceAddress,
+                (uint8_t *)&pkt->buffer[0], pkt->length,
+                pkt->destination_mac)) {
+            /* removes the reply no matter where it is queued */
+            pdu_len = dlmstp_pdu_frame(mstp_port, index);
+            break;
         }
+        index = pkt->reply_next;
     }
-    if (pkt->data_expecting_reply) {
-        frame_type = FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY;
-    } else {
-        frame_type = FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY;
-    }
-    /* convert the PDU into the MSTP Frame */
-    pdu_len = MSTP_Create_Frame(
-        &mstp_port->OutputBuffer[0], /* <-- loading this */
-        mstp_port->OutputBufferSize, frame_type, pkt->destination_mac,
-        mstp_port->This_Station, (uint8_t *)&pkt->buffer[0], pkt->length);
-    /* This will pop the element no matter where we found it */
-    (void)Ringbuf_Pop_Element(&poSharedData->PDU_Queue, (uint8_t *)pkt, NULL);
+    pthread_mutex_unlock(&poSharedData->PDU_Mutex);
 
     return pdu_len;
 }
@@ -626,6 +824,61 @@ uint8_t dlmstp_max_info_frames(void *poPort)
     return mstp_port->Nmax_info_frames;
 }
 
+/* The adaptive Max_Info_Frames is on when this limit is greater than */
+/* Max_Info_Frames: a node with a deep transmit queue may then send up */
+/* to this many information frames with each token.  The budget follows */
+/* the number of queued PDUs, so it never exceeds MSTP_PDU_PACKET_COUNT */
+/* however high the limit is set.  Zero turns the adaptive mode off. */
+void dlmstp_set_max_info_frames_limit(void *poPort, uint8_t limit)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+
+    if (!mstp_port) {
+        return;
+    }
+    mstp_port->Nmax_info_frames_limit = limit;
+}
+
+uint8_t dlmstp_max_info_frames_limit(void *poPort)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+
+    if (!mstp_port) {
+        return 0;
+    }
+
+    return mstp_port->Nmax_info_frames_limit;
+}
+
+/* The adaptive budget is halved while the token rotation time is longer */
+/* than this many milliseconds.  Zero for no limit. */
+void dlmstp_set_token_rotation_limit(void *poPort, uint16_t milliseconds)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+
+    if (!mstp_port) {
+        return;
+    }
+    mstp_port->Ttoken_rotation_limit = milliseconds;
+}
+
+uint16_t dlmstp_token_rotation_limit(void *poPort)
+{
+    struct mstp_port_struct_t *mstp_port = (struct mstp_port_struct_t *)poPort;
+
+    if (!mstp_port) {
+        return 0;
+    }
+
+    return mstp_port->Ttoken_rotation_limit;
+}
+
+/* Token usage statistics of this node, for tuning the two limits above */
+void dlmstp_token_statistics(void *poPort, MSTP_TOKEN_STATISTICS *statistics)
+{
+    MSTP_Token_Statistics((struct mstp_port_struct_t *)poPort, statistics);
+}
+
 /* This parameter represents the value of the Max_Master property of the */
 /* node's Device object. The value of Max_Master specifies the highest */
 /* allowable address for master nodes. The value of Max_Master shall be */
@@ -776,9 +1029,8 @@ bool dlmstp_init(void *poPort, char *ifname)
 
     poSharedData->RS485_Port_Name = ifname;
     /* initialize PDU queue */
-    Ringbuf_Init(
-        &poSharedData->PDU_Queue, (uint8_t *)&poSharedData->PDU_Buffer,
-        sizeof(struct mstp_pdu_packet), MSTP_PDU_PACKET_COUNT);
+    pthread_mutex_init(&poSharedData->PDU_Mutex, NULL);
+    dlmstp_pdu_queue_init(poSharedData);
     /* initialize packet queue */
     poSharedData->Receive_Packet.ready = false;
     poSharedData->Receive_Packet.pdu_len = 0;
@@ -847,6 +1099,9 @@ bool dlmstp_init(void *poPort, char *ifname)
     gettimeofday(&poSharedData->start, NULL);
     mstp_port->SilenceTimer = Timer_Silence;
     mstp_port->SilenceTimerReset = Timer_Silence_Reset;
+    /* for the adaptive Max_Info_Frames, if Nmax_info_frames_limit is set */
+    mstp_port->SendQueueCount = dlmstp_pdu_queue_count;
+    mstp_port->Milliseconds = dlmstp_milliseconds;
     MSTP_Init(mstp_port);
     debug_fprintf(stderr, "MS/TP MAC: %02X\n", mstp_port->This_Station);
     debug_fprintf(stderr, "MS/TP Max_Master: %02X\n", mstp_port->Nmax_master);
@@ -28,10 +28,19 @@
 #define DLMSTP_HEADER_MAX (2+1+1+1+2+1+2)
 #define DLMSTP_MPDU_MAX (DLMSTP_HEADER_MAX+MAX_PDU)
 
-/* count must be a power of 2 for ringbuf library */
+/* number of PDUs that may wait to be sent - at most 254.  This also caps
+   the budget of the adaptive Max_Info_Frames, which follows the queue. */
 #ifndef MSTP_PDU_PACKET_COUNT
 #define MSTP_PDU_PACKET_COUNT 8
 #endif
+/* one transmit queue for each BACnet network priority */
+#define MSTP_PDU_PRIORITY_COUNT (MESSAGE_PRIORITY_LIFE_SAFETY + 1)
+/* number of buckets in the index of queued replies - a power of 2 */
+#ifndef MSTP_PDU_REPLY_BUCKETS
+#define MSTP_PDU_REPLY_BUCKETS 16
+#endif
+/* end of a list of PDUs */
+#define MSTP_PDU_NONE 0xFF
 
 typedef struct dlmstp_packet {
     bool ready; /* true if ready to be sent or received */
@@ -44,11 +53,27 @@ typedef struct dlmstp_packet {
 /* data structure for MS/TP PDU Queue */
 struct mstp_pdu_packet {
     bool data_expecting_reply;
+    /* true if the PDU is a reply that is in the reply index */
+    bool reply;
+    uint8_t priority;
+    uint8_t invoke_id;
     uint8_t destination_mac;
+    /* links in the priority queue, or in the free list */
+    uint8_t next;
+    uint8_t prev;
+    /* links in the bucket of the reply index */
+    uint8_t reply_next;
+    uint8_t reply_prev;
     uint16_t length;
     uint8_t buffer[DLMSTP_MPDU_MAX];
 };
 
+/* a FIFO of PDUs with the same priority */
+struct mstp_pdu_queue {
+    uint8_t head;
+    uint8_t tail;
+};
+
 typedef struct shared_mstp_data {
     /* Number of MS/TP Packets Rx/Tx */
     uint16_t MSTP_Packets;
@@ -93,8 +118,13 @@ typedef struct shared_mstp_data {
     uint8_t Rx_Buffer[4096];
     struct timeval start;
 
-    RING_BUFFER PDU_Queue;
-
+    /* transmit queues, highest priority is sent first */
+    pthread_mutex_t PDU_Mutex;
+    struct mstp_pdu_queue PDU_Queue[MSTP_PDU_PRIORITY_COUNT];
+    /* queued replies by destination MAC and invoke ID */
+    uint8_t PDU_Reply_Index[MSTP_PDU_REPLY_BUCKETS];
+    uint8_t PDU_Free;
+    uint8_t PDU_Count;
     struct mstp_pdu_packet PDU_Buffer[MSTP_PDU_PACKET_COUNT];
 
 } SHARED_MSTP_DATA;
@@ -146,6 +176,29 @@ extern "C" {
     uint8_t dlmstp_max_info_frames(
         void *poShared);
 
+    /* adaptive Max_Info_Frames - off unless the limit is greater than
+       Max_Info_Frames, and never more than MSTP_PDU_PACKET_COUNT */
+    BACNET_STACK_EXPORT
+    void dlmstp_set_max_info_frames_limit(
+        void *poShared,
+        uint8_t limit);
+    BACNET_STACK_EXPORT
+    uint8_t dlmstp_max_info_frames_limit(
+        void *poShared);
+    /* token rotation time in milliseconds that halves the adaptive
+       budget, or zero for none */
+    BACNET_STACK_EXPORT
+    void dlmstp_set_token_rotation_limit(
+        void *poShared,
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    uint16_t dlmstp_token_rotation_limit(
+        void *poShared);
+    BACNET_STACK_EXPORT
+    void dlmstp_token_statistics(
+        void *poShared,
+        MSTP_TOKEN_STATISTICS *statistics);
+
     /* This parameter represents the value of the Max_Master property of the */
     /* node's Device object. The value of Max_Master specifies the highest */
     /* allowable address for master nodes. The value of Max_Master shall be */
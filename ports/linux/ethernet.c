@@ -9,9 +9,13 @@
 #include <stdbool.h> /* for the standard bool type. */
 
 #include "bacport.h"
+#include <poll.h>
+#include <sys/mman.h>
+#include <linux/filter.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/datalink/ethernet.h"
 #include "bacnet/bacint.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** @file linux/ethernet.c  Provides Linux-specific functions for
  * BACnet/Ethernet. */
@@ -28,6 +32,67 @@ uint8_t Ethernet_MAC_Address[MAX_MAC_LEN] = { 0 };
 static int eth802_sockfd = -1; /* 802.2 file handle */
 static struct sockaddr eth_addr = { 0 }; /* used for binding 802.2 */
 
+/* Receive and transmit through TPACKET_V3 rings that are memory mapped
+   from the kernel, so that received frames are handled where the kernel
+   put them, a block of frames at a time, instead of with a read() and a
+   copy for each frame.  The plain 802.2 socket is used when the rings
+   can not be set up. */
+#ifndef ETHERNET_PACKET_MMAP
+#define ETHERNET_PACKET_MMAP 1
+#endif
+/* size of each ring block - a multiple of the page size */
+#ifndef ETHERNET_RING_BLOCK_SIZE
+#define ETHERNET_RING_BLOCK_SIZE (1 << 16)
+#endif
+/* number of blocks in the receive ring */
+#ifndef ETHERNET_RING_RX_BLOCKS
+#define ETHERNET_RING_RX_BLOCKS 32
+#endif
+/* number of blocks in the transmit ring */
+#ifndef ETHERNET_RING_TX_BLOCKS
+#define ETHERNET_RING_TX_BLOCKS 2
+#endif
+/* size of each frame slot - holds the largest frame and its header */
+#ifndef ETHERNET_RING_FRAME_SIZE
+#define ETHERNET_RING_FRAME_SIZE 2048
+#endif
+/* milliseconds before the kernel hands over a block that is not full */
+#ifndef ETHERNET_RING_BLOCK_TIMEOUT
+#define ETHERNET_RING_BLOCK_TIMEOUT 10
+#endif
+/* most frames handled by one call of ethernet_receive_pdus(), so that
+   a busy network does not starve the rest of the main loop */
+#ifndef ETHERNET_RECEIVE_PDUS_MAX
+#define ETHERNET_RECEIVE_PDUS_MAX 64
+#endif
+/* offset of the frame data in a transmit frame slot */
+#define ETHERNET_RING_TX_DATA TPACKET_ALIGN(sizeof(struct tpacket3_hdr))
+
+#if ETHERNET_PACKET_MMAP
+static struct ethernet_ring {
+    uint8_t *map;
+    size_t map_size;
+    /* receive block being handled, and its frames not yet handled */
+    unsigned rx_block;
+    struct tpacket3_hdr *rx_frame;
+    unsigned rx_frame_count;
+    /* the block has been handled and can be given back to the kernel */
+    bool rx_release;
+    /* next transmit frame slot */
+    unsigned tx_frame;
+} Ethernet_Ring;
+
+/* accept only 802.2 frames for the BACnet LLC SAP: DSAP, SSAP, UI */
+static struct sock_filter Ethernet_Ring_Filter[] = {
+    BPF_STMT(BPF_LD | BPF_H | BPF_ABS, 14),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x8282, 0, 3),
+    BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 16),
+    BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, 0x03, 0, 1),
+    BPF_STMT(BPF_RET | BPF_K, ETHERNET_RING_FRAME_SIZE),
+    BPF_STMT(BPF_RET | BPF_K, 0),
+};
+#endif
+
 bool ethernet_valid(void)
 {
     return (eth802_sockfd >= 0);
@@ -35,6 +100,12 @@ bool ethernet_valid(void)
 
 void ethernet_cleanup(void)
 {
+#if ETHERNET_PACKET_MMAP
+    if (Ethernet_Ring.map) {
+        munmap(Ethernet_Ring.map, Ethernet_Ring.map_size);
+    }
+    memset(&Ethernet_Ring, 0, sizeof(Ethernet_Ring));
+#endif
     if (ethernet_valid())
         close(eth802_sockfd);
     eth802_sockfd = -1;
@@ -42,6 +113,253 @@ void ethernet_cleanup(void)
     return;
 }
 
+#if ETHERNET_PACKET_MMAP
+/**
+ * @brief Open a packet socket with memory mapped receive and transmit
+ *  rings, and a filter for the BACnet LLC SAP
+ * @param interface_name - name of the network interface
+ * @return socket file descriptor, or -1 if the rings are not available
+ */
+static int ethernet_ring_open(const char *interface_name)
+{
+    struct sock_fprog filter = { sizeof(Ethernet_Ring_Filter) /
+            sizeof(Ethernet_Ring_Filter[0]),
+        Ethernet_Ring_Filter };
+    struct tpacket_req3 rx_req = { 0 }, tx_req = { 0 };
+    struct sockaddr_ll sll = { 0 };
+    int version = TPACKET_V3;
+    size_t map_size;
+    void *map;
+    int sock_fd;
+
+    sll.sll_ifindex = (int)if_nametoindex(interface_name);
+    if (sll.sll_ifindex == 0) {
+        return -1;
+    }
+    sock_fd = socket(AF_PACKET, SOCK_RAW, htons(ETH_P_802_2));
+    if (sock_fd < 0) {
+        return -1;
+    }
+    rx_req.tp_block_size = ETHERNET_RING_BLOCK_SIZE;
+    rx_req.tp_block_nr = ETHERNET_RING_RX_BLOCKS;
+    rx_req.tp_frame_size = ETHERNET_RING_FRAME_SIZE;
+    rx_req.tp_frame_nr = (ETHERNET_RING_BLOCK_SIZE / ETHERNET_RING_FRAME_SIZE) *
+        ETHERNET_RING_RX_BLOCKS;
+    rx_req.tp_retire_blk_tov = ETHERNET_RING_BLOCK_TIMEOUT;
+    tx_req.tp_block_size = ETHERNET_RING_BLOCK_SIZE;
+    tx_req.tp_block_nr = ETHERNET_RING_TX_BLOCKS;
+    tx_req.tp_frame_size = ETHERNET_RING_FRAME_SIZE;
+    tx_req.tp_frame_nr = (ETHERNET_RING_BLOCK_SIZE / ETHERNET_RING_FRAME_SIZE) *
+        ETHERNET_RING_TX_BLOCKS;
+    map_size = ((size_t)rx_req.tp_block_size * rx_req.tp_block_nr) +
+        ((size_t)tx_req.tp_block_size * tx_req.tp_block_nr);
+    if ((setsockopt(sock_fd, SOL_SOCKET, SO_ATTACH_FILTER, &filter,
+             sizeof(filter)) != 0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_VERSION, &version,
+             sizeof(version)) != 0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_RX_RING, &rx_req,
+             sizeof(rx_req)) != 0) ||
+        (setsockopt(sock_fd, SOL_PACKET, PACKET_TX_RING, &tx_req,
+             sizeof(tx_req)) != 0)) {
+        fprintf(stderr, "ethernet: packet ring not available: %s\n",
+            strerror(errno));
+        close(sock_fd);
+        return -1;
+    }
+    map = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, sock_fd, 0);
+    if (map == MAP_FAILED) {
+        fprintf(stderr, "ethernet: packet ring not mapped: %s\n",
+            strerror(errno));
+        close(sock_fd);
+        return -1;
+    }
+    sll.sll_family = AF_PACKET;
+    sll.sll_protocol = htons(ETH_P_802_2);
+    if (bind(sock_fd, (struct sockaddr *)&sll, sizeof(sll)) != 0) {
+        fprintf(stderr, "ethernet: Unable to bind packet ring: %s\n",
+            strerror(errno));
+        munmap(map, map_size);
+        close(sock_fd);
+        return -1;
+    }
+    memset(&Ethernet_Ring, 0, sizeof(Ethernet_Ring));
+    Ethernet_Ring.map = map;
+    Ethernet_Ring.map_size = map_size;
+    atexit(ethernet_cleanup);
+
+    return sock_fd;
+}
+
+/**
+ * @brief Give the receive block that has been handled back to the kernel
+ */
+static void ethernet_ring_release(void)
+{
+    struct tpacket_block_desc *block;
+
+    if (Ethernet_Ring.rx_release) {
+        block = (struct tpacket_block_desc *)(Ethernet_Ring.map +
+            ((size_t)Ethernet_Ring.rx_block * ETHERNET_RING_BLOCK_SIZE));
+        __sync_synchronize();
+        block->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        Ethernet_Ring.rx_block =
+            (Ethernet_Ring.rx_block + 1) % ETHERNET_RING_RX_BLOCKS;
+        Ethernet_Ring.rx_release = false;
+    }
+}
+
+/**
+ * @brief Get the next received frame from the receive ring.  The frame
+ *  stays valid until the next call, or until ethernet_ring_release().
+ * @param timeout - milliseconds to wait for a frame
+ * @param frame_len - returns the number of octets in the frame
+ * @return frame data, or NULL if no frame was received
+ */
+static uint8_t *ethernet_ring_frame(unsigned timeout, unsigned *frame_len)
+{
+    struct tpacket_block_desc *block;
+    struct tpacket3_hdr *frame;
+    struct sockaddr_ll *sll;
+    struct pollfd pfd = { 0 };
+    bool waited = false;
+
+    for (;;) {
+        ethernet_ring_release();
+        if (Ethernet_Ring.rx_frame_count == 0) {
+            block = (struct tpacket_block_desc *)(Ethernet_Ring.map +
+                ((size_t)Ethernet_Ring.rx_block * ETHERNET_RING_BLOCK_SIZE));
+            if ((block->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+                if (waited || (timeout == 0)) {
+                    return NULL;
+                }
+                pfd.fd = eth802_sockfd;
+                pfd.events = POLLIN | POLLERR;
+                if (poll(&pfd, 1, (int)timeout) <= 0) {
+                    return NULL;
+                }
+                waited = true;
+                continue;
+            }
+            __sync_synchronize();
+            Ethernet_Ring.rx_frame_count = block->hdr.bh1.num_pkts;
+            Ethernet_Ring.rx_frame = (struct tpacket3_hdr *)((uint8_t *)block +
+                block->hdr.bh1.offset_to_first_pkt);
+            if (Ethernet_Ring.rx_frame_count == 0) {
+                Ethernet_Ring.rx_release = true;
+                continue;
+            }
+        }
+        frame = Ethernet_Ring.rx_frame;
+        Ethernet_Ring.rx_frame_count--;
+        if (Ethernet_Ring.rx_frame_count) {
+            Ethernet_Ring.rx_frame = (struct tpacket3_hdr *)((uint8_t *)frame +
+                frame->tp_next_offset);
+        } else {
+            Ethernet_Ring.rx_release = true;
+        }
+        sll = (struct sockaddr_ll *)((uint8_t *)frame +
+            TPACKET_ALIGN(sizeof(struct tpacket3_hdr)));
+        if (sll->sll_pkttype == PACKET_OUTGOING) {
+            /* our own transmitted frame */
+            continue;
+        }
+        *frame_len = frame->tp_snaplen;
+
+        return (uint8_t *)frame + frame->tp_mac;
+    }
+}
+
+/**
+ * @brief Queue a frame in the transmit ring, and ask the kernel to send
+ *  the queued frames
+ * @param mtu - the frame to send
+ * @param mtu_len - number of octets in the frame
+ * @return number of octets queued, or -1 on failure
+ */
+static int ethernet_ring_send(uint8_t *mtu, int mtu_len)
+{
+    struct tpacket3_hdr *frame;
+    size_t rx_size = (size_t)ETHERNET_RING_BLOCK_SIZE * ETHERNET_RING_RX_BLOCKS;
+    unsigned tx_frames =
+        (ETHERNET_RING_BLOCK_SIZE / ETHERNET_RING_FRAME_SIZE) *
+        ETHERNET_RING_TX_BLOCKS;
+
+    if ((mtu_len <= 0) ||
+        ((size_t)mtu_len >
+            (ETHERNET_RING_FRAME_SIZE - ETHERNET_RING_TX_DATA))) {
+        errno = EMSGSIZE;
+        return -1;
+    }
+    frame = (struct tpacket3_hdr *)(Ethernet_Ring.map + rx_size +
+        ((size_t)Ethernet_Ring.tx_frame * ETHERNET_RING_FRAME_SIZE));
+    if (frame->tp_status & TP_STATUS_WRONG_FORMAT) {
+        frame->tp_status = TP_STATUS_AVAILABLE;
+    }
+    if (frame->tp_status != TP_STATUS_AVAILABLE) {
+        /* the ring is full - wait for the kernel to send the frames */
+        (void)send(eth802_sockfd, NULL, 0, 0);
+        if (frame->tp_status != TP_STATUS_AVAILABLE) {
+            errno = ENOBUFS;
+            return -1;
+        }
+    }
+    memcpy((uint8_t *)frame + ETHERNET_RING_TX_DATA, mtu, (size_t)mtu_len);
+    frame->tp_len = (uint32_t)mtu_len;
+    frame->tp_snaplen = (uint32_t)mtu_len;
+    frame->tp_next_offset = 0;
+    __sync_synchronize();
+    frame->tp_status = TP_STATUS_SEND_REQUEST;
+    Ethernet_Ring.tx_frame = (Ethernet_Ring.tx_frame + 1) % tx_frames;
+    if ((send(eth802_sockfd, NULL, 0, MSG_DONTWAIT) < 0) &&
+        (errno != EAGAIN) && (errno != ENOBUFS)) {
+        return -1;
+    }
+
+    return mtu_len;
+}
+#endif
+
+/**
+ * @brief Check a received 802.2 frame, and find its BACnet PDU
+ * @param frame - received frame
+ * @param frame_len - number of octets in the frame
+ * @param src - returns the source address
+ * @param pdu_len - returns the number of octets in the PDU
+ * @return the PDU in the frame, or NULL if the frame is not for us
+ */
+static uint8_t *ethernet_frame_pdu(uint8_t *frame,
+    unsigned frame_len,
+    BACNET_ADDRESS *src,
+    uint16_t *pdu_len)
+{
+    uint16_t len = 0;
+
+    if (frame_len < ETHERNET_HEADER_MAX) {
+        return NULL;
+    }
+    /* the signature of an 802.2 BACnet packet */
+    if ((frame[14] != 0x82) || (frame[15] != 0x82)) {
+        return NULL;
+    }
+    /* check destination address for when */
+    /* the Ethernet card is in promiscious mode */
+    if ((memcmp(&frame[0], Ethernet_MAC_Address, 6) != 0) &&
+        (memcmp(&frame[0], Ethernet_Broadcast, 6) != 0)) {
+        return NULL;
+    }
+    (void)decode_unsigned16(&frame[12], &len);
+    /* DSAP, SSAP, LLC Control */
+    if ((len < 3) || ((unsigned)(len - 3) > (frame_len - 17))) {
+        return NULL;
+    }
+    /* copy the source address */
+    src->mac_len = 6;
+    memmove(src->mac, &frame[6], 6);
+    *pdu_len = len - 3;
+
+    return &frame[17];
+}
+
 #if 0
 /*----------------------------------------------------------------------
  Portable function to set a socket into nonblocking mode.
@@ -163,13 +481,17 @@ static int get_local_hwaddr(const char *ifname, unsigned char *mac)
 
 bool ethernet_init(char *interface_name)
 {
-    if (interface_name) {
-        get_local_hwaddr(interface_name, Ethernet_MAC_Address);
-        eth802_sockfd = ethernet_bind(&eth_addr, interface_name);
-    } else {
-        get_local_hwaddr("eth0", Ethernet_MAC_Address);
-        eth802_sockfd = ethernet_bind(&eth_addr, "eth0");
+    if (!interface_name) {
+        interface_name = "eth0";
+    }
+    get_local_hwaddr(interface_name, Ethernet_MAC_Address);
+#if ETHERNET_PACKET_MMAP
+    eth802_sockfd = ethernet_ring_open(interface_name);
+    if (eth802_sockfd >= 0) {
+        return true;
     }
+#endif
+    eth802_sockfd = ethernet_bind(&eth_addr, interface_name);
 
     return ethernet_valid();
 }
@@ -179,12 +501,23 @@ int ethernet_send(uint8_t *mtu, int mtu_len)
     int bytes = 0;
 
     /* Send the packet */
-    bytes = sendto(eth802_sockfd, &mtu, mtu_len, 0,
-        (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
+#if ETHERNET_PACKET_MMAP
+    if (Ethernet_Ring.map) {
+        bytes = ethernet_ring_send(mtu, mtu_len);
+    } else
+#endif
+    {
+        bytes = sendto(eth802_sockfd, mtu, mtu_len, 0,
+            (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
+    }
     /* did it get sent? */
-    if (bytes < 0)
+    if (bytes < 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
         fprintf(
             stderr, "ethernet: Error sending packet: %s\n", strerror(errno));
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    }
 
     return bytes;
 }
@@ -248,12 +581,7 @@ int ethernet_send_pdu(BACNET_ADDRESS *dest, /* destination address */
     encode_unsigned16(&mtu[12], 3 + pdu_len);
 
     /* Send the packet */
-    bytes = sendto(eth802_sockfd, &mtu, mtu_len, 0,
-        (struct sockaddr *)&eth_addr, sizeof(struct sockaddr));
-    /* did it get sent? */
-    if (bytes < 0)
-        fprintf(
-            stderr, "ethernet: Error sending packet: %s\n", strerror(errno));
+    bytes = ethernet_send(mtu, mtu_len);
 
     return bytes;
 }
@@ -267,6 +595,9 @@ uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
 { /* number of milliseconds to wait for a packet */
     int received_bytes;
     uint8_t buf[ETHERNET_MPDU_MAX] = { 0 }; /* data */
+    uint8_t *frame = &buf[0];
+    uint8_t *frame_pdu = NULL;
+    unsigned frame_len = 0;
     uint16_t pdu_len = 0; /* return value */
     fd_set read_fds;
     int max;
@@ -276,67 +607,119 @@ uint16_t ethernet_receive(BACNET_ADDRESS *src, /* source address */
     if (eth802_sockfd <= 0)
         return 0;
 
-    /* we could just use a non-blocking socket, but that consumes all
-       the CPU time.  We can use a timeout; it is only supported as
-       a select. */
-    if (timeout >= 1000) {
-        select_timeout.tv_sec = timeout / 1000;
-        select_timeout.tv_usec =
-            1000 * (timeout - select_timeout.tv_sec * 1000);
-    } else {
-        select_timeout.tv_sec = 0;
-        select_timeout.tv_usec = 1000 * timeout;
-    }
-    FD_ZERO(&read_fds);
-    FD_SET(eth802_sockfd, &read_fds);
-    max = eth802_sockfd;
-
-    if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0)
-        received_bytes = read(eth802_sockfd, &buf[0], sizeof(buf));
-    else
-        return 0;
+#if ETHERNET_PACKET_MMAP
+    if (Ethernet_Ring.map) {
+        frame = ethernet_ring_frame(timeout, &frame_len);
+        if (!frame) {
+            return 0;
+        }
+    } else
+#endif
+    {
+        /* we could just use a non-blocking socket, but that consumes all
+           the CPU time.  We can use a timeout; it is only supported as
+           a select. */
+        if (timeout >= 1000) {
+            select_timeout.tv_sec = timeout / 1000;
+            select_timeout.tv_usec =
+                1000 * (timeout - select_timeout.tv_sec * 1000);
+        } else {
+            select_timeout.tv_sec = 0;
+            select_timeout.tv_usec = 1000 * timeout;
+        }
+        FD_ZERO(&read_fds);
+        FD_SET(eth802_sockfd, &read_fds);
+        max = eth802_sockfd;
+
+        if (select(max + 1, &read_fds, NULL, NULL, &select_timeout) > 0)
+            received_bytes = read(eth802_sockfd, &buf[0], sizeof(buf));
+        else
+            return 0;
+
+        /* See if there is a problem */
+        if (received_bytes < 0) {
+            /* EAGAIN Non-blocking I/O has been selected  */
+            /* using O_NONBLOCK and no data */
+            /* was immediately available for reading. */
+            if (errno != EAGAIN)
+                fprintf(stderr,
+                    "ethernet: Read error in receiving packet: %s\n",
+                    strerror(errno));
+            return 0;
+        }
 
-    /* See if there is a problem */
-    if (received_bytes < 0) {
-        /* EAGAIN Non-blocking I/O has been selected  */
-        /* using O_NONBLOCK and no data */
-        /* was immediately available for reading. */
-        if (errno != EAGAIN)
-            fprintf(stderr, "ethernet: Read error in receiving packet: %s\n",
-                strerror(errno));
-        return 0;
+        if (received_bytes == 0)
+            return 0;
+        frame_len = (unsigned)received_bytes;
+    }
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
+    frame_pdu = ethernet_frame_pdu(frame, frame_len, src, &pdu_len);
+    /* copy the buffer into the PDU */
+    if (frame_pdu && (pdu_len < max_pdu))
+        memmove(&pdu[0], frame_pdu, pdu_len);
+    /* ignore packets that are too large */
+    else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
+        pdu_len = 0;
     }
 
-    if (received_bytes == 0)
-        return 0;
+    return pdu_len;
+}
 
-    /* the signature of an 802.2 BACnet packet */
-    if ((buf[14] != 0x82) && (buf[15] != 0x82)) {
-        /*fprintf(stderr,"ethernet: Non-BACnet packet\n"); */
-        return 0;
-    }
-    /* copy the source address */
-    src->mac_len = 6;
-    memmove(src->mac, &buf[6], 6);
+/**
+ * @brief Receive the 802.2 framed packets that are waiting, and pass each
+ *  PDU to the handler.  With the packet ring, the PDU is passed where the
+ *  kernel put it, and up to ETHERNET_RECEIVE_PDUS_MAX frames are handled
+ *  in one call.  The frames that are left stay in the ring for the next
+ *  call, which does not wait for them.
+ * @param handler - function to handle each PDU, such as npdu_handler()
+ * @param timeout - number of milliseconds to wait for a packet
+ * @return number of PDUs passed to the handler
+ */
+unsigned ethernet_receive_pdus(ethernet_pdu_handler handler, unsigned timeout)
+{
+    BACNET_ADDRESS src = { 0 };
+    uint8_t pdu[MAX_PDU] = { 0 };
+    uint16_t pdu_len = 0;
+    unsigned count = 0;
+#if ETHERNET_PACKET_MMAP
+    uint8_t *frame = NULL;
+    uint8_t *frame_pdu = NULL;
+    unsigned frame_len = 0;
+    unsigned frames = 0;
+#endif
 
-    /* check destination address for when */
-    /* the Ethernet card is in promiscious mode */
-    if ((memcmp(&buf[0], Ethernet_MAC_Address, 6) != 0) &&
-        (memcmp(&buf[0], Ethernet_Broadcast, 6) != 0)) {
-        /*fprintf(stderr, "ethernet: This packet isn't for us\n"); */
+    if (!handler || (eth802_sockfd <= 0)) {
         return 0;
     }
+#if ETHERNET_PACKET_MMAP
+    if (Ethernet_Ring.map) {
+        while ((frames < ETHERNET_RECEIVE_PDUS_MAX) &&
+            ((frame = ethernet_ring_frame(timeout, &frame_len)) != NULL)) {
+            /* only wait for the first frame */
+            timeout = 0;
+            frames++;
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
+            frame_pdu = ethernet_frame_pdu(frame, frame_len, &src, &pdu_len);
+            if (frame_pdu && (pdu_len > 0)) {
+                handler(&src, frame_pdu, pdu_len);
+                count++;
+            } else {
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
+            }
+        }
+        ethernet_ring_release();
 
-    (void)decode_unsigned16(&buf[12], &pdu_len);
-    pdu_len -= 3 /* DSAP, SSAP, LLC Control */;
-    /* copy the buffer into the PDU */
-    if (pdu_len < max_pdu)
-        memmove(&pdu[0], &buf[17], pdu_len);
-    /* ignore packets that are too large */
-    else
-        pdu_len = 0;
+        return count;
+    }
+#endif
+    pdu_len = ethernet_receive(&src, pdu, sizeof(pdu), timeout);
+    if (pdu_len > 0) {
+        handler(&src, pdu, pdu_len);
+        count++;
+    }
 
-    return pdu_len;
+    return count;
 }
 
 void ethernet_set_my_address(BACNET_ADDRESS *my_address)
@@ -60,6 +60,38 @@
    B'111'   interpreted as Type   = Closing Tag
 */
 
+/* Fast-path octets for the most common application tagged primitives
+   where the tag fits in one octet and the length is 1..4 octets.
+   REAL, ENUMERATED, UNSIGNED and OBJECT_ID dominate RPM and COV
+   payloads, so these skip the generic tag decoder. */
+#define FAST_TAG_OCTET(tag_number, len) \
+    ((uint8_t)(((tag_number) << 4) | ((len)&0x07)))
+#define FAST_TAG_REAL \
+    FAST_TAG_OCTET(BACNET_APPLICATION_TAG_REAL, 4)
+#define FAST_TAG_OBJECT_ID \
+    FAST_TAG_OCTET(BACNET_APPLICATION_TAG_OBJECT_ID, 4)
+#define FAST_TAG_SMALL_LENGTH(octet, tag_number) \
+    ((((octet)&0xF8) == ((tag_number) << 4)) && (((octet)&0x07) >= 1) && \
+        (((octet)&0x07) <= 4))
+
+/**
+ * @brief Load a big-endian unsigned value of 1..4 octets
+ * @param apdu - buffer holding at least len octets
+ * @param len - number of octets 1..4
+ * @return the decoded value
+ */
+static uint32_t fast_unsigned32_load(const uint8_t *apdu, uint32_t len)
+{
+    uint32_t value = 0;
+    uint32_t i;
+
+    for (i = 0; i < len; i++) {
+        value = (value << 8) | apdu[i];
+    }
+
+    return value;
+}
+
 /**
  * Encode the max APDU value and return the encoded octed.
  *
@@ -1842,6 +1874,10 @@ int bacnet_object_id_application_decode(uint8_t *apdu,
     int len = 0;
     BACNET_TAG tag = { 0 };
 
+    if (apdu && (apdu_size >= 5) && (apdu[0] == FAST_TAG_OBJECT_ID)) {
+        return 1 + decode_object_id_safe(
+            &apdu[1], 4, object_type, object_instance);
+    }
     len = bacnet_tag_decode(apdu, apdu_size, &tag);
     if ((len > 0) && tag.application) {
         if (tag.number == BACNET_APPLICATION_TAG_OBJECT_ID) {
@@ -1861,6 +1897,72 @@ int bacnet_object_id_application_decode(uint8_t *apdu,
     return apdu_len;
 }
 
+/**
+ * @brief Bulk decode consecutive application tagged BACnet Object
+ *  Identifier values, such as the elements of an Object_List.
+ *  Decoding stops at the first element that is not an application
+ *  tagged Object Identifier (for example a closing tag), at the end
+ *  of the buffer, or when the value array is full.
+ *
+ * @param apdu - buffer of data to be decoded
+ * @param apdu_size - number of bytes in the buffer
+ * @param value - array of object identifiers to fill, or NULL to count
+ * @param value_size - number of elements in the value array
+ * @param value_count - number of elements decoded, if not NULL
+ *
+ * @return number of bytes decoded, or #BACNET_STATUS_ERROR (-1) if malformed
+ */
+int bacnet_object_id_application_array_decode(uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_OBJECT_ID *value,
+    uint32_t value_size,
+    uint32_t *value_count)
+{
+    uint32_t apdu_len = 0;
+    uint32_t count = 0;
+    uint32_t bits;
+    int len;
+
+    if (!apdu) {
+        return BACNET_STATUS_ERROR;
+    }
+    while ((count < value_size) && (apdu_len < apdu_size)) {
+        if ((apdu[apdu_len] == FAST_TAG_OBJECT_ID) &&
+            ((apdu_size - apdu_len) >= 5)) {
+            bits = fast_unsigned32_load(&apdu[apdu_len + 1], 4);
+            if (value) {
+                value[count].type = (BACNET_OBJECT_TYPE)(
+                    (bits >> BACNET_INSTANCE_BITS) & BACNET_MAX_OBJECT);
+                value[count].instance = bits & BACNET_MAX_INSTANCE;
+            }
+            apdu_len += 5;
+            count++;
+        } else if (IS_CONTEXT_SPECIFIC(apdu[apdu_len])) {
+            /* end of the list, such as a closing tag */
+            break;
+        } else {
+            len = bacnet_object_id_application_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, NULL, NULL);
+            if (len < 0) {
+                return BACNET_STATUS_ERROR;
+            } else if (len == 0) {
+                break;
+            }
+            /* a longer than usual, but valid, encoding */
+            (void)bacnet_object_id_application_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, value ? &value[count].type : NULL,
+                value ? &value[count].instance : NULL);
+            apdu_len += (uint32_t)len;
+            count++;
+        }
+    }
+    if (value_count) {
+        *value_count = count;
+    }
+
+    return (int)apdu_len;
+}
+
 /**
  * @brief Decode the BACnet Object Identifier Value when context encoded
  * as defined in clause 20.2.14 Encoding of an Object Identifier Value
@@ -2006,6 +2108,10 @@ int encode_application_object_id(
     int len = 0;
     uint8_t *apdu_offset = NULL;
 
+    if (apdu) {
+        apdu[0] = FAST_TAG_OBJECT_ID;
+        return 1 + encode_bacnet_object_id(&apdu[1], object_type, instance);
+    }
     /* get the length by using NULL APDU */
     len = encode_bacnet_object_id(NULL, object_type, instance);
     len = encode_tag(
@@ -2795,6 +2901,16 @@ int bacnet_unsigned_application_decode(
     int len = 0;
     BACNET_TAG tag = { 0 };
 
+    if (apdu && (apdu_size > 0) &&
+        FAST_TAG_SMALL_LENGTH(apdu[0], BACNET_APPLICATION_TAG_UNSIGNED_INT)) {
+        len = apdu[0] & 0x07;
+        if (apdu_size > (uint32_t)len) {
+            if (value) {
+                *value = fast_unsigned32_load(&apdu[1], (uint32_t)len);
+            }
+            return 1 + len;
+        }
+    }
     len = bacnet_tag_decode(apdu, apdu_size, &tag);
     if ((len > 0) && tag.application) {
         if (tag.number == BACNET_APPLICATION_TAG_UNSIGNED_INT) {
@@ -3056,6 +3172,16 @@ int bacnet_enumerated_application_decode(
     BACNET_UNSIGNED_INTEGER unsigned_value = 0;
     BACNET_TAG tag = { 0 };
 
+    if (apdu && (apdu_size > 0) &&
+        FAST_TAG_SMALL_LENGTH(apdu[0], BACNET_APPLICATION_TAG_ENUMERATED)) {
+        len = apdu[0] & 0x07;
+        if (apdu_size > (uint32_t)len) {
+            if (value) {
+                *value = fast_unsigned32_load(&apdu[1], (uint32_t)len);
+            }
+            return 1 + len;
+        }
+    }
     len = bacnet_tag_decode(apdu, apdu_size, &tag);
     if ((len > 0) && tag.application) {
         if (tag.number == BACNET_APPLICATION_TAG_ENUMERATED) {
@@ -3506,6 +3632,10 @@ int encode_application_real(uint8_t *apdu, float value)
     int len = 0;
     uint8_t *apdu_offset = NULL;
 
+    if (apdu) {
+        apdu[0] = FAST_TAG_REAL;
+        return 1 + encode_bacnet_real(value, &apdu[1]);
+    }
     /* length of REAL is 4 octets, as per 20.2.6 */
     len = encode_tag(apdu, BACNET_APPLICATION_TAG_REAL, false, 4);
     if (apdu) {
@@ -3651,6 +3781,9 @@ int bacnet_real_application_decode(
     int len = 0;
     BACNET_TAG tag = { 0 };
 
+    if (apdu && (apdu_size >= 5) && (apdu[0] == FAST_TAG_REAL)) {
+        return 1 + decode_real(&apdu[1], value);
+    }
     len = bacnet_tag_decode(apdu, apdu_size, &tag);
     if ((len > 0) && tag.application) {
         if (tag.number == BACNET_APPLICATION_TAG_REAL) {
@@ -276,6 +276,12 @@ int bacnet_object_id_application_decode(
     BACNET_OBJECT_TYPE *object_type,
     uint32_t *object_instance);
 BACNET_STACK_EXPORT
+int bacnet_object_id_application_array_decode(uint8_t *apdu,
+    uint32_t apdu_size,
+    BACNET_OBJECT_ID *value,
+    uint32_t value_size,
+    uint32_t *value_count);
+BACNET_STACK_EXPORT
 int bacnet_object_id_context_decode(
     uint8_t *apdu,
     uint32_t apdu_len_max,
@@ -23,26 +23,16 @@
 /* returns the number of apdu bytes consumed */
 int decode_real(uint8_t *apdu, float *real_value)
 {
-    union {
-        uint8_t byte[4];
-        float real_value;
-    } my_data;
+    uint32_t bits;
 
     if (apdu) {
-        /* NOTE: assumes the compiler stores float as IEEE-754 float */
-        if (big_endian()) {
-            my_data.byte[0] = apdu[0];
-            my_data.byte[1] = apdu[1];
-            my_data.byte[2] = apdu[2];
-            my_data.byte[3] = apdu[3];
-        } else {
-            my_data.byte[0] = apdu[3];
-            my_data.byte[1] = apdu[2];
-            my_data.byte[2] = apdu[1];
-            my_data.byte[3] = apdu[0];
-        }
+        /* NOTE: assumes the compiler stores float as IEEE-754 float
+           and uses the same byte order for float and uint32_t.
+           A big-endian load with shifts is host endian independent. */
+        bits = ((uint32_t)apdu[0] << 24) | ((uint32_t)apdu[1] << 16) |
+            ((uint32_t)apdu[2] << 8) | (uint32_t)apdu[3];
         if (real_value) {
-            *real_value = my_data.real_value;
+            memcpy(real_value, &bits, sizeof(bits));
         }
     }
 
@@ -65,25 +55,16 @@ int decode_real_safe(uint8_t *apdu, uint32_t len_value, float *real_value)
 /* returns the number of apdu bytes consumed */
 int encode_bacnet_real(float value, uint8_t *apdu)
 {
-    union {
-        uint8_t byte[4];
-        float real_value;
-    } my_data;
+    uint32_t bits;
 
-    /* NOTE: assumes the compiler stores float as IEEE-754 float */
-    my_data.real_value = value;
     if (apdu) {
-        if (big_endian()) {
-            apdu[0] = my_data.byte[0];
-            apdu[1] = my_data.byte[1];
-            apdu[2] = my_data.byte[2];
-            apdu[3] = my_data.byte[3];
-        } else {
-            apdu[0] = my_data.byte[3];
-            apdu[1] = my_data.byte[2];
-            apdu[2] = my_data.byte[1];
-            apdu[3] = my_data.byte[0];
-        }
+        /* NOTE: assumes the compiler stores float as IEEE-754 float
+           and uses the same byte order for float and uint32_t. */
+        memcpy(&bits, &value, sizeof(bits));
+        apdu[0] = (uint8_t)(bits >> 24);
+        apdu[1] = (uint8_t)(bits >> 16);
+        apdu[2] = (uint8_t)(bits >> 8);
+        apdu[3] = (uint8_t)bits;
     }
 
     return 4;
@@ -95,6 +76,21 @@ int encode_bacnet_real(float value, uint8_t *apdu)
 /* returns the number of apdu bytes consumed */
 int decode_double(uint8_t *apdu, double *double_value)
 {
+#ifdef UINT64_MAX
+    uint64_t bits;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores double as IEEE-754 double
+           and uses the same byte order for double and uint64_t. */
+        bits = ((uint64_t)apdu[0] << 56) | ((uint64_t)apdu[1] << 48) |
+            ((uint64_t)apdu[2] << 40) | ((uint64_t)apdu[3] << 32) |
+            ((uint64_t)apdu[4] << 24) | ((uint64_t)apdu[5] << 16) |
+            ((uint64_t)apdu[6] << 8) | (uint64_t)apdu[7];
+        if (double_value) {
+            memcpy(double_value, &bits, sizeof(bits));
+        }
+    }
+#else
     union {
         uint8_t byte[8];
         double double_value;
@@ -125,6 +121,7 @@ int decode_double(uint8_t *apdu, double *double_value)
             *double_value = my_data.double_value;
         }
     }
+#endif
 
     return 8;
 }
@@ -145,6 +142,23 @@ int decode_double_safe(uint8_t *apdu, uint32_t len_value, double *double_value)
 /* returns the number of apdu bytes consumed */
 int encode_bacnet_double(double value, uint8_t *apdu)
 {
+#ifdef UINT64_MAX
+    uint64_t bits;
+
+    if (apdu) {
+        /* NOTE: assumes the compiler stores double as IEEE-754 double
+           and uses the same byte order for double and uint64_t. */
+        memcpy(&bits, &value, sizeof(bits));
+        apdu[0] = (uint8_t)(bits >> 56);
+        apdu[1] = (uint8_t)(bits >> 48);
+        apdu[2] = (uint8_t)(bits >> 40);
+        apdu[3] = (uint8_t)(bits >> 32);
+        apdu[4] = (uint8_t)(bits >> 24);
+        apdu[5] = (uint8_t)(bits >> 16);
+        apdu[6] = (uint8_t)(bits >> 8);
+        apdu[7] = (uint8_t)bits;
+    }
+#else
     union {
         uint8_t byte[8];
         double double_value;
@@ -173,6 +187,7 @@ int encode_bacnet_double(double value, uint8_t *apdu)
             apdu[7] = my_data.byte[0];
         }
     }
+#endif
 
     return 8;
 }
@@ -10,33 +10,40 @@
 #include "bacnet/indtext.h"
 #include "bacnet/bacenum.h"
 #include "bacnet/bactext.h"
+#include "bacnet/basic/sys/platform.h"
 
 static const char *ASHRAE_Reserved_String = "Reserved for Use by ASHRAE";
 static const char *Vendor_Proprietary_String = "Vendor Proprietary Value";
 
+/* Convert the text to an integer value */
+static bool bactext_strtol(const char *search_name, unsigned *found_index)
+{
+    char *endptr;
+    long value;
+
+    value = strtol(search_name, &endptr, 0);
+    if (endptr == search_name) {
+        /* No digits found */
+        return false;
+    } else if (*endptr != '\0') {
+        /* Extra text found */
+        return false;
+    }
+    *found_index = (unsigned)value;
+
+    return true;
+}
+
 /* Search for a text value first based on the corresponding text list, then by
  * attempting to convert to an integer value. */
 static bool bactext_strtol_index(
     INDTEXT_DATA *istring, const char *search_name, unsigned *found_index)
 {
-    char *endptr;
-    long value;
-
     if (indtext_by_istring(istring, search_name, found_index) == true) {
         return true;
-    } else {
-        value = strtol(search_name, &endptr, 0);
-        if (endptr == search_name) {
-            /* No digits found */
-            return false;
-        } else if (*endptr != '\0') {
-            /* Extra text found */
-            return false;
-        } else {
-            *found_index = (unsigned)value;
-            return true;
-        }
     }
+
+    return bactext_strtol(search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_confirmed_service_names[] = {
@@ -222,23 +229,35 @@ INDTEXT_DATA bacnet_object_type_names[] = { { OBJECT_ANALOG_INPUT,
        the procedures and constraints described in Clause 23. */
     { 0, NULL } };
 
+/* sorted views of the object type names, for binary search */
+static INDTEXT_DATA
+    *Object_Type_Names_By_Name[ARRAY_SIZE(bacnet_object_type_names)];
+static INDTEXT_DATA
+    *Object_Type_Names_By_Index[ARRAY_SIZE(bacnet_object_type_names)];
+static INDTEXT_INDEX Object_Type_Names_Index = { bacnet_object_type_names,
+    Object_Type_Names_By_Name, Object_Type_Names_By_Index,
+    ARRAY_SIZE(bacnet_object_type_names), 0, 0, false };
+
 const char *bactext_object_type_name(unsigned index)
 {
-    return indtext_by_index_split_default(bacnet_object_type_names, index,
-        OBJECT_PROPRIETARY_MIN, ASHRAE_Reserved_String,
-        Vendor_Proprietary_String);
+    return indtext_index_by_index_default(&Object_Type_Names_Index, index,
+        (index < OBJECT_PROPRIETARY_MIN) ? ASHRAE_Reserved_String
+                                         : Vendor_Proprietary_String);
 }
 
 bool bactext_object_type_index(const char *search_name, unsigned *found_index)
 {
-    return indtext_by_istring(
-        bacnet_object_type_names, search_name, found_index);
+    return indtext_index_by_istring(
+        &Object_Type_Names_Index, search_name, found_index);
 }
 
 bool bactext_object_type_strtol(const char *search_name, unsigned *found_index)
 {
-    return bactext_strtol_index(
-        bacnet_object_type_names, search_name, found_index);
+    if (bactext_object_type_index(search_name, found_index)) {
+        return true;
+    }
+
+    return bactext_strtol(search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_property_names[] = {
@@ -726,6 +745,14 @@ INDTEXT_DATA bacnet_property_names[] = {
     { PROP_TRIM_FADE_TIME, "trim-fade-time" }, { 0, NULL }
 };
 
+/* sorted views of the property names, for binary search */
+static INDTEXT_DATA *Property_Names_By_Name[ARRAY_SIZE(bacnet_property_names)];
+static INDTEXT_DATA
+    *Property_Names_By_Index[ARRAY_SIZE(bacnet_property_names)];
+static INDTEXT_INDEX Property_Names_Index = { bacnet_property_names,
+    Property_Names_By_Name, Property_Names_By_Index,
+    ARRAY_SIZE(bacnet_property_names), 0, 0, false };
+
 bool bactext_property_name_proprietary(unsigned index)
 {
     bool status = false;
@@ -746,32 +773,42 @@ const char *bactext_property_name(unsigned index)
     if (bactext_property_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else {
-        return indtext_by_index_default(
-            bacnet_property_names, index, ASHRAE_Reserved_String);
+        return indtext_index_by_index_default(
+            &Property_Names_Index, index, ASHRAE_Reserved_String);
     }
 }
 
 const char *bactext_property_name_default(
     unsigned index, const char *default_string)
 {
-    return indtext_by_index_default(
-        bacnet_property_names, index, default_string);
+    return indtext_index_by_index_default(
+        &Property_Names_Index, index, default_string);
 }
 
 unsigned bactext_property_id(const char *name)
 {
-    return indtext_by_istring_default(bacnet_property_names, name, 0);
+    unsigned index = 0;
+
+    if (!indtext_index_by_istring(&Property_Names_Index, name, &index)) {
+        index = 0;
+    }
+
+    return index;
 }
 
 bool bactext_property_index(const char *search_name, unsigned *found_index)
 {
-    return indtext_by_istring(bacnet_property_names, search_name, found_index);
+    return indtext_index_by_istring(
+        &Property_Names_Index, search_name, found_index);
 }
 
 bool bactext_property_strtol(const char *search_name, unsigned *found_index)
 {
-    return bactext_strtol_index(
-        bacnet_property_names, search_name, found_index);
+    if (bactext_property_index(search_name, found_index)) {
+        return true;
+    }
+
+    return bactext_strtol(search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_engineering_unit_names[] = {
@@ -1161,6 +1198,17 @@ INDTEXT_DATA bacnet_engineering_unit_names[] = {
        the procedures and constraints described in Clause 23. */
 };
 
+/* sorted views of the engineering unit names, for binary search */
+static INDTEXT_DATA
+    *Engineering_Unit_Names_By_Name[ARRAY_SIZE(bacnet_engineering_unit_names)];
+static INDTEXT_DATA *Engineering_Unit_Names_By_Index[ARRAY_SIZE(
+    bacnet_engineering_unit_names)];
+static INDTEXT_INDEX Engineering_Unit_Names_Index = {
+    bacnet_engineering_unit_names, Engineering_Unit_Names_By_Name,
+    Engineering_Unit_Names_By_Index, ARRAY_SIZE(bacnet_engineering_unit_names),
+    0, 0, false
+};
+
 bool bactext_engineering_unit_name_proprietary(unsigned index)
 {
     bool status = false;
@@ -1181,8 +1229,8 @@ const char *bactext_engineering_unit_name(unsigned index)
     if (bactext_engineering_unit_name_proprietary(index)) {
         return Vendor_Proprietary_String;
     } else if (index <= UNITS_RESERVED_RANGE_MAX2) {
-        return indtext_by_index_default(
-            bacnet_engineering_unit_names, index, ASHRAE_Reserved_String);
+        return indtext_index_by_index_default(
+            &Engineering_Unit_Names_Index, index, ASHRAE_Reserved_String);
     }
 
     return ASHRAE_Reserved_String;
@@ -1191,8 +1239,8 @@ const char *bactext_engineering_unit_name(unsigned index)
 bool bactext_engineering_unit_index(
     const char *search_name, unsigned *found_index)
 {
-    return indtext_by_istring(
-        bacnet_engineering_unit_names, search_name, found_index);
+    return indtext_index_by_istring(
+        &Engineering_Unit_Names_Index, search_name, found_index);
 }
 
 INDTEXT_DATA bacnet_reject_reason_names[] = { { REJECT_REASON_OTHER, "Other" },
@@ -1969,3 +2017,16 @@ const char *bactext_shed_level_type_name(unsigned index)
     return indtext_by_index_default(
         bacnet_shed_level_type_names, index, ASHRAE_Reserved_String);
 }
+
+/**
+ * @brief Sort the name tables that are searched with a binary search.
+ *  The tables are otherwise sorted by their first lookup, which is not
+ *  thread-safe; call this once before using bactext from more than one
+ *  thread.
+ */
+void bactext_init(void)
+{
+    indtext_index_init(&Object_Type_Names_Index);
+    indtext_index_init(&Property_Names_Index);
+    indtext_index_init(&Engineering_Unit_Names_Index);
+}
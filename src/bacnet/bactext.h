@@ -24,6 +24,12 @@
 extern "C" {
 #endif /* __cplusplus */
 
+    /* the object type, property, and engineering unit lookups sort
+       their tables on first use, which is not thread-safe: call
+       bactext_init() first when bactext is used from several threads */
+    BACNET_STACK_EXPORT
+    void bactext_init(void);
+
     BACNET_STACK_EXPORT
     const char *bactext_confirmed_service_name(
         unsigned index);
@@ -14,6 +14,7 @@
 #include "bacnet/datalink/bip.h"
 #include "bacnet/datalink/bvlc.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd/h_bbmd.h"
 
@@ -50,6 +51,27 @@ static bool BVLC_NAT_Handling = false;
 static BACNET_IP_ADDRESS Remote_BBMD;
 /** if we are a foreign device, store the Time-To-Live Seconds here */
 static uint16_t Remote_BBMD_TTL_Seconds;
+#if BBMD_CLIENT_ENABLED
+/** the BBMDs that we register with, in order of preference */
+static struct remote_bbmd {
+    BACNET_IP_ADDRESS address;
+    uint16_t ttl_seconds;
+    uint16_t result_code;
+    bool registered;
+    /* waiting for the result of a registration */
+    bool pending;
+    /* milliseconds since the registration was sent */
+    uint32_t elapsed_ms;
+    uint32_t rtt_ms;
+    /* milliseconds until the next registration */
+    uint32_t renew_ms;
+    /* milliseconds between tries after a failure */
+    uint32_t retry_ms;
+} Remote_BBMD_List[BVLC_REMOTE_BBMD_MAX];
+static unsigned Remote_BBMD_Count;
+/** seconds between registrations, or 0 for half of the Time-To-Live */
+static uint16_t Remote_BBMD_Refresh_Seconds = BVLC_REMOTE_BBMD_REFRESH_SECONDS;
+#endif
 #if BBMD_ENABLED || BBMD_CLIENT_ENABLED
 /* local buffer & length for sending */
 static uint8_t BVLC_Buffer[BIP_MPDU_MAX];
@@ -246,6 +268,122 @@ void bvlc_maintenance_timer(uint16_t seconds)
 #endif
 }
 
+#if BBMD_CLIENT_ENABLED
+/**
+ * @brief Send the foreign device registration to one of our BBMDs
+ * @param bbmd - the BBMD to register with
+ * @return number of bytes sent, or -1 on failure
+ */
+static int remote_bbmd_register(struct remote_bbmd *bbmd)
+{
+    uint8_t mtu[16] = { 0 };
+    uint16_t mtu_len = 0;
+
+    mtu_len = bvlc_encode_register_foreign_device(
+        &mtu[0], sizeof(mtu), bbmd->ttl_seconds);
+    bbmd->pending = true;
+    bbmd->elapsed_ms = 0;
+    debug_print_bip("Send Register-Foreign-Device", &bbmd->address);
+
+    return bip_send_mpdu(&bbmd->address, &mtu[0], mtu_len);
+}
+
+/**
+ * @brief Schedule the next registration with a BBMD. A registration
+ *  is renewed at half of its Time-To-Live, or at the refresh interval
+ *  if that is shorter, and a failed registration is tried again after
+ *  a delay that doubles up to BVLC_REMOTE_BBMD_RETRY_MAX_SECONDS.
+ * @param bbmd - the BBMD to schedule
+ */
+static void remote_bbmd_schedule(struct remote_bbmd *bbmd)
+{
+    uint32_t seconds;
+
+    if (bbmd->registered) {
+        seconds = bbmd->ttl_seconds / 2;
+        if (Remote_BBMD_Refresh_Seconds &&
+            (Remote_BBMD_Refresh_Seconds < seconds)) {
+            seconds = Remote_BBMD_Refresh_Seconds;
+        }
+        if (seconds == 0) {
+            seconds = 1;
+        }
+        bbmd->retry_ms = 0;
+        bbmd->renew_ms = seconds * 1000UL;
+    } else {
+        if (bbmd->retry_ms == 0) {
+            bbmd->retry_ms = 1000UL;
+        } else {
+            bbmd->retry_ms *= 2;
+        }
+        if (bbmd->retry_ms > BVLC_REMOTE_BBMD_RETRY_MAX_SECONDS * 1000UL) {
+            bbmd->retry_ms = BVLC_REMOTE_BBMD_RETRY_MAX_SECONDS * 1000UL;
+        }
+        bbmd->renew_ms = bbmd->retry_ms;
+    }
+}
+
+/**
+ * @brief Pick the BBMD that our broadcasts are sent through: the first
+ *  BBMD that we are registered with, or else the primary BBMD.
+ */
+static void remote_bbmd_active_update(void)
+{
+    struct remote_bbmd *bbmd = NULL;
+    unsigned i;
+
+    if (Remote_BBMD_Count == 0) {
+        return;
+    }
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        if (Remote_BBMD_List[i].registered) {
+            bbmd = &Remote_BBMD_List[i];
+            break;
+        }
+    }
+    if (!bbmd) {
+        bbmd = &Remote_BBMD_List[0];
+    }
+    if (bvlc_address_different(&Remote_BBMD, &bbmd->address)) {
+        debug_print_bip("Foreign device broadcasts through", &bbmd->address);
+    }
+    bvlc_address_copy(&Remote_BBMD, &bbmd->address);
+    Remote_BBMD_TTL_Seconds = bbmd->ttl_seconds;
+}
+
+/**
+ * @brief Handle a BVLC-Result from one of our BBMDs
+ * @param addr - the address of the BBMD that sent the result
+ * @param result_code - the BVLC result code
+ */
+static void remote_bbmd_result_handler(
+    BACNET_IP_ADDRESS *addr, uint16_t result_code)
+{
+    struct remote_bbmd *bbmd;
+    unsigned i;
+
+    if ((result_code != BVLC_RESULT_SUCCESSFUL_COMPLETION) &&
+        (result_code != BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK)) {
+        return;
+    }
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        bbmd = &Remote_BBMD_List[i];
+        if (bbmd->pending && !bvlc_address_different(&bbmd->address, addr)) {
+            bbmd->pending = false;
+            bbmd->result_code = result_code;
+            bbmd->registered =
+                (result_code == BVLC_RESULT_SUCCESSFUL_COMPLETION);
+            if (bbmd->registered) {
+                bbmd->rtt_ms = bbmd->elapsed_ms;
+            }
+            remote_bbmd_schedule(bbmd);
+            remote_bbmd_active_update();
+            break;
+        }
+    }
+}
+#endif
+
 /**
  * Compares the IP source address to my IP address
  *
@@ -323,6 +461,7 @@ static uint16_t bbmd_forward_npdu(
     if (mtu_len > 0) {
         bip_get_broadcast_addr(&broadcast_address);
         bip_send_mpdu(&broadcast_address, mtu, mtu_len);
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_BBMD_FORWARDED_LOCAL);
         debug_printf("BVLC: Sent Forwarded-NPDU as local broadcast.\n");
     }
 
@@ -387,6 +526,7 @@ static uint16_t bbmd_bdt_forward_npdu(BACNET_IP_ADDRESS *bip_src,
                 }
             }
             bip_send_mpdu(&bip_dest, mtu, mtu_len);
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_BBMD_FORWARDED_BDT);
             debug_print_bip("BDT Send Forwarded-NPDU", &bip_dest);
         }
     }
@@ -452,6 +592,7 @@ static uint16_t bbmd_fdt_forward_npdu(BACNET_IP_ADDRESS *bip_src,
                 }
             }
             bip_send_mpdu(&bip_dest, mtu, mtu_len);
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_BBMD_FORWARDED_FDT);
             debug_print_bip("FDT Send Forwarded-NPDU", &bip_dest);
         }
     }
@@ -689,6 +830,9 @@ int bvlc_bbmd_disabled_handler(BACNET_IP_ADDRESS *addr,
                     BVLC_Result_Code = result_code;
                     debug_print_unsigned(
                         "Received Result Code =", BVLC_Result_Code);
+#if BBMD_CLIENT_ENABLED
+                    remote_bbmd_result_handler(addr, result_code);
+#endif
                 }
                 break;
             case BVLC_WRITE_BROADCAST_DISTRIBUTION_TABLE:
@@ -854,6 +998,9 @@ int bvlc_bbmd_enabled_handler(BACNET_IP_ADDRESS *addr,
                 BVLC_Result_Code = result_code;
                 debug_print_unsigned(
                     "Received Result Code =", BVLC_Result_Code);
+#if BBMD_CLIENT_ENABLED
+                remote_bbmd_result_handler(addr, result_code);
+#endif
             }
             break;
         case BVLC_WRITE_BROADCAST_DISTRIBUTION_TABLE:
@@ -1224,6 +1371,153 @@ uint16_t bvlc_remote_bbmd_lifetime(void)
 {
     return Remote_BBMD_TTL_Seconds;
 }
+
+/**
+ * @brief Add a BBMD to register with as a foreign device, and send the
+ *  registration now.  The first BBMD added is the primary, and the
+ *  others are backups that we stay registered with, so that broadcasts
+ *  go through a backup as soon as the primary stops answering.
+ *  The registrations are renewed by bvlc_remote_bbmd_timer().
+ * @param bbmd_addr - IPv4 address of the BBMD
+ * @param ttl_seconds - Lease time to use when registering
+ * @return Positive number (of bytes sent) on success,
+ *         0 if no registration request is sent, or
+ *         -1 if the list of BBMDs is full or the registration fails.
+ */
+int bvlc_remote_bbmd_add(BACNET_IP_ADDRESS *bbmd_addr, uint16_t ttl_seconds)
+{
+    struct remote_bbmd *bbmd = NULL;
+    unsigned i;
+    int len;
+
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        if (!bvlc_address_different(&Remote_BBMD_List[i].address, bbmd_addr)) {
+            bbmd = &Remote_BBMD_List[i];
+            break;
+        }
+    }
+    if (!bbmd) {
+        if (Remote_BBMD_Count >= BVLC_REMOTE_BBMD_MAX) {
+            return -1;
+        }
+        bbmd = &Remote_BBMD_List[Remote_BBMD_Count];
+        Remote_BBMD_Count++;
+        memset(bbmd, 0, sizeof(*bbmd));
+        bvlc_address_copy(&bbmd->address, bbmd_addr);
+        bbmd->result_code = BVLC_RESULT_INVALID;
+    }
+    bbmd->ttl_seconds = ttl_seconds;
+    remote_bbmd_active_update();
+    len = remote_bbmd_register(bbmd);
+
+    return len;
+}
+
+/**
+ * @brief Remove all of the BBMDs that we register with.  Broadcasts are
+ *  still sent to the last active BBMD, until another one is added.
+ */
+void bvlc_remote_bbmd_clear(void)
+{
+    Remote_BBMD_Count = 0;
+}
+
+/**
+ * @brief Get the number of BBMDs that we register with
+ * @return number of BBMDs
+ */
+unsigned bvlc_remote_bbmd_count(void)
+{
+    return Remote_BBMD_Count;
+}
+
+/**
+ * @brief Get the registration status with one of our BBMDs
+ * @param index - 0 for the primary BBMD, 1.. for the backups
+ * @param status - [out] the registration status
+ * @return true if the BBMD exists
+ */
+bool bvlc_remote_bbmd_status(unsigned index, BVLC_REMOTE_BBMD_STATUS *status)
+{
+    struct remote_bbmd *bbmd;
+
+    if ((index >= Remote_BBMD_Count) || !status) {
+        return false;
+    }
+    bbmd = &Remote_BBMD_List[index];
+    bvlc_address_copy(&status->address, &bbmd->address);
+    status->ttl_seconds = bbmd->ttl_seconds;
+    status->result_code = bbmd->result_code;
+    status->registered = bbmd->registered;
+    status->active = !bvlc_address_different(&Remote_BBMD, &bbmd->address);
+    status->rtt_milliseconds = bbmd->rtt_ms;
+    status->renew_milliseconds = bbmd->renew_ms;
+
+    return true;
+}
+
+/**
+ * @brief Set how often a registration is renewed.  A short interval
+ *  finds a BBMD that restarted and lost its foreign device table
+ *  sooner than the Time-To-Live would.  The default is
+ *  BVLC_REMOTE_BBMD_REFRESH_SECONDS.
+ * @param seconds - seconds between registrations, or 0 to renew at
+ *  half of the Time-To-Live
+ */
+void bvlc_remote_bbmd_refresh_set(uint16_t seconds)
+{
+    Remote_BBMD_Refresh_Seconds = seconds;
+}
+
+/**
+ * @brief Get how often a registration is renewed
+ * @return seconds between registrations, or 0 to renew at half of the
+ *  Time-To-Live
+ */
+uint16_t bvlc_remote_bbmd_refresh(void)
+{
+    return Remote_BBMD_Refresh_Seconds;
+}
+
+/**
+ * @brief Renew the registrations with our BBMDs when they are due, and
+ *  fail over to a backup BBMD when a registration is not answered
+ *  within BVLC_REMOTE_BBMD_TIMEOUT_MS.  The round-trip times are
+ *  measured with the resolution of the calls to this function.
+ * @param milliseconds - number of milliseconds elapsed since the last call
+ */
+void bvlc_remote_bbmd_timer(uint16_t milliseconds)
+{
+    struct remote_bbmd *bbmd;
+    bool changed = false;
+    unsigned i;
+
+    for (i = 0; i < Remote_BBMD_Count; i++) {
+        bbmd = &Remote_BBMD_List[i];
+        if (bbmd->pending) {
+            bbmd->elapsed_ms += milliseconds;
+            if (bbmd->elapsed_ms >= BVLC_REMOTE_BBMD_TIMEOUT_MS) {
+                debug_print_bip("Register-Foreign-Device timeout",
+                    &bbmd->address);
+                bbmd->pending = false;
+                bbmd->result_code = BVLC_RESULT_INVALID;
+                if (bbmd->registered) {
+                    bbmd->registered = false;
+                    changed = true;
+                }
+                remote_bbmd_schedule(bbmd);
+            }
+        } else if (bbmd->renew_ms > milliseconds) {
+            bbmd->renew_ms -= milliseconds;
+        } else {
+            bbmd->renew_ms = 0;
+            (void)remote_bbmd_register(bbmd);
+        }
+    }
+    if (changed) {
+        remote_bbmd_active_update();
+    }
+}
 #endif
 
 #if BBMD_CLIENT_ENABLED
@@ -16,6 +16,43 @@
 /* BACnet Stack API */
 #include "bacnet/datalink/bvlc.h"
 
+/* number of BBMDs that a foreign device registers with at the same time */
+#ifndef BVLC_REMOTE_BBMD_MAX
+#define BVLC_REMOTE_BBMD_MAX 4
+#endif
+/* milliseconds to wait for the result of a foreign device registration */
+#ifndef BVLC_REMOTE_BBMD_TIMEOUT_MS
+#define BVLC_REMOTE_BBMD_TIMEOUT_MS 3000
+#endif
+/* default time between registrations, so that a BBMD that restarted or
+   stopped answering is found in about a minute rather than after half of
+   the Time-To-Live */
+#ifndef BVLC_REMOTE_BBMD_REFRESH_SECONDS
+#define BVLC_REMOTE_BBMD_REFRESH_SECONDS \
+    ((20UL * BVLC_REMOTE_BBMD_TIMEOUT_MS) / 1000UL)
+#endif
+/* longest time between tries to register with a BBMD that failed */
+#ifndef BVLC_REMOTE_BBMD_RETRY_MAX_SECONDS
+#define BVLC_REMOTE_BBMD_RETRY_MAX_SECONDS 60
+#endif
+
+/**
+ * Status of the foreign device registration with one BBMD
+ */
+typedef struct bvlc_remote_bbmd_status {
+    BACNET_IP_ADDRESS address;
+    uint16_t ttl_seconds;
+    /* result of the last registration, or BVLC_RESULT_INVALID */
+    uint16_t result_code;
+    bool registered;
+    /* broadcasts are sent through this BBMD */
+    bool active;
+    /* round-trip time of the last successful registration */
+    uint32_t rtt_milliseconds;
+    /* time until the next registration */
+    uint32_t renew_milliseconds;
+} BVLC_REMOTE_BBMD_STATUS;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -95,6 +132,24 @@ BACNET_STACK_EXPORT
 uint16_t bvlc_remote_bbmd_lifetime(
     void);
 
+/* registers with a primary and backup BBMDs as a foreign device */
+BACNET_STACK_EXPORT
+int bvlc_remote_bbmd_add(
+    BACNET_IP_ADDRESS *address, uint16_t time_to_live_seconds);
+BACNET_STACK_EXPORT
+void bvlc_remote_bbmd_clear(void);
+BACNET_STACK_EXPORT
+unsigned bvlc_remote_bbmd_count(void);
+BACNET_STACK_EXPORT
+bool bvlc_remote_bbmd_status(
+    unsigned index, BVLC_REMOTE_BBMD_STATUS *status);
+BACNET_STACK_EXPORT
+void bvlc_remote_bbmd_refresh_set(uint16_t seconds);
+BACNET_STACK_EXPORT
+uint16_t bvlc_remote_bbmd_refresh(void);
+BACNET_STACK_EXPORT
+void bvlc_remote_bbmd_timer(uint16_t milliseconds);
+
 /* Local interface to manage BBMD.
  * The interface user needs to handle mutual exclusion if needed i.e.
  * BACnet packet is not being handled when the BBMD table is modified.
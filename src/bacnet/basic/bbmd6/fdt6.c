@@ -0,0 +1,471 @@
+/**
+ * @file
+ * @brief Foreign Device Table (FDT) of a BACnet/IPv6 BBMD
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The foreign devices are kept in a dense array for the broadcast
+ * fan-out, and are found by their B/IPv6 address with a hash index.
+ * Each registration is also in one slot of a timer wheel, chosen by the
+ * second in which it expires, so the timer only looks at the slots of
+ * the seconds that have passed instead of every registration.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/bvlc6.h"
+/* me! */
+#include "bacnet/basic/bbmd6/fdt6.h"
+
+/* the data stored for each foreign device */
+struct fdt6_entry {
+    /* first, so that the entry is also the FDT entry */
+    BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY fdt;
+    /* value of FDT6_Time when the registration expires */
+    uint32_t expires;
+    /* position in the dense list */
+    unsigned int list_index;
+    /* timer wheel slot neighbors */
+    struct fdt6_entry *wheel_next;
+    struct fdt6_entry *wheel_prev;
+};
+
+/* dense list of the entries */
+static struct fdt6_entry **FDT6_List;
+static unsigned int FDT6_List_Size;
+static unsigned int FDT6_List_Count;
+/* Hash index of the entries by B/IPv6 address.  Open addressing with
+   linear probing, never more than half full. */
+static struct fdt6_entry **FDT6_Index;
+static unsigned int FDT6_Index_Size;
+static unsigned int FDT6_Index_Count;
+/* timer wheel of the entries by the second they expire */
+static struct fdt6_entry *FDT6_Wheel[FDT6_WHEEL_SLOTS];
+/* seconds counted by FDT6_Timer() */
+static uint32_t FDT6_Time;
+
+/**
+ * @brief Hash of a B/IPv6 address and port (FNV-1a)
+ * @param addr - B/IPv6 address
+ * @return hash of the address
+ */
+static uint32_t FDT6_Hash(BACNET_IP6_ADDRESS *addr)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned int i;
+
+    for (i = 0; i < IP6_ADDRESS_MAX; i++) {
+        hash ^= addr->address[i];
+        hash *= 16777619UL;
+    }
+    hash ^= (uint8_t)(addr->port >> 8);
+    hash *= 16777619UL;
+    hash ^= (uint8_t)(addr->port & 0xFF);
+    hash *= 16777619UL;
+
+    return hash;
+}
+
+/**
+ * @brief Put an entry in the hash index, which has a free slot
+ * @param entry - entry to be indexed
+ */
+static void FDT6_Index_Insert(struct fdt6_entry *entry)
+{
+    unsigned int mask = FDT6_Index_Size - 1;
+    unsigned int slot;
+
+    slot = FDT6_Hash(&entry->fdt.bip6_address) & mask;
+    while (FDT6_Index[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    FDT6_Index[slot] = entry;
+    FDT6_Index_Count++;
+}
+
+/**
+ * @brief Make room in the hash index and the list for one more entry
+ * @return true if there is room
+ */
+static bool FDT6_Grow(void)
+{
+    struct fdt6_entry **old_index = FDT6_Index;
+    unsigned int old_size = FDT6_Index_Size;
+    unsigned int size, i;
+    void *data;
+
+    if (FDT6_List_Count >= FDT6_List_Size) {
+        size = FDT6_List_Size ? (FDT6_List_Size * 2) : 16;
+        data = realloc(FDT6_List, size * sizeof(struct fdt6_entry *));
+        if (!data) {
+            return false;
+        }
+        FDT6_List = data;
+        FDT6_List_Size = size;
+    }
+    if ((FDT6_Index_Count + 1) <= (FDT6_Index_Size / 2)) {
+        return true;
+    }
+    size = FDT6_Index_Size ? (FDT6_Index_Size * 2) : 32;
+    FDT6_Index = calloc(size, sizeof(struct fdt6_entry *));
+    if (!FDT6_Index) {
+        FDT6_Index = old_index;
+        return false;
+    }
+    FDT6_Index_Size = size;
+    FDT6_Index_Count = 0;
+    for (i = 0; i < old_size; i++) {
+        if (old_index[i]) {
+            FDT6_Index_Insert(old_index[i]);
+        }
+    }
+    free(old_index);
+
+    return true;
+}
+
+/**
+ * @brief Take an entry out of the hash index, and move the entries that
+ *  follow it in the same probe sequence back into the free slot
+ * @param entry - entry to be removed
+ */
+static void FDT6_Index_Remove(struct fdt6_entry *entry)
+{
+    unsigned int mask = FDT6_Index_Size - 1;
+    unsigned int slot, next, home;
+
+    if (!FDT6_Index) {
+        return;
+    }
+    slot = FDT6_Hash(&entry->fdt.bip6_address) & mask;
+    while (FDT6_Index[slot] && (FDT6_Index[slot] != entry)) {
+        slot = (slot + 1) & mask;
+    }
+    if (!FDT6_Index[slot]) {
+        return;
+    }
+    FDT6_Index[slot] = NULL;
+    FDT6_Index_Count--;
+    next = (slot + 1) & mask;
+    while (FDT6_Index[next]) {
+        home = FDT6_Hash(&FDT6_Index[next]->fdt.bip6_address) & mask;
+        /* move it back if its home slot is not between the free slot
+           and where it is now, in the order of the probe sequence */
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            FDT6_Index[slot] = FDT6_Index[next];
+            FDT6_Index[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+/**
+ * @brief Find an entry by its B/IPv6 address
+ * @param addr - B/IPv6 address
+ * @return entry, or NULL if not found
+ */
+static struct fdt6_entry *FDT6_Index_Find(BACNET_IP6_ADDRESS *addr)
+{
+    unsigned int mask = FDT6_Index_Size - 1;
+    unsigned int slot;
+    struct fdt6_entry *entry;
+
+    if (!FDT6_Index || !addr) {
+        return NULL;
+    }
+    slot = FDT6_Hash(addr) & mask;
+    while ((entry = FDT6_Index[slot]) != NULL) {
+        if (!bvlc6_address_different(&entry->fdt.bip6_address, addr)) {
+            return entry;
+        }
+        slot = (slot + 1) & mask;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Put an entry in the timer wheel slot of the second it expires
+ * @param entry - entry to be scheduled
+ */
+static void FDT6_Wheel_Insert(struct fdt6_entry *entry)
+{
+    unsigned int slot = entry->expires & (FDT6_WHEEL_SLOTS - 1);
+
+    entry->wheel_prev = NULL;
+    entry->wheel_next = FDT6_Wheel[slot];
+    if (entry->wheel_next) {
+        entry->wheel_next->wheel_prev = entry;
+    }
+    FDT6_Wheel[slot] = entry;
+}
+
+/**
+ * @brief Take an entry out of its timer wheel slot
+ * @param entry - entry to be removed
+ */
+static void FDT6_Wheel_Remove(struct fdt6_entry *entry)
+{
+    unsigned int slot = entry->expires & (FDT6_WHEEL_SLOTS - 1);
+
+    if (entry->wheel_prev) {
+        entry->wheel_prev->wheel_next = entry->wheel_next;
+    } else {
+        FDT6_Wheel[slot] = entry->wheel_next;
+    }
+    if (entry->wheel_next) {
+        entry->wheel_next->wheel_prev = entry->wheel_prev;
+    }
+    entry->wheel_next = NULL;
+    entry->wheel_prev = NULL;
+}
+
+/**
+ * @brief Remove an entry from the table and free it
+ * @param entry - entry to be removed
+ */
+static void FDT6_Remove(struct fdt6_entry *entry)
+{
+    unsigned int index = entry->list_index;
+    unsigned int last = FDT6_List_Count - 1;
+
+    FDT6_Wheel_Remove(entry);
+    FDT6_Index_Remove(entry);
+    if (index != last) {
+        FDT6_List[index] = FDT6_List[last];
+        FDT6_List[index]->list_index = index;
+    }
+    FDT6_List_Count--;
+    free(entry);
+}
+
+/**
+ * @brief Returns the number of foreign devices in the table
+ * @return number of foreign devices
+ */
+unsigned int FDT6_Count(void)
+{
+    return FDT6_List_Count;
+}
+
+/**
+ * @brief Adds a foreign device to the table, or renews its registration.
+ *  The entry is kept for the Time-to-Live plus a grace period of
+ *  30 seconds.
+ * @param addr - B/IPv6 address of the foreign device
+ * @param ttl_seconds - Time-to-Live of the registration
+ * @return true if the foreign device was added or renewed
+ */
+bool FDT6_Add(BACNET_IP6_ADDRESS *addr, uint16_t ttl_seconds)
+{
+    struct fdt6_entry *entry;
+    uint32_t seconds;
+
+    if (!addr) {
+        return false;
+    }
+    seconds = (uint32_t)ttl_seconds + FDT6_TTL_GRACE_SECONDS;
+    if (seconds > UINT16_MAX) {
+        seconds = UINT16_MAX;
+    }
+    entry = FDT6_Index_Find(addr);
+    if (entry) {
+        FDT6_Wheel_Remove(entry);
+    } else {
+        if ((FDT6_List_Count >= MAX_FD6_ENTRIES) || !FDT6_Grow()) {
+            return false;
+        }
+        entry = calloc(1, sizeof(struct fdt6_entry));
+        if (!entry) {
+            return false;
+        }
+        bvlc6_address_copy(&entry->fdt.bip6_address, addr);
+        entry->fdt.valid = true;
+        entry->list_index = FDT6_List_Count;
+        FDT6_List[FDT6_List_Count++] = entry;
+        FDT6_Index_Insert(entry);
+    }
+    entry->fdt.ttl_seconds = ttl_seconds;
+    entry->fdt.ttl_seconds_remaining = (uint16_t)seconds;
+    entry->expires = FDT6_Time + seconds;
+    FDT6_Wheel_Insert(entry);
+
+    return true;
+}
+
+/**
+ * @brief Deletes a foreign device from the table
+ * @param addr - B/IPv6 address of the foreign device
+ * @return true if the foreign device was found and deleted
+ */
+bool FDT6_Delete(BACNET_IP6_ADDRESS *addr)
+{
+    struct fdt6_entry *entry;
+
+    entry = FDT6_Index_Find(addr);
+    if (!entry) {
+        return false;
+    }
+    FDT6_Remove(entry);
+
+    return true;
+}
+
+/**
+ * @brief Updates the seconds remaining of an entry from the timer
+ * @param entry - entry in the table
+ * @return the FDT entry of the entry
+ */
+static BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *FDT6_Entry_Update(
+    struct fdt6_entry *entry)
+{
+    entry->fdt.ttl_seconds_remaining = (uint16_t)(entry->expires - FDT6_Time);
+
+    return &entry->fdt;
+}
+
+/**
+ * @brief Finds a foreign device in the table by its B/IPv6 address
+ * @param addr - B/IPv6 address of the foreign device
+ * @return FDT entry, or NULL if the device is not registered
+ */
+BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *FDT6_Find(BACNET_IP6_ADDRESS *addr)
+{
+    struct fdt6_entry *entry;
+
+    entry = FDT6_Index_Find(addr);
+    if (!entry) {
+        return NULL;
+    }
+
+    return FDT6_Entry_Update(entry);
+}
+
+/**
+ * @brief Gets a foreign device in the table by its position.  The
+ *  positions change when a foreign device is deleted or expires.
+ * @param index - 0..FDT6_Count()-1
+ * @return FDT entry, or NULL if the index is out of range
+ */
+BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *FDT6_Entry(unsigned int index)
+{
+    if (index >= FDT6_List_Count) {
+        return NULL;
+    }
+
+    return FDT6_Entry_Update(FDT6_List[index]);
+}
+
+/**
+ * @brief Removes the foreign devices whose registration has expired.
+ *  Only the timer wheel slots of the seconds that have passed are
+ *  visited.
+ * @param seconds - number of elapsed seconds since the last call
+ * @return number of foreign devices removed
+ */
+unsigned int FDT6_Timer(uint16_t seconds)
+{
+    struct fdt6_entry *entry, *next;
+    unsigned int steps, slot, removed = 0;
+
+    steps = seconds;
+    if (steps > FDT6_WHEEL_SLOTS) {
+        steps = FDT6_WHEEL_SLOTS;
+    }
+    FDT6_Time += seconds;
+    while (steps) {
+        steps--;
+        slot = (FDT6_Time - steps) & (FDT6_WHEEL_SLOTS - 1);
+        entry = FDT6_Wheel[slot];
+        while (entry) {
+            next = entry->wheel_next;
+            /* a later turn of the wheel has not expired yet */
+            if ((int32_t)(FDT6_Time - entry->expires) >= 0) {
+                FDT6_Remove(entry);
+                removed++;
+            }
+            entry = next;
+        }
+    }
+
+    return removed;
+}
+
+/**
+ * @brief Sends an MPDU that is already encoded to every foreign device,
+ *  handing the destinations to the send function in batches
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ * @param exclude - B/IPv6 address not sent to, or NULL
+ * @param send_fn - function that sends to a batch of destinations
+ * @return number of foreign devices sent to
+ */
+unsigned int FDT6_Send(uint8_t *mtu,
+    uint16_t mtu_len,
+    BACNET_IP6_ADDRESS *exclude,
+    fdt6_send_function send_fn)
+{
+    BACNET_IP6_ADDRESS *dest[FDT6_SEND_BATCH];
+    BACNET_IP6_ADDRESS *addr;
+    unsigned int i, count = 0, sent = 0;
+
+    if (!mtu || !send_fn) {
+        return 0;
+    }
+    for (i = 0; i < FDT6_List_Count; i++) {
+        addr = &FDT6_List[i]->fdt.bip6_address;
+        if (exclude && !bvlc6_address_different(addr, exclude)) {
+            continue;
+        }
+        dest[count++] = addr;
+        if (count == FDT6_SEND_BATCH) {
+            send_fn(dest, count, mtu, mtu_len);
+            sent += count;
+            count = 0;
+        }
+    }
+    if (count) {
+        send_fn(dest, count, mtu, mtu_len);
+        sent += count;
+    }
+
+    return sent;
+}
+
+/**
+ * @brief Removes every foreign device and frees the table
+ */
+void FDT6_Cleanup(void)
+{
+    unsigned int i;
+
+    for (i = 0; i < FDT6_List_Count; i++) {
+        free(FDT6_List[i]);
+    }
+    free(FDT6_List);
+    FDT6_List = NULL;
+    FDT6_List_Size = 0;
+    FDT6_List_Count = 0;
+    free(FDT6_Index);
+    FDT6_Index = NULL;
+    FDT6_Index_Size = 0;
+    FDT6_Index_Count = 0;
+    memset(FDT6_Wheel, 0, sizeof(FDT6_Wheel));
+}
+
+/**
+ * @brief Initializes an empty Foreign Device Table
+ */
+void FDT6_Init(void)
+{
+    FDT6_Cleanup();
+    FDT6_Time = 0;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file
+ * @brief API for the Foreign Device Table (FDT) of a BACnet/IPv6 BBMD
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_BBMD6_FDT6_H
+#define BACNET_BASIC_BBMD6_FDT6_H
+
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/bvlc6.h"
+
+/* maximum number of foreign devices that may register */
+#ifndef MAX_FD6_ENTRIES
+#define MAX_FD6_ENTRIES 4096
+#endif
+/* number of one-second slots in the expiry timer wheel - power of 2 */
+#ifndef FDT6_WHEEL_SLOTS
+#define FDT6_WHEEL_SLOTS 64
+#endif
+/* number of destinations handed to the send function at once */
+#ifndef FDT6_SEND_BATCH
+#define FDT6_SEND_BATCH 32
+#endif
+/* seconds of grace added to the Time-to-Live of a registration */
+#define FDT6_TTL_GRACE_SECONDS 30
+
+/**
+ * @brief Sends the same MPDU to a batch of B/IPv6 addresses
+ * @param dest - array of destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
+ */
+typedef void (*fdt6_send_function)(BACNET_IP6_ADDRESS *dest[],
+    unsigned int dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    unsigned int FDT6_Count(void);
+    BACNET_STACK_EXPORT
+    bool FDT6_Add(BACNET_IP6_ADDRESS *addr, uint16_t ttl_seconds);
+    BACNET_STACK_EXPORT
+    bool FDT6_Delete(BACNET_IP6_ADDRESS *addr);
+    BACNET_STACK_EXPORT
+    BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *FDT6_Find(
+        BACNET_IP6_ADDRESS *addr);
+    BACNET_STACK_EXPORT
+    BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *FDT6_Entry(unsigned int index);
+    BACNET_STACK_EXPORT
+    unsigned int FDT6_Timer(uint16_t seconds);
+    BACNET_STACK_EXPORT
+    unsigned int FDT6_Send(uint8_t *mtu,
+        uint16_t mtu_len,
+        BACNET_IP6_ADDRESS *exclude,
+        fdt6_send_function send_fn);
+    BACNET_STACK_EXPORT
+    void FDT6_Cleanup(void);
+    BACNET_STACK_EXPORT
+    void FDT6_Init(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
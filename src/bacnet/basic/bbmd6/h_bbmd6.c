@@ -15,6 +15,7 @@
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/vmac.h"
+#include "bacnet/basic/bbmd6/fdt6.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
 
 static bool BVLC6_Debug;
@@ -61,11 +62,7 @@ static uint16_t BVLC6_Buffer_Len;
 #endif
 static BACNET_IP6_BROADCAST_DISTRIBUTION_TABLE_ENTRY
     BBMD_Table[MAX_BBMD6_ENTRIES];
-/* Foreign Device Table */
-#ifndef MAX_FD6_ENTRIES
-#define MAX_FD6_ENTRIES 128
-#endif
-static BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY FD_Table[MAX_FD6_ENTRIES];
+/* the Foreign Device Table is kept by fdt6.c */
 #endif
 
 /**
@@ -83,25 +80,9 @@ void bvlc6_debug_enable(void)
  */
 void bvlc6_maintenance_timer(uint16_t seconds)
 {
+    VMAC_Timer(seconds);
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-    unsigned i = 0;
-
-    for (i = 0; i < MAX_FD6_ENTRIES; i++) {
-        if (FD_Table[i].valid) {
-            if (FD_Table[i].ttl_seconds_remaining) {
-                if (FD_Table[i].ttl_seconds_remaining < seconds) {
-                    FD_Table[i].ttl_seconds_remaining = 0;
-                } else {
-                    FD_Table[i].ttl_seconds_remaining -= seconds;
-                }
-                if (FD_Table[i].ttl_seconds_remaining == 0) {
-                    FD_Table[i].valid = false;
-                }
-            }
-        }
-    }
-#else
-    (void)seconds;
+    FDT6_Timer(seconds);
 #endif
 }
 
@@ -191,8 +172,10 @@ static void bbmd6_add_vmac(uint32_t device_id, BACNET_IP6_ADDRESS *addr)
         if (!found) {
             vmac = VMAC_Find_By_Key(device_id);
             if (vmac) {
-                /* device ID already exists. Update MAC. */
-                memmove(vmac, &new_vmac, sizeof(struct vmac_data));
+                /* device ID already exists. Update MAC, and the
+                   index of the MAC with it. */
+                VMAC_Delete(device_id);
+                VMAC_Add(device_id, &new_vmac);
                 PRINTF("BVLC6: VMAC for %u [",
                     (unsigned int)device_id);
                 for (i = 0; i < new_vmac.mac_len; i++) {
@@ -348,11 +331,8 @@ int bvlc6_send_pdu(BACNET_ADDRESS *dest,
 /**
  * The send function for Broacast Distribution Table
  *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
+ * @param mtu - the bytes of the encoded Forwarded-NPDU to send
+ * @param mtu_len - the number of bytes of data to send
  */
 static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 {
@@ -361,7 +341,7 @@ static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 
     if (mtu) {
         bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
+        for (i = 0; i < MAX_BBMD6_ENTRIES; i++) {
             if (BBMD_Table[i].valid) {
                 if (bvlc6_address_different(
                         &my_addr, &BBMD_Table[i].bip6_address)) {
@@ -373,68 +353,36 @@ static void bbmd6_send_pdu_bdt(uint8_t *mtu, unsigned int mtu_len)
 }
 
 /**
- * The send function for Broacast Distribution Table
+ * The batch send function for the Foreign Device Table
  *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
+ * @param dest - array of destination addresses
+ * @param dest_count - number of destination addresses
+ * @param mtu - the bytes of data to send
+ * @param mtu_len - the number of bytes of data to send
  */
-static void bbmd6_send_pdu_fdt(uint8_t *mtu, unsigned int mtu_len)
+static void bbmd6_send_pdu_batch(BACNET_IP6_ADDRESS *dest[],
+    unsigned int dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
 {
-    BACNET_IP6_ADDRESS my_addr = { 0 };
-    unsigned i = 0; /* loop counter */
+    unsigned int i;
 
-    if (mtu) {
-        bip6_get_addr(&my_addr);
-        for (i = 0; i < MAX_FD_ENTRIES; i++) {
-            if (FD_Table[i].valid) {
-                if (bvlc6_address_different(
-                        &my_addr, &FD_Table[i].bip6_address)) {
-                    bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
-                }
-            }
-        }
+    for (i = 0; i < dest_count; i++) {
+        bip6_send_mpdu(dest[i], mtu, mtu_len);
     }
 }
 
 /**
- * The Forward NPDU send function for Broacast Distribution Table
+ * The send function for Foreign Device Table
  *
- * @param addr - Points to a #BACNET_IP6_ADDRESS structure containing the
- *  source IPv6 address.
- * @param vmac_src - Source-Virtual-Address
- * @param npdu - the bytes of NPDU+APDU data to send
- * @param npdu_len - the number of bytes of NPDU+APDU data to send
+ * @param mtu - the bytes of the encoded Forwarded-NPDU to send
+ * @param mtu_len - the number of bytes of data to send
+ * @param exclude - B/IPv6 address not sent to, or NULL
  */
-static void bbmd6_send_forward_npdu(BACNET_IP6_ADDRESS *address,
-    uint32_t vmac_src,
-    uint8_t *npdu,
-    unsigned int npdu_len)
+static void bbmd6_send_pdu_fdt(
+    uint8_t *mtu, unsigned int mtu_len, BACNET_IP6_ADDRESS *exclude)
 {
-    uint8_t mtu[BIP6_MPDU_MAX] = { 0 };
-    uint16_t mtu_len = 0;
-    unsigned i = 0; /* loop counter */
-
-    for (i = 0; i < MAX_BBMD_ENTRIES; i++) {
-        if (BBMD_Table[i].valid) {
-            if (bbmd6_address_match_self(&BBMD_Table[i].bip6_address)) {
-                /* don't forward to our selves */
-            } else {
-                bip6_send_mpdu(&BBMD_Table[i].bip6_address, mtu, mtu_len);
-            }
-        }
-    }
-    for (i = 0; i < MAX_FD_ENTRIES; i++) {
-        if (FD_Table[i].valid) {
-            if (bbmd6_address_match_self(&FD_Table[i].bip6_address)) {
-                /* don't forward to our selves */
-            } else {
-                bip6_send_mpdu(&FD_Table[i].bip6_address, mtu, mtu_len);
-            }
-        }
-    }
+    (void)FDT6_Send(mtu, (uint16_t)mtu_len, exclude, bbmd6_send_pdu_batch);
 }
 
 #endif
@@ -811,7 +759,6 @@ int bvlc6_bbmd_disabled_handler(BACNET_IP6_ADDRESS *addr,
 }
 
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
-#warning FIXME: Needs ported to IPv6
 /**
  * Use this handler when you are a BBMD.
  * Sets the BVLC6_Function_Code in case it is needed later.
@@ -829,10 +776,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
     uint16_t mtu_len)
 {
     uint16_t result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
-    uint32_t vmac_me = 0;
     uint32_t vmac_src = 0;
     uint32_t vmac_dst = 0;
-    uint32_t vmac_target = 0;
     uint8_t message_type = 0;
     uint16_t message_length = 0;
     int header_len = 0;
@@ -843,7 +788,9 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
     uint16_t npdu_len = 0;
     bool send_result = false;
     uint16_t offset = 0;
+    uint16_t ttl_seconds = 0;
     BACNET_IP6_ADDRESS fwd_address = { 0 };
+    BACNET_IP6_ADDRESS bvlc_dest = { 0 };
 
     header_len =
         bvlc6_decode_header(mtu, mtu_len, &message_type, &message_length);
@@ -868,15 +815,59 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                 break;
             case BVLC6_REGISTER_FOREIGN_DEVICE:
                 result_code = BVLC6_RESULT_REGISTER_FOREIGN_DEVICE_NAK;
+                function_len = bvlc6_decode_register_foreign_device(
+                    pdu, pdu_len, &vmac_src, &ttl_seconds);
+                if (function_len && !bbmd6_address_match_self(addr) &&
+                    FDT6_Add(addr, ttl_seconds)) {
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                    bbmd6_add_vmac(vmac_src, addr);
+                    PRINTF("BIP6: Registered Foreign Device TTL=%u.\n",
+                        (unsigned)ttl_seconds);
+                }
                 send_result = true;
                 break;
             case BVLC6_DELETE_FOREIGN_DEVICE:
                 result_code = BVLC6_RESULT_DELETE_FOREIGN_DEVICE_NAK;
+                function_len = bvlc6_decode_delete_foreign_device(
+                    pdu, pdu_len, &vmac_src, &fwd_address);
+                if (function_len && FDT6_Delete(&fwd_address)) {
+                    result_code = BVLC6_RESULT_SUCCESSFUL_COMPLETION;
+                }
                 send_result = true;
                 break;
             case BVLC6_DISTRIBUTE_BROADCAST_TO_NETWORK:
-                result_code = BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
-                send_result = true;
+                function_len = bvlc6_decode_distribute_broadcast_to_network(
+                    pdu, pdu_len, &vmac_src, NULL, 0, &npdu_len);
+                if (function_len && FDT6_Find(addr)) {
+                    offset = header_len + (function_len - npdu_len);
+                    npdu = &mtu[offset];
+                    /*  Upon receipt of a BVLL Distribute-Broadcast-To-Network
+                        message from a registered foreign device, the
+                        receiving BBMD shall construct a BVLL Forwarded-NPDU
+                        message and send it via multicast to B/IPv6 devices
+                        in the local multicast domain, unicast it to each
+                        entry in its BDT, and unicast it to each foreign
+                        device in its FDT other than the originating node.
+                        The message is encoded once for all of them. */
+                    BVLC6_Buffer_Len = bvlc6_encode_forwarded_npdu(
+                        &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src, addr,
+                        npdu, npdu_len);
+                    bip6_get_broadcast_addr(&bvlc_dest);
+                    bip6_send_mpdu(
+                        &bvlc_dest, &BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                    bbmd6_send_pdu_bdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                    bbmd6_send_pdu_fdt(
+                        &BVLC6_Buffer[0], BVLC6_Buffer_Len, addr);
+                    bbmd6_add_vmac(vmac_src, addr);
+                    bvlc6_vmac_address_set(src, vmac_src);
+                    if (npdu_confirmed_service(npdu, npdu_len)) {
+                        offset = 0;
+                    }
+                } else {
+                    result_code =
+                        BVLC6_RESULT_DISTRIBUTE_BROADCAST_TO_NETWORK_NAK;
+                    send_result = true;
+                }
                 break;
             case BVLC6_ORIGINAL_UNICAST_NPDU:
                 /* This message is used to send directed NPDUs to
@@ -929,7 +920,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                             &BVLC6_Buffer[0], sizeof(BVLC6_Buffer), vmac_src,
                             addr, npdu, npdu_len);
                         bbmd6_send_pdu_bdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
-                        bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                        bbmd6_send_pdu_fdt(
+                            &BVLC6_Buffer[0], BVLC6_Buffer_Len, NULL);
                     }
                     if (!bbmd6_address_match_self(addr)) {
                         /* The Virtual MAC address table shall be updated
@@ -965,7 +957,8 @@ int bvlc6_bbmd_enabled_handler(BACNET_IP6_ADDRESS *addr,
                         from a BBMD which is in the receiving BBMD's BDT,
                         no BVLC-Result shall be returned and the message
                         shall be discarded. */
-                    bbmd6_send_pdu_fdt(&BVLC6_Buffer[0], BVLC6_Buffer_Len);
+                    bbmd6_send_pdu_fdt(
+                        &BVLC6_Buffer[0], BVLC6_Buffer_Len, NULL);
                     if (!bbmd6_address_match_self(addr)) {
                         /* The Virtual MAC address table shall be updated
                            using the respective parameter values of the
@@ -1106,6 +1099,9 @@ uint8_t bvlc6_get_function_code(void)
 void bvlc6_cleanup(void)
 {
     VMAC_Cleanup();
+#if defined(BACDL_BIP6) && BBMD6_ENABLED
+    FDT6_Cleanup();
+#endif
 }
 
 /**
@@ -1120,6 +1116,6 @@ void bvlc6_init(void)
         &Remote_BBMD, 0, 0, 0, 0, 0, 0, 0, BIP6_MULTICAST_GROUP_ID);
 #if defined(BACDL_BIP6) && BBMD6_ENABLED
     memset(&BBMD_Table, 0, sizeof(BBMD_Table));
-    memset(&FD_Table, 0, sizeof(FD_Table));
+    FDT6_Init();
 #endif
 }
@@ -10,6 +10,7 @@
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "bacnet/bacdef.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
@@ -36,6 +37,125 @@ void VMAC_Debug_Enable(void)
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist VMAC_List;
 
+/* the data stored in the list for each device */
+struct vmac_entry {
+    /* first, so that the entry is also the VMAC data */
+    struct vmac_data vmac;
+    uint32_t device_id;
+    uint16_t ttl_seconds_remaining;
+};
+
+/* Hash index of the entries by VMAC address, for resolving a received
+   address to its device ID without searching the whole list.  Open
+   addressing with linear probing, never more than half full. */
+static struct vmac_entry **VMAC_Index;
+static unsigned int VMAC_Index_Size;
+static unsigned int VMAC_Index_Count;
+/* seconds an entry is kept after its address was last seen, or 0 */
+static uint16_t VMAC_Lifetime_Seconds = VMAC_LIFETIME_SECONDS;
+
+/**
+ * @brief Hash of a VMAC address (FNV-1a)
+ * @param vmac - VMAC address
+ * @return hash of the address
+ */
+static uint32_t VMAC_Hash(struct vmac_data *vmac)
+{
+    uint32_t hash = 2166136261UL;
+    unsigned int i;
+
+    for (i = 0; (i < vmac->mac_len) && (i < VMAC_MAC_MAX); i++) {
+        hash ^= vmac->mac[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Put an entry in the hash index, which has a free slot
+ * @param entry - entry to be indexed
+ */
+static void VMAC_Index_Insert(struct vmac_entry *entry)
+{
+    unsigned int mask = VMAC_Index_Size - 1;
+    unsigned int slot;
+
+    slot = VMAC_Hash(&entry->vmac) & mask;
+    while (VMAC_Index[slot]) {
+        slot = (slot + 1) & mask;
+    }
+    VMAC_Index[slot] = entry;
+    VMAC_Index_Count++;
+}
+
+/**
+ * @brief Make room in the hash index for one more entry
+ * @return true if there is room
+ */
+static bool VMAC_Index_Grow(void)
+{
+    struct vmac_entry **old_index = VMAC_Index;
+    unsigned int old_size = VMAC_Index_Size;
+    unsigned int size, i;
+
+    if ((VMAC_Index_Count + 1) <= (VMAC_Index_Size / 2)) {
+        return true;
+    }
+    size = VMAC_Index_Size ? (VMAC_Index_Size * 2) : 32;
+    VMAC_Index = calloc(size, sizeof(struct vmac_entry *));
+    if (!VMAC_Index) {
+        VMAC_Index = old_index;
+        return false;
+    }
+    VMAC_Index_Size = size;
+    VMAC_Index_Count = 0;
+    for (i = 0; i < old_size; i++) {
+        if (old_index[i]) {
+            VMAC_Index_Insert(old_index[i]);
+        }
+    }
+    free(old_index);
+
+    return true;
+}
+
+/**
+ * @brief Take an entry out of the hash index, and move the entries that
+ *  follow it in the same probe sequence back into the free slot
+ * @param entry - entry to be removed
+ */
+static void VMAC_Index_Remove(struct vmac_entry *entry)
+{
+    unsigned int mask = VMAC_Index_Size - 1;
+    unsigned int slot, next, home;
+
+    if (!VMAC_Index) {
+        return;
+    }
+    slot = VMAC_Hash(&entry->vmac) & mask;
+    while (VMAC_Index[slot] && (VMAC_Index[slot] != entry)) {
+        slot = (slot + 1) & mask;
+    }
+    if (!VMAC_Index[slot]) {
+        return;
+    }
+    VMAC_Index[slot] = NULL;
+    VMAC_Index_Count--;
+    next = (slot + 1) & mask;
+    while (VMAC_Index[next]) {
+        home = VMAC_Hash(&VMAC_Index[next]->vmac) & mask;
+        /* move it back if its home slot is not between the free slot
+           and where it is now, in the order of the probe sequence */
+        if (((next - home) & mask) >= ((next - slot) & mask)) {
+            VMAC_Index[slot] = VMAC_Index[next];
+            VMAC_Index[next] = NULL;
+            slot = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
 /**
  * Returns the number of VMAC in the list
  */
@@ -55,14 +175,16 @@ unsigned int VMAC_Count(void)
 bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 {
     bool status = false;
+    struct vmac_entry *entry = NULL;
     struct vmac_data *pVMAC = NULL;
     int index = 0;
     size_t i = 0;
 
-    pVMAC = Keylist_Data(VMAC_List, device_id);
-    if (!pVMAC) {
-        pVMAC = calloc(1, sizeof(struct vmac_data));
-        if (pVMAC) {
+    entry = Keylist_Data(VMAC_List, device_id);
+    if (!entry && VMAC_Index_Grow()) {
+        entry = calloc(1, sizeof(struct vmac_entry));
+        if (entry) {
+            pVMAC = &entry->vmac;
             /* copy the MAC into the data store */
             for (i = 0; i < sizeof(pVMAC->mac); i++) {
                 if (i < src->mac_len) {
@@ -72,13 +194,18 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
                 }
             }
             pVMAC->mac_len = src->mac_len;
-            index = Keylist_Data_Add(VMAC_List, device_id, pVMAC);
+            entry->device_id = device_id;
+            entry->ttl_seconds_remaining = VMAC_Lifetime_Seconds;
+            index = Keylist_Data_Add(VMAC_List, device_id, entry);
             if (index >= 0) {
+                VMAC_Index_Insert(entry);
                 status = true;
                 if (VMAC_Debug) {
                     debug_fprintf(
                         stderr, "VMAC %u added.\n", (unsigned int)device_id);
                 }
+            } else {
+                free(entry);
             }
         }
     }
@@ -96,11 +223,12 @@ bool VMAC_Add(uint32_t device_id, struct vmac_data *src)
 bool VMAC_Delete(uint32_t device_id)
 {
     bool status = false;
-    struct vmac_data *pVMAC;
+    struct vmac_entry *entry;
 
-    pVMAC = Keylist_Data_Delete(VMAC_List, device_id);
-    if (pVMAC) {
-        free(pVMAC);
+    entry = Keylist_Data_Delete(VMAC_List, device_id);
+    if (entry) {
+        VMAC_Index_Remove(entry);
+        free(entry);
         status = true;
     }
 
@@ -116,7 +244,14 @@ bool VMAC_Delete(uint32_t device_id)
  */
 struct vmac_data *VMAC_Find_By_Key(uint32_t device_id)
 {
-    return Keylist_Data(VMAC_List, device_id);
+    struct vmac_entry *entry;
+
+    entry = Keylist_Data(VMAC_List, device_id);
+    if (entry) {
+        return &entry->vmac;
+    }
+
+    return NULL;
 }
 
 /** Compare the VMAC address
@@ -183,7 +318,8 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
 }
 
 /**
- * Finds a VMAC in the list by seeking a matching VMAC address
+ * Finds a VMAC in the list by seeking a matching VMAC address.
+ * The address has been seen, so the lifetime of the entry restarts.
  *
  * @param vmac - VMAC address that will be sought
  * @param device_id - BACnet device object instance number
@@ -192,25 +328,70 @@ bool VMAC_Match(struct vmac_data *vmac1, struct vmac_data *vmac2)
  */
 bool VMAC_Find_By_Data(struct vmac_data *vmac, uint32_t *device_id)
 {
-    bool status = false;
-    struct vmac_data *list_vmac;
-    int count = 0;
-    int index = 0;
+    struct vmac_entry *entry;
+    unsigned int mask = VMAC_Index_Size - 1;
+    unsigned int slot;
 
-    count = Keylist_Count(VMAC_List);
-    while (count) {
-        index = count - 1;
-        list_vmac = Keylist_Data_Index(VMAC_List, index);
-        if (list_vmac) {
-            if (VMAC_Match(vmac, list_vmac)) {
-                status = Keylist_Index_Key(VMAC_List, index, device_id);
-                break;
+    if (!vmac || !VMAC_Index) {
+        return false;
+    }
+    slot = VMAC_Hash(vmac) & mask;
+    while ((entry = VMAC_Index[slot]) != NULL) {
+        if (VMAC_Match(vmac, &entry->vmac)) {
+            entry->ttl_seconds_remaining = VMAC_Lifetime_Seconds;
+            if (device_id) {
+                *device_id = entry->device_id;
             }
+            return true;
         }
-        count--;
+        slot = (slot + 1) & mask;
     }
 
-    return status;
+    return false;
+}
+
+/**
+ * Sets the number of seconds that an entry is kept after its address
+ * was last found with VMAC_Find_By_Data().  Entries added before this
+ * is set keep their lifetime until their address is seen again.
+ *
+ * @param seconds - lifetime of an entry, or 0 to keep entries forever
+ */
+void VMAC_Lifetime_Set(uint16_t seconds)
+{
+    VMAC_Lifetime_Seconds = seconds;
+}
+
+/**
+ * Deletes the entries whose address has not been seen for their lifetime.
+ * Called about once a second.
+ *
+ * @param seconds - number of elapsed seconds since the last call
+ */
+void VMAC_Timer(uint16_t seconds)
+{
+    struct vmac_entry *entry;
+    int index;
+
+    index = Keylist_Count(VMAC_List);
+    while (index > 0) {
+        index--;
+        entry = Keylist_Data_Index(VMAC_List, index);
+        if (!entry || (entry->ttl_seconds_remaining == 0)) {
+            continue;
+        }
+        if (entry->ttl_seconds_remaining > seconds) {
+            entry->ttl_seconds_remaining -= seconds;
+        } else {
+            if (VMAC_Debug) {
+                debug_fprintf(stderr, "VMAC %u expired.\n",
+                    (unsigned int)entry->device_id);
+            }
+            (void)Keylist_Data_Delete_By_Index(VMAC_List, index);
+            VMAC_Index_Remove(entry);
+            free(entry);
+        }
+    }
 }
 
 /**
@@ -245,6 +426,10 @@ void VMAC_Cleanup(void)
         Keylist_Delete(VMAC_List);
         VMAC_List = NULL;
     }
+    free(VMAC_Index);
+    VMAC_Index = NULL;
+    VMAC_Index_Size = 0;
+    VMAC_Index_Count = 0;
 }
 
 /**
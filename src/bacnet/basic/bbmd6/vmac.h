@@ -15,6 +15,10 @@
 
 /* define the max MAC as big as IPv6 + port number */
 #define VMAC_MAC_MAX 18
+/* seconds an entry is kept after its address was last seen, 0=forever */
+#ifndef VMAC_LIFETIME_SECONDS
+#define VMAC_LIFETIME_SECONDS 0
+#endif
 /**
 * VMAC data structure
 *
@@ -41,6 +45,10 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool VMAC_Delete(uint32_t device_id);
     BACNET_STACK_EXPORT
+    void VMAC_Lifetime_Set(uint16_t seconds);
+    BACNET_STACK_EXPORT
+    void VMAC_Timer(uint16_t seconds);
+    BACNET_STACK_EXPORT
     bool VMAC_Different(
         struct vmac_data *vmac1,
         struct vmac_data *vmac2);
@@ -17,6 +17,7 @@
 #include "bacnet/bacdcode.h"
 #include "bacnet/readrange.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /* we are likely compiling the demo command line tools if print enabled */
 #if !defined(BACNET_ADDRESS_CACHE_FILE)
@@ -41,12 +42,22 @@ static uint32_t Own_Device_ID = 0xFFFFFFFF;
 #define MAX_ADDRESS_CACHE 255
 #endif
 
+/* seconds that a Who-Is for a single device is held off after the
+   previous one, or after an I-Am from the device. 0 disables the holdoff. */
+#if !defined(ADDRESS_WHO_IS_HOLDOFF)
+#define ADDRESS_WHO_IS_HOLDOFF 0
+#endif
+static uint16_t Who_Is_Holdoff = ADDRESS_WHO_IS_HOLDOFF;
+
 static struct Address_Cache_Entry {
     uint8_t Flags;
     uint32_t device_id;
     unsigned max_apdu;
     BACNET_ADDRESS address;
     uint32_t TimeToLive;
+    /* seconds since the binding was updated, or since the Who-Is
+       for an outstanding bind request */
+    uint32_t Age;
 } Address_Cache[MAX_ADDRESS_CACHE];
 
 /* State flags for cache entries */
@@ -59,6 +70,8 @@ static struct Address_Cache_Entry {
 #define BAC_ADDR_STATIC BIT(2)
 /* Opportunistically added address with short TTL */
 #define BAC_ADDR_SHORT_TTL BIT(3)
+/* Who-Is sent for an outstanding bind request */
+#define BAC_ADDR_WHO_IS BIT(4)
 /* Freed up but held for caller to fill */
 #define BAC_ADDR_RESERVED BIT(7)
 
@@ -370,6 +383,11 @@ bool address_get_by_device(
             break;
         }
     }
+    if (found) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_ADDRESS_CACHE_HITS);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_ADDRESS_CACHE_MISSES);
+    }
 
     return found;
 }
@@ -451,8 +469,9 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
                 /* Renewing existing entry */
                 pMatch->TimeToLive = BAC_ADDR_LONG_TIME;
             }
+            pMatch->Age = 0;
             /* Clear bind request flag just in case */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+            pMatch->Flags &= ~(BAC_ADDR_BIND_REQ | BAC_ADDR_WHO_IS);
             found = true;
             break;
         }
@@ -468,6 +487,7 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
                 bacnet_address_copy(&pMatch->address, src);
                 /* Opportunistic entry so leave on short fuse */
                 pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+                pMatch->Age = 0;
                 found = true;
                 break;
             }
@@ -484,6 +504,7 @@ void address_add(uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
             bacnet_address_copy(&pMatch->address, src);
             /* Opportunistic entry so leave on short fuse */
             pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+            pMatch->Age = 0;
         }
     }
     return;
@@ -551,6 +572,7 @@ bool address_device_bind_request(uint32_t device_id,
             pMatch->device_id = device_id;
             /* No point in leaving bind requests in for long haul */
             pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+            pMatch->Age = 0;
             /* now would be a good time to do a Who-Is request */
             return (false);
         }
@@ -564,6 +586,7 @@ bool address_device_bind_request(uint32_t device_id,
         pMatch->device_id = device_id;
         /* No point in leaving bind requests in for long haul */
         pMatch->TimeToLive = BAC_ADDR_SHORT_TIME;
+        pMatch->Age = 0;
     }
     return (false);
 }
@@ -606,8 +629,9 @@ void address_add_binding(
             (pMatch->device_id == device_id)) {
             bacnet_address_copy(&pMatch->address, src);
             pMatch->max_apdu = max_apdu;
+            pMatch->Age = 0;
             /* Clear bind request flag in case it was set */
-            pMatch->Flags &= ~BAC_ADDR_BIND_REQ;
+            pMatch->Flags &= ~(BAC_ADDR_BIND_REQ | BAC_ADDR_WHO_IS);
             /* Only update TTL if not static */
             if ((pMatch->Flags & BAC_ADDR_STATIC) == 0) {
                 /* and set it on a long fuse */
@@ -984,6 +1008,13 @@ void address_cache_timer(uint16_t uSeconds)
 
     for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
         pMatch = &Address_Cache[index];
+        if ((pMatch->Flags & BAC_ADDR_IN_USE) != 0) {
+            if (pMatch->Age < (UINT32_MAX - uSeconds)) {
+                pMatch->Age += uSeconds;
+            } else {
+                pMatch->Age = UINT32_MAX;
+            }
+        }
         if (((pMatch->Flags & (BAC_ADDR_IN_USE | BAC_ADDR_RESERVED)) != 0) &&
             ((pMatch->Flags & BAC_ADDR_STATIC) ==
                 0)) { /* Check all entries holding a slot except statics
@@ -996,3 +1027,85 @@ void address_cache_timer(uint16_t uSeconds)
         }
     }
 }
+
+/**
+ * Get the number of seconds since the binding of a device was updated
+ * by an I-Am, or was added.
+ *
+ * @param device_id  Device-ID
+ * @param age_seconds  Pointer to the variable taking the seconds, or NULL
+ *
+ * @return true if the device is bound
+ */
+bool address_device_age(uint32_t device_id, uint32_t *age_seconds)
+{
+    struct Address_Cache_Entry *pMatch;
+    unsigned index;
+
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        pMatch = &Address_Cache[index];
+        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
+            (pMatch->device_id == device_id)) {
+            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) != 0) {
+                return false;
+            }
+            if (age_seconds) {
+                *age_seconds = pMatch->Age;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * Set the number of seconds that a Who-Is for a single device is held off.
+ * The holdoff depends on address_cache_timer() to age the entries.
+ *
+ * @param seconds  Holdoff in seconds, or 0 to never hold off a Who-Is
+ */
+void address_who_is_holdoff_set(uint16_t seconds)
+{
+    Who_Is_Holdoff = seconds;
+}
+
+/**
+ * Check if a Who-Is for a single device should be sent now, so that
+ * repeated bind attempts do not flood the network with the same Who-Is.
+ * A Who-Is is held off while the binding of the device is fresher than
+ * the holdoff, or while the Who-Is for an outstanding bind request was
+ * sent within the holdoff.  Otherwise the Who-Is is recorded as sent.
+ *
+ * @param device_id  Device-ID
+ *
+ * @return true if the Who-Is should be sent
+ */
+bool address_who_is_request(uint32_t device_id)
+{
+    struct Address_Cache_Entry *pMatch;
+    unsigned index;
+
+    if (Who_Is_Holdoff == 0) {
+        return true;
+    }
+    for (index = 0; index < MAX_ADDRESS_CACHE; index++) {
+        pMatch = &Address_Cache[index];
+        if (((pMatch->Flags & BAC_ADDR_IN_USE) != 0) &&
+            (pMatch->device_id == device_id)) {
+            if ((pMatch->Flags & BAC_ADDR_BIND_REQ) == 0) {
+                /* already bound - only ask again when it is stale */
+                return (pMatch->Age >= Who_Is_Holdoff);
+            }
+            if (((pMatch->Flags & BAC_ADDR_WHO_IS) != 0) &&
+                (pMatch->Age < Who_Is_Holdoff)) {
+                return false;
+            }
+            pMatch->Flags |= BAC_ADDR_WHO_IS;
+            pMatch->Age = 0;
+            return true;
+        }
+    }
+
+    return true;
+}
@@ -113,6 +113,19 @@ extern "C" {
     void address_cache_timer(
         uint16_t uSeconds);
 
+    BACNET_STACK_EXPORT
+    bool address_device_age(
+        uint32_t device_id,
+        uint32_t * age_seconds);
+
+    BACNET_STACK_EXPORT
+    void address_who_is_holdoff_set(
+        uint16_t seconds);
+
+    BACNET_STACK_EXPORT
+    bool address_who_is_request(
+        uint32_t device_id);
+
     BACNET_STACK_EXPORT
     void address_protected_entry_index_set(uint32_t top_protected_entry_index);
     BACNET_STACK_EXPORT
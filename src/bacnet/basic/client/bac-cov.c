@@ -0,0 +1,820 @@
+/**
+ * @file
+ * @brief Manage COV subscriptions to properties of other BACnet devices
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * Each point is a (device, object, property) whose value is wanted.  The
+ * point is subscribed with SubscribeCOV when it is the Present_Value
+ * without a COV increment, or else with SubscribeCOVProperty, and the
+ * subscription is renewed at a random time between one half and three
+ * quarters of its lifetime, so that the renewals of many points do not
+ * bunch up.  The subscriber process identifier of a point is its index,
+ * which finds the point of a notification without a search.  The
+ * points are also hashed by (device, object, property), so that the
+ * ReadProperty values and the API calls find their point quickly.
+ *
+ * A device that does not answer is silent.  Its points are tried again
+ * with an exponential backoff.  A point whose device refuses the
+ * subscription with an Error, Reject, or Abort is polled with
+ * ReadProperty instead, and the poll interval doubles while the value
+ * does not change and halves when it does.  A refused point is offered
+ * a subscription again after a while, in case the device has changed.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/apdu.h"
+#include "bacnet/bacapp.h"
+#include "bacnet/cov.h"
+#include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
+/* us */
+#include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-cov.h"
+
+/* subscriber process identifier of the first point */
+#ifndef BACNET_COV_PROCESS_ID_BASE
+#define BACNET_COV_PROCESS_ID_BASE 0x00C00000UL
+#endif
+/* number of subscription requests waiting for an answer */
+#ifndef BACNET_COV_PENDING_MAX
+#define BACNET_COV_PENDING_MAX 4
+#endif
+/* number of points visited per task cycle */
+#ifndef BACNET_COV_TASK_BATCH
+#define BACNET_COV_TASK_BATCH 32
+#endif
+/* shortest and longest backoff after a silent device, in seconds */
+#ifndef BACNET_COV_RETRY_MIN_SECONDS
+#define BACNET_COV_RETRY_MIN_SECONDS 10
+#endif
+#ifndef BACNET_COV_RETRY_MAX_SECONDS
+#define BACNET_COV_RETRY_MAX_SECONDS 900
+#endif
+/* number of hash buckets of the points - a power of two */
+#ifndef BACNET_COV_POINT_HASH_SIZE
+#define BACNET_COV_POINT_HASH_SIZE 256
+#endif
+/* end of a list of points */
+#define BACNET_COV_POINT_NONE BACNET_COV_POINT_MAX
+
+typedef enum {
+    BACNET_COV_POINT_SUBSCRIBE,
+    BACNET_COV_POINT_WAITING,
+    BACNET_COV_POINT_SUBSCRIBED,
+    BACNET_COV_POINT_POLLING
+} BACNET_COV_POINT_STATE;
+
+typedef enum {
+    BACNET_COV_RESULT_NONE,
+    BACNET_COV_RESULT_ACK,
+    BACNET_COV_RESULT_ERROR
+} BACNET_COV_RESULT;
+
+typedef struct bacnet_cov_point {
+    bool valid : 1;
+    /* SubscribeCOV instead of SubscribeCOVProperty */
+    bool object_cov : 1;
+    bool cov_increment_present : 1;
+    bool poll_pending : 1;
+    bool value_present : 1;
+    uint8_t state;
+    /* timeouts in a row */
+    uint8_t failures;
+    uint32_t device_id;
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    float cov_increment;
+    /* seconds clock of the next renewal, retry, or poll */
+    uint32_t due;
+    /* seconds clock of the next subscription of a polled point */
+    uint32_t retry;
+    uint32_t poll_seconds;
+    /* hash of the last polled value */
+    uint32_t value_hash;
+    /* next point in the same hash bucket, or in the free list */
+    unsigned next;
+} BACNET_COV_POINT;
+static BACNET_COV_POINT COV_Point[BACNET_COV_POINT_MAX];
+static unsigned COV_Point_Hash[BACNET_COV_POINT_HASH_SIZE];
+static unsigned COV_Point_Free;
+
+/* a subscription request waiting for an answer */
+typedef struct bacnet_cov_pending {
+    uint8_t invoke_id;
+    uint8_t result;
+    /* index of the point, or BACNET_COV_POINT_MAX for a cancellation */
+    unsigned point_index;
+    BACNET_ADDRESS dest;
+} BACNET_COV_PENDING;
+static BACNET_COV_PENDING COV_Pending[BACNET_COV_PENDING_MAX];
+
+static uint32_t COV_Seconds;
+static uint32_t COV_Lifetime = BACNET_COV_LIFETIME_SECONDS;
+static bacnet_read_write_value_callback_t COV_Value_Callback;
+static BACNET_COV_NOTIFICATION COV_Confirmed_Notification;
+static BACNET_COV_NOTIFICATION COV_Unconfirmed_Notification;
+
+/**
+ * @brief Determine if the seconds clock has reached a time
+ * @param due - seconds clock of the time
+ * @return true if the time has come
+ */
+static bool bacnet_cov_due(uint32_t due)
+{
+    return (int32_t)(COV_Seconds - due) >= 0;
+}
+
+/**
+ * @brief Get the hash bucket of a point
+ * @return index of the hash bucket
+ */
+static unsigned bacnet_cov_point_hash(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    uint32_t hash;
+
+    hash = device_id * 2654435761UL;
+    hash ^= object_instance + ((uint32_t)object_type << 22);
+    hash *= 2654435761UL;
+    hash ^= (uint32_t)object_property;
+    hash *= 2654435761UL;
+
+    return (unsigned)(hash >> 16) & (BACNET_COV_POINT_HASH_SIZE - 1);
+}
+
+/**
+ * @brief Find the index of a point
+ * @return index of the point, or BACNET_STATUS_ERROR if not found
+ */
+static int bacnet_cov_point_find(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    BACNET_COV_POINT *point;
+    unsigned i;
+
+    i = COV_Point_Hash[bacnet_cov_point_hash(
+        device_id, object_type, object_instance, object_property)];
+    while (i < BACNET_COV_POINT_MAX) {
+        point = &COV_Point[i];
+        if ((point->device_id == device_id) &&
+            (point->object_type == object_type) &&
+            (point->object_instance == object_instance) &&
+            (point->object_property == object_property)) {
+            return (int)i;
+        }
+        i = point->next;
+    }
+
+    return BACNET_STATUS_ERROR;
+}
+
+/**
+ * @brief Send a SubscribeCOV or SubscribeCOVProperty request for a point
+ * @param index - index of the point
+ * @param cancel - true to cancel the subscription
+ * @return invoke ID of the request, or 0 if it was not sent
+ */
+static uint8_t bacnet_cov_subscribe_send(unsigned index, bool cancel)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    BACNET_COV_POINT *point = &COV_Point[index];
+
+    cov_data.subscriberProcessIdentifier = BACNET_COV_PROCESS_ID_BASE + index;
+    cov_data.monitoredObjectIdentifier.type = point->object_type;
+    cov_data.monitoredObjectIdentifier.instance = point->object_instance;
+    cov_data.cancellationRequest = cancel;
+    cov_data.issueConfirmedNotifications = false;
+    cov_data.lifetime = COV_Lifetime;
+    cov_data.covSubscribeToProperty = !point->object_cov;
+    cov_data.monitoredProperty.propertyIdentifier = point->object_property;
+    cov_data.monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    cov_data.covIncrementPresent = point->cov_increment_present;
+    cov_data.covIncrement = point->cov_increment;
+
+    return Send_COV_Subscribe(point->device_id, &cov_data);
+}
+
+/**
+ * @brief Get a free slot for a request waiting for an answer
+ * @return slot, or NULL if there is none
+ */
+static BACNET_COV_PENDING *bacnet_cov_pending_free(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_PENDING_MAX; i++) {
+        if (COV_Pending[i].invoke_id == 0) {
+            return &COV_Pending[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Hold off the subscriptions to a silent device, so that its
+ *  points do not each spend a timeout on it
+ * @param device_id - device instance
+ * @param due - seconds clock of the next try
+ */
+static void bacnet_cov_device_defer(uint32_t device_id, uint32_t due)
+{
+    BACNET_COV_POINT *point;
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        point = &COV_Point[i];
+        if (point->valid && (point->device_id == device_id) &&
+            (point->state == BACNET_COV_POINT_SUBSCRIBE) &&
+            ((int32_t)(due - point->due) > 0)) {
+            point->due = due;
+        }
+    }
+}
+
+/**
+ * @brief Handle a point whose device did not answer
+ * @param index - index of the point
+ */
+static void bacnet_cov_point_timeout(unsigned index)
+{
+    BACNET_COV_POINT *point = &COV_Point[index];
+    uint32_t backoff = BACNET_COV_RETRY_MIN_SECONDS;
+    unsigned i;
+
+    if (point->failures < UINT8_MAX) {
+        point->failures++;
+    }
+    for (i = 1; (i < point->failures) &&
+         (backoff < BACNET_COV_RETRY_MAX_SECONDS);
+         i++) {
+        backoff *= 2;
+    }
+    if (backoff > BACNET_COV_RETRY_MAX_SECONDS) {
+        backoff = BACNET_COV_RETRY_MAX_SECONDS;
+    }
+    point->state = BACNET_COV_POINT_SUBSCRIBE;
+    point->due = COV_Seconds + backoff;
+    bacnet_cov_device_defer(point->device_id, point->due);
+}
+
+/**
+ * @brief Handle a point whose subscription was accepted, and schedule
+ *  its renewal at a random time in the second half of its lifetime
+ * @param index - index of the point
+ */
+static void bacnet_cov_point_accepted(unsigned index)
+{
+    BACNET_COV_POINT *point = &COV_Point[index];
+
+    point->state = BACNET_COV_POINT_SUBSCRIBED;
+    point->failures = 0;
+    point->due = COV_Seconds + (COV_Lifetime / 2) +
+        ((uint32_t)rand() % ((COV_Lifetime / 4) + 1));
+}
+
+/**
+ * @brief Handle a point whose subscription was refused, and poll it
+ * @param index - index of the point
+ */
+static void bacnet_cov_point_refused(unsigned index)
+{
+    BACNET_COV_POINT *point = &COV_Point[index];
+
+    point->state = BACNET_COV_POINT_POLLING;
+    point->failures = 0;
+    point->poll_pending = false;
+    point->poll_seconds = BACNET_COV_POLL_MIN_SECONDS;
+    point->due = COV_Seconds;
+    point->retry = COV_Seconds + BACNET_COV_REFUSED_RETRY_SECONDS;
+}
+
+/**
+ * @brief Handle the answers to the subscription requests
+ */
+static void bacnet_cov_pending_process(void)
+{
+    BACNET_COV_PENDING *pending;
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_PENDING_MAX; i++) {
+        pending = &COV_Pending[i];
+        if (pending->invoke_id == 0) {
+            continue;
+        }
+        if (tsm_invoke_id_free(pending->invoke_id)) {
+            if ((pending->point_index < BACNET_COV_POINT_MAX) &&
+                COV_Point[pending->point_index].valid) {
+                if (pending->result == BACNET_COV_RESULT_ACK) {
+                    bacnet_cov_point_accepted(pending->point_index);
+                } else {
+                    /* an Error, Reject, or Abort */
+                    bacnet_cov_point_refused(pending->point_index);
+                }
+            }
+            pending->invoke_id = 0;
+        } else if (tsm_invoke_id_failed(pending->invoke_id)) {
+            tsm_free_invoke_id(pending->invoke_id);
+            if ((pending->point_index < BACNET_COV_POINT_MAX) &&
+                COV_Point[pending->point_index].valid) {
+                bacnet_cov_point_timeout(pending->point_index);
+            }
+            pending->invoke_id = 0;
+        }
+    }
+}
+
+/**
+ * @brief Send a subscription request for a point
+ * @param index - index of the point
+ * @param cancel - true to cancel the subscription
+ * @return true if the request was sent or the device is being bound,
+ *  false if there are no resources to send it now
+ */
+static bool bacnet_cov_request(unsigned index, bool cancel)
+{
+    BACNET_COV_POINT *point = &COV_Point[index];
+    BACNET_COV_PENDING *pending;
+    BACNET_ADDRESS dest = { 0 };
+    unsigned max_apdu = 0;
+    uint8_t invoke_id;
+
+    pending = bacnet_cov_pending_free();
+    if (!pending || !tsm_transaction_available()) {
+        return false;
+    }
+    if (!address_bind_request(point->device_id, &max_apdu, &dest)) {
+        if (!cancel) {
+            if (address_who_is_request(point->device_id)) {
+                Send_WhoIs(point->device_id, point->device_id);
+            }
+            bacnet_cov_point_timeout(index);
+        }
+        return true;
+    }
+    invoke_id = bacnet_cov_subscribe_send(index, cancel);
+    if (invoke_id == 0) {
+        return false;
+    }
+    pending->invoke_id = invoke_id;
+    pending->result = BACNET_COV_RESULT_NONE;
+    pending->dest = dest;
+    if (cancel) {
+        pending->point_index = BACNET_COV_POINT_MAX;
+    } else {
+        pending->point_index = index;
+        point->state = BACNET_COV_POINT_WAITING;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Handler for a Simple ACK of a subscription request
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID of the request
+ */
+static void bacnet_cov_simple_ack_handler(
+    BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_PENDING_MAX; i++) {
+        if ((COV_Pending[i].invoke_id == invoke_id) &&
+            address_match(&COV_Pending[i].dest, src)) {
+            COV_Pending[i].result = BACNET_COV_RESULT_ACK;
+        }
+    }
+}
+
+/**
+ * @brief Handler for an Error of a subscription request
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID of the request
+ * @param error_class [in] the error class
+ * @param error_code [in] the error code
+ */
+static void bacnet_cov_error_handler(BACNET_ADDRESS *src,
+    uint8_t invoke_id,
+    BACNET_ERROR_CLASS error_class,
+    BACNET_ERROR_CODE error_code)
+{
+    unsigned i;
+
+    (void)error_class;
+    (void)error_code;
+    for (i = 0; i < BACNET_COV_PENDING_MAX; i++) {
+        if ((COV_Pending[i].invoke_id == invoke_id) &&
+            address_match(&COV_Pending[i].dest, src)) {
+            COV_Pending[i].result = BACNET_COV_RESULT_ERROR;
+        }
+    }
+}
+
+/**
+ * @brief Handler for the values of a COV notification
+ * @param cov_data - decoded COV notification
+ */
+static void bacnet_cov_notification(BACNET_COV_DATA *cov_data)
+{
+    BACNET_COV_POINT *point;
+    BACNET_PROPERTY_VALUE *value;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    uint32_t index;
+
+    if (!cov_data ||
+        (cov_data->subscriberProcessIdentifier < BACNET_COV_PROCESS_ID_BASE)) {
+        return;
+    }
+    index = cov_data->subscriberProcessIdentifier - BACNET_COV_PROCESS_ID_BASE;
+    if (index >= BACNET_COV_POINT_MAX) {
+        return;
+    }
+    point = &COV_Point[index];
+    if (!point->valid ||
+        (point->device_id != cov_data->initiatingDeviceIdentifier) ||
+        (point->object_type != cov_data->monitoredObjectIdentifier.type) ||
+        (point->object_instance !=
+            cov_data->monitoredObjectIdentifier.instance)) {
+        return;
+    }
+    point->failures = 0;
+    if (!COV_Value_Callback) {
+        return;
+    }
+    rp_data.object_type = point->object_type;
+    rp_data.object_instance = point->object_instance;
+    rp_data.error_class = ERROR_CLASS_SERVICES;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    for (value = cov_data->listOfValues; value; value = value->next) {
+        rp_data.object_property = value->propertyIdentifier;
+        rp_data.array_index = value->propertyArrayIndex;
+        COV_Value_Callback(point->device_id, &rp_data, &value->value);
+    }
+}
+
+/**
+ * @brief Handler for the ReadProperty values, which adapts the poll
+ *  interval of a polled point, and passes the value on
+ * @param device_instance [in] device instance number where data originated
+ * @param rp_data [in] ReadProperty data
+ * @param value [in] decoded value, or NULL on error
+ */
+static void bacnet_cov_read_value(uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    static uint8_t apdu[MAX_APDU];
+    BACNET_COV_POINT *point;
+    uint32_t hash = 2166136261UL;
+    int index, len, i;
+
+    index = bacnet_cov_point_find(device_instance, rp_data->object_type,
+        rp_data->object_instance, rp_data->object_property);
+    if (index >= 0) {
+        point = &COV_Point[index];
+        if ((point->state == BACNET_COV_POINT_POLLING) &&
+            point->poll_pending) {
+            point->poll_pending = false;
+            len = 0;
+            if (value && (rp_data->error_code == ERROR_CODE_SUCCESS)) {
+                len = bacapp_encode_application_data(apdu, value);
+            }
+            if (len > 0) {
+                /* FNV-1a */
+                for (i = 0; i < len; i++) {
+                    hash ^= apdu[i];
+                    hash *= 16777619UL;
+                }
+                if (point->value_present && (hash == point->value_hash)) {
+                    point->poll_seconds *= 2;
+                    if (point->poll_seconds > BACNET_COV_POLL_MAX_SECONDS) {
+                        point->poll_seconds = BACNET_COV_POLL_MAX_SECONDS;
+                    }
+                } else {
+                    point->poll_seconds /= 2;
+                    if (point->poll_seconds < BACNET_COV_POLL_MIN_SECONDS) {
+                        point->poll_seconds = BACNET_COV_POLL_MIN_SECONDS;
+                    }
+                }
+                point->value_hash = hash;
+                point->value_present = true;
+            } else {
+                point->poll_seconds = BACNET_COV_POLL_MAX_SECONDS;
+            }
+            point->due = COV_Seconds + point->poll_seconds;
+        }
+    }
+    if (COV_Value_Callback) {
+        COV_Value_Callback(device_instance, rp_data, value);
+    }
+}
+
+/**
+ * @brief Handles the subscriptions, renewals, and polls that are due.
+ *  Call it often from the application task loop.
+ */
+void bacnet_cov_task(void)
+{
+    static unsigned cursor = 0;
+    BACNET_COV_POINT *point;
+    unsigned i, index;
+
+    bacnet_cov_pending_process();
+    for (i = 0; i < BACNET_COV_TASK_BATCH; i++) {
+        index = cursor;
+        point = &COV_Point[index];
+        if (point->valid && bacnet_cov_due(point->due)) {
+            if ((point->state == BACNET_COV_POINT_POLLING) &&
+                bacnet_cov_due(point->retry)) {
+                point->state = BACNET_COV_POINT_SUBSCRIBE;
+            }
+            if ((point->state == BACNET_COV_POINT_SUBSCRIBE) ||
+                (point->state == BACNET_COV_POINT_SUBSCRIBED)) {
+                if (!bacnet_cov_request(index, false)) {
+                    /* no resources now - this point is first next time */
+                    return;
+                }
+            } else if (point->state == BACNET_COV_POINT_POLLING) {
+                if (!bacnet_read_property_queue(point->device_id,
+                        point->object_type, point->object_instance,
+                        point->object_property, BACNET_ARRAY_ALL)) {
+                    return;
+                }
+                point->poll_pending = true;
+                point->due = COV_Seconds + point->poll_seconds;
+            }
+        }
+        cursor++;
+        if (cursor >= BACNET_COV_POINT_MAX) {
+            cursor = 0;
+        }
+    }
+}
+
+/**
+ * @brief Advance the seconds clock of the subscriptions
+ * @param seconds - number of seconds elapsed since the last call
+ */
+void bacnet_cov_timer_seconds(uint32_t seconds)
+{
+    COV_Seconds += seconds;
+}
+
+/**
+ * @brief Adds a point to be subscribed, or polled if its device refuses
+ * @param device_id - ID of the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param object_property - property of the object
+ * @param cov_increment - COV increment of a REAL property, or zero to use
+ *  the increment of the device
+ * @return true if added or existing, false if there is no room
+ */
+bool bacnet_cov_point_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    float cov_increment)
+{
+    BACNET_COV_POINT *point;
+    unsigned index, bucket;
+
+    if ((device_id >= BACNET_MAX_INSTANCE) ||
+        (object_instance >= BACNET_MAX_INSTANCE)) {
+        return false;
+    }
+    if (bacnet_cov_point_find(device_id, object_type, object_instance,
+            object_property) >= 0) {
+        return true;
+    }
+    index = COV_Point_Free;
+    if (index >= BACNET_COV_POINT_MAX) {
+        return false;
+    }
+    point = &COV_Point[index];
+    COV_Point_Free = point->next;
+    bucket = bacnet_cov_point_hash(
+        device_id, object_type, object_instance, object_property);
+    memset(point, 0, sizeof(*point));
+    point->valid = true;
+    point->device_id = device_id;
+    point->object_type = object_type;
+    point->object_instance = object_instance;
+    point->object_property = object_property;
+    point->cov_increment_present = isgreater(cov_increment, 0.0f);
+    point->cov_increment = cov_increment;
+    point->object_cov = (object_property == PROP_PRESENT_VALUE) &&
+        !point->cov_increment_present;
+    point->state = BACNET_COV_POINT_SUBSCRIBE;
+    point->due = COV_Seconds;
+    point->next = COV_Point_Hash[bucket];
+    COV_Point_Hash[bucket] = index;
+
+    return true;
+}
+
+/**
+ * @brief Removes a point, and cancels its subscription
+ * @param device_id - ID of the device
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ * @param object_property - property of the object
+ * @return true if the point was removed
+ */
+bool bacnet_cov_point_remove(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    unsigned *link;
+    unsigned i;
+    int index;
+
+    index = bacnet_cov_point_find(
+        device_id, object_type, object_instance, object_property);
+    if (index < 0) {
+        return false;
+    }
+    if ((COV_Point[index].state == BACNET_COV_POINT_SUBSCRIBED) ||
+        (COV_Point[index].state == BACNET_COV_POINT_WAITING)) {
+        /* best effort - the subscription expires anyway */
+        (void)bacnet_cov_request((unsigned)index, true);
+    }
+    /* the answer of a request in flight must not reach a point
+       that reuses the slot - keep the invoke ID to free it later */
+    for (i = 0; i < BACNET_COV_PENDING_MAX; i++) {
+        if ((COV_Pending[i].invoke_id != 0) &&
+            (COV_Pending[i].point_index == (unsigned)index)) {
+            COV_Pending[i].point_index = BACNET_COV_POINT_MAX;
+        }
+    }
+    link = &COV_Point_Hash[bacnet_cov_point_hash(
+        device_id, object_type, object_instance, object_property)];
+    while (*link != (unsigned)index) {
+        link = &COV_Point[*link].next;
+    }
+    *link = COV_Point[index].next;
+    COV_Point[index].valid = false;
+    COV_Point[index].next = COV_Point_Free;
+    COV_Point_Free = (unsigned)index;
+
+    return true;
+}
+
+/**
+ * @brief Determine if a point is subscribed
+ * @return true if the point has an accepted subscription
+ */
+bool bacnet_cov_point_subscribed(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property)
+{
+    int index;
+
+    index = bacnet_cov_point_find(
+        device_id, object_type, object_instance, object_property);
+    if (index < 0) {
+        return false;
+    }
+
+    return COV_Point[index].state == BACNET_COV_POINT_SUBSCRIBED;
+}
+
+/**
+ * @brief Determine if a device has not answered the last few requests
+ * @param device_id - ID of the device
+ * @return true if the device is silent
+ */
+bool bacnet_cov_device_silent(uint32_t device_id)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        if (COV_Point[i].valid && (COV_Point[i].device_id == device_id) &&
+            (COV_Point[i].failures >= BACNET_COV_SILENT_FAILURES)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Count the points in a state
+ * @param state - state of the points, or -1 for any state
+ * @return number of points
+ */
+static unsigned bacnet_cov_state_count(int state)
+{
+    unsigned i, count = 0;
+
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        if (COV_Point[i].valid &&
+            ((state < 0) || (COV_Point[i].state == state))) {
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Get the number of points
+ * @return number of points
+ */
+unsigned bacnet_cov_point_count(void)
+{
+    return bacnet_cov_state_count(-1);
+}
+
+/**
+ * @brief Get the number of points with an accepted subscription
+ * @return number of points
+ */
+unsigned bacnet_cov_subscribed_count(void)
+{
+    return bacnet_cov_state_count(BACNET_COV_POINT_SUBSCRIBED);
+}
+
+/**
+ * @brief Get the number of points that are polled
+ * @return number of points
+ */
+unsigned bacnet_cov_polled_count(void)
+{
+    return bacnet_cov_state_count(BACNET_COV_POINT_POLLING);
+}
+
+/**
+ * @brief Set the lifetime of the subscriptions
+ * @param seconds - lifetime, at least 60 seconds
+ */
+void bacnet_cov_lifetime_set(uint32_t seconds)
+{
+    if (seconds >= 60) {
+        COV_Lifetime = seconds;
+    }
+}
+
+/**
+ * @brief Sets the callback for the values from COV notifications and
+ *  from polls, and for any other ReadProperty values
+ * @param callback - function for callback
+ */
+void bacnet_cov_value_callback_set(bacnet_read_write_value_callback_t callback)
+{
+    COV_Value_Callback = callback;
+}
+
+/**
+ * @brief Initializes the COV subscription module.  The ReadProperty
+ *  module is used for polling, so its value callback is taken over, and
+ *  all of its values are passed on to bacnet_cov_value_callback_set().
+ * @note Set the value callback with bacnet_cov_value_callback_set()
+ *  after this, not with bacnet_read_write_value_callback_set().
+ */
+void bacnet_cov_init(void)
+{
+    unsigned i;
+
+    memset(COV_Point, 0, sizeof(COV_Point));
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        COV_Point[i].next = i + 1;
+    }
+    COV_Point_Free = 0;
+    for (i = 0; i < BACNET_COV_POINT_HASH_SIZE; i++) {
+        COV_Point_Hash[i] = BACNET_COV_POINT_NONE;
+    }
+    memset(COV_Pending, 0, sizeof(COV_Pending));
+    COV_Seconds = 0;
+    apdu_set_confirmed_simple_ack_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, bacnet_cov_simple_ack_handler);
+    apdu_set_confirmed_simple_ack_handler(SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY,
+        bacnet_cov_simple_ack_handler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV, bacnet_cov_error_handler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY, bacnet_cov_error_handler);
+    COV_Confirmed_Notification.callback = bacnet_cov_notification;
+    handler_ccov_notification_add(&COV_Confirmed_Notification);
+    COV_Unconfirmed_Notification.callback = bacnet_cov_notification;
+    handler_ucov_notification_add(&COV_Unconfirmed_Notification);
+    bacnet_read_write_value_callback_set(bacnet_cov_read_value);
+}
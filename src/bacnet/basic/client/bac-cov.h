@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @brief API to manage COV subscriptions to properties of other devices
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_CLIENT_COV_H
+#define BACNET_BASIC_CLIENT_COV_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/rp.h"
+#include "bacnet/basic/client/bac-rw.h"
+
+/* number of (device, object, property) points that are managed */
+#ifndef BACNET_COV_POINT_MAX
+#define BACNET_COV_POINT_MAX 1024
+#endif
+/* lifetime of the subscriptions, in seconds */
+#ifndef BACNET_COV_LIFETIME_SECONDS
+#define BACNET_COV_LIFETIME_SECONDS 600
+#endif
+/* shortest and longest interval for polling a point without COV */
+#ifndef BACNET_COV_POLL_MIN_SECONDS
+#define BACNET_COV_POLL_MIN_SECONDS 10
+#endif
+#ifndef BACNET_COV_POLL_MAX_SECONDS
+#define BACNET_COV_POLL_MAX_SECONDS 300
+#endif
+/* seconds until a subscription refused by a device is tried again */
+#ifndef BACNET_COV_REFUSED_RETRY_SECONDS
+#define BACNET_COV_REFUSED_RETRY_SECONDS 3600
+#endif
+/* number of timeouts in a row after which a device is silent */
+#ifndef BACNET_COV_SILENT_FAILURES
+#define BACNET_COV_SILENT_FAILURES 3
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/* bacnet_cov_init() installs its own bac-rw value callback, to adapt
+   the polls, and passes every ReadProperty value on to the callback of
+   bacnet_cov_value_callback_set(). Use that instead of
+   bacnet_read_write_value_callback_set() once COV is initialized. */
+BACNET_STACK_EXPORT
+void bacnet_cov_init(void);
+BACNET_STACK_EXPORT
+void bacnet_cov_task(void);
+BACNET_STACK_EXPORT
+void bacnet_cov_timer_seconds(uint32_t seconds);
+BACNET_STACK_EXPORT
+bool bacnet_cov_point_add(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    float cov_increment);
+BACNET_STACK_EXPORT
+bool bacnet_cov_point_remove(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property);
+BACNET_STACK_EXPORT
+bool bacnet_cov_point_subscribed(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property);
+BACNET_STACK_EXPORT
+bool bacnet_cov_device_silent(uint32_t device_id);
+BACNET_STACK_EXPORT
+unsigned bacnet_cov_point_count(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_cov_subscribed_count(void);
+BACNET_STACK_EXPORT
+unsigned bacnet_cov_polled_count(void);
+BACNET_STACK_EXPORT
+void bacnet_cov_lifetime_set(uint32_t seconds);
+BACNET_STACK_EXPORT
+void bacnet_cov_value_callback_set(
+    bacnet_read_write_value_callback_t callback);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
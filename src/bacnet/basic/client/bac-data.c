@@ -14,6 +14,7 @@
 #include "bacnet/basic/sys/mstimer.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-cov.h"
 #include "bacnet/basic/client/bac-data.h"
 
 /* number of objects data stored */
@@ -42,6 +43,8 @@ typedef struct bacnet_object_data {
         } type;
     } Present_Value;
     bool refresh;
+    /* Present_Value is kept up to date by the COV subscription manager */
+    bool cov;
 } BACNET_DATA_OBJECT;
 static BACNET_DATA_OBJECT Object_Table[BACNET_DATA_OBJECT_MAX];
 
@@ -234,6 +237,9 @@ bool bacnet_data_object_add(uint32_t device_id,
                     object->Object_Type = object_type;
                     object->Object_ID = object_instance;
                     object->refresh = true;
+                    object->cov = bacnet_cov_point_add(device_id,
+                        object_type, object_instance, PROP_PRESENT_VALUE,
+                        0.0f);
                     status = true;
                 }
             } else {
@@ -368,7 +374,9 @@ void bacnet_data_task(void)
         mstimer_reset(&Object_Poll_Timer);
         for (i = 0; i < BACNET_DATA_OBJECT_MAX; i++) {
             object = &Object_Table[i];
-            object->refresh = true;
+            if (!object->cov) {
+                object->refresh = true;
+            }
         }
     }
     if (mstimer_expired(&Read_Write_Timer)) {
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/bactext.h"
 #include "bacnet/bacapp.h"
+#include "bacnet/bacdcode.h"
 #include "bacnet/basic/sys/mstimer.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/basic/sys/keylist.h"
@@ -35,10 +36,29 @@ static OS_Keylist Device_List = NULL;
 static uint16_t Target_DNET = 0;
 /* re-discovery time */
 static unsigned long Discovery_Milliseconds;
+/* called when the discovery of a device is finished */
+static bacnet_discover_device_done_callback Device_Done_Callback;
+/* index of the next device to run, so that every device gets a turn */
+static unsigned int Device_Task_Index;
+/* number of times a failed request is sent again before it is skipped */
+#ifndef BACNET_DISCOVER_RETRY_MAX
+#define BACNET_DISCOVER_RETRY_MAX 3
+#endif
+/* properties read one at a time from devices without ReadPropertyMultiple */
+static const BACNET_PROPERTY_ID Discover_Properties[] = {
+    PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_DESCRIPTION, PROP_PRESENT_VALUE,
+    PROP_STATUS_FLAGS, PROP_OUT_OF_SERVICE, PROP_UNITS, PROP_VENDOR_NAME,
+    PROP_MODEL_NAME, PROP_FIRMWARE_REVISION,
+    PROP_APPLICATION_SOFTWARE_VERSION, PROP_PROTOCOL_REVISION
+};
+#define DISCOVER_PROPERTIES_COUNT \
+    (sizeof(Discover_Properties) / sizeof(Discover_Properties[0]))
 /* states of discovery */
 typedef enum bacnet_discover_state_enum {
     BACNET_DISCOVER_STATE_INIT = 0,
     BACNET_DISCOVER_STATE_BINDING,
+    BACNET_DISCOVER_STATE_OBJECT_LIST_ALL_REQUEST,
+    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE,
     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST,
     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE,
     BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST,
@@ -66,9 +86,17 @@ typedef struct bacnet_device_data_t {
     /* used for discovering device data */
     uint32_t Object_List_Size;
     uint32_t Object_List_Index;
+    /* index into Discover_Properties when reading one at a time */
+    uint8_t Property_Index;
+    uint8_t Retry_Count;
+    /* device does not support ReadPropertyMultiple of ALL */
+    bool Read_Property_Only;
+    /* the last discovery did not reach the device */
+    bool Discovery_Failed;
     /* timer and stats */
     struct mstimer Discovery_Timer;
     unsigned long Discovery_Elapsed_Milliseconds;
+    uint16_t Discovery_Done_Count;
     BACNET_DISCOVER_STATE Discovery_State;
 } BACNET_DEVICE_DATA;
 
@@ -386,6 +414,68 @@ unsigned long bacnet_discover_device_elapsed_milliseconds(uint32_t device_id)
     return milliseconds;
 }
 
+/**
+ * @brief Get the number of times the discovery of a device was done
+ *  without a failure
+ * @param device_id - ID of the destination device
+ * @return the number of discoveries done, 0 until the first one is done
+ */
+unsigned bacnet_discover_device_done_count(uint32_t device_id)
+{
+    unsigned count = 0;
+    BACNET_DEVICE_DATA *device;
+    KEY key = device_id;
+
+    device = Keylist_Data(Device_List, key);
+    if (device) {
+        count = device->Discovery_Done_Count;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Determine if the last discovery of a device failed because the
+ *  device did not return its Object_List
+ * @param device_id - ID of the destination device
+ * @return true if the last discovery of the device failed
+ */
+bool bacnet_discover_device_failed(uint32_t device_id)
+{
+    bool status = false;
+    BACNET_DEVICE_DATA *device;
+    KEY key = device_id;
+
+    device = Keylist_Data(Device_List, key);
+    if (device) {
+        status = device->Discovery_Failed;
+    }
+
+    return status;
+}
+
+/**
+ * @brief Determine if every device found has finished its discovery at
+ *  least once, whether it was done or failed
+ * @return true if no device is waiting for its first discovery
+ */
+bool bacnet_discover_devices_done(void)
+{
+    BACNET_DEVICE_DATA *device;
+    int device_count, device_index;
+
+    device_count = Keylist_Count(Device_List);
+    for (device_index = 0; device_index < device_count; device_index++) {
+        device = Keylist_Data_Index(Device_List, device_index);
+        if (device && (device->Discovery_Done_Count == 0) &&
+            !device->Discovery_Failed) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief Get a property value from the device cache
  * @param device_id - ID of the destination device
@@ -545,6 +635,52 @@ bool bacnet_discover_object_property_identifier(uint32_t device_id,
     return status;
 }
 
+/**
+ * @brief Add every object identifier from an entire Object_List value
+ *  without decoding each element into an application data value.
+ * @param device_id [in] Device instance number where data originated
+ * @param apdu [in] application data of the Object_List property
+ * @param apdu_len [in] number of bytes of application data
+ * @param device_data [in] Pointer to the device data structure
+ * @return number of object identifiers found in the list
+ */
+static uint32_t bacnet_device_object_list_add(uint32_t device_id,
+    uint8_t *apdu,
+    int apdu_len,
+    BACNET_DEVICE_DATA *device_data)
+{
+    BACNET_OBJECT_ID object_id[32] = { 0 };
+    uint32_t offset = 0;
+    uint32_t value_count = 0;
+    uint32_t count = 0;
+    uint32_t i;
+    int len = 0;
+
+    if ((apdu_len <= 0) || !device_data) {
+        return 0;
+    }
+    while (offset < (uint32_t)apdu_len) {
+        len = bacnet_object_id_application_array_decode(&apdu[offset],
+            (uint32_t)apdu_len - offset, object_id, ARRAY_SIZE(object_id),
+            &value_count);
+        if ((len <= 0) || (value_count == 0)) {
+            break;
+        }
+        for (i = 0; i < value_count; i++) {
+            if (bacnet_object_data_add(device_data->Object_List,
+                    object_id[i].type, object_id[i].instance)) {
+                count++;
+            }
+        }
+        offset += (uint32_t)len;
+    }
+    debug_printf("%u object-list added %lu objects%s.\n", device_id,
+        (unsigned long)count,
+        (offset < (uint32_t)apdu_len) ? " (malformed)" : "");
+
+    return count;
+}
+
 /**
  * @brief add a ReadProperty reply value from a device object property
  * @param device_id [in] Device instance number where data originated
@@ -568,7 +704,33 @@ static void bacnet_device_object_property_add(uint32_t device_id,
     if ((rp_data->object_type == OBJECT_DEVICE) &&
         (rp_data->object_instance == device_id) &&
         (rp_data->object_property == PROP_OBJECT_LIST)) {
-        if (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT) {
+        if (device_data->Discovery_State ==
+            BACNET_DISCOVER_STATE_OBJECT_LIST_ALL_REQUEST) {
+            /* the whole list was returned in one reply, and is split into
+               elements after this first one - take it all at once */
+            device_data->Object_List_Size =
+                bacnet_device_object_list_add(device_id,
+                    rp_data->application_data, rp_data->application_data_len,
+                    device_data);
+            device_data->Object_List_Index = 0;
+            device_data->Retry_Count = 0;
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+        } else if (rp_data->array_index == BACNET_ARRAY_ALL) {
+            /* the whole list was returned in one reply */
+            device_data->Object_List_Size =
+                bacnet_device_object_list_add(device_id,
+                    rp_data->application_data, rp_data->application_data_len,
+                    device_data);
+            device_data->Object_List_Index = 0;
+            if ((device_data->Discovery_State ==
+                    BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST) ||
+                (device_data->Discovery_State ==
+                    BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST)) {
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+            }
+        } else if (value->tag == BACNET_APPLICATION_TAG_UNSIGNED_INT) {
             device_data->Object_List_Size = value->type.Unsigned_Int;
             device_data->Object_List_Index = 0;
             if (device_data->Discovery_State ==
@@ -587,6 +749,7 @@ static void bacnet_device_object_property_add(uint32_t device_id,
                     object_data ? "success" : "fail");
                 if (device_data->Discovery_State ==
                     BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST) {
+                    device_data->Retry_Count = 0;
                     device_data->Discovery_State =
                         BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
                 }
@@ -596,6 +759,7 @@ static void bacnet_device_object_property_add(uint32_t device_id,
         /* move to next state */
         if (device_data->Discovery_State ==
             BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST) {
+            device_data->Retry_Count = 0;
             device_data->Discovery_State =
                 BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
         }
@@ -659,38 +823,142 @@ static void bacnet_device_object_property_add(uint32_t device_id,
     }
 }
 
+/**
+ * @brief Finish the discovery of a device, and schedule the next one
+ * @param device_id - device instance number
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_device_done(
+    uint32_t device_id, BACNET_DEVICE_DATA *device_data)
+{
+    /* track the duration */
+    device_data->Discovery_Elapsed_Milliseconds =
+        mstimer_elapsed(&device_data->Discovery_Timer);
+    /* rediscover in the future */
+    mstimer_set(&device_data->Discovery_Timer, Discovery_Milliseconds);
+    device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+    if (!device_data->Discovery_Failed &&
+        (device_data->Discovery_Done_Count < UINT16_MAX)) {
+        device_data->Discovery_Done_Count++;
+    }
+    if (Device_Done_Callback) {
+        Device_Done_Callback(device_id);
+    }
+}
+
+/**
+ * @brief Count a failed request, to limit how often it is sent again
+ * @param device_data - Pointer to the device data structure
+ * @return true if the failed request should be sent again
+ */
+static bool bacnet_discover_retry(BACNET_DEVICE_DATA *device_data)
+{
+    if (device_data->Retry_Count < BACNET_DISCOVER_RETRY_MAX) {
+        device_data->Retry_Count++;
+        return true;
+    }
+    device_data->Retry_Count = 0;
+
+    return false;
+}
+
+/**
+ * @brief Step back to the property that was last queued when reading
+ *  one property at a time, so that it is read again
+ * @param device_data - Pointer to the device data structure
+ */
+static void bacnet_discover_property_previous(BACNET_DEVICE_DATA *device_data)
+{
+    if (device_data->Property_Index > 0) {
+        device_data->Property_Index--;
+    } else if (device_data->Object_List_Index != 0) {
+        /* the last property of the previous object */
+        device_data->Property_Index = DISCOVER_PROPERTIES_COUNT - 1;
+        device_data->Object_List_Index--;
+    }
+}
+
+/**
+ * @brief Determine if a request failed because no reply came back, as
+ *  opposed to an Error, Reject, or Abort from the device
+ * @param error_code - BACnet Error code reported by the read-write client
+ * @return true if the request timed out
+ */
+static bool bacnet_discover_timeout(BACNET_ERROR_CODE error_code)
+{
+    return (error_code == ERROR_CODE_TIMEOUT) ||
+        (error_code == ERROR_CODE_ABORT_TSM_TIMEOUT);
+}
+
 /**
  * @brief Handle the error from a ReadProperty or ReadPropertyMultiple
  * @param device_id - device instance number where data originated
  * @param error_code - BACnet Error code
+ * @param device_data - Pointer to the device data structure
  */
 static void Device_Error_Handler(uint32_t device_id,
     BACNET_ERROR_CODE error_code,
     BACNET_DEVICE_DATA *device_data)
 {
-    if (device_data) {
-        debug_printf(
-            "%u - %s\n", device_id, bactext_error_code_name((int)error_code));
-        switch (device_data->Discovery_State) {
-            case BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST:
-                /* resend request */
+    if (!device_data) {
+        return;
+    }
+    debug_printf(
+        "%u - %s\n", device_id, bactext_error_code_name((int)error_code));
+    switch (device_data->Discovery_State) {
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_ALL_REQUEST:
+            /* too big, or not an array - read the list one at a time */
+            device_data->Retry_Count = 0;
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE;
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST:
+            /* unable to reach the device - try again next time */
+            device_data->Retry_Count = 0;
+            device_data->Discovery_Failed = true;
+            bacnet_discover_device_done(device_id, device_data);
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST:
+            /* resend request, or skip the element */
+            if (bacnet_discover_retry(device_data) &&
+                (device_data->Object_List_Index != 0)) {
+                device_data->Object_List_Index--;
+            }
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST:
+            if (!device_data->Read_Property_Only &&
+                ((error_code == ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE) ||
+                    (error_code ==
+                        ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED) ||
+                    (error_code == ERROR_CODE_ABORT_BUFFER_OVERFLOW))) {
+                /* read this object again, one property at a time */
+                device_data->Read_Property_Only = true;
+                device_data->Property_Index = 0;
+                device_data->Retry_Count = 0;
                 if (device_data->Object_List_Index != 0) {
                     device_data->Object_List_Index--;
                 }
-                device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE;
-                break;
-            case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST:
-                /* resend request */
-                if (device_data->Object_List_Index != 0) {
-                    device_data->Object_List_Index--;
+            } else if (device_data->Read_Property_Only) {
+                if (bacnet_discover_timeout(error_code) &&
+                    bacnet_discover_retry(device_data)) {
+                    /* no reply - read the same property again */
+                    bacnet_discover_property_previous(device_data);
+                } else {
+                    /* unknown property, or still no reply - move on */
+                    device_data->Retry_Count = 0;
                 }
-                device_data->Discovery_State =
-                    BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
-                break;
-            default:
-                break;
-        }
+            } else if (bacnet_discover_retry(device_data) &&
+                (device_data->Object_List_Index != 0)) {
+                /* resend request */
+                device_data->Object_List_Index--;
+            }
+            device_data->Discovery_State =
+                BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE;
+            break;
+        default:
+            break;
     }
 }
 
@@ -720,11 +988,20 @@ static void bacnet_read_property_reply(uint32_t device_id,
     } else if (value) {
         bacnet_device_object_property_add(
             device_id, rp_data, value, device_data);
+    } else {
+        /* the reply could not be decoded */
+        Device_Error_Handler(device_id, ERROR_CODE_OTHER, device_data);
     }
 }
 
 /**
  * @brief Non-blocking task for running BACnet discover state machine
+ *
+ * The Object_List is read whole first, and one element at a time if the
+ * device can not return it in one reply.  Each object is then read with a
+ * ReadPropertyMultiple of ALL, or one property at a time from devices that
+ * can not.  Only one request is queued for a device at a time.
+ *
  * @param device_id - Device ID from discovered device
  * @param device_data - Pointer to the device data structure
  */
@@ -734,6 +1011,7 @@ static void bacnet_discover_device_fsm(
     KEY key = 0;
     BACNET_OBJECT_TYPE object_type = 0;
     uint32_t object_instance = 0;
+    BACNET_PROPERTY_ID object_property = PROP_ALL;
     bool status = false;
 
     if (!device_data) {
@@ -741,18 +1019,30 @@ static void bacnet_discover_device_fsm(
     }
     switch (device_data->Discovery_State) {
         case BACNET_DISCOVER_STATE_INIT:
+            device_data->Retry_Count = 0;
+            device_data->Property_Index = 0;
+            device_data->Read_Property_Only = false;
+            status = bacnet_read_property_queue(device_id, OBJECT_DEVICE,
+                device_id, PROP_OBJECT_LIST, BACNET_ARRAY_ALL);
+            if (status) {
+                device_data->Discovery_State =
+                    BACNET_DISCOVER_STATE_OBJECT_LIST_ALL_REQUEST;
+            }
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_ALL_REQUEST:
+            /* waiting for response */
+            break;
+        case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE:
             status = bacnet_read_property_queue(
                 device_id, OBJECT_DEVICE, device_id, PROP_OBJECT_LIST, 0);
             if (status) {
                 device_data->Discovery_State =
                     BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST;
-            } else {
-                debug_perror("%u object-list-size fail to queue!\n", device_id);
             }
             break;
         case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_REQUEST:
             /* waiting for response */
-            return;
+            break;
         case BACNET_DISCOVER_STATE_OBJECT_LIST_SIZE_RESPONSE:
             device_data->Object_List_Index = 0;
             device_data->Discovery_State =
@@ -762,25 +1052,18 @@ static void bacnet_discover_device_fsm(
             /* waiting for response */
             break;
         case BACNET_DISCOVER_STATE_OBJECT_LIST_RESPONSE:
-            device_data->Object_List_Index++;
-            if (device_data->Object_List_Index <=
+            if (device_data->Object_List_Index <
                 device_data->Object_List_Size) {
                 debug_printf("%u object-list[%u] size=%u.\n", device_id,
-                    device_data->Object_List_Index,
+                    device_data->Object_List_Index + 1,
                     device_data->Object_List_Size);
                 status = bacnet_read_property_queue(device_id, OBJECT_DEVICE,
                     device_id, PROP_OBJECT_LIST,
-                    device_data->Object_List_Index);
+                    device_data->Object_List_Index + 1);
                 if (status) {
+                    device_data->Object_List_Index++;
                     device_data->Discovery_State =
                         BACNET_DISCOVER_STATE_OBJECT_LIST_REQUEST;
-                    return;
-                } else {
-                    debug_perror("%u object-list[%u] %s-%u fail to queue!\n",
-                        device_id, device_data->Object_List_Index,
-                        bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
-                    device_data->Object_List_Index--;
                 }
             } else {
                 device_data->Object_List_Index = 0;
@@ -793,36 +1076,44 @@ static void bacnet_discover_device_fsm(
             break;
         case BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_RESPONSE:
             if (device_data->Object_List_Index <
-                device_data->Object_List_Size) {
+                (uint32_t)Keylist_Count(device_data->Object_List)) {
                 if (Keylist_Index_Key(device_data->Object_List,
                         device_data->Object_List_Index, &key)) {
                     object_type = KEY_DECODE_TYPE(key);
                     object_instance = KEY_DECODE_ID(key);
-                    debug_printf("%u object-list[%u] %s-%u read ALL.\n",
+                    if (device_data->Read_Property_Only) {
+                        object_property =
+                            Discover_Properties[device_data->Property_Index];
+                    }
+                    debug_printf("%u object-list[%u] %s-%u read %s.\n",
                         device_id, device_data->Object_List_Index,
                         bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
+                        (unsigned)object_instance,
+                        bactext_property_name(object_property));
                     status = bacnet_read_property_queue(device_id, object_type,
-                        object_instance, PROP_ALL, BACNET_ARRAY_ALL);
+                        object_instance, object_property, BACNET_ARRAY_ALL);
+                } else {
+                    /* skip a missing entry */
+                    device_data->Object_List_Index++;
+                    break;
                 }
                 if (status) {
                     device_data->Discovery_State =
                         BACNET_DISCOVER_STATE_OBJECT_GET_PROPERTY_REQUEST;
-                    device_data->Object_List_Index++;
-                } else {
-                    debug_perror("%u object-list[%u] %s-%u fail to queue!\n",
-                        device_id, device_data->Object_List_Index,
-                        bactext_object_type_name(object_type),
-                        (unsigned)object_instance);
+                    if (device_data->Read_Property_Only) {
+                        device_data->Property_Index++;
+                        if (device_data->Property_Index >=
+                            DISCOVER_PROPERTIES_COUNT) {
+                            device_data->Property_Index = 0;
+                            device_data->Object_List_Index++;
+                        }
+                    } else {
+                        device_data->Object_List_Index++;
+                    }
                 }
             } else {
-                /* track the duration */
-                device_data->Discovery_Elapsed_Milliseconds =
-                    mstimer_elapsed(&device_data->Discovery_Timer);
-                /* rediscover in the future */
-                mstimer_set(
-                    &device_data->Discovery_Timer, Discovery_Milliseconds);
-                device_data->Discovery_State = BACNET_DISCOVER_STATE_DONE;
+                device_data->Discovery_Failed = false;
+                bacnet_discover_device_done(device_id, device_data);
             }
             break;
         case BACNET_DISCOVER_STATE_DONE:
@@ -840,30 +1131,32 @@ static void bacnet_discover_device_fsm(
 }
 
 /**
- * @brief Adds a device to the device list
- * @param device_id - Device ID from discovered device
- * @param src - BACnet address from discovered device
- * @return non-zero device index for device if added or existing
+ * @brief Runs the discovery state machine of the devices, starting where
+ *  it stopped the last time, until the read-write queue is full
  */
 static void bacnet_discover_devices_task(void)
 {
-    unsigned int device_index = 0;
     unsigned int device_count = 0;
+    unsigned int i;
     uint32_t device_id = 0;
     BACNET_DEVICE_DATA *device_data;
     KEY key;
 
     device_count = Keylist_Count(Device_List);
-    for (device_index = 0; device_index < device_count; device_index++) {
-        device_data = Keylist_Data_Index(Device_List, device_index);
-        if (!device_data) {
-            debug_perror("device[%u] is NULL!\n", device_index);
-            continue;
+    for (i = 0; i < device_count; i++) {
+        if (bacnet_read_write_busy()) {
+            break;
         }
-        if (Keylist_Index_Key(Device_List, device_index, &key)) {
+        if (Device_Task_Index >= device_count) {
+            Device_Task_Index = 0;
+        }
+        device_data = Keylist_Data_Index(Device_List, Device_Task_Index);
+        if (device_data &&
+            Keylist_Index_Key(Device_List, Device_Task_Index, &key)) {
             device_id = key;
             bacnet_discover_device_fsm(device_id, device_data);
         }
+        Device_Task_Index++;
     }
 }
 
@@ -1031,9 +1324,7 @@ void bacnet_discover_task(void)
         mstimer_restart(&Read_Write_Timer);
         bacnet_read_write_task();
     }
-    if (bacnet_read_write_idle()) {
-        bacnet_discover_devices_task();
-    }
+    bacnet_discover_devices_task();
 }
 
 /**
@@ -1133,6 +1424,28 @@ void bacnet_discover_device_add(uint32_t device_instance,
         device_data ? "success" : "fail");
 }
 
+/**
+ * @brief Set the number of requests in progress at the same time, in
+ *  total and to each device
+ * @param count - number of requests in progress to all the devices
+ * @param device_count - number of requests in progress to one device
+ */
+void bacnet_discover_concurrency_set(unsigned count, unsigned device_count)
+{
+    bacnet_read_write_concurrency_set(count);
+    bacnet_read_write_device_concurrency_set(device_count);
+}
+
+/**
+ * @brief Set the function called when the discovery of a device is done
+ * @param callback - function to call, or NULL
+ */
+void bacnet_discover_device_done_callback_set(
+    bacnet_discover_device_done_callback callback)
+{
+    Device_Done_Callback = callback;
+}
+
 /**
  * @brief Initializes the ReadProperty module
  */
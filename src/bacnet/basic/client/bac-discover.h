@@ -33,6 +33,14 @@ typedef bool (*bacnet_discover_device_callback) (
     BACNET_READ_PROPERTY_DATA * rp_data,
     void *context_data);
 
+/**
+ * @brief Callback function for when the discovery of a device is finished.
+ *  It is called again each time the device is discovered again, and also
+ *  when the discovery failed - see bacnet_discover_device_failed().
+ * @param device_id [in] The device ID of the device
+ */
+typedef void (*bacnet_discover_device_done_callback)(uint32_t device_id);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -56,6 +64,12 @@ BACNET_STACK_EXPORT
 size_t bacnet_discover_device_memory(
     uint32_t device_id);
 BACNET_STACK_EXPORT
+unsigned bacnet_discover_device_done_count(uint32_t device_id);
+BACNET_STACK_EXPORT
+bool bacnet_discover_device_failed(uint32_t device_id);
+BACNET_STACK_EXPORT
+bool bacnet_discover_devices_done(void);
+BACNET_STACK_EXPORT
 unsigned int bacnet_discover_object_property_count(
     uint32_t device_id,
     BACNET_OBJECT_TYPE object_type,
@@ -119,6 +133,12 @@ void bacnet_discover_read_process_milliseconds_set(unsigned long milliseconds);
 BACNET_STACK_EXPORT
 unsigned long bacnet_discover_read_process_milliseconds(void);
 
+BACNET_STACK_EXPORT
+void bacnet_discover_concurrency_set(unsigned count, unsigned device_count);
+BACNET_STACK_EXPORT
+void bacnet_discover_device_done_callback_set(
+    bacnet_discover_device_done_callback callback);
+
 BACNET_STACK_EXPORT
 void bacnet_discover_device_add(
     uint32_t device_instance,
@@ -26,9 +26,7 @@
 
 /* timer for address cache */
 static struct mstimer Cache_Timer;
-#define CACHE_CYCLE_SECONDS 60
-/* timeout timer for read-write task */
-static struct mstimer Read_Write_Timer;
+#define CACHE_CYCLE_SECONDS 1
 /* where the data from the read is stored */
 static bacnet_read_write_value_callback_t bacnet_read_write_value_callback;
 /* where the data from the I-Am is called */
@@ -72,15 +70,66 @@ static TARGET_DATA Target_Data_Buffer[TARGET_DATA_QUEUE_COUNT];
 static RING_BUFFER Target_Data_Queue;
 /* local storage - keeps it off the c-stack */
 static BACNET_APPLICATION_DATA_VALUE Target_Decoded_Property_Value;
-/* the invoke id is needed to filter incoming messages */
-static uint8_t Request_Invoke_ID;
-static BACNET_ADDRESS Target_Address;
-static uint32_t Target_Device_ID;
 static uint16_t Target_Vendor_ID;
-static bool Error_Detected = false;
-static BACNET_ERROR_CLASS Error_Class;
-static BACNET_ERROR_CODE Error_Code;
-static BACNET_CLIENT_STATE RW_State = BACNET_CLIENT_IDLE;
+/* a request in progress */
+typedef struct target_request_t {
+    BACNET_CLIENT_STATE state;
+    TARGET_DATA target;
+    struct mstimer timer;
+    /* the invoke id is needed to filter incoming messages */
+    uint8_t invoke_id;
+    BACNET_ADDRESS address;
+    bool error_detected;
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+} TARGET_REQUEST;
+static TARGET_REQUEST Target_Request[BACNET_READ_WRITE_REQUEST_MAX];
+/* number of requests in progress at the same time, in total and per device */
+static unsigned Target_Request_Limit = 1;
+static unsigned Target_Request_Device_Limit = 1;
+
+/**
+ * @brief Find the request in progress that a reply belongs to
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param invoke_id [in] the invokeID from the message
+ * @return the matching request, or NULL if none
+ */
+static TARGET_REQUEST *bacnet_read_write_request_find(
+    BACNET_ADDRESS *src, uint8_t invoke_id)
+{
+    TARGET_REQUEST *request;
+    unsigned i;
+
+    for (i = 0; i < BACNET_READ_WRITE_REQUEST_MAX; i++) {
+        request = &Target_Request[i];
+        if ((request->state == BACNET_CLIENT_WAITING) &&
+            (request->invoke_id == invoke_id) &&
+            address_match(&request->address, src)) {
+            return request;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Count the requests in progress to a device
+ * @param device_id [in] device instance number
+ * @return number of requests in progress to the device
+ */
+static unsigned bacnet_read_write_device_request_count(uint32_t device_id)
+{
+    unsigned i, count = 0;
+
+    for (i = 0; i < BACNET_READ_WRITE_REQUEST_MAX; i++) {
+        if ((Target_Request[i].state != BACNET_CLIENT_IDLE) &&
+            (Target_Request[i].target.device_id == device_id)) {
+            count++;
+        }
+    }
+
+    return count;
+}
 
 /**
  * @brief Handler for an Error PDU.
@@ -94,11 +143,13 @@ static void MyErrorHandler(BACNET_ADDRESS *src,
     BACNET_ERROR_CLASS error_class,
     BACNET_ERROR_CODE error_code)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = error_class;
-        Error_Code = error_code;
+    TARGET_REQUEST *request;
+
+    request = bacnet_read_write_request_find(src, invoke_id);
+    if (request) {
+        request->error_detected = true;
+        request->error_class = error_class;
+        request->error_code = error_code;
     }
 }
 
@@ -112,12 +163,14 @@ static void MyErrorHandler(BACNET_ADDRESS *src,
 static void MyAbortHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t abort_reason, bool server)
 {
+    TARGET_REQUEST *request;
+
     (void)server;
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = ERROR_CLASS_SERVICES;
-        Error_Code = abort_convert_to_error_code(abort_reason);
+    request = bacnet_read_write_request_find(src, invoke_id);
+    if (request) {
+        request->error_detected = true;
+        request->error_class = ERROR_CLASS_SERVICES;
+        request->error_code = abort_convert_to_error_code(abort_reason);
     }
 }
 
@@ -130,11 +183,13 @@ static void MyAbortHandler(
 static void MyRejectHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id, uint8_t reject_reason)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
-        Error_Detected = true;
-        Error_Class = ERROR_CLASS_SERVICES;
-        Error_Code = reject_convert_to_error_code(reject_reason);
+    TARGET_REQUEST *request;
+
+    request = bacnet_read_write_request_find(src, invoke_id);
+    if (request) {
+        request->error_detected = true;
+        request->error_class = ERROR_CLASS_SERVICES;
+        request->error_code = reject_convert_to_error_code(reject_reason);
     }
 }
 
@@ -190,8 +245,7 @@ static void My_I_Am_Bind(
 static void MyWritePropertySimpleAckHandler(
     BACNET_ADDRESS *src, uint8_t invoke_id)
 {
-    if (address_match(&Target_Address, src) &&
-        (invoke_id == Request_Invoke_ID)) {
+    if (bacnet_read_write_request_find(src, invoke_id)) {
         /* nothing to do */
     }
 }
@@ -270,20 +324,20 @@ static void My_Read_Property_Ack_Handler(uint8_t *service_request,
 {
     int len = 0;
     BACNET_READ_PROPERTY_DATA rp_data;
-    uint32_t device_id = 0;
+    TARGET_REQUEST *request;
 
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
-        address_get_device_id(src, &device_id);
+    request = bacnet_read_write_request_find(src, service_data->invoke_id);
+    if (request) {
         len = rp_ack_decode_service_request(
             service_request, service_len, &rp_data);
         if (len < 0) {
             /* unable to decode value */
-            Error_Detected = true;
-            Error_Class = ERROR_CLASS_SERVICES;
-            Error_Code = ERROR_CODE_INTERNAL_ERROR;
+            request->error_detected = true;
+            request->error_class = ERROR_CLASS_SERVICES;
+            request->error_code = ERROR_CODE_INTERNAL_ERROR;
         } else {
-            bacnet_read_property_ack_process(device_id, &rp_data);
+            bacnet_read_property_ack_process(
+                request->target.device_id, &rp_data);
         }
     }
 }
@@ -303,13 +357,12 @@ static void My_Read_Property_Multiple_Ack_Handler(uint8_t *apdu,
     BACNET_CONFIRMED_SERVICE_ACK_DATA *service_data)
 {
     BACNET_READ_PROPERTY_DATA rp_data = { 0 };
-    uint32_t device_id = 0;
+    TARGET_REQUEST *request;
 
-    address_get_device_id(src, &device_id);
-    if (address_match(&Target_Address, src) &&
-        (service_data->invoke_id == Request_Invoke_ID)) {
+    request = bacnet_read_write_request_find(src, service_data->invoke_id);
+    if (request) {
         rpm_ack_object_property_process(apdu, apdu_len,
-            device_id, &rp_data,
+            request->target.device_id, &rp_data,
             bacnet_read_property_ack_process);
     }
 }
@@ -347,26 +400,27 @@ static uint8_t Send_RPM_All_Request(uint32_t device_id,
 }
 
 /**
- * @brief Handles the ReadProperty process
- * @param service_request [in] The contents of the service request.
+ * @brief Handles the ReadProperty process of one request in progress
+ * @param request [in] The request in progress
  * @return true if the process is finished
  */
-static bool bacnet_read_write_process(TARGET_DATA *target)
+static bool bacnet_read_write_process(TARGET_REQUEST *request)
 {
+    TARGET_DATA *target = &request->target;
     bool found = false;
     unsigned max_apdu = 0;
     uint8_t application_data[16] = { 0 };
     int application_data_len = 0;
     bool valid_tag = false;
 
-    switch (RW_State) {
+    switch (request->state) {
         case BACNET_CLIENT_IDLE:
-            mstimer_set(&Read_Write_Timer, apdu_timeout());
+            mstimer_set(&request->timer, apdu_timeout());
+            request->error_detected = false;
             if (target->device_id < BACNET_MAX_INSTANCE) {
-                Error_Detected = false;
-                RW_State = BACNET_CLIENT_BIND;
+                request->state = BACNET_CLIENT_BIND;
             } else {
-                RW_State = BACNET_CLIENT_FINISHED;
+                request->state = BACNET_CLIENT_FINISHED;
             }
             break;
         case BACNET_CLIENT_BIND:
@@ -374,28 +428,28 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
             address_own_device_id_set(Device_Object_Instance_Number());
             /* try to bind with the device */
             found = address_bind_request(
-                target->device_id, &max_apdu, &Target_Address);
+                target->device_id, &max_apdu, &request->address);
             if (found) {
-                Target_Device_ID = target->device_id;
-                RW_State = BACNET_CLIENT_SEND;
+                request->state = BACNET_CLIENT_SEND;
             } else {
-                Send_WhoIs(target->device_id, target->device_id);
-                RW_State = BACNET_CLIENT_BINDING;
+                if (address_who_is_request(target->device_id)) {
+                    Send_WhoIs(target->device_id, target->device_id);
+                }
+                request->state = BACNET_CLIENT_BINDING;
             }
             break;
         case BACNET_CLIENT_BINDING:
             found = address_bind_request(
-                target->device_id, &max_apdu, &Target_Address);
+                target->device_id, &max_apdu, &request->address);
             if (found) {
-                Target_Device_ID = target->device_id;
-                mstimer_set(&Read_Write_Timer, apdu_timeout());
-                RW_State = BACNET_CLIENT_SEND;
-            } else if (mstimer_expired(&Read_Write_Timer)) {
+                mstimer_set(&request->timer, apdu_timeout());
+                request->state = BACNET_CLIENT_SEND;
+            } else if (mstimer_expired(&request->timer)) {
                 /* unable to bind within APDU timeout */
-                Error_Detected = true;
-                Error_Class = ERROR_CLASS_SERVICES;
-                Error_Code = ERROR_CODE_TIMEOUT;
-                RW_State = BACNET_CLIENT_FINISHED;
+                request->error_detected = true;
+                request->error_class = ERROR_CLASS_SERVICES;
+                request->error_code = ERROR_CODE_TIMEOUT;
+                request->state = BACNET_CLIENT_FINISHED;
             }
             break;
         case BACNET_CLIENT_SEND:
@@ -435,7 +489,7 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
                         break;
                 }
                 if (valid_tag) {
-                    Request_Invoke_ID = Send_Write_Property_Request_Data(
+                    request->invoke_id = Send_Write_Property_Request_Data(
                         target->device_id, target->object_type,
                         target->object_instance, target->object_property,
                         &application_data[0], application_data_len,
@@ -443,49 +497,47 @@ static bool bacnet_read_write_process(TARGET_DATA *target)
                 }
             } else {
                 if (target->object_property == PROP_ALL) {
-                    Request_Invoke_ID = Send_RPM_All_Request(target->device_id,
+                    request->invoke_id = Send_RPM_All_Request(target->device_id,
                         target->object_type, target->object_instance);
                 } else {
-                    Request_Invoke_ID =
+                    request->invoke_id =
                         Send_Read_Property_Request(target->device_id,
                             target->object_type, target->object_instance,
                             target->object_property, target->array_index);
                 }
             }
-            if (Request_Invoke_ID == 0) {
-                if (mstimer_expired(&Read_Write_Timer)) {
+            if (request->invoke_id == 0) {
+                if (mstimer_expired(&request->timer)) {
                     /* TSM Timeout - no invokeIDs available */
-                    Error_Detected = true;
-                    Error_Class = ERROR_CLASS_SERVICES;
-                    Error_Code = ERROR_CODE_TIMEOUT;
-                    RW_State = BACNET_CLIENT_FINISHED;
+                    request->error_detected = true;
+                    request->error_class = ERROR_CLASS_SERVICES;
+                    request->error_code = ERROR_CODE_TIMEOUT;
+                    request->state = BACNET_CLIENT_FINISHED;
                 }
             } else {
-                RW_State = BACNET_CLIENT_WAITING;
+                request->state = BACNET_CLIENT_WAITING;
             }
             break;
         case BACNET_CLIENT_WAITING:
-            if (tsm_invoke_id_free(Request_Invoke_ID)) {
-                Error_Detected = false;
-                RW_State = BACNET_CLIENT_FINISHED;
-            } else if (tsm_invoke_id_failed(Request_Invoke_ID)) {
-                Error_Detected = true;
-                Error_Class = ERROR_CLASS_SERVICES;
-                Error_Code = ERROR_CODE_ABORT_TSM_TIMEOUT;
-                RW_State = BACNET_CLIENT_FINISHED;
-                tsm_free_invoke_id(Request_Invoke_ID);
-            } else if (Error_Detected) {
-                RW_State = BACNET_CLIENT_FINISHED;
+            if (request->error_detected) {
+                /* the transaction was ended by the Error, Reject or Abort */
+                request->state = BACNET_CLIENT_FINISHED;
+            } else if (tsm_invoke_id_free(request->invoke_id)) {
+                request->state = BACNET_CLIENT_FINISHED;
+            } else if (tsm_invoke_id_failed(request->invoke_id)) {
+                request->error_detected = true;
+                request->error_class = ERROR_CLASS_SERVICES;
+                request->error_code = ERROR_CODE_ABORT_TSM_TIMEOUT;
+                request->state = BACNET_CLIENT_FINISHED;
+                tsm_free_invoke_id(request->invoke_id);
             }
             break;
         case BACNET_CLIENT_FINISHED:
-            RW_State = BACNET_CLIENT_IDLE;
-            break;
         default:
             break;
     }
 
-    return (RW_State == BACNET_CLIENT_FINISHED);
+    return (request->state == BACNET_CLIENT_FINISHED);
 }
 
 /**
@@ -511,31 +563,64 @@ void bacnet_read_write_device_callback_set(
 }
 
 /**
- * @brief Handles the ReadProperty repetitive task
+ * @brief Reports the error of a finished request to the value callback
+ * @param request [in] The finished request
+ */
+static void bacnet_read_write_error_report(TARGET_REQUEST *request)
+{
+    TARGET_DATA *target = &request->target;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    if (request->error_detected && bacnet_read_write_value_callback) {
+        rp_data.error_class = request->error_class;
+        rp_data.error_code = request->error_code;
+        rp_data.object_type = target->object_type;
+        rp_data.object_instance = target->object_instance;
+        rp_data.object_property = target->object_property;
+        rp_data.array_index = target->array_index;
+        bacnet_read_write_value_callback(target->device_id, &rp_data, NULL);
+    }
+}
+
+/**
+ * @brief Handles the ReadProperty repetitive task.
+ *
+ * The queued requests are started in order while fewer than the
+ * concurrency limit are in progress, and while the device of the next
+ * request has fewer than the per-device limit in progress.
  */
 void bacnet_read_write_task(void)
 {
     TARGET_DATA *target;
-    bool status = false;
-    BACNET_READ_PROPERTY_DATA rp_data;
+    TARGET_REQUEST *request;
+    unsigned i;
 
-    if (!Ringbuf_Empty(&Target_Data_Queue)) {
+    for (i = 0; i < Target_Request_Limit; i++) {
+        request = &Target_Request[i];
+        if (request->state != BACNET_CLIENT_IDLE) {
+            continue;
+        }
         target = (TARGET_DATA *)Ringbuf_Peek(&Target_Data_Queue);
-        status = bacnet_read_write_process(target);
-        if (status) {
-            if (Error_Detected) {
-                if (bacnet_read_write_value_callback) {
-                    rp_data.error_class = Error_Class;
-                    rp_data.error_code = Error_Code;
-                    rp_data.object_type = target->object_type;
-                    rp_data.object_instance = target->object_instance;
-                    rp_data.object_property = target->object_property;
-                    rp_data.array_index = target->array_index;
-                    bacnet_read_write_value_callback(
-                        target->device_id, &rp_data, NULL);
-                }
-            }
-            Ringbuf_Pop(&Target_Data_Queue, NULL);
+        if (!target) {
+            break;
+        }
+        if (bacnet_read_write_device_request_count(target->device_id) >=
+            Target_Request_Device_Limit) {
+            break;
+        }
+        request->target = *target;
+        Ringbuf_Pop(&Target_Data_Queue, NULL);
+        (void)bacnet_read_write_process(request);
+    }
+    /* all of them, in case the limit was lowered while busy */
+    for (i = 0; i < BACNET_READ_WRITE_REQUEST_MAX; i++) {
+        request = &Target_Request[i];
+        if (request->state == BACNET_CLIENT_IDLE) {
+            continue;
+        }
+        if (bacnet_read_write_process(request)) {
+            bacnet_read_write_error_report(request);
+            request->state = BACNET_CLIENT_IDLE;
         }
     }
     if (mstimer_expired(&Cache_Timer)) {
@@ -817,10 +902,19 @@ bool bacnet_write_property_boolean_queue(uint32_t device_id,
 
 /**
  * @brief Determines if the BACnet ReadProperty queue is empty
- * @return true if the parameter queue is empty, and thus, idle
+ * @return true if the parameter queue is empty and no request is in
+ *  progress, and thus, idle
  */
 bool bacnet_read_write_idle(void)
 {
+    unsigned i;
+
+    for (i = 0; i < BACNET_READ_WRITE_REQUEST_MAX; i++) {
+        if (Target_Request[i].state != BACNET_CLIENT_IDLE) {
+            return false;
+        }
+    }
+
     return Ringbuf_Empty(&Target_Data_Queue);
 }
 
@@ -853,11 +947,62 @@ uint16_t bacnet_read_write_vendor_id_filter(void)
     return Target_Vendor_ID;
 }
 
+/**
+ * @brief Sets the number of requests that may be in progress at once
+ * @param count - number of requests, 1..BACNET_READ_WRITE_REQUEST_MAX
+ */
+void bacnet_read_write_concurrency_set(unsigned count)
+{
+    if (count < 1) {
+        count = 1;
+    } else if (count > BACNET_READ_WRITE_REQUEST_MAX) {
+        count = BACNET_READ_WRITE_REQUEST_MAX;
+    }
+    Target_Request_Limit = count;
+}
+
+/**
+ * @brief Gets the number of requests that may be in progress at once
+ * @return number of requests
+ */
+unsigned bacnet_read_write_concurrency(void)
+{
+    return Target_Request_Limit;
+}
+
+/**
+ * @brief Sets the number of requests that may be in progress at once
+ *  to the same device, so that small devices are not overrun
+ * @param count - number of requests to a device, 1 or more
+ */
+void bacnet_read_write_device_concurrency_set(unsigned count)
+{
+    if (count < 1) {
+        count = 1;
+    }
+    Target_Request_Device_Limit = count;
+}
+
+/**
+ * @brief Gets the number of requests that may be in progress at once
+ *  to the same device
+ * @return number of requests to a device
+ */
+unsigned bacnet_read_write_device_concurrency(void)
+{
+    return Target_Request_Device_Limit;
+}
+
 /**
  * @brief Initializes the ReadProperty module
  */
 void bacnet_read_write_init(void)
 {
+    unsigned i;
+
+    for (i = 0; i < BACNET_READ_WRITE_REQUEST_MAX; i++) {
+        Target_Request[i].state = BACNET_CLIENT_IDLE;
+    }
     Ringbuf_Init(&Target_Data_Queue, (uint8_t *)&Target_Data_Buffer,
         TARGET_DATA_QUEUE_SIZE, TARGET_DATA_QUEUE_COUNT);
     /* handle i-am to support binding to other devices */
@@ -872,6 +1017,8 @@ void bacnet_read_write_init(void)
         SERVICE_CONFIRMED_WRITE_PROPERTY, MyWritePropertySimpleAckHandler);
     /* handle any errors coming back */
     apdu_set_error_handler(SERVICE_CONFIRMED_READ_PROPERTY, MyErrorHandler);
+    apdu_set_error_handler(
+        SERVICE_CONFIRMED_READ_PROP_MULTIPLE, MyErrorHandler);
     apdu_set_error_handler(SERVICE_CONFIRMED_WRITE_PROPERTY, MyErrorHandler);
     apdu_set_abort_handler(MyAbortHandler);
     apdu_set_reject_handler(MyRejectHandler);
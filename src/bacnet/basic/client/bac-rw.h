@@ -14,6 +14,11 @@
 #include "bacnet/bacapp.h"
 #include "bacnet/rp.h"
 
+/* largest number of requests that may be in progress at the same time */
+#ifndef BACNET_READ_WRITE_REQUEST_MAX
+#define BACNET_READ_WRITE_REQUEST_MAX 32
+#endif
+
 /**
  * Save the requested ReadProperty data to a data store
  *
@@ -22,6 +27,11 @@
  *  which is packed with the information from the ReadProperty request.
  * @param value [in] pointer to the BACNET_APPLICATION_DATA_VALUE structure
  *  which is packed with the decoded value from the ReadProperty request.
+ *
+ * A failed request is reported with a NULL value and the error in rp_data.
+ * An Error, Reject, or Abort from the device carries its own error code.
+ * A request that got no reply carries ERROR_CODE_ABORT_TSM_TIMEOUT, and
+ * one that could not bind or get an invoke ID carries ERROR_CODE_TIMEOUT.
  */
 typedef void (*bacnet_read_write_value_callback_t)(uint32_t device_instance,
     BACNET_READ_PROPERTY_DATA *rp_data,
@@ -115,6 +125,14 @@ BACNET_STACK_EXPORT
 void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id);
 BACNET_STACK_EXPORT
 uint16_t bacnet_read_write_vendor_id_filter(void);
+BACNET_STACK_EXPORT
+void bacnet_read_write_concurrency_set(unsigned count);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_concurrency(void);
+BACNET_STACK_EXPORT
+void bacnet_read_write_device_concurrency_set(unsigned count);
+BACNET_STACK_EXPORT
+unsigned bacnet_read_write_device_concurrency(void);
 
 #ifdef __cplusplus
 }
@@ -34,6 +34,7 @@
 #include "bacnet/basic/object/device.h"
 /* us */
 #include "bacnet/basic/client/bac-rw.h"
+#include "bacnet/basic/client/bac-cov.h"
 #include "bacnet/basic/client/bac-data.h"
 #include "bacnet/basic/client/bac-task.h"
 
@@ -72,12 +73,15 @@ void bacnet_task(void)
         dcc_timer_seconds(1);
         datalink_maintenance_timer(1);
         dlenv_maintenance_timer(1);
+        bacnet_cov_timer_seconds(1);
     }
     if (mstimer_expired(&BACnet_TSM_Timer)) {
         mstimer_reset(&BACnet_TSM_Timer);
         tsm_timer_milliseconds(mstimer_interval(&BACnet_TSM_Timer));
+        handler_who_is_timer(mstimer_interval(&BACnet_TSM_Timer));
     }
     bacnet_data_task();
+    bacnet_cov_task();
 }
 
 /**
@@ -102,7 +106,17 @@ void bacnet_task_init(void)
     /* handle communication so we can shutup when asked */
     apdu_set_confirmed_handler(SERVICE_CONFIRMED_DEVICE_COMMUNICATION_CONTROL,
         handler_device_communication_control);
+    /* handle the COV notifications of our subscriptions */
+    apdu_set_unconfirmed_handler(
+        SERVICE_UNCONFIRMED_COV_NOTIFICATION, handler_ucov_notification);
+    apdu_set_confirmed_handler(
+        SERVICE_CONFIRMED_COV_NOTIFICATION, handler_ccov_notification);
+    /* don't repeat the Who-Is for a device faster than it can answer */
+    address_who_is_holdoff_set(10);
     bacnet_data_init();
+    /* subscribe to the data points, and poll the ones without COV */
+    bacnet_cov_init();
+    bacnet_cov_value_callback_set(bacnet_data_value_save);
     mstimer_set(&BACnet_Task_Timer, 1000);
     mstimer_set(&BACnet_TSM_Timer, 50);
 }
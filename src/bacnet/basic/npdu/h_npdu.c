@@ -17,6 +17,7 @@
 #include "bacnet/apdu.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/debug.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 #if PRINT_ENABLED
@@ -220,7 +221,7 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
     if (pdu_len < 1) {
         return;
     }
-
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_NPDU_RX);
     /* only handle the version that we know how to handle */
     if (pdu[0] == BACNET_PROTOCOL_VERSION) {
         apdu_offset =
@@ -231,6 +232,7 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
                     src, &npdu_data, &pdu[apdu_offset],
                     (uint16_t)(pdu_len - apdu_offset));
             } else {
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_NPDU_RX_DROPPED);
                 debug_printf("NPDU: message for router. Discarded!\n");
             }
         } else if ((apdu_offset > 0) && (apdu_offset < pdu_len)) {
@@ -255,12 +257,16 @@ void npdu_handler(BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len)
                         (uint16_t)(pdu_len - apdu_offset));
                 }
             } else {
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_NPDU_RX_DROPPED);
 #if PRINT_ENABLED
                 printf("NPDU: DNET=%u.  Discarded!\n", (unsigned)dest.net);
 #endif
             }
+        } else {
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_NPDU_RX_DROPPED);
         }
     } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_NPDU_RX_DROPPED);
 #if PRINT_ENABLED
         printf(
             "NPDU: BACnet Protocol Version=%u.  Discarded!\n",
@@ -164,6 +164,9 @@ static void network_control_handler(BACNET_ADDRESS *src,
  * the src information does not need to change to reflect that (as it normally
  * would for a routed message) because the reply will be sent from the level
  * of the gateway Device.
+ * @note A global Who-Is is given only to the gateway Device, so the
+ * application registers handler_who_is_unicast_for_routing() or
+ * handler_who_is_bcast_for_routing() to answer for all of the Devices.
  *
  * @param src [in] The BACNET_ADDRESS of the message's source.
  * @param dest [in] The BACNET_ADDRESS of the message's destination.
@@ -210,6 +213,27 @@ static void routed_apdu_handler(BACNET_ADDRESS *src,
         return;
     }
 
+    if ((apdu_len >= 2) &&
+        (apdu[0] == PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST) &&
+        (apdu[1] == SERVICE_UNCONFIRMED_WHO_IS)) {
+        /* The Who-Is handlers for routing answer for every Device,
+         * so a broadcast Who-Is is handled once instead of once for
+         * each Device: a global one by the gateway Device, and one to
+         * the virtual network by the first virtual Device, so that
+         * only the virtual Devices answer. */
+        if (dest->net == BACNET_BROADCAST_NETWORK) {
+            if (Get_Routed_Device_Object(0)) {
+                apdu_handler(src, apdu, apdu_len);
+            }
+            return;
+        }
+        if ((dest->net == DNET_list[0]) && (dest->len == 0)) {
+            if (Get_Routed_Device_Object(1)) {
+                apdu_handler(src, apdu, apdu_len);
+            }
+            return;
+        }
+    }
     while (Routed_Device_GetNext(dest, DNET_list, &cursor)) {
         apdu_handler(src, apdu, apdu_len);
         bGotOne = true;
@@ -36,6 +36,10 @@
 struct object_data {
     bool Changed : 1;
     bool Write_Enabled : 1;
+    /* the Date_List is evaluated once per date */
+    bool Cache_Valid : 1;
+    bool Cache_Value : 1;
+    BACNET_DATE Cache_Date;
     bool Present_Value;
     OS_Keylist Date_List;
     const char *Object_Name;
@@ -210,6 +214,7 @@ static void Calendar_Date_List_Clean(OS_Keylist list)
 
 /**
  * For a given object instance-number, returns the Calendar entity by index.
+ * After modifying the entity, call Calendar_Date_List_Modified().
  *
  * @param  object_instance - object-instance number of the object
  * @param  index - index of entity
@@ -230,6 +235,23 @@ Calendar_Date_List_Get(uint32_t object_instance, uint8_t index)
     return entry;
 }
 
+/**
+ * For a given object instance-number, forgets the Date_List result kept
+ * by Calendar_Date_Active().  Call this after modifying an entity that
+ * was returned by Calendar_Date_List_Get().
+ *
+ * @param  object_instance - object-instance number of the object
+ */
+void Calendar_Date_List_Modified(uint32_t object_instance)
+{
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        pObject->Cache_Valid = false;
+    }
+}
+
 /**
  * For a given object instance-number, adds a Calendar entity to entities list.
  *
@@ -256,6 +278,7 @@ bool Calendar_Date_List_Add(
     }
 
     *entry = *value;
+    pObject->Cache_Valid = false;
     st = Keylist_Data_Add(
         pObject->Date_List, Keylist_Count(pObject->Date_List), entry);
 
@@ -278,6 +301,7 @@ bool Calendar_Date_List_Delete_All(uint32_t object_instance)
     }
 
     Calendar_Date_List_Clean(pObject->Date_List);
+    pObject->Cache_Valid = false;
 
     return true;
 }
@@ -334,6 +358,64 @@ int Calendar_Date_List_Encode(
     return apdu_len;
 }
 
+/**
+ * Determines if a date is in the Date_List of a Calendar
+ *
+ * @param  pObject - Calendar object
+ * @param  date - date to check
+ *
+ * @return  true if the date is in the Date_List
+ */
+static bool Calendar_Date_List_Match(
+    struct object_data *pObject, BACNET_DATE *date)
+{
+    BACNET_CALENDAR_ENTRY *entry;
+    int count, index;
+
+    count = Keylist_Count(pObject->Date_List);
+    for (index = 0; index < count; index++) {
+        entry = Keylist_Data_Index(pObject->Date_List, index);
+        if (bacapp_date_in_calendar_entry(date, entry)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * For a given object instance-number, determines if a date is
+ * in the Date_List.  The result is kept for the last date checked,
+ * so that repeated checks on the same day do not evaluate every
+ * BACnetCalendarEntry again.  The result is forgotten when the
+ * Date_List is written, or by Calendar_Date_List_Modified().
+ *
+ * @param  object_instance - object-instance number of the object
+ * @param  date - date to check
+ *
+ * @return  true if the date is in the Date_List
+ */
+bool Calendar_Date_Active(uint32_t object_instance, BACNET_DATE *date)
+{
+    struct object_data *pObject;
+    bool active = false;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject || !date) {
+        return false;
+    }
+    if (pObject->Cache_Valid &&
+        (datetime_compare_date(&pObject->Cache_Date, date) == 0)) {
+        return pObject->Cache_Value;
+    }
+    active = Calendar_Date_List_Match(pObject, date);
+    datetime_copy_date(&pObject->Cache_Date, date);
+    pObject->Cache_Value = active;
+    pObject->Cache_Valid = true;
+
+    return active;
+}
+
 /**
  * For a given object instance-number, determines the present-value
  *
@@ -345,21 +427,15 @@ bool Calendar_Present_Value(uint32_t object_instance)
 {
     BACNET_DATE date;
     BACNET_TIME time;
-    BACNET_CALENDAR_ENTRY *entry = NULL;
-    unsigned size = 0;
-    int index;
-
-    datetime_local(&date, &time, NULL, NULL);
+    struct object_data *pObject;
 
-    size = Calendar_Date_List_Count(object_instance);
-    for (index = 0; index < size; index++) {
-        entry = Calendar_Date_List_Get(object_instance, index);
-        if (bacapp_date_in_calendar_entry(&date, entry)) {
-            return true;
-        }
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (!pObject) {
+        return false;
     }
+    datetime_local(&date, &time, NULL, NULL);
 
-    return false;
+    return Calendar_Date_List_Match(pObject, &date);
 }
 
 /**
@@ -706,6 +782,7 @@ uint32_t Calendar_Create(uint32_t object_instance)
         pObject->Date_List = Keylist_Create();
         pObject->Changed = false;
         pObject->Write_Enabled = false;
+        pObject->Cache_Valid = false;
         /* add to list */
         index = Keylist_Data_Add(Object_List, object_instance, pObject);
         if (index < 0) {
@@ -58,6 +58,8 @@ bool Calendar_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data);
 BACNET_STACK_EXPORT
 bool Calendar_Present_Value(uint32_t object_instance);
 BACNET_STACK_EXPORT
+bool Calendar_Date_Active(uint32_t object_instance, BACNET_DATE *date);
+BACNET_STACK_EXPORT
 void Calendar_Write_Present_Value_Callback_Set(
     calendar_write_present_value_callback cb);
 
@@ -65,6 +67,8 @@ BACNET_STACK_EXPORT
 BACNET_CALENDAR_ENTRY *Calendar_Date_List_Get(
     uint32_t object_instance, uint8_t index);
 BACNET_STACK_EXPORT
+void Calendar_Date_List_Modified(uint32_t object_instance);
+BACNET_STACK_EXPORT
 bool Calendar_Date_List_Add(
     uint32_t object_instance, BACNET_CALENDAR_ENTRY *value);
 BACNET_STACK_EXPORT
@@ -30,16 +30,33 @@
 #define CONTROL_GROUPS_MAX 8
 #endif
 
+/* number of empty members in a new channel */
 #ifndef CHANNEL_MEMBERS_MAX
 #define CHANNEL_MEMBERS_MAX 8
 #endif
 
+/* largest number of members that can be written to a channel */
+#ifndef CHANNEL_MEMBERS_LIMIT
+#define CHANNEL_MEMBERS_LIMIT 256
+#endif
+
+/* a member, the datatype its value is coerced to when written, and the
+   WriteProperty function of its object, or NULL until it is looked up */
+struct channel_member {
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE Reference;
+    BACNET_APPLICATION_TAG Coerce_Tag;
+    write_property_function Write_Property;
+};
+
 struct object_data {
     bool Out_Of_Service : 1;
     BACNET_CHANNEL_VALUE Present_Value;
     unsigned Last_Priority;
     BACNET_WRITE_STATUS Write_Status;
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE Members[CHANNEL_MEMBERS_MAX];
+    /* each member is allocated on its own, so that a member does not
+       move when the number of members changes */
+    struct channel_member **Members;
+    unsigned Members_Count;
     uint16_t Number;
     uint32_t Control_Groups[CONTROL_GROUPS_MAX];
     const char *Object_Name;
@@ -50,6 +67,7 @@ struct object_data {
 static OS_Keylist Object_List;
 
 static write_property_function Write_Property_Internal_Callback;
+static channel_write_property_lookup_function Write_Property_Lookup_Callback;
 
 /* These arrays are used by the ReadPropertyMultiple handler
    property-list property (as of protocol-revision 14) */
@@ -252,6 +270,149 @@ bool Channel_Number_Set(uint32_t object_instance, uint16_t value)
     return status;
 }
 
+/**
+ * @brief Determine the datatype that a channel value is coerced to
+ *  when it is written to a member property
+ * @param object_type - object type of the member
+ * @param property - property of the member
+ * @param array_index - array index of the member
+ * @return application tag of the datatype, or MAX_BACNET_APPLICATION_TAG
+ *  if the member property is not supported
+ */
+static BACNET_APPLICATION_TAG Channel_Member_Coerce_Tag(
+    BACNET_OBJECT_TYPE object_type,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index)
+{
+    BACNET_APPLICATION_TAG tag = MAX_BACNET_APPLICATION_TAG;
+
+    switch (object_type) {
+        case OBJECT_ANALOG_INPUT:
+        case OBJECT_ANALOG_OUTPUT:
+        case OBJECT_ANALOG_VALUE:
+            if ((property == PROP_PRESENT_VALUE) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_REAL;
+            }
+            break;
+        case OBJECT_BINARY_INPUT:
+        case OBJECT_BINARY_OUTPUT:
+        case OBJECT_BINARY_VALUE:
+            if ((property == PROP_PRESENT_VALUE) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_ENUMERATED;
+            }
+            break;
+        case OBJECT_MULTI_STATE_INPUT:
+        case OBJECT_MULTI_STATE_OUTPUT:
+        case OBJECT_MULTI_STATE_VALUE:
+            if ((property == PROP_PRESENT_VALUE) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+            }
+            break;
+        case OBJECT_LIGHTING_OUTPUT:
+            if ((property == PROP_PRESENT_VALUE) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_REAL;
+            } else if ((property == PROP_LIGHTING_COMMAND) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_LIGHTING_COMMAND;
+            }
+            break;
+        case OBJECT_COLOR:
+            if ((property == PROP_PRESENT_VALUE) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_XY_COLOR;
+            } else if ((property == PROP_COLOR_COMMAND) &&
+                (array_index == BACNET_ARRAY_ALL)) {
+                tag = BACNET_APPLICATION_TAG_COLOR_COMMAND;
+            }
+            break;
+        case OBJECT_COLOR_TEMPERATURE:
+            tag = BACNET_APPLICATION_TAG_UNSIGNED_INT;
+            break;
+        default:
+            break;
+    }
+
+    return tag;
+}
+
+/**
+ * @brief Set a member, and resolve the datatype that the channel value
+ *  is coerced to, so that it is not looked up for every write
+ * @param pMember - member to be set
+ * @param pMemberSrc - object property reference of the member
+ */
+static void Channel_Member_Set(struct channel_member *pMember,
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMemberSrc)
+{
+    memcpy(&pMember->Reference, pMemberSrc,
+        sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
+    pMember->Coerce_Tag =
+        Channel_Member_Coerce_Tag(pMemberSrc->objectIdentifier.type,
+            pMemberSrc->propertyIdentifier, pMemberSrc->arrayIndex);
+    pMember->Write_Property = NULL;
+}
+
+/**
+ * @brief Set a member to an empty reference
+ * @param pMember - member to be set
+ */
+static void Channel_Member_Empty(struct channel_member *pMember)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+
+    member.objectIdentifier.type = OBJECT_LIGHTING_OUTPUT;
+    member.objectIdentifier.instance = BACNET_MAX_INSTANCE;
+    member.propertyIdentifier = PROP_PRESENT_VALUE;
+    member.arrayIndex = BACNET_ARRAY_ALL;
+    member.deviceIdentifier.type = OBJECT_DEVICE;
+    member.deviceIdentifier.instance = BACNET_MAX_INSTANCE;
+    Channel_Member_Set(pMember, &member);
+}
+
+/**
+ * @brief Change the number of members of a channel.  New members are empty.
+ *  The members that are kept do not move.
+ * @param pObject - object instance data
+ * @param count - number of members
+ * @return true if the number of members was changed
+ */
+static bool Channel_Members_Resize(struct object_data *pObject, unsigned count)
+{
+    struct channel_member **members;
+    unsigned m;
+
+    for (m = count; m < pObject->Members_Count; m++) {
+        free(pObject->Members[m]);
+    }
+    if (count < pObject->Members_Count) {
+        pObject->Members_Count = count;
+    }
+    if (count == 0) {
+        free(pObject->Members);
+        pObject->Members = NULL;
+        return true;
+    }
+    members = realloc(pObject->Members, count * sizeof(*members));
+    if (!members) {
+        return false;
+    }
+    pObject->Members = members;
+    for (m = pObject->Members_Count; m < count; m++) {
+        members[m] = malloc(sizeof(struct channel_member));
+        if (!members[m]) {
+            return false;
+        }
+        Channel_Member_Empty(members[m]);
+        pObject->Members_Count = m + 1;
+    }
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet object instance number
@@ -309,12 +470,21 @@ static bool Channel_Reference_List_Member_Valid(
  */
 unsigned Channel_Reference_List_Member_Count(uint32_t object_instance)
 {
-    (void)object_instance;
-    return CHANNEL_MEMBERS_MAX;
+    unsigned count = 0;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject) {
+        count = pObject->Members_Count;
+    }
+
+    return count;
 }
 
 /**
- * For a given object instance-number, returns the member element
+ * For a given object instance-number, returns the member element.
+ * The element stays at the same address until it is removed by a
+ * smaller number of members, or the object is deleted.
  *
  * @param object_instance - object-instance number of the object
  * @param  array_index - 1-based array index
@@ -330,8 +500,8 @@ BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *Channel_Reference_List_Member_Element(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (array_index > 0)) {
         array_index--;
-        if (array_index < CHANNEL_MEMBERS_MAX) {
-            pMember = &pObject->Members[array_index];
+        if (array_index < pObject->Members_Count) {
+            pMember = &pObject->Members[array_index]->Reference;
         }
     }
 
@@ -350,17 +520,14 @@ bool Channel_Reference_List_Member_Element_Set(uint32_t object_instance,
     unsigned array_index,
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMemberSrc)
 {
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
     bool status = false;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject && (array_index > 0)) {
         array_index--;
-        if (array_index < CHANNEL_MEMBERS_MAX) {
-            pMember = &pObject->Members[array_index];
-            memcpy(pMember, pMemberSrc,
-                sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
+        if (array_index < pObject->Members_Count) {
+            Channel_Member_Set(pObject->Members[array_index], pMemberSrc);
             status = true;
         }
     }
@@ -369,7 +536,8 @@ bool Channel_Reference_List_Member_Element_Set(uint32_t object_instance,
 }
 
 /**
- * For a given object instance-number, adds a member element
+ * For a given object instance-number, adds a member element into the
+ * first empty member, or at the end of the members when none are empty
  *
  * @param object_instance - object-instance number of the object
  * @param pMemberSrc - pointer to a object property reference element
@@ -380,28 +548,56 @@ bool Channel_Reference_List_Member_Element_Set(uint32_t object_instance,
 unsigned Channel_Reference_List_Member_Element_Add(uint32_t object_instance,
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMemberSrc)
 {
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
     unsigned array_index = 0;
     unsigned m = 0;
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject) {
-        for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
-            pMember = &pObject->Members[m];
-            if (!Channel_Reference_List_Member_Valid(pMember)) {
+    if (pObject && pMemberSrc) {
+        for (m = 0; m < pObject->Members_Count; m++) {
+            if (!Channel_Reference_List_Member_Valid(
+                    &pObject->Members[m]->Reference)) {
                 /* first empty slot */
                 array_index = 1 + m;
-                memcpy(pMember, pMemberSrc,
-                    sizeof(BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE));
                 break;
             }
         }
+        if ((array_index == 0) &&
+            (pObject->Members_Count < CHANNEL_MEMBERS_LIMIT) &&
+            Channel_Members_Resize(pObject, pObject->Members_Count + 1)) {
+            array_index = pObject->Members_Count;
+        }
+        if (array_index > 0) {
+            Channel_Member_Set(pObject->Members[array_index - 1], pMemberSrc);
+        }
     }
 
     return array_index;
 }
 
+/**
+ * For a given object instance-number, sets the number of members.
+ * New members are empty.
+ *
+ * @param object_instance - object-instance number of the object
+ * @param count - number of members
+ *
+ * @return true if the number of members was set
+ */
+bool Channel_Reference_List_Member_Count_Set(
+    uint32_t object_instance, unsigned count)
+{
+    bool status = false;
+    struct object_data *pObject;
+
+    pObject = Keylist_Data(Object_List, object_instance);
+    if (pObject && (count <= CHANNEL_MEMBERS_LIMIT)) {
+        status = Channel_Members_Resize(pObject, count);
+    }
+
+    return status;
+}
+
 /**
  * For a given object instance-number, determines the Number
  *
@@ -1088,88 +1284,14 @@ bool Channel_Write_Member_Value(
 {
     bool status = false;
     int apdu_len = 0;
+    BACNET_APPLICATION_TAG tag;
 
     if (wp_data && value) {
-        if (((wp_data->object_type == OBJECT_ANALOG_INPUT) ||
-                (wp_data->object_type == OBJECT_ANALOG_OUTPUT) ||
-                (wp_data->object_type == OBJECT_ANALOG_VALUE)) &&
-            (wp_data->object_property == PROP_PRESENT_VALUE) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_REAL);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (((wp_data->object_type == OBJECT_BINARY_INPUT) ||
-                       (wp_data->object_type == OBJECT_BINARY_OUTPUT) ||
-                       (wp_data->object_type == OBJECT_BINARY_VALUE)) &&
-            (wp_data->object_property == PROP_PRESENT_VALUE) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
+        tag = Channel_Member_Coerce_Tag(wp_data->object_type,
+            wp_data->object_property, wp_data->array_index);
+        if (tag != MAX_BACNET_APPLICATION_TAG) {
             apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_ENUMERATED);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (((wp_data->object_type == OBJECT_MULTI_STATE_INPUT) ||
-                       (wp_data->object_type == OBJECT_MULTI_STATE_OUTPUT) ||
-                       (wp_data->object_type == OBJECT_MULTI_STATE_VALUE)) &&
-            (wp_data->object_property == PROP_PRESENT_VALUE) &&
-            (wp_data->array_index == BACNET_ARRAY_ALL)) {
-            apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_UNSIGNED_INT);
-            if (apdu_len != BACNET_STATUS_ERROR) {
-                wp_data->application_data_len = apdu_len;
-                status = true;
-            }
-        } else if (wp_data->object_type == OBJECT_LIGHTING_OUTPUT) {
-            if ((wp_data->object_property == PROP_PRESENT_VALUE) &&
-                (wp_data->array_index == BACNET_ARRAY_ALL)) {
-                apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                    wp_data->application_data_len, value,
-                    BACNET_APPLICATION_TAG_REAL);
-                if (apdu_len != BACNET_STATUS_ERROR) {
-                    wp_data->application_data_len = apdu_len;
-                    status = true;
-                }
-            } else if ((wp_data->object_property == PROP_LIGHTING_COMMAND) &&
-                (wp_data->array_index == BACNET_ARRAY_ALL)) {
-                apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                    wp_data->application_data_len, value,
-                    BACNET_APPLICATION_TAG_LIGHTING_COMMAND);
-                if (apdu_len != BACNET_STATUS_ERROR) {
-                    wp_data->application_data_len = apdu_len;
-                    status = true;
-                }
-            }
-        } else if (wp_data->object_type == OBJECT_COLOR) {
-            if ((wp_data->object_property == PROP_PRESENT_VALUE) &&
-                (wp_data->array_index == BACNET_ARRAY_ALL)) {
-                apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                    wp_data->application_data_len, value,
-                    BACNET_APPLICATION_TAG_XY_COLOR);
-                if (apdu_len != BACNET_STATUS_ERROR) {
-                    wp_data->application_data_len = apdu_len;
-                    status = true;
-                }
-            } else if ((wp_data->object_property == PROP_COLOR_COMMAND) &&
-                (wp_data->array_index == BACNET_ARRAY_ALL)) {
-                apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                    wp_data->application_data_len, value,
-                    BACNET_APPLICATION_TAG_COLOR_COMMAND);
-                if (apdu_len != BACNET_STATUS_ERROR) {
-                    wp_data->application_data_len = apdu_len;
-                    status = true;
-                }
-            }
-        } else if (wp_data->object_type == OBJECT_COLOR_TEMPERATURE) {
-            apdu_len = Channel_Coerce_Data_Encode(wp_data->application_data,
-                wp_data->application_data_len, value,
-                BACNET_APPLICATION_TAG_UNSIGNED_INT);
+                wp_data->application_data_len, value, tag);
             if (apdu_len != BACNET_STATUS_ERROR) {
                 wp_data->application_data_len = apdu_len;
                 status = true;
@@ -1180,9 +1302,56 @@ bool Channel_Write_Member_Value(
     return status;
 }
 
+/**
+ * @brief Get the WriteProperty function of the object of a member,
+ *  looked up once and kept until the member or the callbacks change
+ * @param pMember - member
+ * @return WriteProperty function, or NULL if there is none
+ */
+static write_property_function Channel_Member_Write_Function(
+    struct channel_member *pMember)
+{
+    if (!pMember->Write_Property) {
+        if (Write_Property_Lookup_Callback) {
+            pMember->Write_Property = Write_Property_Lookup_Callback(
+                pMember->Reference.objectIdentifier.type);
+        }
+        if (!pMember->Write_Property) {
+            pMember->Write_Property = Write_Property_Internal_Callback;
+        }
+    }
+
+    return pMember->Write_Property;
+}
+
+/**
+ * @brief Forget the WriteProperty functions of all of the members
+ */
+static void Channel_Member_Write_Functions_Clear(void)
+{
+    struct object_data *pObject;
+    int index, count;
+    unsigned m;
+
+    count = Keylist_Count(Object_List);
+    for (index = 0; index < count; index++) {
+        pObject = Keylist_Data_Index(Object_List, index);
+        if (pObject) {
+            for (m = 0; m < pObject->Members_Count; m++) {
+                pObject->Members[m]->Write_Property = NULL;
+            }
+        }
+    }
+}
+
 /**
  * For a given object instance-number, sets the present-value at a given
- * priority 1..16.
+ * priority 1..16.  The value is coerced once for each datatype of the
+ * members, and the encoding is reused for the following members that
+ * have the same datatype.  Each member is written with the WriteProperty
+ * function of its object when the lookup callback is set, so the Device
+ * object is not searched for every member, or else through the
+ * WriteProperty callback.
  *
  * @param pObject - object instance data
  * @param value - application value
@@ -1197,34 +1366,54 @@ static bool Channel_Write_Members(struct object_data *pObject,
     BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
     bool status = false;
     unsigned m = 0;
-    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember = NULL;
+    struct channel_member *pMember = NULL;
+    write_property_function write_property;
+    BACNET_APPLICATION_TAG encoded_tag = MAX_BACNET_APPLICATION_TAG;
+    int encoded_len = 0;
 
     if (pObject && value) {
         pObject->Write_Status = BACNET_WRITE_STATUS_IN_PROGRESS;
-        for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
-            pMember = &pObject->Members[m];
+        for (m = 0; m < pObject->Members_Count; m++) {
+            pMember = pObject->Members[m];
             /* NOTE: our implementation is for internal objects only */
             /* NOTE: we could check to match our Device ID, but then
                we would need to update all channels when our device ID
                changed.  Instead, we'll just screen when members are
                set. */
-            if ((pMember->deviceIdentifier.type == OBJECT_DEVICE) &&
-                (pMember->deviceIdentifier.instance != BACNET_MAX_INSTANCE) &&
-                (pMember->objectIdentifier.instance != BACNET_MAX_INSTANCE)) {
-                wp_data.object_type = pMember->objectIdentifier.type;
-                wp_data.object_instance = pMember->objectIdentifier.instance;
-                wp_data.object_property = pMember->propertyIdentifier;
-                wp_data.array_index = pMember->arrayIndex;
-                wp_data.priority = priority;
-                wp_data.application_data_len = sizeof(wp_data.application_data);
-                status = Channel_Write_Member_Value(&wp_data, value);
-                if (status) {
-                    if (Write_Property_Internal_Callback) {
-                        status = Write_Property_Internal_Callback(&wp_data);
-                    }
-                } else {
+            if ((pMember->Reference.deviceIdentifier.type != OBJECT_DEVICE) ||
+                !Channel_Reference_List_Member_Valid(&pMember->Reference)) {
+                continue;
+            }
+            if (pMember->Coerce_Tag == MAX_BACNET_APPLICATION_TAG) {
+                pObject->Write_Status = BACNET_WRITE_STATUS_FAILED;
+                continue;
+            }
+            if (pMember->Coerce_Tag != encoded_tag) {
+                /* the encoding stays in the WriteProperty data */
+                encoded_len = Channel_Coerce_Data_Encode(
+                    wp_data.application_data,
+                    sizeof(wp_data.application_data), value,
+                    pMember->Coerce_Tag);
+                if (encoded_len == BACNET_STATUS_ERROR) {
+                    /* the value can not be coerced to this datatype */
+                    encoded_tag = MAX_BACNET_APPLICATION_TAG;
+                    status = false;
                     pObject->Write_Status = BACNET_WRITE_STATUS_FAILED;
+                    continue;
                 }
+                encoded_tag = pMember->Coerce_Tag;
+            }
+            wp_data.object_type = pMember->Reference.objectIdentifier.type;
+            wp_data.object_instance =
+                pMember->Reference.objectIdentifier.instance;
+            wp_data.object_property = pMember->Reference.propertyIdentifier;
+            wp_data.array_index = pMember->Reference.arrayIndex;
+            wp_data.priority = priority;
+            wp_data.application_data_len = encoded_len;
+            status = true;
+            write_property = Channel_Member_Write_Function(pMember);
+            if (write_property) {
+                status = write_property(&wp_data);
             }
         }
         if (pObject->Write_Status == BACNET_WRITE_STATUS_IN_PROGRESS) {
@@ -1487,6 +1676,97 @@ int Channel_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     return apdu_len;
 }
 
+/**
+ * @brief Write the List_Of_Object_Property_References property.
+ *  Writing the whole array, or array element zero, changes the number
+ *  of members.
+ * @param wp_data - all of the WriteProperty data structure
+ * @return false if an error is loaded, true if no errors
+ */
+static bool Channel_Reference_List_Write(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    uint8_t *apdu = wp_data->application_data;
+    int apdu_size = wp_data->application_data_len;
+    int len = 0, apdu_len = 0;
+    unsigned count = 0, m = 0;
+
+    if (!Channel_Valid_Instance(wp_data->object_instance)) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    if (apdu_size < 0) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+    if (wp_data->array_index == 0) {
+        len = bacnet_unsigned_application_decode(
+            apdu, apdu_size, &unsigned_value);
+        if (len <= 0) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            return false;
+        }
+        if ((unsigned_value > CHANNEL_MEMBERS_LIMIT) ||
+            !Channel_Reference_List_Member_Count_Set(
+                wp_data->object_instance, (unsigned)unsigned_value)) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        return true;
+    }
+    if (wp_data->array_index == BACNET_ARRAY_ALL) {
+        /* validate every element before any member is changed;
+           an empty list removes every member */
+        while (apdu_len < apdu_size) {
+            len = bacnet_device_object_property_reference_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, &member);
+            if (len <= 0) {
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+                return false;
+            }
+            apdu_len += len;
+            count++;
+        }
+        if ((count > CHANNEL_MEMBERS_LIMIT) ||
+            !Channel_Reference_List_Member_Count_Set(
+                wp_data->object_instance, count)) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        apdu_len = 0;
+        for (m = 1; m <= count; m++) {
+            len = bacnet_device_object_property_reference_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, &member);
+            apdu_len += len;
+            (void)Channel_Reference_List_Member_Element_Set(
+                wp_data->object_instance, m, &member);
+        }
+        return true;
+    }
+    len = bacnet_device_object_property_reference_decode(
+        apdu, apdu_size, &member);
+    if (len <= 0) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return false;
+    }
+    if (!Channel_Reference_List_Member_Element_Set(
+            wp_data->object_instance, wp_data->array_index, &member)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * WriteProperty handler for this object.  For the given WriteProperty
  * data, the application_data is loaded or the error flags are set.
@@ -1504,6 +1784,10 @@ bool Channel_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     int element_len = 0;
     uint32_t count = 0;
 
+    if (wp_data->object_property == PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES) {
+        /* the references are not application tagged */
+        return Channel_Reference_List_Write(wp_data);
+    }
     /* decode the some of the request */
     len = bacapp_decode_application_data(
         wp_data->application_data, wp_data->application_data_len, &value);
@@ -1534,16 +1818,6 @@ bool Channel_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
                     wp_data->object_instance, value.type.Boolean);
             }
             break;
-        case PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES:
-            /* FIXME: add property handling */
-            /*            status = */
-            /*            Channel_List_Of_Object_Property_References_Set( */
-            /*                wp_data, */
-            /*                &value); */
-            wp_data->error_class = ERROR_CLASS_PROPERTY;
-            wp_data->error_code =
-                ERROR_CODE_OPTIONAL_FUNCTIONALITY_NOT_SUPPORTED;
-            break;
         case PROP_CHANNEL_NUMBER:
             status = write_property_type_valid(
                 wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
@@ -1636,6 +1910,20 @@ bool Channel_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 void Channel_Write_Property_Internal_Callback_Set(write_property_function cb)
 {
     Write_Property_Internal_Callback = cb;
+    Channel_Member_Write_Functions_Clear();
+}
+
+/**
+ * @brief Sets a callback that finds the WriteProperty function of an
+ *  object type, which is then used to write the members of that type
+ * @param cb - callback that returns the WriteProperty function, or NULL
+ *  to write every member through the WriteProperty callback
+ */
+void Channel_Write_Property_Lookup_Callback_Set(
+    channel_write_property_lookup_function cb)
+{
+    Write_Property_Lookup_Callback = cb;
+    Channel_Member_Write_Functions_Clear();
 }
 
 /**
@@ -1647,7 +1935,7 @@ uint32_t Channel_Create(uint32_t object_instance)
 {
     struct object_data *pObject = NULL;
     int index = 0;
-    unsigned m, g;
+    unsigned g;
 
     if (object_instance > BACNET_MAX_INSTANCE) {
         return BACNET_MAX_INSTANCE;
@@ -1669,16 +1957,12 @@ uint32_t Channel_Create(uint32_t object_instance)
             pObject->Out_Of_Service = false;
             pObject->Last_Priority = BACNET_NO_PRIORITY;
             pObject->Write_Status = BACNET_WRITE_STATUS_IDLE;
-            for (m = 0; m < CHANNEL_MEMBERS_MAX; m++) {
-                pObject->Members[m].objectIdentifier.type =
-                    OBJECT_LIGHTING_OUTPUT;
-                pObject->Members[m].objectIdentifier.instance =
-                    BACNET_MAX_INSTANCE;
-                pObject->Members[m].propertyIdentifier = PROP_PRESENT_VALUE;
-                pObject->Members[m].arrayIndex = BACNET_ARRAY_ALL;
-                pObject->Members[m].deviceIdentifier.type = OBJECT_DEVICE;
-                pObject->Members[m].deviceIdentifier.instance =
-                    BACNET_MAX_INSTANCE;
+            pObject->Members = NULL;
+            pObject->Members_Count = 0;
+            if (!Channel_Members_Resize(pObject, CHANNEL_MEMBERS_MAX)) {
+                (void)Channel_Members_Resize(pObject, 0);
+                free(pObject);
+                return BACNET_MAX_INSTANCE;
             }
             pObject->Number = 0;
             for (g = 0; g < CONTROL_GROUPS_MAX; g++) {
@@ -1687,6 +1971,7 @@ uint32_t Channel_Create(uint32_t object_instance)
             /* add to list */
             index = Keylist_Data_Add(Object_List, object_instance, pObject);
             if (index < 0) {
+                (void)Channel_Members_Resize(pObject, 0);
                 free(pObject);
                 return BACNET_MAX_INSTANCE;
             }
@@ -1710,6 +1995,7 @@ bool Channel_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        (void)Channel_Members_Resize(pObject, 0);
         free(pObject);
         status = true;
     }
@@ -1728,6 +2014,7 @@ void Channel_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
+                (void)Channel_Members_Resize(pObject, 0);
                 free(pObject);
             }
         } while (pObject);
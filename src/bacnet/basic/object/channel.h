@@ -98,6 +98,14 @@ typedef struct BACnet_Channel_Value_t {
     struct BACnet_Channel_Value_t *next;
 } BACNET_CHANNEL_VALUE;
 
+/**
+ * @brief Finds the WriteProperty function of an object type
+ * @param object_type - object type of a member
+ * @return WriteProperty function, or NULL if the type is not supported
+ */
+typedef write_property_function (*channel_write_property_lookup_function)(
+    BACNET_OBJECT_TYPE object_type);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -158,6 +166,9 @@ BACNET_STACK_EXPORT
 unsigned Channel_Reference_List_Member_Element_Add(uint32_t object_instance,
     BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMemberSrc);
 BACNET_STACK_EXPORT
+bool Channel_Reference_List_Member_Count_Set(
+    uint32_t object_instance, unsigned count);
+BACNET_STACK_EXPORT
 uint16_t Channel_Control_Groups_Element(
     uint32_t object_instance, int32_t array_index);
 BACNET_STACK_EXPORT
@@ -181,6 +192,9 @@ bool Channel_Write_Member_Value(
 BACNET_STACK_EXPORT
 void Channel_Write_Property_Internal_Callback_Set(
     write_property_function cb);
+BACNET_STACK_EXPORT
+void Channel_Write_Property_Lookup_Callback_Set(
+    channel_write_property_lookup_function cb);
 
 BACNET_STACK_EXPORT
 uint32_t Channel_Create(uint32_t object_instance);
@@ -8,6 +8,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -309,7 +310,8 @@ static object_functions_t My_Object_Table[] = {
         NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */, NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
-        Lighting_Output_Create, Lighting_Output_Delete, Lighting_Output_Timer },
+        Lighting_Output_Create, Lighting_Output_Delete,
+        NULL /* Timer: see Device_Timer() */ },
     { OBJECT_CHANNEL, Channel_Init, Channel_Count, Channel_Index_To_Instance,
         Channel_Valid_Instance, Channel_Object_Name, Channel_Read_Property,
         Channel_Write_Property, Channel_Property_Lists,
@@ -366,12 +368,13 @@ static object_functions_t My_Object_Table[] = {
         NULL /* Value_Lists */, NULL /* COV */, NULL /* COV Clear */,
         NULL /* Intrinsic Reporting */, NULL /* Add_List_Element */,
         NULL /* Remove_List_Element */, NULL /* Create */, NULL /* Delete */,
-        NULL /* Timer */ },
+        Schedule_Timer },
     { OBJECT_STRUCTURED_VIEW, Structured_View_Init, Structured_View_Count,
         Structured_View_Index_To_Instance, Structured_View_Valid_Instance,
         Structured_View_Object_Name, Structured_View_Read_Property,
         NULL /* Write_Property */, Structured_View_Property_Lists,
-        NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
+        Structured_View_Read_Range_Info, NULL /* Iterator */,
+        NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */,  NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
         Structured_View_Create, Structured_View_Delete, NULL /* Timer */ },
@@ -394,6 +397,23 @@ static object_functions_t My_Object_Table[] = {
 };
 /* clang-format on */
 
+/**
+ * @brief Get the table of objects of the Device that is addressed
+ * @return table of objects of the routed Device, if it has its own table,
+ *  or else the table of objects of this Device
+ */
+static struct object_functions *Device_Object_Table(void)
+{
+#ifdef BAC_ROUTING
+    struct object_functions *pObject = Routed_Device_Object_Table();
+
+    if (pObject) {
+        return pObject;
+    }
+#endif
+    return Object_Table;
+}
+
 /** Glue function to let the Device object, when called by a handler,
  * lookup which Object type needs to be invoked.
  * @ingroup ObjHelpers
@@ -407,7 +427,7 @@ static struct object_functions *Device_Objects_Find_Functions(
 {
     struct object_functions *pObject = NULL;
 
-    pObject = Object_Table;
+    pObject = Device_Object_Table();
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         /* handle each object type */
         if (pObject->Object_Type == Object_Type) {
@@ -438,6 +458,26 @@ rr_info_function Device_Objects_RR_Info(BACNET_OBJECT_TYPE object_type)
     return (pObject != NULL ? pObject->Object_RR_Info : NULL);
 }
 
+/** Try to find the WriteProperty function of an object type, which a
+ * Channel calls directly for each of its members of that type.
+ * Unlike Device_Write_Property(), the function does not check the
+ * object instance first, and the write is not given to the
+ * Device_Write_Property_Store_Callback_Set() callback.
+ * @ingroup ObjIntf
+ *
+ * @param object_type [in] The type of BACnet Object
+ * @return Pointer to the Object_Write_Property function of this type of
+ *         Object, or NULL if the type is not supported or not writable.
+ */
+write_property_function Device_Objects_Write_Property(
+    BACNET_OBJECT_TYPE object_type)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Objects_Find_Functions(object_type);
+    return (pObject != NULL ? pObject->Object_Write_Property : NULL);
+}
+
 /** For a given object type, returns the special property list.
  * This function is used for ReadPropertyMultiple calls which want
  * just Required, just Optional, or All properties.
@@ -507,6 +547,7 @@ static const int Device_Properties_Optional[] = {
 #endif
     PROP_DESCRIPTION, PROP_LOCAL_TIME, PROP_UTC_OFFSET, PROP_LOCAL_DATE,
     PROP_DAYLIGHT_SAVINGS_STATUS, PROP_LOCATION, PROP_ACTIVE_COV_SUBSCRIPTIONS,
+    PROP_ACTIVE_COV_MULTIPLE_SUBSCRIPTIONS,
 #if defined(BACNET_TIME_MASTER)
     PROP_TIME_SYNCHRONIZATION_RECIPIENTS, PROP_TIME_SYNCHRONIZATION_INTERVAL,
     PROP_ALIGN_INTERVALS, PROP_INTERVAL_OFFSET,
@@ -578,6 +619,23 @@ static uint32_t Interval_Offset_Minutes;
 /* Max_Info_Frames - rely on MS/TP subsystem, if there is one */
 /* Device_Address_Binding - required, but relies on binding cache */
 static uint32_t Database_Revision = 0;
+/* contiguous copy of the Object_List */
+struct object_list_cache_entry {
+    BACNET_OBJECT_ID id;
+    /* index of the object within its object type */
+    unsigned object_index;
+};
+static struct {
+    struct object_list_cache_entry *list;
+    unsigned size;
+    unsigned count;
+    /* number of objects of each object type in the table */
+    unsigned *type_count;
+    unsigned type_size;
+    uint32_t revision;
+    struct object_functions *table;
+    bool valid;
+} Object_List_Cache;
 /* Configuration_Files */
 /* Last_Restore_Time */
 /* Backup_Failure_Timeout */
@@ -980,7 +1038,7 @@ unsigned Device_Object_List_Count(void)
     struct object_functions *pObject = NULL;
 
     /* initialize the default return values */
-    pObject = Object_Table;
+    pObject = Device_Object_Table();
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
             count += pObject->Object_Count();
@@ -991,17 +1049,16 @@ unsigned Device_Object_List_Count(void)
     return count;
 }
 
-/** Lookup the Object at the given array index in the Device's Object List.
- * Even though we don't keep a single linear array of objects in the Device,
- * this method acts as though we do and works through a virtual, concatenated
- * array of all of our object type arrays.
+/** Lookup the Object at the given array index in the Device's Object List,
+ * by working through a virtual, concatenated array of all of our object
+ * type arrays.
  *
  * @param array_index [in] The desired array index (1 to N)
  * @param object_type [out] The object's type, if found.
  * @param instance [out] The object's instance number, if found.
  * @return True if found, else false.
  */
-bool Device_Object_List_Identifier(
+static bool Device_Object_List_Walk(
     uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
 {
     bool status = false;
@@ -1016,7 +1073,7 @@ bool Device_Object_List_Identifier(
     }
     object_index = array_index - 1;
     /* initialize the default return values */
-    pObject = Object_Table;
+    pObject = Device_Object_Table();
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
         if (pObject->Object_Count) {
             object_index -= count;
@@ -1050,6 +1107,184 @@ bool Device_Object_List_Identifier(
     return status;
 }
 
+/**
+ * @brief Rebuild the cached copy of the Object_List, when the database
+ *  revision or the number of objects of any object type has changed
+ *  since it was built.  Objects may be created and deleted directly,
+ *  without a change of the database revision, so the entries read from
+ *  the cache are also checked with Device_Object_List_Cache_Entry().
+ * @return true if the cache is valid
+ */
+static bool Device_Object_List_Cache_Update(void)
+{
+    struct object_functions *pObject = NULL;
+    struct object_list_cache_entry *list;
+    unsigned *type_count;
+    unsigned count = 0, type_index = 0;
+    unsigned type_objects, i, index = 0;
+    unsigned object_index;
+    bool changed;
+
+    changed = !Object_List_Cache.valid ||
+        (Object_List_Cache.revision != Database_Revision) ||
+        (Object_List_Cache.table != Device_Object_Table());
+    pObject = Device_Object_Table();
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        type_objects = 0;
+        if (pObject->Object_Count) {
+            type_objects = pObject->Object_Count();
+        }
+        if ((type_index >= Object_List_Cache.type_size) ||
+            (Object_List_Cache.type_count[type_index] != type_objects)) {
+            changed = true;
+        }
+        count += type_objects;
+        type_index++;
+        pObject++;
+    }
+    if (type_index != Object_List_Cache.type_size) {
+        changed = true;
+    }
+    if (!changed) {
+        return true;
+    }
+    Object_List_Cache.valid = false;
+    if (type_index > Object_List_Cache.type_size) {
+        type_count = realloc(
+            Object_List_Cache.type_count, type_index * sizeof(*type_count));
+        if (!type_count) {
+            return false;
+        }
+        Object_List_Cache.type_count = type_count;
+    }
+    Object_List_Cache.type_size = type_index;
+    if (count > Object_List_Cache.size) {
+        list = realloc(Object_List_Cache.list, count * sizeof(*list));
+        if (!list) {
+            return false;
+        }
+        Object_List_Cache.list = list;
+        Object_List_Cache.size = count;
+    }
+    type_index = 0;
+    pObject = Device_Object_Table();
+    while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
+        type_objects = 0;
+        if (pObject->Object_Count) {
+            type_objects = pObject->Object_Count();
+        }
+        if (type_objects && !pObject->Object_Index_To_Instance) {
+            return false;
+        }
+        if (type_objects) {
+            object_index = 0;
+            if (pObject->Object_Iterator && type_objects) {
+                object_index = pObject->Object_Iterator(~(unsigned)0);
+            }
+            for (i = 0; i < type_objects; i++) {
+                if (index >= count) {
+                    return false;
+                }
+                if (pObject->Object_Iterator) {
+                    if (i > 0) {
+                        object_index = pObject->Object_Iterator(object_index);
+                    }
+                } else {
+                    object_index = i;
+                }
+                Object_List_Cache.list[index].id.type = pObject->Object_Type;
+                Object_List_Cache.list[index].id.instance =
+                    pObject->Object_Index_To_Instance(object_index);
+                Object_List_Cache.list[index].object_index = object_index;
+                index++;
+            }
+        }
+        Object_List_Cache.type_count[type_index] = type_objects;
+        type_index++;
+        pObject++;
+    }
+    if (index != count) {
+        return false;
+    }
+    Object_List_Cache.count = count;
+    Object_List_Cache.revision = Database_Revision;
+    Object_List_Cache.table = Device_Object_Table();
+    Object_List_Cache.valid = true;
+
+    return true;
+}
+
+/**
+ * @brief Check that an entry of the cached Object_List is still the
+ *  object at its index within its object type.  An object created and
+ *  another deleted directly, without Device_Create_Object() or
+ *  Device_Delete_Object(), leave the number of objects unchanged but
+ *  move the objects after them.
+ * @param entry - entry of the cached Object_List
+ * @return true if the entry is current
+ */
+static bool Device_Object_List_Cache_Entry(
+    const struct object_list_cache_entry *entry)
+{
+    struct object_functions *pObject = NULL;
+
+    pObject = Device_Objects_Find_Functions(entry->id.type);
+    if (!pObject || !pObject->Object_Index_To_Instance) {
+        return false;
+    }
+
+    return pObject->Object_Index_To_Instance(entry->object_index) ==
+        entry->id.instance;
+}
+
+/** Lookup the Object at the given array index in the Device's Object List.
+ * Even though we don't keep a single linear array of objects in the Device,
+ * this method acts as though we do: a contiguous copy of the concatenated
+ * object type arrays is kept, and rebuilt when the Database_Revision or
+ * the number of objects of a type changes, or when the element read is
+ * no longer the object at its place, so that the Object_List can be read
+ * element by element, or by ReadRange, without walking all of the
+ * object types for each element.  The routed Devices of a gateway share
+ * the copy, so the Device object itself is looked up when it is read.
+ *
+ * @param array_index [in] The desired array index (1 to N)
+ * @param object_type [out] The object's type, if found.
+ * @param instance [out] The object's instance number, if found.
+ * @return True if found, else false.
+ */
+bool Device_Object_List_Identifier(
+    uint32_t array_index, BACNET_OBJECT_TYPE *object_type, uint32_t *instance)
+{
+    const struct object_list_cache_entry *entry;
+
+    /* array index zero is length - so invalid */
+    if (array_index == 0) {
+        return false;
+    }
+    if (!Device_Object_List_Cache_Update() ||
+        (array_index > Object_List_Cache.count)) {
+        return Device_Object_List_Walk(array_index, object_type, instance);
+    }
+    entry = &Object_List_Cache.list[array_index - 1];
+    if (!Device_Object_List_Cache_Entry(entry)) {
+        /* the objects changed in place - build the copy again */
+        Object_List_Cache.valid = false;
+        if (!Device_Object_List_Cache_Update()) {
+            return Device_Object_List_Walk(array_index, object_type, instance);
+        }
+        entry = &Object_List_Cache.list[array_index - 1];
+    }
+    *object_type = entry->id.type;
+    *instance = entry->id.instance;
+#ifdef BAC_ROUTING
+    if (*object_type == OBJECT_DEVICE) {
+        *instance = Device_Object_Instance_Number();
+    }
+#endif
+
+    return true;
+}
+
 /**
  * @brief Encode a BACnetARRAY property element
  * @param object_instance [in] BACnet network port object instance number
@@ -1385,7 +1620,7 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
             }
             /* set the object types with objects to supported */
 
-            pObject = Object_Table;
+            pObject = Device_Object_Table();
             while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
                 if ((pObject->Object_Count) && (pObject->Object_Count() > 0)) {
                     bitstring_set_bit(
@@ -1462,6 +1697,10 @@ int Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
             apdu_len = handler_cov_encode_subscriptions(&apdu[0], apdu_max);
             break;
+        case PROP_ACTIVE_COV_MULTIPLE_SUBSCRIPTIONS:
+            apdu_len =
+                handler_cov_encode_multiple_subscriptions(&apdu[0], apdu_max);
+            break;
         default:
             rpdata->error_class = ERROR_CLASS_PROPERTY;
             rpdata->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
@@ -1817,6 +2056,7 @@ bool Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
         case PROP_DEVICE_ADDRESS_BINDING:
         case PROP_DATABASE_REVISION:
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
+        case PROP_ACTIVE_COV_MULTIPLE_SUBSCRIPTIONS:
 #if defined(BACNET_TIME_MASTER)
         case PROP_TIME_SYNCHRONIZATION_RECIPIENTS:
 #endif
@@ -1899,6 +2139,20 @@ static bool Device_Write_Property_Object_Name(
     return status;
 }
 
+/* called after a property is written, to make the value persistent */
+static write_property_function Write_Property_Store_Callback;
+
+/**
+ * @brief Set the function that is called after each property that is
+ *  written successfully, for example to journal the value so that it
+ *  persists across a restart.
+ * @param cb - function to call, or NULL to not call any function
+ */
+void Device_Write_Property_Store_Callback_Set(write_property_function cb)
+{
+    Write_Property_Store_Callback = cb;
+}
+
 /** Looks up the requested Object and Property, and set the new Value in it,
  *  if allowed.
  * If the Object or Property can't be found, sets the error class and code.
@@ -1946,10 +2200,64 @@ bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
         wp_data->error_class = ERROR_CLASS_OBJECT;
         wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
     }
+    if (status && Write_Property_Store_Callback) {
+        (void)Write_Property_Store_Callback(wp_data);
+    }
 
     return (status);
 }
 
+/**
+ * @brief Check a property write without applying it.  The object must
+ *  exist and be writable, and the property must be in its property list.
+ *  WritePropertyMultiple uses this to reject a request before any of
+ *  its properties are written.  The value is not checked: a wrong
+ *  datatype or a value out of range is only found by
+ *  Device_Write_Property().
+ * @param wp_data [in,out] Structure with the desired Object and Property
+ *  info on entry, and the error class and code on return.
+ * @return True if the property write can be attempted
+ */
+bool Device_Write_Property_Check(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    struct object_functions *pObject = NULL;
+    struct special_property_list_t property_list = { 0 };
+
+    pObject = Device_Objects_Find_Functions(wp_data->object_type);
+    if ((pObject == NULL) || !pObject->Object_Valid_Instance ||
+        !pObject->Object_Valid_Instance(wp_data->object_instance)) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    if (!pObject->Object_Write_Property) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+#if (BACNET_PROTOCOL_REVISION >= 14)
+    if (wp_data->object_property == PROP_PROPERTY_LIST) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    }
+#endif
+    if (pObject->Object_RPM_List &&
+        !property_list_common(wp_data->object_property)) {
+        Device_Objects_Property_List(
+            wp_data->object_type, wp_data->object_instance, &property_list);
+        if (!property_lists_member(property_list.Required.pList,
+                property_list.Optional.pList, property_list.Proprietary.pList,
+                wp_data->object_property)) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /**
  * @brief AddListElement from an object list property
  * @param list_element [in] Pointer to the BACnet_List_Element_Data structure,
@@ -2269,7 +2577,23 @@ void Device_Init(object_functions_t *object_table)
     }
 #if (BACNET_PROTOCOL_REVISION >= 14)
     Channel_Write_Property_Internal_Callback_Set(Device_Write_Property);
+    Channel_Write_Property_Lookup_Callback_Set(Device_Objects_Write_Property);
 #endif
+    Schedule_Write_Property_Internal_Callback_Set(Device_Write_Property);
+    Schedule_Calendar_Callback_Set(Calendar_Date_Active);
+}
+
+/**
+ * @brief Encode the Object_List elements requested by a ReadRange
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @return number of bytes encoded, or a negative value on error
+ */
+static int Device_Object_List_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    return rr_array_encode(apdu, pRequest, Device_Object_List_Count(),
+        Device_Object_List_Element_Encode);
 }
 
 bool DeviceGetRRInfo(BACNET_READ_RANGE_DATA *pRequest, /* Info on the request */
@@ -2301,6 +2625,12 @@ bool DeviceGetRRInfo(BACNET_READ_RANGE_DATA *pRequest, /* Info on the request */
             status = true;
             break;
 
+        case PROP_OBJECT_LIST:
+            pInfo->RequestTypes = RR_BY_POSITION;
+            pInfo->Handler = Device_Object_List_Read_Range;
+            status = true;
+            break;
+
         case PROP_ACTIVE_COV_SUBSCRIPTIONS:
             pInfo->RequestTypes = RR_BY_POSITION;
             pRequest->error_class = ERROR_CLASS_PROPERTY;
@@ -2335,19 +2665,22 @@ void Device_Timer(uint16_t milliseconds)
 
     pObject = Object_Table;
     while (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE) {
-        if (pObject->Object_Count) {
+        count = 0;
+        if ((pObject->Object_Timer) && (pObject->Object_Index_To_Instance) &&
+            (pObject->Object_Count)) {
             count = pObject->Object_Count();
         }
         while (count) {
             count--;
-            if ((pObject->Object_Timer) &&
-                (pObject->Object_Index_To_Instance)) {
-                instance = pObject->Object_Index_To_Instance(count);
-                pObject->Object_Timer(instance, milliseconds);
-            }
+            instance = pObject->Object_Index_To_Instance(count);
+            pObject->Object_Timer(instance, milliseconds);
         }
         pObject++;
     }
+#if (BACNET_PROTOCOL_REVISION >= 14)
+    /* only the Lighting Output objects with a transition in progress */
+    Lighting_Output_Active_Timer(milliseconds);
+#endif
 }
 
 #ifdef BAC_ROUTING
@@ -169,6 +169,13 @@ typedef struct object_functions {
 #define MAX_DEV_VER_LEN  16
 #define MAX_DEV_DESC_LEN 64
 
+/* number of I-Am sent by each call to Routed_Device_I_Am_Task().  The
+   Who-Is handlers for routing send one batch, and a gateway with more
+   Devices must call Routed_Device_I_Am_Task() from its main loop. */
+#ifndef ROUTED_DEVICE_I_AM_BATCH
+#define ROUTED_DEVICE_I_AM_BATCH 16
+#endif
+
 /** Structure to define the Object Properties common to all Objects. */
 typedef struct commonBacObj_s {
 
@@ -240,6 +247,9 @@ extern "C" {
     BACNET_STACK_EXPORT
     rr_info_function Device_Objects_RR_Info(
         BACNET_OBJECT_TYPE object_type);
+    BACNET_STACK_EXPORT
+    write_property_function Device_Objects_Write_Property(
+        BACNET_OBJECT_TYPE object_type);
 
     BACNET_STACK_EXPORT
     void Device_getCurrentDateTime(
@@ -451,6 +461,12 @@ extern "C" {
     BACNET_STACK_EXPORT
     bool Device_Write_Property(
         BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    bool Device_Write_Property_Check(
+        BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    void Device_Write_Property_Store_Callback_Set(
+        write_property_function cb);
 
     BACNET_STACK_EXPORT
     int Device_Add_List_Element(
@@ -497,6 +513,30 @@ extern "C" {
     BACNET_STACK_EXPORT
     BACNET_ADDRESS *Get_Routed_Device_Address(
         int idx);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Set_Address(
+        BACNET_ADDRESS * address);
+    BACNET_STACK_EXPORT
+    uint16_t Routed_Device_Count(
+        void);
+    BACNET_STACK_EXPORT
+    void Routed_Device_Cleanup(
+        void);
+    BACNET_STACK_EXPORT
+    bool Routed_Device_Set_Object_Table(
+        object_functions_t * object_table);
+    BACNET_STACK_EXPORT
+    object_functions_t *Routed_Device_Object_Table(
+        void);
+    BACNET_STACK_EXPORT
+    void Routed_Device_I_Am_Request(
+        uint32_t low_limit,
+        uint32_t high_limit,
+        BACNET_ADDRESS * dest);
+    /* required in the main loop of a gateway: sends the queued I-Am */
+    BACNET_STACK_EXPORT
+    unsigned Routed_Device_I_Am_Task(
+        unsigned max_count);
 
     BACNET_STACK_EXPORT
     bool Routed_Device_Address_Lookup(
@@ -9,6 +9,7 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
@@ -22,6 +23,7 @@
 #include "bacnet/reject.h"
 #include "bacnet/version.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/binding/address.h"
 /* include the objects */
@@ -41,6 +43,7 @@
 #include "bacnet/basic/object/bacfile.h" /* object list dependency */
 #endif
 /* os specific includes */
+#include "bacnet/basic/sys/keylist.h"
 #include "bacnet/basic/sys/mstimer.h"
 
 /* forward prototypes */
@@ -63,10 +66,48 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data);
  * and extending the regular Device Object functionality.
  ****************************************************************************/
 
-/** Model the gateway as the main Device, with (two) remote
- * Devices that are reached via its routing capabilities.
+/** A Device in the table of Devices, with its place in the indexes */
+struct routed_device {
+    /** Device Object descriptive data */
+    DEVICE_OBJECT_DATA Device;
+    /** optional table of objects in this Device, or NULL for the table of
+     * the gateway Device */
+    object_functions_t *Object_Table;
+    /** where the I-Am is sent, when unicast */
+    BACNET_ADDRESS I_Am_Dest;
+    /** index of this Device in the table of Devices */
+    uint16_t Index;
+    /** key of the MAC address in the MAC address index */
+    KEY MAC_Key;
+    /** next Device whose MAC address has the same key */
+    struct routed_device *MAC_Next;
+    /** true if this Device is in the MAC address index */
+    bool MAC_Indexed : 1;
+    /** true if an I-Am is waiting to be sent for this Device */
+    bool I_Am_Pending : 1;
+    /** true if the waiting I-Am is sent to I_Am_Dest */
+    bool I_Am_Unicast : 1;
+};
+
+/** Model the gateway as the main Device, with remote Devices that are
+ * reached via its routing capabilities.  The table of Devices grows as
+ * Devices are added, and each Device is allocated once so that the indexes
+ * may keep pointers to it.
  */
-DEVICE_OBJECT_DATA Devices[MAX_NUM_DEVICES];
+static struct routed_device **Devices;
+/** number of Devices that the table can hold before it grows */
+static uint16_t Devices_Size;
+/** index of the Devices, by Device object instance number */
+static OS_Keylist Device_Instance_List;
+/** index of the routed Devices, by hash of the virtual MAC address, with
+ * the Devices whose MAC addresses have the same hash chained together */
+static OS_Keylist Device_MAC_List;
+/** number of Devices with an I-Am waiting to be sent */
+static unsigned I_Am_Pending_Count;
+/** where the search for the next waiting I-Am starts */
+static uint16_t I_Am_Cursor;
+/** Device Object data used before any Device has been added */
+static DEVICE_OBJECT_DATA Device_Empty;
 /** Keep track of the number of managed devices, including the gateway */
 uint16_t Num_Managed_Devices = 0;
 /** Which Device entry are we currently managing.
@@ -80,42 +121,268 @@ uint16_t iCurrent_Device_Idx = 0;
  * found in device.c
  */
 
+/**
+ * @brief Get the Device Object data of the currently active Device
+ * @return Device Object data of the current Device
+ */
+static DEVICE_OBJECT_DATA *Routed_Device_Current(void)
+{
+    if (iCurrent_Device_Idx < Num_Managed_Devices) {
+        return &Devices[iCurrent_Device_Idx]->Device;
+    }
+
+    return &Device_Empty;
+}
+
+/**
+ * @brief Compute the key of a MAC address for the MAC address index,
+ *  using the FNV-1a hash of the length and the octets of the address.
+ * @param mac_len - number of octets in the MAC address
+ * @param mac - MAC address
+ * @return key for the MAC address index
+ */
+static KEY Routed_Device_MAC_Key(uint8_t mac_len, const uint8_t *mac)
+{
+    uint32_t hash = 2166136261UL;
+    uint8_t i;
+
+    hash ^= mac_len;
+    hash *= 16777619UL;
+    for (i = 0; i < mac_len; i++) {
+        hash ^= mac[i];
+        hash *= 16777619UL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief Remove a routed Device from the MAC address index
+ * @param pDev - routed Device
+ */
+static void Routed_Device_MAC_Remove(struct routed_device *pDev)
+{
+    struct routed_device *pHead;
+    struct routed_device *pPrev;
+
+    if (!pDev->MAC_Indexed) {
+        return;
+    }
+    pHead = Keylist_Data(Device_MAC_List, pDev->MAC_Key);
+    if (pHead == pDev) {
+        (void)Keylist_Data_Delete(Device_MAC_List, pDev->MAC_Key);
+        if (pDev->MAC_Next) {
+            (void)Keylist_Data_Add(
+                Device_MAC_List, pDev->MAC_Key, pDev->MAC_Next);
+        }
+    } else {
+        for (pPrev = pHead; pPrev; pPrev = pPrev->MAC_Next) {
+            if (pPrev->MAC_Next == pDev) {
+                pPrev->MAC_Next = pDev->MAC_Next;
+                break;
+            }
+        }
+    }
+    pDev->MAC_Next = NULL;
+    pDev->MAC_Indexed = false;
+}
+
+/**
+ * @brief Add a routed Device to the MAC address index.  A Device whose
+ *  key is already used by another Device is chained after that Device.
+ * @param pDev - routed Device
+ */
+static void Routed_Device_MAC_Add(struct routed_device *pDev)
+{
+    struct routed_device *pHead;
+    KEY key;
+
+    Routed_Device_MAC_Remove(pDev);
+    if ((pDev->Index == 0) || (pDev->Device.bacDevAddr.len == 0)) {
+        /* the gateway Device is not on the virtual network */
+        return;
+    }
+    key = Routed_Device_MAC_Key(
+        pDev->Device.bacDevAddr.len, pDev->Device.bacDevAddr.adr);
+    pHead = Keylist_Data(Device_MAC_List, key);
+    if (pHead) {
+        pDev->MAC_Next = pHead->MAC_Next;
+        pHead->MAC_Next = pDev;
+    } else if (Keylist_Data_Add(Device_MAC_List, key, pDev) < 0) {
+        return;
+    }
+    pDev->MAC_Key = key;
+    pDev->MAC_Indexed = true;
+}
+
+/**
+ * @brief Determine if a routed Device has the given MAC address
+ * @param pDev - routed Device
+ * @param mac_len - number of octets in the MAC address
+ * @param mac - MAC address
+ * @return true if the MAC address matches
+ */
+static bool Routed_Device_MAC_Match(
+    const struct routed_device *pDev, uint8_t mac_len, const uint8_t *mac)
+{
+    return (pDev->Device.bacDevAddr.len == mac_len) &&
+        (memcmp(pDev->Device.bacDevAddr.adr, mac, mac_len) == 0);
+}
+
+/**
+ * @brief Find the routed Device at the given MAC address, comparing the
+ *  whole MAC address of each Device whose key matches.  An address that
+ *  was changed without Routed_Device_Set_Address() is not found.
+ * @param mac_len - number of octets in the MAC address
+ * @param mac - MAC address
+ * @return index of the routed Device, or -1 if not found
+ */
+static int Routed_Device_MAC_Find(uint8_t mac_len, const uint8_t *mac)
+{
+    struct routed_device *pDev;
+
+    pDev = Keylist_Data(Device_MAC_List, Routed_Device_MAC_Key(mac_len, mac));
+    while (pDev) {
+        if (Routed_Device_MAC_Match(pDev, mac_len, mac)) {
+            return pDev->Index;
+        }
+        pDev = pDev->MAC_Next;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Make room in the table of Devices for one more Device
+ * @return true if there is room
+ */
+static bool Routed_Device_Table_Grow(void)
+{
+    struct routed_device **table;
+    unsigned size;
+
+    if (Num_Managed_Devices < Devices_Size) {
+        return true;
+    }
+    if (Num_Managed_Devices >= (UINT16_MAX - 1)) {
+        return false;
+    }
+    size = Devices_Size ? (Devices_Size * 2U) : MAX_NUM_DEVICES;
+    if (size > (UINT16_MAX - 1)) {
+        size = UINT16_MAX - 1;
+    }
+    table = realloc(Devices, size * sizeof(*Devices));
+    if (!table) {
+        return false;
+    }
+    Devices = table;
+    Devices_Size = (uint16_t)size;
+
+    return true;
+}
+
 /** Add a Device to our table of Devices[].
  * The first entry must be the gateway device.
  * @param Object_Instance [in] Set the new Device to this instance number.
  * @param sObject_Name [in] Use this Object Name for the Device.
  * @param sDescription [in] Set this Description for the Device.
  * @return The index of this instance in the Devices[] array, or UINT16_MAX if
- *         there isn't enough room to add this Device.
+ *         there isn't enough room to add this Device, or if a Device with
+ *         this instance number has already been added.
  */
 uint16_t Add_Routed_Device(uint32_t Object_Instance,
     BACNET_CHARACTER_STRING *sObject_Name,
     const char *sDescription)
 {
-    int i = Num_Managed_Devices;
-    if (i < MAX_NUM_DEVICES) {
-        DEVICE_OBJECT_DATA *pDev = &Devices[i];
-        Num_Managed_Devices++;
-        iCurrent_Device_Idx = i;
-        pDev->bacObj.mObject_Type = OBJECT_DEVICE;
-        pDev->bacObj.Object_Instance_Number = Object_Instance;
-        if (sObject_Name != NULL) {
-            Routed_Device_Set_Object_Name(sObject_Name->encoding,
-                sObject_Name->value, sObject_Name->length);
-        } else {
-            Routed_Device_Set_Object_Name(
-                CHARACTER_UTF8, "No Name", strlen("No Name"));
-        }
-        if (sDescription != NULL) {
-            Routed_Device_Set_Description(sDescription, strlen(sDescription));
-        } else {
-            Routed_Device_Set_Description("No Descr", strlen("No Descr"));
+    struct routed_device *pRouted;
+    DEVICE_OBJECT_DATA *pDev;
+    uint16_t i = Num_Managed_Devices;
+
+    if (!Device_Instance_List) {
+        Device_Instance_List = Keylist_Create();
+        Device_MAC_List = Keylist_Create();
+        if (!Device_Instance_List || !Device_MAC_List) {
+            return UINT16_MAX;
         }
-        pDev->Database_Revision = 0; /* Reset/Initialize now */
-        return i;
-    } else {
+    }
+    if (Keylist_Data(Device_Instance_List, Object_Instance)) {
+        return UINT16_MAX;
+    }
+    if (!Routed_Device_Table_Grow()) {
         return UINT16_MAX;
     }
+    pRouted = calloc(1, sizeof(struct routed_device));
+    if (!pRouted) {
+        return UINT16_MAX;
+    }
+    if (Keylist_Data_Add(Device_Instance_List, Object_Instance, pRouted) < 0) {
+        free(pRouted);
+        return UINT16_MAX;
+    }
+    pRouted->Index = i;
+    Devices[i] = pRouted;
+    Num_Managed_Devices++;
+    iCurrent_Device_Idx = i;
+    pDev = &pRouted->Device;
+    pDev->bacObj.mObject_Type = OBJECT_DEVICE;
+    pDev->bacObj.Object_Instance_Number = Object_Instance;
+    if (sObject_Name != NULL) {
+        Routed_Device_Set_Object_Name(
+            sObject_Name->encoding, sObject_Name->value, sObject_Name->length);
+    } else {
+        Routed_Device_Set_Object_Name(
+            CHARACTER_UTF8, "No Name", strlen("No Name"));
+    }
+    if (sDescription != NULL) {
+        Routed_Device_Set_Description(sDescription, strlen(sDescription));
+    } else {
+        Routed_Device_Set_Description("No Descr", strlen("No Descr"));
+    }
+    pDev->Database_Revision = 0; /* Reset/Initialize now */
+
+    return i;
+}
+
+/**
+ * @brief Get the number of Devices in the table, including the gateway
+ * @return number of Devices
+ */
+uint16_t Routed_Device_Count(void)
+{
+    return Num_Managed_Devices;
+}
+
+/**
+ * @brief Remove every Device from the table, and free the memory
+ */
+void Routed_Device_Cleanup(void)
+{
+    uint16_t i;
+
+    for (i = 0; i < Num_Managed_Devices; i++) {
+        free(Devices[i]);
+    }
+    free(Devices);
+    Devices = NULL;
+    Devices_Size = 0;
+    Num_Managed_Devices = 0;
+    iCurrent_Device_Idx = 0;
+    I_Am_Pending_Count = 0;
+    I_Am_Cursor = 0;
+    if (Device_Instance_List) {
+        while (Keylist_Count(Device_Instance_List) > 0) {
+            (void)Keylist_Data_Pop(Device_Instance_List);
+        }
+        Keylist_Delete(Device_Instance_List);
+        Device_Instance_List = NULL;
+    }
+    if (Device_MAC_List) {
+        while (Keylist_Count(Device_MAC_List) > 0) {
+            (void)Keylist_Data_Pop(Device_MAC_List);
+        }
+        Keylist_Delete(Device_MAC_List);
+        Device_MAC_List = NULL;
+    }
 }
 
 /** Return the Device Object descriptive data for the indicated entry.
@@ -130,10 +397,10 @@ uint16_t Add_Routed_Device(uint32_t Object_Instance,
 DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
 {
     if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx];
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
+        return Routed_Device_Current();
+    } else if ((idx >= 0) && (idx < Num_Managed_Devices)) {
         iCurrent_Device_Idx = idx;
-        return &Devices[idx];
+        return &Devices[idx]->Device;
     } else {
         return NULL;
     }
@@ -147,17 +414,40 @@ DEVICE_OBJECT_DATA *Get_Routed_Device_Object(int idx)
  *                 If valid idx, will set iCurrent_Device_Idx with the idx
  * @return Pointer to the requested Device Object BACnet address, or NULL if the
  * idx is for an invalid row entry (eg, after the last good Device).
+ * @note Use Routed_Device_Set_Address() to change the address, so that
+ *  the MAC address index is kept up to date.  An address changed in place
+ *  is not found by a unicast on the virtual network.
  */
 BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 {
-    if (idx == -1) {
-        return &Devices[iCurrent_Device_Idx].bacDevAddr;
-    } else if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
-        iCurrent_Device_Idx = idx;
-        return &Devices[idx].bacDevAddr;
-    } else {
-        return NULL;
+    DEVICE_OBJECT_DATA *pDev = Get_Routed_Device_Object(idx);
+
+    if (pDev) {
+        return &pDev->bacDevAddr;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the BACnet address of the currently active Device, and
+ *  index its MAC address
+ * @param address [in] BACnet address of the Device
+ * @return true if the address was set
+ */
+bool Routed_Device_Set_Address(BACNET_ADDRESS *address)
+{
+    struct routed_device *pDev;
+
+    if (!address || (iCurrent_Device_Idx >= Num_Managed_Devices)) {
+        return false;
     }
+    pDev = Devices[iCurrent_Device_Idx];
+    Routed_Device_MAC_Remove(pDev);
+    bacnet_address_copy(&pDev->Device.bacDevAddr, address);
+    Routed_Device_MAC_Add(pDev);
+
+    return true;
 }
 
 /** Get the currently active BACnet address.
@@ -170,7 +460,7 @@ BACNET_ADDRESS *Get_Routed_Device_Address(int idx)
 void routed_get_my_address(BACNET_ADDRESS *my_address)
 {
     if (my_address) {
-        memcpy(my_address, &Devices[iCurrent_Device_Idx].bacDevAddr,
+        memcpy(my_address, &Routed_Device_Current()->bacDevAddr,
             sizeof(BACNET_ADDRESS));
     }
 }
@@ -198,8 +488,8 @@ bool Routed_Device_Address_Lookup(int idx, uint8_t dlen, uint8_t *dadr)
     DEVICE_OBJECT_DATA *pDev;
     int i;
 
-    if ((idx >= 0) && (idx < MAX_NUM_DEVICES)) {
-        pDev = &Devices[idx];
+    if ((idx >= 0) && (idx < Num_Managed_Devices)) {
+        pDev = &Devices[idx]->Device;
         if (dlen == 0) {
             /* Automatic match */
             iCurrent_Device_Idx = idx;
@@ -254,7 +544,7 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
     /* First, see if the index is out of range.
      * Eg, last call to GetNext may have been the last successful one.
      */
-    if ((idx < 0) || (idx >= MAX_NUM_DEVICES)) {
+    if ((idx < 0) || (idx >= Num_Managed_Devices)) {
         idx = -1;
 
         /* Next, see if it's a BACnet broadcast.
@@ -284,18 +574,24 @@ bool Routed_Device_GetNext(BACNET_ADDRESS *dest, int *DNET_list, int *cursor)
         if (idx == 0) { /* Step over this case (starting point) */
             idx = 1;
         }
-        while (idx < MAX_NUM_DEVICES) {
+        if (dest->len == 0) {
             bSuccess =
                 Routed_Device_Address_Lookup(idx++, dest->len, dest->adr);
-            if (bSuccess) {
-                break; /* We don't need to keep looking */
+        } else {
+            /* a unicast is for one Device, found in the MAC index */
+            idx = Routed_Device_MAC_Find(dest->len, dest->adr);
+            if (idx > 0) {
+                iCurrent_Device_Idx = idx;
+                bSuccess = true;
             }
+            idx = -1;
         }
     }
 
     if (!bSuccess) {
         *cursor = -1;
-    } else if (idx == MAX_NUM_DEVICES) { /* No more to GetNext */
+    } else if ((idx < 0) || (idx >= Num_Managed_Devices)) {
+        /* No more to GetNext */
         *cursor = -1;
     } else {
         *cursor = idx;
@@ -341,25 +637,24 @@ bool Routed_Device_Is_Valid_Network(uint16_t dest_net, int *DNET_list)
 uint32_t Routed_Device_Index_To_Instance(unsigned index)
 {
     (void)index;
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return Routed_Device_Current()->bacObj.Object_Instance_Number;
 }
 
 /**
  * For a given object instance-number, determines a 1..N-1 index
- * of Device objects where N is MAX_NUM_DEVICES
+ * of Device objects where N is the number of Devices
  *
  * @param  object_instance - object-instance number of the object
  * @return  index for the given instance-number, or 0 if not valid.
  */
 static uint32_t Routed_Device_Instance_To_Index(uint32_t Instance_Number)
 {
-    int i;
+    struct routed_device *pDev;
 
-    for (i = 0; i < MAX_NUM_DEVICES; i++) {
-        if (Devices[i].bacObj.Object_Instance_Number == Instance_Number) {
-            /* Found Instance, so return the Device Index Number */
-            return i;
-        }
+    pDev = Keylist_Data(Device_Instance_List, Instance_Number);
+    if (pDev) {
+        /* Found Instance, so return the Device Index Number */
+        return pDev->Index;
     }
 
     /* We did not find instance... so simply return an Index of 0
@@ -379,7 +674,7 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
     DEVICE_OBJECT_DATA *pDev = NULL;
 
     iCurrent_Device_Idx = Routed_Device_Instance_To_Index(object_id);
-    pDev = &Devices[iCurrent_Device_Idx];
+    pDev = Routed_Device_Current();
     if (pDev->bacObj.Object_Instance_Number == object_id) {
         valid = true;
     }
@@ -390,7 +685,7 @@ bool Routed_Device_Valid_Object_Instance_Number(uint32_t object_id)
 bool Routed_Device_Name(
     uint32_t object_instance, BACNET_CHARACTER_STRING *object_name)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
     if (object_instance == pDev->bacObj.Object_Instance_Number) {
         return characterstring_init_ansi(object_name, pDev->bacObj.Object_Name);
     }
@@ -409,7 +704,7 @@ int Routed_Device_Read_Property_Local(BACNET_READ_PROPERTY_DATA *rpdata)
     int apdu_len = 0; /* return value */
     BACNET_CHARACTER_STRING char_string;
     uint8_t *apdu = NULL;
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if ((rpdata == NULL) || (rpdata->application_data == NULL) ||
         (rpdata->application_data_len == 0)) {
@@ -510,19 +805,36 @@ bool Routed_Device_Write_Property_Local(BACNET_WRITE_PROPERTY_DATA *wp_data)
  */
 uint32_t Routed_Device_Object_Instance_Number(void)
 {
-    return Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number;
+    return Routed_Device_Current()->bacObj.Object_Instance_Number;
 }
 
 bool Routed_Device_Set_Object_Instance_Number(uint32_t object_id)
 {
     bool status = true; /* return value */
+    struct routed_device *pDev;
+    uint32_t old_id;
 
-    if (object_id <= BACNET_MAX_INSTANCE) {
+    if (object_id > BACNET_MAX_INSTANCE) {
+        status = false;
+    } else if (iCurrent_Device_Idx < Num_Managed_Devices) {
+        pDev = Devices[iCurrent_Device_Idx];
+        old_id = pDev->Device.bacObj.Object_Instance_Number;
+        if (object_id != old_id) {
+            if (Keylist_Data(Device_Instance_List, object_id)) {
+                /* another Device has this instance number */
+                return false;
+            }
+            (void)Keylist_Data_Delete(Device_Instance_List, old_id);
+            if (Keylist_Data_Add(Device_Instance_List, object_id, pDev) < 0) {
+                (void)Keylist_Data_Add(Device_Instance_List, old_id, pDev);
+                return false;
+            }
+        }
         /* Make the change and update the database revision */
-        Devices[iCurrent_Device_Idx].bacObj.Object_Instance_Number = object_id;
+        pDev->Device.bacObj.Object_Instance_Number = object_id;
         Routed_Device_Inc_Database_Revision();
     } else {
-        status = false;
+        Device_Empty.bacObj.Object_Instance_Number = object_id;
     }
 
     return status;
@@ -538,7 +850,7 @@ bool Routed_Device_Set_Object_Name(
     uint8_t encoding, const char *value, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if ((encoding == CHARACTER_UTF8) && (length < MAX_DEV_NAME_LEN)) {
         /* Make the change and update the database revision */
@@ -554,7 +866,7 @@ bool Routed_Device_Set_Object_Name(
 bool Routed_Device_Set_Description(const char *name, size_t length)
 {
     bool status = false; /*return value */
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
 
     if (length < MAX_DEV_DESC_LEN) {
         memmove(pDev->Description, name, length);
@@ -572,7 +884,7 @@ bool Routed_Device_Set_Description(const char *name, size_t length)
  */
 void Routed_Device_Inc_Database_Revision(void)
 {
-    DEVICE_OBJECT_DATA *pDev = &Devices[iCurrent_Device_Idx];
+    DEVICE_OBJECT_DATA *pDev = Routed_Device_Current();
     pDev->Database_Revision++;
 }
 
@@ -627,3 +939,161 @@ int Routed_Device_Service_Approval(BACNET_SERVICES_SUPPORTED service,
 
     return len;
 }
+
+/**
+ * @brief Set the table of objects of the currently active Device.
+ *  The Device object functions in the table are replaced with the ones
+ *  for routing, as Routing_Device_Init() does for the gateway Device.
+ * @param object_table [in] Table of objects, terminated by an entry with
+ *  MAX_BACNET_OBJECT_TYPE, or NULL to use the table of the gateway Device.
+ * @return true if the table was set
+ */
+bool Routed_Device_Set_Object_Table(object_functions_t *object_table)
+{
+    object_functions_t *pObject;
+
+    if (iCurrent_Device_Idx >= Num_Managed_Devices) {
+        return false;
+    }
+    Devices[iCurrent_Device_Idx]->Object_Table = object_table;
+    pObject = object_table;
+    while (pObject && (pObject->Object_Type < MAX_BACNET_OBJECT_TYPE)) {
+        if (pObject->Object_Type == OBJECT_DEVICE) {
+            pObject->Object_Index_To_Instance = Routed_Device_Index_To_Instance;
+            pObject->Object_Valid_Instance =
+                Routed_Device_Valid_Object_Instance_Number;
+            pObject->Object_Name = Routed_Device_Name;
+            pObject->Object_Read_Property = Routed_Device_Read_Property_Local;
+            pObject->Object_Write_Property = Routed_Device_Write_Property_Local;
+        }
+        pObject++;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Get the table of objects of the currently active Device
+ * @return table of objects, or NULL if the Device uses the table of the
+ *  gateway Device
+ */
+object_functions_t *Routed_Device_Object_Table(void)
+{
+    if (iCurrent_Device_Idx < Num_Managed_Devices) {
+        return Devices[iCurrent_Device_Idx]->Object_Table;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Find the position in the instance index of the first Device
+ *  with an instance number that is not less than the given one
+ * @param instance - Device object instance number
+ * @return position in the instance index
+ */
+static int Routed_Device_Instance_Lower_Bound(uint32_t instance)
+{
+    int low = 0;
+    int high = Keylist_Count(Device_Instance_List);
+    int middle;
+
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (Keylist_Key(Device_Instance_List, middle) < instance) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @brief Queue an I-Am for each Device with an instance number within
+ *  the limits, as requested by a Who-Is.  Only the Devices within the
+ *  limits are visited, and the I-Am are sent by Routed_Device_I_Am_Task()
+ *  a few at a time.  A Device that is asked by a second requester before
+ *  its I-Am was sent will broadcast its I-Am, to answer both.
+ *  The Who-Is is taken as received by the current Device: when that is
+ *  a virtual routed Device, the Who-Is was sent to the virtual network,
+ *  and the gateway Device, which is not on it, does not answer.
+ * @param low_limit [in] lowest Device object instance number
+ * @param high_limit [in] highest Device object instance number
+ * @param dest [in] where to send the I-Am, or NULL to broadcast it
+ */
+void Routed_Device_I_Am_Request(
+    uint32_t low_limit, uint32_t high_limit, BACNET_ADDRESS *dest)
+{
+    struct routed_device *pDev;
+    bool virtual_only;
+    int count, index;
+
+    virtual_only = (iCurrent_Device_Idx != 0);
+    count = Keylist_Count(Device_Instance_List);
+    index = Routed_Device_Instance_Lower_Bound(low_limit);
+    for (; index < count; index++) {
+        if (Keylist_Key(Device_Instance_List, index) > high_limit) {
+            break;
+        }
+        pDev = Keylist_Data_Index(Device_Instance_List, index);
+        if (virtual_only && (pDev->Index == 0)) {
+            continue;
+        }
+        if (!pDev->I_Am_Pending) {
+            pDev->I_Am_Pending = true;
+            I_Am_Pending_Count++;
+            if (dest) {
+                bacnet_address_copy(&pDev->I_Am_Dest, dest);
+                pDev->I_Am_Unicast = true;
+            } else {
+                pDev->I_Am_Unicast = false;
+            }
+        } else if (pDev->I_Am_Unicast &&
+            (!dest || !bacnet_address_same(&pDev->I_Am_Dest, dest))) {
+            pDev->I_Am_Unicast = false;
+        }
+    }
+}
+
+/**
+ * @brief Send some of the I-Am that are waiting to be sent.  Call this
+ *  often, such as each time through the main loop.
+ * @param max_count [in] the most I-Am to send now, or 0 for
+ *  ROUTED_DEVICE_I_AM_BATCH
+ * @return number of I-Am still waiting to be sent
+ */
+unsigned Routed_Device_I_Am_Task(unsigned max_count)
+{
+    struct routed_device *pDev;
+    uint16_t current = iCurrent_Device_Idx;
+    unsigned sent = 0;
+
+    if (max_count == 0) {
+        max_count = ROUTED_DEVICE_I_AM_BATCH;
+    }
+    while ((I_Am_Pending_Count > 0) && (sent < max_count)) {
+        if (I_Am_Cursor >= Num_Managed_Devices) {
+            I_Am_Cursor = 0;
+        }
+        pDev = Devices[I_Am_Cursor];
+        I_Am_Cursor++;
+        if (!pDev->I_Am_Pending) {
+            continue;
+        }
+        pDev->I_Am_Pending = false;
+        I_Am_Pending_Count--;
+        /* the I-Am is from this Device */
+        iCurrent_Device_Idx = pDev->Index;
+        if (pDev->I_Am_Unicast) {
+            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], &pDev->I_Am_Dest);
+        } else {
+            Send_I_Am(&Handler_Transmit_Buffer[0]);
+        }
+        sent++;
+    }
+    iCurrent_Device_Idx = current;
+
+    return I_Am_Pending_Count;
+}
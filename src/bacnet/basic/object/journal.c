@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @brief Write-behind journal of the properties written
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * Each property that is written and kept in the snapshot is added as a
+ * record to a buffer in RAM, which only costs a copy while the
+ * WriteProperty request is handled.  The application commits the buffer
+ * to an append-only journal file from its task loop, so many writes
+ * share one flush of the file, and compacts the journal into a new
+ * snapshot from time to time.  At startup the snapshot is restored, and
+ * then the journal is replayed on top of it.
+ *
+ * A record is: length (2) of the rest of the record without the CRC,
+ * object type (2), object instance (4), property (4), array index (4),
+ * priority (1), value, and a CRC-32 (4) of all of the bytes before it.
+ * A record that was only partly written, or is damaged, ends the replay.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacint.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/journal.h"
+#include "bacnet/basic/object/snapshot.h"
+
+static uint8_t Journal_Buffer[DEVICE_JOURNAL_BUFFER_SIZE];
+static size_t Journal_Length;
+/* a record did not fit, so a snapshot is needed */
+static bool Journal_Overflow;
+
+/**
+ * @brief Add a property that was written to the journal.  Use as the
+ *  Device_Write_Property_Store_Callback_Set() callback.
+ * @param wp_data - WriteProperty data of the property that was written
+ * @return true if the property was added, or is not kept
+ */
+bool Device_Journal_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    uint8_t *record;
+    size_t record_len;
+    uint32_t crc;
+
+    if (!wp_data || (wp_data->application_data_len < 0)) {
+        return false;
+    }
+    if (!Device_Snapshot_Property(wp_data->object_property)) {
+        return true;
+    }
+    record_len = DEVICE_JOURNAL_RECORD_OVERHEAD +
+        (size_t)wp_data->application_data_len;
+    if ((Journal_Length + record_len) > sizeof(Journal_Buffer)) {
+        Journal_Overflow = true;
+        return false;
+    }
+    record = &Journal_Buffer[Journal_Length];
+    (void)encode_unsigned16(&record[0], (uint16_t)(record_len - 6));
+    (void)encode_unsigned16(&record[2], (uint16_t)wp_data->object_type);
+    (void)encode_unsigned32(&record[4], wp_data->object_instance);
+    (void)encode_unsigned32(&record[8], (uint32_t)wp_data->object_property);
+    (void)encode_unsigned32(&record[12], wp_data->array_index);
+    record[16] = wp_data->priority;
+    memcpy(&record[17], wp_data->application_data,
+        (size_t)wp_data->application_data_len);
+    crc = Device_Snapshot_CRC32(record, record_len - 4);
+    (void)encode_unsigned32(&record[record_len - 4], crc);
+    Journal_Length += record_len;
+
+    return true;
+}
+
+/**
+ * @brief Get the number of bytes of records waiting to be committed
+ * @return number of bytes waiting
+ */
+size_t Device_Journal_Pending(void)
+{
+    return Journal_Length;
+}
+
+/**
+ * @brief Determine if records were lost because the buffer was full.
+ *  The journal is then incomplete, and a snapshot has to be saved.
+ * @return true if records were lost since the last reset
+ */
+bool Device_Journal_Overflow(void)
+{
+    return Journal_Overflow;
+}
+
+/**
+ * @brief Commit the waiting records to the journal with one write
+ * @param write_fn - function that appends the records to stable storage
+ * @param context - context passed to the function
+ * @return true if there was nothing to commit, or the records were written
+ */
+bool Device_Journal_Commit(
+    device_journal_write_function write_fn, void *context)
+{
+    if (Journal_Length == 0) {
+        return true;
+    }
+    if (!write_fn || !write_fn(context, Journal_Buffer, Journal_Length)) {
+        return false;
+    }
+    Journal_Length = 0;
+
+    return true;
+}
+
+/**
+ * @brief Drop the waiting records, after a snapshot holds their values
+ */
+void Device_Journal_Reset(void)
+{
+    Journal_Length = 0;
+    Journal_Overflow = false;
+}
+
+/**
+ * @brief Write the properties of the records in a journal again
+ * @param buffer - journal
+ * @param buffer_size - number of bytes in the journal
+ * @param valid_len - number of bytes of whole records, which is less
+ *  than the size when the end of the journal was not completely written
+ * @return number of records replayed
+ */
+int Device_Journal_Replay(
+    uint8_t *buffer, size_t buffer_size, size_t *valid_len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint16_t len = 0, object_type = 0;
+    uint32_t property = 0, crc = 0;
+    size_t offset = 0, record_len;
+    int records = 0;
+
+    while (buffer && ((offset + DEVICE_JOURNAL_RECORD_OVERHEAD) <=
+                         buffer_size)) {
+        (void)decode_unsigned16(&buffer[offset], &len);
+        record_len = (size_t)len + 6;
+        if ((record_len < DEVICE_JOURNAL_RECORD_OVERHEAD) ||
+            ((offset + record_len) > buffer_size) ||
+            ((record_len - DEVICE_JOURNAL_RECORD_OVERHEAD) >
+                sizeof(wp_data.application_data))) {
+            break;
+        }
+        (void)decode_unsigned32(&buffer[offset + record_len - 4], &crc);
+        if (crc != Device_Snapshot_CRC32(&buffer[offset], record_len - 4)) {
+            break;
+        }
+        (void)decode_unsigned16(&buffer[offset + 2], &object_type);
+        wp_data.object_type = object_type;
+        (void)decode_unsigned32(
+            &buffer[offset + 4], &wp_data.object_instance);
+        (void)decode_unsigned32(&buffer[offset + 8], &property);
+        wp_data.object_property = property;
+        (void)decode_unsigned32(&buffer[offset + 12], &wp_data.array_index);
+        wp_data.priority = buffer[offset + 16];
+        wp_data.application_data_len =
+            (int)(record_len - DEVICE_JOURNAL_RECORD_OVERHEAD);
+        memcpy(wp_data.application_data, &buffer[offset + 17],
+            (size_t)wp_data.application_data_len);
+        (void)Device_Write_Property(&wp_data);
+        offset += record_len;
+        records++;
+    }
+    if (valid_len) {
+        *valid_len = offset;
+    }
+
+    return records;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file
+ * @brief API for a write-behind journal of the properties written
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_JOURNAL_H
+#define BACNET_BASIC_OBJECT_JOURNAL_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/wp.h"
+
+/* number of bytes of records waiting to be committed */
+#ifndef DEVICE_JOURNAL_BUFFER_SIZE
+#define DEVICE_JOURNAL_BUFFER_SIZE (MAX_APDU * 8)
+#endif
+
+/* length (2), object type (2), instance (4), property (4),
+   array index (4), priority (1), value, CRC-32 (4) */
+#define DEVICE_JOURNAL_RECORD_OVERHEAD 21
+
+/**
+ * @brief Writes the records to stable storage, as one group commit
+ * @param context - context given to Device_Journal_Commit()
+ * @param data - records to append to the journal
+ * @param data_len - number of bytes of records
+ * @return true if the records were written
+ */
+typedef bool (*device_journal_write_function)(
+    void *context, const uint8_t *data, size_t data_len);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    bool Device_Journal_Write_Property(
+        BACNET_WRITE_PROPERTY_DATA * wp_data);
+    BACNET_STACK_EXPORT
+    size_t Device_Journal_Pending(
+        void);
+    BACNET_STACK_EXPORT
+    bool Device_Journal_Overflow(
+        void);
+    BACNET_STACK_EXPORT
+    bool Device_Journal_Commit(
+        device_journal_write_function write_fn,
+        void *context);
+    BACNET_STACK_EXPORT
+    void Device_Journal_Reset(
+        void);
+    BACNET_STACK_EXPORT
+    int Device_Journal_Replay(
+        uint8_t *buffer,
+        size_t buffer_size,
+        size_t *valid_len);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
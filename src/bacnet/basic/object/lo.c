@@ -21,13 +21,18 @@
 #include "bacnet/lighting.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/sys/keylist.h"
-#include "bacnet/basic/sys/linear.h"
 #include "bacnet/basic/sys/debug.h"
 #include "bacnet/bactext.h"
 #include "bacnet/proplist.h"
 /* me! */
 #include "bacnet/basic/object/lo.h"
 
+/* change of the tracking value, in percent, that is large enough to
+   call the present value callback while fading or ramping */
+#ifndef LIGHTING_OUTPUT_NOTIFY_INCREMENT
+#define LIGHTING_OUTPUT_NOTIFY_INCREMENT 0.1f
+#endif
+
 struct object_data {
     float Present_Value;
     float Tracking_Value;
@@ -57,13 +62,48 @@ struct object_data {
     bool Blink_Warn_Enable : 1;
     bool Egress_Active : 1;
     bool Color_Override : 1;
+    /* 1-based index in the active set, or zero when idle */
+    unsigned Active_Index;
+    /* tracking value given to the callback most recently */
+    float Notify_Value;
 };
 /* Key List for storing the object data sorted by instance number  */
 static OS_Keylist Object_List;
+/* The objects with a fade, ramp, or step in progress.  The values that
+   change every tick are kept in separate arrays, so that the tracking
+   values of every fade and ramp are advanced in one loop that the
+   compiler can vectorize, and idle objects cost nothing. */
+static struct lighting_output_active {
+    unsigned count;
+    unsigned size;
+    uint32_t *instance;
+    struct object_data **object;
+    /* tracking value, in percent */
+    float *current;
+    /* target value, in percent */
+    float *target;
+    /* change of the tracking value, in percent per millisecond */
+    float *rate;
+    /* remaining fade time, in milliseconds */
+    uint32_t *remaining;
+    /* callbacks held back until every active object has been advanced */
+    bool notify_deferred;
+    unsigned notify_count;
+    struct lighting_output_notify {
+        uint32_t instance;
+        float old_value;
+        float value;
+    } *notify;
+} Active;
 /* callback for present value writes */
 static lighting_output_write_present_value_callback
     Lighting_Output_Write_Present_Value_Callback;
 
+static void Lighting_Output_Active_Start(
+    uint32_t object_instance, struct object_data *pObject);
+static void Lighting_Output_Present_Value_Notify(
+    uint32_t object_instance, float old_value, float value);
+
 /* These arrays are used by the ReadPropertyMultiple handler and
    property-list property (as of protocol-revision 14) */
 static const int Lighting_Output_Properties_Required[] = {
@@ -688,6 +728,9 @@ static bool Lighting_Output_Present_Value_Write(
                 *error_class = ERROR_CLASS_PROPERTY;
                 *error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
             }
+            if (status) {
+                Lighting_Output_Active_Start(object_instance, pObject);
+            }
         } else {
             *error_class = ERROR_CLASS_PROPERTY;
             *error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
@@ -782,6 +825,7 @@ static bool Lighting_Output_Present_Value_Relinquish_Write(
                     pObject->Lighting_Command.operation = BACNET_LIGHTS_FADE_TO;
                 }
                 pObject->Lighting_Command.target_level = value;
+                Lighting_Output_Active_Start(object_instance, pObject);
             }
             status = true;
         } else {
@@ -914,6 +958,9 @@ bool Lighting_Output_Lighting_Command_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         status = lighting_command_copy(&pObject->Lighting_Command, value);
+        if (status) {
+            Lighting_Output_Active_Start(object_instance, pObject);
+        }
     }
 
     return status;
@@ -1050,6 +1097,9 @@ static bool Lighting_Output_Lighting_Command_Write(
                 *error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
                 break;
         }
+        if (status) {
+            Lighting_Output_Active_Start(object_instance, pObject);
+        }
     } else {
         *error_class = ERROR_CLASS_OBJECT;
         *error_code = ERROR_CODE_UNKNOWN_OBJECT;
@@ -1145,11 +1195,11 @@ float Lighting_Output_Tracking_Value(uint32_t object_instance)
 }
 
 /**
- * For a given object instance-number, sets the in-progress value of the
- * object.
+ * For a given object instance-number, sets the tracking value of the
+ * object.  A fade or ramp in progress continues from this value.
  *
  * @param object_instance - object-instance number of the object
- * @param in_progress - holds the value to be set
+ * @param value - holds the value to be set
  *
  * @return true if value was set
  */
@@ -1161,6 +1211,9 @@ bool Lighting_Output_Tracking_Value_Set(uint32_t object_instance, float value)
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Tracking_Value = value;
+        if (pObject->Active_Index) {
+            Lighting_Output_Active_Start(object_instance, pObject);
+        }
         status = true;
     }
 
@@ -2253,167 +2306,6 @@ bool Lighting_Output_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
     return status;
 }
 
-/**
- * Handles the timing for a single Lighting Output object Fade
- *
- * @param object_instance - Lighting Output object
- * @param milliseconds - number of milliseconds elapsed since previously
- * called.  Works best when called about every 10 milliseconds.
- */
-static void
-Lighting_Output_Fade_Handler(uint32_t object_instance, uint16_t milliseconds)
-{
-    struct object_data *pObject;
-    float old_value;
-    float x1, x2, x3, y1, y3;
-
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
-    old_value = pObject->Tracking_Value;
-    if (milliseconds >= pObject->Lighting_Command.fade_time) {
-        /* stop fading */
-        pObject->Tracking_Value = pObject->Lighting_Command.target_level;
-        pObject->In_Progress = BACNET_LIGHTING_IDLE;
-        pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-        pObject->Lighting_Command.fade_time = 0;
-    } else {
-        if (!islessgreater(
-                pObject->Tracking_Value,
-                pObject->Lighting_Command.target_level)) {
-            /* stop fading */
-            pObject->Tracking_Value = pObject->Lighting_Command.target_level;
-            pObject->In_Progress = BACNET_LIGHTING_IDLE;
-            pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-            pObject->Lighting_Command.fade_time = 0;
-        } else {
-            /* fading */
-            x1 = 0.0f;
-            x2 = (float)milliseconds;
-            x3 = (float)pObject->Lighting_Command.fade_time;
-            y1 = old_value;
-            y3 = pObject->Lighting_Command.target_level;
-            pObject->Tracking_Value = linear_interpolate(x1, x2, x3, y1, y3);
-            pObject->Lighting_Command.fade_time -= milliseconds;
-            pObject->In_Progress = BACNET_LIGHTING_FADE_ACTIVE;
-        }
-    }
-    if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
-    } else {
-        debug_printf("LO[%u] Fade Handler Operation=%s Value=%f\n",
-            object_instance,
-            bactext_lighting_operation_name(
-            pObject->Lighting_Command.operation),
-            (double)pObject->Tracking_Value);
-    }
-}
-
-/**
- * Updates the object tracking value while ramping
- *
- * Commands Present_Value to ramp from the current Tracking_Value to the
- * target-level specified in the command. The ramp operation
- * changes the output from its current value to target-level,
- * at a particular percent per second defined by ramp-rate.
- * While the ramp operation is executing, In_Progress shall be set
- * to RAMP_ACTIVE, and Tracking_Value shall be updated to reflect the current
- * progress of the ramp. <target-level> shall be clamped to
- * Min_Actual_Value and Max_Actual_Value.
- *
- * @param  object_instance - object-instance number of the object
- * @param milliseconds - number of milliseconds elapsed
- */
-static void
-Lighting_Output_Ramp_Handler(uint32_t object_instance, uint16_t milliseconds)
-{
-    float old_value, target_value, min_value, max_value, step_value, steps;
-    struct object_data *pObject;
-
-    pObject = Keylist_Data(Object_List, object_instance);
-    if (!pObject) {
-        return;
-    }
-    old_value = pObject->Tracking_Value;
-    min_value = pObject->Min_Actual_Value;
-    max_value = pObject->Max_Actual_Value;
-    target_value = pObject->Lighting_Command.target_level;
-    /* clamp target within min/max, if needed */
-    if (isgreater(target_value, max_value)) {
-        target_value = max_value;
-    }
-    if (isless(target_value, min_value)) {
-        target_value = min_value;
-    }
-    /* determine the number of steps */
-    if (milliseconds <= 1000) {
-        /* percent per second */
-        steps = linear_interpolate(
-            0.0f, (float)milliseconds, 1000.0f, 0.0f,
-            pObject->Lighting_Command.ramp_rate);
-    } else {
-        steps = ((float)milliseconds * pObject->Lighting_Command.ramp_rate) /
-            1000.0f;
-    }
-    if (!islessgreater(pObject->Tracking_Value, target_value)) {
-        /* stop ramping */
-        pObject->Tracking_Value = target_value;
-        pObject->In_Progress = BACNET_LIGHTING_IDLE;
-        pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-    } else {
-        if (isless(old_value, target_value)) {
-            step_value = old_value + steps;
-            if (isgreater(step_value, target_value)) {
-                /* stop ramping */
-                pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-            }
-        } else if (isgreater(old_value, target_value)) {
-            debug_printf("LO[%u] Ramp Handler Down steps=%f tracking=%f\n",
-                object_instance, (double)steps, (double)old_value);
-            if (isgreater(old_value, steps)) {
-                step_value = old_value - steps;
-            } else {
-                step_value = target_value;
-            }
-            if (isless(step_value, target_value)) {
-                /* stop ramping */
-                pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-            }
-        } else {
-            debug_printf("LO[%u] Ramp Handler at target=%f tracking=%f\n",
-                object_instance, (double)target_value, (double)old_value);
-            /* stop ramping */
-            step_value = target_value;
-            pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
-        }
-        /* clamp target within min/max, if needed */
-        if (isgreater(step_value, max_value)) {
-            step_value = max_value;
-        }
-        if (isless(step_value, min_value)) {
-            step_value = min_value;
-        }
-        pObject->Tracking_Value = step_value;
-        if (pObject->Lighting_Command.operation == BACNET_LIGHTS_STOP) {
-            pObject->In_Progress = BACNET_LIGHTING_IDLE;
-        } else {
-            pObject->In_Progress = BACNET_LIGHTING_RAMP_ACTIVE;
-        }
-    }
-    if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
-            object_instance, old_value, pObject->Tracking_Value);
-    } else {
-        debug_printf("LO[%u] Ramp Handler Operation=%s Value=%f\n",
-            object_instance,
-            bactext_lighting_operation_name(
-            pObject->Lighting_Command.operation),
-            (double)pObject->Tracking_Value);
-    }
-}
-
 /**
  * Updates the object tracking value while stepping
  *
@@ -2451,7 +2343,7 @@ static void Lighting_Output_Step_Up_Handler(uint32_t object_instance)
         pObject->In_Progress = BACNET_LIGHTING_IDLE;
         pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
         if (Lighting_Output_Write_Present_Value_Callback) {
-            Lighting_Output_Write_Present_Value_Callback(
+            Lighting_Output_Present_Value_Notify(
                 object_instance, old_value, pObject->Tracking_Value);
         } else {
             debug_printf("LO[%u] Step Up Handler Operation=%s Value=%f\n",
@@ -2502,7 +2394,7 @@ static void Lighting_Output_Step_Down_Handler(uint32_t object_instance)
     pObject->In_Progress = BACNET_LIGHTING_IDLE;
     pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
     if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
+        Lighting_Output_Present_Value_Notify(
             object_instance, old_value, pObject->Tracking_Value);
     } else {
         debug_printf("LO[%u] Step Down Handler Operation=%s Value=%f\n",
@@ -2548,7 +2440,7 @@ static void Lighting_Output_Step_On_Handler(uint32_t object_instance)
     pObject->In_Progress = BACNET_LIGHTING_IDLE;
     pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
     if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
+        Lighting_Output_Present_Value_Notify(
             object_instance, old_value, pObject->Tracking_Value);
     } else {
         debug_printf("LO[%u] Step On Handler Operation=%s Value=%f\n",
@@ -2599,7 +2491,7 @@ static void Lighting_Output_Step_Off_Handler(uint32_t object_instance)
     pObject->In_Progress = BACNET_LIGHTING_IDLE;
     pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
     if (Lighting_Output_Write_Present_Value_Callback) {
-        Lighting_Output_Write_Present_Value_Callback(
+        Lighting_Output_Present_Value_Notify(
             object_instance, old_value, pObject->Tracking_Value);
     } else {
         debug_printf("LO[%u] Step Off Handler Operation=%s Value=%f\n",
@@ -2610,53 +2502,366 @@ static void Lighting_Output_Step_Off_Handler(uint32_t object_instance)
     }
 }
 
+/**
+ * @brief Makes room for one more object in the active set
+ * @return true if there is room
+ */
+static bool Lighting_Output_Active_Grow(void)
+{
+    unsigned size;
+    void *data;
+
+    if (Active.count < Active.size) {
+        return true;
+    }
+    size = Active.size ? (Active.size * 2) : 16;
+    data = realloc(Active.instance, size * sizeof(*Active.instance));
+    if (!data) {
+        return false;
+    }
+    Active.instance = data;
+    data = realloc(Active.object, size * sizeof(*Active.object));
+    if (!data) {
+        return false;
+    }
+    Active.object = data;
+    data = realloc(Active.current, size * sizeof(*Active.current));
+    if (!data) {
+        return false;
+    }
+    Active.current = data;
+    data = realloc(Active.target, size * sizeof(*Active.target));
+    if (!data) {
+        return false;
+    }
+    Active.target = data;
+    data = realloc(Active.rate, size * sizeof(*Active.rate));
+    if (!data) {
+        return false;
+    }
+    Active.rate = data;
+    data = realloc(Active.remaining, size * sizeof(*Active.remaining));
+    if (!data) {
+        return false;
+    }
+    Active.remaining = data;
+    data = realloc(Active.notify, size * sizeof(*Active.notify));
+    if (!data) {
+        return false;
+    }
+    Active.notify = data;
+    Active.size = size;
+
+    return true;
+}
+
+/**
+ * @brief Removes an object from the active set, by moving the last
+ *  object of the active set into its place
+ * @param pObject - object instance data
+ */
+static void Lighting_Output_Active_Remove(struct object_data *pObject)
+{
+    unsigned index, last;
+
+    if (!pObject || !pObject->Active_Index) {
+        return;
+    }
+    index = pObject->Active_Index - 1;
+    last = Active.count - 1;
+    if (index != last) {
+        Active.instance[index] = Active.instance[last];
+        Active.object[index] = Active.object[last];
+        Active.current[index] = Active.current[last];
+        Active.target[index] = Active.target[last];
+        Active.rate[index] = Active.rate[last];
+        Active.remaining[index] = Active.remaining[last];
+        Active.object[index]->Active_Index = index + 1;
+    }
+    Active.count--;
+    pObject->Active_Index = 0;
+}
+
+/**
+ * @brief Calls the present value callback, or holds the call back while
+ *  Lighting_Output_Active_Timer() is advancing the active set, so that
+ *  the callback can command lighting objects
+ * @param object_instance - object-instance number of the object
+ * @param old_value - tracking value before the change
+ * @param value - tracking value after the change
+ */
+static void Lighting_Output_Present_Value_Notify(
+    uint32_t object_instance, float old_value, float value)
+{
+    struct lighting_output_notify *notify;
+
+    if (!Lighting_Output_Write_Present_Value_Callback) {
+        return;
+    }
+    if (Active.notify_deferred && (Active.notify_count < Active.size)) {
+        notify = &Active.notify[Active.notify_count++];
+        notify->instance = object_instance;
+        notify->old_value = old_value;
+        notify->value = value;
+        return;
+    }
+    Lighting_Output_Write_Present_Value_Callback(
+        object_instance, old_value, value);
+}
+
+/**
+ * @brief Calls the callback when the tracking value has changed enough
+ *  to be seen, or when the transition is finished
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object instance data
+ * @param finished - true if the fade or ramp is finished
+ */
+static void Lighting_Output_Active_Notify(
+    uint32_t object_instance, struct object_data *pObject, bool finished)
+{
+    float old_value = pObject->Notify_Value;
+
+    if (!finished &&
+        isless(fabsf(pObject->Tracking_Value - old_value),
+            LIGHTING_OUTPUT_NOTIFY_INCREMENT)) {
+        return;
+    }
+    pObject->Notify_Value = pObject->Tracking_Value;
+    if (Lighting_Output_Write_Present_Value_Callback) {
+        Lighting_Output_Present_Value_Notify(
+            object_instance, old_value, pObject->Tracking_Value);
+    } else {
+        debug_printf("LO[%u] Transition Operation=%s Value=%f\n",
+            object_instance,
+            bactext_lighting_operation_name(
+            pObject->Lighting_Command.operation),
+            (double)pObject->Tracking_Value);
+    }
+}
+
+/**
+ * @brief Adds, updates, or removes an object in the active set after its
+ *  lighting command has changed.
+ *
+ * A fade changes the tracking value linearly from its value now to the
+ * target-level within the fade-time, so its rate is fixed when the fade
+ * starts.  A ramp changes the tracking value by ramp-rate percent per
+ * second toward the target-level, which is clamped to Min_Actual_Value
+ * and Max_Actual_Value.
+ *
+ * @param object_instance - object-instance number of the object
+ * @param pObject - object instance data
+ */
+static void Lighting_Output_Active_Start(
+    uint32_t object_instance, struct object_data *pObject)
+{
+    unsigned index;
+    float target, rate;
+
+    switch (pObject->Lighting_Command.operation) {
+        case BACNET_LIGHTS_FADE_TO:
+        case BACNET_LIGHTS_RAMP_TO:
+        case BACNET_LIGHTS_STEP_UP:
+        case BACNET_LIGHTS_STEP_DOWN:
+        case BACNET_LIGHTS_STEP_ON:
+        case BACNET_LIGHTS_STEP_OFF:
+            break;
+        case BACNET_LIGHTS_NONE:
+        case BACNET_LIGHTS_STOP:
+            pObject->In_Progress = BACNET_LIGHTING_IDLE;
+            Lighting_Output_Active_Remove(pObject);
+            return;
+        default:
+            Lighting_Output_Active_Remove(pObject);
+            return;
+    }
+    if (!pObject->Active_Index) {
+        if (!Lighting_Output_Active_Grow()) {
+            return;
+        }
+        pObject->Active_Index = ++Active.count;
+        pObject->Notify_Value = pObject->Tracking_Value;
+    }
+    index = pObject->Active_Index - 1;
+    target = pObject->Lighting_Command.target_level;
+    rate = 0.0f;
+    if (pObject->Lighting_Command.operation == BACNET_LIGHTS_FADE_TO) {
+        if (pObject->Lighting_Command.fade_time > 0) {
+            rate = (target - pObject->Tracking_Value) /
+                (float)pObject->Lighting_Command.fade_time;
+        }
+    } else if (pObject->Lighting_Command.operation == BACNET_LIGHTS_RAMP_TO) {
+        /* clamp target within min/max, if needed */
+        if (isgreater(target, pObject->Max_Actual_Value)) {
+            target = pObject->Max_Actual_Value;
+        }
+        if (isless(target, pObject->Min_Actual_Value)) {
+            target = pObject->Min_Actual_Value;
+        }
+        /* percent per second */
+        rate = fabsf(pObject->Lighting_Command.ramp_rate) / 1000.0f;
+        if (isless(target, pObject->Tracking_Value)) {
+            rate = -rate;
+        }
+    }
+    Active.instance[index] = object_instance;
+    Active.object[index] = pObject;
+    Active.current[index] = pObject->Tracking_Value;
+    Active.target[index] = target;
+    Active.rate[index] = rate;
+    Active.remaining[index] = pObject->Lighting_Command.fade_time;
+}
+
+/**
+ * @brief Completes one tick of an object in the active set, after its
+ *  tracking value has been advanced, and removes the object from the
+ *  active set when its transition is finished.
+ * @param index - 0-based index of the object in the active set
+ * @param milliseconds - number of milliseconds elapsed
+ */
+static void Lighting_Output_Active_Step(unsigned index, uint16_t milliseconds)
+{
+    struct object_data *pObject = Active.object[index];
+    uint32_t object_instance = Active.instance[index];
+    float current = Active.current[index];
+    float target = Active.target[index];
+    float rate = Active.rate[index];
+    bool finished = false;
+
+    switch (pObject->Lighting_Command.operation) {
+        case BACNET_LIGHTS_FADE_TO:
+            if ((milliseconds >= Active.remaining[index]) ||
+                !islessgreater(rate, 0.0f) ||
+                (isgreater(rate, 0.0f) && isgreaterequal(current, target)) ||
+                (isless(rate, 0.0f) && islessequal(current, target))) {
+                finished = true;
+            } else {
+                Active.remaining[index] -= milliseconds;
+                pObject->Lighting_Command.fade_time = Active.remaining[index];
+                pObject->Tracking_Value = current;
+                pObject->In_Progress = BACNET_LIGHTING_FADE_ACTIVE;
+            }
+            break;
+        case BACNET_LIGHTS_RAMP_TO:
+            /* a ramp-rate of zero keeps ramping without moving */
+            if (!islessgreater(current, target) ||
+                (isgreater(rate, 0.0f) && isgreaterequal(current, target)) ||
+                (isless(rate, 0.0f) && islessequal(current, target))) {
+                finished = true;
+            } else {
+                /* clamp within min/max, if needed */
+                if (isgreater(current, pObject->Max_Actual_Value)) {
+                    current = pObject->Max_Actual_Value;
+                }
+                if (isless(current, pObject->Min_Actual_Value)) {
+                    current = pObject->Min_Actual_Value;
+                }
+                Active.current[index] = current;
+                pObject->Tracking_Value = current;
+                pObject->In_Progress = BACNET_LIGHTING_RAMP_ACTIVE;
+            }
+            break;
+        case BACNET_LIGHTS_STEP_UP:
+            Lighting_Output_Active_Remove(pObject);
+            Lighting_Output_Step_Up_Handler(object_instance);
+            return;
+        case BACNET_LIGHTS_STEP_DOWN:
+            Lighting_Output_Active_Remove(pObject);
+            Lighting_Output_Step_Down_Handler(object_instance);
+            return;
+        case BACNET_LIGHTS_STEP_ON:
+            Lighting_Output_Active_Remove(pObject);
+            Lighting_Output_Step_On_Handler(object_instance);
+            return;
+        case BACNET_LIGHTS_STEP_OFF:
+            Lighting_Output_Active_Remove(pObject);
+            Lighting_Output_Step_Off_Handler(object_instance);
+            return;
+        default:
+            Lighting_Output_Active_Remove(pObject);
+            return;
+    }
+    if (finished) {
+        pObject->Tracking_Value = target;
+        pObject->In_Progress = BACNET_LIGHTING_IDLE;
+        pObject->Lighting_Command.operation = BACNET_LIGHTS_STOP;
+        pObject->Lighting_Command.fade_time = 0;
+        Lighting_Output_Active_Remove(pObject);
+    }
+    Lighting_Output_Active_Notify(object_instance, pObject, finished);
+}
+
 /**
  * @brief Updates the lighting object tracking value per ramp or fade or step
  * @param  object_instance - object-instance number of the object
  * @param milliseconds - number of milliseconds elapsed since previously
  * called.  Suggest that this is called every 10 milliseconds.
+ * @note Use Lighting_Output_Active_Timer() instead, to update all of the
+ *  objects without visiting the idle ones.
  */
 void Lighting_Output_Timer(uint32_t object_instance, uint16_t milliseconds)
 {
     struct object_data *pObject;
+    unsigned index;
 
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
-        switch (pObject->Lighting_Command.operation) {
-            case BACNET_LIGHTS_NONE:
-                pObject->In_Progress = BACNET_LIGHTING_IDLE;
-                break;
-            case BACNET_LIGHTS_FADE_TO:
-                Lighting_Output_Fade_Handler(object_instance, milliseconds);
-                break;
-            case BACNET_LIGHTS_RAMP_TO:
-                Lighting_Output_Ramp_Handler(object_instance, milliseconds);
-                break;
-            case BACNET_LIGHTS_STEP_UP:
-                Lighting_Output_Step_Up_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_DOWN:
-                Lighting_Output_Step_Down_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_ON:
-                Lighting_Output_Step_On_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_STEP_OFF:
-                Lighting_Output_Step_Off_Handler(object_instance);
-                break;
-            case BACNET_LIGHTS_WARN:
-                break;
-            case BACNET_LIGHTS_WARN_OFF:
-                break;
-            case BACNET_LIGHTS_WARN_RELINQUISH:
-                break;
-            case BACNET_LIGHTS_STOP:
-                pObject->In_Progress = BACNET_LIGHTING_IDLE;
-                break;
-            default:
-                break;
+        if (pObject->Active_Index) {
+            index = pObject->Active_Index - 1;
+            Active.current[index] +=
+                Active.rate[index] * (float)milliseconds;
+            Lighting_Output_Active_Step(index, milliseconds);
+        } else if ((pObject->Lighting_Command.operation ==
+                       BACNET_LIGHTS_NONE) ||
+            (pObject->Lighting_Command.operation == BACNET_LIGHTS_STOP)) {
+            pObject->In_Progress = BACNET_LIGHTING_IDLE;
+        }
+    }
+}
+
+/**
+ * @brief Updates the tracking value of every lighting object that has a
+ *  ramp or fade or step in progress.  The idle objects are not visited.
+ * @param milliseconds - number of milliseconds elapsed since previously
+ * called.  Suggest that this is called every 10 milliseconds.
+ */
+void Lighting_Output_Active_Timer(uint16_t milliseconds)
+{
+    const float elapsed = (float)milliseconds;
+    float *current = Active.current;
+    const float *rate = Active.rate;
+    unsigned count = Active.count;
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        current[i] += rate[i] * elapsed;
+    }
+    /* backwards, since a finished object is replaced by the last one */
+    Active.notify_deferred = true;
+    Active.notify_count = 0;
+    for (i = count; i > 0; i--) {
+        Lighting_Output_Active_Step(i - 1, milliseconds);
+    }
+    Active.notify_deferred = false;
+    /* the callback may change the active set */
+    for (i = 0; i < Active.notify_count; i++) {
+        if (Lighting_Output_Write_Present_Value_Callback) {
+            Lighting_Output_Write_Present_Value_Callback(
+                Active.notify[i].instance, Active.notify[i].old_value,
+                Active.notify[i].value);
         }
     }
+    Active.notify_count = 0;
+}
+
+/**
+ * @brief Get the number of lighting objects with a ramp or fade or step
+ *  in progress
+ * @return number of objects in the active set
+ */
+unsigned Lighting_Output_Active_Count(void)
+{
+    return Active.count;
 }
 
 /**
@@ -2755,6 +2960,7 @@ bool Lighting_Output_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        Lighting_Output_Active_Remove(pObject);
         free(pObject);
         status = true;
     }
@@ -2779,6 +2985,14 @@ void Lighting_Output_Cleanup(void)
         Keylist_Delete(Object_List);
         Object_List = NULL;
     }
+    free(Active.instance);
+    free(Active.object);
+    free(Active.current);
+    free(Active.target);
+    free(Active.rate);
+    free(Active.remaining);
+    free(Active.notify);
+    memset(&Active, 0, sizeof(Active));
 }
 
 /**
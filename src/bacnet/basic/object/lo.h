@@ -231,6 +231,12 @@ extern "C" {
     void Lighting_Output_Timer(
         uint32_t object_instance,
         uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    void Lighting_Output_Active_Timer(
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    unsigned Lighting_Output_Active_Count(
+        void);
 
     BACNET_STACK_EXPORT
     void Lighting_Output_Write_Present_Value_Callback_Set(
@@ -713,7 +713,8 @@ void Notification_Class_find_recipient(void)
             recipient = &destination->Recipient;
             if (bacnet_recipient_device_valid(recipient)) {
                 device_id = recipient->type.device.instance;
-                if (!address_bind_request(device_id, &max_apdu, &src)) {
+                if (!address_bind_request(device_id, &max_apdu, &src) &&
+                    address_who_is_request(device_id)) {
                     /*  Send who_ is request only when
                         address of device is unknown. */
                     Send_WhoIs(device_id, device_id);
@@ -7,11 +7,14 @@
  */
 #include <stdbool.h>
 #include <stdint.h>
+#include <math.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
 #include "bacnet/bacdcode.h"
 #include "bacnet/bactext.h"
+#include "bacnet/datetime.h"
 #include "bacnet/proplist.h"
 #include "bacnet/timestamp.h"
 #include "bacnet/basic/services.h"
@@ -23,6 +26,22 @@
 #endif
 
 static SCHEDULE_DESCR Schedule_Descr[MAX_SCHEDULES];
+/* writes the Present_Value to the referenced properties */
+static write_property_function Write_Property_Internal_Callback;
+/* resolves the Calendar references of the Exception_Schedule */
+static schedule_calendar_function Calendar_Callback;
+/* one day of a Weekly_Schedule write, and one more time-value than fits,
+   to detect a day that is too long */
+static BACNET_TIME_VALUE Weekly_Schedule_Day[BACNET_WEEKLY_SCHEDULE_SIZE + 1];
+
+/* a list of time-values that applies to the day, and its priority */
+typedef struct schedule_source {
+    const BACNET_TIME_VALUE *Time_Values;
+    uint16_t TV_Count;
+    uint8_t Priority;
+} SCHEDULE_SOURCE;
+/* the special events and the day of the Weekly_Schedule */
+#define SCHEDULE_SOURCE_MAX (BACNET_EXCEPTION_SCHEDULE_SIZE + 1)
 
 static const int Schedule_Properties_Required[] = { PROP_OBJECT_IDENTIFIER,
     PROP_OBJECT_NAME, PROP_OBJECT_TYPE, PROP_PRESENT_VALUE,
@@ -94,14 +113,18 @@ void Schedule_Init(void)
         for (j = 0; j < 7; j++) {
             psched->Weekly_Schedule[j].TV_Count = 0;
         }
-        memcpy(&psched->Present_Value, &psched->Schedule_Default,
-            sizeof(psched->Present_Value));
         psched->Schedule_Default.context_specific = false;
         psched->Schedule_Default.tag = BACNET_APPLICATION_TAG_REAL;
         psched->Schedule_Default.type.Real = 21.0f; /* 21 C, room temperature */
+        memcpy(&psched->Present_Value, &psched->Schedule_Default,
+            sizeof(psched->Present_Value));
         psched->obj_prop_ref_cnt = 0; /* no references, add as needed */
         psched->Priority_For_Writing = 16; /* lowest priority */
         psched->Out_Of_Service = false;
+        psched->Timeline_Count = 0;
+        psched->Timeline_Index = 0;
+        psched->Timeline_More = false;
+        psched->Timeline_Valid = false;
 #if BACNET_EXCEPTION_SCHEDULE_SIZE
         for (e = 0; e < BACNET_EXCEPTION_SCHEDULE_SIZE; e++) {
             event = &psched->Exception_Schedule[e];
@@ -207,7 +230,26 @@ void Schedule_Out_Of_Service_Set(uint32_t object_instance, bool value)
     index = Schedule_Instance_To_Index(object_instance);
     if (index < MAX_SCHEDULES) {
         Schedule_Descr[index].Out_Of_Service = value;
+        /* evaluate again when back in service */
+        Schedule_Descr[index].Timeline_Valid = false;
+    }
+}
+
+/**
+ * @brief Gets the out-of-service status of a Schedule object
+ * @param object_instance - object-instance number of the object
+ * @return true if out of service, and false if not
+ */
+bool Schedule_Out_Of_Service(uint32_t object_instance)
+{
+    SCHEDULE_DESCR *pObject;
+
+    pObject = Schedule_Object(object_instance);
+    if (pObject) {
+        return pObject->Out_Of_Service;
     }
+
+    return false;
 }
 
 /**
@@ -405,41 +447,279 @@ int Schedule_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     return apdu_len;
 }
 
+/**
+ * @brief Write the Weekly_Schedule, or one day of it
+ * @param desc - schedule descriptor
+ * @param wp_data - WriteProperty data, including the error on failure
+ * @return true if the property was written
+ */
+static bool Schedule_Weekly_Schedule_Write(
+    SCHEDULE_DESCR *desc, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_OBJ_DAILY_SCHEDULE *daily;
+    unsigned int tv_count = 0;
+    unsigned first_day = 0, days = 7, day;
+    int len = 0, apdu_len = 0;
+
+    if (wp_data->array_index == 0) {
+        /* the size of the array cannot be changed */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    } else if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        if (wp_data->array_index > 7) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            return false;
+        }
+        first_day = wp_data->array_index - 1;
+        days = 1;
+    }
+    /* check the whole value before changing anything */
+    for (day = 0; day < days; day++) {
+        len = bacnet_time_values_context_decode(
+            &wp_data->application_data[apdu_len],
+            wp_data->application_data_len - apdu_len, 0, Weekly_Schedule_Day,
+            BACNET_WEEKLY_SCHEDULE_SIZE + 1, &tv_count);
+        if (len < 0) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            return false;
+        }
+        if (tv_count > BACNET_WEEKLY_SCHEDULE_SIZE) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        apdu_len += len;
+    }
+    /* decode each day in place */
+    apdu_len = 0;
+    for (day = 0; day < days; day++) {
+        daily = &desc->Weekly_Schedule[first_day + day];
+        len = bacnet_time_values_context_decode(
+            &wp_data->application_data[apdu_len],
+            wp_data->application_data_len - apdu_len, 0, daily->Time_Values,
+            BACNET_WEEKLY_SCHEDULE_SIZE, &tv_count);
+        daily->TV_Count = (uint16_t)tv_count;
+        apdu_len += len;
+    }
+
+    return true;
+}
+
+#if BACNET_EXCEPTION_SCHEDULE_SIZE
+/**
+ * @brief Write the Exception_Schedule, or one special event of it
+ * @param desc - schedule descriptor
+ * @param wp_data - WriteProperty data, including the error on failure
+ * @return true if the property was written
+ */
+static bool Schedule_Exception_Schedule_Write(
+    SCHEDULE_DESCR *desc, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_SPECIAL_EVENT event;
+    unsigned first = 0, count = 0, e;
+    int len = 0, apdu_len = 0;
+
+    if (wp_data->array_index == 0) {
+        /* the size of the array cannot be changed */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
+        return false;
+    } else if ((wp_data->array_index != BACNET_ARRAY_ALL) &&
+        (wp_data->array_index > BACNET_EXCEPTION_SCHEDULE_SIZE)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+        return false;
+    }
+    /* check the whole value before changing anything */
+    while (apdu_len < wp_data->application_data_len) {
+        len = bacnet_special_event_decode(&wp_data->application_data[apdu_len],
+            wp_data->application_data_len - apdu_len, &event);
+        if (len <= 0) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            return false;
+        }
+        apdu_len += len;
+        count++;
+    }
+    if ((wp_data->array_index != BACNET_ARRAY_ALL) && (count != 1)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+        return false;
+    } else if (count > BACNET_EXCEPTION_SCHEDULE_SIZE) {
+        wp_data->error_class = ERROR_CLASS_RESOURCES;
+        wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+        return false;
+    }
+    if (wp_data->array_index != BACNET_ARRAY_ALL) {
+        first = wp_data->array_index - 1;
+    }
+    apdu_len = 0;
+    for (e = 0; e < count; e++) {
+        len = bacnet_special_event_decode(&wp_data->application_data[apdu_len],
+            wp_data->application_data_len - apdu_len,
+            &desc->Exception_Schedule[first + e]);
+        apdu_len += len;
+    }
+    if (wp_data->array_index == BACNET_ARRAY_ALL) {
+        /* the rest of the special events are unused */
+        for (e = count; e < BACNET_EXCEPTION_SCHEDULE_SIZE; e++) {
+            desc->Exception_Schedule[e].timeValues.TV_Count = 0;
+        }
+    }
+
+    return true;
+}
+#endif
+
+/**
+ * @brief Write the List_Of_Object_Property_References
+ * @param desc - schedule descriptor
+ * @param wp_data - WriteProperty data, including the error on failure
+ * @return true if the property was written
+ */
+static bool Schedule_References_Write(
+    SCHEDULE_DESCR *desc, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE
+        references[BACNET_SCHEDULE_OBJ_PROP_REF_SIZE];
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE reference;
+    unsigned count = 0;
+    int len = 0, apdu_len = 0;
+
+    while (apdu_len < wp_data->application_data_len) {
+        len = bacnet_device_object_property_reference_decode(
+            &wp_data->application_data[apdu_len],
+            wp_data->application_data_len - apdu_len, &reference);
+        if (len <= 0) {
+            wp_data->error_class = ERROR_CLASS_PROPERTY;
+            wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+            return false;
+        }
+        if (count >= BACNET_SCHEDULE_OBJ_PROP_REF_SIZE) {
+            wp_data->error_class = ERROR_CLASS_RESOURCES;
+            wp_data->error_code = ERROR_CODE_NO_SPACE_TO_WRITE_PROPERTY;
+            return false;
+        }
+        references[count++] = reference;
+        apdu_len += len;
+    }
+    if (count) {
+        memcpy(desc->Object_Property_References, references,
+            count * sizeof(references[0]));
+    }
+    desc->obj_prop_ref_cnt = (uint8_t)count;
+
+    return true;
+}
+
 bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
 {
-    unsigned object_index;
+    SCHEDULE_DESCR *desc;
+    BACNET_PRIMITIVE_DATA_VALUE primitive;
+    BACNET_DATE start_date;
     bool status = false; /* return value */
     int len;
     BACNET_APPLICATION_DATA_VALUE value;
 
-    /* decode the some of the request */
-    len = bacapp_decode_application_data(
-        wp_data->application_data, wp_data->application_data_len, &value);
-    /* FIXME: len < application_data_len: more data? */
-    if (len < 0) {
-        /* error while decoding - a value larger than we can handle */
-        wp_data->error_class = ERROR_CLASS_PROPERTY;
-        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+    desc = Schedule_Object(wp_data->object_instance);
+    if (!desc) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
         return false;
     }
-
-    object_index = Schedule_Instance_To_Index(wp_data->object_instance);
-    if (object_index >= MAX_SCHEDULES) {
+    if ((wp_data->object_property != PROP_WEEKLY_SCHEDULE) &&
+        (wp_data->object_property != PROP_EXCEPTION_SCHEDULE) &&
+        (wp_data->array_index != BACNET_ARRAY_ALL)) {
+        /*  only array properties can have array options */
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_PROPERTY_IS_NOT_AN_ARRAY;
         return false;
     }
-
     switch ((int)wp_data->object_property) {
+        case PROP_WEEKLY_SCHEDULE:
+            status = Schedule_Weekly_Schedule_Write(desc, wp_data);
+            break;
+#if BACNET_EXCEPTION_SCHEDULE_SIZE
+        case PROP_EXCEPTION_SCHEDULE:
+            status = Schedule_Exception_Schedule_Write(desc, wp_data);
+            break;
+#endif
+        case PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES:
+            status = Schedule_References_Write(desc, wp_data);
+            break;
         case PROP_OUT_OF_SERVICE:
-            status = write_property_type_valid(
-                wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
-            if (status) {
-                Schedule_Out_Of_Service_Set(
-                    wp_data->object_instance, value.type.Boolean);
+        case PROP_SCHEDULE_DEFAULT:
+        case PROP_PRIORITY_FOR_WRITING:
+        case PROP_EFFECTIVE_PERIOD:
+            /* decode the some of the request */
+            len = bacapp_decode_application_data(wp_data->application_data,
+                wp_data->application_data_len, &value);
+            if (len < 0) {
+                /* error while decoding - a value larger than we can handle */
+                wp_data->error_class = ERROR_CLASS_PROPERTY;
+                wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                return false;
+            }
+            if (wp_data->object_property == PROP_OUT_OF_SERVICE) {
+                status = write_property_type_valid(
+                    wp_data, &value, BACNET_APPLICATION_TAG_BOOLEAN);
+                if (status) {
+                    Schedule_Out_Of_Service_Set(
+                        wp_data->object_instance, value.type.Boolean);
+                }
+            } else if (wp_data->object_property == PROP_SCHEDULE_DEFAULT) {
+                /* only the primitive datatypes can be scheduled */
+                if (bacnet_application_to_primitive_data_value(
+                        &primitive, &value) == 0) {
+                    memcpy(&desc->Schedule_Default, &value,
+                        sizeof(desc->Schedule_Default));
+                    status = true;
+                } else {
+                    wp_data->error_class = ERROR_CLASS_PROPERTY;
+                    wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+                }
+            } else if (wp_data->object_property == PROP_PRIORITY_FOR_WRITING) {
+                status = write_property_type_valid(
+                    wp_data, &value, BACNET_APPLICATION_TAG_UNSIGNED_INT);
+                if (status) {
+                    if ((value.type.Unsigned_Int >= BACNET_MIN_PRIORITY) &&
+                        (value.type.Unsigned_Int <= BACNET_MAX_PRIORITY)) {
+                        desc->Priority_For_Writing =
+                            (uint8_t)value.type.Unsigned_Int;
+                    } else {
+                        status = false;
+                        wp_data->error_class = ERROR_CLASS_PROPERTY;
+                        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+                    }
+                }
+            } else {
+                /* BACnetDateRange is the start and end dates */
+                status = write_property_type_valid(
+                    wp_data, &value, BACNET_APPLICATION_TAG_DATE);
+                if (status) {
+                    datetime_copy_date(&start_date, &value.type.Date);
+                    len = bacapp_decode_application_data(
+                        &wp_data->application_data[len],
+                        wp_data->application_data_len - len, &value);
+                    if ((len > 0) &&
+                        (value.tag == BACNET_APPLICATION_TAG_DATE)) {
+                        datetime_copy_date(&desc->Start_Date, &start_date);
+                        datetime_copy_date(&desc->End_Date, &value.type.Date);
+                    } else {
+                        status = false;
+                        wp_data->error_class = ERROR_CLASS_PROPERTY;
+                        wp_data->error_code = ERROR_CODE_INVALID_DATA_TYPE;
+                    }
+                }
             }
             break;
         default:
             if (property_lists_member(
-                Schedule_Properties_Required, Schedule_Properties_Optional, 
+                Schedule_Properties_Required, Schedule_Properties_Optional,
                 Schedule_Properties_Proprietary, wp_data->object_property)) {
                 wp_data->error_class = ERROR_CLASS_PROPERTY;
                 wp_data->error_code = ERROR_CODE_WRITE_ACCESS_DENIED;
@@ -449,6 +729,10 @@ bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
             }
             break;
     }
+    if (status) {
+        /* compile the schedule again at the next update */
+        desc->Timeline_Valid = false;
+    }
 
     return status;
 }
@@ -473,8 +757,441 @@ bool Schedule_In_Effective_Period(SCHEDULE_DESCR *desc, BACNET_DATE *date)
     return res;
 }
 
+/**
+ * @brief Convert a time of the day into hundredths of a second
+ * @param btime - time of the day, where wildcards are zero
+ * @return hundredths of a second since midnight
+ */
+static uint32_t Schedule_Time_Hundredths(const BACNET_TIME *btime)
+{
+    uint32_t hour = 0, minute = 0, second = 0, hundredths = 0;
+
+    if (btime->hour != 0xFF) {
+        hour = btime->hour;
+    }
+    if (btime->min != 0xFF) {
+        minute = btime->min;
+    }
+    if (btime->sec != 0xFF) {
+        second = btime->sec;
+    }
+    if (btime->hundredths != 0xFF) {
+        hundredths = btime->hundredths;
+    }
+
+    return (((hour * 60UL) + minute) * 60UL + second) * 100UL + hundredths;
+}
+
+/**
+ * @brief Compare two primitive values
+ * @param value1 - primitive value, or NULL for the Schedule_Default
+ * @param value2 - primitive value, or NULL for the Schedule_Default
+ * @return true if the values are the same
+ */
+static bool Schedule_Primitive_Same(const BACNET_PRIMITIVE_DATA_VALUE *value1,
+    const BACNET_PRIMITIVE_DATA_VALUE *value2)
+{
+    if (value1 && (value1->tag == BACNET_APPLICATION_TAG_NULL)) {
+        value1 = NULL;
+    }
+    if (value2 && (value2->tag == BACNET_APPLICATION_TAG_NULL)) {
+        value2 = NULL;
+    }
+    if (!value1 || !value2) {
+        return (value1 == value2);
+    }
+    if (value1->tag != value2->tag) {
+        return false;
+    }
+    switch (value1->tag) {
+#if defined(BACAPP_BOOLEAN)
+        case BACNET_APPLICATION_TAG_BOOLEAN:
+            return (value1->type.Boolean == value2->type.Boolean);
+#endif
+#if defined(BACAPP_UNSIGNED)
+        case BACNET_APPLICATION_TAG_UNSIGNED_INT:
+            return (value1->type.Unsigned_Int == value2->type.Unsigned_Int);
+#endif
+#if defined(BACAPP_SIGNED)
+        case BACNET_APPLICATION_TAG_SIGNED_INT:
+            return (value1->type.Signed_Int == value2->type.Signed_Int);
+#endif
+#if defined(BACAPP_REAL)
+        case BACNET_APPLICATION_TAG_REAL:
+            return !islessgreater(value1->type.Real, value2->type.Real);
+#endif
+#if defined(BACAPP_DOUBLE)
+        case BACNET_APPLICATION_TAG_DOUBLE:
+            return !islessgreater(value1->type.Double, value2->type.Double);
+#endif
+#if defined(BACAPP_ENUMERATED)
+        case BACNET_APPLICATION_TAG_ENUMERATED:
+            return (value1->type.Enumerated == value2->type.Enumerated);
+#endif
+        default:
+            break;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Find the lists of time-values that apply to a date, in order
+ *  of priority: the special events of the Exception_Schedule that are
+ *  active on the date, then the day of the Weekly_Schedule.
+ * @param desc - schedule descriptor
+ * @param date - date to evaluate
+ * @param sources - SCHEDULE_SOURCE_MAX lists of time-values
+ * @return number of lists of time-values found
+ */
+static unsigned Schedule_Sources(
+    SCHEDULE_DESCR *desc, BACNET_DATE *date, SCHEDULE_SOURCE *sources)
+{
+    unsigned count = 0;
+#if BACNET_EXCEPTION_SCHEDULE_SIZE
+    BACNET_SPECIAL_EVENT *event;
+    SCHEDULE_SOURCE source;
+    bool active;
+    unsigned e, i;
+#endif
+
+    if (!Schedule_In_Effective_Period(desc, date)) {
+        return 0;
+    }
+#if BACNET_EXCEPTION_SCHEDULE_SIZE
+    for (e = 0; e < BACNET_EXCEPTION_SCHEDULE_SIZE; e++) {
+        event = &desc->Exception_Schedule[e];
+        if (event->timeValues.TV_Count == 0) {
+            continue;
+        }
+        if (event->periodTag == BACNET_SPECIAL_EVENT_PERIOD_CALENDAR_ENTRY) {
+            active = bacapp_date_in_calendar_entry(
+                date, &event->period.calendarEntry);
+        } else {
+            active = Calendar_Callback &&
+                (event->period.calendarReference.type == OBJECT_CALENDAR) &&
+                Calendar_Callback(
+                    event->period.calendarReference.instance, date);
+        }
+        if (!active) {
+            continue;
+        }
+        source.Time_Values = event->timeValues.Time_Values;
+        source.TV_Count = event->timeValues.TV_Count;
+        source.Priority = event->priority;
+        /* same priority: the first special event in the array wins */
+        i = count;
+        while ((i > 0) && (sources[i - 1].Priority > source.Priority)) {
+            sources[i] = sources[i - 1];
+            i--;
+        }
+        sources[i] = source;
+        count++;
+    }
+#endif
+    if ((date->wday >= 1) && (date->wday <= 7) &&
+        (desc->Weekly_Schedule[date->wday - 1].TV_Count > 0)) {
+        sources[count].Time_Values =
+            desc->Weekly_Schedule[date->wday - 1].Time_Values;
+        sources[count].TV_Count =
+            desc->Weekly_Schedule[date->wday - 1].TV_Count;
+        sources[count].Priority = BACNET_MAX_PRIORITY + 1;
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Determine the value in effect at a time of the day.  In each list
+ *  the latest time-value at or before the time is in effect, and a NULL
+ *  value relinquishes to the lists of lower priority.
+ * @param sources - lists of time-values, in order of priority
+ * @param count - number of lists of time-values
+ * @param now - hundredths of a second since midnight
+ * @return value in effect, or NULL for the Schedule_Default
+ */
+static const BACNET_PRIMITIVE_DATA_VALUE *Schedule_Value_At(
+    const SCHEDULE_SOURCE *sources, unsigned count, uint32_t now)
+{
+    const BACNET_TIME_VALUE *found;
+    uint32_t found_time = 0, tv_time;
+    unsigned s, i;
+
+    for (s = 0; s < count; s++) {
+        found = NULL;
+        for (i = 0; i < sources[s].TV_Count; i++) {
+            tv_time = Schedule_Time_Hundredths(&sources[s].Time_Values[i].Time);
+            if ((tv_time <= now) && (!found || (tv_time >= found_time))) {
+                found = &sources[s].Time_Values[i];
+                found_time = tv_time;
+            }
+        }
+        if (found && (found->Value.tag != BACNET_APPLICATION_TAG_NULL)) {
+            return &found->Value;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Compile the transitions of the rest of the day into the timeline.
+ *  Only the earliest BACNET_SCHEDULE_TIMELINE_SIZE transitions are kept,
+ *  and the rest are compiled when the timeline runs out.
+ * @param desc - schedule descriptor
+ * @param date - date to compile
+ * @param now - hundredths of a second since midnight
+ * @return value in effect now, or NULL for the Schedule_Default
+ */
+static const BACNET_PRIMITIVE_DATA_VALUE *Schedule_Compile(
+    SCHEDULE_DESCR *desc, BACNET_DATE *date, uint32_t now)
+{
+    SCHEDULE_SOURCE sources[SCHEDULE_SOURCE_MAX] = { { 0 } };
+    BACNET_SCHEDULE_TRANSITION *timeline = desc->Timeline;
+    const BACNET_PRIMITIVE_DATA_VALUE *value, *previous, *current;
+    unsigned count, s, i, k, n = 0;
+    uint32_t tv_time;
+
+    count = Schedule_Sources(desc, date, sources);
+    desc->Timeline_More = false;
+    /* the earliest distinct times after now, in order */
+    for (s = 0; s < count; s++) {
+        for (i = 0; i < sources[s].TV_Count; i++) {
+            tv_time = Schedule_Time_Hundredths(&sources[s].Time_Values[i].Time);
+            if (tv_time <= now) {
+                continue;
+            }
+            k = n;
+            while ((k > 0) && (timeline[k - 1].Time > tv_time)) {
+                k--;
+            }
+            if ((k > 0) && (timeline[k - 1].Time == tv_time)) {
+                continue;
+            }
+            if (k >= BACNET_SCHEDULE_TIMELINE_SIZE) {
+                desc->Timeline_More = true;
+                continue;
+            }
+            if (n >= BACNET_SCHEDULE_TIMELINE_SIZE) {
+                /* the latest one is compiled later */
+                n--;
+                desc->Timeline_More = true;
+            }
+            memmove(&timeline[k + 1], &timeline[k],
+                (n - k) * sizeof(timeline[0]));
+            timeline[k].Time = tv_time;
+            n++;
+        }
+    }
+    /* the value after each time, without the ones that change nothing,
+       except the last one when there are more to compile then */
+    current = Schedule_Value_At(sources, count, now);
+    previous = current;
+    for (i = 0, k = 0; i < n; i++) {
+        value = Schedule_Value_At(sources, count, timeline[i].Time);
+        if (Schedule_Primitive_Same(previous, value) &&
+            !(desc->Timeline_More && (i == (n - 1)))) {
+            continue;
+        }
+        timeline[k].Time = timeline[i].Time;
+        if (value) {
+            timeline[k].Value = *value;
+        } else {
+            timeline[k].Value.tag = BACNET_APPLICATION_TAG_NULL;
+        }
+        previous = value;
+        k++;
+    }
+    desc->Timeline_Count = (uint8_t)k;
+    desc->Timeline_Index = 0;
+    desc->Timeline_Valid = true;
+    desc->Timeline_Time = now;
+    datetime_copy_date(&desc->Timeline_Date, date);
+
+    return current;
+}
+
+/**
+ * @brief Write the Present_Value to the referenced properties
+ *  of the objects in this device
+ * @param desc - schedule descriptor
+ */
+static void Schedule_Write_References(SCHEDULE_DESCR *desc)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *reference;
+    unsigned i;
+    int len;
+
+    if (!Write_Property_Internal_Callback || (desc->obj_prop_ref_cnt == 0)) {
+        return;
+    }
+    len = bacapp_encode_application_data(
+        wp_data.application_data, &desc->Present_Value);
+    if (len <= 0) {
+        return;
+    }
+    wp_data.application_data_len = len;
+    wp_data.priority = desc->Priority_For_Writing;
+    for (i = 0; i < desc->obj_prop_ref_cnt; i++) {
+        reference = &desc->Object_Property_References[i];
+        /* NOTE: our implementation is for internal objects only */
+        if ((reference->deviceIdentifier.type == OBJECT_DEVICE) &&
+            (reference->deviceIdentifier.instance !=
+                Device_Object_Instance_Number())) {
+            continue;
+        }
+        wp_data.object_type = reference->objectIdentifier.type;
+        wp_data.object_instance = reference->objectIdentifier.instance;
+        wp_data.object_property = reference->propertyIdentifier;
+        wp_data.array_index = reference->arrayIndex;
+        (void)Write_Property_Internal_Callback(&wp_data);
+    }
+}
+
+/**
+ * @brief Set the Present_Value, and write it to the referenced
+ *  properties if it changed
+ * @param desc - schedule descriptor
+ * @param value - value in effect, or NULL for the Schedule_Default
+ * @return true if the Present_Value changed
+ */
+static bool Schedule_Present_Value_Apply(
+    SCHEDULE_DESCR *desc, const BACNET_PRIMITIVE_DATA_VALUE *value)
+{
+    BACNET_PRIMITIVE_DATA_VALUE current;
+
+    if (!value || (value->tag == BACNET_APPLICATION_TAG_NULL)) {
+        if (bacapp_same_value(&desc->Present_Value, &desc->Schedule_Default)) {
+            return false;
+        }
+        memcpy(&desc->Present_Value, &desc->Schedule_Default,
+            sizeof(desc->Present_Value));
+    } else {
+        if ((bacnet_application_to_primitive_data_value(
+                 &current, &desc->Present_Value) == 0) &&
+            Schedule_Primitive_Same(&current, value)) {
+            return false;
+        }
+        bacnet_primitive_to_application_data_value(
+            &desc->Present_Value, value);
+    }
+    Schedule_Write_References(desc);
+
+    return true;
+}
+
+/**
+ * @brief Update the Present_Value of a Schedule object for the date and
+ *  time.  The schedule is compiled into a timeline of transitions when
+ *  the date changes, when the time goes backwards, or after the schedule
+ *  was written, so that the other updates only compare the time to the
+ *  next transition.  The referenced properties are written when the
+ *  Present_Value changes.
+ * @param object_instance - object-instance number of the object
+ * @param date - local date
+ * @param time - local time
+ * @return true if the Present_Value changed
+ */
+bool Schedule_Update(
+    uint32_t object_instance, BACNET_DATE *date, BACNET_TIME *time)
+{
+    SCHEDULE_DESCR *desc;
+    const BACNET_PRIMITIVE_DATA_VALUE *value = NULL;
+    bool transition = false;
+    uint32_t now;
+
+    desc = Schedule_Object(object_instance);
+    if (!desc || !date || !time || desc->Out_Of_Service) {
+        return false;
+    }
+    now = Schedule_Time_Hundredths(time);
+    if (!desc->Timeline_Valid || (now < desc->Timeline_Time) ||
+        (datetime_compare_date(&desc->Timeline_Date, date) != 0)) {
+        value = Schedule_Compile(desc, date, now);
+        return Schedule_Present_Value_Apply(desc, value);
+    }
+    desc->Timeline_Time = now;
+    while ((desc->Timeline_Index < desc->Timeline_Count) &&
+        (desc->Timeline[desc->Timeline_Index].Time <= now)) {
+        value = &desc->Timeline[desc->Timeline_Index].Value;
+        desc->Timeline_Index++;
+        transition = true;
+    }
+    if (!transition) {
+        return false;
+    }
+    if ((desc->Timeline_Index >= desc->Timeline_Count) &&
+        desc->Timeline_More) {
+        value = Schedule_Compile(desc, date, now);
+    }
+
+    return Schedule_Present_Value_Apply(desc, value);
+}
+
+/**
+ * @brief Get the time of the next transition of a Schedule object
+ * @param object_instance - object-instance number of the object
+ * @param time - time of the next transition today
+ * @return true if there is another transition today
+ */
+bool Schedule_Next_Transition(uint32_t object_instance, BACNET_TIME *time)
+{
+    SCHEDULE_DESCR *desc;
+    uint32_t hundredths;
+
+    desc = Schedule_Object(object_instance);
+    if (!desc || !time || !desc->Timeline_Valid ||
+        (desc->Timeline_Index >= desc->Timeline_Count)) {
+        return false;
+    }
+    hundredths = desc->Timeline[desc->Timeline_Index].Time;
+    datetime_seconds_since_midnight_into_time(hundredths / 100, time);
+    time->hundredths = (uint8_t)(hundredths % 100);
+
+    return true;
+}
+
+/**
+ * @brief Updates the Schedule object from the local date and time
+ * @param object_instance - object-instance number of the object
+ * @param milliseconds - number of milliseconds elapsed
+ */
+void Schedule_Timer(uint32_t object_instance, uint16_t milliseconds)
+{
+    BACNET_DATE date;
+    BACNET_TIME time;
+
+    (void)milliseconds;
+    if (datetime_local(&date, &time, NULL, NULL)) {
+        (void)Schedule_Update(object_instance, &date, &time);
+    }
+}
+
+/**
+ * @brief Sets the callback used to write the Present_Value to the
+ *  referenced properties
+ * @param cb - callback used to write the referenced properties
+ */
+void Schedule_Write_Property_Internal_Callback_Set(write_property_function cb)
+{
+    Write_Property_Internal_Callback = cb;
+}
+
+/**
+ * @brief Sets the callback used to resolve the Calendar references
+ *  of the Exception_Schedule
+ * @param cb - callback used to check a date in a Calendar object
+ */
+void Schedule_Calendar_Callback_Set(schedule_calendar_function cb)
+{
+    Calendar_Callback = cb;
+}
+
 /**
  * @brief Recalculate the Present Value of the Schedule object
+ *  from the Weekly_Schedule
  * @param desc - schedule descriptor
  * @param wday - day of the week
  * @param time - time of the day
@@ -482,27 +1199,19 @@ bool Schedule_In_Effective_Period(SCHEDULE_DESCR *desc, BACNET_DATE *date)
 void Schedule_Recalculate_PV(
     SCHEDULE_DESCR *desc, BACNET_WEEKDAY wday, BACNET_TIME *time)
 {
-    int i;
-    desc->Present_Value.tag = BACNET_APPLICATION_TAG_NULL;
-
-    /* for future development, here should be the loop for Exception Schedule */
-
-    /*  Note to developers: please ping Edward at info@connect-ex.com
-        for a more complete schedule object implementation. */
-    for (i = 0; i < desc->Weekly_Schedule[wday - 1].TV_Count &&
-         desc->Present_Value.tag == BACNET_APPLICATION_TAG_NULL;
-         i++) {
-        int diff = datetime_wildcard_compare_time(
-            time, &desc->Weekly_Schedule[wday - 1].Time_Values[i].Time);
-        if (diff >= 0 &&
-            desc->Weekly_Schedule[wday - 1].Time_Values[i].Value.tag !=
-                BACNET_APPLICATION_TAG_NULL) {
-            bacnet_primitive_to_application_data_value(&desc->Present_Value,
-                &desc->Weekly_Schedule[wday - 1].Time_Values[i].Value);
-        }
-    }
+    SCHEDULE_SOURCE source;
+    const BACNET_PRIMITIVE_DATA_VALUE *value = NULL;
 
-    if (desc->Present_Value.tag == BACNET_APPLICATION_TAG_NULL) {
+    if ((wday >= 1) && (wday <= 7)) {
+        source.Time_Values = desc->Weekly_Schedule[wday - 1].Time_Values;
+        source.TV_Count = desc->Weekly_Schedule[wday - 1].TV_Count;
+        source.Priority = BACNET_MAX_PRIORITY + 1;
+        value = Schedule_Value_At(&source, 1, Schedule_Time_Hundredths(time));
+    }
+    if (value) {
+        bacnet_primitive_to_application_data_value(
+            &desc->Present_Value, value);
+    } else {
         memcpy(&desc->Present_Value, &desc->Schedule_Default,
             sizeof(desc->Present_Value));
     }
@@ -33,6 +33,19 @@
 #define BACNET_EXCEPTION_SCHEDULE_SIZE 8 /* maximum number of special events */
 #endif
 
+#ifndef BACNET_SCHEDULE_TIMELINE_SIZE
+#define BACNET_SCHEDULE_TIMELINE_SIZE 8 /* transitions compiled at a time */
+#endif
+
+/**
+ * @brief Callback to determine if a date is in a Calendar object
+ * @param  object_instance - Calendar object-instance number
+ * @param  date - date to check
+ * @return true if the date is in the Calendar
+ */
+typedef bool (*schedule_calendar_function)(
+    uint32_t object_instance, BACNET_DATE *date);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -47,6 +60,13 @@ extern "C" {
         uint16_t TV_Count;      /* the number of time values actually used */
     } BACNET_OBJ_DAILY_SCHEDULE;
 
+    /* a change of the Present_Value at a time of the day */
+    typedef struct bacnet_schedule_transition {
+        uint32_t Time;  /* hundredths of a second since midnight */
+        /* NULL tag is the Schedule_Default */
+        BACNET_PRIMITIVE_DATA_VALUE Value;
+    } BACNET_SCHEDULE_TRANSITION;
+
     typedef struct schedule {
         /* Effective Period: Start and End Date */
         BACNET_DATE Start_Date;
@@ -68,6 +88,14 @@ extern "C" {
         uint8_t obj_prop_ref_cnt;       /* actual number of obj_prop references */
         uint8_t Priority_For_Writing;   /* (1..16) */
         bool Out_Of_Service;
+        /* transitions compiled for the rest of Timeline_Date */
+        BACNET_SCHEDULE_TRANSITION Timeline[BACNET_SCHEDULE_TIMELINE_SIZE];
+        uint8_t Timeline_Count;
+        uint8_t Timeline_Index; /* the next transition */
+        bool Timeline_More;     /* more transitions than were compiled */
+        bool Timeline_Valid;    /* false when the schedule was written */
+        BACNET_DATE Timeline_Date;
+        uint32_t Timeline_Time; /* the last time evaluated */
     } SCHEDULE_DESCR;
 
     BACNET_STACK_EXPORT
@@ -99,13 +127,30 @@ extern "C" {
     bool Schedule_Object_Name(uint32_t object_instance,
         BACNET_CHARACTER_STRING * object_name);
 
+    BACNET_STACK_EXPORT
+    bool Schedule_Update(uint32_t object_instance,
+        BACNET_DATE * date,
+        BACNET_TIME * time);
+    BACNET_STACK_EXPORT
+    bool Schedule_Next_Transition(uint32_t object_instance,
+        BACNET_TIME * time);
+    BACNET_STACK_EXPORT
+    void Schedule_Timer(uint32_t object_instance,
+        uint16_t milliseconds);
+    BACNET_STACK_EXPORT
+    void Schedule_Write_Property_Internal_Callback_Set(
+        write_property_function cb);
+    BACNET_STACK_EXPORT
+    void Schedule_Calendar_Callback_Set(
+        schedule_calendar_function cb);
+
     BACNET_STACK_EXPORT
     int Schedule_Read_Property(BACNET_READ_PROPERTY_DATA * rpdata);
     BACNET_STACK_EXPORT
     bool Schedule_Write_Property(BACNET_WRITE_PROPERTY_DATA * wp_data);
 
     /* utility functions for calculating current Present Value
-     * if Exception Schedule is to be added, these functions must take that into account */
+     * from the Weekly_Schedule only - see Schedule_Update() */
     BACNET_STACK_EXPORT
     bool Schedule_In_Effective_Period(SCHEDULE_DESCR * desc,
         BACNET_DATE * date);
@@ -0,0 +1,381 @@
+/**
+ * @file
+ * @brief Binary snapshot of the object database of this device
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The snapshot holds the values of the properties that are usually
+ * configured or commanded by an operator - names, descriptions, the
+ * priority array and the present value - for every object in the
+ * Object_List, so that a restart does not lose them.  The values are
+ * kept in their BACnet application encoding and are read and written
+ * through the Device object, so any object type works without changes.
+ * A property is only restored where the object accepts a WriteProperty
+ * of it: the Object_Name of most of the basic objects is read-only, so
+ * those objects keep the name they were created with, and an application
+ * that names its objects has to name them again after the restore.
+ *
+ * The snapshot is a header followed by one record per object:
+ *
+ *   header: 'B' 'A' 'C' 'S', version (2), reserved (2), object count (4),
+ *           payload length (4), CRC-32 of the payload (4)
+ *   object: object type (2), object instance (4), property count (1)
+ *   property: property identifier (4), value length (2), value
+ *
+ * All of the numbers are big endian.  A snapshot that does not have
+ * the expected version, length, or CRC-32 is not restored.  Objects that
+ * do not exist are created first, in the order of the Object_List, so
+ * the object lists are built in key order.
+ */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacapp.h"
+#include "bacnet/bacint.h"
+#include "bacnet/create_object.h"
+#include "bacnet/rp.h"
+#include "bacnet/wp.h"
+#include "bacnet/basic/object/device.h"
+#include "bacnet/basic/object/snapshot.h"
+
+/* properties that are kept, in the order they are restored */
+static const BACNET_PROPERTY_ID Snapshot_Properties[] = {
+    PROP_OBJECT_NAME, PROP_DESCRIPTION, PROP_OUT_OF_SERVICE,
+    PROP_RELINQUISH_DEFAULT, PROP_COV_INCREMENT, PROP_PRIORITY_ARRAY,
+    PROP_PRESENT_VALUE
+};
+
+struct snapshot_writer {
+    uint8_t *buffer;
+    size_t size;
+    size_t len;
+    bool overflow;
+};
+
+/* value of the property being encoded */
+static uint8_t Snapshot_Value[MAX_APDU];
+
+/**
+ * @brief Compute the CRC-32 (IEEE 802.3) of a buffer
+ * @param buffer - data to check
+ * @param buffer_size - number of bytes of data
+ * @return CRC-32 of the data
+ */
+uint32_t Device_Snapshot_CRC32(const uint8_t *buffer, size_t buffer_size)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    size_t i;
+    unsigned bit;
+
+    for (i = 0; i < buffer_size; i++) {
+        crc ^= buffer[i];
+        for (bit = 0; bit < 8; bit++) {
+            if (crc & 1UL) {
+                crc = (crc >> 1) ^ 0xEDB88320UL;
+            } else {
+                crc >>= 1;
+            }
+        }
+    }
+
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+/**
+ * @brief Determine if a property is kept in the snapshot
+ * @param property - property identifier
+ * @return true if the value of the property is kept
+ */
+bool Device_Snapshot_Property(BACNET_PROPERTY_ID property)
+{
+    unsigned i;
+
+    for (i = 0; i < ARRAY_SIZE(Snapshot_Properties); i++) {
+        if (Snapshot_Properties[i] == property) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Add some bytes to the snapshot, or only count them
+ * @param writer - snapshot being written
+ * @param data - bytes to add
+ * @param len - number of bytes to add
+ */
+static void snapshot_write(
+    struct snapshot_writer *writer, const uint8_t *data, size_t len)
+{
+    if (writer->buffer) {
+        if ((writer->len + len) > writer->size) {
+            writer->overflow = true;
+        } else if (!writer->overflow) {
+            memcpy(&writer->buffer[writer->len], data, len);
+        }
+    }
+    writer->len += len;
+}
+
+/**
+ * @brief Add the kept properties of one object to the snapshot
+ * @param writer - snapshot being written
+ * @param object_type - type of the object
+ * @param object_instance - instance of the object
+ */
+static void snapshot_object_encode(struct snapshot_writer *writer,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    uint8_t header[7];
+    size_t count_offset;
+    uint8_t count = 0;
+    bool commanded = false;
+    unsigned i;
+    int len;
+
+    (void)encode_unsigned16(&header[0], (uint16_t)object_type);
+    (void)encode_unsigned32(&header[2], object_instance);
+    header[6] = 0;
+    count_offset = writer->len + 6;
+    snapshot_write(writer, header, sizeof(header));
+    for (i = 0; i < ARRAY_SIZE(Snapshot_Properties); i++) {
+        if (commanded && (Snapshot_Properties[i] == PROP_PRESENT_VALUE)) {
+            /* the priority array holds the commanded values */
+            continue;
+        }
+        rpdata.object_type = object_type;
+        rpdata.object_instance = object_instance;
+        rpdata.object_property = Snapshot_Properties[i];
+        rpdata.array_index = BACNET_ARRAY_ALL;
+        rpdata.application_data = Snapshot_Value;
+        rpdata.application_data_len = sizeof(Snapshot_Value);
+        len = Device_Read_Property(&rpdata);
+        if ((len <= 0) || (len > UINT16_MAX)) {
+            continue;
+        }
+        if (Snapshot_Properties[i] == PROP_PRIORITY_ARRAY) {
+            commanded = true;
+        }
+        (void)encode_unsigned32(&header[0], (uint32_t)rpdata.object_property);
+        (void)encode_unsigned16(&header[4], (uint16_t)len);
+        snapshot_write(writer, header, 6);
+        snapshot_write(writer, Snapshot_Value, (size_t)len);
+        count++;
+    }
+    if (writer->buffer && !writer->overflow) {
+        writer->buffer[count_offset] = count;
+    }
+}
+
+/**
+ * @brief Encode a snapshot of the objects of this device
+ * @param buffer - buffer to hold the snapshot, or NULL to get the length
+ * @param buffer_size - size of the buffer
+ * @return number of bytes in the snapshot, or zero if the buffer is
+ *  too small
+ */
+size_t Device_Snapshot_Encode(uint8_t *buffer, size_t buffer_size)
+{
+    struct snapshot_writer writer = { 0 };
+    uint8_t header[DEVICE_SNAPSHOT_HEADER_SIZE] = { 'B', 'A', 'C', 'S' };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint32_t count, i, objects = 0;
+    size_t payload_len;
+
+    writer.buffer = buffer;
+    writer.size = buffer_size;
+    snapshot_write(&writer, header, sizeof(header));
+    count = Device_Object_List_Count();
+    for (i = 1; i <= count; i++) {
+        if (Device_Object_List_Identifier(
+                i, &object_type, &object_instance)) {
+            snapshot_object_encode(&writer, object_type, object_instance);
+            objects++;
+        }
+    }
+    if (!buffer) {
+        return writer.len;
+    }
+    if (writer.overflow) {
+        return 0;
+    }
+    payload_len = writer.len - DEVICE_SNAPSHOT_HEADER_SIZE;
+    (void)encode_unsigned16(&buffer[4], DEVICE_SNAPSHOT_VERSION);
+    (void)encode_unsigned16(&buffer[6], 0);
+    (void)encode_unsigned32(&buffer[8], objects);
+    (void)encode_unsigned32(&buffer[12], (uint32_t)payload_len);
+    (void)encode_unsigned32(&buffer[16],
+        Device_Snapshot_CRC32(
+            &buffer[DEVICE_SNAPSHOT_HEADER_SIZE], payload_len));
+
+    return writer.len;
+}
+
+/**
+ * @brief Get the CRC-32 of the payload from the header of a snapshot.
+ *  Two snapshots of the same objects and values have the same CRC-32.
+ * @param buffer - snapshot
+ * @param buffer_size - number of bytes in the snapshot
+ * @return CRC-32 of the payload, or zero if there is no header
+ */
+uint32_t Device_Snapshot_Header_CRC32(uint8_t *buffer, size_t buffer_size)
+{
+    uint32_t crc = 0;
+
+    if (buffer && (buffer_size >= DEVICE_SNAPSHOT_HEADER_SIZE)) {
+        (void)decode_unsigned32(&buffer[16], &crc);
+    }
+
+    return crc;
+}
+
+/**
+ * @brief Check the header, length, and CRC-32 of a snapshot
+ * @param buffer - snapshot
+ * @param buffer_size - number of bytes in the snapshot
+ * @return true if the snapshot can be restored
+ */
+bool Device_Snapshot_Valid(uint8_t *buffer, size_t buffer_size)
+{
+    uint16_t version = 0;
+    uint32_t payload_len = 0, crc = 0;
+
+    if (!buffer || (buffer_size < DEVICE_SNAPSHOT_HEADER_SIZE)) {
+        return false;
+    }
+    if ((buffer[0] != 'B') || (buffer[1] != 'A') || (buffer[2] != 'C') ||
+        (buffer[3] != 'S')) {
+        return false;
+    }
+    (void)decode_unsigned16(&buffer[4], &version);
+    (void)decode_unsigned32(&buffer[12], &payload_len);
+    crc = Device_Snapshot_Header_CRC32(buffer, buffer_size);
+    if ((version != DEVICE_SNAPSHOT_VERSION) ||
+        (payload_len != (buffer_size - DEVICE_SNAPSHOT_HEADER_SIZE))) {
+        return false;
+    }
+
+    return crc ==
+        Device_Snapshot_CRC32(&buffer[DEVICE_SNAPSHOT_HEADER_SIZE],
+            payload_len);
+}
+
+/**
+ * @brief Restore the commanded values from a priority array
+ * @param wp_data - WriteProperty data for the object
+ * @param value - encoded priority array
+ * @param value_len - number of bytes in the encoded priority array
+ */
+static void snapshot_priority_array_restore(
+    BACNET_WRITE_PROPERTY_DATA *wp_data, uint8_t *value, int value_len)
+{
+    BACNET_APPLICATION_DATA_VALUE element;
+    uint8_t priority;
+    int len, offset = 0;
+
+    for (priority = BACNET_MIN_PRIORITY; priority <= BACNET_MAX_PRIORITY;
+         priority++) {
+        if (offset >= value_len) {
+            break;
+        }
+        len = bacapp_decode_application_data(
+            &value[offset], value_len - offset, &element);
+        if (len <= 0) {
+            break;
+        }
+        if (element.tag != BACNET_APPLICATION_TAG_NULL) {
+            wp_data->object_property = PROP_PRESENT_VALUE;
+            wp_data->priority = priority;
+            memcpy(wp_data->application_data, &value[offset], (size_t)len);
+            wp_data->application_data_len = len;
+            (void)Device_Write_Property(wp_data);
+        }
+        offset += len;
+    }
+}
+
+/**
+ * @brief Restore the objects of this device from a snapshot.  Objects that
+ *  do not exist are created, and then the kept properties are written.
+ *  Properties that are not writable in an object, such as the
+ *  Object_Name of an Analog Output, are skipped and keep their value.
+ * @param buffer - snapshot
+ * @param buffer_size - number of bytes in the snapshot
+ * @return number of objects restored, or BACNET_STATUS_ERROR if the
+ *  snapshot is not valid
+ */
+int Device_Snapshot_Restore(uint8_t *buffer, size_t buffer_size)
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint16_t object_type = 0, value_len = 0;
+    uint32_t object_instance = 0, property = 0;
+    uint8_t count, i;
+    size_t offset = DEVICE_SNAPSHOT_HEADER_SIZE;
+    int objects = 0;
+    bool exists;
+
+    if (!Device_Snapshot_Valid(buffer, buffer_size)) {
+        return BACNET_STATUS_ERROR;
+    }
+    while (offset < buffer_size) {
+        if ((offset + 7) > buffer_size) {
+            return BACNET_STATUS_ERROR;
+        }
+        (void)decode_unsigned16(&buffer[offset], &object_type);
+        (void)decode_unsigned32(&buffer[offset + 2], &object_instance);
+        count = buffer[offset + 6];
+        offset += 7;
+        exists = Device_Valid_Object_Id(object_type, object_instance);
+        if (!exists) {
+            create_data.object_type = object_type;
+            create_data.object_instance = object_instance;
+            create_data.list_of_initial_values = NULL;
+            exists = Device_Create_Object(&create_data);
+        }
+        if (exists) {
+            objects++;
+        }
+        for (i = 0; i < count; i++) {
+            if ((offset + 6) > buffer_size) {
+                return BACNET_STATUS_ERROR;
+            }
+            (void)decode_unsigned32(&buffer[offset], &property);
+            (void)decode_unsigned16(&buffer[offset + 4], &value_len);
+            offset += 6;
+            if (((offset + value_len) > buffer_size) ||
+                (value_len > sizeof(wp_data.application_data))) {
+                return BACNET_STATUS_ERROR;
+            }
+            if (exists) {
+                wp_data.object_type = object_type;
+                wp_data.object_instance = object_instance;
+                wp_data.array_index = BACNET_ARRAY_ALL;
+                wp_data.priority = BACNET_MAX_PRIORITY;
+                if (property == PROP_PRIORITY_ARRAY) {
+                    snapshot_priority_array_restore(
+                        &wp_data, &buffer[offset], value_len);
+                } else {
+                    wp_data.object_property = property;
+                    memcpy(
+                        wp_data.application_data, &buffer[offset], value_len);
+                    wp_data.application_data_len = value_len;
+                    (void)Device_Write_Property(&wp_data);
+                }
+            }
+            offset += value_len;
+        }
+    }
+
+    return objects;
+}
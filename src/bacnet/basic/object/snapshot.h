@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @brief API for a binary snapshot of the object database of this device
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_BASIC_OBJECT_SNAPSHOT_H
+#define BACNET_BASIC_OBJECT_SNAPSHOT_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* snapshot format version, incremented when the layout changes */
+#define DEVICE_SNAPSHOT_VERSION 1
+/* magic, version, reserved, object count, payload length, CRC-32 */
+#define DEVICE_SNAPSHOT_HEADER_SIZE 20
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    size_t Device_Snapshot_Encode(
+        uint8_t *buffer,
+        size_t buffer_size);
+    BACNET_STACK_EXPORT
+    uint32_t Device_Snapshot_Header_CRC32(
+        uint8_t *buffer,
+        size_t buffer_size);
+    BACNET_STACK_EXPORT
+    bool Device_Snapshot_Valid(
+        uint8_t *buffer,
+        size_t buffer_size);
+    BACNET_STACK_EXPORT
+    int Device_Snapshot_Restore(
+        uint8_t *buffer,
+        size_t buffer_size);
+    BACNET_STACK_EXPORT
+    bool Device_Snapshot_Property(
+        BACNET_PROPERTY_ID property);
+    BACNET_STACK_EXPORT
+    uint32_t Device_Snapshot_CRC32(
+        const uint8_t *buffer,
+        size_t buffer_size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
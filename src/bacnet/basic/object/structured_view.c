@@ -25,6 +25,7 @@
 #include "bacnet/abort.h"
 #include "bacnet/proplist.h"
 #include "bacnet/property.h"
+#include "bacnet/readrange.h"
 #include "bacnet/reject.h"
 #include "bacnet/rp.h"
 #include "bacnet/basic/services.h"
@@ -38,6 +39,9 @@ struct object_data {
     BACNET_NODE_TYPE Node_Type;
     const char *Node_Subtype;
     BACNET_SUBORDINATE_DATA *Subordinate_List;
+    /* contiguous index of the Subordinate_List members */
+    BACNET_SUBORDINATE_DATA **Subordinate_Index;
+    unsigned Subordinate_Index_Count;
     BACNET_RELATIONSHIP Default_Subordinate_Relationship;
     BACNET_DEVICE_OBJECT_REFERENCE Represents;
 };
@@ -355,10 +359,48 @@ Structured_View_Subordinate_List(uint32_t object_instance)
     return subordinate_list;
 }
 
+/**
+ * @brief Builds the contiguous index of the Subordinate_List members,
+ *  so that a member can be found by its position without walking the list
+ * @param pObject - object instance data
+ */
+static void Structured_View_Subordinate_Index_Build(struct object_data *pObject)
+{
+    BACNET_SUBORDINATE_DATA *subordinate_list;
+    BACNET_SUBORDINATE_DATA **index_list;
+    unsigned count = 0;
+
+    pObject->Subordinate_Index_Count = 0;
+    subordinate_list = pObject->Subordinate_List;
+    while (subordinate_list) {
+        count++;
+        subordinate_list = subordinate_list->next;
+    }
+    if (count == 0) {
+        return;
+    }
+    index_list = realloc(
+        pObject->Subordinate_Index, count * sizeof(*index_list));
+    if (!index_list) {
+        return;
+    }
+    pObject->Subordinate_Index = index_list;
+    count = 0;
+    subordinate_list = pObject->Subordinate_List;
+    while (subordinate_list) {
+        index_list[count] = subordinate_list;
+        count++;
+        subordinate_list = subordinate_list->next;
+    }
+    pObject->Subordinate_Index_Count = count;
+}
+
 /**
  * @brief For a given object instance-number, sets the Subordinate_List
  * @param  object_instance - object-instance number of the object
  * @param  subordinate_list - holds the Subordinate_List to be set
+ * @note The members are indexed when the list is set, so set the list
+ *  again after changing its members.
  */
 void Structured_View_Subordinate_List_Set(
     uint32_t object_instance, BACNET_SUBORDINATE_DATA *subordinate_list)
@@ -368,6 +410,7 @@ void Structured_View_Subordinate_List_Set(
     pObject = Keylist_Data(Object_List, object_instance);
     if (pObject) {
         pObject->Subordinate_List = subordinate_list;
+        Structured_View_Subordinate_Index_Build(pObject);
     }
 }
 
@@ -496,7 +539,9 @@ BACNET_SUBORDINATE_DATA *Structured_View_Subordinate_List_Member(
     struct object_data *pObject;
 
     pObject = Keylist_Data(Object_List, object_instance);
-    if (pObject) {
+    if (pObject && (array_index < pObject->Subordinate_Index_Count)) {
+        subordinate_list = pObject->Subordinate_Index[array_index];
+    } else if (pObject) {
         subordinate_list = pObject->Subordinate_List;
         while (subordinate_list) {
             if (index == array_index) {
@@ -767,6 +812,117 @@ int Structured_View_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata)
     return apdu_len;
 }
 
+/**
+ * @brief Encode the Subordinate_List elements requested by a ReadRange
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @return number of bytes encoded, or a negative value on error
+ */
+static int Structured_View_Subordinate_List_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    return rr_array_encode(apdu, pRequest,
+        Structured_View_Subordinate_List_Count(pRequest->object_instance),
+        Structured_View_Subordinate_List_Element_Encode);
+}
+
+/**
+ * @brief Encode the Subordinate_Annotations elements requested by a
+ *  ReadRange
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @return number of bytes encoded, or a negative value on error
+ */
+static int Structured_View_Subordinate_Annotations_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    return rr_array_encode(apdu, pRequest,
+        Structured_View_Subordinate_List_Count(pRequest->object_instance),
+        Structured_View_Subordinate_Annotations_Element_Encode);
+}
+
+/**
+ * @brief Encode the Subordinate_Node_Types elements requested by a
+ *  ReadRange
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @return number of bytes encoded, or a negative value on error
+ */
+static int Structured_View_Subordinate_Node_Types_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    return rr_array_encode(apdu, pRequest,
+        Structured_View_Subordinate_List_Count(pRequest->object_instance),
+        Structured_View_Subordinate_Node_Types_Element_Encode);
+}
+
+/**
+ * @brief Encode the Subordinate_Relationships elements requested by a
+ *  ReadRange
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @return number of bytes encoded, or a negative value on error
+ */
+static int Structured_View_Subordinate_Relationships_Read_Range(
+    uint8_t *apdu, BACNET_READ_RANGE_DATA *pRequest)
+{
+    return rr_array_encode(apdu, pRequest,
+        Structured_View_Subordinate_List_Count(pRequest->object_instance),
+        Structured_View_Subordinate_Relationships_Element_Encode);
+}
+
+/**
+ * @brief Get the ReadRange information of a property of the object.
+ *  The Subordinate_List and its companion arrays can be read by position.
+ * @param pRequest - ReadRange request data
+ * @param pInfo - where to put the request types and handler
+ * @return true if the property can be read with ReadRange
+ */
+bool Structured_View_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo)
+{
+    bool status = false;
+
+    if (!pRequest || !pInfo) {
+        return false;
+    }
+    if (!Structured_View_Valid_Instance(pRequest->object_instance)) {
+        pRequest->error_class = ERROR_CLASS_OBJECT;
+        pRequest->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    pInfo->RequestTypes = RR_BY_POSITION;
+    pInfo->Handler = NULL;
+    switch (pRequest->object_property) {
+        case PROP_SUBORDINATE_LIST:
+            pInfo->Handler = Structured_View_Subordinate_List_Read_Range;
+            break;
+        case PROP_SUBORDINATE_ANNOTATIONS:
+            pInfo->Handler = Structured_View_Subordinate_Annotations_Read_Range;
+            break;
+        case PROP_SUBORDINATE_NODE_TYPES:
+            pInfo->Handler = Structured_View_Subordinate_Node_Types_Read_Range;
+            break;
+        case PROP_SUBORDINATE_RELATIONSHIPS:
+            pInfo->Handler =
+                Structured_View_Subordinate_Relationships_Read_Range;
+            break;
+        default:
+            pRequest->error_class = ERROR_CLASS_SERVICES;
+            pRequest->error_code = ERROR_CODE_PROPERTY_IS_NOT_A_LIST;
+            if (pRequest->array_index == BACNET_ARRAY_ALL) {
+                pRequest->error_class = ERROR_CLASS_PROPERTY;
+                pRequest->error_code = ERROR_CODE_UNKNOWN_PROPERTY;
+            }
+            break;
+    }
+    if (pInfo->Handler) {
+        status = true;
+    }
+
+    return status;
+}
+
 /**
  * Creates a Structured View object
  * @param object_instance - object-instance number of the object
@@ -797,6 +953,8 @@ uint32_t Structured_View_Create(uint32_t object_instance)
         pObject->Description = NULL;
         pObject->Node_Subtype = NULL;
         pObject->Subordinate_List = NULL;
+        pObject->Subordinate_Index = NULL;
+        pObject->Subordinate_Index_Count = 0;
         pObject->Default_Subordinate_Relationship = BACNET_RELATIONSHIP_DEFAULT;
         pObject->Represents.deviceIdentifier.type = OBJECT_NONE;
         pObject->Represents.deviceIdentifier.instance = BACNET_MAX_INSTANCE;
@@ -826,6 +984,7 @@ bool Structured_View_Delete(uint32_t object_instance)
 
     pObject = Keylist_Data_Delete(Object_List, object_instance);
     if (pObject) {
+        free(pObject->Subordinate_Index);
         free(pObject);
         status = true;
     }
@@ -844,6 +1003,7 @@ void Structured_View_Cleanup(void)
         do {
             pObject = Keylist_Data_Pop(Object_List);
             if (pObject) {
+                free(pObject->Subordinate_Index);
                 free(pObject);
             }
         } while (pObject);
@@ -15,6 +15,7 @@
 #include "bacnet/bacerror.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/bacdevobjpropref.h"
+#include "bacnet/readrange.h"
 #include "bacnet/rp.h"
 
 struct BACnetSubordinateData;
@@ -53,6 +54,9 @@ bool Structured_View_Name_Set(uint32_t object_instance, char *new_name);
 
 BACNET_STACK_EXPORT
 int Structured_View_Read_Property(BACNET_READ_PROPERTY_DATA *rpdata);
+BACNET_STACK_EXPORT
+bool Structured_View_Read_Range_Info(
+    BACNET_READ_RANGE_DATA *pRequest, RR_PROP_INFO *pInfo);
 
 BACNET_STACK_EXPORT
 char *Structured_View_Description(uint32_t object_instance);
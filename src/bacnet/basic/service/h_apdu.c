@@ -20,6 +20,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /* APDU Timeout in Milliseconds */
 static uint16_t Timeout_Milliseconds = 3000;
@@ -559,6 +560,7 @@ void apdu_handler(
     uint8_t *service_request = NULL;
     uint16_t service_request_len = 0;
     int len = 0; /* counts where we are in PDU */
+    uint32_t metrics_start = 0;
 #if !BACNET_SVC_SERVER
     uint8_t invoke_id = 0;
     BACNET_CONFIRMED_SERVICE_ACK_DATA service_ack_data = { 0 };
@@ -582,6 +584,7 @@ void apdu_handler(
                 &service_request, &service_request_len);
             if (len == 0) {
                 /* service data unable to be decoded - simply drop */
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_APDU_RX_DROPPED);
                 break;
             }
             if (apdu_confirmed_dcc_disabled(service_choice)) {
@@ -593,8 +596,10 @@ void apdu_handler(
             }
             if ((service_choice < MAX_BACNET_CONFIRMED_SERVICE) &&
                 (Confirmed_Function[service_choice])) {
+                metrics_start = BACNET_METRICS_TIMESTAMP();
                 Confirmed_Function[service_choice](
                     service_request, service_request_len, src, &service_data);
+                BACNET_METRICS_CONFIRMED_SERVICE(service_choice, metrics_start);
             } else if (Unrecognized_Service_Handler) {
                 Unrecognized_Service_Handler(
                     service_request, service_request_len, src, &service_data);
@@ -602,6 +607,7 @@ void apdu_handler(
             break;
         case PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST:
             if (apdu_len < 2) {
+                BACNET_METRICS_INCREMENT(BACNET_METRIC_APDU_RX_DROPPED);
                 break;
             }
             service_choice = apdu[1];
@@ -619,8 +625,11 @@ void apdu_handler(
             }
             if (service_choice < MAX_BACNET_UNCONFIRMED_SERVICE) {
                 if (Unconfirmed_Function[service_choice]) {
+                    metrics_start = BACNET_METRICS_TIMESTAMP();
                     Unconfirmed_Function[service_choice](
                         service_request, service_request_len, src);
+                    BACNET_METRICS_UNCONFIRMED_SERVICE(
+                        service_choice, metrics_start);
                 }
             }
             break;
@@ -8,8 +8,10 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <math.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -29,6 +31,7 @@
 #include "bacnet/basic/tsm/tsm.h"
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/datalink.h"
 
 #ifndef MAX_COV_PROPERTIES
@@ -66,6 +69,155 @@ static BACNET_COV_SUBSCRIPTION COV_Subscriptions[MAX_COV_SUBCRIPTIONS];
 #endif
 static BACNET_COV_ADDRESS COV_Addresses[MAX_COV_ADDRESSES];
 
+/* A SubscribeCOVProperty or SubscribeCOVPropertyMultiple context is
+   the subscriber address and process identifier, and owns one (single)
+   or many (multiple) monitored property references. */
+typedef struct BACnet_COV_Property_Context {
+    bool valid : 1;
+    bool multiple : 1;
+    bool issueConfirmedNotifications : 1;
+    /* at least one reference has changed */
+    bool send_pending : 1;
+    unsigned dest_index;
+    uint8_t invokeID; /* for confirmed COV */
+    uint32_t subscriberProcessIdentifier;
+    uint32_t lifetime; /* zero is indefinite */
+    uint32_t maxNotificationDelay;
+    /* seconds left to coalesce changes before they are sent */
+    uint32_t delay;
+    /* monitored property references, in the order they were added */
+    uint16_t reference_head;
+    uint16_t reference_tail;
+    uint16_t reference_count;
+} BACNET_COV_PROPERTY_CONTEXT;
+
+/* encodings up to this size are kept in the reference itself */
+#ifndef COV_PROPERTY_VALUE_SIZE
+#define COV_PROPERTY_VALUE_SIZE 8
+#endif
+
+/* the encoding of the last value reported, compared bytewise with the
+   value read to find a change.  A longer encoding is allocated. */
+typedef struct BACnet_COV_Property_Value {
+    uint16_t len;
+    uint8_t data[COV_PROPERTY_VALUE_SIZE];
+    uint8_t *heap;
+} BACNET_COV_PROPERTY_VALUE;
+
+typedef struct BACnet_COV_Property_Reference {
+    bool valid : 1;
+    bool covIncrementPresent : 1;
+    bool timestamped : 1;
+    bool send_requested : 1;
+    /* the last value is known */
+    bool value_present : 1;
+    uint16_t context_index;
+    /* next reference of the context, or of the free list */
+    uint16_t next;
+    BACNET_OBJECT_ID monitoredObjectIdentifier;
+    BACNET_PROPERTY_REFERENCE monitoredProperty;
+    float covIncrement;
+    /* last value reported, when it is a REAL with a COV increment */
+    float value_real;
+    /* last value, and last Status_Flags (single only) */
+    BACNET_COV_PROPERTY_VALUE value;
+    BACNET_COV_PROPERTY_VALUE status;
+    BACNET_TIME timeOfChange;
+} BACNET_COV_PROPERTY_REFERENCE;
+
+/* each SubscribeCOVProperty has its own context, so there are as many
+   contexts as SubscribeCOV subscriptions */
+#ifndef MAX_COV_PROPERTY_CONTEXTS
+#define MAX_COV_PROPERTY_CONTEXTS MAX_COV_SUBCRIPTIONS
+#endif
+static BACNET_COV_PROPERTY_CONTEXT COV_Property_Contexts
+    [MAX_COV_PROPERTY_CONTEXTS];
+#ifndef MAX_COV_PROPERTY_REFERENCES
+#define MAX_COV_PROPERTY_REFERENCES 512
+#endif
+#if (MAX_COV_PROPERTY_REFERENCES > UINT16_MAX)
+#error "MAX_COV_PROPERTY_REFERENCES must fit the uint16_t reference links"
+#endif
+static BACNET_COV_PROPERTY_REFERENCE COV_Property_References
+    [MAX_COV_PROPERTY_REFERENCES];
+/* end of a list of references */
+#define COV_PROPERTY_REFERENCE_NONE MAX_COV_PROPERTY_REFERENCES
+/* unused references, and the number of used ones */
+static uint16_t COV_Property_Reference_Free;
+static unsigned COV_Property_Reference_Count;
+/* number of references checked for a change per task cycle */
+#ifndef COV_PROPERTY_MARK_BATCH
+#define COV_PROPERTY_MARK_BATCH 16
+#endif
+/* number of values in one COVNotificationMultiple */
+#ifndef MAX_COV_NOTIFY_MULTIPLE_VALUES
+#define MAX_COV_NOTIFY_MULTIPLE_VALUES 64
+#endif
+/* number of references in one SubscribeCOVPropertyMultiple request */
+#ifndef MAX_COV_SUBSCRIBE_MULTIPLE_REFERENCES
+#define MAX_COV_SUBSCRIBE_MULTIPLE_REFERENCES (MAX_APDU / 6)
+#endif
+/* upper limit of the seconds that changes are coalesced, whatever the
+   maxNotificationDelay of the subscriber is */
+#ifndef COV_MAX_NOTIFICATION_DELAY
+#define COV_MAX_NOTIFICATION_DELAY 5
+#endif
+static uint32_t COV_Max_Notification_Delay = COV_MAX_NOTIFICATION_DELAY;
+
+/**
+ * @brief Compare an encoded value with the last one, and keep it when
+ *  it is different
+ * @param value - last value
+ * @param data - encoded value
+ * @param data_len - number of bytes in the encoded value
+ * @return true if the value is different from the last one
+ */
+static bool cov_property_value_update(
+    BACNET_COV_PROPERTY_VALUE *value, const uint8_t *data, int data_len)
+{
+    uint8_t *stored;
+
+    if ((data_len < 0) || (data_len > UINT16_MAX)) {
+        return false;
+    }
+    stored = value->data;
+    if (value->len > sizeof(value->data)) {
+        stored = value->heap;
+    }
+    if ((value->len == data_len) && (memcmp(stored, data, data_len) == 0)) {
+        return false;
+    }
+    if ((size_t)data_len > sizeof(value->data)) {
+        stored = realloc(value->heap, (size_t)data_len);
+        if (!stored) {
+            /* not kept, so the next value is a change too */
+            free(value->heap);
+            value->heap = NULL;
+            value->len = 0;
+            return true;
+        }
+        value->heap = stored;
+    }
+    memcpy(stored, data, (size_t)data_len);
+    value->len = (uint16_t)data_len;
+
+    return true;
+}
+
+/**
+ * @brief Release the last values of a reference
+ * @param reference - monitored property reference
+ */
+static void cov_property_values_free(BACNET_COV_PROPERTY_REFERENCE *reference)
+{
+    free(reference->value.heap);
+    reference->value.heap = NULL;
+    reference->value.len = 0;
+    free(reference->status.heap);
+    reference->status.heap = NULL;
+    reference->status.len = 0;
+}
+
 /**
  * Gets the address from the list of COV addresses
  *
@@ -107,6 +259,13 @@ static void cov_address_remove_unused(void)
                     break;
                 }
             }
+            for (index = 0; !found && (index < MAX_COV_PROPERTY_CONTEXTS);
+                 index++) {
+                if ((COV_Property_Contexts[index].valid) &&
+                    (COV_Property_Contexts[index].dest_index == cov_index)) {
+                    found = true;
+                }
+            }
             if (!found) {
                 COV_Addresses[cov_index].valid = false;
             }
@@ -186,35 +345,38 @@ TimeRemaining [3] Unsigned,
 COVIncrement [4] REAL OPTIONAL
 */
 
-static int cov_encode_subscription(
-    uint8_t *apdu, int max_apdu, BACNET_COV_SUBSCRIPTION *cov_subscription)
+static int cov_encode_recipient_process(
+    uint8_t *apdu, BACNET_ADDRESS *dest, uint32_t process_identifier)
 {
     int len = 0;
     int apdu_len = 0;
     BACNET_OCTET_STRING octet_string;
-    BACNET_ADDRESS *dest = NULL;
 
-    (void)max_apdu;
-    if (!cov_subscription) {
-        return 0;
-    }
-    dest = cov_address_get(cov_subscription->dest_index);
-    if (!dest) {
-        return 0;
-    }
     /* Recipient [0] BACnetRecipientProcess - opening */
-    len = encode_opening_tag(&apdu[apdu_len], 0);
+    len = encode_opening_tag(apdu, 0);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /*  recipient [0] BACnetRecipient - opening */
-    len = encode_opening_tag(&apdu[apdu_len], 0);
+    len = encode_opening_tag(apdu, 0);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* CHOICE - address [1] BACnetAddress - opening */
-    len = encode_opening_tag(&apdu[apdu_len], 1);
+    len = encode_opening_tag(apdu, 1);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* network-number Unsigned16, */
     /* -- A value of 0 indicates the local network */
-    len = encode_application_unsigned(&apdu[apdu_len], dest->net);
+    len = encode_application_unsigned(apdu, dest->net);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* mac-address OCTET STRING */
     /* -- A string of length 0 indicates a broadcast */
     if (dest->net) {
@@ -222,20 +384,53 @@ static int cov_encode_subscription(
     } else {
         octetstring_init(&octet_string, &dest->mac[0], dest->mac_len);
     }
-    len = encode_application_octet_string(&apdu[apdu_len], &octet_string);
+    len = encode_application_octet_string(apdu, &octet_string);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* CHOICE - address [1] BACnetAddress - closing */
-    len = encode_closing_tag(&apdu[apdu_len], 1);
+    len = encode_closing_tag(apdu, 1);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /*  recipient [0] BACnetRecipient - closing */
-    len = encode_closing_tag(&apdu[apdu_len], 0);
+    len = encode_closing_tag(apdu, 0);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* processIdentifier [1] Unsigned32 */
-    len = encode_context_unsigned(
-        &apdu[apdu_len], 1, cov_subscription->subscriberProcessIdentifier);
+    len = encode_context_unsigned(apdu, 1, process_identifier);
     apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
     /* Recipient [0] BACnetRecipientProcess - closing */
-    len = encode_closing_tag(&apdu[apdu_len], 0);
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+static int cov_encode_subscription(
+    uint8_t *apdu, int max_apdu, BACNET_COV_SUBSCRIPTION *cov_subscription)
+{
+    int len = 0;
+    int apdu_len = 0;
+    BACNET_ADDRESS *dest = NULL;
+
+    (void)max_apdu;
+    if (!cov_subscription) {
+        return 0;
+    }
+    dest = cov_address_get(cov_subscription->dest_index);
+    if (!dest) {
+        return 0;
+    }
+    len = cov_encode_recipient_process(
+        &apdu[apdu_len], dest, cov_subscription->subscriberProcessIdentifier);
     apdu_len += len;
     /*  MonitoredPropertyReference [1] BACnetObjectPropertyReference, */
     len = encode_opening_tag(&apdu[apdu_len], 1);
@@ -264,6 +459,54 @@ static int cov_encode_subscription(
     return apdu_len;
 }
 
+static int cov_encode_property_subscription(uint8_t *apdu,
+    BACNET_COV_PROPERTY_CONTEXT *context,
+    BACNET_COV_PROPERTY_REFERENCE *reference)
+{
+    int len = 0;
+    int apdu_len = 0;
+    BACNET_ADDRESS *dest = NULL;
+
+    dest = cov_address_get(context->dest_index);
+    if (!dest) {
+        return 0;
+    }
+    len = cov_encode_recipient_process(
+        &apdu[apdu_len], dest, context->subscriberProcessIdentifier);
+    apdu_len += len;
+    /*  MonitoredPropertyReference [1] BACnetObjectPropertyReference, */
+    len = encode_opening_tag(&apdu[apdu_len], 1);
+    apdu_len += len;
+    len = encode_context_object_id(&apdu[apdu_len], 0,
+        reference->monitoredObjectIdentifier.type,
+        reference->monitoredObjectIdentifier.instance);
+    apdu_len += len;
+    len = encode_context_enumerated(&apdu[apdu_len], 1,
+        reference->monitoredProperty.propertyIdentifier);
+    apdu_len += len;
+    if (reference->monitoredProperty.propertyArrayIndex != BACNET_ARRAY_ALL) {
+        len = encode_context_unsigned(&apdu[apdu_len], 2,
+            reference->monitoredProperty.propertyArrayIndex);
+        apdu_len += len;
+    }
+    len = encode_closing_tag(&apdu[apdu_len], 1);
+    apdu_len += len;
+    /* IssueConfirmedNotifications [2] BOOLEAN, */
+    len = encode_context_boolean(
+        &apdu[apdu_len], 2, context->issueConfirmedNotifications);
+    apdu_len += len;
+    /* TimeRemaining [3] Unsigned, */
+    len = encode_context_unsigned(&apdu[apdu_len], 3, context->lifetime);
+    apdu_len += len;
+    /* COVIncrement [4] REAL OPTIONAL */
+    if (reference->covIncrementPresent) {
+        len = encode_context_real(&apdu[apdu_len], 4, reference->covIncrement);
+        apdu_len += len;
+    }
+
+    return apdu_len;
+}
+
 /** Handle a request to list all the COV subscriptions.
  * @ingroup DSCOV
  *  Invoked by a request to read the Device object's
@@ -280,6 +523,8 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
     int len = 0;
     int apdu_len = 0;
     unsigned index = 0;
+    unsigned reference_index;
+    BACNET_COV_PROPERTY_CONTEXT *context;
 
     if (apdu) {
         for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
@@ -293,6 +538,203 @@ int handler_cov_encode_subscriptions(uint8_t *apdu, int max_apdu)
                 }
             }
         }
+        for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+            context = &COV_Property_Contexts[index];
+            if (!context->valid || context->multiple) {
+                /* SubscribeCOVPropertyMultiple contexts are listed in
+                   Active_COV_Multiple_Subscriptions */
+                continue;
+            }
+            for (reference_index = context->reference_head;
+                 reference_index < MAX_COV_PROPERTY_REFERENCES;
+                 reference_index = COV_Property_References[reference_index].next) {
+                len = cov_encode_property_subscription(&apdu[apdu_len],
+                    context, &COV_Property_References[reference_index]);
+                apdu_len += len;
+                if (apdu_len > max_apdu) {
+                    return -2;
+                }
+            }
+        }
+    }
+
+    return apdu_len;
+}
+
+/*
+BACnetCOVMultipleSubscription ::= SEQUENCE {
+    recipient [0] BACnetRecipientProcess,
+    issue-confirmed-notifications [1] BOOLEAN,
+    time-remaining [2] Unsigned,
+    max-notification-delay [3] Unsigned,
+    list-of-cov-subscription-specifications [4] SEQUENCE OF SEQUENCE {
+        monitored-object-identifier [0] BACnetObjectIdentifier,
+        list-of-cov-references [1] SEQUENCE OF SEQUENCE {
+            monitored-property [0] BACnetPropertyReference,
+            cov-increment [1] REAL OPTIONAL,
+            timestamped [2] BOOLEAN
+        }
+    }
+}
+*/
+
+/**
+ * @brief Encode the BACnetCOVMultipleSubscription of a context.  The
+ *  references of the same object that are next to each other share
+ *  one subscription specification.
+ * @param apdu - buffer for the encoding, or NULL for the length
+ * @param context - SubscribeCOVPropertyMultiple context
+ * @return number of bytes encoded
+ */
+static int cov_encode_multiple_subscription(
+    uint8_t *apdu, BACNET_COV_PROPERTY_CONTEXT *context)
+{
+    BACNET_COV_PROPERTY_REFERENCE *reference = NULL;
+    BACNET_COV_PROPERTY_REFERENCE *previous = NULL;
+    BACNET_ADDRESS *dest = NULL;
+    unsigned index;
+    int len = 0;
+    int apdu_len = 0;
+
+    dest = cov_address_get(context->dest_index);
+    if (!dest) {
+        return 0;
+    }
+    len = cov_encode_recipient_process(
+        apdu, dest, context->subscriberProcessIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_boolean(
+        apdu, 1, context->issueConfirmedNotifications);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_unsigned(apdu, 2, context->lifetime);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_unsigned(apdu, 3, context->maxNotificationDelay);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_opening_tag(apdu, 4);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (index = context->reference_head;
+         index < MAX_COV_PROPERTY_REFERENCES; index = reference->next) {
+        reference = &COV_Property_References[index];
+        if (!previous ||
+            (memcmp(&reference->monitoredObjectIdentifier,
+                 &previous->monitoredObjectIdentifier,
+                 sizeof(BACNET_OBJECT_ID)) != 0)) {
+            if (previous) {
+                len = encode_closing_tag(apdu, 1);
+                apdu_len += len;
+                if (apdu) {
+                    apdu += len;
+                }
+            }
+            len = encode_context_object_id(apdu, 0,
+                reference->monitoredObjectIdentifier.type,
+                reference->monitoredObjectIdentifier.instance);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            len = encode_opening_tag(apdu, 1);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        len = encode_opening_tag(apdu, 0);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        len = encode_context_enumerated(
+            apdu, 0, reference->monitoredProperty.propertyIdentifier);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        if (reference->monitoredProperty.propertyArrayIndex !=
+            BACNET_ARRAY_ALL) {
+            len = encode_context_unsigned(
+                apdu, 1, reference->monitoredProperty.propertyArrayIndex);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        len = encode_closing_tag(apdu, 0);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        if (reference->covIncrementPresent) {
+            len = encode_context_real(apdu, 1, reference->covIncrement);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        len = encode_context_boolean(apdu, 2, reference->timestamped);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        previous = reference;
+    }
+    if (previous) {
+        len = encode_closing_tag(apdu, 1);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 4);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the SubscribeCOVPropertyMultiple subscriptions, as the
+ *  value of the Device object Active_COV_Multiple_Subscriptions property
+ * @param apdu [out] Buffer in which the APDU contents are built.
+ * @param max_apdu [in] Max length of the APDU buffer.
+ * @return How many bytes were encoded in the buffer, or -2 if the response
+ *  would not fit within the buffer.
+ */
+int handler_cov_encode_multiple_subscriptions(uint8_t *apdu, int max_apdu)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    unsigned index;
+    int len = 0;
+    int apdu_len = 0;
+
+    if (!apdu) {
+        return 0;
+    }
+    for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+        context = &COV_Property_Contexts[index];
+        if (!context->valid || !context->multiple) {
+            continue;
+        }
+        len = cov_encode_multiple_subscription(NULL, context);
+        if ((apdu_len + len) > max_apdu) {
+            return -2;
+        }
+        len = cov_encode_multiple_subscription(&apdu[apdu_len], context);
+        apdu_len += len;
     }
 
     return apdu_len;
@@ -318,6 +760,23 @@ void handler_cov_init(void)
         COV_Subscriptions[index].lifetime = 0;
         COV_Subscriptions[index].flag.send_requested = false;
     }
+    memset(COV_Property_Contexts, 0, sizeof(COV_Property_Contexts));
+    for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+        COV_Property_Contexts[index].dest_index = MAX_COV_ADDRESSES;
+        COV_Property_Contexts[index].reference_head =
+            COV_PROPERTY_REFERENCE_NONE;
+        COV_Property_Contexts[index].reference_tail =
+            COV_PROPERTY_REFERENCE_NONE;
+    }
+    for (index = 0; index < MAX_COV_PROPERTY_REFERENCES; index++) {
+        cov_property_values_free(&COV_Property_References[index]);
+    }
+    memset(COV_Property_References, 0, sizeof(COV_Property_References));
+    for (index = 0; index < MAX_COV_PROPERTY_REFERENCES; index++) {
+        COV_Property_References[index].next = (uint16_t)(index + 1);
+    }
+    COV_Property_Reference_Free = 0;
+    COV_Property_Reference_Count = 0;
     for (index = 0; index < MAX_COV_ADDRESSES; index++) {
         COV_Addresses[index].valid = false;
     }
@@ -432,14 +891,12 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
     if (!dcc_communication_enabled()) {
         return status;
     }
-#if PRINT_ENABLED
-    fprintf(stderr, "COVnotification: requested\n");
-#endif
     if (!cov_subscription) {
         return status;
     }
     dest = cov_address_get(cov_subscription->dest_index);
     if (!dest) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_DROPPED);
 #if PRINT_ENABLED
         fprintf(stderr, "COVnotification: dest not found!\n");
 #endif
@@ -483,12 +940,13 @@ static bool cov_send_request(BACNET_COV_SUBSCRIPTION *cov_subscription,
         dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
     if (bytes_sent > 0) {
         status = true;
-#if PRINT_ENABLED
-        fprintf(stderr, "COVnotification: Sent!\n");
-#endif
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_SENT);
     }
 
 COV_FAILED:
+    if (!status) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_DROPPED);
+    }
 
     return status;
 }
@@ -534,62 +992,808 @@ static void cov_lifetime_expiration_handler(
     }
 }
 
-/** Handler to check the list of subscribed objects for any that have changed
- *  and so need to have notifications sent.
- * @ingroup DSCOV
- * This handler will be invoked by the main program every second or so.
- * This example only handles Binary Inputs, but can be easily extended to
- * support other types.
- * For each subscribed object,
- *  - See if the subscription has timed out
- *    - Remove it if it has timed out.
- *  - See if the subscribed object instance has changed
- *    (eg, check with Binary_Input_Change_Of_Value() )
- *  - If changed,
- *    - Clear the COV (eg, Binary_Input_Change_Of_Value_Clear() )
- *    - Send the notice with cov_send_request()
- *      - Will be confirmed or unconfirmed, as per the subscription.
- *
- * @note worst case tasking: MS/TP with the ability to send only
- *        one notification per task cycle.
- *
- * @param elapsed_seconds [in] How many seconds have elapsed since last called.
+/**
+ * @brief Set the upper limit of the seconds that the changes of a
+ *  SubscribeCOVPropertyMultiple context are coalesced before they are
+ *  sent, whatever the maxNotificationDelay of the subscriber is.
+ * @param seconds - upper limit, or zero to send the changes at once
  */
-void handler_cov_timer_seconds(uint32_t elapsed_seconds)
+void handler_cov_max_notification_delay_set(uint32_t seconds)
 {
-    unsigned index = 0;
-    uint32_t lifetime_seconds = 0;
+    COV_Max_Notification_Delay = seconds;
+}
 
-    if (elapsed_seconds) {
-        /* handle the subscription timeouts */
-        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
-            if (COV_Subscriptions[index].flag.valid) {
-                lifetime_seconds = COV_Subscriptions[index].lifetime;
-                if (lifetime_seconds) {
-                    /* only expire COV with definite lifetimes */
-                    cov_lifetime_expiration_handler(
-                        index, elapsed_seconds, lifetime_seconds);
-                }
-            }
-        }
+/**
+ * @brief Get the number of property references that are subscribed
+ *  by SubscribeCOVProperty and SubscribeCOVPropertyMultiple
+ * @return number of property references
+ */
+unsigned handler_cov_property_count(void)
+{
+    return COV_Property_Reference_Count;
+}
+
+/* scratch for reading one property value */
+static uint8_t COV_Read_Buffer[MAX_APDU];
+/* values of the COVNotificationMultiple being built */
+static uint8_t COV_Value_Buffer[MAX_APDU];
+
+/**
+ * @brief Read the value of a monitored property into the read buffer
+ * @param object_id - monitored object
+ * @param property - monitored property
+ * @param error_class - error class, if the property can not be read
+ * @param error_code - error code, if the property can not be read
+ * @return number of bytes of the value, or negative on error
+ */
+static int cov_property_read(BACNET_OBJECT_ID *object_id,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    int len;
+
+    rpdata.object_type = object_id->type;
+    rpdata.object_instance = object_id->instance;
+    rpdata.object_property = property;
+    rpdata.array_index = array_index;
+    rpdata.application_data = &COV_Read_Buffer[0];
+    rpdata.application_data_len = sizeof(COV_Read_Buffer);
+    len = Device_Read_Property(&rpdata);
+    if ((len < 0) && error_class && error_code) {
+        *error_class = rpdata.error_class;
+        *error_code = rpdata.error_code;
     }
+
+    return len;
 }
 
-bool handler_cov_fsm(void)
+/**
+ * @brief Determine if a monitored property has changed since the last
+ *  time it was reported, and remember its value when it has changed.
+ *  A REAL value with a COV increment changes when it moves by at least
+ *  the increment, and any other value changes when its encoding does.
+ *  The encodings are compared bytewise with the last ones.
+ * @param reference - monitored property reference
+ * @return true if the value has changed
+ */
+static bool cov_property_changed(BACNET_COV_PROPERTY_REFERENCE *reference)
 {
-    static int index = 0;
-    BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_DATE_TIME now;
+    bool changed = false;
+    float value = 0.0f;
+    int len;
+
+    len = cov_property_read(&reference->monitoredObjectIdentifier,
+        reference->monitoredProperty.propertyIdentifier,
+        reference->monitoredProperty.propertyArrayIndex, NULL, NULL);
+    if (len < 0) {
+        return false;
+    }
+    if (reference->covIncrementPresent &&
+        (bacnet_real_application_decode(COV_Read_Buffer, len, &value) ==
+            len)) {
+        if (!reference->value_present ||
+            isgreaterequal(fabsf(value - reference->value_real),
+                reference->covIncrement)) {
+            reference->value_real = value;
+            changed = true;
+        }
+    } else if (cov_property_value_update(
+                   &reference->value, COV_Read_Buffer, len) ||
+        !reference->value_present) {
+        changed = true;
+    }
+    context = &COV_Property_Contexts[reference->context_index];
+    if (!context->multiple) {
+        /* SubscribeCOVProperty also reports the Status_Flags */
+        len = cov_property_read(&reference->monitoredObjectIdentifier,
+            PROP_STATUS_FLAGS, BACNET_ARRAY_ALL, NULL, NULL);
+        if ((len > 0) &&
+            cov_property_value_update(
+                &reference->status, COV_Read_Buffer, len)) {
+            changed = true;
+        }
+    }
+    reference->value_present = true;
+    if (changed && reference->timestamped) {
+        Device_getCurrentDateTime(&now);
+        reference->timeOfChange = now.time;
+    }
+
+    return changed;
+}
+
+/**
+ * @brief Request a monitored property to be sent, and start the window
+ *  in which the other changes of its context are coalesced
+ * @param reference - monitored property reference
+ */
+static void cov_property_send_request(BACNET_COV_PROPERTY_REFERENCE *reference)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    uint32_t delay = 0;
+
+    reference->send_requested = true;
+    context = &COV_Property_Contexts[reference->context_index];
+    if (!context->send_pending) {
+        context->send_pending = true;
+        if (context->multiple) {
+            delay = context->maxNotificationDelay;
+            if (delay > COV_Max_Notification_Delay) {
+                delay = COV_Max_Notification_Delay;
+            }
+        }
+        context->delay = delay;
+    }
+}
+
+/**
+ * @brief Remove a property subscription context and its references
+ * @param context_index - index of the context
+ */
+static void cov_property_context_free(unsigned context_index)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    unsigned index;
+
+    context = &COV_Property_Contexts[context_index];
+    for (index = context->reference_head;
+         index < MAX_COV_PROPERTY_REFERENCES;
+         index = COV_Property_References[index].next) {
+        COV_Property_References[index].valid = false;
+        cov_property_values_free(&COV_Property_References[index]);
+        COV_Property_Reference_Count--;
+    }
+    if (context->reference_tail < MAX_COV_PROPERTY_REFERENCES) {
+        /* the whole list goes back to the free list */
+        COV_Property_References[context->reference_tail].next =
+            COV_Property_Reference_Free;
+        COV_Property_Reference_Free = context->reference_head;
+    }
+    context->reference_head = COV_PROPERTY_REFERENCE_NONE;
+    context->reference_tail = COV_PROPERTY_REFERENCE_NONE;
+    context->reference_count = 0;
+    if (context->invokeID) {
+        tsm_free_invoke_id(context->invokeID);
+        context->invokeID = 0;
+    }
+    context->valid = false;
+    context->send_pending = false;
+    context->dest_index = MAX_COV_ADDRESSES;
+    cov_address_remove_unused();
+}
+
+/**
+ * @brief Take a reference from the free list, and add it to the end of
+ *  the references of a context
+ * @param context_index - index of the context
+ * @return index of the reference, or -1 if there is no room
+ */
+static int cov_property_reference_add(unsigned context_index)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    unsigned index;
+
+    index = COV_Property_Reference_Free;
+    if (index >= MAX_COV_PROPERTY_REFERENCES) {
+        return -1;
+    }
+    reference = &COV_Property_References[index];
+    COV_Property_Reference_Free = reference->next;
+    memset(reference, 0, sizeof(*reference));
+    reference->valid = true;
+    reference->context_index = (uint16_t)context_index;
+    reference->next = COV_PROPERTY_REFERENCE_NONE;
+    context = &COV_Property_Contexts[context_index];
+    if (context->reference_tail < MAX_COV_PROPERTY_REFERENCES) {
+        COV_Property_References[context->reference_tail].next =
+            (uint16_t)index;
+    } else {
+        context->reference_head = (uint16_t)index;
+    }
+    context->reference_tail = (uint16_t)index;
+    context->reference_count++;
+    COV_Property_Reference_Count++;
+
+    return (int)index;
+}
+
+/**
+ * @brief Remove a reference from its context, and give it back to the
+ *  free list
+ * @param reference_index - index of the reference
+ */
+static void cov_property_reference_remove(unsigned reference_index)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    unsigned index, previous = COV_PROPERTY_REFERENCE_NONE;
+
+    reference = &COV_Property_References[reference_index];
+    context = &COV_Property_Contexts[reference->context_index];
+    for (index = context->reference_head; index != reference_index;
+         index = COV_Property_References[index].next) {
+        if (index >= MAX_COV_PROPERTY_REFERENCES) {
+            return;
+        }
+        previous = index;
+    }
+    if (previous < MAX_COV_PROPERTY_REFERENCES) {
+        COV_Property_References[previous].next = reference->next;
+    } else {
+        context->reference_head = reference->next;
+    }
+    if (context->reference_tail == reference_index) {
+        context->reference_tail = (uint16_t)previous;
+    }
+    context->reference_count--;
+    COV_Property_Reference_Count--;
+    reference->valid = false;
+    cov_property_values_free(reference);
+    reference->next = COV_Property_Reference_Free;
+    COV_Property_Reference_Free = (uint16_t)reference_index;
+}
+
+/**
+ * @brief Find a monitored property of a context
+ * @param context_index - index of the context
+ * @param object_id - monitored object
+ * @param property - monitored property
+ * @return index of the reference, or -1 if not found
+ */
+static int cov_property_reference_find(unsigned context_index,
+    BACNET_OBJECT_ID *object_id,
+    BACNET_PROPERTY_REFERENCE *property)
+{
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    unsigned index;
+
+    for (index = COV_Property_Contexts[context_index].reference_head;
+         index < MAX_COV_PROPERTY_REFERENCES;
+         index = COV_Property_References[index].next) {
+        reference = &COV_Property_References[index];
+        if ((reference->monitoredObjectIdentifier.type == object_id->type) &&
+            (reference->monitoredObjectIdentifier.instance ==
+                object_id->instance) &&
+            (reference->monitoredProperty.propertyIdentifier ==
+                property->propertyIdentifier) &&
+            (reference->monitoredProperty.propertyArrayIndex ==
+                property->propertyArrayIndex)) {
+            return (int)index;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Find the context of a subscriber.  A SubscribeCOVProperty
+ *  context also has to monitor the given property.
+ * @param src - address of the subscriber
+ * @param process_identifier - subscriber process identifier
+ * @param multiple - true for a SubscribeCOVPropertyMultiple context
+ * @param object_id - monitored object, for SubscribeCOVProperty
+ * @param property - monitored property, for SubscribeCOVProperty
+ * @return index of the context, or -1 if not found
+ */
+static int cov_property_context_find(BACNET_ADDRESS *src,
+    uint32_t process_identifier,
+    bool multiple,
+    BACNET_OBJECT_ID *object_id,
+    BACNET_PROPERTY_REFERENCE *property)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_ADDRESS *dest;
+    unsigned index;
+
+    for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+        context = &COV_Property_Contexts[index];
+        if (!context->valid || (context->multiple != multiple) ||
+            (context->subscriberProcessIdentifier != process_identifier)) {
+            continue;
+        }
+        dest = cov_address_get(context->dest_index);
+        if (dest && !bacnet_address_same(src, dest)) {
+            continue;
+        }
+        if (multiple ||
+            (cov_property_reference_find(index, object_id, property) >= 0)) {
+            return (int)index;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Add a context for a subscriber
+ * @param src - address of the subscriber
+ * @param process_identifier - subscriber process identifier
+ * @param multiple - true for a SubscribeCOVPropertyMultiple context
+ * @return index of the context, or -1 if there is no room
+ */
+static int cov_property_context_add(
+    BACNET_ADDRESS *src, uint32_t process_identifier, bool multiple)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    unsigned index;
+    int dest_index;
+
+    for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+        context = &COV_Property_Contexts[index];
+        if (!context->valid) {
+            dest_index = cov_address_add(src);
+            if (dest_index < 0) {
+                return -1;
+            }
+            memset(context, 0, sizeof(*context));
+            context->reference_head = COV_PROPERTY_REFERENCE_NONE;
+            context->reference_tail = COV_PROPERTY_REFERENCE_NONE;
+            context->valid = true;
+            context->multiple = multiple;
+            context->dest_index = (unsigned)dest_index;
+            context->subscriberProcessIdentifier = process_identifier;
+            return (int)index;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Determine if a property can be monitored
+ * @param cov_reference - property reference of the request
+ * @param single - true if the value is sent in a COVNotification, which
+ *  only carries a primitive value
+ * @param error_class - error class, if the property can not be monitored
+ * @param error_code - error code, if the property can not be monitored
+ * @return true if the property can be monitored
+ */
+static bool cov_property_reference_valid(BACNET_COV_REFERENCE *cov_reference,
+    bool single,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    len = cov_property_read(&cov_reference->monitoredObjectIdentifier,
+        cov_reference->monitoredProperty.propertyIdentifier,
+        cov_reference->monitoredProperty.propertyArrayIndex, error_class,
+        error_code);
+    if (len < 0) {
+        return false;
+    }
+    if (single &&
+        (bacapp_decode_application_data(COV_Read_Buffer, len, &value) !=
+            len)) {
+        *error_class = ERROR_CLASS_PROPERTY;
+        *error_code = ERROR_CODE_NOT_COV_PROPERTY;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Add or update a monitored property of a context, and request
+ *  its value to be sent
+ * @param context_index - index of the context
+ * @param cov_reference - property reference of the request
+ * @param error_class - error class, if there is no room
+ * @param error_code - error code, if there is no room
+ * @return true if the property is monitored
+ */
+static bool cov_property_subscribe(unsigned context_index,
+    BACNET_COV_REFERENCE *cov_reference,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    uint16_t next;
+    int index;
+
+    index = cov_property_reference_find(context_index,
+        &cov_reference->monitoredObjectIdentifier,
+        &cov_reference->monitoredProperty);
+    if (index < 0) {
+        index = cov_property_reference_add(context_index);
+        if (index < 0) {
+            *error_class = ERROR_CLASS_RESOURCES;
+            *error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
+            return false;
+        }
+    }
+    reference = &COV_Property_References[index];
+    next = reference->next;
+    memset(reference, 0, sizeof(*reference));
+    reference->valid = true;
+    reference->context_index = (uint16_t)context_index;
+    reference->next = next;
+    reference->monitoredObjectIdentifier =
+        cov_reference->monitoredObjectIdentifier;
+    reference->monitoredProperty = cov_reference->monitoredProperty;
+    reference->covIncrementPresent = cov_reference->covIncrementPresent;
+    reference->covIncrement = cov_reference->covIncrement;
+    reference->timestamped = cov_reference->timestamped;
+    /* remember the value, and send it at once */
+    (void)cov_property_changed(reference);
+    reference->send_requested = true;
+    COV_Property_Contexts[context_index].send_pending = true;
+    COV_Property_Contexts[context_index].delay = 0;
+
+    return true;
+}
+
+/**
+ * @brief Remove a context when it has no monitored property left
+ * @param context_index - index of the context
+ */
+static void cov_property_context_prune(unsigned context_index)
+{
+    if (COV_Property_Contexts[context_index].reference_count == 0) {
+        cov_property_context_free(context_index);
+    }
+}
+
+/**
+ * @brief Remove a monitored property from a context, and the context
+ *  when it has no monitored property left
+ * @param context_index - index of the context
+ * @param cov_reference - property reference of the request
+ */
+static void cov_property_unsubscribe(
+    unsigned context_index, BACNET_COV_REFERENCE *cov_reference)
+{
+    int reference_index;
+
+    reference_index = cov_property_reference_find(context_index,
+        &cov_reference->monitoredObjectIdentifier,
+        &cov_reference->monitoredProperty);
+    if (reference_index >= 0) {
+        cov_property_reference_remove((unsigned)reference_index);
+    }
+    cov_property_context_prune(context_index);
+}
+
+/**
+ * @brief Send a COVNotification with the value and Status_Flags of the
+ *  property monitored by a SubscribeCOVProperty context
+ * @param context - SubscribeCOVProperty context
+ * @param reference - monitored property reference
+ * @return true if the notification was sent, or the value is gone
+ */
+static bool cov_property_send_single(BACNET_COV_PROPERTY_CONTEXT *context,
+    BACNET_COV_PROPERTY_REFERENCE *reference)
+{
+    BACNET_COV_SUBSCRIPTION cov_subscription = { 0 };
+    BACNET_PROPERTY_VALUE value_list[2];
+    int len;
+    bool status;
+
+    bacapp_property_value_list_init(&value_list[0], 2);
+    len = cov_property_read(&reference->monitoredObjectIdentifier,
+        reference->monitoredProperty.propertyIdentifier,
+        reference->monitoredProperty.propertyArrayIndex, NULL, NULL);
+    if ((len < 0) ||
+        (bacapp_decode_application_data(
+             COV_Read_Buffer, len, &value_list[0].value) <= 0)) {
+        /* nothing to report */
+        return true;
+    }
+    value_list[0].propertyIdentifier =
+        reference->monitoredProperty.propertyIdentifier;
+    value_list[0].propertyArrayIndex =
+        reference->monitoredProperty.propertyArrayIndex;
+    len = cov_property_read(&reference->monitoredObjectIdentifier,
+        PROP_STATUS_FLAGS, BACNET_ARRAY_ALL, NULL, NULL);
+    if ((len > 0) &&
+        (bacapp_decode_application_data(
+             COV_Read_Buffer, len, &value_list[1].value) > 0)) {
+        value_list[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    } else {
+        value_list[0].next = NULL;
+    }
+    cov_subscription.flag.valid = true;
+    cov_subscription.flag.issueConfirmedNotifications =
+        context->issueConfirmedNotifications;
+    cov_subscription.dest_index = context->dest_index;
+    cov_subscription.subscriberProcessIdentifier =
+        context->subscriberProcessIdentifier;
+    cov_subscription.lifetime = context->lifetime;
+    cov_subscription.monitoredObjectIdentifier =
+        reference->monitoredObjectIdentifier;
+    status = cov_send_request(&cov_subscription, &value_list[0]);
+    context->invokeID = cov_subscription.invokeID;
+
+    return status;
+}
+
+/**
+ * @brief Send the changed values of a SubscribeCOVPropertyMultiple
+ *  context, as many as fit, in one COVNotificationMultiple.  The values
+ *  that did not fit stay requested for the next notification.
+ * @param context_index - index of the context
+ * @return true if the notification was sent
+ */
+static bool cov_property_send_multiple(unsigned context_index)
+{
+    static BACNET_COV_MULTIPLE_VALUE values[MAX_COV_NOTIFY_MULTIPLE_VALUES];
+    static uint16_t value_reference[MAX_COV_NOTIFY_MULTIPLE_VALUES];
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    BACNET_COV_MULTIPLE_DATA cov_data = { 0 };
+    BACNET_NPDU_DATA npdu_data;
+    BACNET_ADDRESS my_address;
+    BACNET_ADDRESS *dest = NULL;
+    unsigned index, offset = 0, count = 0;
+    unsigned apdu_size, header_len;
+    int len = 0;
+    int pdu_len = 0;
+    int bytes_sent = 0;
+    uint8_t invoke_id = 0;
+    bool status = false;
+
+    context = &COV_Property_Contexts[context_index];
+    dest = cov_address_get(context->dest_index);
+    if (!dest) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_DROPPED);
+        return false;
+    }
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], dest, &my_address, &npdu_data);
+    apdu_size = sizeof(Handler_Transmit_Buffer) - pdu_len;
+    if (apdu_size > MAX_APDU) {
+        apdu_size = MAX_APDU;
+    }
+    header_len = context->issueConfirmedNotifications ? 4 : 2;
+    cov_data.subscriberProcessIdentifier =
+        context->subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = Device_Object_Instance_Number();
+    cov_data.timeRemaining = context->lifetime;
+    cov_data.values = values;
+    cov_data.value_size = MAX_COV_NOTIFY_MULTIPLE_VALUES;
+    for (index = context->reference_head;
+         index < MAX_COV_PROPERTY_REFERENCES; index = reference->next) {
+        reference = &COV_Property_References[index];
+        if (!reference->send_requested) {
+            continue;
+        }
+        if (count >= MAX_COV_NOTIFY_MULTIPLE_VALUES) {
+            break;
+        }
+        len = cov_property_read(&reference->monitoredObjectIdentifier,
+            reference->monitoredProperty.propertyIdentifier,
+            reference->monitoredProperty.propertyArrayIndex, NULL, NULL);
+        if ((len < 0) || ((offset + len) > sizeof(COV_Value_Buffer))) {
+            if (count == 0) {
+                /* nothing to report, or never fits */
+                reference->send_requested = false;
+                continue;
+            }
+            break;
+        }
+        memcpy(&COV_Value_Buffer[offset], COV_Read_Buffer, len);
+        values[count].monitoredObjectIdentifier =
+            reference->monitoredObjectIdentifier;
+        values[count].propertyIdentifier =
+            reference->monitoredProperty.propertyIdentifier;
+        values[count].propertyArrayIndex =
+            reference->monitoredProperty.propertyArrayIndex;
+        values[count].value = &COV_Value_Buffer[offset];
+        values[count].value_len = (unsigned)len;
+        values[count].timeOfChangePresent = reference->timestamped;
+        values[count].timeOfChange = reference->timeOfChange;
+        cov_data.value_count = count + 1;
+        if ((header_len + cov_notify_multiple_apdu_encode(NULL, &cov_data)) >
+            apdu_size) {
+            cov_data.value_count = count;
+            if (count == 0) {
+                reference->send_requested = false;
+                continue;
+            }
+            break;
+        }
+        if (reference->timestamped) {
+            cov_data.timestampPresent = true;
+        }
+        value_reference[count] = (uint16_t)index;
+        offset += (unsigned)len;
+        count++;
+    }
+    if (count == 0) {
+        return true;
+    }
+    if (cov_data.timestampPresent) {
+        Device_getCurrentDateTime(&cov_data.timestamp);
+    }
+    if (context->issueConfirmedNotifications) {
+        npdu_data.data_expecting_reply = true;
+        invoke_id = tsm_next_free_invokeID();
+        if (invoke_id) {
+            context->invokeID = invoke_id;
+            len = ccov_notify_multiple_encode_apdu(
+                &Handler_Transmit_Buffer[pdu_len], apdu_size, invoke_id,
+                &cov_data);
+        } else {
+            goto COV_FAILED;
+        }
+    } else {
+        len = ucov_notify_multiple_encode_apdu(
+            &Handler_Transmit_Buffer[pdu_len], apdu_size, &cov_data);
+    }
+    pdu_len += len;
+    if (context->issueConfirmedNotifications) {
+        tsm_set_confirmed_unsegmented_transaction(invoke_id, dest, &npdu_data,
+            &Handler_Transmit_Buffer[0], (uint16_t)pdu_len);
+    }
+    bytes_sent = datalink_send_pdu(
+        dest, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent > 0) {
+        status = true;
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_SENT);
+        for (index = 0; index < count; index++) {
+            COV_Property_References[value_reference[index]].send_requested =
+                false;
+        }
+    }
+
+COV_FAILED:
+    if (!status) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_COV_NOTIFICATIONS_DROPPED);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Send the changes of a property subscription context, when its
+ *  coalescing window has closed
+ * @param context_index - index of the context
+ */
+static void cov_property_context_send(unsigned context_index)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    unsigned index;
+
+    context = &COV_Property_Contexts[context_index];
+    if (!context->valid || !context->send_pending || (context->delay > 0)) {
+        return;
+    }
+    if (context->issueConfirmedNotifications &&
+        ((context->invokeID != 0) || !tsm_transaction_available())) {
+        /* already sending, or no transactions available */
+        return;
+    }
+    if (context->multiple) {
+        (void)cov_property_send_multiple(context_index);
+    } else {
+        for (index = context->reference_head;
+             index < MAX_COV_PROPERTY_REFERENCES; index = reference->next) {
+            reference = &COV_Property_References[index];
+            if (reference->send_requested) {
+                if (cov_property_send_single(context, reference)) {
+                    reference->send_requested = false;
+                }
+                break;
+            }
+        }
+    }
+    context->send_pending = false;
+    for (index = context->reference_head;
+         index < MAX_COV_PROPERTY_REFERENCES; index = reference->next) {
+        reference = &COV_Property_References[index];
+        if (reference->send_requested) {
+            context->send_pending = true;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Handle the lifetime and the coalescing window of the property
+ *  subscription contexts
+ * @param elapsed_seconds - number of seconds elapsed
+ */
+static void cov_property_timer_seconds(uint32_t elapsed_seconds)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    unsigned index;
+
+    for (index = 0; index < MAX_COV_PROPERTY_CONTEXTS; index++) {
+        context = &COV_Property_Contexts[index];
+        if (!context->valid) {
+            continue;
+        }
+        if (context->send_pending) {
+            if (context->delay > elapsed_seconds) {
+                context->delay -= elapsed_seconds;
+            } else {
+                context->delay = 0;
+            }
+        }
+        if (context->lifetime) {
+            /* only expire COV with definite lifetimes */
+            if (context->lifetime > elapsed_seconds) {
+                context->lifetime -= elapsed_seconds;
+            } else {
+                cov_property_context_free(index);
+            }
+        }
+    }
+}
+
+/** Handler to check the list of subscribed objects for any that have changed
+ *  and so need to have notifications sent.
+ * @ingroup DSCOV
+ * This handler will be invoked by the main program every second or so.
+ * This example only handles Binary Inputs, but can be easily extended to
+ * support other types.
+ * For each subscribed object,
+ *  - See if the subscription has timed out
+ *    - Remove it if it has timed out.
+ *  - See if the subscribed object instance has changed
+ *    (eg, check with Binary_Input_Change_Of_Value() )
+ *  - If changed,
+ *    - Clear the COV (eg, Binary_Input_Change_Of_Value_Clear() )
+ *    - Send the notice with cov_send_request()
+ *      - Will be confirmed or unconfirmed, as per the subscription.
+ *
+ * @note worst case tasking: MS/TP with the ability to send only
+ *        one notification per task cycle.
+ *
+ * @param elapsed_seconds [in] How many seconds have elapsed since last called.
+ */
+void handler_cov_timer_seconds(uint32_t elapsed_seconds)
+{
+    unsigned index = 0;
+    uint32_t lifetime_seconds = 0;
+
+    if (elapsed_seconds) {
+        /* handle the subscription timeouts */
+        for (index = 0; index < MAX_COV_SUBCRIPTIONS; index++) {
+            if (COV_Subscriptions[index].flag.valid) {
+                lifetime_seconds = COV_Subscriptions[index].lifetime;
+                if (lifetime_seconds) {
+                    /* only expire COV with definite lifetimes */
+                    cov_lifetime_expiration_handler(
+                        index, elapsed_seconds, lifetime_seconds);
+                }
+            }
+        }
+        cov_property_timer_seconds(elapsed_seconds);
+    }
+}
+
+bool handler_cov_fsm(void)
+{
+    static int index = 0;
+    static unsigned mark_index = COV_PROPERTY_REFERENCE_NONE;
+    BACNET_OBJECT_TYPE object_type = MAX_BACNET_OBJECT_TYPE;
     uint32_t object_instance = 0;
     bool status = false;
     bool send = false;
     BACNET_PROPERTY_VALUE value_list[MAX_COV_PROPERTIES];
+    BACNET_COV_PROPERTY_REFERENCE *reference;
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    unsigned i;
     /* states for transmitting */
     static enum {
         COV_STATE_IDLE = 0,
         COV_STATE_MARK,
         COV_STATE_CLEAR,
         COV_STATE_FREE,
-        COV_STATE_SEND
+        COV_STATE_SEND,
+        COV_STATE_PROPERTY_MARK,
+        COV_STATE_PROPERTY_SEND
     } cov_task_state = COV_STATE_IDLE;
 
     switch (cov_task_state) {
@@ -692,6 +1896,59 @@ bool handler_cov_fsm(void)
             }
             index++;
             if (index >= MAX_COV_SUBCRIPTIONS) {
+                index = 0;
+                mark_index = COV_Property_Contexts[0].reference_head;
+                cov_task_state = COV_STATE_PROPERTY_MARK;
+            }
+            break;
+        case COV_STATE_PROPERTY_MARK:
+            /* mark a batch of monitored properties that have changed,
+               walking the references of each context in turn */
+            i = 0;
+            while ((i < COV_PROPERTY_MARK_BATCH) &&
+                (index < MAX_COV_PROPERTY_CONTEXTS)) {
+                if (mark_index >= MAX_COV_PROPERTY_REFERENCES) {
+                    index++;
+                    if (index < MAX_COV_PROPERTY_CONTEXTS) {
+                        mark_index =
+                            COV_Property_Contexts[index].reference_head;
+                    }
+                    continue;
+                }
+                reference = &COV_Property_References[mark_index];
+                if (!reference->valid ||
+                    (reference->context_index != (unsigned)index)) {
+                    /* removed since the last batch */
+                    mark_index = COV_PROPERTY_REFERENCE_NONE;
+                    continue;
+                }
+                mark_index = reference->next;
+                if (cov_property_changed(reference)) {
+                    cov_property_send_request(reference);
+                }
+                i++;
+            }
+            if (index >= MAX_COV_PROPERTY_CONTEXTS) {
+                index = 0;
+                cov_task_state = COV_STATE_PROPERTY_SEND;
+            }
+            break;
+        case COV_STATE_PROPERTY_SEND:
+            /* confirmed notification house keeping */
+            context = &COV_Property_Contexts[index];
+            if (context->valid && context->issueConfirmedNotifications &&
+                context->invokeID) {
+                if (tsm_invoke_id_free(context->invokeID)) {
+                    context->invokeID = 0;
+                } else if (tsm_invoke_id_failed(context->invokeID)) {
+                    tsm_free_invoke_id(context->invokeID);
+                    context->invokeID = 0;
+                }
+            }
+            /* send the changes whose coalescing window has closed */
+            cov_property_context_send(index);
+            index++;
+            if (index >= MAX_COV_PROPERTY_CONTEXTS) {
                 index = 0;
                 cov_task_state = COV_STATE_IDLE;
             }
@@ -863,3 +2120,301 @@ void handler_cov_subscribe(uint8_t *service_request,
 
     return;
 }
+
+static bool cov_subscribe_property(BACNET_ADDRESS *src,
+    BACNET_SUBSCRIBE_COV_DATA *cov_data,
+    BACNET_ERROR_CLASS *error_class,
+    BACNET_ERROR_CODE *error_code)
+{
+    BACNET_COV_REFERENCE cov_reference = { 0 };
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    int context_index;
+    bool status = false;
+
+    cov_reference.monitoredObjectIdentifier =
+        cov_data->monitoredObjectIdentifier;
+    cov_reference.monitoredProperty = cov_data->monitoredProperty;
+    cov_reference.covIncrementPresent = cov_data->covIncrementPresent;
+    cov_reference.covIncrement = cov_data->covIncrement;
+    context_index = cov_property_context_find(src,
+        cov_data->subscriberProcessIdentifier, false,
+        &cov_reference.monitoredObjectIdentifier,
+        &cov_reference.monitoredProperty);
+    if (cov_data->cancellationRequest) {
+        /* From BACnet Standard 135-2010-13.15.2
+           ...Cancellations that are issued for which no matching COV
+           context can be found shall succeed as if a context had
+           existed, returning 'Result(+)'. */
+        if (context_index >= 0) {
+            cov_property_context_free((unsigned)context_index);
+        }
+        return true;
+    }
+    if (!cov_property_reference_valid(
+            &cov_reference, true, error_class, error_code)) {
+        return false;
+    }
+    if (context_index < 0) {
+        context_index = cov_property_context_add(
+            src, cov_data->subscriberProcessIdentifier, false);
+        if (context_index < 0) {
+            *error_class = ERROR_CLASS_RESOURCES;
+            *error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
+            return false;
+        }
+    }
+    context = &COV_Property_Contexts[context_index];
+    context->issueConfirmedNotifications =
+        cov_data->issueConfirmedNotifications;
+    context->lifetime = cov_data->lifetime;
+    status = cov_property_subscribe(
+        (unsigned)context_index, &cov_reference, error_class, error_code);
+    if (!status) {
+        cov_property_context_prune((unsigned)context_index);
+    }
+
+    return status;
+}
+
+/** Handler for a COV Subscribe Property Service request.
+ * @ingroup DSCOV
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if
+ *   - the message is segmented
+ *   - if decoding fails
+ * - an ACK, if cov_subscribe_property() succeeds
+ * - an Error if cov_subscribe_property() fails
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_cov_subscribe_property(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    BACNET_SUBSCRIBE_COV_DATA cov_data = { 0 };
+    int len = 0;
+    int pdu_len = 0;
+    int npdu_len = 0;
+    int apdu_len = 0;
+    BACNET_NPDU_DATA npdu_data;
+    bool success = false;
+    int bytes_sent = 0;
+    BACNET_ADDRESS my_address;
+    bool error = false;
+
+    /* initialize a common abort code */
+    cov_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+    /* encode the NPDU portion of the packet */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    if (service_data->segmented_message) {
+        /* we don't support segmentation - send an abort */
+        len = BACNET_STATUS_ABORT;
+        error = true;
+    } else {
+        len = cov_subscribe_property_decode_service_request(
+            service_request, service_len, &cov_data);
+#if PRINT_ENABLED
+        if (len <= 0)
+            fprintf(stderr, "SubscribeCOVProperty: Unable to decode!\n");
+#endif
+        if (len < 0) {
+            error = true;
+        } else {
+            cov_data.error_class = ERROR_CLASS_OBJECT;
+            cov_data.error_code = ERROR_CODE_UNKNOWN_OBJECT;
+            success = cov_subscribe_property(
+                src, &cov_data, &cov_data.error_class, &cov_data.error_code);
+            if (success) {
+                apdu_len = encode_simple_ack(&Handler_Transmit_Buffer[npdu_len],
+                    service_data->invoke_id,
+                    SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY);
+            } else {
+                len = BACNET_STATUS_ERROR;
+                error = true;
+            }
+        }
+    }
+    /* Error? */
+    if (error) {
+        if (len == BACNET_STATUS_ABORT) {
+            apdu_len = abort_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
+                service_data->invoke_id,
+                abort_convert_error_code(cov_data.error_code), true);
+        } else if (len == BACNET_STATUS_ERROR) {
+            apdu_len = bacerror_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
+                service_data->invoke_id,
+                SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY, cov_data.error_class,
+                cov_data.error_code);
+        } else if (len == BACNET_STATUS_REJECT) {
+            apdu_len = reject_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
+                service_data->invoke_id,
+                reject_convert_error_code(cov_data.error_code));
+        }
+    }
+    pdu_len = npdu_len + apdu_len;
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+#if PRINT_ENABLED
+        fprintf(stderr, "SubscribeCOVProperty: Failed to send PDU (%s)!\n",
+            strerror(errno));
+#endif
+    }
+}
+
+/**
+ * @brief Subscribe or cancel the references of a SubscribeCOVPropertyMultiple
+ *  request.  The references before the first one that fails stay
+ *  subscribed, and the one that fails is reported in the error.
+ * @param src - address of the subscriber
+ * @param cov_data - decoded request, with the error when it fails
+ * @return true if every reference was subscribed or cancelled
+ */
+static bool cov_subscribe_property_multiple(
+    BACNET_ADDRESS *src, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *cov_data)
+{
+    BACNET_COV_PROPERTY_CONTEXT *context;
+    BACNET_COV_REFERENCE *cov_reference;
+    int context_index;
+    unsigned i;
+    bool status = true;
+
+    context_index = cov_property_context_find(
+        src, cov_data->subscriberProcessIdentifier, true, NULL, NULL);
+    if (cov_data->cancellationRequest) {
+        /* cancellations without a matching context succeed */
+        for (i = 0; (context_index >= 0) && (i < cov_data->reference_count);
+             i++) {
+            if (COV_Property_Contexts[context_index].valid) {
+                cov_property_unsubscribe(
+                    (unsigned)context_index, &cov_data->references[i]);
+            }
+        }
+        return true;
+    }
+    cov_data->failed_index = 0;
+    if (context_index < 0) {
+        context_index = cov_property_context_add(
+            src, cov_data->subscriberProcessIdentifier, true);
+        if (context_index < 0) {
+            cov_data->error_class = ERROR_CLASS_RESOURCES;
+            cov_data->error_code = ERROR_CODE_NO_SPACE_TO_ADD_LIST_ELEMENT;
+            return false;
+        }
+    }
+    context = &COV_Property_Contexts[context_index];
+    context->issueConfirmedNotifications =
+        cov_data->issueConfirmedNotifications;
+    context->lifetime = cov_data->lifetime;
+    context->maxNotificationDelay = cov_data->maxNotificationDelay;
+    for (i = 0; i < cov_data->reference_count; i++) {
+        cov_reference = &cov_data->references[i];
+        if (!cov_property_reference_valid(cov_reference, false,
+                &cov_data->error_class, &cov_data->error_code) ||
+            !cov_property_subscribe((unsigned)context_index, cov_reference,
+                &cov_data->error_class, &cov_data->error_code)) {
+            cov_data->failed_index = i;
+            status = false;
+            break;
+        }
+    }
+    if (!status) {
+        cov_property_context_prune((unsigned)context_index);
+    }
+
+    return status;
+}
+
+/** Handler for a COV Subscribe Property Multiple Service request.
+ * @ingroup DSCOV
+ * This handler will be invoked by apdu_handler() if it has been enabled
+ * by a call to apdu_set_confirmed_handler().
+ * This handler builds a response packet, which is
+ * - an Abort if
+ *   - the message is segmented
+ *   - there are more references than fit
+ * - a Reject if decoding fails
+ * - an ACK, if every reference was subscribed or cancelled
+ * - an Error with the first failed reference, if one of them failed
+ *
+ * @param service_request [in] The contents of the service request.
+ * @param service_len [in] The length of the service_request.
+ * @param src [in] BACNET_ADDRESS of the source of the message
+ * @param service_data [in] The BACNET_CONFIRMED_SERVICE_DATA information
+ *                          decoded from the APDU header of this message.
+ */
+void handler_cov_subscribe_property_multiple(uint8_t *service_request,
+    uint16_t service_len,
+    BACNET_ADDRESS *src,
+    BACNET_CONFIRMED_SERVICE_DATA *service_data)
+{
+    static BACNET_COV_REFERENCE
+        references[MAX_COV_SUBSCRIBE_MULTIPLE_REFERENCES];
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA cov_data = { 0 };
+    int len = 0;
+    int pdu_len = 0;
+    int npdu_len = 0;
+    int apdu_len = 0;
+    BACNET_NPDU_DATA npdu_data;
+    int bytes_sent = 0;
+    BACNET_ADDRESS my_address;
+
+    /* initialize a common abort code */
+    cov_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
+    cov_data.references = references;
+    cov_data.reference_size = MAX_COV_SUBSCRIBE_MULTIPLE_REFERENCES;
+    /* encode the NPDU portion of the packet */
+    datalink_get_my_address(&my_address);
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    npdu_len = npdu_encode_pdu(
+        &Handler_Transmit_Buffer[0], src, &my_address, &npdu_data);
+    if (service_data->segmented_message) {
+        /* we don't support segmentation - send an abort */
+        len = BACNET_STATUS_ABORT;
+    } else {
+        len = cov_subscribe_property_multiple_decode_service_request(
+            service_request, service_len, &cov_data);
+#if PRINT_ENABLED
+        if (len <= 0)
+            fprintf(stderr, "SubscribeCOVPropertyMultiple: "
+                "Unable to decode!\n");
+#endif
+    }
+    if (len == BACNET_STATUS_ABORT) {
+        apdu_len = abort_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
+            service_data->invoke_id,
+            abort_convert_error_code(cov_data.error_code), true);
+    } else if (len < 0) {
+        apdu_len = reject_encode_apdu(&Handler_Transmit_Buffer[npdu_len],
+            service_data->invoke_id,
+            reject_convert_error_code(cov_data.error_code));
+    } else if (cov_subscribe_property_multiple(src, &cov_data)) {
+        apdu_len = encode_simple_ack(&Handler_Transmit_Buffer[npdu_len],
+            service_data->invoke_id,
+            SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE);
+    } else {
+        apdu_len = cov_subscribe_property_multiple_error_encode_apdu(
+            &Handler_Transmit_Buffer[npdu_len], service_data->invoke_id,
+            &cov_data);
+    }
+    pdu_len = npdu_len + apdu_len;
+    bytes_sent = datalink_send_pdu(
+        src, &npdu_data, &Handler_Transmit_Buffer[0], pdu_len);
+    if (bytes_sent <= 0) {
+#if PRINT_ENABLED
+        fprintf(stderr,
+            "SubscribeCOVPropertyMultiple: Failed to send PDU (%s)!\n",
+            strerror(errno));
+#endif
+    }
+}
@@ -28,6 +28,24 @@ extern "C" {
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_DATA * service_data);
     BACNET_STACK_EXPORT
+    void handler_cov_subscribe_property(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
+    void handler_cov_subscribe_property_multiple(
+        uint8_t * service_request,
+        uint16_t service_len,
+        BACNET_ADDRESS * src,
+        BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
+    void handler_cov_max_notification_delay_set(
+        uint32_t seconds);
+    BACNET_STACK_EXPORT
+    unsigned handler_cov_property_count(
+        void);
+    BACNET_STACK_EXPORT
     bool handler_cov_fsm(
         void);
     BACNET_STACK_EXPORT
@@ -43,6 +61,10 @@ extern "C" {
     int handler_cov_encode_subscriptions(
         uint8_t * apdu,
         int max_apdu);
+    BACNET_STACK_EXPORT
+    int handler_cov_encode_multiple_subscriptions(
+        uint8_t * apdu,
+        int max_apdu);
 
 #ifdef __cplusplus
 }
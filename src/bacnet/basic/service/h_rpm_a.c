@@ -17,6 +17,7 @@
 #include "bacnet/apdu.h"
 #include "bacnet/bactext.h"
 #include "bacnet/rpm.h"
+#include "bacnet/tag_reader.h"
 /* some demo stuff needed */
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/services.h"
@@ -46,7 +47,7 @@ int rpm_ack_decode_service_request(
     int len = 0; /* number of bytes returned from decoding */
     uint8_t tag_number = 0; /* decoded tag number */
     uint32_t len_value = 0; /* decoded length value */
-    int data_len = 0; /* data blob length */
+    BACNET_TAG_READER reader; /* used to skip values we can't decode */
     BACNET_READ_ACCESS_DATA *rpm_object;
     BACNET_READ_ACCESS_DATA *old_rpm_object;
     BACNET_PROPERTY_REFERENCE *rpm_property;
@@ -95,7 +96,6 @@ int rpm_ack_decode_service_request(
             apdu_len -= len;
             apdu += len;
             if (apdu_len && decode_is_opening_tag_number(apdu, 4)) {
-                data_len = bacnet_enclosed_data_length(apdu, apdu_len);
                 /* propertyValue */
                 decoded_len++;
                 apdu_len--;
@@ -119,10 +119,16 @@ int rpm_ack_decode_service_request(
                         /* If len == 0 then it's an empty structure, which is
                          * OK. */
                         if (len < 0) {
-                            /* problem decoding */
-                            if (data_len >= 0) {
+                            /* problem decoding - skip the remaining
+                               elements up to the closing tag, if valid */
+                            bacnet_tag_reader_init(&reader, apdu, apdu_len);
+                            while (bacnet_tag_reader_skip(&reader)) {
+                                /* fast-forward without decoding */
+                            }
+                            if (!bacnet_tag_reader_error(&reader) &&
+                                !bacnet_tag_reader_done(&reader)) {
                                 /* valid data that we'll skip over */
-                                len = data_len;
+                                len = (int)bacnet_tag_reader_offset(&reader);
                                 bacapp_value_list_init(value, 1);
                             } else {
                                 PERROR("RPM Ack: unable to decode! %s:%s\n",
@@ -13,6 +13,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacaddr.h"
 #include "bacnet/bacdcode.h"
 #include "bacnet/whois.h"
 #include "bacnet/iam.h"
@@ -22,6 +23,159 @@
 
 /** @file h_whois.c  Handles Who-Is requests. */
 
+/* largest random delay before an I-Am response, in milliseconds.
+   Zero, with a zero interval, sends the I-Am responses immediately. */
+static uint16_t I_Am_Jitter_Max;
+/* shortest time between two I-Am responses, in milliseconds */
+static uint16_t I_Am_Interval_Min;
+/* milliseconds until another I-Am response may be sent */
+static uint16_t I_Am_Interval_Timer;
+/* state of the random delay generator */
+static uint32_t I_Am_Random;
+/* the one I-Am response that is waiting to be sent */
+static struct i_am_response {
+    bool pending : 1;
+    bool unicast : 1;
+    uint16_t delay;
+    BACNET_ADDRESS dest;
+} I_Am_Response;
+
+/**
+ * @brief Get a random delay for an I-Am response, so that the devices
+ *  answering the same Who-Is do not all answer at once.
+ * @return random delay 0..I_Am_Jitter_Max milliseconds
+ */
+static uint16_t i_am_response_jitter(void)
+{
+    uint32_t x;
+
+    if (I_Am_Jitter_Max == 0) {
+        return 0;
+    }
+    if (I_Am_Random == 0) {
+        /* seeded by the device instance, which is unique on the network */
+        I_Am_Random = Device_Object_Instance_Number() ^ 0x9E3779B9UL;
+        if (I_Am_Random == 0) {
+            I_Am_Random = 1;
+        }
+    }
+    /* xorshift32 */
+    x = I_Am_Random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    I_Am_Random = x;
+
+    return (uint16_t)(x % ((uint32_t)I_Am_Jitter_Max + 1UL));
+}
+
+/**
+ * @brief Send the I-Am response now, or schedule it.
+ *
+ * A Who-Is that arrives while a response is pending is coalesced with it:
+ * a second unicast request from the same source is dropped, and a request
+ * from another source, or a broadcast request, changes the pending
+ * response into a single broadcast I-Am.
+ *
+ * @param dest [in] BACnet address for a unicast response,
+ *  or NULL for a broadcast response.
+ */
+static void i_am_response(BACNET_ADDRESS *dest)
+{
+    struct i_am_response *response = &I_Am_Response;
+    uint16_t delay;
+
+    if ((I_Am_Jitter_Max == 0) && (I_Am_Interval_Min == 0)) {
+        if (dest) {
+            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], dest);
+        } else {
+            Send_I_Am(&Handler_Transmit_Buffer[0]);
+        }
+        return;
+    }
+    if (response->pending) {
+        if (response->unicast &&
+            (!dest || !bacnet_address_same(dest, &response->dest))) {
+            response->unicast = false;
+        }
+        return;
+    }
+    delay = i_am_response_jitter();
+    if (delay < I_Am_Interval_Timer) {
+        delay = I_Am_Interval_Timer;
+    }
+    response->pending = true;
+    response->delay = delay;
+    if (dest) {
+        response->unicast = true;
+        bacnet_address_copy(&response->dest, dest);
+    } else {
+        response->unicast = false;
+    }
+}
+
+/**
+ * @brief Set the largest random delay of the I-Am responses.
+ * @param milliseconds [in] largest delay, or 0 for no delay
+ */
+void handler_who_is_jitter_set(uint16_t milliseconds)
+{
+    I_Am_Jitter_Max = milliseconds;
+}
+
+/**
+ * @brief Set the shortest time between two I-Am responses.
+ * @param milliseconds [in] shortest time, or 0 for no limit
+ */
+void handler_who_is_interval_set(uint16_t milliseconds)
+{
+    I_Am_Interval_Min = milliseconds;
+    if (I_Am_Interval_Timer > milliseconds) {
+        I_Am_Interval_Timer = milliseconds;
+    }
+}
+
+/**
+ * @brief Determine if an I-Am response is waiting to be sent
+ * @return true if an I-Am response is waiting to be sent
+ */
+bool handler_who_is_pending(void)
+{
+    return I_Am_Response.pending;
+}
+
+/**
+ * @brief Sends the pending I-Am response when its delay has elapsed.
+ *  Only needed when a jitter or interval has been set.
+ * @param milliseconds [in] number of milliseconds elapsed since the
+ *  previous call.  Suggest that this is called every 10 to 50 milliseconds.
+ */
+void handler_who_is_timer(uint16_t milliseconds)
+{
+    struct i_am_response *response = &I_Am_Response;
+
+    if (I_Am_Interval_Timer > milliseconds) {
+        I_Am_Interval_Timer -= milliseconds;
+    } else {
+        I_Am_Interval_Timer = 0;
+    }
+    if (!response->pending) {
+        return;
+    }
+    if (response->delay > milliseconds) {
+        response->delay -= milliseconds;
+        return;
+    }
+    response->pending = false;
+    response->delay = 0;
+    if (response->unicast) {
+        Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], &response->dest);
+    } else {
+        Send_I_Am(&Handler_Transmit_Buffer[0]);
+    }
+    I_Am_Interval_Timer = I_Am_Interval_Min;
+}
+
 /** Handler for Who-Is requests, with broadcast I-Am response.
  * @ingroup DMDDB
  * @param service_request [in] The received message to be handled.
@@ -39,12 +193,12 @@ void handler_who_is(
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
     if (len == 0) {
-        Send_I_Am(&Handler_Transmit_Buffer[0]);
+        i_am_response(NULL);
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
         if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
             (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am(&Handler_Transmit_Buffer[0]);
+            i_am_response(NULL);
         }
     }
 
@@ -70,12 +224,12 @@ void handler_who_is_unicast(
         service_request, service_len, &low_limit, &high_limit);
     /* If no limits, then always respond */
     if (len == 0) {
-        Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+        i_am_response(src);
     } else if (len != BACNET_STATUS_ERROR) {
         /* is my device id within the limits? */
         if ((Device_Object_Instance_Number() >= (uint32_t)low_limit) &&
             (Device_Object_Instance_Number() <= (uint32_t)high_limit)) {
-            Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
+            i_am_response(src);
         }
     }
 
@@ -92,6 +246,9 @@ void handler_who_is_unicast(
 /** Local function to check Who-Is requests against our Device IDs.
  * Will check the gateway (root Device) and all virtual routed
  * Devices against the range and respond for each that matches.
+ * The matching Devices are found in the instance index.  The first
+ * batch of their I-Am responses is sent now, and the rest are sent by
+ * the calls of the application to Routed_Device_I_Am_Task().
  *
  * @param service_request [in] The received message to be handled.
  * @param service_len [in] Length of the service_request message.
@@ -108,10 +265,6 @@ static void check_who_is_for_routing(uint8_t *service_request,
     int len = 0;
     int32_t low_limit = 0;
     int32_t high_limit = 0;
-    int32_t dev_instance;
-    int cursor = 0; /* Starting hint */
-    int my_list[2] = { 0, -1 }; /* Not really used, so dummy values */
-    BACNET_ADDRESS bcast_net;
 
     len = whois_decode_service_request(
         service_request, service_len, &low_limit, &high_limit);
@@ -119,21 +272,17 @@ static void check_who_is_for_routing(uint8_t *service_request,
         /* Invalid; just leave */
         return;
     }
-    /* Go through all devices, starting with the root gateway Device */
-    memset(&bcast_net, 0, sizeof(BACNET_ADDRESS));
-    bcast_net.net = BACNET_BROADCAST_NETWORK; /* That's all we have to set */
-
-    while (Routed_Device_GetNext(&bcast_net, my_list, &cursor)) {
-        dev_instance = Device_Object_Instance_Number();
-        /* If len == 0, no limits and always respond */
-        if ((len == 0) ||
-            ((dev_instance >= low_limit) && (dev_instance <= high_limit))) {
-            if (is_unicast)
-                Send_I_Am_Unicast(&Handler_Transmit_Buffer[0], src);
-            else
-                Send_I_Am(&Handler_Transmit_Buffer[0]);
-        }
+    /* If len == 0, no limits and always respond */
+    if (len == 0) {
+        low_limit = 0;
+        high_limit = BACNET_MAX_INSTANCE;
+    }
+    if ((low_limit < 0) || (high_limit < low_limit)) {
+        return;
     }
+    Routed_Device_I_Am_Request(
+        (uint32_t)low_limit, (uint32_t)high_limit, is_unicast ? src : NULL);
+    (void)Routed_Device_I_Am_Task(0);
 }
 
 /** Handler for Who-Is requests in the virtual routing setup,
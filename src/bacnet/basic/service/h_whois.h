@@ -37,6 +37,25 @@ extern "C" {
         BACNET_ADDRESS * src);
 
     BACNET_STACK_EXPORT
+    void handler_who_is_jitter_set(
+        uint16_t milliseconds);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_interval_set(
+        uint16_t milliseconds);
+
+    BACNET_STACK_EXPORT
+    bool handler_who_is_pending(
+        void);
+
+    BACNET_STACK_EXPORT
+    void handler_who_is_timer(
+        uint16_t milliseconds);
+
+    /* The routing handlers send the first ROUTED_DEVICE_I_AM_BATCH I-Am
+       at once.  When more Devices match, the application must call
+       Routed_Device_I_Am_Task() from its main loop to send the rest. */
+    BACNET_STACK_EXPORT
     void handler_who_is_bcast_for_routing(
         uint8_t * service_request,
         uint16_t service_len,
@@ -8,6 +8,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 /* BACnet Stack defines - first */
@@ -31,25 +32,94 @@
 /** @file h_wpm.c  Handles Write Property Multiple requests. */
 #define PRINTF debug_perror
 
-/** Decoding for an object property.
+/* one property write of the request, referencing its value in place */
+typedef struct write_plan_entry {
+    uint32_t object_instance;
+    uint32_t object_property;
+    BACNET_ARRAY_INDEX array_index;
+    uint16_t object_type;
+    uint16_t value_offset;
+    uint16_t value_len;
+    uint8_t priority;
+} WRITE_PLAN_ENTRY;
+
+/* the smallest property write: a property identifier, the opening tag,
+   a NULL value, and the closing tag */
+#define WRITE_PLAN_ENTRY_SIZE_MIN 5
+
+static write_property_function Write_Property_Check[MAX_BACNET_OBJECT_TYPE];
+static write_property_function Write_Property_Check_Default;
+
+/**
+ * @brief Set the function that checks a property write of an object type
+ *  without applying it.  When every property in a request has a check
+ *  function, a request with a property that can not be written at all,
+ *  such as an unknown object or property, is rejected before anything
+ *  is written.  Errors in the values are only found while writing.
+ * @param object_type - object type
+ * @param pFunction - function that checks the write, or NULL
+ */
+void handler_write_property_multiple_check_set(
+    BACNET_OBJECT_TYPE object_type, write_property_function pFunction)
+{
+    if (object_type < MAX_BACNET_OBJECT_TYPE) {
+        Write_Property_Check[object_type] = pFunction;
+    }
+}
+
+/**
+ * @brief Set the function that checks a property write of the object
+ *  types that have no check function of their own, such as
+ *  Device_Write_Property_Check()
+ * @param pFunction - function that checks the write, or NULL
+ */
+void handler_write_property_multiple_check_default_set(
+    write_property_function pFunction)
+{
+    Write_Property_Check_Default = pFunction;
+}
+
+/**
+ * @brief Get the function that checks a property write of an object type
+ * @param object_type - object type
+ * @return function that checks the write, or NULL
+ */
+static write_property_function write_property_check(uint16_t object_type)
+{
+    if ((object_type < MAX_BACNET_OBJECT_TYPE) &&
+        Write_Property_Check[object_type]) {
+        return Write_Property_Check[object_type];
+    }
+
+    return Write_Property_Check_Default;
+}
+
+/** Decoding of the request into the write plan.
  *
  * @param apdu [in] The contents of the APDU buffer.
  * @param apdu_len [in] The length of the APDU buffer.
  * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
- * @param device_write_property - Device object WriteProperty function
+ * @param plan [out] The write plan.
+ * @param plan_size [in] The number of property writes the plan holds.
+ * @param count [out] The number of property writes in the plan.
  *
  * @return number of bytes decoded, or BACNET_STATUS_REJECT,
- *  or BACNET_STATUS_ERROR
+ *  or BACNET_STATUS_ABORT
  */
-static int write_property_multiple_decode(uint8_t *apdu,
+static int write_plan_decode(uint8_t *apdu,
     uint16_t apdu_len,
     BACNET_WRITE_PROPERTY_DATA *wp_data,
-    write_property_function device_write_property)
+    WRITE_PLAN_ENTRY *plan,
+    unsigned plan_size,
+    unsigned *count)
 {
     int len = 0;
     int offset = 0;
     uint8_t tag_number = 0;
+    uint16_t value_offset = 0;
+    WRITE_PLAN_ENTRY *entry;
 
+    *count = 0;
     /* decode service request */
     do {
         /* decode Object Identifier */
@@ -63,35 +133,26 @@ static int write_property_multiple_decode(uint8_t *apdu,
                       (3) an optional 'Property Array Index'
                       (4) a 'Property Value'
                       (5) an optional 'Priority' */
-                    len = wpm_decode_object_property(
-                        &apdu[offset], apdu_len - offset, wp_data);
-                    if (len > 0) {
-                        offset += len;
-                        PRINTF("WPM: type=%lu instance=%lu property=%lu "
-                               "priority=%lu index=%ld\n",
-                            (unsigned long)wp_data->object_type,
-                            (unsigned long)wp_data->object_instance,
-                            (unsigned long)wp_data->object_property,
-                            (unsigned long)wp_data->priority,
-                            (long)wp_data->array_index);
-                        if (device_write_property) {
-                            if (device_write_property(wp_data) == false) {
-                                /* Workaround BTL Specified Test 9.23.2.X5 */
-                                if ((wp_data->error_class ==
-                                        ERROR_CLASS_PROPERTY) &&
-                                    (wp_data->error_code ==
-                                        ERROR_CODE_INVALID_DATA_TYPE)) {
-                                    wp_data->error_class = ERROR_CLASS_SERVICES;
-                                    wp_data->error_code =
-                                        ERROR_CODE_INVALID_TAG;
-                                }
-                                return BACNET_STATUS_ERROR;
-                            }
-                        }
-                    } else {
+                    len = wpm_decode_object_property_reference(&apdu[offset],
+                        apdu_len - offset, wp_data, &value_offset);
+                    if (len <= 0) {
                         PRINTF("WPM: Bad Encoding!\n");
                         return len;
                     }
+                    if (*count >= plan_size) {
+                        wp_data->error_code = ERROR_CODE_ABORT_BUFFER_OVERFLOW;
+                        return BACNET_STATUS_ABORT;
+                    }
+                    entry = &plan[*count];
+                    entry->object_type = (uint16_t)wp_data->object_type;
+                    entry->object_instance = wp_data->object_instance;
+                    entry->object_property = wp_data->object_property;
+                    entry->array_index = wp_data->array_index;
+                    entry->priority = wp_data->priority;
+                    entry->value_offset = (uint16_t)(offset + value_offset);
+                    entry->value_len = (uint16_t)wp_data->application_data_len;
+                    (*count)++;
+                    offset += len;
                     /* Closing tag 1 - List of Properties */
                     if (decode_is_closing_tag_number(&apdu[offset], 1)) {
                         tag_number = 1;
@@ -112,6 +173,88 @@ static int write_property_multiple_decode(uint8_t *apdu,
     return len;
 }
 
+/**
+ * @brief Load a property write of the plan into the WriteProperty data
+ * @param entry [in] The property write of the plan.
+ * @param apdu [in] The contents of the APDU buffer.
+ * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
+ */
+static void write_plan_entry_load(const WRITE_PLAN_ENTRY *entry,
+    const uint8_t *apdu,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    wp_data->object_type = (BACNET_OBJECT_TYPE)entry->object_type;
+    wp_data->object_instance = entry->object_instance;
+    wp_data->object_property = (BACNET_PROPERTY_ID)entry->object_property;
+    wp_data->array_index = entry->array_index;
+    wp_data->priority = entry->priority;
+    wp_data->application_data_len = entry->value_len;
+    memcpy(
+        wp_data->application_data, &apdu[entry->value_offset], entry->value_len);
+}
+
+/**
+ * @brief Check the write plan before anything is written.  The plan is
+ *  only checked when every object type in it has a check function, and
+ *  a plan that passes may still fail while it is applied, for example
+ *  on a value that is out of range.
+ * @param plan [in] The write plan.
+ * @param count [in] The number of property writes in the plan.
+ * @param apdu [in] The contents of the APDU buffer.
+ * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure,
+ *  holding the first failed property write.
+ * @return true if the plan can be applied
+ */
+static bool write_plan_check(const WRITE_PLAN_ENTRY *plan,
+    unsigned count,
+    const uint8_t *apdu,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        if (!write_property_check(plan[i].object_type)) {
+            return true;
+        }
+    }
+    for (i = 0; i < count; i++) {
+        write_plan_entry_load(&plan[i], apdu, wp_data);
+        if (!write_property_check(plan[i].object_type)(wp_data)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Apply the write plan to the objects of this device, in order.
+ *  As the standard requires, the properties written before a property
+ *  that fails stay written.
+ * @param plan [in] The write plan.
+ * @param count [in] The number of property writes in the plan.
+ * @param apdu [in] The contents of the APDU buffer.
+ * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure,
+ *  holding the first failed property write.
+ * @return true if every property was written
+ */
+static bool write_plan_apply(const WRITE_PLAN_ENTRY *plan,
+    unsigned count,
+    const uint8_t *apdu,
+    BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    unsigned i;
+
+    for (i = 0; i < count; i++) {
+        write_plan_entry_load(&plan[i], apdu, wp_data);
+        if (!Device_Write_Property(wp_data)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 /** Handler for a WriteProperty Service request.
  * @ingroup DSWP
  * This handler will be invoked by apdu_handler() if it has been enabled
@@ -120,8 +263,17 @@ static int write_property_multiple_decode(uint8_t *apdu,
  * - an Abort if
  *   - the message is segmented
  *   - if decoding fails
- * - an ACK if Device_Write_Property_Multiple() succeeds
- * - an Error if Device_Write_PropertyMultiple() encounters an error
+ * - an ACK if Device_Write_Property() succeeds for every property
+ * - an Error if a check function registered with
+ *   handler_write_property_multiple_check_set() or
+ *   handler_write_property_multiple_check_default_set() fails, in which
+ *   case nothing is written, or if Device_Write_Property() encounters
+ *   an error, in which case the properties before it stay written
+ *
+ * The request is decoded once into a write plan that references the
+ * property values in place, so nothing is written unless the whole
+ * request is well formed.  The plan is sized from the length of the
+ * request, up to BACNET_WPM_PLAN_MAX property writes.
  *
  * @param service_request [in] The contents of the service request.
  * @param service_len [in] The length of the service_request.
@@ -142,19 +294,43 @@ void handler_write_property_multiple(uint8_t *service_request,
     BACNET_NPDU_DATA npdu_data;
     BACNET_ADDRESS my_address;
     int bytes_sent = 0;
+    WRITE_PLAN_ENTRY *plan = NULL;
+    unsigned plan_size = 0;
+    unsigned count = 0;
 
     if (service_data->segmented_message) {
         wp_data.error_code = ERROR_CODE_ABORT_SEGMENTATION_NOT_SUPPORTED;
         len = BACNET_STATUS_ABORT;
         PRINTF("WPM: Segmented message.  Sending Abort!\n");
     } else {
-        /* first time - detect malformed request before writing any data */
-        len = write_property_multiple_decode(
-            service_request, service_len, &wp_data, NULL);
+        /* enough for the smallest property writes filling the request */
+        plan_size = (service_len / WRITE_PLAN_ENTRY_SIZE_MIN) + 1;
+        if (plan_size > BACNET_WPM_PLAN_MAX) {
+            plan_size = BACNET_WPM_PLAN_MAX;
+        }
+        plan = calloc(plan_size, sizeof(WRITE_PLAN_ENTRY));
+        if (plan) {
+            /* decode once - detect malformed request before writing data */
+            len = write_plan_decode(service_request, service_len, &wp_data,
+                plan, plan_size, &count);
+        } else {
+            wp_data.error_code = ERROR_CODE_ABORT_OUT_OF_RESOURCES;
+            len = BACNET_STATUS_ABORT;
+        }
         if (len > 0) {
-            len = write_property_multiple_decode(
-                service_request, service_len, &wp_data, Device_Write_Property);
+            PRINTF("WPM: %u properties\n", count);
+            if (!write_plan_check(plan, count, service_request, &wp_data) ||
+                !write_plan_apply(plan, count, service_request, &wp_data)) {
+                /* Workaround BTL Specified Test 9.23.2.X5 */
+                if ((wp_data.error_class == ERROR_CLASS_PROPERTY) &&
+                    (wp_data.error_code == ERROR_CODE_INVALID_DATA_TYPE)) {
+                    wp_data.error_class = ERROR_CLASS_SERVICES;
+                    wp_data.error_code = ERROR_CODE_INVALID_TAG;
+                }
+                len = BACNET_STATUS_ERROR;
+            }
         }
+        free(plan);
     }
     /* encode the confirmed reply */
     datalink_get_my_address(&my_address);
@@ -20,6 +20,15 @@
 /* BACnet Stack API */
 #include "bacnet/bacapp.h"
 #include "bacnet/apdu.h"
+#include "bacnet/wp.h"
+
+/* number of property writes in a WritePropertyMultiple request that can
+   be handled; the plan is allocated for each request from its length,
+   and the smallest property write is 5 octets, so by default every
+   unsegmented request fits */
+#ifndef BACNET_WPM_PLAN_MAX
+#define BACNET_WPM_PLAN_MAX ((MAX_APDU / 5) + 1)
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,6 +40,13 @@ extern "C" {
         uint16_t service_len,
         BACNET_ADDRESS * src,
         BACNET_CONFIRMED_SERVICE_DATA * service_data);
+    BACNET_STACK_EXPORT
+    void handler_write_property_multiple_check_set(
+        BACNET_OBJECT_TYPE object_type,
+        write_property_function pFunction);
+    BACNET_STACK_EXPORT
+    void handler_write_property_multiple_check_default_set(
+        write_property_function pFunction);
 
 #ifdef __cplusplus
 }
@@ -40,12 +40,16 @@ static struct Keylist *KeylistCreate(void)
 
 /** Check to see if the array is big enough for an addition
  * or is too big when we are deleting and we can shrink.
+ * The array grows by half of its size, so that adding many
+ * nodes (for example, creating all the objects at startup)
+ * copies each node pointer only a few times.
  *
  * @param list  Pointer to the list to be tested.
+ * @param adding  true if a node is being added, false if deleted
  *
  * @return Returns true if success, false if failed
  */
-static bool CheckArraySize(OS_Keylist list)
+static bool CheckArraySize(OS_Keylist list, bool adding)
 {
     int new_size = 0; /* set it up so that no size change is the default */
     const int chunk = 8; /* minimum number of nodes to allocate memory for */
@@ -56,20 +60,24 @@ static bool CheckArraySize(OS_Keylist list)
     }
 
     /* indicates the need for more memory allocation */
-    if (list->count == list->size) {
-        new_size = list->size + chunk;
-
-        /* allow for shrinking memory */
-    } else if ((list->size > chunk) && (list->count < (list->size - chunk))) {
-        new_size = list->size - chunk;
+    if (adding) {
+        if (list->count == list->size) {
+            new_size = list->size + chunk + (list->size / 2);
+        }
+        /* allow for shrinking memory when only a quarter is used */
+    } else if ((list->size > chunk) && (list->count < (list->size / 4))) {
+        new_size = list->size / 2;
+        if (new_size < chunk) {
+            new_size = chunk;
+        }
     }
     if (new_size > 0) {
         /* Allocate more room for node pointer array */
         new_array = calloc((size_t)new_size, sizeof(struct Keylist_Node *));
 
-        /* See if we got the memory we wanted */
+        /* See if we got the memory we wanted - no room to add */
         if (!new_array) {
-            return true;
+            return !adding;
         }
 
         /* copy the nodes from the old array to the new array */
@@ -170,7 +178,7 @@ int Keylist_Data_Add(OS_Keylist list, KEY key, void *data)
     int index = -1; /* return value */
     int i; /* counts through the array */
 
-    if (list && CheckArraySize(list)) {
+    if (list && CheckArraySize(list, true)) {
         /* figure out where to put the new node */
         if (list->count) {
             (void)FindIndex(list, key, &index);
@@ -242,7 +250,7 @@ void *Keylist_Data_Delete_By_Index(OS_Keylist list, int index)
             }
 
             /* potentially reduce the size of the array */
-            (void)CheckArraySize(list);
+            (void)CheckArraySize(list, false);
         }
     }
     return (data);
@@ -477,7 +485,7 @@ OS_Keylist Keylist_Create(void)
 
     list = KeylistCreate();
     if (list) {
-        CheckArraySize(list);
+        CheckArraySize(list, true);
     }
 
     return list;
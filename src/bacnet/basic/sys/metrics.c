@@ -0,0 +1,255 @@
+/**
+ * @file
+ * @brief BACnet Stack performance counters and latency histograms
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The counters are 32-bit words.  The datalinks may count from their own
+ * threads, as in the router with one thread per port, so with GCC or
+ * Clang the counters use relaxed atomic operations; other compilers get
+ * plain increments and the counters must then only be written by a single
+ * task.  The handler latency histograms are only updated by the task that
+ * runs the APDU handler, and need a microsecond clock from the
+ * application; until one is set, only the request counts are recorded.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/metrics.h"
+
+#if defined(__GNUC__)
+#define METRICS_COUNTER_ADD(counter) \
+    ((void)__atomic_add_fetch(&(counter), 1, __ATOMIC_RELAXED))
+#define METRICS_COUNTER_LOAD(counter) \
+    __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define METRICS_COUNTER_CLEAR(counter) \
+    __atomic_store_n(&(counter), 0, __ATOMIC_RELAXED)
+#else
+#define METRICS_COUNTER_ADD(counter) ((void)(counter)++)
+#define METRICS_COUNTER_LOAD(counter) (counter)
+#define METRICS_COUNTER_CLEAR(counter) ((counter) = 0)
+#endif
+
+static uint32_t Metrics_Counter[BACNET_METRIC_MAX];
+static BACNET_METRICS_HISTOGRAM
+    Metrics_Confirmed_Service[MAX_BACNET_CONFIRMED_SERVICE];
+static BACNET_METRICS_HISTOGRAM
+    Metrics_Unconfirmed_Service[MAX_BACNET_UNCONFIRMED_SERVICE];
+static bacnet_metrics_clock_function Metrics_Clock;
+
+static const char *Metrics_Name[BACNET_METRIC_MAX] = {
+    "datalink-rx", "datalink-rx-dropped", "datalink-tx", "datalink-tx-errors",
+    "npdu-rx", "npdu-rx-dropped", "apdu-rx-dropped", "tsm-retries",
+    "tsm-timeouts", "cov-notifications-sent", "cov-notifications-dropped",
+    "address-cache-hits", "address-cache-misses", "bbmd-forwarded-local",
+    "bbmd-forwarded-bdt", "bbmd-forwarded-fdt"
+};
+
+/**
+ * @brief Increment a counter, from any thread when built with GCC or Clang
+ * @param id - counter identifier
+ */
+void bacnet_metrics_increment(BACNET_METRIC_ID id)
+{
+    if (id < BACNET_METRIC_MAX) {
+        METRICS_COUNTER_ADD(Metrics_Counter[id]);
+    }
+}
+
+/**
+ * @brief Get the value of a counter
+ * @param id - counter identifier
+ * @return counter value, which wraps to zero after 2^32-1
+ */
+uint32_t bacnet_metrics_counter(BACNET_METRIC_ID id)
+{
+    if (id < BACNET_METRIC_MAX) {
+        return METRICS_COUNTER_LOAD(Metrics_Counter[id]);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the name of a counter, for reports
+ * @param id - counter identifier
+ * @return name of the counter, or NULL if not a counter
+ */
+const char *bacnet_metrics_name(BACNET_METRIC_ID id)
+{
+    if (id < BACNET_METRIC_MAX) {
+        return Metrics_Name[id];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Set the clock used to measure the handler latency
+ * @param clock - function returning free running microseconds, or NULL
+ */
+void bacnet_metrics_clock_set(bacnet_metrics_clock_function clock)
+{
+    Metrics_Clock = clock;
+}
+
+/**
+ * @brief Get a timestamp for measuring the latency
+ * @return free running microseconds, or zero if there is no clock
+ */
+uint32_t bacnet_metrics_timestamp(void)
+{
+    if (Metrics_Clock) {
+        return Metrics_Clock();
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Add a sample to a latency histogram
+ * @param histogram - latency histogram
+ * @param elapsed_us - latency in microseconds
+ */
+void bacnet_metrics_histogram_add(
+    BACNET_METRICS_HISTOGRAM *histogram, uint32_t elapsed_us)
+{
+    unsigned bucket = 0;
+    uint32_t value = elapsed_us;
+
+    if (!histogram) {
+        return;
+    }
+    while (value && (bucket < (BACNET_METRICS_HISTOGRAM_BUCKETS - 1))) {
+        value >>= 1;
+        bucket++;
+    }
+    histogram->bucket[bucket]++;
+    histogram->count++;
+    histogram->total_us += elapsed_us;
+    if (elapsed_us > histogram->max_us) {
+        histogram->max_us = elapsed_us;
+    }
+}
+
+/**
+ * @brief Estimate a percentile of a latency histogram
+ * @param histogram - latency histogram
+ * @param percent - percentile from 0 to 100
+ * @return upper bound of the bucket holding the percentile, in
+ *  microseconds, limited to the largest latency seen
+ */
+uint32_t bacnet_metrics_histogram_percentile(
+    const BACNET_METRICS_HISTOGRAM *histogram, unsigned percent)
+{
+    uint64_t target, total = 0;
+    uint32_t upper_us;
+    unsigned bucket;
+
+    if (!histogram || (histogram->count == 0)) {
+        return 0;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    target = ((uint64_t)histogram->count * percent + 99) / 100;
+    if (target == 0) {
+        target = 1;
+    }
+    for (bucket = 0; bucket < BACNET_METRICS_HISTOGRAM_BUCKETS; bucket++) {
+        total += histogram->bucket[bucket];
+        if (total >= target) {
+            break;
+        }
+    }
+    if (bucket >= (BACNET_METRICS_HISTOGRAM_BUCKETS - 1)) {
+        return histogram->max_us;
+    }
+    upper_us = bucket ? ((1UL << bucket) - 1UL) : 0;
+    if (upper_us > histogram->max_us) {
+        upper_us = histogram->max_us;
+    }
+
+    return upper_us;
+}
+
+/**
+ * @brief Count a confirmed service request handled and its latency
+ * @param service - BACNET_CONFIRMED_SERVICE
+ * @param start_us - timestamp from before the handler was called
+ */
+void bacnet_metrics_confirmed_service_update(uint8_t service, uint32_t start_us)
+{
+    if (service < MAX_BACNET_CONFIRMED_SERVICE) {
+        bacnet_metrics_histogram_add(&Metrics_Confirmed_Service[service],
+            bacnet_metrics_timestamp() - start_us);
+    }
+}
+
+/**
+ * @brief Count an unconfirmed service request handled and its latency
+ * @param service - BACNET_UNCONFIRMED_SERVICE
+ * @param start_us - timestamp from before the handler was called
+ */
+void bacnet_metrics_unconfirmed_service_update(
+    uint8_t service, uint32_t start_us)
+{
+    if (service < MAX_BACNET_UNCONFIRMED_SERVICE) {
+        bacnet_metrics_histogram_add(&Metrics_Unconfirmed_Service[service],
+            bacnet_metrics_timestamp() - start_us);
+    }
+}
+
+/**
+ * @brief Get the request count and latency of a confirmed service
+ * @param service - BACNET_CONFIRMED_SERVICE
+ * @param histogram - copy of the latency histogram
+ * @return true if the service is valid
+ */
+bool bacnet_metrics_confirmed_service(
+    uint8_t service, BACNET_METRICS_HISTOGRAM *histogram)
+{
+    if ((service < MAX_BACNET_CONFIRMED_SERVICE) && histogram) {
+        *histogram = Metrics_Confirmed_Service[service];
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get the request count and latency of an unconfirmed service
+ * @param service - BACNET_UNCONFIRMED_SERVICE
+ * @param histogram - copy of the latency histogram
+ * @return true if the service is valid
+ */
+bool bacnet_metrics_unconfirmed_service(
+    uint8_t service, BACNET_METRICS_HISTOGRAM *histogram)
+{
+    if ((service < MAX_BACNET_UNCONFIRMED_SERVICE) && histogram) {
+        *histogram = Metrics_Unconfirmed_Service[service];
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Clear all of the counters and histograms
+ */
+void bacnet_metrics_reset(void)
+{
+    unsigned i;
+
+    for (i = 0; i < BACNET_METRIC_MAX; i++) {
+        METRICS_COUNTER_CLEAR(Metrics_Counter[i]);
+    }
+    memset(Metrics_Confirmed_Service, 0, sizeof(Metrics_Confirmed_Service));
+    memset(
+        Metrics_Unconfirmed_Service, 0, sizeof(Metrics_Unconfirmed_Service));
+}
@@ -0,0 +1,124 @@
+/**
+ * @file
+ * @brief API for the BACnet Stack performance counters and histograms
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_SYS_METRICS_H
+#define BACNET_SYS_METRICS_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+#ifndef BACNET_METRICS_ENABLED
+#define BACNET_METRICS_ENABLED 0
+#endif
+
+/* number of log2 microsecond buckets in a latency histogram:
+   bucket 0 is 0us, bucket N is 2^(N-1)..2^N-1 us, the last is the rest */
+#ifndef BACNET_METRICS_HISTOGRAM_BUCKETS
+#define BACNET_METRICS_HISTOGRAM_BUCKETS 24
+#endif
+
+typedef enum bacnet_metric_id {
+    BACNET_METRIC_DATALINK_RX = 0,
+    BACNET_METRIC_DATALINK_RX_DROPPED,
+    BACNET_METRIC_DATALINK_TX,
+    BACNET_METRIC_DATALINK_TX_ERRORS,
+    BACNET_METRIC_NPDU_RX,
+    BACNET_METRIC_NPDU_RX_DROPPED,
+    BACNET_METRIC_APDU_RX_DROPPED,
+    BACNET_METRIC_TSM_RETRIES,
+    BACNET_METRIC_TSM_TIMEOUTS,
+    BACNET_METRIC_COV_NOTIFICATIONS_SENT,
+    BACNET_METRIC_COV_NOTIFICATIONS_DROPPED,
+    BACNET_METRIC_ADDRESS_CACHE_HITS,
+    BACNET_METRIC_ADDRESS_CACHE_MISSES,
+    BACNET_METRIC_BBMD_FORWARDED_LOCAL,
+    BACNET_METRIC_BBMD_FORWARDED_BDT,
+    BACNET_METRIC_BBMD_FORWARDED_FDT,
+    BACNET_METRIC_MAX
+} BACNET_METRIC_ID;
+
+typedef struct bacnet_metrics_histogram {
+    uint32_t count;
+    uint32_t max_us;
+    uint64_t total_us;
+    uint32_t bucket[BACNET_METRICS_HISTOGRAM_BUCKETS];
+} BACNET_METRICS_HISTOGRAM;
+
+/* returns a free running microsecond timestamp */
+typedef uint32_t (*bacnet_metrics_clock_function)(void);
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_increment(
+        BACNET_METRIC_ID id);
+    BACNET_STACK_EXPORT
+    uint32_t bacnet_metrics_counter(
+        BACNET_METRIC_ID id);
+    BACNET_STACK_EXPORT
+    const char *bacnet_metrics_name(
+        BACNET_METRIC_ID id);
+
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_clock_set(
+        bacnet_metrics_clock_function clock);
+    BACNET_STACK_EXPORT
+    uint32_t bacnet_metrics_timestamp(
+        void);
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_confirmed_service_update(
+        uint8_t service,
+        uint32_t start_us);
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_unconfirmed_service_update(
+        uint8_t service,
+        uint32_t start_us);
+    BACNET_STACK_EXPORT
+    bool bacnet_metrics_confirmed_service(
+        uint8_t service,
+        BACNET_METRICS_HISTOGRAM *histogram);
+    BACNET_STACK_EXPORT
+    bool bacnet_metrics_unconfirmed_service(
+        uint8_t service,
+        BACNET_METRICS_HISTOGRAM *histogram);
+
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_histogram_add(
+        BACNET_METRICS_HISTOGRAM *histogram,
+        uint32_t elapsed_us);
+    BACNET_STACK_EXPORT
+    uint32_t bacnet_metrics_histogram_percentile(
+        const BACNET_METRICS_HISTOGRAM *histogram,
+        unsigned percent);
+
+    BACNET_STACK_EXPORT
+    void bacnet_metrics_reset(
+        void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+/* hot path instrumentation compiles to nothing when disabled */
+#if BACNET_METRICS_ENABLED
+#define BACNET_METRICS_INCREMENT(id) bacnet_metrics_increment(id)
+#define BACNET_METRICS_TIMESTAMP() bacnet_metrics_timestamp()
+#define BACNET_METRICS_CONFIRMED_SERVICE(service, start_us) \
+    bacnet_metrics_confirmed_service_update(service, start_us)
+#define BACNET_METRICS_UNCONFIRMED_SERVICE(service, start_us) \
+    bacnet_metrics_unconfirmed_service_update(service, start_us)
+#else
+#define BACNET_METRICS_INCREMENT(id) ((void)0)
+#define BACNET_METRICS_TIMESTAMP() (0)
+#define BACNET_METRICS_CONFIRMED_SERVICE(service, start_us) ((void)(start_us))
+#define BACNET_METRICS_UNCONFIRMED_SERVICE(service, start_us) \
+    ((void)(start_us))
+#endif
+#endif
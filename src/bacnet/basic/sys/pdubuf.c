@@ -0,0 +1,217 @@
+/**
+ * @file
+ * @brief A PDU buffer with headroom and tailroom.  A datalink receives
+ *  into the buffer after some headroom, and each layer strips its header
+ *  by moving the head forward, so the NPDU and APDU are never shifted.
+ *  A router rewrites the NPCI in place by pulling the old header and
+ *  pushing the new one into the headroom.
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/basic/sys/pdubuf.h"
+
+/**
+ * @brief Initialize a PDU buffer with one user and no PDU
+ * @param b - PDU buffer
+ * @param data - block of memory
+ * @param size - size, in bytes, of the block of memory
+ * @param headroom - number of octets to reserve in front of the PDU
+ */
+void pdubuf_init(
+    BACNET_PDU_BUFFER *b, uint8_t *data, uint16_t size, uint16_t headroom)
+{
+    if (b) {
+        b->data = data;
+        b->size = data ? size : 0;
+        b->refcount = 1;
+        pdubuf_reset(b, headroom);
+    }
+}
+
+/**
+ * @brief Empty a PDU buffer
+ * @param b - PDU buffer
+ * @param headroom - number of octets to reserve in front of the PDU
+ */
+void pdubuf_reset(BACNET_PDU_BUFFER *b, uint16_t headroom)
+{
+    if (b) {
+        if (headroom > b->size) {
+            headroom = b->size;
+        }
+        b->head = headroom;
+        b->length = 0;
+    }
+}
+
+/**
+ * @brief Get the first octet of the PDU
+ * @param b - PDU buffer
+ * @return first octet of the PDU, or NULL if not initialized
+ */
+uint8_t *pdubuf_data(BACNET_PDU_BUFFER const *b)
+{
+    if (b && b->data) {
+        return &b->data[b->head];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Get the number of octets in the PDU
+ * @param b - PDU buffer
+ * @return number of octets in the PDU
+ */
+uint16_t pdubuf_length(BACNET_PDU_BUFFER const *b)
+{
+    return b ? b->length : 0;
+}
+
+/**
+ * @brief Get the number of octets free in front of the PDU
+ * @param b - PDU buffer
+ * @return number of octets that may be pushed
+ */
+uint16_t pdubuf_headroom(BACNET_PDU_BUFFER const *b)
+{
+    return b ? b->head : 0;
+}
+
+/**
+ * @brief Get the number of octets free after the PDU
+ * @param b - PDU buffer
+ * @return number of octets that may be put
+ */
+uint16_t pdubuf_tailroom(BACNET_PDU_BUFFER const *b)
+{
+    if (b) {
+        return b->size - b->head - b->length;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Get the octet after the PDU, where a datalink may receive
+ * @param b - PDU buffer
+ * @return octet after the PDU, or NULL if not initialized
+ */
+uint8_t *pdubuf_tail(BACNET_PDU_BUFFER const *b)
+{
+    if (b && b->data) {
+        return &b->data[b->head + b->length];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Strip a header from the front of the PDU
+ * @param b - PDU buffer
+ * @param len - number of octets of the header
+ * @return the new first octet of the PDU, or NULL if the PDU is shorter
+ */
+uint8_t *pdubuf_pull(BACNET_PDU_BUFFER *b, uint16_t len)
+{
+    if (!b || !b->data || (len > b->length)) {
+        return NULL;
+    }
+    b->head += len;
+    b->length -= len;
+
+    return &b->data[b->head];
+}
+
+/**
+ * @brief Prepend room for a header in front of the PDU
+ * @param b - PDU buffer
+ * @param len - number of octets of the header
+ * @return the new first octet of the PDU, where the header is to be
+ *  encoded, or NULL if there is not enough headroom
+ */
+uint8_t *pdubuf_push(BACNET_PDU_BUFFER *b, uint16_t len)
+{
+    if (!b || !b->data || (len > b->head)) {
+        return NULL;
+    }
+    b->head -= len;
+    b->length += len;
+
+    return &b->data[b->head];
+}
+
+/**
+ * @brief Append room for data after the PDU
+ * @param b - PDU buffer
+ * @param len - number of octets to append
+ * @return the first appended octet, or NULL if there is not enough tailroom
+ */
+uint8_t *pdubuf_put(BACNET_PDU_BUFFER *b, uint16_t len)
+{
+    uint8_t *tail;
+
+    if (!b || !b->data || (len > pdubuf_tailroom(b))) {
+        return NULL;
+    }
+    tail = &b->data[b->head + b->length];
+    b->length += len;
+
+    return tail;
+}
+
+/**
+ * @brief Shorten the PDU, such as to drop a trailer
+ * @param b - PDU buffer
+ * @param len - new number of octets in the PDU
+ * @return true if the PDU was at least that long
+ */
+bool pdubuf_trim(BACNET_PDU_BUFFER *b, uint16_t len)
+{
+    if (!b || (len > b->length)) {
+        return false;
+    }
+    b->length = len;
+
+    return true;
+}
+
+/**
+ * @brief Add a user of the buffer, such as a queue that holds the PDU
+ *  until it is sent
+ * @param b - PDU buffer
+ * @return true if added, or false if the buffer has no users left or
+ *  already has as many as the counter holds, so that the caller does
+ *  not hold a buffer that the last unref would release
+ */
+bool pdubuf_ref(BACNET_PDU_BUFFER *b)
+{
+    if (!b || (b->refcount == 0) || (b->refcount == UINT8_MAX)) {
+        return false;
+    }
+    b->refcount++;
+
+    return true;
+}
+
+/**
+ * @brief Remove a user of the buffer
+ * @param b - PDU buffer
+ * @return true if that was the last user, and the buffer may be reused
+ */
+bool pdubuf_unref(BACNET_PDU_BUFFER *b)
+{
+    if (!b || (b->refcount == 0)) {
+        return false;
+    }
+    b->refcount--;
+
+    return b->refcount == 0;
+}
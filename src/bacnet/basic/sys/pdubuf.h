@@ -0,0 +1,79 @@
+/**
+ * @file
+ * @brief API for a PDU buffer with headroom and tailroom, so that the
+ *  protocol layers can strip or prepend their headers without copying
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ *
+ * Users so far: the Linux bip_receive_buffer() and bip6_receive_buffer(),
+ * and apps/router-ipv6, which rewrites the NPCI in place.  Not converted
+ * yet, and still copying:
+ *  - bip_receive() and bip6_receive(), which memmove the NPDU to the
+ *    front of the caller's buffer to keep their API;
+ *  - dlmstp_receive() and the other datalinks;
+ *  - routing_npdu_handler() in h_routed_npdu.c;
+ *  - apps/router, which copies each PDU into a message for its ports.
+ * Nothing in the stack shares a buffer yet, so the reference count is
+ * only for an application that queues a received PDU.
+ */
+#ifndef BACNET_SYS_PDUBUF_H
+#define BACNET_SYS_PDUBUF_H
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+
+/* octets reserved in front of a received NPDU, enough for a router
+   to grow the NPCI with SNET, SLEN, and SADR when it forwards */
+#ifndef BACNET_PDU_HEADROOM
+#define BACNET_PDU_HEADROOM 32
+#endif
+
+struct bacnet_pdu_buffer {
+    uint8_t *data; /* block of memory */
+    uint16_t size; /* size, in bytes, of the block of memory */
+    uint16_t head; /* offset of the first octet of the PDU */
+    uint16_t length; /* number of octets in the PDU */
+    uint8_t refcount; /* number of users of the buffer, at most 255 */
+};
+typedef struct bacnet_pdu_buffer BACNET_PDU_BUFFER;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void pdubuf_init(BACNET_PDU_BUFFER *b,
+    uint8_t *data,
+    uint16_t size,
+    uint16_t headroom);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_data(BACNET_PDU_BUFFER const *b);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_length(BACNET_PDU_BUFFER const *b);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_headroom(BACNET_PDU_BUFFER const *b);
+BACNET_STACK_EXPORT
+uint16_t pdubuf_tailroom(BACNET_PDU_BUFFER const *b);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_tail(BACNET_PDU_BUFFER const *b);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_pull(BACNET_PDU_BUFFER *b, uint16_t len);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_push(BACNET_PDU_BUFFER *b, uint16_t len);
+BACNET_STACK_EXPORT
+uint8_t *pdubuf_put(BACNET_PDU_BUFFER *b, uint16_t len);
+BACNET_STACK_EXPORT
+bool pdubuf_trim(BACNET_PDU_BUFFER *b, uint16_t len);
+BACNET_STACK_EXPORT
+void pdubuf_reset(BACNET_PDU_BUFFER *b, uint16_t headroom);
+BACNET_STACK_EXPORT
+bool pdubuf_ref(BACNET_PDU_BUFFER *b);
+BACNET_STACK_EXPORT
+bool pdubuf_unref(BACNET_PDU_BUFFER *b);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -19,6 +19,7 @@
 #include "bacnet/datalink/datalink.h"
 #include "bacnet/basic/services.h"
 #include "bacnet/basic/binding/address.h"
+#include "bacnet/basic/sys/metrics.h"
 
 /** @file tsm.c  BACnet Transaction State Machine operations  */
 /* FIXME: modify basic service handlers to use TSM rather than this buffer! */
@@ -311,6 +312,7 @@ void tsm_timer_milliseconds(uint16_t milliseconds)
                 if (plist->RetryCount < apdu_retries()) {
                     plist->RequestTimer = apdu_timeout();
                     plist->RetryCount++;
+                    BACNET_METRICS_INCREMENT(BACNET_METRIC_TSM_RETRIES);
                     datalink_send_pdu(&plist->dest, &plist->npdu_data,
                         &plist->apdu[0], plist->apdu_len);
                 } else {
@@ -318,6 +320,7 @@ void tsm_timer_milliseconds(uint16_t milliseconds)
                        and this indicates a failed message:
                        IDLE and a valid invoke id */
                     plist->state = TSM_STATE_IDLE;
+                    BACNET_METRICS_INCREMENT(BACNET_METRIC_TSM_TIMEOUTS);
                     if (plist->InvokeID != 0) {
                         if (Timeout_Function) {
                             Timeout_Function(plist->InvokeID);
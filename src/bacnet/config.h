@@ -26,7 +26,7 @@
 #if !(defined(BACDL_ETHERNET) || defined(BACDL_ARCNET) || \
     defined(BACDL_MSTP) || defined(BACDL_BIP) || defined(BACDL_BIP6) || \
     defined(BACDL_TEST) || defined(BACDL_ALL) || defined(BACDL_NONE) || \
-    defined(BACDL_CUSTOM))
+    defined(BACDL_LOOPBACK) || defined(BACDL_CUSTOM))
 #define BACDL_BIP
 #endif
 
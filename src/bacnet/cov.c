@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdint.h>
+#include <string.h>
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
@@ -19,6 +20,8 @@ COV Subscribe
 COV Subscribe Property
 COV Notification
 Unconfirmed COV Notification
+COV Subscribe Property Multiple
+COV Notification Multiple
 */
 
 /**
@@ -835,6 +838,879 @@ int cov_subscribe_property_decode_service_request(
     return len;
 }
 
+/*
+SubscribeCOVPropertyMultiple-Request ::= SEQUENCE {
+    subscriberProcessIdentifier [0] Unsigned32,
+    issueConfirmedNotifications [1] BOOLEAN OPTIONAL,
+    lifetime [2] Unsigned OPTIONAL,
+    maxNotificationDelay [3] Unsigned OPTIONAL,
+    listOfCOVSubscriptionSpecifications [4] SEQUENCE OF SEQUENCE {
+        monitoredObjectIdentifier [0] BACnetObjectIdentifier,
+        listOfCOVReferences [1] SEQUENCE OF SEQUENCE {
+            monitoredProperty [0] BACnetPropertyReference,
+            covIncrement [1] REAL OPTIONAL,
+            timestamped [2] BOOLEAN
+        }
+    }
+}
+*/
+
+/**
+ * @brief Encode the SubscribeCOVPropertyMultiple service request
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param data  Pointer to the data to encode.
+ * @return bytes encoded or zero on error.
+ */
+int cov_subscribe_property_multiple_apdu_encode(
+    uint8_t *apdu, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    BACNET_COV_REFERENCE *reference;
+    unsigned i;
+
+    if (!data) {
+        return 0;
+    }
+    /* tag 0 - subscriberProcessIdentifier */
+    len = encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (!data->cancellationRequest) {
+        /* tag 1 - issueConfirmedNotifications */
+        len =
+            encode_context_boolean(apdu, 1, data->issueConfirmedNotifications);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* tag 2 - lifetime */
+        len = encode_context_unsigned(apdu, 2, data->lifetime);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* tag 3 - maxNotificationDelay */
+        len = encode_context_unsigned(apdu, 3, data->maxNotificationDelay);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    /* tag 4 - listOfCOVSubscriptionSpecifications */
+    len = encode_opening_tag(apdu, 4);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (i = 0; i < data->reference_count; i++) {
+        reference = &data->references[i];
+        if ((i == 0) ||
+            (memcmp(&reference->monitoredObjectIdentifier,
+                 &data->references[i - 1].monitoredObjectIdentifier,
+                 sizeof(BACNET_OBJECT_ID)) != 0)) {
+            /* monitoredObjectIdentifier [0] */
+            len = encode_context_object_id(apdu, 0,
+                reference->monitoredObjectIdentifier.type,
+                reference->monitoredObjectIdentifier.instance);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            /* listOfCOVReferences [1] */
+            len = encode_opening_tag(apdu, 1);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        /* monitoredProperty [0] BACnetPropertyReference */
+        len = encode_opening_tag(apdu, 0);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        len = encode_context_enumerated(
+            apdu, 0, reference->monitoredProperty.propertyIdentifier);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        if (reference->monitoredProperty.propertyArrayIndex !=
+            BACNET_ARRAY_ALL) {
+            len = encode_context_unsigned(
+                apdu, 1, reference->monitoredProperty.propertyArrayIndex);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        len = encode_closing_tag(apdu, 0);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* covIncrement [1] REAL OPTIONAL */
+        if (reference->covIncrementPresent) {
+            len = encode_context_real(apdu, 1, reference->covIncrement);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        /* timestamped [2] BOOLEAN */
+        len = encode_context_boolean(apdu, 2, reference->timestamped);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        if ((i == (data->reference_count - 1)) ||
+            (memcmp(&reference->monitoredObjectIdentifier,
+                 &data->references[i + 1].monitoredObjectIdentifier,
+                 sizeof(BACNET_OBJECT_ID)) != 0)) {
+            len = encode_closing_tag(apdu, 1);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+    }
+    len = encode_closing_tag(apdu, 4);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the SubscribeCOVPropertyMultiple service request
+ * @param apdu  Pointer to the buffer for encoding into
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+size_t cov_subscribe_property_multiple_service_request_encode(
+    uint8_t *apdu, size_t apdu_size, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+
+    apdu_len = cov_subscribe_property_multiple_apdu_encode(NULL, data);
+    if (apdu_len > apdu_size) {
+        apdu_len = 0;
+    } else {
+        apdu_len = cov_subscribe_property_multiple_apdu_encode(apdu, data);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode SubscribeCOVPropertyMultiple request
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size number of bytes available in the buffer
+ * @param invoke_id  Invoke Id.
+ * @param data  Pointer to the data to encode.
+ * @return number of bytes encoded, or zero on error.
+ */
+int cov_subscribe_property_multiple_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+
+    if (!data) {
+        return 0;
+    }
+    if (apdu && (apdu_size > 4)) {
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        apdu[2] = invoke_id;
+        apdu[3] = SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE;
+    }
+    len = 4;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_subscribe_property_multiple_service_request_encode(
+        apdu, apdu_size - apdu_len, data);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode the SubscribeCOVPropertyMultiple service request.
+ *  When the references are NULL, the references are only counted.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the decoded values.
+ * @return Bytes decoded, or BACNET_STATUS_REJECT if the request is
+ *  malformed, or BACNET_STATUS_ABORT if there are more references than
+ *  fit, with the reason in the error code.
+ */
+int cov_subscribe_property_multiple_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data)
+{
+    int len = 0;
+    int apdu_len = 0;
+    int tag_len = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint32_t enumerated_value = 0;
+    BACNET_COV_REFERENCE reference = { 0 };
+    bool issue_present = false;
+    bool lifetime_present = false;
+
+    if (!apdu || !data) {
+        return BACNET_STATUS_REJECT;
+    }
+    data->reference_count = 0;
+    data->error_code = ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER;
+    /* subscriberProcessIdentifier [0] Unsigned32 */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &unsigned_value);
+    if (len <= 0) {
+        return BACNET_STATUS_REJECT;
+    }
+    apdu_len += len;
+    data->subscriberProcessIdentifier = (uint32_t)unsigned_value;
+    /* issueConfirmedNotifications [1] BOOLEAN OPTIONAL */
+    len = bacnet_boolean_context_decode(&apdu[apdu_len], apdu_size - apdu_len,
+        1, &data->issueConfirmedNotifications);
+    if (len > 0) {
+        apdu_len += len;
+        issue_present = true;
+    } else {
+        data->issueConfirmedNotifications = false;
+    }
+    /* lifetime [2] Unsigned OPTIONAL */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 2, &unsigned_value);
+    if (len > 0) {
+        apdu_len += len;
+        data->lifetime = (uint32_t)unsigned_value;
+        lifetime_present = true;
+    } else {
+        data->lifetime = 0;
+    }
+    data->cancellationRequest = !issue_present && !lifetime_present;
+    /* maxNotificationDelay [3] Unsigned OPTIONAL */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 3, &unsigned_value);
+    if (len > 0) {
+        apdu_len += len;
+        data->maxNotificationDelay = (uint32_t)unsigned_value;
+    } else {
+        data->maxNotificationDelay = 0;
+    }
+    /* listOfCOVSubscriptionSpecifications [4] */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 4, &tag_len)) {
+        return BACNET_STATUS_REJECT;
+    }
+    apdu_len += tag_len;
+    data->error_code = ERROR_CODE_REJECT_INVALID_TAG;
+    while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 4, &tag_len)) {
+        /* monitoredObjectIdentifier [0] */
+        len = bacnet_object_id_context_decode(&apdu[apdu_len],
+            apdu_size - apdu_len, 0, &object_type, &object_instance);
+        if (len <= 0) {
+            return BACNET_STATUS_REJECT;
+        }
+        apdu_len += len;
+        reference.monitoredObjectIdentifier.type = object_type;
+        reference.monitoredObjectIdentifier.instance = object_instance;
+        /* listOfCOVReferences [1] */
+        if (!bacnet_is_opening_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &tag_len)) {
+            return BACNET_STATUS_REJECT;
+        }
+        apdu_len += tag_len;
+        while (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &tag_len)) {
+            /* monitoredProperty [0] BACnetPropertyReference */
+            if (!bacnet_is_opening_tag_number(
+                    &apdu[apdu_len], apdu_size - apdu_len, 0, &tag_len)) {
+                return BACNET_STATUS_REJECT;
+            }
+            apdu_len += tag_len;
+            len = bacnet_enumerated_context_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, 0, &enumerated_value);
+            if (len <= 0) {
+                return BACNET_STATUS_REJECT;
+            }
+            apdu_len += len;
+            reference.monitoredProperty.propertyIdentifier =
+                (BACNET_PROPERTY_ID)enumerated_value;
+            len = bacnet_unsigned_context_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &unsigned_value);
+            if (len > 0) {
+                apdu_len += len;
+                reference.monitoredProperty.propertyArrayIndex =
+                    (BACNET_ARRAY_INDEX)unsigned_value;
+            } else {
+                reference.monitoredProperty.propertyArrayIndex =
+                    BACNET_ARRAY_ALL;
+            }
+            if (!bacnet_is_closing_tag_number(
+                    &apdu[apdu_len], apdu_size - apdu_len, 0, &tag_len)) {
+                return BACNET_STATUS_REJECT;
+            }
+            apdu_len += tag_len;
+            /* covIncrement [1] REAL OPTIONAL */
+            len = bacnet_real_context_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, 1, &reference.covIncrement);
+            if (len > 0) {
+                apdu_len += len;
+                reference.covIncrementPresent = true;
+            } else {
+                reference.covIncrementPresent = false;
+                reference.covIncrement = 0.0f;
+            }
+            /* timestamped [2] BOOLEAN */
+            len = bacnet_boolean_context_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, 2, &reference.timestamped);
+            if (len <= 0) {
+                return BACNET_STATUS_REJECT;
+            }
+            apdu_len += len;
+            if (data->references) {
+                if (data->reference_count >= data->reference_size) {
+                    data->error_code = ERROR_CODE_ABORT_OUT_OF_RESOURCES;
+                    return BACNET_STATUS_ABORT;
+                }
+                data->references[data->reference_count] = reference;
+            }
+            data->reference_count++;
+        }
+        apdu_len += tag_len;
+    }
+    apdu_len += tag_len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the Error APDU of a SubscribeCOVPropertyMultiple request
+ *
+ *  SubscribeCOVPropertyMultiple-Error ::= SEQUENCE {
+ *      error-type [0] Error,
+ *      first-failed-subscription [1] SEQUENCE {
+ *          monitoredObjectIdentifier [0] BACnetObjectIdentifier,
+ *          monitoredPropertyReference [1] BACnetPropertyReference,
+ *          errorType [2] Error
+ *      }
+ *  }
+ *
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param invoke_id  Invoke Id of the request
+ * @param data  Pointer to the request data, with the error and the
+ *  index of the first failed reference
+ * @return number of bytes encoded
+ */
+int cov_subscribe_property_multiple_error_encode_apdu(uint8_t *apdu,
+    uint8_t invoke_id,
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data)
+{
+    int len = 0;
+    int apdu_len = 0;
+    BACNET_COV_REFERENCE *reference = NULL;
+
+    if (!data) {
+        return 0;
+    }
+    if (apdu) {
+        apdu[0] = PDU_TYPE_ERROR;
+        apdu[1] = invoke_id;
+        apdu[2] = SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE;
+        apdu += 3;
+    }
+    apdu_len = 3;
+    /* error-type [0] Error */
+    len = encode_opening_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_class);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_code);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 0);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (data->references && (data->failed_index < data->reference_count)) {
+        reference = &data->references[data->failed_index];
+    }
+    if (!reference) {
+        return apdu_len;
+    }
+    /* first-failed-subscription [1] */
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_object_id(apdu, 0,
+        reference->monitoredObjectIdentifier.type,
+        reference->monitoredObjectIdentifier.instance);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_opening_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_context_enumerated(
+        apdu, 0, reference->monitoredProperty.propertyIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    if (reference->monitoredProperty.propertyArrayIndex != BACNET_ARRAY_ALL) {
+        len = encode_context_unsigned(
+            apdu, 1, reference->monitoredProperty.propertyArrayIndex);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_opening_tag(apdu, 2);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_class);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_application_enumerated(apdu, data->error_code);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 2);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = encode_closing_tag(apdu, 1);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/*
+ConfirmedCOVNotificationMultiple-Request ::= SEQUENCE {
+    subscriberProcessIdentifier [0] Unsigned32,
+    initiatingDeviceIdentifier [1] BACnetObjectIdentifier,
+    timeRemaining [2] Unsigned,
+    timestamp [3] BACnetDateTime OPTIONAL,
+    listOfCOVNotifications [4] SEQUENCE OF SEQUENCE {
+        monitoredObjectIdentifier [0] BACnetObjectIdentifier,
+        listOfValues [1] SEQUENCE OF SEQUENCE {
+            propertyIdentifier [0] BACnetPropertyIdentifier,
+            propertyArrayIndex [1] Unsigned OPTIONAL,
+            propertyValue [2] ABSTRACT-SYNTAX.&Type,
+            timeOfChange [3] Time OPTIONAL
+        }
+    }
+}
+UnconfirmedCOVNotificationMultiple-Request is the same.
+*/
+
+/**
+ * @brief Encode the COVNotificationMultiple service request
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param data  Pointer to the data to encode.
+ * @return number of bytes encoded, or zero on error.
+ */
+int cov_notify_multiple_apdu_encode(
+    uint8_t *apdu, BACNET_COV_MULTIPLE_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* total length of the apdu, return value */
+    BACNET_COV_MULTIPLE_VALUE *value;
+    unsigned i;
+
+    if (!data) {
+        return 0;
+    }
+    /* tag 0 - subscriberProcessIdentifier */
+    len = encode_context_unsigned(apdu, 0, data->subscriberProcessIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 1 - initiatingDeviceIdentifier */
+    len = encode_context_object_id(
+        apdu, 1, OBJECT_DEVICE, data->initiatingDeviceIdentifier);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 2 - timeRemaining */
+    len = encode_context_unsigned(apdu, 2, data->timeRemaining);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    /* tag 3 - timestamp */
+    if (data->timestampPresent) {
+        len = bacapp_encode_context_datetime(apdu, 3, &data->timestamp);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+    }
+    /* tag 4 - listOfCOVNotifications */
+    len = encode_opening_tag(apdu, 4);
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    for (i = 0; i < data->value_count; i++) {
+        value = &data->values[i];
+        if ((i == 0) ||
+            (memcmp(&value->monitoredObjectIdentifier,
+                 &data->values[i - 1].monitoredObjectIdentifier,
+                 sizeof(BACNET_OBJECT_ID)) != 0)) {
+            /* monitoredObjectIdentifier [0] */
+            len = encode_context_object_id(apdu, 0,
+                value->monitoredObjectIdentifier.type,
+                value->monitoredObjectIdentifier.instance);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+            /* listOfValues [1] */
+            len = encode_opening_tag(apdu, 1);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        /* propertyIdentifier [0] */
+        len = encode_context_enumerated(apdu, 0, value->propertyIdentifier);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* propertyArrayIndex [1] OPTIONAL */
+        if (value->propertyArrayIndex != BACNET_ARRAY_ALL) {
+            len = encode_context_unsigned(apdu, 1, value->propertyArrayIndex);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        /* propertyValue [2] */
+        len = encode_opening_tag(apdu, 2);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+            if (value->value && value->value_len) {
+                memcpy(apdu, value->value, value->value_len);
+            }
+            apdu += value->value_len;
+        }
+        apdu_len += value->value_len;
+        len = encode_closing_tag(apdu, 2);
+        apdu_len += len;
+        if (apdu) {
+            apdu += len;
+        }
+        /* timeOfChange [3] OPTIONAL */
+        if (value->timeOfChangePresent) {
+            len = encode_context_time(apdu, 3, &value->timeOfChange);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+        if ((i == (data->value_count - 1)) ||
+            (memcmp(&value->monitoredObjectIdentifier,
+                 &data->values[i + 1].monitoredObjectIdentifier,
+                 sizeof(BACNET_OBJECT_ID)) != 0)) {
+            len = encode_closing_tag(apdu, 1);
+            apdu_len += len;
+            if (apdu) {
+                apdu += len;
+            }
+        }
+    }
+    len = encode_closing_tag(apdu, 4);
+    apdu_len += len;
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode the COVNotificationMultiple service request
+ * @param apdu  Pointer to the buffer for encoding into
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+size_t cov_notify_multiple_service_request_encode(
+    uint8_t *apdu, size_t apdu_size, BACNET_COV_MULTIPLE_DATA *data)
+{
+    size_t apdu_len = 0; /* total length of the apdu, return value */
+
+    apdu_len = cov_notify_multiple_apdu_encode(NULL, data);
+    if (apdu_len > apdu_size) {
+        apdu_len = 0;
+    } else {
+        apdu_len = cov_notify_multiple_apdu_encode(apdu, data);
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode APDU for ConfirmedCOVNotificationMultiple
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param invoke_id  ID to invoke for notification
+ * @param data  Pointer to the data to encode.
+ * @return bytes encoded or zero on error.
+ */
+int ccov_notify_multiple_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_COV_MULTIPLE_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu && (apdu_size > 4)) {
+        apdu[0] = PDU_TYPE_CONFIRMED_SERVICE_REQUEST;
+        apdu[1] = encode_max_segs_max_apdu(0, MAX_APDU);
+        apdu[2] = invoke_id;
+        apdu[3] = SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE;
+    }
+    len = 4;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_multiple_service_request_encode(
+        apdu, apdu_size - apdu_len, data);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Encode APDU for UnconfirmedCOVNotificationMultiple
+ * @param apdu  Pointer to the buffer, or NULL for length
+ * @param apdu_size number of bytes available in the buffer
+ * @param data  Pointer to the service data used for encoding values
+ * @return number of bytes encoded, or zero if unable to encode or too large
+ */
+int ucov_notify_multiple_encode_apdu(
+    uint8_t *apdu, unsigned apdu_size, BACNET_COV_MULTIPLE_DATA *data)
+{
+    int len = 0; /* length of each encoding */
+    int apdu_len = 0; /* return value */
+
+    if (apdu && (apdu_size > 2)) {
+        apdu[0] = PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST;
+        apdu[1] = SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE;
+    }
+    len = 2;
+    apdu_len += len;
+    if (apdu) {
+        apdu += len;
+    }
+    len = cov_notify_multiple_service_request_encode(
+        apdu, apdu_size - apdu_len, data);
+    if (len > 0) {
+        apdu_len += len;
+    } else {
+        apdu_len = 0;
+    }
+
+    return apdu_len;
+}
+
+/**
+ * @brief Decode the COVNotificationMultiple service request.  The values
+ *  point into the APDU buffer, so the buffer has to be kept while the
+ *  values are used.  When the values are NULL, they are only counted.
+ * @note Confirmed and unconfirmed COVNotificationMultiple are the same.
+ * @param apdu  Pointer to the buffer.
+ * @param apdu_size  Number of valid bytes in the buffer.
+ * @param data  Pointer to the data to store the decoded values.
+ * @return Bytes decoded or BACNET_STATUS_ERROR on error.
+ */
+int cov_notify_multiple_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_COV_MULTIPLE_DATA *data)
+{
+    int len = 0;
+    int apdu_len = 0;
+    int tag_len = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    uint32_t enumerated_value = 0;
+    BACNET_COV_MULTIPLE_VALUE value = { 0 };
+
+    if (!apdu || !data) {
+        return BACNET_STATUS_ERROR;
+    }
+    data->value_count = 0;
+    /* subscriberProcessIdentifier [0] Unsigned32 */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 0, &unsigned_value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    data->subscriberProcessIdentifier = (uint32_t)unsigned_value;
+    /* initiatingDeviceIdentifier [1] BACnetObjectIdentifier */
+    len = bacnet_object_id_context_decode(&apdu[apdu_len],
+        apdu_size - apdu_len, 1, &object_type, &object_instance);
+    if ((len <= 0) || (object_type != OBJECT_DEVICE)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    data->initiatingDeviceIdentifier = object_instance;
+    /* timeRemaining [2] Unsigned */
+    len = bacnet_unsigned_context_decode(
+        &apdu[apdu_len], apdu_size - apdu_len, 2, &unsigned_value);
+    if (len <= 0) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += len;
+    data->timeRemaining = (uint32_t)unsigned_value;
+    /* timestamp [3] BACnetDateTime OPTIONAL */
+    data->timestampPresent = false;
+    if (bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 3, NULL)) {
+        len = bacnet_datetime_context_decode(
+            &apdu[apdu_len], apdu_size - apdu_len, 3, &data->timestamp);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        data->timestampPresent = true;
+    }
+    /* listOfCOVNotifications [4] */
+    if (!bacnet_is_opening_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 4, &tag_len)) {
+        return BACNET_STATUS_ERROR;
+    }
+    apdu_len += tag_len;
+    while (!bacnet_is_closing_tag_number(
+        &apdu[apdu_len], apdu_size - apdu_len, 4, &tag_len)) {
+        /* monitoredObjectIdentifier [0] */
+        len = bacnet_object_id_context_decode(&apdu[apdu_len],
+            apdu_size - apdu_len, 0, &object_type, &object_instance);
+        if (len <= 0) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += len;
+        value.monitoredObjectIdentifier.type = object_type;
+        value.monitoredObjectIdentifier.instance = object_instance;
+        /* listOfValues [1] */
+        if (!bacnet_is_opening_tag_number(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &tag_len)) {
+            return BACNET_STATUS_ERROR;
+        }
+        apdu_len += tag_len;
+        while (!bacnet_is_closing_tag_number(
+            &apdu[apdu_len], apdu_size - apdu_len, 1, &tag_len)) {
+            /* propertyIdentifier [0] */
+            len = bacnet_enumerated_context_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, 0, &enumerated_value);
+            if (len <= 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu_len += len;
+            value.propertyIdentifier = (BACNET_PROPERTY_ID)enumerated_value;
+            /* propertyArrayIndex [1] OPTIONAL */
+            len = bacnet_unsigned_context_decode(
+                &apdu[apdu_len], apdu_size - apdu_len, 1, &unsigned_value);
+            if (len > 0) {
+                apdu_len += len;
+                value.propertyArrayIndex = (BACNET_ARRAY_INDEX)unsigned_value;
+            } else {
+                value.propertyArrayIndex = BACNET_ARRAY_ALL;
+            }
+            /* propertyValue [2] */
+            if (!bacnet_is_opening_tag_number(
+                    &apdu[apdu_len], apdu_size - apdu_len, 2, &tag_len)) {
+                return BACNET_STATUS_ERROR;
+            }
+            len = bacnet_enclosed_data_length(
+                &apdu[apdu_len], apdu_size - apdu_len);
+            if (len < 0) {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu_len += tag_len;
+            value.value = &apdu[apdu_len];
+            value.value_len = (unsigned)len;
+            apdu_len += len;
+            if (!bacnet_is_closing_tag_number(
+                    &apdu[apdu_len], apdu_size - apdu_len, 2, &tag_len)) {
+                return BACNET_STATUS_ERROR;
+            }
+            apdu_len += tag_len;
+            /* timeOfChange [3] Time OPTIONAL */
+            len = bacnet_time_context_decode(&apdu[apdu_len],
+                apdu_size - apdu_len, 3, &value.timeOfChange);
+            if (len > 0) {
+                apdu_len += len;
+                value.timeOfChangePresent = true;
+            } else {
+                value.timeOfChangePresent = false;
+            }
+            if (data->values) {
+                if (data->value_count >= data->value_size) {
+                    return BACNET_STATUS_ERROR;
+                }
+                data->values[data->value_count] = value;
+            }
+            data->value_count++;
+        }
+        apdu_len += tag_len;
+    }
+    apdu_len += tag_len;
+
+    return apdu_len;
+}
+
 /**
  * @brief Link an array or buffer of BACNET_PROPERTY_VALUE elements
  * @param value_list - One or more BACNET_PROPERTY_VALUE elements in
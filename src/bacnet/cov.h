@@ -40,6 +40,56 @@ typedef struct BACnet_Subscribe_COV_Data {
     struct BACnet_Subscribe_COV_Data *next;
 } BACNET_SUBSCRIBE_COV_DATA;
 
+/* one monitored property of a SubscribeCOVPropertyMultiple request */
+typedef struct BACnet_COV_Reference {
+    BACNET_OBJECT_ID monitoredObjectIdentifier;
+    BACNET_PROPERTY_REFERENCE monitoredProperty;
+    bool covIncrementPresent; /* true if present */
+    float covIncrement; /* optional */
+    bool timestamped;
+} BACNET_COV_REFERENCE;
+
+typedef struct BACnet_Subscribe_COV_Multiple_Data {
+    uint32_t subscriberProcessIdentifier;
+    bool cancellationRequest; /* true if this is a cancellation request */
+    bool issueConfirmedNotifications; /* optional */
+    uint32_t lifetime; /* seconds, optional */
+    uint32_t maxNotificationDelay; /* seconds, optional */
+    /* listOfCOVSubscriptionSpecifications, where the references
+       of the same object are next to each other */
+    BACNET_COV_REFERENCE *references;
+    unsigned reference_count; /* number of references used */
+    unsigned reference_size; /* number of references that may be decoded */
+    unsigned failed_index; /* the first failed subscription */
+    BACNET_ERROR_CLASS error_class;
+    BACNET_ERROR_CODE error_code;
+} BACNET_SUBSCRIBE_COV_MULTIPLE_DATA;
+
+/* one value of a COVNotificationMultiple */
+typedef struct BACnet_COV_Multiple_Value {
+    BACNET_OBJECT_ID monitoredObjectIdentifier;
+    BACNET_PROPERTY_ID propertyIdentifier;
+    BACNET_ARRAY_INDEX propertyArrayIndex;
+    /* the encoded application data of the property value */
+    uint8_t *value;
+    unsigned value_len;
+    bool timeOfChangePresent;
+    BACNET_TIME timeOfChange; /* optional */
+} BACNET_COV_MULTIPLE_VALUE;
+
+typedef struct BACnet_COV_Multiple_Data {
+    uint32_t subscriberProcessIdentifier;
+    uint32_t initiatingDeviceIdentifier;
+    uint32_t timeRemaining; /* seconds */
+    bool timestampPresent;
+    BACNET_DATE_TIME timestamp; /* optional */
+    /* listOfCOVNotifications, where the values
+       of the same object are next to each other */
+    BACNET_COV_MULTIPLE_VALUE *values;
+    unsigned value_count; /* number of values used */
+    unsigned value_size; /* number of values that may be decoded */
+} BACNET_COV_MULTIPLE_DATA;
+
 /* generic callback for COV notifications */
 typedef void (*BACnet_COV_Notification_Callback)(BACNET_COV_DATA *cov_data);
 struct BACnet_COV_Notification;
@@ -128,6 +178,51 @@ int cov_subscribe_encode_apdu(uint8_t *apdu,
     uint8_t invoke_id,
     BACNET_SUBSCRIBE_COV_DATA *data);
 
+BACNET_STACK_EXPORT
+int cov_subscribe_property_multiple_apdu_encode(
+    uint8_t *apdu, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+size_t cov_subscribe_property_multiple_service_request_encode(
+    uint8_t *apdu, size_t apdu_size, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int cov_subscribe_property_multiple_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int cov_subscribe_property_multiple_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int cov_subscribe_property_multiple_error_encode_apdu(uint8_t *apdu,
+    uint8_t invoke_id,
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int cov_notify_multiple_apdu_encode(
+    uint8_t *apdu, BACNET_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+size_t cov_notify_multiple_service_request_encode(
+    uint8_t *apdu, size_t apdu_size, BACNET_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int ccov_notify_multiple_encode_apdu(uint8_t *apdu,
+    unsigned apdu_size,
+    uint8_t invoke_id,
+    BACNET_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int ucov_notify_multiple_encode_apdu(
+    uint8_t *apdu, unsigned apdu_size, BACNET_COV_MULTIPLE_DATA *data);
+
+BACNET_STACK_EXPORT
+int cov_notify_multiple_decode_service_request(
+    uint8_t *apdu, unsigned apdu_size, BACNET_COV_MULTIPLE_DATA *data);
+
 BACNET_STACK_EXPORT
 void cov_property_value_list_link(
     BACNET_PROPERTY_VALUE *value_list,
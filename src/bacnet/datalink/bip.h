@@ -17,6 +17,7 @@
 /* BACnet Stack API */
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/bvlc.h"
+#include "bacnet/basic/sys/pdubuf.h"
 
 /* specific defines for BACnet/IP over Ethernet */
 #define BIP_HEADER_MAX (1 + 1 + 2)
@@ -63,6 +64,10 @@ extern "C" {
         uint8_t *pdu,
         uint16_t max_pdu,
         unsigned timeout);
+    BACNET_STACK_EXPORT
+    uint16_t bip_receive_buffer(BACNET_ADDRESS *src,
+        BACNET_PDU_BUFFER *pdu,
+        unsigned timeout);
 
     /* use host byte order for setting UDP port */
     BACNET_STACK_EXPORT
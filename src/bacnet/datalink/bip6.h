@@ -22,6 +22,7 @@
 /* BACnet Stack API */
 #include "bacnet/npdu.h"
 #include "bacnet/datalink/bvlc6.h"
+#include "bacnet/basic/sys/pdubuf.h"
 
 /* specific defines for BACnet/IP over Ethernet */
 #define BIP6_HEADER_MAX (1 + 1 + 2)
@@ -58,6 +59,11 @@ extern "C" {
         uint8_t * pdu,
         uint16_t max_pdu,
         unsigned timeout);
+    BACNET_STACK_EXPORT
+    uint16_t bip6_receive_buffer(
+        BACNET_ADDRESS * src,
+        BACNET_PDU_BUFFER * pdu,
+        unsigned timeout);
 
     /* functions that are custom per port */
     BACNET_STACK_EXPORT
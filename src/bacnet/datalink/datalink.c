@@ -19,6 +19,7 @@
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
 #include "bacnet/datalink/arcnet.h"
 #include "bacnet/datalink/dlmstp.h"
+#include "bacnet/datalink/loopback.h"
 #include <strings.h> /* for strcasecmp() */
 
 static enum {
@@ -27,7 +28,8 @@ static enum {
     DATALINK_ETHERNET,
     DATALINK_BIP,
     DATALINK_BIP6,
-    DATALINK_MSTP
+    DATALINK_MSTP,
+    DATALINK_LOOPBACK
 } Datalink_Transport;
 
 void datalink_set(char *datalink_string)
@@ -42,6 +44,8 @@ void datalink_set(char *datalink_string)
         Datalink_Transport = DATALINK_ARCNET;
     } else if (strcasecmp("mstp", datalink_string) == 0) {
         Datalink_Transport = DATALINK_MSTP;
+    } else if (strcasecmp("loopback", datalink_string) == 0) {
+        Datalink_Transport = DATALINK_LOOPBACK;
     } else if (strcasecmp("none", datalink_string) == 0) {
         Datalink_Transport = DATALINK_NONE;
     }
@@ -70,6 +74,9 @@ bool datalink_init(char *ifname)
         case DATALINK_MSTP:
             status = dlmstp_init(ifname);
             break;
+        case DATALINK_LOOPBACK:
+            status = loopback_init(ifname);
+            break;
         default:
             break;
     }
@@ -103,6 +110,9 @@ int datalink_send_pdu(BACNET_ADDRESS *dest,
         case DATALINK_MSTP:
             bytes = dlmstp_send_pdu(dest, npdu_data, pdu, pdu_len);
             break;
+        case DATALINK_LOOPBACK:
+            bytes = loopback_send_pdu(dest, npdu_data, pdu, pdu_len);
+            break;
         default:
             break;
     }
@@ -133,6 +143,9 @@ uint16_t datalink_receive(
         case DATALINK_MSTP:
             bytes = dlmstp_receive(src, pdu, max_pdu, timeout);
             break;
+        case DATALINK_LOOPBACK:
+            bytes = loopback_receive(src, pdu, max_pdu, timeout);
+            break;
         default:
             break;
     }
@@ -160,6 +173,9 @@ void datalink_cleanup(void)
         case DATALINK_MSTP:
             dlmstp_cleanup();
             break;
+        case DATALINK_LOOPBACK:
+            loopback_cleanup();
+            break;
         default:
             break;
     }
@@ -185,6 +201,9 @@ void datalink_get_broadcast_address(BACNET_ADDRESS *dest)
         case DATALINK_MSTP:
             dlmstp_get_broadcast_address(dest);
             break;
+        case DATALINK_LOOPBACK:
+            loopback_get_broadcast_address(dest);
+            break;
         default:
             break;
     }
@@ -210,6 +229,9 @@ void datalink_get_my_address(BACNET_ADDRESS *my_address)
         case DATALINK_MSTP:
             dlmstp_get_my_address(my_address);
             break;
+        case DATALINK_LOOPBACK:
+            loopback_get_my_address(my_address);
+            break;
         default:
             break;
     }
@@ -236,6 +258,9 @@ void datalink_set_interface(char *ifname)
         case DATALINK_MSTP:
             (void)ifname;
             break;
+        case DATALINK_LOOPBACK:
+            (void)ifname;
+            break;
         default:
             break;
     }
@@ -258,6 +283,8 @@ void datalink_maintenance_timer(uint16_t seconds)
             break;
         case DATALINK_MSTP:
             break;
+        case DATALINK_LOOPBACK:
+            break;
         default:
             break;
     }
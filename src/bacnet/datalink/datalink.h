@@ -89,6 +89,18 @@ void routed_get_my_address(
 #define datalink_get_my_address bip6_get_my_address
 #define datalink_maintenance_timer(s) bvlc6_maintenance_timer(s)
 
+#elif defined(BACDL_LOOPBACK)
+#include "bacnet/datalink/loopback.h"
+#define MAX_MPDU LOOPBACK_MPDU_MAX
+
+#define datalink_init loopback_init
+#define datalink_send_pdu loopback_send_pdu
+#define datalink_receive loopback_receive
+#define datalink_cleanup loopback_cleanup
+#define datalink_get_broadcast_address loopback_get_broadcast_address
+#define datalink_get_my_address loopback_get_my_address
+#define datalink_maintenance_timer(s)
+
 #elif defined(BACDL_ALL) || defined(BACDL_NONE) || defined(BACDL_CUSTOM)
 #include "bacnet/npdu.h"
 
@@ -161,6 +173,8 @@ extern "C" {
  * - BACDL_MSTP     -- for Clause 9 MASTER-SLAVE/TOKEN PASSING (MS/TP) LAN
  * - BACDL_BIP      -- for ANNEX J - BACnet/IPv4
  * - BACDL_BIP6     -- for ANNEX U - BACnet/IPv6
+ * - BACDL_LOOPBACK -- for an in-process simulated network, used for
+ *                     testing and load testing without real sockets
  * - BACDL_ALL      -- Unspecified for the build, so the transport can be
  *                     chosen at runtime from among these choices.
  * - BACDL_NONE      -- Unspecified for the build for unit testing
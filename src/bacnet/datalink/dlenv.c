@@ -97,10 +97,19 @@ void dlenv_bbmd_ttl_set(uint16_t ttl_secs)
  */
 int dlenv_bbmd_result(void)
 {
+#if BBMD_ENABLED
+    BVLC_REMOTE_BBMD_STATUS status = { 0 };
+
+    if ((BBMD_Result > 0) && bvlc_remote_bbmd_status(0, &status) &&
+        (status.result_code == BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK)) {
+        return -1;
+    }
+#else
     if ((BBMD_Result > 0) &&
         (bvlc_get_last_result() == BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK)) {
         return -1;
     }
+#endif
     /* Else, show our send: */
     return BBMD_Result;
 }
@@ -117,6 +126,11 @@ int dlenv_bbmd_result(void)
  *     - BACNET_BBMD_PORT - 0..65534, defaults to 47808
  *     - BACNET_BBMD_TIMETOLIVE - 0..65535 seconds, defaults to 60000
  *     - BACNET_BBMD_ADDRESS - dotted IPv4 address
+ *     - BACNET_BBMD_ADDRESS_2 - dotted IPv4 address of a backup BBMD,
+ *       up to BACNET_BBMD_ADDRESS_4
+ *     - BACNET_BBMD_PORT_2 - 0..65534, defaults to BACNET_BBMD_PORT
+ *     - BACNET_BBMD_REFRESH - seconds between registrations, defaults
+ *       to BVLC_REMOTE_BBMD_REFRESH_SECONDS, 0 for half of the time-to-live
  * @return Positive number (of bytes sent) on success,
  *         0 if no registration request is sent, or
  *         -1 if registration fails.
@@ -132,6 +146,7 @@ static int bbmd_register_as_foreign_device(void)
     unsigned entry_number = 0;
     long long_value = 0;
     int c;
+    BACNET_IP_ADDRESS backup_address = { 0 };
 
     pEnv = getenv("BACNET_BBMD_PORT");
     if (pEnv) {
@@ -155,6 +170,13 @@ static int bbmd_register_as_foreign_device(void)
     if (pEnv) {
         BBMD_Address_Valid = bip_get_addr_by_name(pEnv, &BBMD_Address);
     }
+    pEnv = getenv("BACNET_BBMD_REFRESH");
+    if (pEnv) {
+        long_value = strtol(pEnv, NULL, 0);
+        if ((long_value >= 0) && (long_value <= 0xFFFF)) {
+            bvlc_remote_bbmd_refresh_set((uint16_t)long_value);
+        }
+    }
     if (BBMD_Address_Valid) {
         if (BIP_DL_Debug) {
             fprintf(stderr,
@@ -165,7 +187,8 @@ static int bbmd_register_as_foreign_device(void)
                 (unsigned)BBMD_Address.address[3], (unsigned)BBMD_Address.port,
                 (unsigned)BBMD_TTL_Seconds);
         }
-        retval = bvlc_register_with_bbmd(&BBMD_Address, BBMD_TTL_Seconds);
+        bvlc_remote_bbmd_clear();
+        retval = bvlc_remote_bbmd_add(&BBMD_Address, BBMD_TTL_Seconds);
         if (retval < 0) {
             fprintf(stderr, "FAILED to Register with BBMD at %u.%u.%u.%u:%u\n",
                 (unsigned)BBMD_Address.address[0],
@@ -173,7 +196,37 @@ static int bbmd_register_as_foreign_device(void)
                 (unsigned)BBMD_Address.address[2],
                 (unsigned)BBMD_Address.address[3], (unsigned)BBMD_Address.port);
         }
-        BBMD_Timer_Seconds = BBMD_TTL_Seconds;
+        /* backup BBMDs, registered at the same time as the primary */
+        for (entry_number = 2; entry_number <= BVLC_REMOTE_BBMD_MAX;
+             entry_number++) {
+            snprintf(bbmd_env, sizeof(bbmd_env), "BACNET_BBMD_ADDRESS_%u",
+                entry_number);
+            pEnv = getenv(bbmd_env);
+            if (!pEnv || !bip_get_addr_by_name(pEnv, &backup_address)) {
+                continue;
+            }
+            backup_address.port = BBMD_Address.port;
+            snprintf(bbmd_env, sizeof(bbmd_env), "BACNET_BBMD_PORT_%u",
+                entry_number);
+            pEnv = getenv(bbmd_env);
+            if (pEnv) {
+                long_value = strtol(pEnv, NULL, 0);
+                if ((long_value > 0) && (long_value <= 0xFFFF)) {
+                    backup_address.port = (uint16_t)long_value;
+                }
+            }
+            if (BIP_DL_Debug) {
+                fprintf(stderr,
+                    "Registering with backup BBMD at %u.%u.%u.%u:%u\n",
+                    (unsigned)backup_address.address[0],
+                    (unsigned)backup_address.address[1],
+                    (unsigned)backup_address.address[2],
+                    (unsigned)backup_address.address[3],
+                    (unsigned)backup_address.port);
+            }
+            (void)bvlc_remote_bbmd_add(
+                &backup_address, BBMD_TTL_Seconds);
+        }
     } else {
         for (entry_number = 1; entry_number <= 128; entry_number++) {
             bdt_entry_valid = false;
@@ -470,6 +523,20 @@ void dlenv_network_port_init(void)
  */
 void dlenv_maintenance_timer(uint16_t elapsed_seconds)
 {
+#if defined(BACDL_BIP) && BBMD_ENABLED
+    uint16_t seconds = elapsed_seconds;
+
+    /* the BBMD client renews its own registrations */
+    while (seconds > 0) {
+        if (seconds > 60) {
+            bvlc_remote_bbmd_timer(60000U);
+            seconds -= 60;
+        } else {
+            bvlc_remote_bbmd_timer(seconds * 1000U);
+            seconds = 0;
+        }
+    }
+#endif
 #if defined(BACDL_BIP) || defined(BACDL_BIP6)
     if (BBMD_Timer_Seconds) {
         if (BBMD_Timer_Seconds <= elapsed_seconds) {
@@ -525,6 +592,13 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  *       Registration (0..65535). Defaults to 60000 seconds.
  *   - BACNET_BBMD_ADDRESS - dotted IPv4 address of the BBMD or Foreign
  *       Device Registrar.
+ *   - BACNET_BBMD_ADDRESS_2 - dotted IPv4 address of a backup BBMD, up to
+ *       BACNET_BBMD_ADDRESS_4, registered at the same time as the primary.
+ *   - BACNET_BBMD_PORT_2 - UDP/IP port number of a backup BBMD.
+ *       Defaults to BACNET_BBMD_PORT.
+ *   - BACNET_BBMD_REFRESH - number of seconds between registrations.
+ *       Defaults to BVLC_REMOTE_BBMD_REFRESH_SECONDS (60 seconds), or 0
+ *       to renew at half of BACNET_BBMD_TIMETOLIVE.
  *   - BACNET_BDT_ADDR_1 - dotted IPv4 address of the BBMD table entry 1..128
  *   - BACNET_BDT_PORT_1 - UDP port of the BBMD table entry 1..128 (optional)
  *   - BACNET_BDT_MASK_1 - dotted IPv4 mask of the BBMD table
@@ -540,6 +614,12 @@ void dlenv_maintenance_timer(uint16_t elapsed_seconds)
  *   - BACNET_BIP6_PORT - UDP/IP port number (0..65534) used for BACnet/IPv6
  *     communications.  Default is 47808 (0xBAC0).
  *   - BACNET_BIP6_BROADCAST - FF05::BAC0 or FF02::BAC0 or ...
+ * - BACDL_LOOPBACK: (in-process simulated network)
+ *   - BACNET_IFACE - decimal MAC address (port number) of this device
+ *   - BACNET_LOOPBACK_LATENCY - milliseconds from send until receive
+ *   - BACNET_LOOPBACK_LOSS - frames lost, in parts per million
+ *   - BACNET_LOOPBACK_MTU - largest frame that can be sent
+ *   - BACNET_LOOPBACK_SEED - seed of the frame loss random sequence
  */
 void dlenv_init(void)
 {
@@ -639,6 +719,23 @@ void dlenv_init(void)
     } else {
         dlmstp_set_mac_address(127);
     }
+#elif defined(BACDL_LOOPBACK)
+    pEnv = getenv("BACNET_LOOPBACK_LATENCY");
+    if (pEnv) {
+        loopback_latency_set(strtoul(pEnv, NULL, 0));
+    }
+    pEnv = getenv("BACNET_LOOPBACK_LOSS");
+    if (pEnv) {
+        loopback_loss_set(strtoul(pEnv, NULL, 0));
+    }
+    pEnv = getenv("BACNET_LOOPBACK_MTU");
+    if (pEnv) {
+        loopback_mtu_set((uint16_t)strtoul(pEnv, NULL, 0));
+    }
+    pEnv = getenv("BACNET_LOOPBACK_SEED");
+    if (pEnv) {
+        loopback_seed_set(strtoul(pEnv, NULL, 0));
+    }
 #endif
     pEnv = getenv("BACNET_APDU_TIMEOUT");
     if (pEnv) {
@@ -16,6 +16,7 @@
 /* BACnet Stack API */
 #include "bacnet/basic/sys/ringbuf.h"
 #include "bacnet/basic/sys/mstimer.h"
+#include "bacnet/basic/sys/metrics.h"
 #include "bacnet/datalink/crc.h"
 #include "bacnet/datalink/mstp.h"
 #include "bacnet/datalink/dlmstp.h"
@@ -75,6 +76,11 @@ int dlmstp_send_pdu(BACNET_ADDRESS *dest,
             bytes_sent = pdu_len;
         }
     }
+    if (bytes_sent > 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+    }
 
     return bytes_sent;
 }
@@ -406,13 +412,16 @@ uint16_t dlmstp_receive(
     if (user->ReceivePacketPending) {
         user->ReceivePacketPending = false;
         user->Statistics.receive_pdu_counter++;
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
         pdu_len = MSTP_Port->DataLength;
         if (pdu_len > max_pdu) {
             /* PDU is too large */
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
             return 0;
         }
         if (!pdu) {
             /* no place to put a PDU */
+            BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX_DROPPED);
             return 0;
         }
         /* copy input buffer to PDU */
@@ -22,6 +22,15 @@
 #define ETHERNET_HEADER_MAX (6+6+2+1+1+1)
 #define ETHERNET_MPDU_MAX (ETHERNET_HEADER_MAX+MAX_PDU)
 
+/**
+ * @brief Handles one received PDU, such as npdu_handler()
+ * @param src - source address of the PDU
+ * @param pdu - PDU data, which is only valid during the call
+ * @param pdu_len - number of octets of PDU data
+ */
+typedef void (*ethernet_pdu_handler)(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t pdu_len);
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -73,6 +82,14 @@ extern "C" {
     int ethernet_send(
         uint8_t * mtu,
         int mtu_len);
+#if defined(BACDL_ETHERNET_RECEIVE_PDUS)
+/* passes each received PDU to the handler without copying it.
+   Only ports that define BACDL_ETHERNET_RECEIVE_PDUS implement it. */
+    BACNET_STACK_EXPORT
+    unsigned ethernet_receive_pdus(
+        ethernet_pdu_handler handler,
+        unsigned timeout);      /* milliseconds to wait for a packet */
+#endif
 
 #ifdef __cplusplus
 }
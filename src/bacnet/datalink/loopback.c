@@ -0,0 +1,611 @@
+/**
+ * @file
+ * @brief BACnet in-process loopback datalink
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The loopback datalink is a simulated network of ports inside one
+ * process.  The device uses one port through the datalink API, and a test
+ * or load generator can attach many more ports to act as clients, servers
+ * or routers.  Frames are copied into the receive queue of the destination
+ * port (or of every other port for a broadcast) without any system calls.
+ *
+ * The network conditions are configurable: a fixed latency, a frame loss
+ * rate, and an MTU.  Latency is measured with a clock that only moves
+ * when a receive waits or the clock is advanced, and the loss uses a
+ * seeded pseudo random sequence, so that a run is repeatable.  A receive
+ * that waits also sleeps for that time, unless simulated time is enabled
+ * with loopback_simulated_time_set(), which tests and load generators use
+ * to run without any delay.
+ *
+ * The loopback network is not thread safe; use it from one thread.
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <time.h>
+#endif
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/datalink/loopback.h"
+#include "bacnet/basic/sys/metrics.h"
+
+struct loopback_frame {
+    uint16_t src;
+    uint16_t pdu_len;
+    uint32_t deliver_time;
+    uint8_t pdu[LOOPBACK_MPDU_MAX];
+};
+
+struct loopback_port {
+    unsigned head;
+    unsigned count;
+    struct loopback_frame frame[LOOPBACK_QUEUE_DEPTH];
+};
+
+static struct loopback_port *Loopback_Port[LOOPBACK_PORTS_MAX];
+static unsigned Loopback_Port_Count;
+/* the port used by the datalink API */
+static uint16_t Loopback_My_MAC = LOOPBACK_BROADCAST_MAC;
+/* network conditions */
+static uint32_t Loopback_Latency;
+static uint32_t Loopback_Loss;
+static uint16_t Loopback_MTU = LOOPBACK_MPDU_MAX;
+static uint32_t Loopback_Seed = 1;
+/* loopback network time, in milliseconds */
+static uint32_t Loopback_Time;
+/* true if a receive that waits does not sleep */
+static bool Loopback_Simulated_Time;
+static LOOPBACK_STATISTICS Loopback_Stats;
+
+/**
+ * @brief Get the next value of the pseudo random sequence (xorshift32)
+ * @return pseudo random value
+ */
+static uint32_t loopback_random(void)
+{
+    uint32_t x = Loopback_Seed;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    Loopback_Seed = x;
+
+    return x;
+}
+
+/**
+ * @brief Move the time of the loopback network forward while a receive
+ *  waits, and sleep for that time unless the time is simulated.
+ * @param milliseconds - number of milliseconds to wait
+ */
+static void loopback_wait(uint32_t milliseconds)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    struct timespec wait_time;
+#endif
+
+    Loopback_Time += milliseconds;
+    if (Loopback_Simulated_Time || (milliseconds == 0)) {
+        return;
+    }
+#if defined(_WIN32)
+    Sleep(milliseconds);
+#elif defined(__unix__) || defined(__APPLE__)
+    wait_time.tv_sec = milliseconds / 1000;
+    wait_time.tv_nsec = (long)(milliseconds % 1000) * 1000000L;
+    (void)nanosleep(&wait_time, NULL);
+#endif
+}
+
+/**
+ * @brief Find a port on the loopback network
+ * @param mac - port MAC address
+ * @return port, or NULL if not found
+ */
+static struct loopback_port *loopback_port(uint16_t mac)
+{
+    if (mac < LOOPBACK_PORTS_MAX) {
+        return Loopback_Port[mac];
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Convert a BACnet address into a loopback MAC address
+ * @param addr - BACnet address
+ * @return MAC address, or LOOPBACK_BROADCAST_MAC for a broadcast
+ */
+static uint16_t loopback_address_to_mac(BACNET_ADDRESS *addr)
+{
+    if (!addr || (addr->mac_len != LOOPBACK_MAC_LEN)) {
+        return LOOPBACK_BROADCAST_MAC;
+    }
+
+    return ((uint16_t)addr->mac[0] << 8) | addr->mac[1];
+}
+
+/**
+ * @brief Convert a loopback MAC address into a local BACnet address
+ * @param mac - MAC address
+ * @param addr - BACnet address to fill in
+ */
+void loopback_mac_to_address(uint16_t mac, BACNET_ADDRESS *addr)
+{
+    unsigned i;
+
+    if (addr) {
+        addr->mac_len = LOOPBACK_MAC_LEN;
+        addr->mac[0] = (uint8_t)(mac >> 8);
+        addr->mac[1] = (uint8_t)mac;
+        for (i = LOOPBACK_MAC_LEN; i < MAX_MAC_LEN; i++) {
+            addr->mac[i] = 0;
+        }
+        addr->net = 0;
+        addr->len = 0;
+        for (i = 0; i < MAX_MAC_LEN; i++) {
+            addr->adr[i] = 0;
+        }
+    }
+}
+
+/**
+ * @brief Attach a port to the loopback network
+ * @param mac - MAC address of the port, 0..LOOPBACK_PORTS_MAX-1
+ * @return true if the port was created or already exists
+ */
+bool loopback_port_create(uint16_t mac)
+{
+    struct loopback_port *port;
+
+    if (mac >= LOOPBACK_PORTS_MAX) {
+        return false;
+    }
+    if (Loopback_Port[mac]) {
+        return true;
+    }
+    port = calloc(1, sizeof(struct loopback_port));
+    if (!port) {
+        return false;
+    }
+    Loopback_Port[mac] = port;
+    Loopback_Port_Count++;
+
+    return true;
+}
+
+/**
+ * @brief Detach a port from the loopback network, discarding its queue
+ * @param mac - MAC address of the port
+ */
+void loopback_port_delete(uint16_t mac)
+{
+    struct loopback_port *port;
+
+    port = loopback_port(mac);
+    if (port) {
+        free(port);
+        Loopback_Port[mac] = NULL;
+        Loopback_Port_Count--;
+    }
+}
+
+/**
+ * @brief Determine if a port is attached to the loopback network
+ * @param mac - MAC address of the port
+ * @return true if the port exists
+ */
+bool loopback_port_valid(uint16_t mac)
+{
+    return (loopback_port(mac) != NULL);
+}
+
+/**
+ * @brief Get the number of ports attached to the loopback network
+ * @return number of ports
+ */
+unsigned loopback_port_count(void)
+{
+    return Loopback_Port_Count;
+}
+
+/**
+ * @brief Get the number of frames waiting in a port receive queue,
+ *  including frames that are not yet deliverable due to latency.
+ * @param mac - MAC address of the port
+ * @return number of frames waiting
+ */
+unsigned loopback_port_pending(uint16_t mac)
+{
+    struct loopback_port *port;
+
+    port = loopback_port(mac);
+    if (port) {
+        return port->count;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Queue a copy of a frame for one receiving port
+ * @param port - receiving port
+ * @param src - MAC address of the sending port
+ * @param pdu - frame data
+ * @param pdu_len - number of bytes of frame data
+ */
+static void loopback_port_enqueue(
+    struct loopback_port *port, uint16_t src, uint8_t *pdu, unsigned pdu_len)
+{
+    struct loopback_frame *frame;
+
+    if (Loopback_Loss && ((loopback_random() % 1000000UL) < Loopback_Loss)) {
+        Loopback_Stats.dropped_loss++;
+        return;
+    }
+    if (port->count >= LOOPBACK_QUEUE_DEPTH) {
+        Loopback_Stats.dropped_overflow++;
+        return;
+    }
+    frame =
+        &port->frame[(port->head + port->count) % LOOPBACK_QUEUE_DEPTH];
+    frame->src = src;
+    frame->pdu_len = (uint16_t)pdu_len;
+    frame->deliver_time = Loopback_Time + Loopback_Latency;
+    memcpy(frame->pdu, pdu, pdu_len);
+    port->count++;
+}
+
+/**
+ * @brief Send a frame from a port on the loopback network
+ * @param mac - MAC address of the sending port
+ * @param dest - destination address; a MAC length other than
+ *  LOOPBACK_MAC_LEN or the broadcast MAC sends to every other port
+ * @param pdu - any data to be sent - may be null
+ * @param pdu_len - number of bytes of data
+ * @return number of bytes sent, or -1 on error
+ */
+int loopback_port_send(
+    uint16_t mac, BACNET_ADDRESS *dest, uint8_t *pdu, unsigned pdu_len)
+{
+    struct loopback_port *port;
+    uint16_t dest_mac;
+    unsigned i;
+
+    if (!loopback_port(mac) || (!pdu && pdu_len)) {
+        return -1;
+    }
+    if ((pdu_len > Loopback_MTU) || (pdu_len > LOOPBACK_MPDU_MAX)) {
+        Loopback_Stats.dropped_mtu++;
+        return -1;
+    }
+    Loopback_Stats.transmitted++;
+    dest_mac = loopback_address_to_mac(dest);
+    if (dest_mac == LOOPBACK_BROADCAST_MAC) {
+        for (i = 0; i < LOOPBACK_PORTS_MAX; i++) {
+            port = Loopback_Port[i];
+            if (port && (i != mac)) {
+                loopback_port_enqueue(port, mac, pdu, pdu_len);
+            }
+        }
+    } else {
+        port = loopback_port(dest_mac);
+        if (port) {
+            loopback_port_enqueue(port, mac, pdu, pdu_len);
+        } else {
+            Loopback_Stats.dropped_unknown++;
+        }
+    }
+
+    return (int)pdu_len;
+}
+
+/**
+ * @brief Receive a frame on a port of the loopback network.
+ *  When no frame is deliverable, the receive waits until the next
+ *  delivery, or for the timeout, see loopback_simulated_time_set().
+ * @param mac - MAC address of the receiving port
+ * @param src - source address of the frame
+ * @param pdu - buffer for the frame data
+ * @param max_pdu - size of the buffer
+ * @param timeout - number of milliseconds to wait for a frame
+ * @return the number of octets in the PDU, or zero if none
+ */
+uint16_t loopback_port_receive(uint16_t mac,
+    BACNET_ADDRESS *src,
+    uint8_t *pdu,
+    uint16_t max_pdu,
+    unsigned timeout)
+{
+    struct loopback_port *port;
+    struct loopback_frame *frame;
+    uint32_t wait_time;
+    uint16_t pdu_len = 0;
+
+    port = loopback_port(mac);
+    if (!port) {
+        return 0;
+    }
+    if (port->count == 0) {
+        loopback_wait(timeout);
+        return 0;
+    }
+    frame = &port->frame[port->head];
+    wait_time = frame->deliver_time - Loopback_Time;
+    if ((int32_t)wait_time > 0) {
+        if (wait_time > timeout) {
+            loopback_wait(timeout);
+            return 0;
+        }
+        loopback_wait(wait_time);
+    }
+    if (frame->pdu_len <= max_pdu) {
+        memcpy(pdu, frame->pdu, frame->pdu_len);
+        pdu_len = frame->pdu_len;
+        loopback_mac_to_address(frame->src, src);
+        Loopback_Stats.delivered++;
+    } else {
+        /* too large for the receiver - like a truncated datagram */
+        Loopback_Stats.dropped_mtu++;
+    }
+    port->head = (port->head + 1) % LOOPBACK_QUEUE_DEPTH;
+    port->count--;
+
+    return pdu_len;
+}
+
+/**
+ * @brief Set the latency of every frame on the loopback network
+ * @param milliseconds - time from send until the frame can be received
+ */
+void loopback_latency_set(uint32_t milliseconds)
+{
+    Loopback_Latency = milliseconds;
+}
+
+/**
+ * @brief Get the latency of every frame on the loopback network
+ * @return latency in milliseconds
+ */
+uint32_t loopback_latency(void)
+{
+    return Loopback_Latency;
+}
+
+/**
+ * @brief Set the fraction of frames that are lost on the loopback network
+ * @param parts_per_million - 0 for none, up to 1000000 for all
+ */
+void loopback_loss_set(uint32_t parts_per_million)
+{
+    if (parts_per_million > 1000000UL) {
+        parts_per_million = 1000000UL;
+    }
+    Loopback_Loss = parts_per_million;
+}
+
+/**
+ * @brief Get the fraction of frames that are lost on the loopback network
+ * @return parts per million
+ */
+uint32_t loopback_loss(void)
+{
+    return Loopback_Loss;
+}
+
+/**
+ * @brief Set the largest frame that can be sent on the loopback network
+ * @param mtu - maximum frame size, limited to LOOPBACK_MPDU_MAX
+ */
+void loopback_mtu_set(uint16_t mtu)
+{
+    if (mtu > LOOPBACK_MPDU_MAX) {
+        mtu = LOOPBACK_MPDU_MAX;
+    }
+    Loopback_MTU = mtu;
+}
+
+/**
+ * @brief Get the largest frame that can be sent on the loopback network
+ * @return maximum frame size
+ */
+uint16_t loopback_mtu(void)
+{
+    return Loopback_MTU;
+}
+
+/**
+ * @brief Seed the pseudo random sequence used for frame loss
+ * @param seed - any non-zero value
+ */
+void loopback_seed_set(uint32_t seed)
+{
+    Loopback_Seed = seed ? seed : 1;
+}
+
+/**
+ * @brief Enable or disable simulated time.  With simulated time, a
+ *  receive that waits only moves the time of the loopback network, and
+ *  returns at once; otherwise it also sleeps.  The default is disabled,
+ *  so that an application polling the loopback datalink does not spin.
+ * @param enable - true to simulate the time
+ */
+void loopback_simulated_time_set(bool enable)
+{
+    Loopback_Simulated_Time = enable;
+}
+
+/**
+ * @brief Determine if the time of the loopback network is simulated
+ * @return true if the time is simulated
+ */
+bool loopback_simulated_time(void)
+{
+    return Loopback_Simulated_Time;
+}
+
+/**
+ * @brief Get the time of the loopback network
+ * @return time in milliseconds
+ */
+uint32_t loopback_time(void)
+{
+    return Loopback_Time;
+}
+
+/**
+ * @brief Move the simulated time of the loopback network forward
+ * @param milliseconds - amount of time to advance
+ */
+void loopback_time_advance(uint32_t milliseconds)
+{
+    Loopback_Time += milliseconds;
+}
+
+/**
+ * @brief Get the frame counters of the loopback network
+ * @param stats - frame counters
+ */
+void loopback_statistics(LOOPBACK_STATISTICS *stats)
+{
+    if (stats) {
+        *stats = Loopback_Stats;
+    }
+}
+
+/**
+ * @brief Clear the frame counters of the loopback network
+ */
+void loopback_statistics_reset(void)
+{
+    memset(&Loopback_Stats, 0, sizeof(Loopback_Stats));
+}
+
+/**
+ * @brief Detach every port and restore the default network conditions
+ */
+void loopback_reset(void)
+{
+    unsigned i;
+
+    for (i = 0; i < LOOPBACK_PORTS_MAX; i++) {
+        loopback_port_delete((uint16_t)i);
+    }
+    Loopback_My_MAC = LOOPBACK_BROADCAST_MAC;
+    Loopback_Latency = 0;
+    Loopback_Loss = 0;
+    Loopback_MTU = LOOPBACK_MPDU_MAX;
+    Loopback_Seed = 1;
+    Loopback_Time = 0;
+    Loopback_Simulated_Time = false;
+    loopback_statistics_reset();
+}
+
+/**
+ * @brief Initialize the loopback datalink port of this device
+ * @param interface_name - decimal MAC address of the port, or NULL for 1
+ * @return true if the port is attached
+ */
+bool loopback_init(char *interface_name)
+{
+    unsigned long mac = 1;
+
+    if (interface_name) {
+        mac = strtoul(interface_name, NULL, 0);
+    }
+    if (mac >= LOOPBACK_PORTS_MAX) {
+        return false;
+    }
+    if (!loopback_port_create((uint16_t)mac)) {
+        return false;
+    }
+    Loopback_My_MAC = (uint16_t)mac;
+
+    return true;
+}
+
+/**
+ * @brief Detach the loopback datalink port of this device
+ */
+void loopback_cleanup(void)
+{
+    loopback_port_delete(Loopback_My_MAC);
+    Loopback_My_MAC = LOOPBACK_BROADCAST_MAC;
+}
+
+/**
+ * @brief Send a PDU from the loopback datalink port of this device
+ * @param dest - destination address
+ * @param npdu_data - network information
+ * @param pdu - any data to be sent - may be null
+ * @param pdu_len - number of bytes of data
+ * @return number of bytes sent, or -1 on error
+ */
+int loopback_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    int bytes_sent;
+
+    (void)npdu_data;
+    bytes_sent = loopback_port_send(Loopback_My_MAC, dest, pdu, pdu_len);
+    if (bytes_sent < 0) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX_ERRORS);
+    } else {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_TX);
+    }
+
+    return bytes_sent;
+}
+
+/**
+ * @brief Receive a PDU on the loopback datalink port of this device
+ * @param src - source address
+ * @param pdu - buffer for the PDU
+ * @param max_pdu - size of the buffer
+ * @param timeout - number of milliseconds to wait for a packet
+ * @return the number of octets in the PDU, or zero if none
+ */
+uint16_t loopback_receive(
+    BACNET_ADDRESS *src, uint8_t *pdu, uint16_t max_pdu, unsigned timeout)
+{
+    uint16_t pdu_len;
+
+    pdu_len =
+        loopback_port_receive(Loopback_My_MAC, src, pdu, max_pdu, timeout);
+    if (pdu_len) {
+        BACNET_METRICS_INCREMENT(BACNET_METRIC_DATALINK_RX);
+    }
+
+    return pdu_len;
+}
+
+/**
+ * @brief Get the address of the loopback datalink port of this device
+ * @param my_address - address to fill in
+ */
+void loopback_get_my_address(BACNET_ADDRESS *my_address)
+{
+    loopback_mac_to_address(Loopback_My_MAC, my_address);
+}
+
+/**
+ * @brief Get the broadcast address of the loopback network
+ * @param dest - address to fill in
+ */
+void loopback_get_broadcast_address(BACNET_ADDRESS *dest)
+{
+    if (dest) {
+        loopback_mac_to_address(LOOPBACK_BROADCAST_MAC, dest);
+        dest->net = BACNET_BROADCAST_NETWORK;
+    }
+}
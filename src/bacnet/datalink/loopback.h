@@ -0,0 +1,164 @@
+/**
+ * @file
+ * @brief BACnet in-process loopback datalink interface and defines
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @defgroup DLLoopback BACnet Loopback DataLink Network Layer
+ * @ingroup DataLink
+ */
+#ifndef BACNET_LOOPBACK_H
+#define BACNET_LOOPBACK_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/npdu.h"
+
+/* specific defines for the loopback datalink */
+#define LOOPBACK_MPDU_MAX (MAX_PDU)
+/* the MAC address is a 2-octet port number, most significant octet first */
+#define LOOPBACK_MAC_LEN 2
+#define LOOPBACK_BROADCAST_MAC 0xFFFF
+/* number of ports that can be attached to the loopback network */
+#ifndef LOOPBACK_PORTS_MAX
+#define LOOPBACK_PORTS_MAX 1024
+#endif
+/* number of frames that can be waiting in each port receive queue */
+#ifndef LOOPBACK_QUEUE_DEPTH
+#define LOOPBACK_QUEUE_DEPTH 16
+#endif
+
+typedef struct loopback_statistics {
+    /* frames accepted for transmission */
+    uint32_t transmitted;
+    /* frames returned to a receiver */
+    uint32_t delivered;
+    /* frames dropped by the configured loss rate */
+    uint32_t dropped_loss;
+    /* frames dropped because they were larger than the MTU */
+    uint32_t dropped_mtu;
+    /* frames dropped because the receive queue was full */
+    uint32_t dropped_overflow;
+    /* frames dropped because no port has the destination MAC */
+    uint32_t dropped_unknown;
+} LOOPBACK_STATISTICS;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+    /* network of simulated ports */
+    BACNET_STACK_EXPORT
+    bool loopback_port_create(
+        uint16_t mac);
+    BACNET_STACK_EXPORT
+    void loopback_port_delete(
+        uint16_t mac);
+    BACNET_STACK_EXPORT
+    bool loopback_port_valid(
+        uint16_t mac);
+    BACNET_STACK_EXPORT
+    unsigned loopback_port_count(
+        void);
+    BACNET_STACK_EXPORT
+    int loopback_port_send(
+        uint16_t mac,
+        BACNET_ADDRESS * dest,
+        uint8_t * pdu,
+        unsigned pdu_len);
+    BACNET_STACK_EXPORT
+    uint16_t loopback_port_receive(
+        uint16_t mac,
+        BACNET_ADDRESS * src,
+        uint8_t * pdu,
+        uint16_t max_pdu,
+        unsigned timeout);
+    BACNET_STACK_EXPORT
+    unsigned loopback_port_pending(
+        uint16_t mac);
+    BACNET_STACK_EXPORT
+    void loopback_mac_to_address(
+        uint16_t mac,
+        BACNET_ADDRESS * addr);
+
+    /* network conditions */
+    BACNET_STACK_EXPORT
+    void loopback_latency_set(
+        uint32_t milliseconds);
+    BACNET_STACK_EXPORT
+    uint32_t loopback_latency(
+        void);
+    BACNET_STACK_EXPORT
+    void loopback_loss_set(
+        uint32_t parts_per_million);
+    BACNET_STACK_EXPORT
+    uint32_t loopback_loss(
+        void);
+    BACNET_STACK_EXPORT
+    void loopback_mtu_set(
+        uint16_t mtu);
+    BACNET_STACK_EXPORT
+    uint16_t loopback_mtu(
+        void);
+    BACNET_STACK_EXPORT
+    void loopback_seed_set(
+        uint32_t seed);
+
+    /* network time */
+    BACNET_STACK_EXPORT
+    void loopback_simulated_time_set(
+        bool enable);
+    BACNET_STACK_EXPORT
+    bool loopback_simulated_time(
+        void);
+    BACNET_STACK_EXPORT
+    uint32_t loopback_time(
+        void);
+    BACNET_STACK_EXPORT
+    void loopback_time_advance(
+        uint32_t milliseconds);
+
+    BACNET_STACK_EXPORT
+    void loopback_statistics(
+        LOOPBACK_STATISTICS * stats);
+    BACNET_STACK_EXPORT
+    void loopback_statistics_reset(
+        void);
+    BACNET_STACK_EXPORT
+    void loopback_reset(
+        void);
+
+    /* datalink API for the port of this device */
+    BACNET_STACK_EXPORT
+    bool loopback_init(
+        char *interface_name);
+    BACNET_STACK_EXPORT
+    void loopback_cleanup(
+        void);
+    BACNET_STACK_EXPORT
+    int loopback_send_pdu(
+        BACNET_ADDRESS * dest,
+        BACNET_NPDU_DATA * npdu_data,
+        uint8_t * pdu,
+        unsigned pdu_len);
+    BACNET_STACK_EXPORT
+    uint16_t loopback_receive(
+        BACNET_ADDRESS * src,
+        uint8_t * pdu,
+        uint16_t max_pdu,
+        unsigned timeout);
+    BACNET_STACK_EXPORT
+    void loopback_get_my_address(
+        BACNET_ADDRESS * my_address);
+    BACNET_STACK_EXPORT
+    void loopback_get_broadcast_address(
+        BACNET_ADDRESS * dest);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -267,6 +267,9 @@ void MSTP_Create_And_Send_Frame(struct mstp_port_struct_t *mstp_port,
     len =
         MSTP_Create_Frame(mstp_port->OutputBuffer, mstp_port->OutputBufferSize,
             frame_type, destination, source, data, data_len);
+    if (frame_type == FRAME_TYPE_POLL_FOR_MASTER) {
+        mstp_port->Token_Statistics.poll_for_master_counter++;
+    }
 
     MSTP_Send_Frame(mstp_port, (uint8_t *)&mstp_port->OutputBuffer[0], len);
     /* FIXME: be sure to reset SilenceTimer() after each octet is sent! */
@@ -593,6 +596,68 @@ void MSTP_Receive_Frame_FSM(struct mstp_port_struct_t *mstp_port)
     return;
 }
 
+/**
+ * @brief Start to use the token: count it, measure the token rotation
+ *  time, and set the number of information frames that may be sent.
+ *
+ * In the adaptive mode the budget follows the depth of the transmit
+ * queue, at most doubling from one token to the next, between
+ * Nmax_info_frames and Nmax_info_frames_limit.  The budget is halved
+ * while the token rotation time is longer than Ttoken_rotation_limit,
+ * so that a busy node does not starve the other masters.
+ *
+ * @param mstp_port MSTP port context data
+ */
+static void MSTP_Token_Use_Start(struct mstp_port_struct_t *mstp_port)
+{
+    MSTP_TOKEN_STATISTICS *statistics = &mstp_port->Token_Statistics;
+    uint32_t now, rotation = 0;
+    unsigned budget, queued;
+
+    mstp_port->FrameCount = 0;
+    statistics->token_counter++;
+    if (mstp_port->Milliseconds) {
+        now = mstp_port->Milliseconds((void *)mstp_port);
+        if (statistics->token_counter > 1) {
+            rotation = now - mstp_port->Token_Use_Time;
+            statistics->token_rotation_milliseconds = rotation;
+            if (rotation > statistics->token_rotation_milliseconds_max) {
+                statistics->token_rotation_milliseconds_max = rotation;
+            }
+        }
+        mstp_port->Token_Use_Time = now;
+    }
+    budget = mstp_port->Nmax_info_frames;
+    if (mstp_port->Nmax_info_frames_limit > mstp_port->Nmax_info_frames) {
+        if (mstp_port->SendQueueCount) {
+            queued = mstp_port->SendQueueCount((void *)mstp_port);
+        } else if (mstp_port->InfoFramesExhausted) {
+            queued = 2 * (unsigned)mstp_port->Info_Frames_Budget;
+        } else {
+            queued = 0;
+        }
+        if (mstp_port->Ttoken_rotation_limit &&
+            (rotation > mstp_port->Ttoken_rotation_limit)) {
+            budget = mstp_port->Info_Frames_Budget / 2;
+        } else if (queued > mstp_port->Info_Frames_Budget) {
+            budget = 2 * (unsigned)mstp_port->Info_Frames_Budget;
+            if (budget > queued) {
+                budget = queued;
+            }
+        } else {
+            budget = queued;
+        }
+        if (budget < mstp_port->Nmax_info_frames) {
+            budget = mstp_port->Nmax_info_frames;
+        }
+        if (budget > mstp_port->Nmax_info_frames_limit) {
+            budget = mstp_port->Nmax_info_frames_limit;
+        }
+    }
+    mstp_port->Info_Frames_Budget = (uint8_t)budget;
+    mstp_port->InfoFramesExhausted = false;
+}
+
 /**
  * @brief Finite State Machine for receiving an MSTP frame
  * @param mstp_port MSTP port context data
@@ -685,7 +750,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                                 break;
                             }
                             mstp_port->ReceivedValidFrame = false;
-                            mstp_port->FrameCount = 0;
+                            MSTP_Token_Use_Start(mstp_port);
                             mstp_port->SoleMaster = false;
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_USE_TOKEN;
@@ -771,7 +836,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             length = (unsigned)MSTP_Get_Send(mstp_port, 0);
             if (length < 1) {
                 /* NothingToSend */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                mstp_port->FrameCount = mstp_port->Info_Frames_Budget;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 transition_now = true;
             } else {
@@ -780,6 +845,11 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 MSTP_Send_Frame(mstp_port,
                     (uint8_t *)&mstp_port->OutputBuffer[0], (uint16_t)length);
                 mstp_port->FrameCount++;
+                mstp_port->Token_Statistics.info_frame_counter++;
+                if (mstp_port->FrameCount >= mstp_port->Info_Frames_Budget) {
+                    mstp_port->InfoFramesExhausted = true;
+                    mstp_port->Token_Statistics.budget_exhausted_counter++;
+                }
                 switch (frame_type) {
                     case FRAME_TYPE_BACNET_DATA_EXPECTING_REPLY:
                         if (destination == MSTP_BROADCAST_ADDRESS) {
@@ -814,7 +884,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                 mstp_port->Treply_timeout) {
                 /* ReplyTimeout */
                 /* assume that the request has failed */
-                mstp_port->FrameCount = mstp_port->Nmax_info_frames;
+                mstp_port->FrameCount = mstp_port->Info_Frames_Budget;
                 mstp_port->master_state = MSTP_MASTER_STATE_DONE_WITH_TOKEN;
                 /* Any retry of the data frame shall await the next entry */
                 /* to the USE_TOKEN state. (Because of the length of the
@@ -877,7 +947,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
             /* The DONE_WITH_TOKEN state either sends another data frame,  */
             /* passes the token, or initiates a Poll For Master cycle. */
             /* SendAnotherFrame */
-            if (mstp_port->FrameCount < mstp_port->Nmax_info_frames) {
+            if (mstp_port->FrameCount < mstp_port->Info_Frames_Budget) {
                 /* then this node may send another information frame  */
                 /* before passing the token.  */
                 mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
@@ -901,7 +971,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     /* there are no other known master nodes to */
                     /* which the token may be sent (true master-slave
                      * operation).  */
-                    mstp_port->FrameCount = 0;
+                    MSTP_Token_Use_Start(mstp_port);
                     mstp_port->TokenCount++;
                     mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
                     transition_now = true;
@@ -1099,7 +1169,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                     /* SoleMaster */
                     /* There was no valid reply to the periodic poll  */
                     /* by the sole known master for other masters. */
-                    mstp_port->FrameCount = 0;
+                    MSTP_Token_Use_Start(mstp_port);
                     /* mstp_port->TokenCount++; removed in 2004 */
                     mstp_port->master_state = MSTP_MASTER_STATE_USE_TOKEN;
                     transition_now = true;
@@ -1131,7 +1201,7 @@ bool MSTP_Master_Node_FSM(struct mstp_port_struct_t *mstp_port)
                             /* to indicate that this station is the only master
                              */
                             mstp_port->SoleMaster = true;
-                            mstp_port->FrameCount = 0;
+                            MSTP_Token_Use_Start(mstp_port);
                             mstp_port->master_state =
                                 MSTP_MASTER_STATE_USE_TOKEN;
                             transition_now = true;
@@ -1678,7 +1748,36 @@ void MSTP_Init(struct mstp_port_struct_t *mstp_port)
         mstp_port->SoleMaster = false;
         mstp_port->SourceAddress = 0;
         mstp_port->TokenCount = 0;
+        mstp_port->Info_Frames_Budget = mstp_port->Nmax_info_frames;
+        mstp_port->InfoFramesExhausted = false;
+        mstp_port->Token_Use_Time = 0;
+        MSTP_Token_Statistics_Reset(mstp_port);
         /* zero config */
         mstp_port->Zero_Config_State = MSTP_ZERO_CONFIG_STATE_INIT;
     }
 }
+
+/**
+ * @brief Copy the token usage statistics of an MS/TP master node
+ * @param mstp_port MSTP port context data
+ * @param statistics [out] token usage statistics
+ */
+void MSTP_Token_Statistics(struct mstp_port_struct_t *mstp_port,
+    MSTP_TOKEN_STATISTICS *statistics)
+{
+    if (mstp_port && statistics) {
+        *statistics = mstp_port->Token_Statistics;
+    }
+}
+
+/**
+ * @brief Reset the token usage statistics of an MS/TP master node
+ * @param mstp_port MSTP port context data
+ */
+void MSTP_Token_Statistics_Reset(struct mstp_port_struct_t *mstp_port)
+{
+    if (mstp_port) {
+        memset(&mstp_port->Token_Statistics, 0,
+            sizeof(mstp_port->Token_Statistics));
+    }
+}
@@ -28,6 +28,21 @@
 /* size of the buffer used to send and validate a unique test request */
 #define MSTP_UUID_SIZE 16
 
+/* token usage statistics of a master node, for tuning the trunk */
+typedef struct mstp_token_statistics {
+    /* number of times this node has started to use the token */
+    uint32_t token_counter;
+    /* number of Poll For Master frames sent */
+    uint32_t poll_for_master_counter;
+    /* number of information frames sent while holding the token */
+    uint32_t info_frame_counter;
+    /* number of token holds that used up the info-frame budget */
+    uint32_t budget_exhausted_counter;
+    /* the last and the longest token rotation time, in milliseconds */
+    uint32_t token_rotation_milliseconds;
+    uint32_t token_rotation_milliseconds_max;
+} MSTP_TOKEN_STATISTICS;
+
 struct mstp_port_struct_t {
     MSTP_RECEIVE_STATE receive_state;
     /* When a master node is powered up or reset, */
@@ -211,6 +226,29 @@ struct mstp_port_struct_t {
       turnaround_time_milliseconds = (Tturnaround*1000UL)/RS485_Baud; */
     uint8_t Tturnaround_timeout;
 
+    /* Adaptive Max_Info_Frames, which is off unless Nmax_info_frames_limit
+       is greater than Nmax_info_frames.  When on, a node with a deep
+       transmit queue may send up to Nmax_info_frames_limit frames with
+       each token, and the budget is halved while the token rotation time
+       is longer than Ttoken_rotation_limit milliseconds (zero for none). */
+    uint8_t Nmax_info_frames_limit;
+    uint16_t Ttoken_rotation_limit;
+    /* The number of information frames this node may send with the token
+       that it is holding. */
+    uint8_t Info_Frames_Budget;
+    /* A Boolean flag set to TRUE if the last token hold used up the budget */
+    unsigned InfoFramesExhausted : 1;
+    /* Optional: number of PDUs waiting to be sent, used by the adaptive
+       Max_Info_Frames.  Without it, a token hold that used up the budget
+       is taken as a sign of a deep queue. */
+    unsigned (*SendQueueCount)(void *pArg);
+    /* Optional: a free running millisecond clock, used to measure the
+       token rotation time */
+    uint32_t (*Milliseconds)(void *pArg);
+    /* clock value when this node last started to use the token */
+    uint32_t Token_Use_Time;
+    MSTP_TOKEN_STATISTICS Token_Statistics;
+
     /*Platform-specific port data */
     void *UserData;
 };
@@ -262,6 +300,12 @@ unsigned MSTP_Zero_Config_Station_Increment(unsigned station);
 BACNET_STACK_EXPORT
 void MSTP_Zero_Config_FSM(struct mstp_port_struct_t *mstp_port);
 
+BACNET_STACK_EXPORT
+void MSTP_Token_Statistics(struct mstp_port_struct_t *mstp_port,
+    MSTP_TOKEN_STATISTICS *statistics);
+BACNET_STACK_EXPORT
+void MSTP_Token_Statistics_Reset(struct mstp_port_struct_t *mstp_port);
+
 /* functions used by the MS/TP state machine to put or get data */
 /* FIXME: developer must implement these in their DLMSTP module */
 
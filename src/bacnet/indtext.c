@@ -6,6 +6,7 @@
  * @copyright SPDX-License-Identifier: GPL-2.0-or-later WITH GCC-exception-2.0
  */
 #include <stdbool.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include "bacnet/bacdef.h"
@@ -211,3 +212,225 @@ unsigned indtext_count(INDTEXT_DATA *data_list)
     }
     return count;
 }
+
+/**
+ * @brief Order two entries by text, case insensitive, and then by their
+ *  position in the list, so that the first of equal texts comes first
+ * @param a - pointer to the first entry pointer
+ * @param b - pointer to the second entry pointer
+ * @return negative, zero, or positive
+ */
+static int indtext_name_compare(const void *a, const void *b)
+{
+    INDTEXT_DATA *data_a = *(INDTEXT_DATA *const *)a;
+    INDTEXT_DATA *data_b = *(INDTEXT_DATA *const *)b;
+    int status;
+
+    status = indtext_stricmp(data_a->pString, data_b->pString);
+    if (status == 0) {
+        status = (data_a < data_b) ? -1 : (data_a > data_b);
+    }
+
+    return status;
+}
+
+/**
+ * @brief Order two entries by index, and then by their position in the
+ *  list, so that the first of equal indexes comes first
+ * @param a - pointer to the first entry pointer
+ * @param b - pointer to the second entry pointer
+ * @return negative, zero, or positive
+ */
+static int indtext_index_compare(const void *a, const void *b)
+{
+    INDTEXT_DATA *data_a = *(INDTEXT_DATA *const *)a;
+    INDTEXT_DATA *data_b = *(INDTEXT_DATA *const *)b;
+
+    if (data_a->index != data_b->index) {
+        return (data_a->index < data_b->index) ? -1 : 1;
+    }
+
+    return (data_a < data_b) ? -1 : (data_a > data_b);
+}
+
+/**
+ * @brief Sort the views of a list, if they are not sorted yet.
+ *  The binary searches sort the views the first time they are used,
+ *  which writes to the views; call this before sharing the views
+ *  between threads.
+ * @param data_index - sorted views of a list of strings and indices
+ * @return true if the views are sorted
+ */
+bool indtext_index_init(INDTEXT_INDEX *data_index)
+{
+    INDTEXT_DATA *data_list;
+    unsigned count;
+
+    if (!data_index) {
+        return false;
+    }
+    if (data_index->sorted) {
+        return true;
+    }
+    data_list = data_index->data_list;
+    count = indtext_count(data_list);
+    if (!data_index->by_name || !data_index->by_index ||
+        (count > data_index->size)) {
+        return false;
+    }
+    data_index->dense = 0;
+    while ((data_index->dense < count) &&
+        (data_list[data_index->dense].index == data_index->dense)) {
+        data_index->dense++;
+    }
+    for (data_index->count = 0; data_index->count < count;
+         data_index->count++) {
+        data_index->by_name[data_index->count] = &data_list[data_index->count];
+        data_index->by_index[data_index->count] =
+            &data_list[data_index->count];
+    }
+    qsort(data_index->by_name, count, sizeof(INDTEXT_DATA *),
+        indtext_name_compare);
+    qsort(data_index->by_index, count, sizeof(INDTEXT_DATA *),
+        indtext_index_compare);
+    data_index->sorted = true;
+
+    return true;
+}
+
+/**
+ * @brief Find the first entry in the text view that is not less than
+ *  the search string, case insensitive
+ * @param data_index - sorted views of a list of strings and indices
+ * @param search_name - string to search for
+ * @return position in the text view, or count if none
+ */
+static unsigned indtext_index_name_lower_bound(
+    INDTEXT_INDEX *data_index, const char *search_name)
+{
+    unsigned low = 0, high = data_index->count, middle;
+
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (indtext_stricmp(
+                data_index->by_name[middle]->pString, search_name) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * @brief Search a list of strings to find a matching string, using
+ *  a binary search of its sorted views
+ * @param data_index - sorted views of a list of strings and indices
+ * @param search_name - string to search for
+ * @param found_index - index of the string found
+ * @return true if the string is found
+ */
+bool indtext_index_by_string(
+    INDTEXT_INDEX *data_index, const char *search_name, unsigned *found_index)
+{
+    INDTEXT_DATA *data;
+    unsigned i;
+
+    if (!search_name || !indtext_index_init(data_index)) {
+        return indtext_by_string(
+            data_index ? data_index->data_list : NULL, search_name,
+            found_index);
+    }
+    /* the case sensitive match is among the case insensitive ones */
+    for (i = indtext_index_name_lower_bound(data_index, search_name);
+         i < data_index->count; i++) {
+        data = data_index->by_name[i];
+        if (indtext_stricmp(data->pString, search_name) != 0) {
+            break;
+        }
+        if (strcmp(data->pString, search_name) == 0) {
+            if (found_index) {
+                *found_index = data->index;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Search a list of strings to find a matching string, case
+ *  insensitive, using a binary search of its sorted views
+ * @param data_index - sorted views of a list of strings and indices
+ * @param search_name - string to search for
+ * @param found_index - index of the string found
+ * @return true if the string is found
+ */
+bool indtext_index_by_istring(
+    INDTEXT_INDEX *data_index, const char *search_name, unsigned *found_index)
+{
+    INDTEXT_DATA *data;
+    unsigned i;
+
+    if (!search_name || !indtext_index_init(data_index)) {
+        return indtext_by_istring(
+            data_index ? data_index->data_list : NULL, search_name,
+            found_index);
+    }
+    i = indtext_index_name_lower_bound(data_index, search_name);
+    if (i < data_index->count) {
+        data = data_index->by_name[i];
+        if (indtext_stricmp(data->pString, search_name) == 0) {
+            if (found_index) {
+                *found_index = data->index;
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Return the string for a given index, or a default string.
+ *  The leading entries whose index is their position are looked up
+ *  directly, and the others with a binary search of the sorted views.
+ * @param data_index - sorted views of a list of strings and indices
+ * @param index - index to search for
+ * @param default_name - default string to return if the index is not found
+ * @return the string found, or the default string
+ */
+const char *indtext_index_by_index_default(
+    INDTEXT_INDEX *data_index, unsigned index, const char *default_name)
+{
+    unsigned low, high, middle;
+    INDTEXT_DATA *data;
+
+    if (!indtext_index_init(data_index)) {
+        return indtext_by_index_default(
+            data_index ? data_index->data_list : NULL, index, default_name);
+    }
+    if (index < data_index->dense) {
+        return data_index->data_list[index].pString;
+    }
+    low = 0;
+    high = data_index->count;
+    while (low < high) {
+        middle = low + ((high - low) / 2);
+        if (data_index->by_index[middle]->index < index) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    if (low < data_index->count) {
+        data = data_index->by_index[low];
+        if (data->index == index) {
+            return data->pString;
+        }
+    }
+
+    return default_name;
+}
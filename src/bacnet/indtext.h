@@ -20,6 +20,25 @@ typedef const struct {
     const char *pString;        /* text pair - use NULL to end the list */
 } INDTEXT_DATA;
 
+/* sorted views of a list of index and text pairs, for binary search.
+   The storage arrays hold at least as many pointers as the list has
+   entries, and the views are sorted when they are first used, or by
+   indtext_index_init(). The first use is not thread-safe. */
+typedef struct indtext_index {
+    INDTEXT_DATA *data_list;
+    /* storage for the entries sorted by text, case insensitive */
+    INDTEXT_DATA **by_name;
+    /* storage for the entries sorted by index */
+    INDTEXT_DATA **by_index;
+    /* number of pointers in each of the storage arrays */
+    unsigned size;
+    /* number of entries in the list, once sorted */
+    unsigned count;
+    /* number of leading entries whose index is their position */
+    unsigned dense;
+    bool sorted;
+} INDTEXT_INDEX;
+
 #ifdef __cplusplus
 extern "C" {
 #endif /* __cplusplus */
@@ -81,6 +100,26 @@ extern "C" {
         const char *before_split_default_name,
         const char *default_name);
 
+/* binary search versions, using the sorted views of a list */
+    BACNET_STACK_EXPORT
+    bool indtext_index_init(
+        INDTEXT_INDEX * data_index);
+    BACNET_STACK_EXPORT
+    bool indtext_index_by_string(
+        INDTEXT_INDEX * data_index,
+        const char *search_name,
+        unsigned *found_index);
+    BACNET_STACK_EXPORT
+    bool indtext_index_by_istring(
+        INDTEXT_INDEX * data_index,
+        const char *search_name,
+        unsigned *found_index);
+    BACNET_STACK_EXPORT
+    const char *indtext_index_by_index_default(
+        INDTEXT_INDEX * data_index,
+        unsigned index,
+        const char *default_name);
+
 /* returns the number of elements in the list */
     BACNET_STACK_EXPORT
     unsigned indtext_count(
@@ -607,3 +607,101 @@ int rr_ack_decode_service_request(uint8_t *apdu,
 
     return len;
 }
+
+/**
+ * @brief Encode the elements of a BACnetARRAY property, or of a list that
+ *  can be reached by position, for a ReadRange-ACK by position.  As many
+ *  of the requested elements as fit into the response are encoded, and
+ *  the result flags and item count of the request are set.
+ *
+ * The elements are encoded with the same function that encodes one
+ * element of the array for ReadProperty, so any array property can be
+ * read in pieces without segmentation.
+ *
+ * @param apdu - buffer of at least MAX_APDU bytes for the item data
+ * @param pRequest - ReadRange request data
+ * @param count - number of elements in the array
+ * @param encoder - function that encodes one element by 0-based index
+ * @return number of bytes encoded, or -2 if not even one element fits,
+ *  or BACNET_STATUS_ERROR if an element could not be encoded
+ */
+int rr_array_encode(uint8_t *apdu,
+    BACNET_READ_RANGE_DATA *pRequest,
+    uint32_t count,
+    bacnet_array_property_element_encode_function encoder)
+{
+    int apdu_len = 0;
+    int len = 0;
+    uint32_t first = 0; /* first element to encode, 1..N */
+    uint32_t items = 0; /* number of elements to encode */
+    uint32_t last = 0; /* last element encoded */
+    uint32_t index = 0;
+    uint32_t remaining = 0; /* amount of unused space in the response */
+
+    if ((!pRequest) || (!apdu) || (!encoder)) {
+        return 0;
+    }
+    bitstring_init(&pRequest->ResultFlags);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, false);
+    bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, false);
+    pRequest->ItemCount = 0;
+    if ((count == 0) || (pRequest->Overhead >= MAX_APDU)) {
+        return 0;
+    }
+    remaining = (uint32_t)(MAX_APDU - pRequest->Overhead);
+    if (pRequest->RequestType == RR_READ_ALL) {
+        first = 1;
+        items = count;
+    } else if (pRequest->Count < 0) {
+        /* negative count means the elements before and including
+           the reference index */
+        items = 0U - (uint32_t)pRequest->Count;
+        if (items >= pRequest->Range.RefIndex) {
+            items = pRequest->Range.RefIndex;
+            first = 1;
+        } else {
+            first = pRequest->Range.RefIndex - items + 1;
+        }
+    } else {
+        first = pRequest->Range.RefIndex;
+        items = (uint32_t)pRequest->Count;
+    }
+    if ((first == 0) || (first > count)) {
+        /* nothing to return, since the index is not in the array */
+        return 0;
+    }
+    if (items > (count - first + 1)) {
+        items = count - first + 1;
+    }
+    for (index = first; index < (first + items); index++) {
+        len = encoder(pRequest->object_instance, index - 1, NULL);
+        if (len < 0) {
+            pRequest->error_class = ERROR_CLASS_PROPERTY;
+            pRequest->error_code = ERROR_CODE_INVALID_ARRAY_INDEX;
+            return BACNET_STATUS_ERROR;
+        }
+        if ((uint32_t)len > remaining) {
+            bitstring_set_bit(
+                &pRequest->ResultFlags, RESULT_FLAG_MORE_ITEMS, true);
+            break;
+        }
+        len = encoder(pRequest->object_instance, index - 1, &apdu[apdu_len]);
+        apdu_len += len;
+        remaining -= (uint32_t)len;
+        last = index;
+        pRequest->ItemCount++;
+    }
+    if (pRequest->ItemCount == 0) {
+        /* the response is too small for one element */
+        return -2;
+    }
+    if (first == 1) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_FIRST_ITEM, true);
+    }
+    if (last == count) {
+        bitstring_set_bit(&pRequest->ResultFlags, RESULT_FLAG_LAST_ITEM, true);
+    }
+
+    return apdu_len;
+}
@@ -11,6 +11,7 @@
 /* BACnet Stack defines - first */
 #include "bacnet/bacdef.h"
 /* BACnet Stack API */
+#include "bacnet/bacdcode.h"
 #include "bacnet/bacstr.h"
 #include "bacnet/datetime.h"
 
@@ -152,6 +153,13 @@ extern "C" {
         int apdu_len,   /* total length of the apdu */
         BACNET_READ_RANGE_DATA * rrdata);
 
+    BACNET_STACK_EXPORT
+    int rr_array_encode(
+        uint8_t * apdu,
+        BACNET_READ_RANGE_DATA * pRequest,
+        uint32_t count,
+        bacnet_array_property_element_encode_function encoder);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
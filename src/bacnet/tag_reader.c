@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @brief Streaming, allocation-free BACnet tag reader
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ * @section DESCRIPTION
+ *
+ * The tag reader is a pull-style cursor over an APDU buffer.  Each call
+ * returns the next opening tag, closing tag, or primitive value, where
+ * the primitive value contents are a span that points back into the
+ * APDU buffer.  Nothing is copied or allocated, so a caller can walk,
+ * inspect, or fast-forward over a large constructed value (for example
+ * an Object_List with thousands of elements in a ReadPropertyMultiple-ACK)
+ * without decoding each element into a BACNET_APPLICATION_DATA_VALUE.
+ */
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+#include "bacnet/tag_reader.h"
+
+/**
+ * @brief Initialize a tag reader over an APDU buffer
+ * @param reader - tag reader to initialize
+ * @param apdu - buffer to read from
+ * @param apdu_size - number of valid bytes in the buffer
+ */
+void bacnet_tag_reader_init(
+    BACNET_TAG_READER *reader, uint8_t *apdu, uint32_t apdu_size)
+{
+    if (reader) {
+        reader->apdu = apdu;
+        reader->apdu_size = apdu ? apdu_size : 0;
+        reader->offset = 0;
+        reader->depth = 0;
+        reader->error = false;
+    }
+}
+
+/**
+ * @brief Decode the tag at the reader cursor without moving the cursor
+ * @param reader - tag reader
+ * @param item - returns the tag and borrowed primitive contents
+ * @return true if a complete tag (and contents) is available
+ */
+bool bacnet_tag_reader_peek(
+    const BACNET_TAG_READER *reader, BACNET_TAG_READER_ITEM *item)
+{
+    BACNET_TAG tag = { 0 };
+    uint32_t remaining;
+    uint32_t data_len = 0;
+    int len;
+
+    if (!reader || reader->error || !reader->apdu) {
+        return false;
+    }
+    if (reader->offset >= reader->apdu_size) {
+        return false;
+    }
+    remaining = reader->apdu_size - reader->offset;
+    len = bacnet_tag_decode(&reader->apdu[reader->offset], remaining, &tag);
+    if (len <= 0) {
+        return false;
+    }
+    if (tag.context ||
+        (tag.application && (tag.number != BACNET_APPLICATION_TAG_BOOLEAN))) {
+        data_len = tag.len_value_type;
+    }
+    if (data_len > (remaining - (uint32_t)len)) {
+        /* contents octets run past the end of the buffer */
+        return false;
+    }
+    if (item) {
+        item->tag = tag;
+        item->offset = reader->offset;
+        item->tag_len = (uint32_t)len;
+        item->depth = reader->depth;
+        if (tag.opening || tag.closing) {
+            item->data = NULL;
+            item->data_len = 0;
+        } else {
+            item->data = &reader->apdu[reader->offset + (uint32_t)len];
+            item->data_len = data_len;
+        }
+        if (tag.closing && (item->depth > 0)) {
+            item->depth--;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Return the tag at the reader cursor and advance past it.
+ *  Opening tags increment the depth and closing tags decrement it.
+ *  A closing tag found at depth zero belongs to a constructed value that
+ *  encloses the reader, so it ends the scope of the reader and is not
+ *  consumed.  This lets a reader be started inside a constructed value.
+ * @param reader - tag reader
+ * @param item - returns the tag and borrowed primitive contents, or NULL
+ * @return true if a tag was read, false at the end of data, at the end
+ *  of the enclosing scope, or on error.  Use bacnet_tag_reader_error()
+ *  to tell them apart.
+ */
+bool bacnet_tag_reader_next(
+    BACNET_TAG_READER *reader, BACNET_TAG_READER_ITEM *item)
+{
+    BACNET_TAG_READER_ITEM local = { 0 };
+
+    if (!reader) {
+        return false;
+    }
+    if (!bacnet_tag_reader_peek(reader, &local)) {
+        if (!reader->error && (reader->offset < reader->apdu_size)) {
+            reader->error = true;
+        }
+        return false;
+    }
+    if (local.tag.closing && (reader->depth == 0)) {
+        /* end of the enclosing scope */
+        return false;
+    }
+    reader->offset += local.tag_len + local.data_len;
+    if (local.tag.opening) {
+        reader->depth++;
+    } else if (local.tag.closing) {
+        reader->depth--;
+    }
+    if (item) {
+        *item = local;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Skip the next element: a primitive, or a whole constructed
+ *  value from its opening tag through the matching closing tag.
+ * @param reader - tag reader
+ * @return true if the element was skipped, false at a closing tag
+ *  (which is not consumed), at the end of data, or on error.
+ */
+bool bacnet_tag_reader_skip(BACNET_TAG_READER *reader)
+{
+    BACNET_TAG_READER_ITEM item = { 0 };
+
+    if (!bacnet_tag_reader_peek(reader, &item)) {
+        /* flags the error, if any */
+        return bacnet_tag_reader_next(reader, NULL);
+    }
+    if (item.tag.closing) {
+        /* end of the current constructed value - not consumed */
+        return false;
+    }
+    (void)bacnet_tag_reader_next(reader, NULL);
+    if (item.tag.opening) {
+        return bacnet_tag_reader_skip_to_closing(reader);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Fast-forward past the closing tag that matches the most
+ *  recent opening tag, without returning any of the enclosed elements.
+ * @param reader - tag reader positioned inside a constructed value
+ * @return true if the matching closing tag was consumed
+ */
+bool bacnet_tag_reader_skip_to_closing(BACNET_TAG_READER *reader)
+{
+    BACNET_TAG_READER_ITEM item = { 0 };
+    uint16_t depth;
+
+    if (!reader || (reader->depth == 0)) {
+        return false;
+    }
+    depth = reader->depth;
+    while (bacnet_tag_reader_next(reader, &item)) {
+        if (item.tag.closing && (reader->depth < depth)) {
+            return true;
+        }
+    }
+    /* ran out of data before the closing tag */
+    reader->error = true;
+
+    return false;
+}
+
+/**
+ * @brief Determine if the reader has consumed all of its buffer
+ * @param reader - tag reader
+ * @return true if no more data is available
+ */
+bool bacnet_tag_reader_done(const BACNET_TAG_READER *reader)
+{
+    if (!reader) {
+        return true;
+    }
+
+    return (reader->offset >= reader->apdu_size);
+}
+
+/**
+ * @brief Determine if the reader found malformed data
+ * @param reader - tag reader
+ * @return true if malformed data was found
+ */
+bool bacnet_tag_reader_error(const BACNET_TAG_READER *reader)
+{
+    if (!reader) {
+        return true;
+    }
+
+    return reader->error;
+}
+
+/**
+ * @brief Get the current cursor position
+ * @param reader - tag reader
+ * @return number of bytes consumed from the start of the buffer
+ */
+uint32_t bacnet_tag_reader_offset(const BACNET_TAG_READER *reader)
+{
+    if (!reader) {
+        return 0;
+    }
+
+    return reader->offset;
+}
+
+/**
+ * @brief Get the number of bytes not yet consumed
+ * @param reader - tag reader
+ * @return number of bytes remaining in the buffer
+ */
+uint32_t bacnet_tag_reader_remaining(const BACNET_TAG_READER *reader)
+{
+    if (!reader || (reader->offset >= reader->apdu_size)) {
+        return 0;
+    }
+
+    return reader->apdu_size - reader->offset;
+}
+
+/**
+ * @brief Returns the length of data between an opening tag and its
+ *  matching closing tag in a single pass over the tags.
+ * @note Expects that the first octet contain the opening tag.
+ * @param apdu Pointer to the APDU buffer
+ * @param apdu_size Bytes valid in the buffer
+ * @return length of data between an opening tag and a closing tag 0..N,
+ *  or BACNET_STATUS_ERROR.
+ */
+int bacnet_tag_reader_enclosed_length(uint8_t *apdu, uint32_t apdu_size)
+{
+    BACNET_TAG_READER reader;
+    BACNET_TAG_READER_ITEM item = { 0 };
+    uint32_t start;
+
+    bacnet_tag_reader_init(&reader, apdu, apdu_size);
+    if (!bacnet_tag_reader_next(&reader, &item) || !item.tag.opening) {
+        return BACNET_STATUS_ERROR;
+    }
+    start = bacnet_tag_reader_offset(&reader);
+    while (bacnet_tag_reader_next(&reader, &item)) {
+        if (reader.depth == 0) {
+            return (int)(item.offset - start);
+        }
+    }
+
+    return BACNET_STATUS_ERROR;
+}
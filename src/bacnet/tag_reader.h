@@ -0,0 +1,84 @@
+/**
+ * @file
+ * @brief API for a streaming, allocation-free BACnet tag reader
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#ifndef BACNET_TAG_READER_H
+#define BACNET_TAG_READER_H
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+/* BACnet Stack defines - first */
+#include "bacnet/bacdef.h"
+/* BACnet Stack API */
+#include "bacnet/bacdcode.h"
+
+/**
+ * A cursor over an APDU buffer which returns one tag at a time.
+ * The reader never copies or allocates - primitive values are returned
+ * as a span that points back into the APDU buffer.
+ */
+typedef struct BACnet_Tag_Reader {
+    uint8_t *apdu;
+    uint32_t apdu_size;
+    uint32_t offset;
+    /* number of opening tags not yet closed */
+    uint16_t depth;
+    /* set when the buffer was malformed; sticky until re-init */
+    bool error : 1;
+} BACNET_TAG_READER;
+
+/**
+ * One element returned from the tag reader.  For an opening or
+ * closing tag, data is NULL and data_len is zero.  For a primitive,
+ * data points to the contents octets inside the APDU buffer.
+ * Note: application tagged BOOLEAN has its value in tag.len_value_type
+ * and no contents octets.
+ */
+typedef struct BACnet_Tag_Reader_Item {
+    BACNET_TAG tag;
+    /* offset of the tag in the APDU buffer */
+    uint32_t offset;
+    /* number of octets used by the tag (header) */
+    uint32_t tag_len;
+    /* borrowed contents octets of a primitive value */
+    uint8_t *data;
+    uint32_t data_len;
+    /* nesting depth where the tag was found */
+    uint16_t depth;
+} BACNET_TAG_READER_ITEM;
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+BACNET_STACK_EXPORT
+void bacnet_tag_reader_init(
+    BACNET_TAG_READER *reader, uint8_t *apdu, uint32_t apdu_size);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_peek(
+    const BACNET_TAG_READER *reader, BACNET_TAG_READER_ITEM *item);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_next(
+    BACNET_TAG_READER *reader, BACNET_TAG_READER_ITEM *item);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_skip(BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_skip_to_closing(BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_done(const BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+bool bacnet_tag_reader_error(const BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+uint32_t bacnet_tag_reader_offset(const BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+uint32_t bacnet_tag_reader_remaining(const BACNET_TAG_READER *reader);
+BACNET_STACK_EXPORT
+int bacnet_tag_reader_enclosed_length(uint8_t *apdu, uint32_t apdu_size);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+#endif
@@ -90,24 +90,28 @@ int wpm_decode_object_id(
     return (int)len;
 }
 
-/** Decoding for an object property.
+/** Decoding for an object property, without copying the property value.
  *
  * @param apdu [in] The contents of the APDU buffer.
  * @param apdu_len [in] The length of the APDU buffer.
  * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
+ *  The application_data_len is set, but the application_data is not.
+ * @param value_offset [out] The offset of the property value in the APDU.
  *
  * @return Bytes decoded
  */
-int wpm_decode_object_property(
-    uint8_t *apdu, uint16_t apdu_len, BACNET_WRITE_PROPERTY_DATA *wp_data)
+int wpm_decode_object_property_reference(uint8_t *apdu,
+    uint16_t apdu_len,
+    BACNET_WRITE_PROPERTY_DATA *wp_data,
+    uint16_t *value_offset)
 {
     uint8_t tag_number = 0;
     uint32_t len_value = 0;
     uint32_t enum_value = 0;
     BACNET_UNSIGNED_INTEGER unsigned_value = 0;
-    int len = 0, i = 0, imax = 0;
+    int len = 0, imax = 0;
 
-    if ((apdu) && (apdu_len) && (wp_data)) {
+    if ((apdu) && (apdu_len) && (wp_data) && (value_offset)) {
         wp_data->array_index = BACNET_ARRAY_ALL;
         wp_data->priority = BACNET_MAX_PRIORITY;
         wp_data->application_data_len = 0;
@@ -136,13 +140,11 @@ int wpm_decode_object_property(
             imax = bacnet_enclosed_data_length(&apdu[len], apdu_len - len);
             len++;
             if (imax != BACNET_STATUS_ERROR) {
-                /* copy application data, check max length */
+                /* reference application data, check max length */
                 if (imax > (apdu_len - len)) {
                     imax = (apdu_len - len);
                 }
-                for (i = 0; i < imax; i++) {
-                    wp_data->application_data[i] = apdu[len + i];
-                }
+                *value_offset = (uint16_t)len;
                 wp_data->application_data_len = imax;
                 len += imax;
                 if (len < apdu_len) {
@@ -188,6 +190,30 @@ int wpm_decode_object_property(
     return len;
 }
 
+/** Decoding for an object property.
+ *
+ * @param apdu [in] The contents of the APDU buffer.
+ * @param apdu_len [in] The length of the APDU buffer.
+ * @param wp_data [out] The BACNET_WRITE_PROPERTY_DATA structure.
+ *
+ * @return Bytes decoded
+ */
+int wpm_decode_object_property(
+    uint8_t *apdu, uint16_t apdu_len, BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    int len;
+    uint16_t value_offset = 0;
+
+    len = wpm_decode_object_property_reference(
+        apdu, apdu_len, wp_data, &value_offset);
+    if ((len > 0) && (wp_data->application_data_len > 0)) {
+        memcpy(wp_data->application_data, &apdu[value_offset],
+            (size_t)wp_data->application_data_len);
+    }
+
+    return len;
+}
+
 /** 
  * @brief Init the APDU for encoding.
  * @param apdu [in] The APDU buffer, or NULL for length
@@ -43,6 +43,12 @@ extern "C" {
         uint8_t * apdu,
         uint16_t apdu_len,
         BACNET_WRITE_PROPERTY_DATA * wpdata);
+    BACNET_STACK_EXPORT
+    int wpm_decode_object_property_reference(
+        uint8_t * apdu,
+        uint16_t apdu_len,
+        BACNET_WRITE_PROPERTY_DATA * wpdata,
+        uint16_t * value_offset);
 
     /* encode objects */
     BACNET_STACK_EXPORT
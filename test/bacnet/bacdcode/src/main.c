@@ -2006,6 +2006,115 @@ static void test_bacnet_array_encode(void)
     zassert_true(apdu_len == BACNET_STATUS_ABORT, NULL);
 }
 
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bacdcode_tests, test_bacnet_fast_path_decodes)
+#else
+static void test_bacnet_fast_path_decodes(void)
+#endif
+{
+    uint8_t apdu[480] = { 0 };
+    BACNET_TAG tag = { 0 };
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0, test_unsigned_value = 0;
+    uint32_t enum_value = 0, test_enum_value = 0;
+    float real_value = 0.0f, test_real_value = 0.0f;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE, test_object_type = 0;
+    uint32_t object_instance = 0, test_object_instance = 0;
+    BACNET_OBJECT_ID object_list[8] = { 0 };
+    uint32_t count = 0, i;
+    int apdu_len, len, test_len;
+    const uint32_t test_values[] = { 0, 1, 0xFF, 0x100, 0xFFFF, 0x10000,
+        0xFFFFFF, 0x1000000, 0xFFFFFFFF };
+    const float test_reals[] = { 0.0f, -1.0f, 3.14159f, 1.0e38f, -1.0e-38f };
+
+    /* verify the fast paths against the generic tag decoder */
+    for (i = 0; i < ARRAY_SIZE(test_values); i++) {
+        apdu_len = encode_application_unsigned(apdu, test_values[i]);
+        zassert_equal(
+            apdu_len, encode_application_unsigned(NULL, test_values[i]),
+            NULL);
+        len = bacnet_unsigned_application_decode(
+            apdu, apdu_len, &unsigned_value);
+        test_len = bacnet_tag_decode(apdu, apdu_len, &tag);
+        test_len += bacnet_unsigned_decode(&apdu[test_len],
+            apdu_len - test_len, tag.len_value_type, &test_unsigned_value);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(unsigned_value, test_unsigned_value, NULL);
+        zassert_equal(unsigned_value, test_values[i], NULL);
+        /* too short */
+        len = bacnet_unsigned_application_decode(
+            apdu, apdu_len - 1, &unsigned_value);
+        zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+        apdu_len = encode_application_enumerated(apdu, test_values[i]);
+        len = bacnet_enumerated_application_decode(
+            apdu, apdu_len, &enum_value);
+        test_len = bacnet_tag_decode(apdu, apdu_len, &tag);
+        test_len += bacnet_enumerated_decode(&apdu[test_len],
+            apdu_len - test_len, tag.len_value_type, &test_enum_value);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(enum_value, test_enum_value, NULL);
+        zassert_equal(enum_value, test_values[i], NULL);
+        /* wrong tag */
+        len = bacnet_real_application_decode(apdu, apdu_len, &real_value);
+        zassert_equal(len, 0, NULL);
+    }
+    for (i = 0; i < ARRAY_SIZE(test_reals); i++) {
+        apdu_len = encode_application_real(apdu, test_reals[i]);
+        zassert_equal(apdu_len, 5, NULL);
+        zassert_equal(
+            apdu_len, encode_application_real(NULL, test_reals[i]), NULL);
+        len = bacnet_real_application_decode(apdu, apdu_len, &real_value);
+        test_len = bacnet_tag_decode(apdu, apdu_len, &tag);
+        test_len += bacnet_real_decode(&apdu[test_len], apdu_len - test_len,
+            tag.len_value_type, &test_real_value);
+        zassert_equal(len, test_len, NULL);
+        zassert_false(islessgreater(real_value, test_real_value), NULL);
+        zassert_false(islessgreater(real_value, test_reals[i]), NULL);
+        len = bacnet_real_application_decode(apdu, apdu_len - 1, &real_value);
+        zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    }
+    for (i = 0; i < ARRAY_SIZE(test_values); i++) {
+        test_object_type = (BACNET_OBJECT_TYPE)(i * 100);
+        test_object_instance = test_values[i] & BACNET_MAX_INSTANCE;
+        apdu_len = encode_application_object_id(
+            apdu, test_object_type, test_object_instance);
+        zassert_equal(apdu_len, 5, NULL);
+        zassert_equal(apdu_len,
+            encode_application_object_id(
+                NULL, test_object_type, test_object_instance),
+            NULL);
+        len = bacnet_object_id_application_decode(
+            apdu, apdu_len, &object_type, &object_instance);
+        zassert_equal(len, apdu_len, NULL);
+        zassert_equal(object_type, test_object_type, NULL);
+        zassert_equal(object_instance, test_object_instance, NULL);
+        len = bacnet_object_id_application_decode(
+            apdu, apdu_len - 1, &object_type, &object_instance);
+        zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+    }
+    /* bulk decode of an Object_List */
+    apdu_len = 0;
+    for (i = 0; i < 6; i++) {
+        apdu_len += encode_application_object_id(
+            &apdu[apdu_len], OBJECT_ANALOG_VALUE, i + 1);
+    }
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 3);
+    len = bacnet_object_id_application_array_decode(
+        apdu, apdu_len, object_list, ARRAY_SIZE(object_list), &count);
+    zassert_equal(len, apdu_len - 1, NULL);
+    zassert_equal(count, 6, NULL);
+    for (i = 0; i < count; i++) {
+        zassert_equal(object_list[i].type, OBJECT_ANALOG_VALUE, NULL);
+        zassert_equal(object_list[i].instance, i + 1, NULL);
+    }
+    len = bacnet_object_id_application_array_decode(
+        apdu, apdu_len, object_list, 2, &count);
+    zassert_equal(len, 10, NULL);
+    zassert_equal(count, 2, NULL);
+    len = bacnet_object_id_application_array_decode(
+        apdu, 7, object_list, ARRAY_SIZE(object_list), &count);
+    zassert_equal(len, BACNET_STATUS_ERROR, NULL);
+}
+
 /**
  * @}
  */
@@ -2045,7 +2154,8 @@ void test_main(void)
         ztest_unit_test(testDateRangeContextDecodes),
         ztest_unit_test(testOctetStringContextDecodes),
         ztest_unit_test(testBACDCodeDouble),
-        ztest_unit_test(test_bacnet_array_encode));
+        ztest_unit_test(test_bacnet_array_encode),
+        ztest_unit_test(test_bacnet_fast_path_decodes));
 
     ztest_run_test_suite(bacdcode_tests);
 }
@@ -226,11 +226,122 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test the foreign device registration with primary and backup BBMDs
+ */
+static void test_Remote_BBMD_Failover(void)
+{
+    BACNET_IP_ADDRESS primary, backup;
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS dest = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    BVLC_REMOTE_BBMD_STATUS status = { 0 };
+    uint8_t mtu[MAX_APDU] = { 0 };
+    uint8_t pdu[MAX_APDU] = { 0 };
+    uint16_t mtu_len = 0;
+    int pdu_len = 0;
+
+    test_setup();
+    bvlc_address_port_from_ascii(&primary, "192.168.0.1", "0xBAC0");
+    bvlc_address_port_from_ascii(&backup, "192.168.0.2", "0xBAC0");
+    bvlc_remote_bbmd_clear();
+    /* by default, a long Time-To-Live is renewed after a short refresh */
+    assert(bvlc_remote_bbmd_refresh() == BVLC_REMOTE_BBMD_REFRESH_SECONDS);
+    bvlc_remote_bbmd_add(&primary, 60000);
+    mtu_len = bvlc_encode_result(
+        &mtu[0], sizeof(mtu), BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_bbmd_disabled_handler(&primary, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(status.registered);
+    assert(status.renew_milliseconds ==
+        BVLC_REMOTE_BBMD_REFRESH_SECONDS * 1000UL);
+    bvlc_remote_bbmd_clear();
+    bvlc_remote_bbmd_refresh_set(0);
+    assert(bvlc_remote_bbmd_refresh() == 0);
+    /* both BBMDs are sent a registration at once */
+    bvlc_remote_bbmd_add(&primary, 60);
+    assert(Test_Sent_Message_Type == BVLC_REGISTER_FOREIGN_DEVICE);
+    assert(!bvlc_address_different(&primary, &Test_Sent_Message_Dest));
+    bvlc_remote_bbmd_add(&backup, 60);
+    assert(Test_Sent_Message_Type == BVLC_REGISTER_FOREIGN_DEVICE);
+    assert(!bvlc_address_different(&backup, &Test_Sent_Message_Dest));
+    assert(bvlc_remote_bbmd_count() == 2);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(status.active);
+    assert(!status.registered);
+    assert(status.result_code == BVLC_RESULT_INVALID);
+    /* the backup answers first, and is used until the primary answers */
+    mtu_len = bvlc_encode_result(
+        &mtu[0], sizeof(mtu), BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_remote_bbmd_timer(20);
+    bvlc_bbmd_disabled_handler(&backup, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(1, &status));
+    assert(status.registered);
+    assert(status.active);
+    assert(status.rtt_milliseconds == 20);
+    bvlc_remote_bbmd_timer(30);
+    bvlc_bbmd_disabled_handler(&primary, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(status.registered);
+    assert(status.active);
+    assert(status.rtt_milliseconds == 50);
+    assert(status.renew_milliseconds == 30000UL);
+    assert(bvlc_remote_bbmd_status(1, &status));
+    assert(!status.active);
+    /* a shorter refresh applies from the next registration */
+    bvlc_remote_bbmd_refresh_set(10);
+    bvlc_remote_bbmd_timer(30000U);
+    assert(Test_Sent_Message_Type == BVLC_REGISTER_FOREIGN_DEVICE);
+    bvlc_bbmd_disabled_handler(&backup, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(1, &status));
+    assert(status.renew_milliseconds == 10000UL);
+    /* the primary does not answer its renewal: fail over to the backup */
+    bvlc_remote_bbmd_timer(BVLC_REMOTE_BBMD_TIMEOUT_MS);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(!status.registered);
+    assert(!status.active);
+    assert(status.result_code == BVLC_RESULT_INVALID);
+    assert(status.renew_milliseconds == 1000UL);
+    assert(bvlc_remote_bbmd_status(1, &status));
+    assert(status.active);
+    dest.net = BACNET_BROADCAST_NETWORK;
+    npdu_encode_npdu_data(&npdu_data, false, MESSAGE_PRIORITY_NORMAL);
+    pdu_len = npdu_encode_pdu(&pdu[0], &dest, &IUT.BACnet_Address, &npdu_data);
+    pdu_len += iam_encode_apdu(&pdu[pdu_len], IUT.Device_ID, MAX_APDU,
+        SEGMENTATION_NONE, BACNET_VENDOR_ID);
+    bvlc_send_pdu(&dest, &npdu_data, pdu, pdu_len);
+    assert(Test_Sent_Message_Type == BVLC_DISTRIBUTE_BROADCAST_TO_NETWORK);
+    assert(!bvlc_address_different(&backup, &Test_Sent_Message_Dest));
+    /* the primary is tried again with a growing delay */
+    bvlc_remote_bbmd_timer(1000U);
+    assert(Test_Sent_Message_Type == BVLC_REGISTER_FOREIGN_DEVICE);
+    assert(!bvlc_address_different(&primary, &Test_Sent_Message_Dest));
+    mtu_len = bvlc_encode_result(
+        &mtu[0], sizeof(mtu), BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK);
+    bvlc_bbmd_disabled_handler(&primary, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(status.result_code == BVLC_RESULT_REGISTER_FOREIGN_DEVICE_NAK);
+    assert(!status.registered);
+    assert(status.renew_milliseconds == 2000UL);
+    /* the primary is used again as soon as it accepts the registration */
+    bvlc_remote_bbmd_timer(2000U);
+    mtu_len = bvlc_encode_result(
+        &mtu[0], sizeof(mtu), BVLC_RESULT_SUCCESSFUL_COMPLETION);
+    bvlc_bbmd_disabled_handler(&primary, &src, &mtu[0], mtu_len);
+    assert(bvlc_remote_bbmd_status(0, &status));
+    assert(status.registered);
+    assert(status.active);
+    bvlc_remote_bbmd_clear();
+    assert(bvlc_remote_bbmd_count() == 0);
+    test_cleanup();
+}
+
 int main(void)
 {
     /* individual tests */
     test_BBMD_Result();
     test_Initiate_Original_Broadcast_NPDU();
+    test_Remote_BBMD_Failover();
 
     return 0;
 }
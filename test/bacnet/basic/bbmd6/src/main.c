@@ -21,6 +21,7 @@
 #include "bacnet/basic/object/device.h"
 #include "bacnet/basic/bbmd6/h_bbmd6.h"
 #include "bacnet/basic/bbmd6/vmac.h"
+#include "bacnet/basic/bbmd6/fdt6.h"
 
 struct device_info_t {
     uint32_t Device_ID;
@@ -305,11 +306,153 @@ static void test_BBMD_Result(void)
     }
 }
 
+/**
+ * @brief Test the VMAC lookup by address, and the aging of the entries
+ */
+static void test_VMAC_Index(void)
+{
+    struct vmac_data vmac = { 0 };
+    uint32_t device_id = 0;
+    uint32_t i = 0;
+    const uint32_t count = 1000;
+
+    VMAC_Init();
+    vmac.mac_len = 18;
+    for (i = 0; i < count; i++) {
+        encode_unsigned32(&vmac.mac[12], i);
+        assert(VMAC_Add(i + 100, &vmac));
+    }
+    assert(VMAC_Count() == count);
+    for (i = 0; i < count; i++) {
+        encode_unsigned32(&vmac.mac[12], i);
+        assert(VMAC_Find_By_Data(&vmac, &device_id));
+        assert(device_id == (i + 100));
+    }
+    for (i = 0; i < count; i += 2) {
+        assert(VMAC_Delete(i + 100));
+    }
+    for (i = 0; i < count; i++) {
+        encode_unsigned32(&vmac.mac[12], i);
+        if (i % 2) {
+            assert(VMAC_Find_By_Data(&vmac, &device_id));
+            assert(device_id == (i + 100));
+        } else {
+            assert(!VMAC_Find_By_Data(&vmac, &device_id));
+        }
+    }
+    /* entries without a lifetime are kept */
+    VMAC_Timer(60);
+    assert(VMAC_Count() == (count / 2));
+    /* entries are deleted when their address is not seen */
+    VMAC_Lifetime_Set(10);
+    encode_unsigned32(&vmac.mac[12], count);
+    assert(VMAC_Add(1, &vmac));
+    VMAC_Timer(5);
+    assert(VMAC_Find_By_Data(&vmac, &device_id));
+    assert(device_id == 1);
+    VMAC_Timer(9);
+    assert(VMAC_Find_By_Key(1) != NULL);
+    VMAC_Timer(1);
+    assert(VMAC_Find_By_Key(1) == NULL);
+    assert(!VMAC_Find_By_Data(&vmac, &device_id));
+    assert(VMAC_Count() == (count / 2));
+    VMAC_Lifetime_Set(0);
+    VMAC_Cleanup();
+}
+
+static unsigned int Test_FDT6_Batches;
+static unsigned int Test_FDT6_Sent;
+
+static void test_FDT6_Send_Batch(BACNET_IP6_ADDRESS *dest[],
+    unsigned int dest_count,
+    uint8_t *mtu,
+    uint16_t mtu_len)
+{
+    unsigned int i;
+
+    assert(dest_count <= FDT6_SEND_BATCH);
+    assert(mtu && (mtu_len == 4));
+    for (i = 0; i < dest_count; i++) {
+        assert(dest[i] != NULL);
+    }
+    Test_FDT6_Batches++;
+    Test_FDT6_Sent += dest_count;
+}
+
+static void test_FDT6(void)
+{
+    BACNET_IP6_FOREIGN_DEVICE_TABLE_ENTRY *entry = NULL;
+    BACNET_IP6_ADDRESS addr = { 0 };
+    uint8_t mtu[4] = { 0 };
+    uint32_t i = 0;
+    const uint32_t count = 1000;
+
+    FDT6_Init();
+    addr.port = 0xBAC0;
+    for (i = 0; i < count; i++) {
+        encode_unsigned32(&addr.address[12], i);
+        /* half of them expire 30 seconds later than the others */
+        assert(FDT6_Add(&addr, (i % 2) ? 90 : 60));
+    }
+    assert(FDT6_Count() == count);
+    for (i = 0; i < count; i++) {
+        encode_unsigned32(&addr.address[12], i);
+        entry = FDT6_Find(&addr);
+        assert(entry != NULL);
+        assert(entry->ttl_seconds == ((i % 2) ? 90 : 60));
+        assert(entry->ttl_seconds_remaining == ((i % 2) ? 120 : 90));
+    }
+    /* renewing a registration does not add an entry */
+    encode_unsigned32(&addr.address[12], 0);
+    assert(FDT6_Add(&addr, 60));
+    assert(FDT6_Count() == count);
+    /* one fan-out is sent in batches, without the originator */
+    Test_FDT6_Batches = 0;
+    Test_FDT6_Sent = 0;
+    assert(FDT6_Send(mtu, sizeof(mtu), &addr, test_FDT6_Send_Batch) ==
+        (count - 1));
+    assert(Test_FDT6_Sent == (count - 1));
+    assert(Test_FDT6_Batches ==
+        (((count - 1) + FDT6_SEND_BATCH - 1) / FDT6_SEND_BATCH));
+    /* expiry */
+    assert(FDT6_Timer(89) == 0);
+    encode_unsigned32(&addr.address[12], 2);
+    entry = FDT6_Find(&addr);
+    assert(entry && (entry->ttl_seconds_remaining == 1));
+    assert(FDT6_Timer(1) == (count / 2));
+    assert(FDT6_Count() == (count / 2));
+    assert(FDT6_Find(&addr) == NULL);
+    assert(FDT6_Timer(29) == 0);
+    encode_unsigned32(&addr.address[12], 1);
+    entry = FDT6_Find(&addr);
+    assert(entry && (entry->ttl_seconds_remaining == 1));
+    /* longer than one turn of the wheel */
+    assert(FDT6_Add(&addr, 100));
+    assert(FDT6_Timer(FDT6_WHEEL_SLOTS + 1) == ((count / 2) - 1));
+    entry = FDT6_Find(&addr);
+    assert(entry && (entry->ttl_seconds_remaining == (130 - 65)));
+    assert(FDT6_Count() == 1);
+    encode_unsigned32(&addr.address[12], count);
+    assert(FDT6_Add(&addr, 60));
+    assert(FDT6_Delete(&addr));
+    assert(!FDT6_Delete(&addr));
+    assert(FDT6_Count() == 1);
+    for (i = 0; i < FDT6_Count(); i++) {
+        entry = FDT6_Entry(i);
+        assert(entry && entry->valid);
+    }
+    assert(FDT6_Entry(FDT6_Count()) == NULL);
+    FDT6_Cleanup();
+    assert(FDT6_Count() == 0);
+}
+
 int main(void)
 {
     test_BBMD_Result();
     test_Execute_Virtual_Address_Resolution();
     test_Initiate_Original_Broadcast_NPDU();
+    test_VMAC_Index();
+    test_FDT6();
 
     return 0;
 }
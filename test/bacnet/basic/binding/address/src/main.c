@@ -200,6 +200,48 @@ static void testAddress(void)
         zassert_equal(count, (MAX_ADDRESS_CACHE - i - 1), NULL);
     }
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(address_tests, testAddressWhoIsHoldoff)
+#else
+static void testAddressWhoIsHoldoff(void)
+#endif
+{
+    BACNET_ADDRESS src;
+    uint32_t device_id = 1234;
+    unsigned max_apdu = 480;
+    uint32_t age = 0;
+
+    address_init();
+    /* no holdoff - always send */
+    address_who_is_holdoff_set(0);
+    zassert_false(address_bind_request(device_id, NULL, NULL), NULL);
+    zassert_true(address_who_is_request(device_id), NULL);
+    zassert_true(address_who_is_request(device_id), NULL);
+    /* bind request outstanding - one Who-Is per holdoff */
+    address_who_is_holdoff_set(10);
+    zassert_true(address_who_is_request(device_id), NULL);
+    zassert_false(address_who_is_request(device_id), NULL);
+    address_cache_timer(9);
+    zassert_false(address_who_is_request(device_id), NULL);
+    address_cache_timer(1);
+    zassert_true(address_who_is_request(device_id), NULL);
+    zassert_false(address_device_age(device_id, &age), NULL);
+    /* bound by an I-Am - fresh binding is reused */
+    set_address(1, &src);
+    address_add(device_id, max_apdu, &src);
+    zassert_true(address_device_age(device_id, &age), NULL);
+    zassert_equal(age, 0, NULL);
+    zassert_false(address_who_is_request(device_id), NULL);
+    address_cache_timer(10);
+    zassert_true(address_device_age(device_id, &age), NULL);
+    zassert_equal(age, 10, NULL);
+    zassert_true(address_who_is_request(device_id), NULL);
+    /* unknown device */
+    zassert_true(address_who_is_request(device_id + 1), NULL);
+    address_who_is_holdoff_set(0);
+    address_remove_device(device_id);
+}
 /**
  * @}
  */
@@ -212,11 +254,13 @@ void test_main(void)
 #ifdef BACNET_ADDRESS_CACHE_FILE
     ztest_test_suite(
         address_tests, ztest_unit_test(testAddressFile),
-        ztest_unit_test(testAddress));
+        ztest_unit_test(testAddress),
+        ztest_unit_test(testAddressWhoIsHoldoff));
 
     ztest_run_test_suite(address_tests);
 #else
-    ztest_test_suite(address_tests, ztest_unit_test(testAddress));
+    ztest_test_suite(address_tests, ztest_unit_test(testAddress),
+        ztest_unit_test(testAddressWhoIsHoldoff));
 
     ztest_run_test_suite(address_tests);
 #endif
@@ -0,0 +1,590 @@
+/**
+ * @file
+ * @brief Unit test for the COV subscriptions to other devices
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/basic/client/bac-rw.h>
+#include <bacnet/basic/client/bac-cov.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_ID 1234
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the TSM - busy, free, or failed by invoke ID */
+static bool Test_TSM_Available;
+static bool Test_Invoke_ID_Free[256];
+static bool Test_Invoke_ID_Failed[256];
+static uint8_t Test_Invoke_ID;
+/* the device binding */
+static bool Test_Bound;
+static unsigned Test_WhoIs_Count;
+/* the last subscription request */
+static BACNET_SUBSCRIBE_COV_DATA Test_COV_Data;
+static unsigned Test_COV_Subscribe_Count;
+/* the polls */
+static bool Test_Read_Queue_Available;
+static unsigned Test_Read_Count;
+/* the handlers that were installed */
+static confirmed_simple_ack_function Test_Simple_Ack_Handler;
+static error_function Test_Error_Handler;
+static BACNET_COV_NOTIFICATION *Test_Notification;
+static bacnet_read_write_value_callback_t Test_Read_Value_Callback;
+/* the values passed on to the application */
+static unsigned Test_Value_Count;
+
+bool tsm_transaction_available(void)
+{
+    return Test_TSM_Available;
+}
+
+bool tsm_invoke_id_free(uint8_t invokeID)
+{
+    return Test_Invoke_ID_Free[invokeID];
+}
+
+bool tsm_invoke_id_failed(uint8_t invokeID)
+{
+    return Test_Invoke_ID_Failed[invokeID];
+}
+
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    Test_Invoke_ID_Failed[invokeID] = false;
+    Test_Invoke_ID_Free[invokeID] = true;
+}
+
+bool address_bind_request(
+    uint32_t device_id, unsigned *max_apdu, BACNET_ADDRESS *src)
+{
+    (void)device_id;
+    if (!Test_Bound) {
+        return false;
+    }
+    *max_apdu = MAX_APDU;
+    memset(src, 0, sizeof(*src));
+    src->mac_len = 1;
+    src->mac[0] = 1;
+
+    return true;
+}
+
+bool address_who_is_request(uint32_t device_id)
+{
+    (void)device_id;
+
+    return true;
+}
+
+void Send_WhoIs(int32_t low_limit, int32_t high_limit)
+{
+    (void)low_limit;
+    (void)high_limit;
+    Test_WhoIs_Count++;
+}
+
+uint8_t Send_COV_Subscribe(
+    uint32_t device_id, BACNET_SUBSCRIBE_COV_DATA *cov_data)
+{
+    zassert_equal(device_id, TEST_DEVICE_ID, NULL);
+    Test_Invoke_ID++;
+    if (Test_Invoke_ID == 0) {
+        Test_Invoke_ID++;
+    }
+    Test_Invoke_ID_Free[Test_Invoke_ID] = false;
+    Test_Invoke_ID_Failed[Test_Invoke_ID] = false;
+    Test_COV_Data = *cov_data;
+    Test_COV_Subscribe_Count++;
+
+    return Test_Invoke_ID;
+}
+
+bool bacnet_read_property_queue(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index)
+{
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+    (void)array_index;
+    zassert_equal(device_id, TEST_DEVICE_ID, NULL);
+    if (!Test_Read_Queue_Available) {
+        return false;
+    }
+    Test_Read_Count++;
+
+    return true;
+}
+
+void bacnet_read_write_value_callback_set(
+    bacnet_read_write_value_callback_t callback)
+{
+    Test_Read_Value_Callback = callback;
+}
+
+void apdu_set_confirmed_simple_ack_handler(
+    BACNET_CONFIRMED_SERVICE service_choice,
+    confirmed_simple_ack_function pFunction)
+{
+    (void)service_choice;
+    Test_Simple_Ack_Handler = pFunction;
+}
+
+void apdu_set_error_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, error_function pFunction)
+{
+    (void)service_choice;
+    Test_Error_Handler = pFunction;
+}
+
+void handler_ccov_notification_add(BACNET_COV_NOTIFICATION *cb)
+{
+    Test_Notification = cb;
+}
+
+void handler_ucov_notification_add(BACNET_COV_NOTIFICATION *cb)
+{
+    Test_Notification = cb;
+}
+
+/**
+ * @brief Value callback of the application
+ */
+static void test_value_callback(uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    (void)rp_data;
+    (void)value;
+    zassert_equal(device_instance, TEST_DEVICE_ID, NULL);
+    Test_Value_Count++;
+}
+
+/**
+ * @brief Initialize the stubs and the module under test
+ */
+static void test_setup(void)
+{
+    Test_TSM_Available = true;
+    memset(Test_Invoke_ID_Free, 0, sizeof(Test_Invoke_ID_Free));
+    memset(Test_Invoke_ID_Failed, 0, sizeof(Test_Invoke_ID_Failed));
+    Test_Bound = true;
+    Test_WhoIs_Count = 0;
+    Test_COV_Subscribe_Count = 0;
+    Test_Read_Queue_Available = true;
+    Test_Read_Count = 0;
+    Test_Value_Count = 0;
+    bacnet_cov_init();
+    bacnet_cov_value_callback_set(test_value_callback);
+    zassert_not_null(Test_Simple_Ack_Handler, NULL);
+    zassert_not_null(Test_Error_Handler, NULL);
+    zassert_not_null(Test_Notification, NULL);
+    zassert_not_null(Test_Read_Value_Callback, NULL);
+}
+
+/**
+ * @brief Answer the last subscription request
+ * @param accept - true for a Simple ACK, false for an Error
+ */
+static void test_subscribe_answer(bool accept)
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 0;
+
+    zassert_true(address_bind_request(TEST_DEVICE_ID, &max_apdu, &src), NULL);
+    if (accept) {
+        Test_Simple_Ack_Handler(&src, Test_Invoke_ID);
+    } else {
+        Test_Error_Handler(&src, Test_Invoke_ID, ERROR_CLASS_SERVICES,
+            ERROR_CODE_SERVICE_REQUEST_DENIED);
+    }
+    Test_Invoke_ID_Free[Test_Invoke_ID] = true;
+}
+
+/**
+ * @brief Answer the last poll with a REAL value
+ * @param real_value - value of the property
+ */
+static void test_poll_answer(float real_value)
+{
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+
+    rp_data.object_type = OBJECT_ANALOG_INPUT;
+    rp_data.object_instance = 1;
+    rp_data.object_property = PROP_PRESENT_VALUE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = real_value;
+    Test_Read_Value_Callback(TEST_DEVICE_ID, &rp_data, &value);
+}
+
+/**
+ * @brief Advance the clock, run the task, and count the polls
+ * @param seconds - seconds to advance the clock
+ * @return number of polls queued
+ */
+static unsigned test_poll_after(uint32_t seconds)
+{
+    unsigned count = Test_Read_Count;
+
+    bacnet_cov_timer_seconds(seconds);
+    bacnet_cov_task();
+
+    return Test_Read_Count - count;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_cov_tests, testCOVSubscribe)
+#else
+static void testCOVSubscribe(void)
+#endif
+{
+    BACNET_COV_DATA cov_data = { 0 };
+    BACNET_PROPERTY_VALUE value = { 0 };
+
+    test_setup();
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    zassert_false(Test_COV_Data.covSubscribeToProperty, NULL);
+    zassert_equal(Test_COV_Data.lifetime, BACNET_COV_LIFETIME_SECONDS, NULL);
+    zassert_false(bacnet_cov_point_subscribed(TEST_DEVICE_ID,
+                      OBJECT_ANALOG_INPUT, 1, PROP_PRESENT_VALUE),
+        NULL);
+    test_subscribe_answer(true);
+    bacnet_cov_task();
+    zassert_true(bacnet_cov_point_subscribed(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_INPUT, 1, PROP_PRESENT_VALUE),
+        NULL);
+    zassert_equal(bacnet_cov_subscribed_count(), 1, NULL);
+    /* a notification is passed on to the application */
+    cov_data.subscriberProcessIdentifier =
+        Test_COV_Data.subscriberProcessIdentifier;
+    cov_data.initiatingDeviceIdentifier = TEST_DEVICE_ID;
+    cov_data.monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    cov_data.monitoredObjectIdentifier.instance = 1;
+    cov_data.listOfValues = &value;
+    value.propertyIdentifier = PROP_PRESENT_VALUE;
+    value.propertyArrayIndex = BACNET_ARRAY_ALL;
+    value.value.tag = BACNET_APPLICATION_TAG_REAL;
+    Test_Notification->callback(&cov_data);
+    zassert_equal(Test_Value_Count, 1, NULL);
+    /* a notification of another object is not */
+    cov_data.monitoredObjectIdentifier.instance = 2;
+    Test_Notification->callback(&cov_data);
+    zassert_equal(Test_Value_Count, 1, NULL);
+    /* renewed within the second half of the lifetime */
+    bacnet_cov_timer_seconds(BACNET_COV_LIFETIME_SECONDS / 2 - 1);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    bacnet_cov_timer_seconds(BACNET_COV_LIFETIME_SECONDS / 4 + 1);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 2, NULL);
+    /* a COV increment uses SubscribeCOVProperty */
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 2,
+                     PROP_PRESENT_VALUE, 1.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 3, NULL);
+    zassert_true(Test_COV_Data.covSubscribeToProperty, NULL);
+    zassert_true(Test_COV_Data.covIncrementPresent, NULL);
+    /* removing a subscribed point cancels its subscription */
+    zassert_true(bacnet_cov_point_remove(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT,
+                     1, PROP_PRESENT_VALUE),
+        NULL);
+    zassert_equal(Test_COV_Subscribe_Count, 4, NULL);
+    zassert_true(Test_COV_Data.cancellationRequest, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_cov_tests, testCOVBackoff)
+#else
+static void testCOVBackoff(void)
+#endif
+{
+    uint32_t backoff = 10;
+    unsigned i;
+
+    test_setup();
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    for (i = 1; i <= BACNET_COV_SILENT_FAILURES; i++) {
+        zassert_false(bacnet_cov_device_silent(TEST_DEVICE_ID), NULL);
+        /* the request times out */
+        Test_Invoke_ID_Failed[Test_Invoke_ID] = true;
+        bacnet_cov_task();
+        zassert_true(Test_Invoke_ID_Free[Test_Invoke_ID], NULL);
+        zassert_equal(Test_COV_Subscribe_Count, i, NULL);
+        /* and is tried again after a backoff that doubles */
+        bacnet_cov_timer_seconds(backoff - 1);
+        bacnet_cov_task();
+        zassert_equal(Test_COV_Subscribe_Count, i, NULL);
+        bacnet_cov_timer_seconds(1);
+        bacnet_cov_task();
+        zassert_equal(Test_COV_Subscribe_Count, i + 1, NULL);
+        backoff *= 2;
+    }
+    Test_Invoke_ID_Failed[Test_Invoke_ID] = true;
+    bacnet_cov_task();
+    zassert_true(bacnet_cov_device_silent(TEST_DEVICE_ID), NULL);
+    /* the backoff is capped */
+    for (i = 0; i < 16; i++) {
+        bacnet_cov_timer_seconds(900);
+        bacnet_cov_task();
+        Test_Invoke_ID_Failed[Test_Invoke_ID] = true;
+        bacnet_cov_task();
+    }
+    zassert_equal(Test_COV_Subscribe_Count, BACNET_COV_SILENT_FAILURES + 17,
+        NULL);
+    /* an answer clears the silence */
+    bacnet_cov_timer_seconds(900);
+    bacnet_cov_task();
+    test_subscribe_answer(true);
+    bacnet_cov_task();
+    zassert_false(bacnet_cov_device_silent(TEST_DEVICE_ID), NULL);
+    zassert_equal(bacnet_cov_subscribed_count(), 1, NULL);
+    /* a device that is not bound is looked for, and backs off */
+    test_setup();
+    Test_Bound = false;
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_WhoIs_Count, 1, NULL);
+    zassert_equal(Test_COV_Subscribe_Count, 0, NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_WhoIs_Count, 1, NULL);
+    Test_Bound = true;
+    bacnet_cov_timer_seconds(10);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    /* no TSM transaction: nothing is sent until there is one */
+    test_setup();
+    Test_TSM_Available = false;
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 0, NULL);
+    Test_TSM_Available = true;
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_cov_tests, testCOVPolling)
+#else
+static void testCOVPolling(void)
+#endif
+{
+    uint32_t seconds = 0;
+
+    test_setup();
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    /* refused: polled at once */
+    test_subscribe_answer(false);
+    zassert_equal(test_poll_after(0), 1, NULL);
+    zassert_equal(bacnet_cov_polled_count(), 1, NULL);
+    zassert_equal(bacnet_cov_subscribed_count(), 0, NULL);
+    test_poll_answer(1.0f);
+    zassert_equal(Test_Value_Count, 1, NULL);
+    /* an unchanged value doubles the interval */
+    zassert_equal(test_poll_after(BACNET_COV_POLL_MIN_SECONDS - 1), 0, NULL);
+    zassert_equal(test_poll_after(1), 1, NULL);
+    seconds += BACNET_COV_POLL_MIN_SECONDS;
+    test_poll_answer(1.0f);
+    zassert_equal(
+        test_poll_after(2 * BACNET_COV_POLL_MIN_SECONDS - 1), 0, NULL);
+    zassert_equal(test_poll_after(1), 1, NULL);
+    seconds += 2 * BACNET_COV_POLL_MIN_SECONDS;
+    test_poll_answer(1.0f);
+    zassert_equal(
+        test_poll_after(4 * BACNET_COV_POLL_MIN_SECONDS - 1), 0, NULL);
+    zassert_equal(test_poll_after(1), 1, NULL);
+    seconds += 4 * BACNET_COV_POLL_MIN_SECONDS;
+    /* a changed value halves it */
+    test_poll_answer(2.0f);
+    zassert_equal(
+        test_poll_after(2 * BACNET_COV_POLL_MIN_SECONDS - 1), 0, NULL);
+    zassert_equal(test_poll_after(1), 1, NULL);
+    seconds += 2 * BACNET_COV_POLL_MIN_SECONDS;
+    /* a failed read polls at the longest interval */
+    Test_Read_Value_Callback(TEST_DEVICE_ID,
+        &(BACNET_READ_PROPERTY_DATA) { .object_type = OBJECT_ANALOG_INPUT,
+            .object_instance = 1,
+            .object_property = PROP_PRESENT_VALUE,
+            .error_code = ERROR_CODE_UNKNOWN_PROPERTY },
+        NULL);
+    zassert_equal(
+        test_poll_after(BACNET_COV_POLL_MAX_SECONDS - 1), 0, NULL);
+    zassert_equal(test_poll_after(1), 1, NULL);
+    seconds += BACNET_COV_POLL_MAX_SECONDS;
+    test_poll_answer(2.0f);
+    zassert_equal(Test_Value_Count, 6, NULL);
+    /* a full read queue: polled once there is room */
+    Test_Read_Queue_Available = false;
+    zassert_equal(test_poll_after(BACNET_COV_POLL_MAX_SECONDS), 0, NULL);
+    seconds += BACNET_COV_POLL_MAX_SECONDS;
+    Test_Read_Queue_Available = true;
+    zassert_equal(test_poll_after(0), 1, NULL);
+    test_poll_answer(2.0f);
+    /* values of other properties are passed on without a poll */
+    Test_Read_Value_Callback(TEST_DEVICE_ID,
+        &(BACNET_READ_PROPERTY_DATA) { .object_type = OBJECT_DEVICE,
+            .object_instance = TEST_DEVICE_ID,
+            .object_property = PROP_OBJECT_NAME },
+        NULL);
+    zassert_equal(Test_Value_Count, 8, NULL);
+    /* the refused subscription is offered again later */
+    zassert_true(seconds < BACNET_COV_REFUSED_RETRY_SECONDS, NULL);
+    bacnet_cov_timer_seconds(BACNET_COV_REFUSED_RETRY_SECONDS - seconds);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 2, NULL);
+    zassert_equal(bacnet_cov_polled_count(), 0, NULL);
+    test_subscribe_answer(true);
+    bacnet_cov_task();
+    zassert_equal(bacnet_cov_subscribed_count(), 1, NULL);
+    /* a late poll value does not change the subscribed point */
+    test_poll_answer(3.0f);
+    zassert_equal(bacnet_cov_subscribed_count(), 1, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_cov_tests, testCOVPoints)
+#else
+static void testCOVPoints(void)
+#endif
+{
+    unsigned i;
+
+    test_setup();
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID,
+                         OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE, 0.0f),
+            NULL);
+    }
+    zassert_equal(bacnet_cov_point_count(), BACNET_COV_POINT_MAX, NULL);
+    /* existing points are found, new ones do not fit */
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID,
+                         OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE, 0.0f),
+            NULL);
+    }
+    zassert_false(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT,
+                      BACNET_COV_POINT_MAX, PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    zassert_false(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                      PROP_OUT_OF_SERVICE, 0.0f),
+        NULL);
+    zassert_equal(bacnet_cov_point_count(), BACNET_COV_POINT_MAX, NULL);
+    /* remove every other point, from the middle of the hash chains */
+    for (i = 0; i < BACNET_COV_POINT_MAX; i += 2) {
+        zassert_true(bacnet_cov_point_remove(TEST_DEVICE_ID,
+                         OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE),
+            NULL);
+        zassert_false(bacnet_cov_point_remove(TEST_DEVICE_ID,
+                          OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE),
+            NULL);
+    }
+    zassert_equal(bacnet_cov_point_count(), BACNET_COV_POINT_MAX / 2, NULL);
+    /* the rest are still found */
+    for (i = 1; i < BACNET_COV_POINT_MAX; i += 2) {
+        zassert_true(bacnet_cov_point_remove(TEST_DEVICE_ID,
+                         OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE),
+            NULL);
+    }
+    zassert_equal(bacnet_cov_point_count(), 0, NULL);
+    /* the slots are used again */
+    for (i = 0; i < BACNET_COV_POINT_MAX; i++) {
+        zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID,
+                         OBJECT_BINARY_INPUT, i, PROP_PRESENT_VALUE, 0.0f),
+            NULL);
+    }
+    zassert_equal(bacnet_cov_point_count(), BACNET_COV_POINT_MAX, NULL);
+    zassert_false(bacnet_cov_point_add(BACNET_MAX_INSTANCE,
+                      OBJECT_ANALOG_INPUT, 1, PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_cov_tests, testCOVRemovePending)
+#else
+static void testCOVRemovePending(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+    unsigned max_apdu = 0;
+    uint8_t invoke_id;
+
+    test_setup();
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 1, NULL);
+    invoke_id = Test_Invoke_ID;
+    /* removed while its subscription is in flight */
+    zassert_true(bacnet_cov_point_remove(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT,
+                     1, PROP_PRESENT_VALUE),
+        NULL);
+    zassert_true(Test_COV_Data.cancellationRequest, NULL);
+    /* a new point takes over the slot */
+    zassert_true(bacnet_cov_point_add(TEST_DEVICE_ID, OBJECT_ANALOG_INPUT, 2,
+                     PROP_PRESENT_VALUE, 0.0f),
+        NULL);
+    bacnet_cov_task();
+    zassert_equal(Test_COV_Subscribe_Count, 3, NULL);
+    /* the late answer of the removed point is not taken as its own */
+    zassert_true(address_bind_request(TEST_DEVICE_ID, &max_apdu, &src), NULL);
+    Test_Simple_Ack_Handler(&src, invoke_id);
+    Test_Invoke_ID_Free[invoke_id] = true;
+    bacnet_cov_task();
+    zassert_false(bacnet_cov_point_subscribed(TEST_DEVICE_ID,
+                      OBJECT_ANALOG_INPUT, 2, PROP_PRESENT_VALUE),
+        NULL);
+    zassert_equal(bacnet_cov_subscribed_count(), 0, NULL);
+    test_subscribe_answer(true);
+    bacnet_cov_task();
+    zassert_true(bacnet_cov_point_subscribed(TEST_DEVICE_ID,
+                     OBJECT_ANALOG_INPUT, 2, PROP_PRESENT_VALUE),
+        NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_cov_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bac_cov_tests, ztest_unit_test(testCOVSubscribe),
+        ztest_unit_test(testCOVBackoff), ztest_unit_test(testCOVPolling),
+        ztest_unit_test(testCOVPoints), ztest_unit_test(testCOVRemovePending));
+
+    ztest_run_test_suite(bac_cov_tests);
+}
+#endif
@@ -0,0 +1,418 @@
+/**
+ * @file
+ * @brief Unit test for the discovery of the devices and their objects
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/sys/mstimer.h>
+#include <bacnet/basic/client/bac-rw.h>
+#include <bacnet/basic/client/bac-discover.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_ID 1234
+#define TEST_DEVICE_ID_2 5678
+
+/* the test clock */
+static unsigned long Test_Milliseconds;
+/* the last read request that was queued to each device */
+typedef struct test_request_t {
+    BACNET_OBJECT_TYPE object_type;
+    uint32_t object_instance;
+    BACNET_PROPERTY_ID object_property;
+    uint32_t array_index;
+} TEST_REQUEST;
+static TEST_REQUEST Test_Request[2];
+static uint32_t Test_Read_Device_ID;
+static unsigned Test_Read_Count;
+/* the callback that the replies are given to */
+static bacnet_read_write_value_callback_t Test_Read_Value_Callback;
+/* the devices whose discovery is done */
+static unsigned Test_Done_Count;
+static uint32_t Test_Done_Device_ID;
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+void Send_WhoIs_To_Network(
+    BACNET_ADDRESS *target_address, int32_t low_limit, int32_t high_limit)
+{
+    (void)target_address;
+    (void)low_limit;
+    (void)high_limit;
+}
+
+/**
+ * @brief Get the last read request that was queued to a device
+ */
+static TEST_REQUEST *test_request(uint32_t device_id)
+{
+    zassert_true(
+        (device_id == TEST_DEVICE_ID) || (device_id == TEST_DEVICE_ID_2), NULL);
+
+    return &Test_Request[(device_id == TEST_DEVICE_ID) ? 0 : 1];
+}
+
+bool bacnet_read_property_queue(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index)
+{
+    TEST_REQUEST *request = test_request(device_id);
+
+    request->object_type = object_type;
+    request->object_instance = object_instance;
+    request->object_property = object_property;
+    request->array_index = array_index;
+    Test_Read_Device_ID = device_id;
+    Test_Read_Count++;
+
+    return true;
+}
+
+void bacnet_read_write_task(void)
+{
+}
+
+void bacnet_read_write_init(void)
+{
+}
+
+bool bacnet_read_write_busy(void)
+{
+    /* one request for each run of the discovery task */
+    return Test_Read_Count > 0;
+}
+
+void bacnet_read_write_value_callback_set(
+    bacnet_read_write_value_callback_t callback)
+{
+    Test_Read_Value_Callback = callback;
+}
+
+void bacnet_read_write_device_callback_set(
+    bacnet_read_write_device_callback_t callback)
+{
+    (void)callback;
+}
+
+void bacnet_read_write_vendor_id_filter_set(uint16_t vendor_id)
+{
+    (void)vendor_id;
+}
+
+uint16_t bacnet_read_write_vendor_id_filter(void)
+{
+    return 0;
+}
+
+void bacnet_read_write_concurrency_set(unsigned count)
+{
+    (void)count;
+}
+
+void bacnet_read_write_device_concurrency_set(unsigned count)
+{
+    (void)count;
+}
+
+/**
+ * @brief Count the devices whose discovery is done
+ */
+static void test_device_done(uint32_t device_id)
+{
+    Test_Done_Device_ID = device_id;
+    Test_Done_Count++;
+}
+
+/**
+ * @brief Run the discovery task, and check the read request it queued
+ * @param device_id - device that is expected to be read
+ * @param object_property - property that is expected to be read
+ */
+static void test_read_expect(
+    uint32_t device_id, BACNET_PROPERTY_ID object_property)
+{
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Read_Count, 1, NULL);
+    zassert_equal(Test_Read_Device_ID, device_id, NULL);
+    zassert_equal(test_request(device_id)->object_property, object_property,
+        NULL);
+}
+
+/**
+ * @brief Reply to the last read request of a device with an error
+ * @param device_id - device that replies
+ * @param error_code - the error of the reply, for example
+ *  ERROR_CODE_ABORT_TSM_TIMEOUT when no reply came back
+ */
+static void test_reply_error(uint32_t device_id, BACNET_ERROR_CODE error_code)
+{
+    TEST_REQUEST *request = test_request(device_id);
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+
+    rp_data.object_type = request->object_type;
+    rp_data.object_instance = request->object_instance;
+    rp_data.object_property = request->object_property;
+    rp_data.array_index = request->array_index;
+    rp_data.error_class = ERROR_CLASS_PROPERTY;
+    rp_data.error_code = error_code;
+    Test_Read_Value_Callback(device_id, &rp_data, NULL);
+}
+
+/**
+ * @brief Reply to the last read request of a device with a value: the
+ *  object list of the device itself, or else a character string
+ * @param device_id - device that replies
+ */
+static void test_reply_value(uint32_t device_id)
+{
+    TEST_REQUEST *request = test_request(device_id);
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_CHARACTER_STRING char_string = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    if (request->object_property == PROP_OBJECT_LIST) {
+        len = encode_application_object_id(apdu, OBJECT_DEVICE, device_id);
+    } else {
+        characterstring_init_ansi(&char_string, "value");
+        len = encode_application_character_string(apdu, &char_string);
+    }
+    zassert_true(len > 0, NULL);
+    zassert_true(bacapp_decode_application_data(apdu, len, &value) > 0, NULL);
+    rp_data.object_type = request->object_type;
+    rp_data.object_instance = request->object_instance;
+    rp_data.object_property = request->object_property;
+    rp_data.array_index = request->array_index;
+    rp_data.application_data = apdu;
+    rp_data.application_data_len = len;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    Test_Read_Value_Callback(device_id, &rp_data, &value);
+}
+
+/**
+ * @brief Start the discovery module with no devices
+ */
+static void test_setup(void)
+{
+    bacnet_discover_seconds_set(60);
+    bacnet_discover_init();
+    bacnet_discover_device_done_callback_set(test_device_done);
+    Test_Done_Count = 0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_discover_tests, testDiscoverReadPropertyOnly)
+#else
+static void testDiscoverReadPropertyOnly(void)
+#endif
+{
+    const uint32_t device_id = TEST_DEVICE_ID;
+    unsigned i;
+
+    test_setup();
+    bacnet_discover_device_add(device_id, MAX_APDU, 0, 0);
+    zassert_false(bacnet_discover_devices_done(), NULL);
+    test_read_expect(device_id, PROP_OBJECT_LIST);
+    zassert_equal(test_request(device_id)->array_index, BACNET_ARRAY_ALL, NULL);
+    test_reply_value(device_id);
+    test_read_expect(device_id, PROP_ALL);
+    /* no ReadPropertyMultiple: read one property at a time */
+    test_reply_error(device_id, ERROR_CODE_REJECT_UNRECOGNIZED_SERVICE);
+    test_read_expect(device_id, PROP_OBJECT_NAME);
+    /* no reply is not an unknown property: read it again */
+    test_reply_error(device_id, ERROR_CODE_ABORT_TSM_TIMEOUT);
+    test_read_expect(device_id, PROP_OBJECT_NAME);
+    test_reply_value(device_id);
+    test_read_expect(device_id, PROP_OBJECT_TYPE);
+    /* an unknown property: move on to the next one */
+    test_reply_error(device_id, ERROR_CODE_UNKNOWN_PROPERTY);
+    test_read_expect(device_id, PROP_DESCRIPTION);
+    /* still no reply after the retries: move on to the next one */
+    for (i = 0; i < 3; i++) {
+        test_reply_error(device_id, ERROR_CODE_TIMEOUT);
+        test_read_expect(device_id, PROP_DESCRIPTION);
+    }
+    test_reply_error(device_id, ERROR_CODE_ABORT_TSM_TIMEOUT);
+    test_read_expect(device_id, PROP_PRESENT_VALUE);
+    /* the other properties are unknown, up to the last one */
+    for (i = 0; i < 20; i++) {
+        if (test_request(device_id)->object_property ==
+            PROP_PROTOCOL_REVISION) {
+            break;
+        }
+        test_reply_error(device_id, ERROR_CODE_UNKNOWN_PROPERTY);
+        Test_Read_Count = 0;
+        bacnet_discover_task();
+        zassert_equal(Test_Read_Count, 1, NULL);
+    }
+    zassert_equal(test_request(device_id)->object_property,
+        PROP_PROTOCOL_REVISION, NULL);
+    zassert_equal(Test_Done_Count, 0, NULL);
+    /* the last property of the last object is also read again */
+    test_reply_error(device_id, ERROR_CODE_ABORT_TSM_TIMEOUT);
+    test_read_expect(device_id, PROP_PROTOCOL_REVISION);
+    test_reply_value(device_id);
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Read_Count, 0, NULL);
+    zassert_equal(Test_Done_Count, 1, NULL);
+    zassert_equal(Test_Done_Device_ID, device_id, NULL);
+    zassert_false(bacnet_discover_device_failed(device_id), NULL);
+    zassert_equal(bacnet_discover_device_done_count(device_id), 1, NULL);
+    zassert_true(bacnet_discover_devices_done(), NULL);
+    zassert_equal(bacnet_discover_object_property_count(
+                      device_id, OBJECT_DEVICE, device_id),
+        2, NULL);
+    bacnet_discover_cleanup();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_discover_tests, testDiscoverDone)
+#else
+static void testDiscoverDone(void)
+#endif
+{
+    test_setup();
+    /* the first device does not reply to its object list */
+    bacnet_discover_device_add(TEST_DEVICE_ID, MAX_APDU, 0, 0);
+    test_read_expect(TEST_DEVICE_ID, PROP_OBJECT_LIST);
+    bacnet_discover_device_add(TEST_DEVICE_ID_2, MAX_APDU, 0, 0);
+    zassert_equal(bacnet_discover_device_count(), 2, NULL);
+    test_reply_error(TEST_DEVICE_ID, ERROR_CODE_ABORT_TSM_TIMEOUT);
+    test_read_expect(TEST_DEVICE_ID_2, PROP_OBJECT_LIST);
+    test_read_expect(TEST_DEVICE_ID, PROP_OBJECT_LIST);
+    zassert_equal(test_request(TEST_DEVICE_ID)->array_index, 0, NULL);
+    test_reply_error(TEST_DEVICE_ID, ERROR_CODE_ABORT_TSM_TIMEOUT);
+    zassert_equal(Test_Done_Count, 1, NULL);
+    zassert_equal(Test_Done_Device_ID, TEST_DEVICE_ID, NULL);
+    zassert_true(bacnet_discover_device_failed(TEST_DEVICE_ID), NULL);
+    zassert_equal(bacnet_discover_device_done_count(TEST_DEVICE_ID), 0, NULL);
+    /* the second device is still waiting for its first discovery */
+    zassert_false(bacnet_discover_devices_done(), NULL);
+    test_reply_value(TEST_DEVICE_ID_2);
+    test_read_expect(TEST_DEVICE_ID_2, PROP_ALL);
+    test_reply_value(TEST_DEVICE_ID_2);
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Done_Count, 2, NULL);
+    zassert_equal(Test_Done_Device_ID, TEST_DEVICE_ID_2, NULL);
+    zassert_false(bacnet_discover_device_failed(TEST_DEVICE_ID_2), NULL);
+    zassert_equal(
+        bacnet_discover_device_done_count(TEST_DEVICE_ID_2), 1, NULL);
+    zassert_true(bacnet_discover_devices_done(), NULL);
+    /* nothing more until the devices are discovered again */
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Read_Count, 0, NULL);
+    /* the failed device is still failed until it replies */
+    Test_Milliseconds += 60UL * 1000UL;
+    /* the devices are due again, and start at the next run */
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Read_Count, 0, NULL);
+    test_read_expect(TEST_DEVICE_ID, PROP_OBJECT_LIST);
+    zassert_true(bacnet_discover_device_failed(TEST_DEVICE_ID), NULL);
+    zassert_true(bacnet_discover_devices_done(), NULL);
+    test_reply_value(TEST_DEVICE_ID);
+    test_read_expect(TEST_DEVICE_ID_2, PROP_OBJECT_LIST);
+    test_read_expect(TEST_DEVICE_ID, PROP_ALL);
+    test_reply_value(TEST_DEVICE_ID);
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Done_Count, 3, NULL);
+    zassert_false(bacnet_discover_device_failed(TEST_DEVICE_ID), NULL);
+    zassert_equal(bacnet_discover_device_done_count(TEST_DEVICE_ID), 1, NULL);
+    /* a device discovered again is counted again */
+    test_reply_value(TEST_DEVICE_ID_2);
+    test_read_expect(TEST_DEVICE_ID_2, PROP_ALL);
+    test_reply_value(TEST_DEVICE_ID_2);
+    Test_Read_Count = 0;
+    bacnet_discover_task();
+    zassert_equal(Test_Done_Count, 4, NULL);
+    zassert_equal(
+        bacnet_discover_device_done_count(TEST_DEVICE_ID_2), 2, NULL);
+    /* an unknown device */
+    zassert_equal(bacnet_discover_device_done_count(0), 0, NULL);
+    zassert_false(bacnet_discover_device_failed(0), NULL);
+    bacnet_discover_cleanup();
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_discover_tests, testDiscoverObjectList)
+#else
+static void testDiscoverObjectList(void)
+#endif
+{
+    const uint32_t device_id = TEST_DEVICE_ID;
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    BACNET_OBJECT_ID object_id = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len = 0;
+    unsigned i;
+
+    test_setup();
+    bacnet_discover_device_add(device_id, MAX_APDU, 0, 0);
+    test_read_expect(device_id, PROP_OBJECT_LIST);
+    /* a whole list, longer than one bulk decode */
+    len += encode_application_object_id(&apdu[len], OBJECT_DEVICE, device_id);
+    for (i = 1; i < 40; i++) {
+        len += encode_application_object_id(
+            &apdu[len], OBJECT_ANALOG_VALUE, i);
+    }
+    zassert_true(bacapp_decode_application_data(apdu, len, &value) > 0, NULL);
+    rp_data.object_type = OBJECT_DEVICE;
+    rp_data.object_instance = device_id;
+    rp_data.object_property = PROP_OBJECT_LIST;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = apdu;
+    rp_data.application_data_len = len;
+    rp_data.error_code = ERROR_CODE_SUCCESS;
+    Test_Read_Value_Callback(device_id, &rp_data, &value);
+    zassert_equal(bacnet_discover_device_object_count(device_id), 40, NULL);
+    /* the object list is kept in object type and instance order */
+    for (i = 0; i < 39; i++) {
+        zassert_true(bacnet_discover_device_object_identifier(
+                         device_id, i, &object_id),
+            NULL);
+        zassert_equal(object_id.type, OBJECT_ANALOG_VALUE, NULL);
+        zassert_equal(object_id.instance, i + 1, NULL);
+    }
+    zassert_true(
+        bacnet_discover_device_object_identifier(device_id, 39, &object_id),
+        NULL);
+    zassert_equal(object_id.type, OBJECT_DEVICE, NULL);
+    zassert_equal(object_id.instance, device_id, NULL);
+    bacnet_discover_cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_discover_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bac_discover_tests,
+        ztest_unit_test(testDiscoverReadPropertyOnly),
+        ztest_unit_test(testDiscoverDone),
+        ztest_unit_test(testDiscoverObjectList));
+
+    ztest_run_test_suite(bac_discover_tests);
+}
+#endif
@@ -0,0 +1,642 @@
+/**
+ * @file
+ * @brief Unit test for reading and writing the properties of other devices
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/abort.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/reject.h>
+#include <bacnet/rp.h>
+#include <bacnet/basic/services.h>
+#include <bacnet/basic/binding/address.h>
+#include <bacnet/basic/tsm/tsm.h>
+#include <bacnet/basic/client/bac-rw.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_APDU_TIMEOUT 3000
+#define TEST_DEVICE_MAX 4
+
+/* the clock */
+static unsigned long Test_Milliseconds;
+/* the TSM - free, or failed by invoke ID */
+static bool Test_TSM_Available;
+static bool Test_Invoke_ID_Free[256];
+static bool Test_Invoke_ID_Failed[256];
+static uint32_t Test_Invoke_ID_Device[256];
+static uint8_t Test_Invoke_ID;
+/* the device binding */
+static bool Test_Bound;
+static unsigned Test_WhoIs_Count;
+/* the requests sent and in progress, in total and per device */
+static unsigned Test_Read_Count;
+static unsigned Test_Write_Count;
+static unsigned Test_Pending[TEST_DEVICE_MAX];
+static unsigned Test_Pending_Max[TEST_DEVICE_MAX];
+static unsigned Test_Pending_Total;
+static unsigned Test_Pending_Total_Max;
+/* the handlers that were installed */
+static confirmed_ack_function Test_Read_Property_Ack_Handler;
+static confirmed_simple_ack_function Test_Simple_Ack_Handler;
+static error_function Test_Error_Handler;
+static abort_function Test_Abort_Handler;
+static reject_function Test_Reject_Handler;
+/* the values and errors passed on to the application */
+static unsigned Test_Value_Count;
+static unsigned Test_Error_Count;
+static uint32_t Test_Value_Device_ID;
+static BACNET_READ_PROPERTY_DATA Test_Value_Data;
+static float Test_Value_Real;
+
+unsigned long mstimer_now(void)
+{
+    return Test_Milliseconds;
+}
+
+uint16_t apdu_timeout(void)
+{
+    return TEST_APDU_TIMEOUT;
+}
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 260001;
+}
+
+void apdu_set_unconfirmed_handler(
+    BACNET_UNCONFIRMED_SERVICE service_choice, unconfirmed_function pFunction)
+{
+    (void)service_choice;
+    (void)pFunction;
+}
+
+void apdu_set_confirmed_ack_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, confirmed_ack_function pFunction)
+{
+    if (service_choice == SERVICE_CONFIRMED_READ_PROPERTY) {
+        Test_Read_Property_Ack_Handler = pFunction;
+    }
+}
+
+void apdu_set_confirmed_simple_ack_handler(
+    BACNET_CONFIRMED_SERVICE service_choice,
+    confirmed_simple_ack_function pFunction)
+{
+    (void)service_choice;
+    Test_Simple_Ack_Handler = pFunction;
+}
+
+void apdu_set_error_handler(
+    BACNET_CONFIRMED_SERVICE service_choice, error_function pFunction)
+{
+    (void)service_choice;
+    Test_Error_Handler = pFunction;
+}
+
+void apdu_set_abort_handler(abort_function pFunction)
+{
+    Test_Abort_Handler = pFunction;
+}
+
+void apdu_set_reject_handler(reject_function pFunction)
+{
+    Test_Reject_Handler = pFunction;
+}
+
+void address_init(void)
+{
+}
+
+void address_own_device_id_set(uint32_t own_id)
+{
+    (void)own_id;
+}
+
+void address_cache_timer(uint16_t uSeconds)
+{
+    (void)uSeconds;
+}
+
+void address_add_binding(
+    uint32_t device_id, unsigned max_apdu, BACNET_ADDRESS *src)
+{
+    (void)device_id;
+    (void)max_apdu;
+    (void)src;
+}
+
+/**
+ * @brief Get the address of a test device
+ * @param device_id - ID of the device
+ * @param src - address of the device
+ */
+static void test_device_address(uint32_t device_id, BACNET_ADDRESS *src)
+{
+    memset(src, 0, sizeof(*src));
+    src->mac_len = 1;
+    src->mac[0] = (uint8_t)device_id;
+}
+
+bool address_bind_request(
+    uint32_t device_id, unsigned *max_apdu, BACNET_ADDRESS *src)
+{
+    if (!Test_Bound) {
+        return false;
+    }
+    if (max_apdu) {
+        *max_apdu = MAX_APDU;
+    }
+    if (src) {
+        test_device_address(device_id, src);
+    }
+
+    return true;
+}
+
+bool address_who_is_request(uint32_t device_id)
+{
+    (void)device_id;
+
+    return true;
+}
+
+void Send_WhoIs(int32_t low_limit, int32_t high_limit)
+{
+    (void)low_limit;
+    (void)high_limit;
+    Test_WhoIs_Count++;
+}
+
+bool tsm_invoke_id_free(uint8_t invokeID)
+{
+    return Test_Invoke_ID_Free[invokeID];
+}
+
+bool tsm_invoke_id_failed(uint8_t invokeID)
+{
+    return Test_Invoke_ID_Failed[invokeID];
+}
+
+void tsm_free_invoke_id(uint8_t invokeID)
+{
+    Test_Invoke_ID_Failed[invokeID] = false;
+    Test_Invoke_ID_Free[invokeID] = true;
+}
+
+/**
+ * @brief Send a confirmed request to a test device
+ * @param device_id - ID of the device
+ * @return invoke ID of the request, or 0 if the TSM is busy
+ */
+static uint8_t test_request_send(uint32_t device_id)
+{
+    zassert_true(device_id < TEST_DEVICE_MAX, NULL);
+    if (!Test_TSM_Available) {
+        return 0;
+    }
+    Test_Invoke_ID++;
+    if (Test_Invoke_ID == 0) {
+        Test_Invoke_ID++;
+    }
+    Test_Invoke_ID_Free[Test_Invoke_ID] = false;
+    Test_Invoke_ID_Failed[Test_Invoke_ID] = false;
+    Test_Invoke_ID_Device[Test_Invoke_ID] = device_id;
+    Test_Pending[device_id]++;
+    if (Test_Pending[device_id] > Test_Pending_Max[device_id]) {
+        Test_Pending_Max[device_id] = Test_Pending[device_id];
+    }
+    Test_Pending_Total++;
+    if (Test_Pending_Total > Test_Pending_Total_Max) {
+        Test_Pending_Total_Max = Test_Pending_Total;
+    }
+
+    return Test_Invoke_ID;
+}
+
+uint8_t Send_Read_Property_Request(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint32_t array_index)
+{
+    uint8_t invoke_id;
+
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+    (void)array_index;
+    invoke_id = test_request_send(device_id);
+    if (invoke_id) {
+        Test_Read_Count++;
+    }
+
+    return invoke_id;
+}
+
+uint8_t Send_Read_Property_Multiple_Request(uint8_t *pdu,
+    size_t max_pdu,
+    uint32_t device_id,
+    BACNET_READ_ACCESS_DATA *read_access_data)
+{
+    (void)pdu;
+    (void)max_pdu;
+    (void)read_access_data;
+
+    return test_request_send(device_id);
+}
+
+uint8_t Send_Write_Property_Request_Data(uint32_t device_id,
+    BACNET_OBJECT_TYPE object_type,
+    uint32_t object_instance,
+    BACNET_PROPERTY_ID object_property,
+    uint8_t *application_data,
+    int application_data_len,
+    uint8_t priority,
+    uint32_t array_index)
+{
+    uint8_t invoke_id;
+
+    (void)object_type;
+    (void)object_instance;
+    (void)object_property;
+    (void)application_data;
+    (void)application_data_len;
+    (void)priority;
+    (void)array_index;
+    invoke_id = test_request_send(device_id);
+    if (invoke_id) {
+        Test_Write_Count++;
+    }
+
+    return invoke_id;
+}
+
+/**
+ * @brief Value callback of the application
+ */
+static void test_value_callback(uint32_t device_instance,
+    BACNET_READ_PROPERTY_DATA *rp_data,
+    BACNET_APPLICATION_DATA_VALUE *value)
+{
+    Test_Value_Device_ID = device_instance;
+    Test_Value_Data = *rp_data;
+    if (value) {
+        zassert_equal(value->tag, BACNET_APPLICATION_TAG_REAL, NULL);
+        Test_Value_Real = value->type.Real;
+        Test_Value_Count++;
+    } else {
+        Test_Error_Count++;
+    }
+}
+
+/**
+ * @brief Initialize the stubs and the module under test
+ */
+static void test_setup(void)
+{
+    Test_Milliseconds = 0;
+    Test_TSM_Available = true;
+    memset(Test_Invoke_ID_Free, 0, sizeof(Test_Invoke_ID_Free));
+    memset(Test_Invoke_ID_Failed, 0, sizeof(Test_Invoke_ID_Failed));
+    Test_Bound = true;
+    Test_WhoIs_Count = 0;
+    Test_Read_Count = 0;
+    Test_Write_Count = 0;
+    memset(Test_Pending, 0, sizeof(Test_Pending));
+    memset(Test_Pending_Max, 0, sizeof(Test_Pending_Max));
+    Test_Pending_Total = 0;
+    Test_Pending_Total_Max = 0;
+    Test_Value_Count = 0;
+    Test_Error_Count = 0;
+    bacnet_read_write_init();
+    bacnet_read_write_value_callback_set(test_value_callback);
+    bacnet_read_write_concurrency_set(1);
+    bacnet_read_write_device_concurrency_set(1);
+    zassert_not_null(Test_Read_Property_Ack_Handler, NULL);
+    zassert_not_null(Test_Simple_Ack_Handler, NULL);
+    zassert_not_null(Test_Error_Handler, NULL);
+    zassert_not_null(Test_Abort_Handler, NULL);
+    zassert_not_null(Test_Reject_Handler, NULL);
+}
+
+/**
+ * @brief End a request, as the TSM does once a reply was handled
+ * @param invoke_id - invoke ID of the request
+ */
+static void test_request_done(uint8_t invoke_id)
+{
+    uint32_t device_id = Test_Invoke_ID_Device[invoke_id];
+
+    zassert_false(Test_Invoke_ID_Free[invoke_id], NULL);
+    Test_Invoke_ID_Free[invoke_id] = true;
+    Test_Pending[device_id]--;
+    Test_Pending_Total--;
+}
+
+/**
+ * @brief Send a ReadProperty-ACK with a REAL value
+ * @param device_id - ID of the device that sends it
+ * @param invoke_id - invoke ID of the ACK
+ * @param real_value - value of the property
+ */
+static void test_read_ack(
+    uint32_t device_id, uint8_t invoke_id, float real_value)
+{
+    BACNET_CONFIRMED_SERVICE_ACK_DATA service_data = { 0 };
+    BACNET_READ_PROPERTY_DATA rp_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint8_t value[8];
+    uint8_t apdu[MAX_APDU];
+    size_t apdu_len;
+
+    rp_data.object_type = OBJECT_ANALOG_INPUT;
+    rp_data.object_instance = 1;
+    rp_data.object_property = PROP_PRESENT_VALUE;
+    rp_data.array_index = BACNET_ARRAY_ALL;
+    rp_data.application_data = value;
+    rp_data.application_data_len = encode_application_real(value, real_value);
+    apdu_len = read_property_ack_service_encode(apdu, sizeof(apdu), &rp_data);
+    zassert_true(apdu_len > 0, NULL);
+    test_device_address(device_id, &src);
+    service_data.invoke_id = invoke_id;
+    Test_Read_Property_Ack_Handler(apdu, (uint16_t)apdu_len, &src,
+        &service_data);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, testReadWriteConcurrency)
+#else
+static void testReadWriteConcurrency(void)
+#endif
+{
+    uint8_t invoke_id;
+    unsigned i;
+
+    test_setup();
+    /* the limits are clamped */
+    bacnet_read_write_concurrency_set(0);
+    zassert_equal(bacnet_read_write_concurrency(), 1, NULL);
+    bacnet_read_write_concurrency_set(BACNET_READ_WRITE_REQUEST_MAX + 1);
+    zassert_equal(
+        bacnet_read_write_concurrency(), BACNET_READ_WRITE_REQUEST_MAX, NULL);
+    bacnet_read_write_device_concurrency_set(0);
+    zassert_equal(bacnet_read_write_device_concurrency(), 1, NULL);
+    /* one at a time by default */
+    bacnet_read_write_concurrency_set(1);
+    zassert_true(bacnet_read_write_idle(), NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, i,
+                         PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+            NULL);
+    }
+    zassert_false(bacnet_read_write_idle(), NULL);
+    for (i = 0; i < 3; i++) {
+        bacnet_read_write_task();
+        bacnet_read_write_task();
+        zassert_equal(Test_Read_Count, i + 1, NULL);
+        test_request_done(Test_Invoke_ID);
+        bacnet_read_write_task();
+    }
+    zassert_true(bacnet_read_write_idle(), NULL);
+    zassert_equal(Test_Pending_Total_Max, 1, NULL);
+    /* four at once, but no more than two to each device */
+    bacnet_read_write_concurrency_set(4);
+    bacnet_read_write_device_concurrency_set(2);
+    for (i = 0; i < 8; i++) {
+        zassert_true(bacnet_read_property_queue(1 + (i % 2),
+                         OBJECT_ANALOG_INPUT, i, PROP_PRESENT_VALUE,
+                         BACNET_ARRAY_ALL),
+            NULL);
+    }
+    zassert_true(bacnet_read_write_busy(), NULL);
+    zassert_false(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 8,
+                      PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    zassert_equal(Test_Pending_Total, 4, NULL);
+    zassert_equal(Test_Pending[1], 2, NULL);
+    zassert_equal(Test_Pending[2], 2, NULL);
+    while (Test_Pending_Total) {
+        /* answer the oldest request in progress */
+        for (invoke_id = 1; invoke_id != 0; invoke_id++) {
+            if (!Test_Invoke_ID_Free[invoke_id] &&
+                (Test_Invoke_ID_Device[invoke_id] != 0)) {
+                break;
+            }
+        }
+        test_request_done(invoke_id);
+        Test_Invoke_ID_Device[invoke_id] = 0;
+        bacnet_read_write_task();
+        bacnet_read_write_task();
+    }
+    zassert_true(bacnet_read_write_idle(), NULL);
+    zassert_equal(Test_Read_Count, 3 + 8, NULL);
+    zassert_equal(Test_Pending_Total_Max, 4, NULL);
+    zassert_equal(Test_Pending_Max[1], 2, NULL);
+    zassert_equal(Test_Pending_Max[2], 2, NULL);
+    /* the next request waits for its device, not for the others */
+    bacnet_read_write_device_concurrency_set(1);
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 2,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    zassert_equal(Test_Pending[1], 1, NULL);
+    zassert_equal(Test_Pending_Total, 1, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, testReadWriteReplyMatching)
+#else
+static void testReadWriteReplyMatching(void)
+#endif
+{
+    uint8_t invoke_id[2];
+
+    test_setup();
+    bacnet_read_write_concurrency_set(2);
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    invoke_id[0] = Test_Invoke_ID;
+    zassert_true(bacnet_read_property_queue(2, OBJECT_ANALOG_INPUT, 1,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    invoke_id[1] = Test_Invoke_ID;
+    zassert_equal(Test_Pending_Total, 2, NULL);
+    /* an ACK from another device with the same invoke ID is ignored */
+    test_read_ack(3, invoke_id[0], 1.0f);
+    zassert_equal(Test_Value_Count, 0, NULL);
+    /* and so is an ACK from the device with another invoke ID */
+    test_read_ack(1, invoke_id[0] + 2, 1.0f);
+    zassert_equal(Test_Value_Count, 0, NULL);
+    /* each ACK reaches its own request */
+    test_read_ack(2, invoke_id[1], 2.0f);
+    zassert_equal(Test_Value_Count, 1, NULL);
+    zassert_equal(Test_Value_Device_ID, 2, NULL);
+    zassert_equal(Test_Value_Real, 2.0f, NULL);
+    zassert_equal(Test_Value_Data.error_code, ERROR_CODE_SUCCESS, NULL);
+    test_read_ack(1, invoke_id[0], 1.0f);
+    zassert_equal(Test_Value_Count, 2, NULL);
+    zassert_equal(Test_Value_Device_ID, 1, NULL);
+    zassert_equal(Test_Value_Real, 1.0f, NULL);
+    test_request_done(invoke_id[0]);
+    test_request_done(invoke_id[1]);
+    bacnet_read_write_task();
+    zassert_true(bacnet_read_write_idle(), NULL);
+    /* a finished request no longer takes replies */
+    test_read_ack(1, invoke_id[0], 3.0f);
+    zassert_equal(Test_Value_Count, 2, NULL);
+    zassert_equal(Test_Error_Count, 0, NULL);
+    /* a write ends with its Simple ACK, without a value */
+    zassert_true(bacnet_write_property_real_queue(1, OBJECT_ANALOG_VALUE, 1,
+                     PROP_PRESENT_VALUE, 5.0f, 8, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    zassert_equal(Test_Write_Count, 1, NULL);
+    test_request_done(Test_Invoke_ID);
+    bacnet_read_write_task();
+    zassert_true(bacnet_read_write_idle(), NULL);
+    zassert_equal(Test_Value_Count, 2, NULL);
+    zassert_equal(Test_Error_Count, 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(bac_rw_tests, testReadWriteErrors)
+#else
+static void testReadWriteErrors(void)
+#endif
+{
+    BACNET_ADDRESS src = { 0 };
+
+    test_setup();
+    test_device_address(1, &src);
+    /* an Error carries its own class and code */
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    Test_Error_Handler(&src, Test_Invoke_ID, ERROR_CLASS_OBJECT,
+        ERROR_CODE_UNKNOWN_OBJECT);
+    test_request_done(Test_Invoke_ID);
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 1, NULL);
+    zassert_equal(Test_Value_Device_ID, 1, NULL);
+    zassert_equal(Test_Value_Data.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(Test_Value_Data.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    zassert_equal(Test_Value_Data.object_type, OBJECT_ANALOG_INPUT, NULL);
+    zassert_equal(Test_Value_Data.object_instance, 7, NULL);
+    zassert_equal(
+        Test_Value_Data.object_property, PROP_PRESENT_VALUE, NULL);
+    /* an Error for another request is ignored */
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    Test_Error_Handler(&src, Test_Invoke_ID + 1, ERROR_CLASS_OBJECT,
+        ERROR_CODE_UNKNOWN_OBJECT);
+    test_request_done(Test_Invoke_ID);
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 1, NULL);
+    /* a Reject and an Abort are converted to error codes */
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    Test_Reject_Handler(
+        &src, Test_Invoke_ID, REJECT_REASON_UNRECOGNIZED_SERVICE);
+    test_request_done(Test_Invoke_ID);
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 2, NULL);
+    zassert_equal(Test_Value_Data.error_code,
+        reject_convert_to_error_code(REJECT_REASON_UNRECOGNIZED_SERVICE),
+        NULL);
+    zassert_true(bacnet_write_property_null_queue(1, OBJECT_ANALOG_VALUE, 1,
+                     PROP_PRESENT_VALUE, 8, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    Test_Abort_Handler(
+        &src, Test_Invoke_ID, ABORT_REASON_SEGMENTATION_NOT_SUPPORTED, true);
+    test_request_done(Test_Invoke_ID);
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 3, NULL);
+    zassert_equal(Test_Value_Data.error_code,
+        abort_convert_to_error_code(ABORT_REASON_SEGMENTATION_NOT_SUPPORTED),
+        NULL);
+    zassert_equal(Test_Value_Data.object_type, OBJECT_ANALOG_VALUE, NULL);
+    /* no reply at all */
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    Test_Invoke_ID_Failed[Test_Invoke_ID] = true;
+    bacnet_read_write_task();
+    zassert_true(Test_Invoke_ID_Free[Test_Invoke_ID], NULL);
+    zassert_equal(Test_Error_Count, 4, NULL);
+    zassert_equal(
+        Test_Value_Data.error_code, ERROR_CODE_ABORT_TSM_TIMEOUT, NULL);
+    /* a device that is not found within the APDU timeout */
+    Test_Bound = false;
+    zassert_true(bacnet_read_property_queue(5, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    zassert_equal(Test_WhoIs_Count, 1, NULL);
+    Test_Milliseconds += TEST_APDU_TIMEOUT;
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 5, NULL);
+    zassert_equal(Test_Value_Device_ID, 5, NULL);
+    zassert_equal(Test_Value_Data.error_code, ERROR_CODE_TIMEOUT, NULL);
+    /* no invoke ID within the APDU timeout */
+    Test_Bound = true;
+    Test_TSM_Available = false;
+    zassert_true(bacnet_read_property_queue(1, OBJECT_ANALOG_INPUT, 7,
+                     PROP_PRESENT_VALUE, BACNET_ARRAY_ALL),
+        NULL);
+    bacnet_read_write_task();
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 5, NULL);
+    Test_Milliseconds += TEST_APDU_TIMEOUT;
+    bacnet_read_write_task();
+    zassert_equal(Test_Error_Count, 6, NULL);
+    zassert_equal(Test_Value_Data.error_code, ERROR_CODE_TIMEOUT, NULL);
+    zassert_true(bacnet_read_write_idle(), NULL);
+    zassert_equal(Test_Value_Count, 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(bac_rw_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(bac_rw_tests, ztest_unit_test(testReadWriteConcurrency),
+        ztest_unit_test(testReadWriteReplyMatching),
+        ztest_unit_test(testReadWriteErrors));
+
+    ztest_run_test_suite(bac_rw_tests);
+}
+#endif
@@ -237,6 +237,47 @@ static void testPresentValue(void)
     zassert_true(Calendar_Delete(instance), NULL);
 }
 
+#ifdef CONFIG_ZTEST_NEW_API
+ZTEST(bacnet_calendar, testDateActive)
+#else
+static void testDateActive(void)
+#endif
+{
+    const uint32_t instance = 1;
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_DATE date;
+    BACNET_TIME time;
+    BACNET_CALENDAR_ENTRY entry = { 0 };
+    BACNET_CALENDAR_ENTRY *value;
+
+    Calendar_Init();
+    zassert_equal(Calendar_Create(instance), instance, NULL);
+    datetime_local(&date, &time, NULL, NULL);
+    zassert_false(Calendar_Date_Active(instance, &date), NULL);
+    /* adding to the Date_List forgets the kept result */
+    entry.tag = BACNET_CALENDAR_DATE;
+    entry.type.Date = date;
+    Calendar_Date_List_Add(instance, &entry);
+    zassert_true(Calendar_Date_Active(instance, &date), NULL);
+    /* encoding the Date_List keeps the result */
+    zassert_true(Calendar_Date_List_Encode(instance, apdu, sizeof(apdu)) > 0,
+        NULL);
+    /* a modified entity is not seen until the result is forgotten */
+    value = Calendar_Date_List_Get(instance, 0);
+    value->type.Date.day++;
+    zassert_true(Calendar_Date_Active(instance, &date), NULL);
+    zassert_false(Calendar_Present_Value(instance), NULL);
+    Calendar_Date_List_Modified(instance);
+    zassert_false(Calendar_Date_Active(instance, &date), NULL);
+    /* another date is checked again */
+    date.day++;
+    zassert_true(Calendar_Date_Active(instance, &date), NULL);
+    /* clearing the Date_List forgets the kept result */
+    zassert_true(Calendar_Date_List_Delete_All(instance), NULL);
+    zassert_false(Calendar_Date_Active(instance, &date), NULL);
+    zassert_true(Calendar_Delete(instance), NULL);
+}
+
 /**
  * @}
  */
@@ -248,7 +289,8 @@ void test_main(void)
 {
     ztest_test_suite(
         calendar_tests, ztest_unit_test(testCalendar),
-        ztest_unit_test(testPresentValue));
+        ztest_unit_test(testPresentValue),
+        ztest_unit_test(testDateActive));
 
     ztest_run_test_suite(calendar_tests);
 }
@@ -135,13 +135,218 @@ static void test_Channel_ReadProperty(void)
     status = Channel_Delete(instance);
     zassert_true(status, NULL);
 }
+
+static unsigned Member_Writes;
+static unsigned Member_Lookup_Writes;
+static BACNET_APPLICATION_TAG Member_Write_Tag[16];
+
+static bool Member_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    int len;
+
+    len = bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    zassert_equal(len, wp_data->application_data_len, NULL);
+    if (Member_Writes < ARRAY_SIZE(Member_Write_Tag)) {
+        Member_Write_Tag[Member_Writes] = value.tag;
+    }
+    Member_Writes++;
+
+    return true;
+}
+
+static bool Member_Lookup_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    Member_Lookup_Writes++;
+
+    return Member_Write_Property(wp_data);
+}
+
+static write_property_function Member_Write_Property_Lookup(
+    BACNET_OBJECT_TYPE object_type)
+{
+    if (object_type == OBJECT_ANALOG_VALUE) {
+        return Member_Lookup_Write_Property;
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Test the members, and the writes of the present-value to them
+ */
+static void test_Channel_Members(void)
+{
+    const uint32_t instance = 124;
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE member = {
+        .objectIdentifier = { OBJECT_ANALOG_VALUE, 1 },
+        .propertyIdentifier = PROP_PRESENT_VALUE,
+        .arrayIndex = BACNET_ARRAY_ALL,
+        .deviceIdentifier = { OBJECT_DEVICE, 1 }
+    };
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE *pMember, *pFirst;
+    BACNET_WRITE_PROPERTY_DATA wpdata = { 0 };
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+    unsigned count, index, m;
+    bool status;
+    int len;
+
+    Channel_Init();
+    Channel_Create(instance);
+    Channel_Write_Property_Internal_Callback_Set(Member_Write_Property);
+    count = Channel_Reference_List_Member_Count(instance);
+    pFirst = Channel_Reference_List_Member_Element(instance, 1);
+    zassert_not_null(pFirst, NULL);
+    /* fill the empty members, and then add more */
+    for (m = 0; m < count + 2; m++) {
+        if (m < 5) {
+            member.objectIdentifier.type = OBJECT_ANALOG_VALUE;
+        } else {
+            member.objectIdentifier.type = OBJECT_BINARY_VALUE;
+        }
+        member.objectIdentifier.instance = m;
+        index = Channel_Reference_List_Member_Element_Add(instance, &member);
+        zassert_equal(index, m + 1, NULL);
+    }
+    zassert_equal(
+        Channel_Reference_List_Member_Count(instance), count + 2, NULL);
+    /* the members do not move when more members are added */
+    zassert_equal(
+        Channel_Reference_List_Member_Element(instance, 1), pFirst, NULL);
+    zassert_equal(pFirst->objectIdentifier.instance, 0, NULL);
+    pMember = Channel_Reference_List_Member_Element(instance, count + 2);
+    zassert_not_null(pMember, NULL);
+    zassert_equal(pMember->objectIdentifier.instance, count + 1, NULL);
+    /* the value is coerced to the datatype of each member */
+    Member_Writes = 0;
+    value.tag = BACNET_APPLICATION_TAG_REAL;
+    value.type.Real = 1.0f;
+    wpdata.object_type = OBJECT_CHANNEL;
+    wpdata.object_instance = instance;
+    wpdata.object_property = PROP_PRESENT_VALUE;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.priority = BACNET_MAX_PRIORITY;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(Member_Writes, count + 2, NULL);
+    for (m = 0; m < Member_Writes; m++) {
+        if (m < 5) {
+            zassert_equal(
+                Member_Write_Tag[m], BACNET_APPLICATION_TAG_REAL, NULL);
+        } else {
+            zassert_equal(
+                Member_Write_Tag[m], BACNET_APPLICATION_TAG_ENUMERATED, NULL);
+        }
+    }
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_SUCCESSFUL, NULL);
+    /* the members of a type with a WriteProperty function are written
+       with it, and the others through the callback */
+    Channel_Write_Property_Lookup_Callback_Set(Member_Write_Property_Lookup);
+    Member_Writes = 0;
+    Member_Lookup_Writes = 0;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(Member_Writes, count + 2, NULL);
+    zassert_equal(Member_Lookup_Writes, 5, NULL);
+    Channel_Write_Property_Lookup_Callback_Set(NULL);
+    Member_Lookup_Writes = 0;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(Member_Lookup_Writes, 0, NULL);
+    /* a member that is not supported fails the write */
+    member.objectIdentifier.type = OBJECT_DEVICE;
+    status = Channel_Reference_List_Member_Element_Set(instance, 1, &member);
+    zassert_true(status, NULL);
+    Member_Writes = 0;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(Member_Writes, count + 1, NULL);
+    zassert_equal(
+        Channel_Write_Status(instance), BACNET_WRITE_STATUS_FAILED, NULL);
+    /* write the whole list of members */
+    member.objectIdentifier.type = OBJECT_MULTI_STATE_VALUE;
+    len = bacapp_encode_device_obj_property_ref(
+        &wpdata.application_data[0], &member);
+    len += bacapp_encode_device_obj_property_ref(
+        &wpdata.application_data[len], &member);
+    wpdata.application_data_len = len;
+    wpdata.object_property = PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    status = Channel_Write_Property(&wpdata);
+    zassert_true(status, NULL);
+    zassert_equal(Channel_Reference_List_Member_Count(instance), 2, NULL);
+    Member_Writes = 0;
+    wpdata.object_property = PROP_PRESENT_VALUE;
+    status = Channel_Present_Value_Set(&wpdata, &value);
+    zassert_true(status, NULL);
+    zassert_equal(Member_Writes, 2, NULL);
+    zassert_equal(
+        Member_Write_Tag[1], BACNET_APPLICATION_TAG_UNSIGNED_INT, NULL);
+    /* array element zero changes the number of members */
+    wpdata.object_property = PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES;
+    wpdata.array_index = 0;
+    wpdata.application_data_len =
+        encode_application_unsigned(wpdata.application_data, 4);
+    status = Channel_Write_Property(&wpdata);
+    zassert_true(status, NULL);
+    zassert_equal(Channel_Reference_List_Member_Count(instance), 4, NULL);
+    pMember = Channel_Reference_List_Member_Element(instance, 4);
+    zassert_not_null(pMember, NULL);
+    zassert_equal(
+        pMember->objectIdentifier.instance, BACNET_MAX_INSTANCE, NULL);
+    /* write one element */
+    wpdata.array_index = 4;
+    wpdata.application_data_len = bacapp_encode_device_obj_property_ref(
+        wpdata.application_data, &member);
+    status = Channel_Write_Property(&wpdata);
+    zassert_true(status, NULL);
+    pMember = Channel_Reference_List_Member_Element(instance, 4);
+    zassert_equal(pMember->objectIdentifier.instance,
+        member.objectIdentifier.instance, NULL);
+    wpdata.array_index = 5;
+    status = Channel_Write_Property(&wpdata);
+    zassert_false(status, NULL);
+    zassert_equal(wpdata.error_code, ERROR_CODE_INVALID_ARRAY_INDEX, NULL);
+    /* an empty list removes every member */
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.application_data_len = 0;
+    status = Channel_Write_Property(&wpdata);
+    zassert_true(status, NULL);
+    zassert_equal(Channel_Reference_List_Member_Count(instance), 0, NULL);
+    wpdata.array_index = 0;
+    status = Channel_Write_Property(&wpdata);
+    zassert_false(status, NULL);
+    /* members can be added up to the limit */
+    for (m = 0; m < CHANNEL_MEMBERS_LIMIT; m++) {
+        index = Channel_Reference_List_Member_Element_Add(instance, &member);
+        zassert_equal(index, m + 1, NULL);
+    }
+    index = Channel_Reference_List_Member_Element_Add(instance, &member);
+    zassert_equal(index, 0, NULL);
+    zassert_equal(Channel_Reference_List_Member_Count(instance),
+        CHANNEL_MEMBERS_LIMIT, NULL);
+    Channel_Write_Property_Internal_Callback_Set(NULL);
+    status = Channel_Delete(instance);
+    zassert_true(status, NULL);
+    /* the members of an unknown object are an unknown object */
+    wpdata.object_property = PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.application_data_len = 0;
+    status = Channel_Write_Property(&wpdata);
+    zassert_false(status, NULL);
+    zassert_equal(wpdata.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(wpdata.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+}
 /**
  * @}
  */
 
 void test_main(void)
 {
-    ztest_test_suite(channel_tests, ztest_unit_test(test_Channel_ReadProperty));
+    ztest_test_suite(channel_tests, ztest_unit_test(test_Channel_ReadProperty),
+        ztest_unit_test(test_Channel_Members));
 
     ztest_run_test_suite(channel_tests);
 }
@@ -10,7 +10,12 @@
 
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/av.h>
 #include <bacnet/bactext.h>
+#include <bacnet/readrange.h>
+#include <bacnet/cov.h>
+#include <bacnet/npdu.h>
+#include <bacnet/basic/service/h_cov.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -227,6 +232,356 @@ static void testDevice(void)
 
     return;
 }
+/**
+ * @brief Test ReadRange by position of the Object_List
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Object_List_Read_Range)
+#else
+static void test_Device_Object_List_Read_Range(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    RR_PROP_INFO info = { 0 };
+    rr_info_function info_function;
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE, type = OBJECT_NONE;
+    uint32_t object_instance = 0, instance = 0;
+    unsigned count, i;
+    int len, apdu_len;
+    bool status;
+
+    Device_Init(NULL);
+    for (i = 1; i <= 300; i++) {
+        Analog_Value_Create(i);
+    }
+    count = Device_Object_List_Count();
+    zassert_true(count >= 300, NULL);
+    info_function = Device_Objects_RR_Info(OBJECT_DEVICE);
+    zassert_not_null(info_function, NULL);
+    request.object_type = OBJECT_DEVICE;
+    request.object_instance = Device_Object_Instance_Number();
+    request.object_property = PROP_OBJECT_LIST;
+    request.array_index = BACNET_ARRAY_ALL;
+    status = info_function(&request, &info);
+    zassert_true(status, NULL);
+    zassert_equal(info.RequestTypes, RR_BY_POSITION, NULL);
+    zassert_not_null(info.Handler, NULL);
+    /* 200 identifiers fit into one response */
+    request.RequestType = RR_BY_POSITION;
+    request.Overhead = RR_OVERHEAD;
+    request.Range.RefIndex = 1;
+    request.Count = 200;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_equal(apdu_len, 200 * 5, NULL);
+    zassert_equal(request.ItemCount, 200, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    for (i = 0, len = 0; i < 200; i++) {
+        len += bacnet_object_id_application_decode(
+            &apdu[len], apdu_len - len, &type, &instance);
+        status =
+            Device_Object_List_Identifier(i + 1, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        zassert_equal(type, object_type, NULL);
+        zassert_equal(instance, object_instance, NULL);
+    }
+    /* the last 5 identifiers, by negative count */
+    request.Range.RefIndex = count;
+    request.Count = -5;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_equal(apdu_len, 5 * 5, NULL);
+    zassert_equal(request.ItemCount, 5, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    len = bacnet_object_id_application_decode(
+        apdu, apdu_len, &type, &instance);
+    zassert_true(len > 0, NULL);
+    Device_Object_List_Identifier(count - 4, &object_type, &object_instance);
+    zassert_equal(type, object_type, NULL);
+    zassert_equal(instance, object_instance, NULL);
+    /* past the end of the list */
+    request.Range.RefIndex = count + 1;
+    request.Count = 10;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_equal(apdu_len, 0, NULL);
+    zassert_equal(request.ItemCount, 0, NULL);
+    /* all of the list does not fit */
+    request.RequestType = RR_READ_ALL;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_true(apdu_len <= (MAX_APDU - RR_OVERHEAD), NULL);
+    zassert_true(request.ItemCount < count, NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    /* the cached list follows the objects */
+    Analog_Value_Delete(1);
+    zassert_equal(Device_Object_List_Count(), count - 1, NULL);
+    for (i = 1; i < count; i++) {
+        status = Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        zassert_false((object_type == OBJECT_ANALOG_VALUE) &&
+            (object_instance == 1), NULL);
+    }
+    status = Device_Object_List_Identifier(count, &object_type, &object_instance);
+    zassert_false(status, NULL);
+    /* a create and a delete leave the count and revision unchanged */
+    Analog_Value_Create(1000);
+    Analog_Value_Delete(2);
+    zassert_equal(Device_Object_List_Count(), count - 1, NULL);
+    instance = 0;
+    for (i = 1; i < count; i++) {
+        status = Device_Object_List_Identifier(i, &object_type, &object_instance);
+        zassert_true(status, NULL);
+        zassert_false((object_type == OBJECT_ANALOG_VALUE) &&
+            (object_instance == 2), NULL);
+        if (object_type == OBJECT_ANALOG_VALUE) {
+            instance = object_instance;
+        }
+    }
+    zassert_equal(instance, 1000, NULL);
+    Analog_Value_Delete(1000);
+    for (i = 3; i <= 300; i++) {
+        Analog_Value_Delete(i);
+    }
+}
+
+extern uint8_t Test_Sent_PDU[MAX_PDU];
+extern unsigned Test_Sent_PDU_Len;
+extern unsigned Test_Sent_PDU_Count;
+
+/**
+ * @brief Run the COV task through one whole cycle
+ */
+static void test_cov_fsm_cycle(void)
+{
+    unsigned i;
+
+    for (i = 0; i < 10000; i++) {
+        if (handler_cov_fsm()) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Get the APDU of the last PDU that was sent
+ * @param apdu_len - number of bytes in the APDU
+ * @return the APDU
+ */
+static uint8_t *test_sent_apdu(int *apdu_len)
+{
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int npdu_len;
+
+    npdu_len = npdu_decode(Test_Sent_PDU, &dest, &src, &npdu_data);
+    *apdu_len = (int)Test_Sent_PDU_Len - npdu_len;
+
+    return &Test_Sent_PDU[npdu_len];
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_COV_Property_Multiple)
+#else
+static void test_Device_COV_Property_Multiple(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t rp_apdu[MAX_APDU] = { 0 };
+    BACNET_READ_PROPERTY_DATA rpdata = { 0 };
+    BACNET_COV_REFERENCE references[2] = { 0 };
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA data = { 0 };
+    BACNET_COV_MULTIPLE_VALUE values[4] = { 0 };
+    BACNET_COV_MULTIPLE_DATA cov_data = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    const uint32_t instance = 400;
+    unsigned count;
+    uint8_t *sent_apdu;
+    int len, sent_len;
+
+    Device_Init(NULL);
+    handler_cov_init();
+    handler_cov_max_notification_delay_set(5);
+    Analog_Value_Create(instance);
+    Analog_Value_Present_Value_Set(instance, 10.0f, 16);
+    src.mac_len = 1;
+    src.mac[0] = 0x42;
+    references[0].monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    references[0].monitoredObjectIdentifier.instance = instance;
+    references[0].monitoredProperty.propertyIdentifier = PROP_PRESENT_VALUE;
+    references[0].monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    references[0].covIncrementPresent = true;
+    references[0].covIncrement = 1.0f;
+    references[1].monitoredObjectIdentifier.type = OBJECT_ANALOG_VALUE;
+    references[1].monitoredObjectIdentifier.instance = instance;
+    references[1].monitoredProperty.propertyIdentifier = PROP_OBJECT_NAME;
+    references[1].monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    data.subscriberProcessIdentifier = 1;
+    data.issueConfirmedNotifications = false;
+    data.lifetime = 60;
+    data.maxNotificationDelay = 10;
+    data.references = references;
+    data.reference_count = 2;
+    service_data.invoke_id = 1;
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), service_data.invoke_id, &data);
+    zassert_true(len > 0, NULL);
+    handler_cov_subscribe_property_multiple(&apdu[4], len - 4, &src,
+        &service_data);
+    sent_apdu = test_sent_apdu(&sent_len);
+    zassert_equal(sent_apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(handler_cov_property_count(), 2, NULL);
+    /* both values are sent at once in one notification */
+    count = Test_Sent_PDU_Count;
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count + 1, NULL);
+    sent_apdu = test_sent_apdu(&sent_len);
+    zassert_equal(sent_apdu[0], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(
+        sent_apdu[1], SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE, NULL);
+    cov_data.values = values;
+    cov_data.value_size = 4;
+    len = cov_notify_multiple_decode_service_request(
+        &sent_apdu[2], sent_len - 2, &cov_data);
+    zassert_equal(len, sent_len - 2, NULL);
+    zassert_equal(cov_data.value_count, 2, NULL);
+    zassert_equal(cov_data.subscriberProcessIdentifier, 1, NULL);
+    /* the subscription is listed in Active_COV_Multiple_Subscriptions */
+    rpdata.object_type = OBJECT_DEVICE;
+    rpdata.object_instance = Device_Object_Instance_Number();
+    rpdata.object_property = PROP_ACTIVE_COV_MULTIPLE_SUBSCRIPTIONS;
+    rpdata.array_index = BACNET_ARRAY_ALL;
+    rpdata.application_data = rp_apdu;
+    rpdata.application_data_len = sizeof(rp_apdu);
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len > 0, NULL);
+    zassert_true(decode_is_opening_tag_number(&rp_apdu[0], 0), NULL);
+    zassert_true(decode_is_closing_tag_number(&rp_apdu[len - 1], 4), NULL);
+    /* one subscription specification for the object, then the end of
+       its list of references */
+    zassert_true(decode_is_closing_tag_number(&rp_apdu[len - 2], 1), NULL);
+    rpdata.object_property = PROP_ACTIVE_COV_SUBSCRIPTIONS;
+    len = Device_Read_Property(&rpdata);
+    zassert_equal(len, 0, NULL);
+    /* too small for the subscription */
+    rpdata.object_property = PROP_ACTIVE_COV_MULTIPLE_SUBSCRIPTIONS;
+    rpdata.application_data_len = 8;
+    len = Device_Read_Property(&rpdata);
+    zassert_true(len < 0, NULL);
+    /* a change smaller than the COV increment is not sent */
+    count = Test_Sent_PDU_Count;
+    Analog_Value_Present_Value_Set(instance, 10.5f, 16);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count, NULL);
+    /* a change is held for the notification delay */
+    Analog_Value_Present_Value_Set(instance, 11.5f, 16);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count, NULL);
+    handler_cov_timer_seconds(5);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count + 1, NULL);
+    sent_apdu = test_sent_apdu(&sent_len);
+    len = cov_notify_multiple_decode_service_request(
+        &sent_apdu[2], sent_len - 2, &cov_data);
+    zassert_equal(len, sent_len - 2, NULL);
+    zassert_equal(cov_data.value_count, 1, NULL);
+    zassert_equal(values[0].propertyIdentifier, PROP_PRESENT_VALUE, NULL);
+    /* the first reference that fails is reported */
+    references[1].monitoredObjectIdentifier.instance = instance + 1;
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), service_data.invoke_id, &data);
+    handler_cov_subscribe_property_multiple(&apdu[4], len - 4, &src,
+        &service_data);
+    sent_apdu = test_sent_apdu(&sent_len);
+    zassert_equal(sent_apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(
+        sent_apdu[2], SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE, NULL);
+    zassert_equal(handler_cov_property_count(), 2, NULL);
+    /* cancellation of one reference, then of the others */
+    references[1].monitoredObjectIdentifier.instance = instance;
+    data.cancellationRequest = true;
+    data.reference_count = 1;
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), service_data.invoke_id, &data);
+    handler_cov_subscribe_property_multiple(&apdu[4], len - 4, &src,
+        &service_data);
+    zassert_equal(handler_cov_property_count(), 1, NULL);
+    count = Test_Sent_PDU_Count;
+    Analog_Value_Present_Value_Set(instance, 20.0f, 16);
+    zassert_true(Analog_Value_Name_Set(instance, "Renamed"), NULL);
+    test_cov_fsm_cycle();
+    handler_cov_timer_seconds(5);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count + 1, NULL);
+    sent_apdu = test_sent_apdu(&sent_len);
+    len = cov_notify_multiple_decode_service_request(
+        &sent_apdu[2], sent_len - 2, &cov_data);
+    zassert_equal(len, sent_len - 2, NULL);
+    zassert_equal(cov_data.value_count, 1, NULL);
+    zassert_equal(values[0].propertyIdentifier, PROP_OBJECT_NAME, NULL);
+    /* a name of the same length is a change too, and the same name is not */
+    count = Test_Sent_PDU_Count;
+    zassert_true(Analog_Value_Name_Set(instance, "Renamer"), NULL);
+    test_cov_fsm_cycle();
+    handler_cov_timer_seconds(5);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count + 1, NULL);
+    zassert_true(Analog_Value_Name_Set(instance, "Renamer"), NULL);
+    test_cov_fsm_cycle();
+    handler_cov_timer_seconds(5);
+    test_cov_fsm_cycle();
+    zassert_equal(Test_Sent_PDU_Count, count + 1, NULL);
+    data.reference_count = 2;
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), service_data.invoke_id, &data);
+    handler_cov_subscribe_property_multiple(&apdu[4], len - 4, &src,
+        &service_data);
+    sent_apdu = test_sent_apdu(&sent_len);
+    zassert_equal(sent_apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(handler_cov_property_count(), 0, NULL);
+    Analog_Value_Delete(instance);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(device_tests, test_Device_Write_Property_Check)
+#else
+static void test_Device_Write_Property_Check(void)
+#endif
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    const uint32_t instance = 401;
+
+    Device_Init(NULL);
+    Analog_Value_Create(instance);
+    wp_data.object_type = OBJECT_ANALOG_VALUE;
+    wp_data.object_instance = instance;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    zassert_true(Device_Write_Property_Check(&wp_data), NULL);
+    /* a property that the object does not have */
+    wp_data.object_property = PROP_WEEKLY_SCHEDULE;
+    zassert_false(Device_Write_Property_Check(&wp_data), NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_UNKNOWN_PROPERTY, NULL);
+    wp_data.object_property = PROP_PROPERTY_LIST;
+    zassert_false(Device_Write_Property_Check(&wp_data), NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_WRITE_ACCESS_DENIED, NULL);
+    /* an object that does not exist */
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.object_instance = instance + 1;
+    zassert_false(Device_Write_Property_Check(&wp_data), NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    Analog_Value_Delete(instance);
+}
+
 /**
  * @}
  */
@@ -238,7 +593,10 @@ void test_main(void)
 {
     ztest_test_suite(
         device_tests, ztest_unit_test(testDevice),
-        ztest_unit_test(test_Device_Data_Sharing));
+        ztest_unit_test(test_Device_Data_Sharing),
+        ztest_unit_test(test_Device_Object_List_Read_Range),
+        ztest_unit_test(test_Device_COV_Property_Multiple),
+        ztest_unit_test(test_Device_Write_Property_Check));
 
     ztest_run_test_suite(device_tests);
 }
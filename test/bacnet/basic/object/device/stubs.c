@@ -10,10 +10,16 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include "bacnet/datetime.h"
 #include "bacnet/bacdef.h"
 #include "bacnet/npdu.h"
 
+/* the last PDU that was sent */
+uint8_t Test_Sent_PDU[MAX_PDU];
+unsigned Test_Sent_PDU_Len;
+unsigned Test_Sent_PDU_Count;
+
 void datetime_init(void)
 {
 }
@@ -45,8 +51,12 @@ int bip_send_pdu(
 {
     (void)dest;
     (void)npdu_data;
-    (void)pdu;
-    (void)pdu_len;
-    
-    return 0;
+    if (pdu_len > sizeof(Test_Sent_PDU)) {
+        return 0;
+    }
+    memcpy(Test_Sent_PDU, pdu, pdu_len);
+    Test_Sent_PDU_Len = pdu_len;
+    Test_Sent_PDU_Count++;
+
+    return (int)pdu_len;
 }
@@ -0,0 +1,275 @@
+/**
+ * @file
+ * @brief test of the Device object extensions for a routing gateway
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/basic/object/device.h>
+
+/* the I-Am that were sent, in the stubs */
+extern unsigned Test_I_Am_Count;
+extern unsigned Test_I_Am_Unicast_Count;
+extern uint32_t Test_I_Am_Instance;
+
+#define TEST_FIRST_INSTANCE 260001
+#define TEST_DEVICE_COUNT 2000
+#define TEST_VIRTUAL_DNET 2709
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Initialize the virtual address of a routed Device
+ * @param address - address to be initialized
+ * @param instance - Device instance, used as the virtual MAC
+ */
+static void test_virtual_address(BACNET_ADDRESS *address, uint32_t instance)
+{
+    memset(address, 0, sizeof(BACNET_ADDRESS));
+    address->net = TEST_VIRTUAL_DNET;
+    address->len = 3;
+    encode_unsigned24(&address->adr[0], instance);
+}
+
+/**
+ * @brief Test
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gateway_tests, testGatewayDevices)
+#else
+static void testGatewayDevices(void)
+#endif
+{
+    BACNET_ADDRESS address = { 0 };
+    BACNET_ADDRESS requester = { 0 };
+    BACNET_ADDRESS *pAddress = NULL;
+    BACNET_CHARACTER_STRING name = { 0 };
+    DEVICE_OBJECT_DATA *pDev = NULL;
+    object_functions_t object_table[2];
+    int DNET_list[2] = { TEST_VIRTUAL_DNET, -1 };
+    /* two MAC addresses with the same FNV-1a key */
+    const uint8_t colliding_mac[2][6] = {
+        { 0x02, 0x00, 0x00, 0x09, 0xfa, 0x5c },
+        { 0x0a, 0x00, 0x00, 0x0e, 0xdf, 0xa4 } };
+    int cursor = 0;
+    unsigned i, count;
+    uint16_t index;
+
+    Device_Init(NULL);
+    Routing_Device_Init(TEST_FIRST_INSTANCE);
+    zassert_equal(Routed_Device_Count(), 1, NULL);
+    characterstring_init_ansi(&name, "Routed");
+    for (i = 1; i < TEST_DEVICE_COUNT; i++) {
+        index = Add_Routed_Device(TEST_FIRST_INSTANCE + i, &name, "Remote");
+        zassert_equal(index, i, NULL);
+        test_virtual_address(&address, TEST_FIRST_INSTANCE + i);
+        zassert_true(Routed_Device_Set_Address(&address), NULL);
+    }
+    zassert_equal(Routed_Device_Count(), TEST_DEVICE_COUNT, NULL);
+    /* a duplicate instance is not added */
+    index = Add_Routed_Device(TEST_FIRST_INSTANCE + 1, &name, "Remote");
+    zassert_equal(index, UINT16_MAX, NULL);
+    /* find by instance */
+    zassert_true(
+        Routed_Device_Valid_Object_Instance_Number(TEST_FIRST_INSTANCE + 1500),
+        NULL);
+    zassert_equal(
+        Device_Object_Instance_Number(), TEST_FIRST_INSTANCE + 1500, NULL);
+    zassert_false(Routed_Device_Valid_Object_Instance_Number(1), NULL);
+    /* find by virtual MAC */
+    test_virtual_address(&address, TEST_FIRST_INSTANCE + 1700);
+    cursor = 0;
+    zassert_true(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    zassert_equal(cursor, -1, NULL);
+    zassert_equal(
+        Device_Object_Instance_Number(), TEST_FIRST_INSTANCE + 1700, NULL);
+    test_virtual_address(&address, 1);
+    cursor = 0;
+    zassert_false(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    /* an address changed in place is found once it is set */
+    pAddress = Get_Routed_Device_Address(5);
+    zassert_not_null(pAddress, NULL);
+    encode_unsigned24(&pAddress->adr[0], 42);
+    test_virtual_address(&address, 42);
+    cursor = 0;
+    zassert_false(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    Get_Routed_Device_Object(5);
+    zassert_true(Routed_Device_Set_Address(&address), NULL);
+    cursor = 0;
+    zassert_true(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    zassert_equal(
+        Device_Object_Instance_Number(), TEST_FIRST_INSTANCE + 5, NULL);
+    test_virtual_address(&address, TEST_FIRST_INSTANCE + 5);
+    cursor = 0;
+    zassert_false(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    /* two MAC addresses with the same key are both found */
+    for (i = 0; i < 2; i++) {
+        memset(&address, 0, sizeof(address));
+        address.net = TEST_VIRTUAL_DNET;
+        address.len = sizeof(colliding_mac[i]);
+        memcpy(address.adr, colliding_mac[i], sizeof(colliding_mac[i]));
+        Get_Routed_Device_Object(10 + i);
+        zassert_true(Routed_Device_Set_Address(&address), NULL);
+    }
+    for (i = 0; i < 2; i++) {
+        memcpy(address.adr, colliding_mac[i], sizeof(colliding_mac[i]));
+        cursor = 0;
+        zassert_true(
+            Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+        zassert_equal(Device_Object_Instance_Number(),
+            TEST_FIRST_INSTANCE + 10 + i, NULL);
+    }
+    /* the first of the chain moves away, the second is still found */
+    Get_Routed_Device_Object(10);
+    test_virtual_address(&address, TEST_FIRST_INSTANCE + 10);
+    zassert_true(Routed_Device_Set_Address(&address), NULL);
+    address.len = sizeof(colliding_mac[1]);
+    memcpy(address.adr, colliding_mac[1], sizeof(colliding_mac[1]));
+    cursor = 0;
+    zassert_true(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    zassert_equal(
+        Device_Object_Instance_Number(), TEST_FIRST_INSTANCE + 11, NULL);
+    memcpy(address.adr, colliding_mac[0], sizeof(colliding_mac[0]));
+    cursor = 0;
+    zassert_false(Routed_Device_GetNext(&address, DNET_list, &cursor), NULL);
+    /* every Device gets a broadcast on the virtual network */
+    memset(&address, 0, sizeof(address));
+    address.net = TEST_VIRTUAL_DNET;
+    cursor = 0;
+    count = 0;
+    while (Routed_Device_GetNext(&address, DNET_list, &cursor)) {
+        count++;
+    }
+    zassert_equal(count, TEST_DEVICE_COUNT - 1, NULL);
+    /* the instance number may only change to an unused one */
+    zassert_not_null(Get_Routed_Device_Object(7), NULL);
+    zassert_false(
+        Routed_Device_Set_Object_Instance_Number(TEST_FIRST_INSTANCE + 8),
+        NULL);
+    zassert_true(Routed_Device_Set_Object_Instance_Number(100), NULL);
+    zassert_true(Routed_Device_Valid_Object_Instance_Number(100), NULL);
+    zassert_false(
+        Routed_Device_Valid_Object_Instance_Number(TEST_FIRST_INSTANCE + 7),
+        NULL);
+    /* I-Am are sent in batches, only for the Devices in the range */
+    Test_I_Am_Count = 0;
+    Routed_Device_I_Am_Request(
+        TEST_FIRST_INSTANCE + 100, TEST_FIRST_INSTANCE + 199, NULL);
+    zassert_equal(Routed_Device_I_Am_Task(10), 90, NULL);
+    zassert_equal(Test_I_Am_Count, 10, NULL);
+    while (Routed_Device_I_Am_Task(0)) {
+    }
+    zassert_equal(Test_I_Am_Count, 100, NULL);
+    zassert_true(Test_I_Am_Instance >= TEST_FIRST_INSTANCE + 100, NULL);
+    zassert_true(Test_I_Am_Instance <= TEST_FIRST_INSTANCE + 199, NULL);
+    zassert_equal(Routed_Device_I_Am_Task(0), 0, NULL);
+    /* a second requester gets a broadcast I-Am */
+    Test_I_Am_Count = 0;
+    Test_I_Am_Unicast_Count = 0;
+    requester.mac_len = 1;
+    requester.mac[0] = 1;
+    Routed_Device_I_Am_Request(
+        TEST_FIRST_INSTANCE + 10, TEST_FIRST_INSTANCE + 19, &requester);
+    requester.mac[0] = 2;
+    Routed_Device_I_Am_Request(
+        TEST_FIRST_INSTANCE + 15, TEST_FIRST_INSTANCE + 24, &requester);
+    zassert_equal(Routed_Device_I_Am_Task(100), 0, NULL);
+    zassert_equal(Test_I_Am_Unicast_Count, 10, NULL);
+    zassert_equal(Test_I_Am_Count, 5, NULL);
+    /* a Who-Is on the virtual network is not answered by the gateway */
+    Test_I_Am_Count = 0;
+    zassert_not_null(Get_Routed_Device_Object(1), NULL);
+    Routed_Device_I_Am_Request(0, BACNET_MAX_INSTANCE, NULL);
+    while (Routed_Device_I_Am_Task(0)) {
+    }
+    zassert_equal(Test_I_Am_Count, TEST_DEVICE_COUNT - 1, NULL);
+    Test_I_Am_Count = 0;
+    zassert_not_null(Get_Routed_Device_Object(0), NULL);
+    Routed_Device_I_Am_Request(0, BACNET_MAX_INSTANCE, NULL);
+    while (Routed_Device_I_Am_Task(0)) {
+    }
+    zassert_equal(Test_I_Am_Count, TEST_DEVICE_COUNT, NULL);
+    /* a Device may have its own table of objects */
+    count = Device_Object_List_Count();
+    zassert_true(count > 1, NULL);
+    memset(object_table, 0, sizeof(object_table));
+    object_table[0].Object_Type = OBJECT_DEVICE;
+    object_table[0].Object_Count = Device_Count;
+    object_table[1].Object_Type = MAX_BACNET_OBJECT_TYPE;
+    pDev = Get_Routed_Device_Object(3);
+    zassert_not_null(pDev, NULL);
+    zassert_true(Routed_Device_Set_Object_Table(object_table), NULL);
+    zassert_equal(Routed_Device_Object_Table(), object_table, NULL);
+    zassert_equal(Device_Object_List_Count(), 1, NULL);
+    zassert_not_null(Get_Routed_Device_Object(0), NULL);
+    zassert_is_null(Routed_Device_Object_Table(), NULL);
+    zassert_equal(Device_Object_List_Count(), count, NULL);
+    Routed_Device_Cleanup();
+    zassert_equal(Routed_Device_Count(), 0, NULL);
+}
+
+/**
+ * @brief Test the Object_List of the routed Devices
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(gateway_tests, testGatewayObjectList)
+#else
+static void testGatewayObjectList(void)
+#endif
+{
+    BACNET_CHARACTER_STRING name = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t instance = 0;
+    unsigned i, count;
+    uint16_t index;
+
+    Device_Init(NULL);
+    Routing_Device_Init(TEST_FIRST_INSTANCE);
+    characterstring_init_ansi(&name, "Routed");
+    for (i = 1; i < 3; i++) {
+        index = Add_Routed_Device(TEST_FIRST_INSTANCE + i, &name, "Remote");
+        zassert_equal(index, i, NULL);
+    }
+    count = Device_Object_List_Count();
+    zassert_true(count > 1, NULL);
+    /* the first element is the Device that is addressed */
+    for (i = 0; i < 3; i++) {
+        zassert_true(Routed_Device_Valid_Object_Instance_Number(
+                         TEST_FIRST_INSTANCE + i),
+            NULL);
+        zassert_true(
+            Device_Object_List_Identifier(1, &object_type, &instance), NULL);
+        zassert_equal(object_type, OBJECT_DEVICE, NULL);
+        zassert_equal(instance, TEST_FIRST_INSTANCE + i, NULL);
+        /* the other elements are shared */
+        zassert_true(Device_Object_List_Identifier(
+                         count, &object_type, &instance),
+            NULL);
+        zassert_not_equal(object_type, OBJECT_DEVICE, NULL);
+    }
+    zassert_false(
+        Device_Object_List_Identifier(count + 1, &object_type, &instance),
+        NULL);
+    Routed_Device_Cleanup();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(gateway_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(gateway_tests, ztest_unit_test(testGatewayDevices),
+        ztest_unit_test(testGatewayObjectList));
+
+    ztest_run_test_suite(gateway_tests);
+}
+#endif
@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @brief stubs for the gateway Device object unit test
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include "bacnet/datetime.h"
+#include "bacnet/bacdef.h"
+#include "bacnet/npdu.h"
+#include "bacnet/basic/object/device.h"
+
+/* the I-Am that were sent */
+unsigned Test_I_Am_Count;
+unsigned Test_I_Am_Unicast_Count;
+uint32_t Test_I_Am_Instance;
+
+void datetime_init(void)
+{
+}
+
+bool datetime_local(
+    BACNET_DATE *bdate,
+    BACNET_TIME *btime,
+    int16_t *utc_offset_minutes,
+    bool *dst_active)
+{
+    (void)bdate;
+    (void)btime;
+    (void)utc_offset_minutes;
+    (void)dst_active;
+
+    return true;
+}
+
+void bip_get_my_address(BACNET_ADDRESS *my_address)
+{
+    (void)my_address;
+}
+
+int bip_send_pdu(
+    BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    (void)pdu;
+
+    return (int)pdu_len;
+}
+
+void Send_I_Am(uint8_t *buffer)
+{
+    (void)buffer;
+    Test_I_Am_Instance = Device_Object_Instance_Number();
+    Test_I_Am_Count++;
+}
+
+void Send_I_Am_Unicast(uint8_t *buffer, BACNET_ADDRESS *src)
+{
+    (void)buffer;
+    (void)src;
+    Test_I_Am_Instance = Device_Object_Instance_Number();
+    Test_I_Am_Unicast_Count++;
+}
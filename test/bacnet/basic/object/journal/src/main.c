@@ -0,0 +1,163 @@
+/**
+ * @file
+ * @brief Unit test for the write-behind journal
+ * @author agent <agent@local>
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/basic/object/ao.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/journal.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static uint8_t Test_Journal[DEVICE_JOURNAL_BUFFER_SIZE * 2];
+static size_t Test_Journal_Length;
+static unsigned Test_Journal_Commits;
+
+static bool test_journal_append(
+    void *context, const uint8_t *data, size_t data_len)
+{
+    bool *fail = context;
+
+    if (fail && *fail) {
+        return false;
+    }
+    if ((Test_Journal_Length + data_len) > sizeof(Test_Journal)) {
+        return false;
+    }
+    memcpy(&Test_Journal[Test_Journal_Length], data, data_len);
+    Test_Journal_Length += data_len;
+    Test_Journal_Commits++;
+
+    return true;
+}
+
+static bool test_present_value_write(
+    uint32_t object_instance, uint8_t priority, bool relinquish, float value)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE data_value = { 0 };
+
+    wp_data.object_type = OBJECT_ANALOG_OUTPUT;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = priority;
+    if (relinquish) {
+        data_value.tag = BACNET_APPLICATION_TAG_NULL;
+    } else {
+        data_value.tag = BACNET_APPLICATION_TAG_REAL;
+        data_value.type.Real = value;
+    }
+    wp_data.application_data_len =
+        bacapp_encode_application_data(wp_data.application_data, &data_value);
+
+    return Device_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Test the journal of the values written
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(journal_tests, testJournal)
+#else
+static void testJournal(void)
+#endif
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    size_t pending, valid_len = 0, first_len;
+    bool fail = true;
+    bool status;
+    int records;
+
+    Device_Init(NULL);
+    create_data.object_type = OBJECT_ANALOG_OUTPUT;
+    create_data.object_instance = 1;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    Device_Journal_Reset();
+    Device_Write_Property_Store_Callback_Set(Device_Journal_Write_Property);
+
+    /* the writes are only buffered until they are committed */
+    status = test_present_value_write(1, 8, false, 42.0f);
+    zassert_true(status, NULL);
+    first_len = Device_Journal_Pending();
+    zassert_true(first_len > DEVICE_JOURNAL_RECORD_OVERHEAD, NULL);
+    status = test_present_value_write(1, 12, false, 12.0f);
+    zassert_true(status, NULL);
+    pending = Device_Journal_Pending();
+    zassert_equal(pending, first_len * 2, NULL);
+    status = Device_Journal_Commit(test_journal_append, &fail);
+    zassert_false(status, NULL);
+    zassert_equal(Device_Journal_Pending(), pending, NULL);
+    fail = false;
+    status = Device_Journal_Commit(test_journal_append, &fail);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Journal_Pending(), 0, NULL);
+    zassert_equal(Test_Journal_Commits, 1, NULL);
+    zassert_equal(Test_Journal_Length, pending, NULL);
+
+    /* replay the journal over values that were not journaled */
+    Device_Write_Property_Store_Callback_Set(NULL);
+    status = test_present_value_write(1, 8, true, 0.0f);
+    zassert_true(status, NULL);
+    status = test_present_value_write(1, 12, true, 0.0f);
+    zassert_true(status, NULL);
+    zassert_equal(Device_Journal_Pending(), 0, NULL);
+    records =
+        Device_Journal_Replay(Test_Journal, Test_Journal_Length, &valid_len);
+    zassert_equal(records, 2, NULL);
+    zassert_equal(valid_len, Test_Journal_Length, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(1), 42.0f), NULL);
+
+    /* a partly written record ends the replay */
+    records = Device_Journal_Replay(
+        Test_Journal, Test_Journal_Length - 3, &valid_len);
+    zassert_equal(records, 1, NULL);
+    zassert_equal(valid_len, first_len, NULL);
+    Test_Journal[first_len + 6] ^= 0x55;
+    records =
+        Device_Journal_Replay(Test_Journal, Test_Journal_Length, &valid_len);
+    zassert_equal(records, 1, NULL);
+    zassert_equal(valid_len, first_len, NULL);
+
+    /* a full buffer needs a snapshot */
+    Device_Write_Property_Store_Callback_Set(Device_Journal_Write_Property);
+    zassert_false(Device_Journal_Overflow(), NULL);
+    while (Device_Journal_Pending() <= (DEVICE_JOURNAL_BUFFER_SIZE -
+            first_len)) {
+        status = test_present_value_write(1, 8, false, 1.0f);
+        zassert_true(status, NULL);
+    }
+    status = test_present_value_write(1, 8, false, 2.0f);
+    zassert_true(status, NULL);
+    zassert_true(Device_Journal_Overflow(), NULL);
+    Device_Journal_Reset();
+    zassert_false(Device_Journal_Overflow(), NULL);
+    zassert_equal(Device_Journal_Pending(), 0, NULL);
+    Device_Write_Property_Store_Callback_Set(NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(journal_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(journal_tests, ztest_unit_test(testJournal));
+
+    ztest_run_test_suite(journal_tests);
+}
+#endif
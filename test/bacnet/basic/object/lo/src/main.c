@@ -137,6 +137,207 @@ static void testLightingOutput(void)
 
     return;
 }
+static unsigned Tracking_Notify_Count;
+
+static void Tracking_Notify(
+    uint32_t object_instance, float old_value, float value)
+{
+    (void)object_instance;
+    (void)old_value;
+    (void)value;
+    Tracking_Notify_Count++;
+}
+
+static bool Present_Value_Write(uint32_t instance, float value)
+{
+    BACNET_WRITE_PROPERTY_DATA wpdata = { 0 };
+
+    wpdata.object_type = OBJECT_LIGHTING_OUTPUT;
+    wpdata.object_instance = instance;
+    wpdata.object_property = PROP_PRESENT_VALUE;
+    wpdata.array_index = BACNET_ARRAY_ALL;
+    wpdata.priority = BACNET_MAX_PRIORITY;
+    wpdata.application_data_len =
+        encode_application_real(wpdata.application_data, value);
+
+    return Lighting_Output_Write_Property(&wpdata);
+}
+
+/**
+ * @brief Test the fades, ramps, and steps of the active set
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(lo_tests, testLightingOutputTransitions)
+#else
+static void testLightingOutputTransitions(void)
+#endif
+{
+    BACNET_LIGHTING_COMMAND command = { 0 };
+    unsigned i;
+    bool status;
+
+    Lighting_Output_Init();
+    Lighting_Output_Create(1);
+    Lighting_Output_Create(2);
+    Lighting_Output_Create(3);
+    Lighting_Output_Write_Present_Value_Callback_Set(Tracking_Notify);
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+    /* fade */
+    Lighting_Output_Default_Fade_Time_Set(1, 1000);
+    status = Present_Value_Write(1, 100.0f);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 1, NULL);
+    /* ramp */
+    Lighting_Output_Transition_Set(2, BACNET_LIGHTING_TRANSITION_RAMP);
+    Lighting_Output_Default_Ramp_Rate_Set(2, 10.0f);
+    status = Present_Value_Write(2, 5.0f);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 2, NULL);
+    /* step */
+    command.operation = BACNET_LIGHTS_STEP_ON;
+    command.use_step_increment = true;
+    command.step_increment = 10.0f;
+    status = Lighting_Output_Lighting_Command_Set(3, &command);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 3, NULL);
+    Tracking_Notify_Count = 0;
+    for (i = 0; i < 5; i++) {
+        Lighting_Output_Active_Timer(50);
+    }
+    zassert_equal(Lighting_Output_Active_Count(), 2, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(1), 25.0f, 0.01f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(1),
+        BACNET_LIGHTING_FADE_ACTIVE, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(2), 2.5f, 0.01f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(2),
+        BACNET_LIGHTING_RAMP_ACTIVE, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(3), 10.0f, 0.01f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(3),
+        BACNET_LIGHTING_IDLE, NULL);
+    for (i = 0; i < 5; i++) {
+        Lighting_Output_Active_Timer(50);
+    }
+    zassert_equal(Lighting_Output_Active_Count(), 1, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(2), 5.0f, 0.01f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(2), BACNET_LIGHTING_IDLE, NULL);
+    for (i = 0; i < 10; i++) {
+        Lighting_Output_Timer(1, 50);
+    }
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(1), 100.0f, 0.001f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(1), BACNET_LIGHTING_IDLE, NULL);
+    /* a slow fade only calls back when the change can be seen */
+    Lighting_Output_Default_Fade_Time_Set(1, 1000);
+    status = Present_Value_Write(1, 99.5f);
+    zassert_true(status, NULL);
+    Tracking_Notify_Count = 0;
+    for (i = 0; i < 100; i++) {
+        Lighting_Output_Active_Timer(10);
+    }
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(1), 99.5f, 0.001f, NULL);
+    zassert_true(Tracking_Notify_Count >= 5, NULL);
+    zassert_true(Tracking_Notify_Count <= 6, NULL);
+    /* deleting an object removes it from the active set */
+    status = Present_Value_Write(1, 0.0f);
+    zassert_true(status, NULL);
+    status = Present_Value_Write(2, 0.0f);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 2, NULL);
+    status = Lighting_Output_Delete(1);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 1, NULL);
+    Lighting_Output_Active_Timer(10);
+    Lighting_Output_Write_Present_Value_Callback_Set(NULL);
+    Lighting_Output_Cleanup();
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+}
+
+static unsigned Command_Notify_Count;
+
+/**
+ * @brief Callback that commands another object from inside the timer
+ */
+static void Command_Notify(
+    uint32_t object_instance, float old_value, float value)
+{
+    (void)old_value;
+    (void)value;
+    if ((object_instance == 1) && (Command_Notify_Count == 0)) {
+        zassert_true(Present_Value_Write(3, 80.0f), NULL);
+    }
+    Command_Notify_Count++;
+}
+
+/**
+ * @brief Test changes to the active set while it is busy
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(lo_tests, testLightingOutputActiveChanges)
+#else
+static void testLightingOutputActiveChanges(void)
+#endif
+{
+    BACNET_LIGHTING_COMMAND command = { 0 };
+    unsigned i;
+    bool status;
+
+    Lighting_Output_Init();
+    Lighting_Output_Create(1);
+    Lighting_Output_Create(2);
+    Lighting_Output_Create(3);
+    /* setting the tracking value during a fade continues from there */
+    Lighting_Output_Default_Fade_Time_Set(1, 1000);
+    status = Present_Value_Write(1, 100.0f);
+    zassert_true(status, NULL);
+    for (i = 0; i < 5; i++) {
+        Lighting_Output_Active_Timer(50);
+    }
+    zassert_within(Lighting_Output_Tracking_Value(1), 25.0f, 0.01f, NULL);
+    status = Lighting_Output_Tracking_Value_Set(1, 70.0f);
+    zassert_true(status, NULL);
+    Lighting_Output_Active_Timer(50);
+    zassert_within(Lighting_Output_Tracking_Value(1), 72.0f, 0.01f, NULL);
+    for (i = 0; i < 15; i++) {
+        Lighting_Output_Active_Timer(50);
+    }
+    zassert_within(Lighting_Output_Tracking_Value(1), 100.0f, 0.001f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(1), BACNET_LIGHTING_IDLE, NULL);
+    /* a ramp-rate of zero keeps ramping without moving */
+    command.operation = BACNET_LIGHTS_RAMP_TO;
+    command.use_target_level = true;
+    command.target_level = 50.0f;
+    command.use_ramp_rate = true;
+    command.ramp_rate = 0.0f;
+    status = Lighting_Output_Lighting_Command_Set(2, &command);
+    zassert_true(status, NULL);
+    for (i = 0; i < 5; i++) {
+        Lighting_Output_Active_Timer(50);
+    }
+    zassert_equal(Lighting_Output_Active_Count(), 1, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(2), 0.0f, 0.001f, NULL);
+    zassert_equal(Lighting_Output_In_Progress(2),
+        BACNET_LIGHTING_RAMP_ACTIVE, NULL);
+    command.operation = BACNET_LIGHTS_STOP;
+    status = Lighting_Output_Lighting_Command_Set(2, &command);
+    zassert_true(status, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+    /* a callback that commands another object runs after the tick */
+    Lighting_Output_Write_Present_Value_Callback_Set(Command_Notify);
+    Lighting_Output_Default_Fade_Time_Set(1, 100);
+    status = Present_Value_Write(1, 10.0f);
+    zassert_true(status, NULL);
+    Command_Notify_Count = 0;
+    Lighting_Output_Active_Timer(50);
+    Lighting_Output_Active_Timer(50);
+    zassert_true(Command_Notify_Count > 0, NULL);
+    zassert_within(Lighting_Output_Tracking_Value(1), 10.0f, 0.001f, NULL);
+    Lighting_Output_Write_Present_Value_Callback_Set(NULL);
+    Lighting_Output_Active_Timer(50);
+    zassert_within(Lighting_Output_Tracking_Value(3), 80.0f, 0.001f, NULL);
+    zassert_equal(Lighting_Output_Active_Count(), 0, NULL);
+    Lighting_Output_Cleanup();
+}
 /**
  * @}
  */
@@ -146,7 +347,9 @@ ZTEST_SUITE(lo_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(lo_tests, ztest_unit_test(testLightingOutput));
+    ztest_test_suite(lo_tests, ztest_unit_test(testLightingOutput),
+        ztest_unit_test(testLightingOutputTransitions),
+        ztest_unit_test(testLightingOutputActiveChanges));
 
     ztest_run_test_suite(lo_tests);
 }
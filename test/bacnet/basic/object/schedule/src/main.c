@@ -9,6 +9,9 @@
 
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/schedule.h>
+#include <bacnet/bacdevobjpropref.h>
+#include <bacnet/dailyschedule.h>
+#include <bacnet/special_event.h>
 #include <property_test.h>
 
 /**
@@ -40,6 +43,184 @@ static void testSchedule(void)
         Schedule_Read_Property, Schedule_Write_Property,
         skip_fail_property_list);
 }
+
+static unsigned Reference_Writes;
+static float Reference_Value;
+
+static bool test_write_property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    BACNET_APPLICATION_DATA_VALUE value = { 0 };
+
+    Reference_Writes++;
+    bacapp_decode_application_data(
+        wp_data->application_data, wp_data->application_data_len, &value);
+    if (value.tag == BACNET_APPLICATION_TAG_REAL) {
+        Reference_Value = value.type.Real;
+    }
+
+    return true;
+}
+
+static void test_time_value_set(
+    BACNET_TIME_VALUE *tv, uint8_t hour, uint8_t minute, float real)
+{
+    datetime_set_time(&tv->Time, hour, minute, 0, 0);
+    if (real < 0.0f) {
+        tv->Value.tag = BACNET_APPLICATION_TAG_NULL;
+    } else {
+        tv->Value.tag = BACNET_APPLICATION_TAG_REAL;
+        tv->Value.type.Real = real;
+    }
+}
+
+static bool test_schedule_write(uint32_t object_instance,
+    BACNET_PROPERTY_ID property,
+    BACNET_ARRAY_INDEX array_index,
+    uint8_t *apdu,
+    int apdu_len)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+
+    wp_data.object_type = OBJECT_SCHEDULE;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = property;
+    wp_data.array_index = array_index;
+    wp_data.priority = BACNET_NO_PRIORITY;
+    memcpy(wp_data.application_data, apdu, apdu_len);
+    wp_data.application_data_len = apdu_len;
+
+    return Schedule_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Test the transitions of the Schedule object
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(schedule_tests, testScheduleTransitions)
+#else
+static void testScheduleTransitions(void)
+#endif
+{
+    static BACNET_DAILY_SCHEDULE day;
+    static BACNET_SPECIAL_EVENT event;
+    BACNET_DEVICE_OBJECT_PROPERTY_REFERENCE reference = { 0 };
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint32_t object_instance;
+    BACNET_DATE date;
+    BACNET_TIME time;
+    unsigned i, changes = 0;
+    int len;
+    bool status;
+
+    Schedule_Init();
+    Schedule_Write_Property_Internal_Callback_Set(test_write_property);
+    object_instance = Schedule_Index_To_Instance(0);
+    reference.objectIdentifier.type = OBJECT_ANALOG_VALUE;
+    reference.objectIdentifier.instance = 1;
+    reference.propertyIdentifier = PROP_PRESENT_VALUE;
+    reference.arrayIndex = BACNET_ARRAY_ALL;
+    reference.deviceIdentifier.type = BACNET_NO_DEV_TYPE;
+    len = bacapp_encode_device_obj_property_ref(apdu, &reference);
+    status = test_schedule_write(object_instance,
+        PROP_LIST_OF_OBJECT_PROPERTY_REFERENCES, BACNET_ARRAY_ALL, apdu, len);
+    zassert_true(status, NULL);
+    /* Monday: 8:00 22.0, 12:00 23.0, 17:00 relinquish to the default */
+    day.TV_Count = 3;
+    test_time_value_set(&day.Time_Values[0], 8, 0, 22.0f);
+    test_time_value_set(&day.Time_Values[1], 12, 0, 23.0f);
+    test_time_value_set(&day.Time_Values[2], 17, 0, -1.0f);
+    len = bacnet_dailyschedule_context_encode(apdu, 0, &day);
+    status = test_schedule_write(
+        object_instance, PROP_WEEKLY_SCHEDULE, 1, apdu, len);
+    zassert_true(status, NULL);
+    /* too many values for one day */
+    day.TV_Count = BACNET_WEEKLY_SCHEDULE_SIZE + 1;
+    for (i = 0; i < day.TV_Count; i++) {
+        test_time_value_set(&day.Time_Values[i], i, 0, 20.0f);
+    }
+    len = bacnet_dailyschedule_context_encode(apdu, 0, &day);
+    status = test_schedule_write(
+        object_instance, PROP_WEEKLY_SCHEDULE, 2, apdu, len);
+    zassert_false(status, NULL);
+
+    datetime_set_date(&date, 2024, 1, 1);
+    zassert_equal(date.wday, BACNET_WEEKDAY_MONDAY, NULL);
+    Reference_Writes = 0;
+    datetime_set_time(&time, 7, 0, 0, 0);
+    zassert_false(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_equal(Reference_Writes, 0, NULL);
+    zassert_true(Schedule_Next_Transition(object_instance, &time), NULL);
+    zassert_equal(time.hour, 8, NULL);
+    zassert_equal(time.min, 0, NULL);
+    datetime_set_time(&time, 8, 0, 0, 0);
+    zassert_true(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_equal(Reference_Writes, 1, NULL);
+    zassert_false(islessgreater(Reference_Value, 22.0f), NULL);
+    datetime_set_time(&time, 9, 0, 0, 0);
+    zassert_false(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_equal(Reference_Writes, 1, NULL);
+    datetime_set_time(&time, 12, 30, 0, 0);
+    zassert_true(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_false(islessgreater(Reference_Value, 23.0f), NULL);
+    datetime_set_time(&time, 17, 0, 0, 0);
+    zassert_true(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_false(islessgreater(Reference_Value, 21.0f), NULL);
+    zassert_false(Schedule_Next_Transition(object_instance, &time), NULL);
+
+    /* an exception for today overrides the weekly schedule */
+    event.periodTag = BACNET_SPECIAL_EVENT_PERIOD_CALENDAR_ENTRY;
+    event.period.calendarEntry.tag = BACNET_CALENDAR_DATE;
+    datetime_copy_date(&event.period.calendarEntry.type.Date, &date);
+    event.priority = 1;
+    event.timeValues.TV_Count = 2;
+    test_time_value_set(&event.timeValues.Time_Values[0], 10, 0, 30.0f);
+    test_time_value_set(&event.timeValues.Time_Values[1], 11, 0, -1.0f);
+    len = bacnet_special_event_encode(apdu, &event);
+    status = test_schedule_write(
+        object_instance, PROP_EXCEPTION_SCHEDULE, 1, apdu, len);
+    zassert_true(status, NULL);
+    datetime_set_time(&time, 10, 30, 0, 0);
+    zassert_true(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_false(islessgreater(Reference_Value, 30.0f), NULL);
+    datetime_set_time(&time, 11, 0, 0, 0);
+    zassert_true(Schedule_Update(object_instance, &date, &time), NULL);
+    zassert_false(islessgreater(Reference_Value, 22.0f), NULL);
+
+    /* more transitions than fit in the timeline */
+    event.timeValues.TV_Count = 8;
+    for (i = 0; i < 7; i++) {
+        test_time_value_set(
+            &event.timeValues.Time_Values[i], i + 1, 0, (float)(i + 1));
+    }
+    test_time_value_set(&event.timeValues.Time_Values[7], 8, 0, -1.0f);
+    len = bacnet_special_event_encode(apdu, &event);
+    status = test_schedule_write(
+        object_instance, PROP_EXCEPTION_SCHEDULE, 1, apdu, len);
+    zassert_true(status, NULL);
+    day.TV_Count = BACNET_WEEKLY_SCHEDULE_SIZE;
+    for (i = 0; i < BACNET_WEEKLY_SCHEDULE_SIZE; i++) {
+        test_time_value_set(&day.Time_Values[i], i + 9, 0, (float)(i + 9));
+    }
+    len = bacnet_dailyschedule_context_encode(apdu, 0, &day);
+    status = test_schedule_write(
+        object_instance, PROP_WEEKLY_SCHEDULE, 1, apdu, len);
+    zassert_true(status, NULL);
+    for (i = 0; i < (24 * 6); i++) {
+        datetime_set_time(&time, i / 6, (i % 6) * 10, 0, 0);
+        if (Schedule_Update(object_instance, &date, &time)) {
+            changes++;
+        }
+    }
+    /* the default at midnight, 1..7, the default at 8:00, then 9..16 */
+    zassert_equal(changes, 17, NULL);
+    zassert_false(islessgreater(Reference_Value, 16.0f), NULL);
+
+    /* no updates when out of service */
+    Schedule_Out_Of_Service_Set(object_instance, true);
+    datetime_set_time(&time, 0, 0, 0, 0);
+    zassert_false(Schedule_Update(object_instance, &date, &time), NULL);
+    Schedule_Write_Property_Internal_Callback_Set(NULL);
+}
 /**
  * @}
  */
@@ -49,7 +230,8 @@ ZTEST_SUITE(schedule_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(schedule_tests, ztest_unit_test(testSchedule));
+    ztest_test_suite(schedule_tests, ztest_unit_test(testSchedule),
+        ztest_unit_test(testScheduleTransitions));
 
     ztest_run_test_suite(schedule_tests);
 }
@@ -0,0 +1,29 @@
+/**
+ * @file
+ * @brief Stub functions for unit test of a BACnet object
+ * @author Steve Karg <skarg@users.sourceforge.net>
+ * @date December 2022
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdbool.h>
+#include <stdint.h>
+#include "bacnet/datetime.h"
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return 260001;
+}
+
+bool datetime_local(
+    BACNET_DATE *bdate,
+    BACNET_TIME *btime,
+    int16_t *utc_offset_minutes,
+    bool *dst_active)
+{
+    datetime_set_date(bdate, 2024, 1, 1);
+    datetime_set_time(btime, 0, 0, 0, 0);
+    (void)utc_offset_minutes;
+    (void)dst_active;
+    return true;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file
+ * @brief Unit test for the object database snapshot
+ * @author agent <agent@local>
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <stdlib.h>
+#include <math.h>
+#include <zephyr/ztest.h>
+#include <bacnet/bacapp.h>
+#include <bacnet/basic/object/ao.h>
+#include <bacnet/basic/object/device.h>
+#include <bacnet/basic/object/snapshot.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static bool test_present_value_write(
+    uint32_t object_instance, uint8_t priority, bool relinquish, float value)
+{
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_APPLICATION_DATA_VALUE data_value = { 0 };
+
+    wp_data.object_type = OBJECT_ANALOG_OUTPUT;
+    wp_data.object_instance = object_instance;
+    wp_data.object_property = PROP_PRESENT_VALUE;
+    wp_data.array_index = BACNET_ARRAY_ALL;
+    wp_data.priority = priority;
+    if (relinquish) {
+        data_value.tag = BACNET_APPLICATION_TAG_NULL;
+    } else {
+        data_value.tag = BACNET_APPLICATION_TAG_REAL;
+        data_value.type.Real = value;
+    }
+    wp_data.application_data_len =
+        bacapp_encode_application_data(wp_data.application_data, &data_value);
+
+    return Device_Write_Property(&wp_data);
+}
+
+/**
+ * @brief Test the snapshot and restore of the objects
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(snapshot_tests, testSnapshot)
+#else
+static void testSnapshot(void)
+#endif
+{
+    BACNET_CREATE_OBJECT_DATA create_data = { 0 };
+    BACNET_DELETE_OBJECT_DATA delete_data = { 0 };
+    BACNET_CHARACTER_STRING name = { 0 };
+    uint8_t *buffer;
+    size_t buffer_size, len;
+    unsigned count;
+    int objects;
+    bool status;
+
+    Device_Init(NULL);
+    create_data.object_type = OBJECT_ANALOG_OUTPUT;
+    create_data.object_instance = 1;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    create_data.object_instance = 2;
+    status = Device_Create_Object(&create_data);
+    zassert_true(status, NULL);
+    status = test_present_value_write(1, 8, false, 42.0f);
+    zassert_true(status, NULL);
+    status = test_present_value_write(1, 12, false, 12.0f);
+    zassert_true(status, NULL);
+    count = Device_Object_List_Count();
+
+    buffer_size = Device_Snapshot_Encode(NULL, 0);
+    zassert_true(buffer_size > DEVICE_SNAPSHOT_HEADER_SIZE, NULL);
+    buffer = calloc(1, buffer_size);
+    zassert_not_null(buffer, NULL);
+    len = Device_Snapshot_Encode(buffer, buffer_size - 1);
+    zassert_equal(len, 0, NULL);
+    len = Device_Snapshot_Encode(buffer, buffer_size);
+    zassert_equal(len, buffer_size, NULL);
+    zassert_true(Device_Snapshot_Valid(buffer, len), NULL);
+    zassert_equal(Device_Snapshot_Header_CRC32(buffer, len),
+        Device_Snapshot_CRC32(&buffer[DEVICE_SNAPSHOT_HEADER_SIZE],
+            len - DEVICE_SNAPSHOT_HEADER_SIZE), NULL);
+    zassert_equal(Device_Snapshot_Header_CRC32(buffer, 3), 0, NULL);
+
+    /* change the values and objects after the snapshot */
+    status = test_present_value_write(1, 8, true, 0.0f);
+    zassert_true(status, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(1), 12.0f), NULL);
+    delete_data.object_type = OBJECT_ANALOG_OUTPUT;
+    delete_data.object_instance = 2;
+    status = Device_Delete_Object(&delete_data);
+    zassert_true(status, NULL);
+    zassert_false(Device_Valid_Object_Id(OBJECT_ANALOG_OUTPUT, 2), NULL);
+    status = Device_Object_Name_ANSI_Init("Renamed");
+    zassert_true(status, NULL);
+    status = Analog_Output_Name_Set(1, "Renamed");
+    zassert_true(status, NULL);
+
+    objects = Device_Snapshot_Restore(buffer, len);
+    zassert_equal(objects, (int)count, NULL);
+    zassert_true(Device_Valid_Object_Id(OBJECT_ANALOG_OUTPUT, 2), NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(1), 42.0f), NULL);
+    /* the Device name is writable and restored, while the Analog Output
+       name is read-only and keeps its value */
+    status = Device_Object_Name(Device_Object_Instance_Number(), &name);
+    zassert_true(status, NULL);
+    zassert_false(characterstring_ansi_same(&name, "Renamed"), NULL);
+    status = Analog_Output_Object_Name(1, &name);
+    zassert_true(status, NULL);
+    zassert_true(characterstring_ansi_same(&name, "Renamed"), NULL);
+    status = test_present_value_write(1, 8, true, 0.0f);
+    zassert_true(status, NULL);
+    zassert_false(
+        islessgreater(Analog_Output_Present_Value(1), 12.0f), NULL);
+
+    /* a damaged snapshot is not restored */
+    buffer[len - 1] ^= 0x55;
+    zassert_false(Device_Snapshot_Valid(buffer, len), NULL);
+    objects = Device_Snapshot_Restore(buffer, len);
+    zassert_equal(objects, BACNET_STATUS_ERROR, NULL);
+    zassert_false(Device_Snapshot_Valid(buffer, len - 1), NULL);
+    free(buffer);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(snapshot_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(snapshot_tests, ztest_unit_test(testSnapshot));
+
+    ztest_run_test_suite(snapshot_tests);
+}
+#endif
@@ -8,6 +8,7 @@
  */
 #include <zephyr/ztest.h>
 #include <bacnet/basic/object/structured_view.h>
+#include <bacnet/basic/sys/platform.h>
 #include <property_test.h>
 
 /**
@@ -41,6 +42,94 @@ static void test_object_structured_view(void)
         OBJECT_STRUCTURED_VIEW, instance, Structured_View_Property_Lists,
         Structured_View_Read_Property, NULL, skip_fail_property_list);
 }
+
+/**
+ * @brief Test ReadRange by position of the Subordinate_List
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tests_object_structured_view, test_object_structured_view_read_range)
+#else
+static void test_object_structured_view_read_range(void)
+#endif
+{
+    static BACNET_SUBORDINATE_DATA subordinate[100];
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_READ_RANGE_DATA request = { 0 };
+    RR_PROP_INFO info = { 0 };
+    BACNET_DEVICE_OBJECT_REFERENCE value = { 0 };
+    BACNET_SUBORDINATE_DATA *member;
+    const uint32_t instance = 456;
+    unsigned i;
+    int len, apdu_len;
+    bool status;
+
+    Structured_View_Init();
+    Structured_View_Create(instance);
+    for (i = 0; i < ARRAY_SIZE(subordinate); i++) {
+        subordinate[i].Device_Instance = 1234;
+        subordinate[i].Object_Type = OBJECT_ANALOG_VALUE;
+        subordinate[i].Object_Instance = i;
+        subordinate[i].next = NULL;
+        if (i > 0) {
+            subordinate[i - 1].next = &subordinate[i];
+        }
+    }
+    Structured_View_Subordinate_List_Set(instance, &subordinate[0]);
+    zassert_equal(
+        Structured_View_Subordinate_List_Count(instance),
+        ARRAY_SIZE(subordinate), NULL);
+    for (i = 0; i < ARRAY_SIZE(subordinate); i++) {
+        member = Structured_View_Subordinate_List_Member(instance, i);
+        zassert_equal(member, &subordinate[i], NULL);
+    }
+    member = Structured_View_Subordinate_List_Member(
+        instance, ARRAY_SIZE(subordinate));
+    zassert_is_null(member, NULL);
+    request.object_type = OBJECT_STRUCTURED_VIEW;
+    request.object_instance = instance;
+    request.object_property = PROP_SUBORDINATE_LIST;
+    request.array_index = BACNET_ARRAY_ALL;
+    status = Structured_View_Read_Range_Info(&request, &info);
+    zassert_true(status, NULL);
+    zassert_not_null(info.Handler, NULL);
+    request.RequestType = RR_BY_POSITION;
+    request.Overhead = RR_OVERHEAD;
+    request.Range.RefIndex = 11;
+    request.Count = 20;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_true(apdu_len > 0, NULL);
+    zassert_equal(request.ItemCount, 20, NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    for (i = 0, len = 0; i < 20; i++) {
+        len += bacnet_device_object_reference_decode(
+            &apdu[len], apdu_len - len, &value);
+        zassert_equal(value.objectIdentifier.instance, 10 + i, NULL);
+    }
+    zassert_equal(len, apdu_len, NULL);
+    request.RequestType = RR_READ_ALL;
+    apdu_len = info.Handler(apdu, &request);
+    zassert_equal(request.ItemCount, ARRAY_SIZE(subordinate), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_FIRST_ITEM), NULL);
+    zassert_true(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_LAST_ITEM), NULL);
+    zassert_false(
+        bitstring_bit(&request.ResultFlags, RESULT_FLAG_MORE_ITEMS), NULL);
+    /* not a list or array */
+    request.object_property = PROP_NODE_TYPE;
+    status = Structured_View_Read_Range_Info(&request, &info);
+    zassert_false(status, NULL);
+    /* unknown object */
+    request.object_instance = instance + 1;
+    request.object_property = PROP_SUBORDINATE_LIST;
+    status = Structured_View_Read_Range_Info(&request, &info);
+    zassert_false(status, NULL);
+    zassert_equal(request.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    Structured_View_Cleanup();
+}
 /**
  * @}
  */
@@ -52,7 +141,8 @@ void test_main(void)
 {
     ztest_test_suite(
         tests_object_structured_view, 
-        ztest_unit_test(test_object_structured_view));
+        ztest_unit_test(test_object_structured_view),
+        ztest_unit_test(test_object_structured_view_read_range));
 
     ztest_run_test_suite(tests_object_structured_view);
 }
@@ -0,0 +1,273 @@
+/**
+ * @file
+ * @brief Unit test for the Who-Is service handler
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/whois.h>
+#include <bacnet/basic/services.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+#define TEST_DEVICE_INSTANCE 1234
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the I-Am that were sent */
+static unsigned Test_I_Am_Count;
+static unsigned Test_I_Am_Unicast_Count;
+static BACNET_ADDRESS Test_I_Am_Dest;
+
+uint32_t Device_Object_Instance_Number(void)
+{
+    return TEST_DEVICE_INSTANCE;
+}
+
+void Send_I_Am(uint8_t *buffer)
+{
+    (void)buffer;
+    Test_I_Am_Count++;
+}
+
+void Send_I_Am_Unicast(uint8_t *buffer, BACNET_ADDRESS *src)
+{
+    (void)buffer;
+    bacnet_address_copy(&Test_I_Am_Dest, src);
+    Test_I_Am_Unicast_Count++;
+}
+
+/**
+ * @brief Encode the service request of a Who-Is
+ * @param request - buffer for the service request
+ * @param low_limit - low limit, or -1 for none
+ * @param high_limit - high limit, or -1 for none
+ * @return number of bytes of the service request
+ */
+static uint16_t
+test_who_is_request(uint8_t *request, int32_t low_limit, int32_t high_limit)
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    int len;
+
+    len = whois_encode_apdu(apdu, low_limit, high_limit);
+    zassert_true(len >= 2, NULL);
+    /* skip the unconfirmed service header */
+    memcpy(request, &apdu[2], len - 2);
+
+    return (uint16_t)(len - 2);
+}
+
+/**
+ * @brief Initialize the source address of a Who-Is
+ * @param src - address to be initialized
+ * @param mac - MAC address of the source
+ */
+static void test_source(BACNET_ADDRESS *src, uint8_t mac)
+{
+    memset(src, 0, sizeof(*src));
+    src->mac_len = 1;
+    src->mac[0] = mac;
+}
+
+/**
+ * @brief Send anything pending, and reset the handler and the counters
+ */
+static void test_reset(void)
+{
+    handler_who_is_jitter_set(0);
+    handler_who_is_interval_set(0);
+    handler_who_is_timer(UINT16_MAX);
+    zassert_false(handler_who_is_pending(), NULL);
+    Test_I_Am_Count = 0;
+    Test_I_Am_Unicast_Count = 0;
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsImmediate)
+#else
+static void testWhoIsImmediate(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint16_t len;
+
+    test_reset();
+    test_source(&src, 1);
+    /* without a jitter or an interval, the I-Am is sent at once */
+    len = test_who_is_request(request, -1, -1);
+    handler_who_is(request, len, &src);
+    zassert_equal(Test_I_Am_Count, 1, NULL);
+    zassert_false(handler_who_is_pending(), NULL);
+    handler_who_is_unicast(request, len, &src);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    zassert_true(bacnet_address_same(&Test_I_Am_Dest, &src), NULL);
+    /* within the limits */
+    len = test_who_is_request(
+        request, TEST_DEVICE_INSTANCE, TEST_DEVICE_INSTANCE);
+    handler_who_is(request, len, &src);
+    zassert_equal(Test_I_Am_Count, 2, NULL);
+    /* outside of the limits */
+    len = test_who_is_request(request, 0, TEST_DEVICE_INSTANCE - 1);
+    handler_who_is(request, len, &src);
+    handler_who_is_unicast(request, len, &src);
+    len = test_who_is_request(
+        request, TEST_DEVICE_INSTANCE + 1, BACNET_MAX_INSTANCE);
+    handler_who_is(request, len, &src);
+    zassert_equal(Test_I_Am_Count, 2, NULL);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    /* malformed: a low limit without a high limit */
+    len = test_who_is_request(
+        request, TEST_DEVICE_INSTANCE, TEST_DEVICE_INSTANCE);
+    handler_who_is(request, len / 2, &src);
+    zassert_equal(Test_I_Am_Count, 2, NULL);
+    zassert_false(handler_who_is_pending(), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsJitter)
+#else
+static void testWhoIsJitter(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    const uint16_t jitter = 100;
+    uint16_t len, elapsed, delay_min = UINT16_MAX, delay_max = 0;
+    unsigned i;
+
+    test_reset();
+    test_source(&src, 1);
+    handler_who_is_jitter_set(jitter);
+    len = test_who_is_request(request, -1, -1);
+    for (i = 0; i < 50; i++) {
+        handler_who_is(request, len, &src);
+        zassert_equal(Test_I_Am_Count, i, NULL);
+        /* the I-Am is sent once its random delay has elapsed */
+        elapsed = 0;
+        while (handler_who_is_pending()) {
+            zassert_true(elapsed <= jitter, NULL);
+            handler_who_is_timer(1);
+            elapsed++;
+        }
+        zassert_equal(Test_I_Am_Count, i + 1, NULL);
+        if (elapsed < delay_min) {
+            delay_min = elapsed;
+        }
+        if (elapsed > delay_max) {
+            delay_max = elapsed;
+        }
+    }
+    /* the delays are spread out over the jitter */
+    zassert_true(delay_min < (jitter / 4), NULL);
+    zassert_true(delay_max > (3 * jitter / 4), NULL);
+    zassert_true(delay_max <= (jitter + 1), NULL);
+    /* the timer does nothing when no I-Am is waiting */
+    handler_who_is_timer(jitter);
+    zassert_equal(Test_I_Am_Count, 50, NULL);
+    zassert_equal(Test_I_Am_Unicast_Count, 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsCoalesce)
+#else
+static void testWhoIsCoalesce(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    BACNET_ADDRESS src2 = { 0 };
+    uint16_t len;
+
+    test_reset();
+    test_source(&src, 1);
+    test_source(&src2, 2);
+    handler_who_is_jitter_set(100);
+    len = test_who_is_request(request, -1, -1);
+    /* two unicast requests from the same source: one unicast I-Am */
+    handler_who_is_unicast(request, len, &src);
+    handler_who_is_unicast(request, len, &src);
+    zassert_true(handler_who_is_pending(), NULL);
+    handler_who_is_timer(UINT16_MAX);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    zassert_equal(Test_I_Am_Count, 0, NULL);
+    zassert_true(bacnet_address_same(&Test_I_Am_Dest, &src), NULL);
+    /* unicast requests from two sources: one broadcast I-Am */
+    handler_who_is_unicast(request, len, &src);
+    handler_who_is_unicast(request, len, &src2);
+    handler_who_is_timer(UINT16_MAX);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    zassert_equal(Test_I_Am_Count, 1, NULL);
+    /* a unicast and a broadcast request: one broadcast I-Am */
+    handler_who_is_unicast(request, len, &src);
+    handler_who_is(request, len, &src2);
+    handler_who_is_timer(UINT16_MAX);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    zassert_equal(Test_I_Am_Count, 2, NULL);
+    /* a broadcast, then a unicast request: still one broadcast I-Am */
+    handler_who_is(request, len, &src2);
+    handler_who_is_unicast(request, len, &src);
+    handler_who_is_timer(UINT16_MAX);
+    zassert_equal(Test_I_Am_Unicast_Count, 1, NULL);
+    zassert_equal(Test_I_Am_Count, 3, NULL);
+    zassert_false(handler_who_is_pending(), NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_whois_tests, testWhoIsInterval)
+#else
+static void testWhoIsInterval(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    uint16_t len;
+
+    test_reset();
+    test_source(&src, 1);
+    handler_who_is_interval_set(1000);
+    len = test_who_is_request(request, -1, -1);
+    /* the first I-Am is sent at the next timer call */
+    handler_who_is(request, len, &src);
+    zassert_true(handler_who_is_pending(), NULL);
+    handler_who_is_timer(0);
+    zassert_equal(Test_I_Am_Count, 1, NULL);
+    /* the next I-Am waits for the interval */
+    handler_who_is(request, len, &src);
+    handler_who_is_timer(999);
+    zassert_equal(Test_I_Am_Count, 1, NULL);
+    zassert_true(handler_who_is_pending(), NULL);
+    handler_who_is_timer(1);
+    zassert_equal(Test_I_Am_Count, 2, NULL);
+    /* after the interval, the I-Am is not held back */
+    handler_who_is_timer(1000);
+    handler_who_is(request, len, &src);
+    handler_who_is_timer(0);
+    zassert_equal(Test_I_Am_Count, 3, NULL);
+    /* no interval and no jitter: sent at once again */
+    handler_who_is_interval_set(0);
+    handler_who_is(request, len, &src);
+    zassert_equal(Test_I_Am_Count, 4, NULL);
+    zassert_false(handler_who_is_pending(), NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_whois_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_whois_tests, ztest_unit_test(testWhoIsImmediate),
+        ztest_unit_test(testWhoIsJitter), ztest_unit_test(testWhoIsCoalesce),
+        ztest_unit_test(testWhoIsInterval));
+
+    ztest_run_test_suite(h_whois_tests);
+}
+#endif
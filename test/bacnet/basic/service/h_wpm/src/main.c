@@ -0,0 +1,248 @@
+/**
+ * @file
+ * @brief Unit test for the WritePropertyMultiple service handler
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/npdu.h>
+#include <bacnet/wpm.h>
+#include <bacnet/basic/service/h_wpm.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/* the largest object instance that exists */
+#define TEST_OBJECT_INSTANCE_MAX 10
+
+uint8_t Handler_Transmit_Buffer[MAX_PDU];
+/* the PDU that was sent */
+static uint8_t Test_PDU[MAX_PDU];
+static unsigned Test_PDU_Len;
+/* the property writes that were applied */
+static unsigned Test_Write_Count;
+static unsigned Test_Check_Count;
+
+bool Device_Write_Property(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    if (wp_data->object_instance > TEST_OBJECT_INSTANCE_MAX) {
+        wp_data->error_class = ERROR_CLASS_OBJECT;
+        wp_data->error_code = ERROR_CODE_UNKNOWN_OBJECT;
+        return false;
+    }
+    Test_Write_Count++;
+
+    return true;
+}
+
+int datalink_send_pdu(BACNET_ADDRESS *dest,
+    BACNET_NPDU_DATA *npdu_data,
+    uint8_t *pdu,
+    unsigned pdu_len)
+{
+    (void)dest;
+    (void)npdu_data;
+    if (pdu_len > sizeof(Test_PDU)) {
+        return -1;
+    }
+    memcpy(Test_PDU, pdu, pdu_len);
+    Test_PDU_Len = pdu_len;
+
+    return (int)pdu_len;
+}
+
+void datalink_get_my_address(BACNET_ADDRESS *my_address)
+{
+    memset(my_address, 0, sizeof(*my_address));
+}
+
+/**
+ * @brief Check function that refuses writes to the present-value
+ *  of instance 2
+ */
+static bool test_write_property_check(BACNET_WRITE_PROPERTY_DATA *wp_data)
+{
+    Test_Check_Count++;
+    if ((wp_data->object_instance == 2) &&
+        (wp_data->object_property == PROP_PRESENT_VALUE)) {
+        wp_data->error_class = ERROR_CLASS_PROPERTY;
+        wp_data->error_code = ERROR_CODE_VALUE_OUT_OF_RANGE;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Encode a WritePropertyMultiple request of one present-value
+ *  write to each of the Analog Value instances
+ * @param apdu - buffer for the service request
+ * @param apdu_size - size of the buffer
+ * @param instances - Analog Value instances to write
+ * @param count - number of instances
+ * @return number of bytes of the service request
+ */
+static int test_wpm_request_encode(
+    uint8_t *apdu, size_t apdu_size, const uint32_t *instances, unsigned count)
+{
+    BACNET_WRITE_ACCESS_DATA write_access_data[8] = { 0 };
+    BACNET_PROPERTY_VALUE property_value[8] = { 0 };
+    unsigned i;
+    int len;
+
+    zassert_true(count <= 8, NULL);
+    wpm_write_access_data_link_array(write_access_data, count);
+    for (i = 0; i < count; i++) {
+        write_access_data[i].object_type = OBJECT_ANALOG_VALUE;
+        write_access_data[i].object_instance = instances[i];
+        write_access_data[i].listOfProperties = &property_value[i];
+        bacapp_property_value_list_init(&property_value[i], 1);
+        property_value[i].propertyIdentifier = PROP_PRESENT_VALUE;
+        property_value[i].value.tag = BACNET_APPLICATION_TAG_REAL;
+        property_value[i].value.type.Real = (float)i;
+    }
+    len = wpm_encode_apdu(apdu, apdu_size, 1, write_access_data);
+    zassert_true(len > 4, NULL);
+    /* skip the confirmed service header */
+    memmove(apdu, &apdu[4], len - 4);
+
+    return len - 4;
+}
+
+/**
+ * @brief Run the handler on a request and return the reply APDU
+ * @param request - service request
+ * @param request_len - number of bytes in the request
+ * @return reply APDU
+ */
+static uint8_t *test_wpm_handler(uint8_t *request, int request_len)
+{
+    BACNET_ADDRESS src = { 0 };
+    BACNET_CONFIRMED_SERVICE_DATA service_data = { 0 };
+    BACNET_NPDU_DATA npdu_data = { 0 };
+    int len;
+
+    service_data.invoke_id = 1;
+    Test_PDU_Len = 0;
+    Test_Write_Count = 0;
+    Test_Check_Count = 0;
+    handler_write_property_multiple(
+        request, (uint16_t)request_len, &src, &service_data);
+    zassert_true(Test_PDU_Len > 0, NULL);
+    len = bacnet_npdu_decode(Test_PDU, Test_PDU_Len, NULL, NULL, &npdu_data);
+    zassert_true(len > 0, NULL);
+
+    return &Test_PDU[len];
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_wpm_tests, testWPMHandler)
+#else
+static void testWPMHandler(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    uint32_t instances[8] = { 1, 2, 3, 4, 5 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint8_t *apdu;
+    int len;
+
+    /* every property is written */
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    /* unknown object without a check: the writes before it stay */
+    instances[2] = TEST_OBJECT_INSTANCE_MAX + 1;
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(Test_Write_Count, 2, NULL);
+    len = wpm_error_ack_decode_apdu(&apdu[3], MAX_APDU, &wp_data);
+    zassert_true(len > 0, NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_OBJECT, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_UNKNOWN_OBJECT, NULL);
+    zassert_equal(wp_data.object_instance, instances[2], NULL);
+    instances[2] = 3;
+    /* more property writes than the plan holds: nothing is written */
+    len = test_wpm_request_encode(
+        request, sizeof(request), instances, BACNET_WPM_PLAN_MAX + 1);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_ABORT | 1, NULL);
+    zassert_equal(apdu[2], ABORT_REASON_BUFFER_OVERFLOW, NULL);
+    zassert_equal(Test_Write_Count, 0, NULL);
+    /* a malformed request: nothing is written */
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len - 3);
+    zassert_not_equal(apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(Test_Write_Count, 0, NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(h_wpm_tests, testWPMHandlerCheck)
+#else
+static void testWPMHandlerCheck(void)
+#endif
+{
+    uint8_t request[MAX_APDU] = { 0 };
+    uint32_t instances[3] = { 1, 2, 3 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    uint8_t *apdu;
+    int len;
+
+    /* a check that fails: nothing is written */
+    handler_write_property_multiple_check_default_set(
+        test_write_property_check);
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(Test_Check_Count, 2, NULL);
+    zassert_equal(Test_Write_Count, 0, NULL);
+    len = wpm_error_ack_decode_apdu(&apdu[3], MAX_APDU, &wp_data);
+    zassert_true(len > 0, NULL);
+    zassert_equal(wp_data.error_class, ERROR_CLASS_PROPERTY, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_VALUE_OUT_OF_RANGE, NULL);
+    zassert_equal(wp_data.object_instance, 2, NULL);
+    /* every check passes: every property is written */
+    instances[1] = 4;
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(Test_Check_Count, 3, NULL);
+    zassert_equal(Test_Write_Count, 3, NULL);
+    /* the check of the object type is used before the default */
+    handler_write_property_multiple_check_default_set(NULL);
+    handler_write_property_multiple_check_set(
+        OBJECT_ANALOG_VALUE, test_write_property_check);
+    instances[1] = 2;
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(Test_Write_Count, 0, NULL);
+    handler_write_property_multiple_check_set(OBJECT_ANALOG_VALUE, NULL);
+    /* without a check, every property is written */
+    len = test_wpm_request_encode(request, sizeof(request), instances, 3);
+    apdu = test_wpm_handler(request, len);
+    zassert_equal(apdu[0], PDU_TYPE_SIMPLE_ACK, NULL);
+    zassert_equal(Test_Check_Count, 0, NULL);
+    zassert_equal(Test_Write_Count, 3, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(h_wpm_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(h_wpm_tests, ztest_unit_test(testWPMHandler),
+        ztest_unit_test(testWPMHandlerCheck));
+
+    ztest_run_test_suite(h_wpm_tests);
+}
+#endif
@@ -0,0 +1,123 @@
+/**
+ * @file
+ * @brief Unit test for the BACnet Stack performance counters
+ * @author agent <agent@local>
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/metrics.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+static uint32_t Test_Clock_us;
+
+static uint32_t test_clock(void)
+{
+    return Test_Clock_us;
+}
+
+/**
+ * @brief Test the counters
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, test_metrics_counters)
+#else
+static void test_metrics_counters(void)
+#endif
+{
+    unsigned i;
+
+    bacnet_metrics_reset();
+    for (i = 0; i < BACNET_METRIC_MAX; i++) {
+        zassert_equal(bacnet_metrics_counter((BACNET_METRIC_ID)i), 0, NULL);
+        zassert_not_null(bacnet_metrics_name((BACNET_METRIC_ID)i), NULL);
+    }
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_TSM_RETRIES);
+    BACNET_METRICS_INCREMENT(BACNET_METRIC_TSM_RETRIES);
+    bacnet_metrics_increment(BACNET_METRIC_ADDRESS_CACHE_HITS);
+    bacnet_metrics_increment(BACNET_METRIC_MAX);
+    zassert_equal(bacnet_metrics_counter(BACNET_METRIC_TSM_RETRIES), 2, NULL);
+    zassert_equal(
+        bacnet_metrics_counter(BACNET_METRIC_ADDRESS_CACHE_HITS), 1, NULL);
+    zassert_equal(bacnet_metrics_counter(BACNET_METRIC_MAX), 0, NULL);
+    zassert_is_null(bacnet_metrics_name(BACNET_METRIC_MAX), NULL);
+    bacnet_metrics_reset();
+    zassert_equal(bacnet_metrics_counter(BACNET_METRIC_TSM_RETRIES), 0, NULL);
+}
+
+/**
+ * @brief Test the service latency histograms
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(metrics_tests, test_metrics_histogram)
+#else
+static void test_metrics_histogram(void)
+#endif
+{
+    BACNET_METRICS_HISTOGRAM histogram = { 0 };
+    uint32_t start;
+    unsigned i;
+
+    bacnet_metrics_reset();
+    /* without a clock, only the count is kept */
+    bacnet_metrics_clock_set(NULL);
+    start = BACNET_METRICS_TIMESTAMP();
+    BACNET_METRICS_CONFIRMED_SERVICE(SERVICE_CONFIRMED_READ_PROPERTY, start);
+    zassert_true(bacnet_metrics_confirmed_service(
+                     SERVICE_CONFIRMED_READ_PROPERTY, &histogram),
+        NULL);
+    zassert_equal(histogram.count, 1, NULL);
+    zassert_equal(histogram.bucket[0], 1, NULL);
+    zassert_false(bacnet_metrics_confirmed_service(
+                      MAX_BACNET_CONFIRMED_SERVICE, &histogram),
+        NULL);
+    /* 90 fast requests and 10 slow ones */
+    bacnet_metrics_clock_set(test_clock);
+    Test_Clock_us = 0xFFFFFF00UL;
+    for (i = 0; i < 100; i++) {
+        start = BACNET_METRICS_TIMESTAMP();
+        /* the clock wraps during the measurement */
+        Test_Clock_us += (i < 90) ? 300 : 5000;
+        BACNET_METRICS_UNCONFIRMED_SERVICE(SERVICE_UNCONFIRMED_WHO_IS, start);
+    }
+    zassert_true(bacnet_metrics_unconfirmed_service(
+                     SERVICE_UNCONFIRMED_WHO_IS, &histogram),
+        NULL);
+    zassert_equal(histogram.count, 100, NULL);
+    zassert_equal(histogram.max_us, 5000, NULL);
+    zassert_equal(histogram.total_us, (90 * 300) + (10 * 5000), NULL);
+    /* 300us is in the 256..511 bucket, 5000us in the 4096..8191 bucket */
+    zassert_equal(histogram.bucket[9], 90, NULL);
+    zassert_equal(histogram.bucket[13], 10, NULL);
+    zassert_equal(bacnet_metrics_histogram_percentile(&histogram, 50), 511,
+        NULL);
+    zassert_equal(bacnet_metrics_histogram_percentile(&histogram, 90), 511,
+        NULL);
+    zassert_equal(bacnet_metrics_histogram_percentile(&histogram, 99), 5000,
+        NULL);
+    /* very long latency lands in the last bucket */
+    bacnet_metrics_histogram_add(&histogram, UINT32_MAX);
+    zassert_equal(
+        histogram.bucket[BACNET_METRICS_HISTOGRAM_BUCKETS - 1], 1, NULL);
+    bacnet_metrics_clock_set(NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(metrics_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(metrics_tests, ztest_unit_test(test_metrics_counters),
+        ztest_unit_test(test_metrics_histogram));
+
+    ztest_run_test_suite(metrics_tests);
+}
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file
+ * @brief test of the PDU buffer with headroom and tailroom
+ * @author agent <agent@local>
+ * @date 2026
+ * @copyright SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <zephyr/ztest.h>
+#include <bacnet/basic/sys/pdubuf.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(pdubuf_tests, testPduBuffer)
+#else
+static void testPduBuffer(void)
+#endif
+{
+    BACNET_PDU_BUFFER pdu = { 0 };
+    uint8_t data_buffer[64] = { 0 };
+    const uint8_t bvlc[4] = { 0x81, 0x0a, 0x00, 0x0c };
+    const uint8_t npci[2] = { 0x01, 0x00 };
+    const uint8_t apdu[6] = { 0x10, 0x08, 0x09, 0x00, 0x19, 0x63 };
+    const uint8_t routed_npci[6] = { 0x01, 0x08, 0x00, 0x02, 0x01, 0x05 };
+    uint8_t *data;
+    unsigned i;
+
+    zassert_is_null(pdubuf_data(&pdu), NULL);
+    zassert_is_null(pdubuf_put(&pdu, 1), NULL);
+    pdubuf_init(&pdu, data_buffer, sizeof(data_buffer), 16);
+    zassert_equal(pdubuf_length(&pdu), 0, NULL);
+    zassert_equal(pdubuf_headroom(&pdu), 16, NULL);
+    zassert_equal(pdubuf_tailroom(&pdu), sizeof(data_buffer) - 16, NULL);
+    zassert_equal(pdubuf_data(&pdu), &data_buffer[16], NULL);
+    zassert_equal(pdubuf_tail(&pdu), &data_buffer[16], NULL);
+    /* receive a BVLC+NPDU at the tail, as a datalink would */
+    data = pdubuf_tail(&pdu);
+    memcpy(data, bvlc, sizeof(bvlc));
+    memcpy(&data[sizeof(bvlc)], npci, sizeof(npci));
+    memcpy(&data[sizeof(bvlc) + sizeof(npci)], apdu, sizeof(apdu));
+    zassert_equal(pdubuf_put(&pdu, 12), data, NULL);
+    zassert_equal(pdubuf_length(&pdu), 12, NULL);
+    /* strip the BVLC header without shifting the NPDU */
+    data = pdubuf_pull(&pdu, sizeof(bvlc));
+    zassert_equal(data, &data_buffer[16 + sizeof(bvlc)], NULL);
+    zassert_equal(pdubuf_length(&pdu), 8, NULL);
+    zassert_equal(memcmp(data, npci, sizeof(npci)), 0, NULL);
+    zassert_is_null(pdubuf_pull(&pdu, 9), NULL);
+    zassert_equal(pdubuf_length(&pdu), 8, NULL);
+    /* rewrite the NPCI in place with a longer routed header */
+    zassert_not_null(pdubuf_pull(&pdu, sizeof(npci)), NULL);
+    data = pdubuf_push(&pdu, sizeof(routed_npci));
+    zassert_not_null(data, NULL);
+    memcpy(data, routed_npci, sizeof(routed_npci));
+    zassert_equal(pdubuf_length(&pdu), 12, NULL);
+    zassert_equal(pdubuf_headroom(&pdu), 16, NULL);
+    zassert_equal(
+        memcmp(&data[sizeof(routed_npci)], apdu, sizeof(apdu)), 0, NULL);
+    zassert_is_null(pdubuf_push(&pdu, 17), NULL);
+    /* not enough tailroom */
+    zassert_is_null(pdubuf_put(&pdu, pdubuf_tailroom(&pdu) + 1), NULL);
+    /* trim a trailer */
+    zassert_true(pdubuf_trim(&pdu, 10), NULL);
+    zassert_equal(pdubuf_length(&pdu), 10, NULL);
+    zassert_false(pdubuf_trim(&pdu, 11), NULL);
+    /* users of the buffer */
+    zassert_true(pdubuf_ref(&pdu), NULL);
+    zassert_false(pdubuf_unref(&pdu), NULL);
+    zassert_true(pdubuf_unref(&pdu), NULL);
+    zassert_false(pdubuf_ref(&pdu), NULL);
+    zassert_false(pdubuf_unref(&pdu), NULL);
+    /* a full counter refuses another user, and is not released early */
+    pdubuf_init(&pdu, data_buffer, sizeof(data_buffer), 16);
+    for (i = 1; i < UINT8_MAX; i++) {
+        zassert_true(pdubuf_ref(&pdu), NULL);
+    }
+    zassert_false(pdubuf_ref(&pdu), NULL);
+    for (i = 1; i < UINT8_MAX; i++) {
+        zassert_false(pdubuf_unref(&pdu), NULL);
+    }
+    zassert_true(pdubuf_unref(&pdu), NULL);
+    /* empty again */
+    pdubuf_reset(&pdu, sizeof(data_buffer) + 1);
+    zassert_equal(pdubuf_headroom(&pdu), sizeof(data_buffer), NULL);
+    zassert_equal(pdubuf_tailroom(&pdu), 0, NULL);
+    zassert_equal(pdubuf_length(&pdu), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(pdubuf_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(pdubuf_tests, ztest_unit_test(testPduBuffer));
+
+    ztest_run_test_suite(pdubuf_tests);
+}
+#endif
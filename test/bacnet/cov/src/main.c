@@ -380,6 +380,236 @@ static void testCOVSubscribeProperty(void)
     data.covIncrementPresent = false;
     testCOVSubscribePropertyEncoding(invoke_id, &data);
 }
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, testCOVSubscribePropertyMultiple)
+#else
+static void testCOVSubscribePropertyMultiple(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_COV_REFERENCE references[3] = { 0 };
+    BACNET_COV_REFERENCE test_references[3] = { 0 };
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA data = { 0 };
+    BACNET_SUBSCRIBE_COV_MULTIPLE_DATA test_data = { 0 };
+    uint8_t invoke_id = 12;
+    int len, null_len, test_len, i;
+
+    references[0].monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    references[0].monitoredObjectIdentifier.instance = 1;
+    references[0].monitoredProperty.propertyIdentifier = PROP_PRESENT_VALUE;
+    references[0].monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    references[0].covIncrementPresent = true;
+    references[0].covIncrement = 0.5f;
+    references[0].timestamped = true;
+    references[1].monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    references[1].monitoredObjectIdentifier.instance = 1;
+    references[1].monitoredProperty.propertyIdentifier = PROP_STATUS_FLAGS;
+    references[1].monitoredProperty.propertyArrayIndex = BACNET_ARRAY_ALL;
+    references[2].monitoredObjectIdentifier.type = OBJECT_BINARY_VALUE;
+    references[2].monitoredObjectIdentifier.instance = 2;
+    references[2].monitoredProperty.propertyIdentifier = PROP_PRIORITY_ARRAY;
+    references[2].monitoredProperty.propertyArrayIndex = 8;
+    data.subscriberProcessIdentifier = 1;
+    data.issueConfirmedNotifications = true;
+    data.lifetime = 300;
+    data.maxNotificationDelay = 5;
+    data.references = references;
+    data.reference_count = 3;
+
+    null_len = cov_subscribe_property_multiple_encode_apdu(
+        NULL, sizeof(apdu), invoke_id, &data);
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), invoke_id, &data);
+    zassert_true(len > 4, NULL);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(apdu[3], SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE,
+        NULL);
+    /* count only */
+    test_len = cov_subscribe_property_multiple_decode_service_request(
+        &apdu[4], len - 4, &test_data);
+    zassert_equal(test_len, len - 4, NULL);
+    zassert_equal(test_data.reference_count, 3, NULL);
+    test_data.references = test_references;
+    test_data.reference_size = 3;
+    test_len = cov_subscribe_property_multiple_decode_service_request(
+        &apdu[4], len - 4, &test_data);
+    zassert_equal(test_len, len - 4, NULL);
+    zassert_equal(test_data.subscriberProcessIdentifier, 1, NULL);
+    zassert_false(test_data.cancellationRequest, NULL);
+    zassert_true(test_data.issueConfirmedNotifications, NULL);
+    zassert_equal(test_data.lifetime, 300, NULL);
+    zassert_equal(test_data.maxNotificationDelay, 5, NULL);
+    zassert_equal(test_data.reference_count, 3, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(test_references[i].monitoredObjectIdentifier.type,
+            references[i].monitoredObjectIdentifier.type, NULL);
+        zassert_equal(test_references[i].monitoredObjectIdentifier.instance,
+            references[i].monitoredObjectIdentifier.instance, NULL);
+        zassert_equal(test_references[i].monitoredProperty.propertyIdentifier,
+            references[i].monitoredProperty.propertyIdentifier, NULL);
+        zassert_equal(test_references[i].monitoredProperty.propertyArrayIndex,
+            references[i].monitoredProperty.propertyArrayIndex, NULL);
+        zassert_equal(test_references[i].covIncrementPresent,
+            references[i].covIncrementPresent, NULL);
+        zassert_equal(test_references[i].timestamped,
+            references[i].timestamped, NULL);
+    }
+    zassert_false(islessgreater(test_references[0].covIncrement, 0.5f), NULL);
+    /* too many references */
+    test_data.reference_size = 2;
+    test_len = cov_subscribe_property_multiple_decode_service_request(
+        &apdu[4], len - 4, &test_data);
+    zassert_equal(test_len, BACNET_STATUS_ABORT, NULL);
+    zassert_equal(test_data.error_code, ERROR_CODE_ABORT_OUT_OF_RESOURCES,
+        NULL);
+    /* malformed */
+    while (--len > 4) {
+        test_data.reference_size = 3;
+        test_len = cov_subscribe_property_multiple_decode_service_request(
+            &apdu[4], len - 4, &test_data);
+        zassert_true(test_len < 0, "len=%d test_len=%d", len, test_len);
+    }
+    /* cancellation */
+    data.cancellationRequest = true;
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, sizeof(apdu), invoke_id, &data);
+    test_data.reference_size = 3;
+    test_len = cov_subscribe_property_multiple_decode_service_request(
+        &apdu[4], len - 4, &test_data);
+    zassert_equal(test_len, len - 4, NULL);
+    zassert_true(test_data.cancellationRequest, NULL);
+    zassert_equal(test_data.reference_count, 3, NULL);
+    /* too small */
+    len = cov_subscribe_property_multiple_encode_apdu(
+        apdu, 10, invoke_id, &data);
+    zassert_equal(len, 0, NULL);
+    /* error */
+    data.failed_index = 2;
+    data.error_class = ERROR_CLASS_PROPERTY;
+    data.error_code = ERROR_CODE_NOT_COV_PROPERTY;
+    null_len =
+        cov_subscribe_property_multiple_error_encode_apdu(NULL, 1, &data);
+    len = cov_subscribe_property_multiple_error_encode_apdu(apdu, 1, &data);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_ERROR, NULL);
+    zassert_equal(apdu[1], 1, NULL);
+    zassert_equal(apdu[2], SERVICE_CONFIRMED_SUBSCRIBE_COV_PROPERTY_MULTIPLE,
+        NULL);
+    zassert_true(bacnet_is_opening_tag_number(&apdu[3], len - 3, 0, NULL),
+        NULL);
+}
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(cov_tests, testCOVNotifyMultiple)
+#else
+static void testCOVNotifyMultiple(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    uint8_t value_apdu[2][8] = { 0 };
+    BACNET_COV_MULTIPLE_VALUE values[3] = { 0 };
+    BACNET_COV_MULTIPLE_VALUE test_values[3] = { 0 };
+    BACNET_COV_MULTIPLE_DATA data = { 0 };
+    BACNET_COV_MULTIPLE_DATA test_data = { 0 };
+    BACNET_BIT_STRING bit_string;
+    int len, null_len, test_len, i;
+
+    values[0].monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    values[0].monitoredObjectIdentifier.instance = 1;
+    values[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    values[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    values[0].value = value_apdu[0];
+    values[0].value_len = encode_application_real(value_apdu[0], 21.5f);
+    values[0].timeOfChangePresent = true;
+    values[0].timeOfChange.hour = 10;
+    values[0].timeOfChange.min = 20;
+    values[0].timeOfChange.sec = 30;
+    values[1].monitoredObjectIdentifier.type = OBJECT_ANALOG_INPUT;
+    values[1].monitoredObjectIdentifier.instance = 1;
+    values[1].propertyIdentifier = PROP_STATUS_FLAGS;
+    values[1].propertyArrayIndex = BACNET_ARRAY_ALL;
+    bitstring_init(&bit_string);
+    bitstring_set_bit(&bit_string, STATUS_FLAG_IN_ALARM, false);
+    bitstring_set_bit(&bit_string, STATUS_FLAG_FAULT, true);
+    bitstring_set_bit(&bit_string, STATUS_FLAG_OVERRIDDEN, false);
+    bitstring_set_bit(&bit_string, STATUS_FLAG_OUT_OF_SERVICE, false);
+    values[1].value = value_apdu[1];
+    values[1].value_len =
+        encode_application_bitstring(value_apdu[1], &bit_string);
+    values[2].monitoredObjectIdentifier.type = OBJECT_BINARY_VALUE;
+    values[2].monitoredObjectIdentifier.instance = 2;
+    values[2].propertyIdentifier = PROP_PRIORITY_ARRAY;
+    values[2].propertyArrayIndex = 8;
+    values[2].value = value_apdu[0];
+    values[2].value_len = values[0].value_len;
+    data.subscriberProcessIdentifier = 7;
+    data.initiatingDeviceIdentifier = 1234;
+    data.timeRemaining = 60;
+    data.timestampPresent = true;
+    datetime_set_values(&data.timestamp, 2024, 1, 2, 3, 4, 5, 0);
+    data.values = values;
+    data.value_count = 3;
+
+    null_len = ccov_notify_multiple_encode_apdu(NULL, sizeof(apdu), 3, &data);
+    len = ccov_notify_multiple_encode_apdu(apdu, sizeof(apdu), 3, &data);
+    zassert_true(len > 4, NULL);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(apdu[2], 3, NULL);
+    zassert_equal(apdu[3], SERVICE_CONFIRMED_COV_NOTIFICATION_MULTIPLE, NULL);
+    test_data.values = test_values;
+    test_data.value_size = 3;
+    test_len = cov_notify_multiple_decode_service_request(
+        &apdu[4], len - 4, &test_data);
+    zassert_equal(test_len, len - 4, NULL);
+    zassert_equal(test_data.subscriberProcessIdentifier, 7, NULL);
+    zassert_equal(test_data.initiatingDeviceIdentifier, 1234, NULL);
+    zassert_equal(test_data.timeRemaining, 60, NULL);
+    zassert_true(test_data.timestampPresent, NULL);
+    zassert_equal(
+        datetime_compare(&test_data.timestamp, &data.timestamp), 0, NULL);
+    zassert_equal(test_data.value_count, 3, NULL);
+    for (i = 0; i < 3; i++) {
+        zassert_equal(test_values[i].monitoredObjectIdentifier.type,
+            values[i].monitoredObjectIdentifier.type, NULL);
+        zassert_equal(test_values[i].monitoredObjectIdentifier.instance,
+            values[i].monitoredObjectIdentifier.instance, NULL);
+        zassert_equal(test_values[i].propertyIdentifier,
+            values[i].propertyIdentifier, NULL);
+        zassert_equal(test_values[i].propertyArrayIndex,
+            values[i].propertyArrayIndex, NULL);
+        zassert_equal(test_values[i].value_len, values[i].value_len, NULL);
+        zassert_equal(memcmp(test_values[i].value, values[i].value,
+                          values[i].value_len),
+            0, NULL);
+        zassert_equal(test_values[i].timeOfChangePresent,
+            values[i].timeOfChangePresent, NULL);
+    }
+    zassert_equal(test_values[0].timeOfChange.hour, 10, NULL);
+    zassert_equal(test_values[0].timeOfChange.sec, 30, NULL);
+    /* malformed */
+    while (--len > 4) {
+        test_len = cov_notify_multiple_decode_service_request(
+            &apdu[4], len - 4, &test_data);
+        zassert_true(test_len < 0, "len=%d test_len=%d", len, test_len);
+    }
+    /* unconfirmed */
+    data.timestampPresent = false;
+    null_len = ucov_notify_multiple_encode_apdu(NULL, sizeof(apdu), &data);
+    len = ucov_notify_multiple_encode_apdu(apdu, sizeof(apdu), &data);
+    zassert_equal(len, null_len, NULL);
+    zassert_equal(apdu[0], PDU_TYPE_UNCONFIRMED_SERVICE_REQUEST, NULL);
+    zassert_equal(
+        apdu[1], SERVICE_UNCONFIRMED_COV_NOTIFICATION_MULTIPLE, NULL);
+    test_len = cov_notify_multiple_decode_service_request(
+        &apdu[2], len - 2, &test_data);
+    zassert_equal(test_len, len - 2, NULL);
+    zassert_false(test_data.timestampPresent, NULL);
+    zassert_equal(test_data.value_count, 3, NULL);
+    /* too small */
+    len = ucov_notify_multiple_encode_apdu(apdu, 20, &data);
+    zassert_equal(len, 0, NULL);
+}
 /**
  * @}
  */
@@ -392,7 +622,9 @@ void test_main(void)
     ztest_test_suite(
         cov_tests, ztest_unit_test(testCOVNotify),
         ztest_unit_test(testCOVSubscribe),
-        ztest_unit_test(testCOVSubscribeProperty));
+        ztest_unit_test(testCOVSubscribeProperty),
+        ztest_unit_test(testCOVSubscribePropertyMultiple),
+        ztest_unit_test(testCOVNotifyMultiple));
 
     ztest_run_test_suite(cov_tests);
 }
@@ -0,0 +1,194 @@
+/**
+ * @file
+ * @brief Unit test for the BACnet in-process loopback datalink
+ * @author agent <agent@local>
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <string.h>
+#include <time.h>
+#include <zephyr/ztest.h>
+#include <bacnet/datalink/loopback.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test unicast and broadcast between ports
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_send_receive)
+#else
+static void test_loopback_send_receive(void)
+#endif
+{
+    uint8_t pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    uint8_t test_pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    BACNET_ADDRESS dest = { 0 }, src = { 0 }, my_address = { 0 };
+    LOOPBACK_STATISTICS stats = { 0 };
+    uint16_t pdu_len;
+    int len;
+
+    loopback_reset();
+    loopback_simulated_time_set(true);
+    zassert_true(loopback_init("1"), NULL);
+    zassert_true(loopback_port_create(2), NULL);
+    zassert_true(loopback_port_create(3), NULL);
+    zassert_false(loopback_port_create(LOOPBACK_PORTS_MAX), NULL);
+    zassert_equal(loopback_port_count(), 3, NULL);
+    loopback_get_my_address(&my_address);
+    zassert_equal(my_address.mac_len, LOOPBACK_MAC_LEN, NULL);
+    zassert_equal(my_address.mac[1], 1, NULL);
+    /* unicast from the device to port 2 */
+    pdu[0] = 0x01;
+    pdu[1] = 0x20;
+    loopback_mac_to_address(2, &dest);
+    len = loopback_send_pdu(&dest, NULL, pdu, 2);
+    zassert_equal(len, 2, NULL);
+    zassert_equal(loopback_port_pending(2), 1, NULL);
+    zassert_equal(loopback_port_pending(3), 0, NULL);
+    pdu_len = loopback_port_receive(2, &src, test_pdu, sizeof(test_pdu), 0);
+    zassert_equal(pdu_len, 2, NULL);
+    zassert_equal(memcmp(pdu, test_pdu, 2), 0, NULL);
+    zassert_equal(src.mac_len, my_address.mac_len, NULL);
+    zassert_equal(memcmp(src.mac, my_address.mac, src.mac_len), 0, NULL);
+    /* broadcast from port 3 reaches everyone else */
+    loopback_get_broadcast_address(&dest);
+    len = loopback_port_send(3, &dest, pdu, 2);
+    zassert_equal(len, 2, NULL);
+    zassert_equal(loopback_port_pending(2), 1, NULL);
+    zassert_equal(loopback_port_pending(3), 0, NULL);
+    pdu_len = loopback_receive(&src, test_pdu, sizeof(test_pdu), 0);
+    zassert_equal(pdu_len, 2, NULL);
+    zassert_equal(src.mac[1], 3, NULL);
+    /* unknown destination, and a full receive queue */
+    loopback_mac_to_address(99, &dest);
+    len = loopback_port_send(3, &dest, pdu, 2);
+    zassert_equal(len, 2, NULL);
+    loopback_mac_to_address(1, &dest);
+    for (len = 0; len < (LOOPBACK_QUEUE_DEPTH + 1); len++) {
+        (void)loopback_port_send(3, &dest, pdu, 2);
+    }
+    loopback_statistics(&stats);
+    zassert_equal(stats.dropped_unknown, 1, NULL);
+    zassert_equal(stats.dropped_overflow, 1, NULL);
+    zassert_equal(stats.delivered, 2, NULL);
+    /* sending from a port that does not exist */
+    zassert_equal(loopback_port_send(99, &dest, pdu, 2), -1, NULL);
+    loopback_cleanup();
+    zassert_false(loopback_port_valid(1), NULL);
+    loopback_reset();
+    loopback_simulated_time_set(true);
+    zassert_equal(loopback_port_count(), 0, NULL);
+}
+
+/**
+ * @brief Test the simulated latency, loss, and MTU
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_conditions)
+#else
+static void test_loopback_conditions(void)
+#endif
+{
+    uint8_t pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    BACNET_ADDRESS dest = { 0 }, src = { 0 };
+    LOOPBACK_STATISTICS stats = { 0 };
+    uint16_t pdu_len;
+    unsigned i, received;
+
+    loopback_reset();
+    loopback_simulated_time_set(true);
+    zassert_true(loopback_port_create(1), NULL);
+    zassert_true(loopback_port_create(2), NULL);
+    loopback_mac_to_address(2, &dest);
+    /* latency */
+    loopback_latency_set(50);
+    zassert_equal(loopback_latency(), 50, NULL);
+    zassert_equal(loopback_port_send(1, &dest, pdu, 10), 10, NULL);
+    pdu_len = loopback_port_receive(2, &src, pdu, sizeof(pdu), 20);
+    zassert_equal(pdu_len, 0, NULL);
+    zassert_equal(loopback_time(), 20, NULL);
+    pdu_len = loopback_port_receive(2, &src, pdu, sizeof(pdu), 100);
+    zassert_equal(pdu_len, 10, NULL);
+    zassert_equal(loopback_time(), 50, NULL);
+    loopback_latency_set(0);
+    /* MTU */
+    loopback_mtu_set(480);
+    zassert_equal(loopback_mtu(), 480, NULL);
+    zassert_equal(loopback_port_send(1, &dest, pdu, 481), -1, NULL);
+    zassert_equal(loopback_port_send(1, &dest, pdu, 480), 480, NULL);
+    zassert_equal(loopback_port_receive(2, &src, pdu, 100, 0), 0, NULL);
+    loopback_mtu_set(UINT16_MAX);
+    zassert_equal(loopback_mtu(), LOOPBACK_MPDU_MAX, NULL);
+    /* loss is repeatable for the same seed */
+    loopback_loss_set(250000);
+    loopback_seed_set(1234);
+    received = 0;
+    for (i = 0; i < 1000; i++) {
+        (void)loopback_port_send(1, &dest, pdu, 1);
+        received += loopback_port_receive(2, &src, pdu, sizeof(pdu), 0);
+    }
+    zassert_true(received > 650, NULL);
+    zassert_true(received < 850, NULL);
+    loopback_statistics(&stats);
+    zassert_equal(stats.dropped_loss, 1000 - received, NULL);
+    zassert_equal(stats.dropped_mtu, 2, NULL);
+    loopback_seed_set(1234);
+    loopback_statistics_reset();
+    for (i = 0; i < 1000; i++) {
+        (void)loopback_port_send(1, &dest, pdu, 1);
+        (void)loopback_port_receive(2, &src, pdu, sizeof(pdu), 0);
+    }
+    loopback_statistics(&stats);
+    zassert_equal(stats.delivered, received, NULL);
+    loopback_reset();
+}
+/**
+ * @brief Test that a receive sleeps for its timeout unless the time is
+ *  simulated
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(loopback_tests, test_loopback_real_time)
+#else
+static void test_loopback_real_time(void)
+#endif
+{
+    uint8_t pdu[LOOPBACK_MPDU_MAX] = { 0 };
+    BACNET_ADDRESS src = { 0 };
+    time_t start;
+    unsigned i;
+
+    loopback_reset();
+    zassert_false(loopback_simulated_time(), NULL);
+    zassert_true(loopback_port_create(2), NULL);
+    start = time(NULL);
+    /* 1.2 seconds of waiting for nothing */
+    for (i = 0; i < 12; i++) {
+        zassert_equal(
+            loopback_port_receive(2, &src, pdu, sizeof(pdu), 100), 0, NULL);
+    }
+    zassert_equal(loopback_time(), 1200, NULL);
+    zassert_true(time(NULL) - start >= 1, NULL);
+    loopback_reset();
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(loopback_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(loopback_tests,
+        ztest_unit_test(test_loopback_send_receive),
+        ztest_unit_test(test_loopback_conditions),
+        ztest_unit_test(test_loopback_real_time));
+
+    ztest_run_test_suite(loopback_tests);
+}
+#endif
@@ -96,6 +96,9 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
     return mstp_port->DataLength;
 }
 
+/* number of test PDUs waiting to be sent */
+static unsigned Test_Send_Queue_Count;
+
 /**
  * @brief MS/TP state machine calls this to get data to send
  * @param mstp_port port specific context data
@@ -104,10 +107,29 @@ uint16_t MSTP_Put_Receive(struct mstp_port_struct_t *mstp_port)
  */
 uint16_t MSTP_Get_Send(struct mstp_port_struct_t *mstp_port, unsigned timeout)
 {
-    (void)mstp_port;
+    uint8_t pdu[4] = { 0x01, 0x00, 0x10, 0x08 };
+
     (void)timeout;
+    if (Test_Send_Queue_Count == 0) {
+        return 0;
+    }
+    Test_Send_Queue_Count--;
 
-    return 0;
+    return MSTP_Create_Frame(mstp_port->OutputBuffer,
+        mstp_port->OutputBufferSize,
+        FRAME_TYPE_BACNET_DATA_NOT_EXPECTING_REPLY, 0x06,
+        mstp_port->This_Station, pdu, sizeof(pdu));
+}
+
+/**
+ * @brief MS/TP state machine calls this to get the transmit queue depth
+ * @param pArg pointer to the port specific context data
+ * @return number of PDUs waiting to be sent
+ */
+static unsigned Test_Send_Queue(void *pArg)
+{
+    (void)pArg;
+    return Test_Send_Queue_Count;
 }
 
 /**
@@ -596,6 +618,83 @@ static void testMasterNodeFSM(void)
     /* FIXME: write a unit test for the Master Node State Machine */
 }
 
+/**
+ * @brief Give the token to the node, and run the master node state
+ *  machine until it passes the token on
+ * @param mstp_port port specific context data
+ * @return number of information frames sent with the token
+ */
+static unsigned testMasterNodeTokenHold(struct mstp_port_struct_t *mstp_port)
+{
+    MSTP_TOKEN_STATISTICS statistics = { 0 };
+    uint32_t info_frames;
+    unsigned i;
+
+    MSTP_Token_Statistics(mstp_port, &statistics);
+    info_frames = statistics.info_frame_counter;
+    mstp_port->master_state = MSTP_MASTER_STATE_IDLE;
+    mstp_port->ReceivedValidFrame = true;
+    mstp_port->FrameType = FRAME_TYPE_TOKEN;
+    mstp_port->DestinationAddress = mstp_port->This_Station;
+    mstp_port->SourceAddress = mstp_port->Next_Station;
+    for (i = 0; i < 256; i++) {
+        (void)MSTP_Master_Node_FSM(mstp_port);
+        if (mstp_port->master_state == MSTP_MASTER_STATE_PASS_TOKEN) {
+            break;
+        }
+    }
+    zassert_equal(
+        mstp_port->master_state, MSTP_MASTER_STATE_PASS_TOKEN, NULL);
+    MSTP_Token_Statistics(mstp_port, &statistics);
+
+    return statistics.info_frame_counter - info_frames;
+}
+
+static void testMasterNodeAdaptiveInfoFrames(void)
+{
+    struct mstp_port_struct_t MSTP_Port = { 0 };
+    MSTP_TOKEN_STATISTICS statistics = { 0 };
+
+    MSTP_Port.InputBuffer = &RxBuffer[0];
+    MSTP_Port.InputBufferSize = sizeof(RxBuffer);
+    MSTP_Port.OutputBuffer = &TxBuffer[0];
+    MSTP_Port.OutputBufferSize = sizeof(TxBuffer);
+    MSTP_Port.Nmax_info_frames = 1;
+    MSTP_Port.Nmax_master = 127;
+    MSTP_Port.SilenceTimer = Timer_Silence;
+    MSTP_Port.SilenceTimerReset = Timer_Silence_Reset;
+    MSTP_Port.This_Station = 0x05;
+    MSTP_Init(&MSTP_Port);
+    MSTP_Port.Next_Station = 0x06;
+    /* fixed Max_Info_Frames */
+    Test_Send_Queue_Count = 20;
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 1, NULL);
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 1, NULL);
+    /* adaptive - the budget doubles up to the limit */
+    MSTP_Port.Nmax_info_frames_limit = 8;
+    MSTP_Port.SendQueueCount = Test_Send_Queue;
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 2, NULL);
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 4, NULL);
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 8, NULL);
+    zassert_equal(Test_Send_Queue_Count, 4, NULL);
+    /* and follows the queue down */
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 4, NULL);
+    zassert_equal(MSTP_Port.Info_Frames_Budget, 4, NULL);
+    zassert_equal(testMasterNodeTokenHold(&MSTP_Port), 0, NULL);
+    zassert_equal(MSTP_Port.Info_Frames_Budget, 1, NULL);
+    MSTP_Token_Statistics(&MSTP_Port, &statistics);
+    zassert_equal(statistics.token_counter, 7, NULL);
+    zassert_equal(statistics.info_frame_counter, 20, NULL);
+    zassert_equal(statistics.poll_for_master_counter, 0, NULL);
+    MSTP_Create_And_Send_Frame(&MSTP_Port, FRAME_TYPE_POLL_FOR_MASTER, 0x07,
+        MSTP_Port.This_Station, NULL, 0);
+    MSTP_Token_Statistics(&MSTP_Port, &statistics);
+    zassert_equal(statistics.poll_for_master_counter, 1, NULL);
+    MSTP_Token_Statistics_Reset(&MSTP_Port);
+    MSTP_Token_Statistics(&MSTP_Port, &statistics);
+    zassert_equal(statistics.token_counter, 0, NULL);
+}
+
 static void testSlaveNodeFSM(void)
 {
     struct mstp_port_struct_t MSTP_Port = { 0 }; /* port data */
@@ -1126,7 +1225,9 @@ void test_main(void)
 {
     ztest_test_suite(
         crc_tests, ztest_unit_test(testReceiveNodeFSM),
-        ztest_unit_test(testMasterNodeFSM), ztest_unit_test(testSlaveNodeFSM),
+        ztest_unit_test(testMasterNodeFSM),
+        ztest_unit_test(testMasterNodeAdaptiveInfoFrames),
+        ztest_unit_test(testSlaveNodeFSM),
         ztest_unit_test(testZeroConfigNodeFSM));
 
     ztest_run_test_suite(crc_tests);
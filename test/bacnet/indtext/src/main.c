@@ -10,6 +10,7 @@
 
 #include <zephyr/ztest.h>
 #include <bacnet/indtext.h>
+#include <bacnet/basic/sys/platform.h>
 
 /**
  * @addtogroup bacnet_tests
@@ -61,6 +62,70 @@ static void testIndexText(void)
     zassert_equal(
         index, indtext_by_istring_default(data_list, "ANNA", index), NULL);
 }
+
+/* not in order, with gaps and a repeated text and index */
+static INDTEXT_DATA index_list[] = { { 0, "Zero" }, { 1, "One" },
+    { 2, "Two" }, { 40, "Forty" }, { 7, "seven" }, { 1000, "Thousand" },
+    { 9, "Nine" }, { 8, "SEVEN" }, { 9, "Niner" }, { 11, "Seven" },
+    { 0, NULL } };
+static INDTEXT_DATA *index_by_name[ARRAY_SIZE(index_list)];
+static INDTEXT_DATA *index_by_index[ARRAY_SIZE(index_list)];
+
+/**
+ * @brief Test the sorted views give the same results as the lists
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(indtext_tests, testIndexTextSorted)
+#else
+static void testIndexTextSorted(void)
+#endif
+{
+    INDTEXT_INDEX data_index = { index_list, index_by_name, index_by_index,
+        ARRAY_SIZE(index_list), 0, 0, false };
+    INDTEXT_INDEX small_index = { index_list, index_by_name, index_by_index,
+        2, 0, 0, false };
+    const char *names[] = { "Zero", "zero", "SEVEN", "Seven", "seven",
+        "Niner", "NINE", "Thousand", "Forty", "Harry", "", "Z", "A" };
+    unsigned i, index, expected;
+    bool valid;
+
+    for (i = 0; i < ARRAY_SIZE(names); i++) {
+        expected = 0;
+        valid = indtext_by_string(index_list, names[i], &expected);
+        index = 0;
+        zassert_equal(valid,
+            indtext_index_by_string(&data_index, names[i], &index), NULL);
+        zassert_equal(index, expected, NULL);
+        expected = 0;
+        valid = indtext_by_istring(index_list, names[i], &expected);
+        index = 0;
+        zassert_equal(valid,
+            indtext_index_by_istring(&data_index, names[i], &index), NULL);
+        zassert_equal(index, expected, NULL);
+    }
+    zassert_true(data_index.sorted, NULL);
+    zassert_equal(data_index.count, indtext_count(index_list), NULL);
+    zassert_equal(data_index.dense, 3, NULL);
+    for (i = 0; i < 1100; i++) {
+        zassert_equal(indtext_by_index_default(index_list, i, "none"),
+            indtext_index_by_index_default(&data_index, i, "none"), NULL);
+    }
+    /* the storage is too small, so the lists are searched */
+    zassert_true(
+        indtext_index_by_istring(&small_index, "niner", &index), NULL);
+    zassert_equal(index, 9, NULL);
+    zassert_false(small_index.sorted, NULL);
+    zassert_false(indtext_index_init(&small_index), NULL);
+    zassert_false(indtext_index_init(NULL), NULL);
+    /* sorting ahead of the first use */
+    data_index.sorted = false;
+    zassert_true(indtext_index_init(&data_index), NULL);
+    zassert_true(data_index.sorted, NULL);
+    zassert_true(indtext_index_init(&data_index), NULL);
+    zassert_false(indtext_index_by_istring(NULL, "niner", NULL), NULL);
+    zassert_false(indtext_index_by_string(&data_index, NULL, NULL), NULL);
+    zassert_is_null(indtext_index_by_index_default(NULL, 0, NULL), NULL);
+}
 /**
  * @}
  */
@@ -70,7 +135,8 @@ ZTEST_SUITE(indtext_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText));
+    ztest_test_suite(indtext_tests, ztest_unit_test(testIndexText),
+        ztest_unit_test(testIndexTextSorted));
 
     ztest_run_test_suite(indtext_tests);
 }
@@ -0,0 +1,162 @@
+/**
+ * @file
+ * @brief Unit test for the BACnet streaming tag reader
+ * @author agent <agent@local>
+ * @date 2026
+ *
+ * SPDX-License-Identifier: MIT
+ */
+#include <zephyr/ztest.h>
+#include <bacnet/bacdcode.h>
+#include <bacnet/tag_reader.h>
+
+/**
+ * @addtogroup bacnet_tests
+ * @{
+ */
+
+/**
+ * @brief Test walking a constructed value tag by tag
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tag_reader_tests, test_tag_reader_walk)
+#else
+static void test_tag_reader_walk(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_TAG_READER reader = { 0 };
+    BACNET_TAG_READER_ITEM item = { 0 };
+    BACNET_OBJECT_TYPE object_type = OBJECT_NONE;
+    uint32_t object_instance = 0;
+    BACNET_UNSIGNED_INTEGER unsigned_value = 0;
+    int len = 0, apdu_len = 0;
+
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 3);
+    apdu_len +=
+        encode_application_object_id(&apdu[apdu_len], OBJECT_DEVICE, 1234);
+    apdu_len += encode_application_boolean(&apdu[apdu_len], true);
+    apdu_len += encode_context_unsigned(&apdu[apdu_len], 1, 0x12345678);
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 3);
+
+    bacnet_tag_reader_init(&reader, apdu, apdu_len);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(item.tag.opening, NULL);
+    zassert_equal(item.tag.number, 3, NULL);
+    zassert_equal(item.depth, 0, NULL);
+    zassert_is_null(item.data, NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(item.tag.application, NULL);
+    zassert_equal(item.tag.number, BACNET_APPLICATION_TAG_OBJECT_ID, NULL);
+    zassert_equal(item.depth, 1, NULL);
+    /* the value is borrowed from the APDU, not copied */
+    zassert_true(item.data > &apdu[0], NULL);
+    zassert_true(item.data < &apdu[apdu_len], NULL);
+    len = decode_object_id_safe(
+        item.data, item.data_len, &object_type, &object_instance);
+    zassert_equal(len, 4, NULL);
+    zassert_equal(object_type, OBJECT_DEVICE, NULL);
+    zassert_equal(object_instance, 1234, NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_equal(item.tag.number, BACNET_APPLICATION_TAG_BOOLEAN, NULL);
+    zassert_equal(item.tag.len_value_type, 1, NULL);
+    zassert_equal(item.data_len, 0, NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(item.tag.context, NULL);
+    zassert_equal(item.tag.number, 1, NULL);
+    len = decode_unsigned(item.data, item.data_len, &unsigned_value);
+    zassert_equal(len, 4, NULL);
+    zassert_equal(unsigned_value, 0x12345678, NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(item.tag.closing, NULL);
+    zassert_equal(item.depth, 0, NULL);
+    zassert_true(bacnet_tag_reader_done(&reader), NULL);
+    zassert_false(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_false(bacnet_tag_reader_error(&reader), NULL);
+    zassert_equal(bacnet_tag_reader_offset(&reader), apdu_len, NULL);
+}
+
+/**
+ * @brief Test fast-forwarding over constructed values
+ */
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(tag_reader_tests, test_tag_reader_skip)
+#else
+static void test_tag_reader_skip(void)
+#endif
+{
+    uint8_t apdu[MAX_APDU] = { 0 };
+    BACNET_TAG_READER reader = { 0 };
+    BACNET_TAG_READER_ITEM item = { 0 };
+    int apdu_len = 0, enclosed_len = 0, len = 0, i;
+
+    apdu_len += encode_opening_tag(&apdu[apdu_len], 4);
+    for (i = 0; i < 4; i++) {
+        apdu_len += encode_opening_tag(&apdu[apdu_len], 0);
+        apdu_len += encode_application_real(&apdu[apdu_len], 1.0f);
+        apdu_len += encode_closing_tag(&apdu[apdu_len], 0);
+    }
+    apdu_len += encode_closing_tag(&apdu[apdu_len], 4);
+    apdu_len += encode_application_unsigned(&apdu[apdu_len], 99);
+
+    enclosed_len = bacnet_tag_reader_enclosed_length(apdu, apdu_len);
+    zassert_equal(
+        enclosed_len, bacnet_enclosed_data_length(apdu, apdu_len), NULL);
+    /* skip the whole constructed value in one call */
+    bacnet_tag_reader_init(&reader, apdu, apdu_len);
+    zassert_true(bacnet_tag_reader_skip(&reader), NULL);
+    zassert_equal(
+        bacnet_tag_reader_offset(&reader), enclosed_len + 2, NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_equal(item.tag.number, BACNET_APPLICATION_TAG_UNSIGNED_INT, NULL);
+    zassert_true(bacnet_tag_reader_done(&reader), NULL);
+    /* skip to the closing tag from inside */
+    bacnet_tag_reader_init(&reader, apdu, apdu_len);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(bacnet_tag_reader_skip_to_closing(&reader), NULL);
+    zassert_true(bacnet_tag_reader_skip_to_closing(&reader), NULL);
+    zassert_equal(
+        bacnet_tag_reader_offset(&reader), enclosed_len + 2, NULL);
+    /* a reader started inside a constructed value stops at its end */
+    bacnet_tag_reader_init(&reader, &apdu[1], apdu_len - 1);
+    len = 0;
+    while (bacnet_tag_reader_skip(&reader)) {
+        len++;
+    }
+    zassert_equal(len, 4, NULL);
+    zassert_false(bacnet_tag_reader_error(&reader), NULL);
+    zassert_equal(bacnet_tag_reader_offset(&reader), enclosed_len, NULL);
+    /* truncated data */
+    bacnet_tag_reader_init(&reader, apdu, enclosed_len);
+    zassert_false(bacnet_tag_reader_skip(&reader), NULL);
+    zassert_true(bacnet_tag_reader_error(&reader), NULL);
+    zassert_equal(
+        bacnet_tag_reader_enclosed_length(apdu, enclosed_len),
+        BACNET_STATUS_ERROR, NULL);
+    /* primitive contents past the end of the buffer */
+    apdu_len = encode_application_unsigned(apdu, 0x12345678);
+    bacnet_tag_reader_init(&reader, apdu, apdu_len - 1);
+    zassert_false(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(bacnet_tag_reader_error(&reader), NULL);
+    /* NULL is handled */
+    bacnet_tag_reader_init(&reader, NULL, apdu_len);
+    zassert_false(bacnet_tag_reader_next(&reader, &item), NULL);
+    zassert_true(bacnet_tag_reader_done(&reader), NULL);
+    zassert_equal(bacnet_tag_reader_remaining(&reader), 0, NULL);
+}
+/**
+ * @}
+ */
+
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST_SUITE(tag_reader_tests, NULL, NULL, NULL, NULL, NULL);
+#else
+void test_main(void)
+{
+    ztest_test_suite(tag_reader_tests, ztest_unit_test(test_tag_reader_walk),
+        ztest_unit_test(test_tag_reader_skip));
+
+    ztest_run_test_suite(tag_reader_tests);
+}
+#endif
@@ -147,6 +147,99 @@ static void testWritePropertyMultiple(void)
         } while (tag_number != 1);
     } while (offset < apdu_len);
 }
+#if defined(CONFIG_ZTEST_NEW_API)
+ZTEST(wp_tests, testWritePropertyMultipleReference)
+#else
+static void testWritePropertyMultipleReference(void)
+#endif
+{
+    BACNET_WRITE_ACCESS_DATA write_access_data = { 0 };
+    BACNET_PROPERTY_VALUE property_value[2] = { 0 };
+    BACNET_WRITE_PROPERTY_DATA wp_data = { 0 };
+    BACNET_WRITE_PROPERTY_DATA test_wp_data = { 0 };
+    uint8_t apdu[480] = { 0 };
+    uint16_t value_offset = 0;
+    int apdu_len = 0;
+    int offset = 0;
+    int len = 0;
+    int test_len = 0;
+    unsigned i = 0;
+
+    write_access_data.object_type = OBJECT_ANALOG_OUTPUT;
+    write_access_data.object_instance = 1;
+    write_access_data.listOfProperties = &property_value[0];
+    bacapp_property_value_list_init(&property_value[0], 2);
+    property_value[0].propertyIdentifier = PROP_PRESENT_VALUE;
+    property_value[0].propertyArrayIndex = BACNET_ARRAY_ALL;
+    property_value[0].value.tag = BACNET_APPLICATION_TAG_REAL;
+    property_value[0].value.type.Real = 3.14159f;
+    property_value[0].value.next = NULL;
+    property_value[0].priority = 8;
+    property_value[1].propertyIdentifier = PROP_PRIORITY_ARRAY;
+    property_value[1].propertyArrayIndex = 5;
+    property_value[1].value.tag = BACNET_APPLICATION_TAG_NULL;
+    property_value[1].value.next = NULL;
+    property_value[1].priority = BACNET_NO_PRIORITY;
+    apdu_len = wpm_encode_apdu(apdu, sizeof(apdu), 1, &write_access_data);
+    zassert_true(apdu_len > 0, NULL);
+    len = wpm_decode_apdu(apdu, apdu_len, NULL);
+    zassert_equal(len, 4, NULL);
+    offset += len;
+    len = wpm_decode_object_id(&apdu[offset], apdu_len - offset, &wp_data);
+    zassert_true(len > 0, NULL);
+    offset += len;
+    zassert_true(decode_is_opening_tag_number(&apdu[offset++], 1), NULL);
+    for (i = 0; i < 2; i++) {
+        /* the reference finds the same value that the copy decodes */
+        len = wpm_decode_object_property_reference(
+            &apdu[offset], apdu_len - offset, &wp_data, &value_offset);
+        test_len = wpm_decode_object_property(
+            &apdu[offset], apdu_len - offset, &test_wp_data);
+        zassert_true(len > 0, NULL);
+        zassert_equal(len, test_len, NULL);
+        zassert_equal(
+            wp_data.object_property, property_value[i].propertyIdentifier,
+            NULL);
+        zassert_equal(
+            wp_data.array_index, property_value[i].propertyArrayIndex, NULL);
+        zassert_equal(wp_data.object_property, test_wp_data.object_property,
+            NULL);
+        zassert_equal(wp_data.array_index, test_wp_data.array_index, NULL);
+        zassert_equal(wp_data.priority, test_wp_data.priority, NULL);
+        zassert_equal(wp_data.application_data_len,
+            test_wp_data.application_data_len, NULL);
+        zassert_true(value_offset < len, NULL);
+        zassert_equal(memcmp(&apdu[offset + value_offset],
+                          test_wp_data.application_data,
+                          test_wp_data.application_data_len),
+            0, NULL);
+        offset += len;
+    }
+    zassert_equal(wp_data.priority, BACNET_MAX_PRIORITY, NULL);
+    zassert_true(decode_is_closing_tag_number(&apdu[offset], 1), NULL);
+    /* the value of the first property, without its closing tag */
+    offset = 4;
+    offset += wpm_decode_object_id(&apdu[offset], apdu_len - offset, &wp_data);
+    offset++;
+    len = wpm_decode_object_property_reference(
+        &apdu[offset], 2, &wp_data, &value_offset);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+    zassert_equal(wp_data.error_code, ERROR_CODE_REJECT_INVALID_TAG, NULL);
+    /* a property identifier without a value */
+    apdu[offset + 2] = 0x39;
+    len = wpm_decode_object_property_reference(
+        &apdu[offset], apdu_len - offset, &wp_data, &value_offset);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+    /* missing parameters */
+    len = wpm_decode_object_property_reference(
+        &apdu[offset], 0, &wp_data, &value_offset);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+    zassert_equal(wp_data.error_code,
+        ERROR_CODE_REJECT_MISSING_REQUIRED_PARAMETER, NULL);
+    len = wpm_decode_object_property_reference(
+        &apdu[offset], apdu_len - offset, &wp_data, NULL);
+    zassert_equal(len, BACNET_STATUS_REJECT, NULL);
+}
 /**
  * @}
  */
@@ -156,7 +249,8 @@ ZTEST_SUITE(wp_tests, NULL, NULL, NULL, NULL, NULL);
 #else
 void test_main(void)
 {
-    ztest_test_suite(wp_tests, ztest_unit_test(testWritePropertyMultiple));
+    ztest_test_suite(wp_tests, ztest_unit_test(testWritePropertyMultiple),
+        ztest_unit_test(testWritePropertyMultipleReference));
 
     ztest_run_test_suite(wp_tests);
 }
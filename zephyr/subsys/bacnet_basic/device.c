@@ -323,7 +323,8 @@ static object_functions_t Object_Table[] = {
         Structured_View_Index_To_Instance, Structured_View_Valid_Instance,
         Structured_View_Object_Name, Structured_View_Read_Property,
         NULL /* Write_Property */, Structured_View_Property_Lists,
-        NULL /* ReadRangeInfo */, NULL /* Iterator */, NULL /* Value_Lists */,
+        Structured_View_Read_Range_Info, NULL /* Iterator */,
+        NULL /* Value_Lists */,
         NULL /* COV */, NULL /* COV Clear */,  NULL /* Intrinsic Reporting */,
         NULL /* Add_List_Element */, NULL /* Remove_List_Element */,
         Structured_View_Create, Structured_View_Delete, NULL /* Timer */ },